@@ -0,0 +1,456 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// external
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// blasfeo
+#include "blasfeo_d_aux.h"
+#include "blasfeo_d_blas.h"
+
+// acados
+#include "acados/dense_qp/dense_qp_as_cache.h"
+#include "acados/utils/math.h"
+#include "acados/utils/mem.h"
+
+
+
+/************************************************
+ * memory
+ ************************************************/
+
+acados_size_t dense_qp_as_cache_calculate_size(dense_qp_dims *dims, int size)
+{
+    int nv = dims->nv;
+    int ne = dims->ne;
+    int nb = dims->nb;
+    int ng = dims->ng;
+
+    acados_size_t ret = sizeof(dense_qp_as_cache);
+
+    ret += size * sizeof(dense_qp_as_cache_entry);
+    ret += size * sizeof(int);  // order
+    ret += size * nv * sizeof(int);  // idxw
+    ret += nb * sizeof(int);  // idxb_prev
+    ret += nv * sizeof(int);  // idxw_tmp
+
+    ret += 2 * size * blasfeo_memsize_dmat(nv, nv);  // Kt, Ls
+    ret += blasfeo_memsize_dmat(nv, nv);  // H_prev
+    ret += blasfeo_memsize_dmat(nv, ng);  // Ct_prev
+    ret += blasfeo_memsize_dmat(ne, nv);  // A_prev
+    ret += 2 * blasfeo_memsize_dmat(nv, nv);  // L, Aw
+    ret += 4 * blasfeo_memsize_dvec(nv);  // y, r, mu, tmp
+
+    ret += 2 * 64;  // align blasfeo memory
+    make_int_multiple_of(8, &ret);
+
+    return ret;
+}
+
+
+
+dense_qp_as_cache *dense_qp_as_cache_assign(dense_qp_dims *dims, int size, void *raw_memory)
+{
+    int nv = dims->nv;
+    int ne = dims->ne;
+    int nb = dims->nb;
+    int ng = dims->ng;
+
+    char *c_ptr = (char *) raw_memory;
+
+    dense_qp_as_cache *cache = (dense_qp_as_cache *) c_ptr;
+    c_ptr += sizeof(dense_qp_as_cache);
+
+    cache->entries = (dense_qp_as_cache_entry *) c_ptr;
+    c_ptr += size * sizeof(dense_qp_as_cache_entry);
+
+    align_char_to(64, &c_ptr);
+
+    // blasfeo_mem
+    for (int ii = 0; ii < size; ii++)
+    {
+        assign_and_advance_blasfeo_dmat_mem(nv, nv, &cache->entries[ii].Kt, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nv, nv, &cache->entries[ii].Ls, &c_ptr);
+    }
+    assign_and_advance_blasfeo_dmat_mem(nv, nv, &cache->H_prev, &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(nv, ng, &cache->Ct_prev, &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(ne, nv, &cache->A_prev, &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(nv, nv, &cache->L, &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(nv, nv, &cache->Aw, &c_ptr);
+    assign_and_advance_blasfeo_dvec_mem(nv, &cache->y, &c_ptr);
+    assign_and_advance_blasfeo_dvec_mem(nv, &cache->r, &c_ptr);
+    assign_and_advance_blasfeo_dvec_mem(nv, &cache->mu, &c_ptr);
+    assign_and_advance_blasfeo_dvec_mem(nv, &cache->tmp, &c_ptr);
+
+    // ints
+    assign_and_advance_int(size, &cache->order, &c_ptr);
+    for (int ii = 0; ii < size; ii++)
+    {
+        assign_and_advance_int(nv, &cache->entries[ii].idxw, &c_ptr);
+        cache->entries[ii].nw = 0;
+        cache->entries[ii].factorized = 0;
+    }
+    assign_and_advance_int(nb, &cache->idxb_prev, &c_ptr);
+    assign_and_advance_int(nv, &cache->idxw_tmp, &c_ptr);
+
+    cache->size = size;
+    cache->num = 0;
+    cache->first_run = 1;
+    cache->H_factorized = 0;
+    cache->hit = 0;
+    cache->num_hits = 0;
+    cache->num_solves = 0;
+
+    assert((char *) raw_memory + dense_qp_as_cache_calculate_size(dims, size) >= c_ptr);
+
+    return cache;
+}
+
+
+
+void dense_qp_as_cache_get(dense_qp_as_cache *cache, const char *field, void *value)
+{
+    if (!strcmp(field, "hit"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = cache->hit;
+    }
+    else if (!strcmp(field, "num_hits"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = cache->num_hits;
+    }
+    else if (!strcmp(field, "num_solves"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = cache->num_solves;
+    }
+    else
+    {
+        printf("\nerror: dense_qp_as_cache_get: field %s not available\n", field);
+        exit(1);
+    }
+}
+
+
+
+/************************************************
+ * functions
+ ************************************************/
+
+// returns 1 if the matrices of qp_in differ from the ones the cached factorizations are based on
+static int update_matrices(dense_qp_in *qp_in, dense_qp_as_cache *cache)
+{
+    int nv = qp_in->dim->nv;
+    int ne = qp_in->dim->ne;
+    int nb = qp_in->dim->nb;
+    int ng = qp_in->dim->ng;
+
+    int changed = cache->first_run;
+    cache->first_run = 0;
+
+    for (int jj = 0; jj < nv; jj++)
+        for (int ii = jj; ii < nv; ii++)
+            changed |= track_change(BLASFEO_DMATEL(qp_in->Hv, ii, jj), &BLASFEO_DMATEL(&cache->H_prev, ii, jj));
+    for (int jj = 0; jj < ng; jj++)
+        for (int ii = 0; ii < nv; ii++)
+            changed |= track_change(BLASFEO_DMATEL(qp_in->Ct, ii, jj), &BLASFEO_DMATEL(&cache->Ct_prev, ii, jj));
+    for (int jj = 0; jj < nv; jj++)
+        for (int ii = 0; ii < ne; ii++)
+            changed |= track_change(BLASFEO_DMATEL(qp_in->A, ii, jj), &BLASFEO_DMATEL(&cache->A_prev, ii, jj));
+    for (int ii = 0; ii < nb; ii++)
+    {
+        changed |= qp_in->idxb[ii] != cache->idxb_prev[ii];
+        cache->idxb_prev[ii] = qp_in->idxb[ii];
+    }
+
+    return changed;
+}
+
+
+
+static int diag_positive(int n, struct blasfeo_dmat *L)
+{
+    for (int ii = 0; ii < n; ii++)
+    {
+        // NOTE: also catches NaN
+        if (!(BLASFEO_DMATEL(L, ii, ii) > 1e-12))
+            return 0;
+    }
+    return 1;
+}
+
+
+
+// factorizes the reduced KKT matrix of the equality constrained QP with active set entry->idxw
+static int factorize_entry(dense_qp_in *qp_in, dense_qp_as_cache *cache, dense_qp_as_cache_entry *entry)
+{
+    int nv = qp_in->dim->nv;
+    int ne = qp_in->dim->ne;
+    int nb = qp_in->dim->nb;
+    int ng = qp_in->dim->ng;
+    int nr = ne + entry->nw;
+
+    struct blasfeo_dmat *Aw = &cache->Aw;
+
+    // rows of the active constraints: [A; C_w^T]
+    blasfeo_dgecp(ne, nv, qp_in->A, 0, 0, Aw, 0, 0);
+    for (int ii = 0; ii < entry->nw; ii++)
+    {
+        int idx = entry->idxw[ii] % (nb + ng);
+        if (idx < nb)
+        {
+            blasfeo_dgese(1, nv, 0.0, Aw, ne + ii, 0);
+            BLASFEO_DMATEL(Aw, ne + ii, qp_in->idxb[idx]) = 1.0;
+        }
+        else
+        {
+            for (int jj = 0; jj < nv; jj++)
+                BLASFEO_DMATEL(Aw, ne + ii, jj) = BLASFEO_DMATEL(qp_in->Ct, jj, idx - nb);
+        }
+    }
+
+    // Kt = Aw L^{-T}, Ls Ls^T = Aw H^{-1} Aw^T
+    blasfeo_dtrsm_rltn(nr, nv, 1.0, &cache->L, 0, 0, Aw, 0, 0, &entry->Kt, 0, 0);
+    blasfeo_dsyrk_ln(nr, nv, 1.0, &entry->Kt, 0, 0, &entry->Kt, 0, 0, 0.0, &entry->Ls, 0, 0,
+                     &entry->Ls, 0, 0);
+    blasfeo_dpotrf_l(nr, &entry->Ls, 0, 0, &entry->Ls, 0, 0);
+
+    entry->factorized = diag_positive(nr, &entry->Ls) ? 1 : -1;
+
+    return entry->factorized == 1;
+}
+
+
+
+static void move_to_front(dense_qp_as_cache *cache, int pos)
+{
+    int slot = cache->order[pos];
+    for (int ii = pos; ii > 0; ii--)
+        cache->order[ii] = cache->order[ii-1];
+    cache->order[0] = slot;
+}
+
+
+
+// solves the equality constrained QP of entry and checks primal and dual feasibility
+static int try_entry(dense_qp_in *qp_in, dense_qp_out *qp_out, dense_qp_as_cache *cache,
+                     dense_qp_as_cache_entry *entry, double tol)
+{
+    int nv = qp_in->dim->nv;
+    int ne = qp_in->dim->ne;
+    int nb = qp_in->dim->nb;
+    int ng = qp_in->dim->ng;
+    int nw = entry->nw;
+    int nr = ne + nw;
+
+    int ii, idx;
+
+    // constraints masked out since the entry was stored
+    for (ii = 0; ii < nw; ii++)
+    {
+        if (BLASFEO_DVECEL(qp_in->d_mask, entry->idxw[ii]) == 0.0)
+            return 0;
+    }
+
+    if (entry->factorized == 0)
+        factorize_entry(qp_in, cache, entry);
+    if (entry->factorized != 1)
+        return 0;
+
+    // right hand side of the active constraints
+    blasfeo_dveccp(ne, qp_in->b, 0, &cache->r, 0);
+    for (ii = 0; ii < nw; ii++)
+    {
+        idx = entry->idxw[ii];
+        // NOTE: upper bounds are stored with negative sign in d
+        BLASFEO_DVECEL(&cache->r, ne+ii) = idx < nb + ng ? BLASFEO_DVECEL(qp_in->d, idx) :
+                                                          -BLASFEO_DVECEL(qp_in->d, idx);
+    }
+
+    // multipliers mu of H v + g + Aw^T mu = 0, Aw v = r
+    blasfeo_dgemv_n(nr, nv, 1.0, &entry->Kt, 0, 0, &cache->y, 0, 1.0, &cache->r, 0, &cache->r, 0);
+    blasfeo_dtrsv_lnn(nr, &entry->Ls, 0, 0, &cache->r, 0, &cache->tmp, 0);
+    blasfeo_dtrsv_ltn(nr, &entry->Ls, 0, 0, &cache->tmp, 0, &cache->mu, 0);
+    blasfeo_dveccpsc(nr, -1.0, &cache->mu, 0, &cache->mu, 0);
+
+    // dual feasibility: lower bounds have mu <= 0, upper bounds mu >= 0
+    for (ii = 0; ii < nw; ii++)
+    {
+        double mu = BLASFEO_DVECEL(&cache->mu, ne+ii);
+        if (entry->idxw[ii] < nb + ng ? mu > tol : mu < -tol)
+            return 0;
+    }
+
+    // primal solution
+    blasfeo_dgemv_t(nr, nv, 1.0, &entry->Kt, 0, 0, &cache->mu, 0, 1.0, &cache->y, 0, &cache->tmp, 0);
+    blasfeo_dtrsv_ltn(nv, &cache->L, 0, 0, &cache->tmp, 0, qp_out->v, 0);
+    blasfeo_dveccpsc(nv, -1.0, qp_out->v, 0, qp_out->v, 0);
+
+    // primal feasibility of all inequalities
+    dense_qp_compute_t(qp_in, qp_out);
+    for (ii = 0; ii < 2 * (nb + ng); ii++)
+    {
+        if (BLASFEO_DVECEL(qp_in->d_mask, ii) != 0.0 && BLASFEO_DVECEL(qp_out->t, ii) < -tol)
+            return 0;
+    }
+
+    // dual solution
+    blasfeo_dvecse(2 * (nb + ng), 0.0, qp_out->lam, 0);
+    for (ii = 0; ii < nw; ii++)
+    {
+        idx = entry->idxw[ii];
+        double lam = idx < nb + ng ? -BLASFEO_DVECEL(&cache->mu, ne+ii) : BLASFEO_DVECEL(&cache->mu, ne+ii);
+        BLASFEO_DVECEL(qp_out->lam, idx) = lam > 0.0 ? lam : 0.0;
+    }
+    blasfeo_dveccpsc(ne, -1.0, &cache->mu, 0, qp_out->pi, 0);
+
+    return 1;
+}
+
+
+
+int dense_qp_as_cache_solve(dense_qp_in *qp_in, dense_qp_out *qp_out, dense_qp_as_cache *cache, double tol)
+{
+    int nv = qp_in->dim->nv;
+
+    cache->hit = 0;
+    cache->num_solves++;
+
+    // NOTE: soft constraints are left to the solver
+    if (cache->num == 0 || qp_in->dim->ns > 0 || nv == 0)
+        return 0;
+
+    if (update_matrices(qp_in, cache))
+    {
+        cache->H_factorized = 0;
+        for (int ii = 0; ii < cache->num; ii++)
+            cache->entries[ii].factorized = 0;
+    }
+    if (cache->H_factorized == 0)
+    {
+        blasfeo_dpotrf_l(nv, qp_in->Hv, 0, 0, &cache->L, 0, 0);
+        cache->H_factorized = diag_positive(nv, &cache->L) ? 1 : -1;
+    }
+    if (cache->H_factorized != 1)
+        return 0;
+
+    // y = L^{-1} g
+    blasfeo_dtrsv_lnn(nv, &cache->L, 0, 0, qp_in->gz, 0, &cache->y, 0);
+
+    for (int ii = 0; ii < cache->num; ii++)
+    {
+        if (try_entry(qp_in, qp_out, cache, &cache->entries[cache->order[ii]], tol))
+        {
+            move_to_front(cache, ii);
+            cache->hit = 1;
+            cache->num_hits++;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+
+void dense_qp_as_cache_store(dense_qp_in *qp_in, dense_qp_out *qp_out, dense_qp_as_cache *cache, double tol)
+{
+    int nv = qp_in->dim->nv;
+    int ne = qp_in->dim->ne;
+    int nb = qp_in->dim->nb;
+    int ng = qp_in->dim->ng;
+
+    int ii, jj;
+
+    if (cache->size == 0 || qp_in->dim->ns > 0)
+        return;
+
+    qp_info *info = (qp_info *) qp_out->misc;
+    if (info->t_computed == 0)
+    {
+        dense_qp_compute_t(qp_in, qp_out);
+        info->t_computed = 1;
+    }
+
+    // active set of qp_out: constraints with positive multiplier at their bound
+    int *idxw = cache->idxw_tmp;
+    int nw = 0;
+    for (ii = 0; ii < nb + ng; ii++)
+    {
+        double lam_l = BLASFEO_DVECEL(qp_in->d_mask, ii) != 0.0 && BLASFEO_DVECEL(qp_out->t, ii) <= tol ?
+                       BLASFEO_DVECEL(qp_out->lam, ii) : 0.0;
+        double lam_u = BLASFEO_DVECEL(qp_in->d_mask, nb+ng+ii) != 0.0 && BLASFEO_DVECEL(qp_out->t, nb+ng+ii) <= tol ?
+                       BLASFEO_DVECEL(qp_out->lam, nb+ng+ii) : 0.0;
+        if (lam_l > 0.0 || lam_u > 0.0)
+        {
+            nw++;
+            // more active constraints than variables can not be factorized
+            if (ne + nw > nv)
+                return;
+            idxw[nw-1] = lam_l >= lam_u ? ii : nb + ng + ii;
+        }
+    }
+
+    // already stored
+    for (ii = 0; ii < cache->num; ii++)
+    {
+        dense_qp_as_cache_entry *entry = &cache->entries[cache->order[ii]];
+        if (entry->nw != nw)
+            continue;
+        for (jj = 0; jj < nw; jj++)
+        {
+            if (entry->idxw[jj] != idxw[jj])
+                break;
+        }
+        if (jj == nw)
+        {
+            move_to_front(cache, ii);
+            return;
+        }
+    }
+
+    // replace the least recently used entry
+    if (cache->num < cache->size)
+    {
+        cache->order[cache->num] = cache->num;
+        cache->num++;
+    }
+    dense_qp_as_cache_entry *entry = &cache->entries[cache->order[cache->num-1]];
+    entry->nw = nw;
+    for (ii = 0; ii < nw; ii++)
+        entry->idxw[ii] = idxw[ii];
+    entry->factorized = 0;
+    move_to_front(cache, cache->num-1);
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#ifndef ACADOS_DENSE_QP_DENSE_QP_AS_CACHE_H_
+#define ACADOS_DENSE_QP_DENSE_QP_AS_CACHE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// blasfeo
+#include "blasfeo_common.h"
+
+// acados
+#include "acados/dense_qp/dense_qp_common.h"
+#include "acados/utils/types.h"
+
+
+
+// active-set cache for small dense QPs:
+// stores the optimal active sets of previous solves together with the factorization of their
+// KKT system, such that a QP with one of these active sets is solved without active-set iterations
+typedef struct
+{
+    int nw;  // number of active inequalities
+    int *idxw;  // active inequalities as index into lam: [lb, lg, ub, ug]
+    struct blasfeo_dmat Kt;  // [A; C_w^T] L^{-T}, with H = L L^T
+    struct blasfeo_dmat Ls;  // cholesky factor of the reduced KKT matrix Kt Kt^T
+    int factorized;
+} dense_qp_as_cache_entry;
+
+
+
+typedef struct
+{
+    int size;  // maximum number of stored active sets
+    int num;  // number of stored active sets
+    int *order;  // most recently used first
+    dense_qp_as_cache_entry *entries;
+
+    // matrices of qp_in at the last factorization
+    struct blasfeo_dmat H_prev;
+    struct blasfeo_dmat Ct_prev;
+    struct blasfeo_dmat A_prev;
+    int *idxb_prev;
+    int first_run;
+
+    struct blasfeo_dmat L;  // cholesky factor of the Hessian
+    struct blasfeo_dmat Aw;
+    struct blasfeo_dvec y;
+    struct blasfeo_dvec r;
+    struct blasfeo_dvec mu;
+    struct blasfeo_dvec tmp;
+    int *idxw_tmp;
+    int H_factorized;
+
+    int hit;  // last solve used a cached active set
+    int num_hits;
+    int num_solves;
+} dense_qp_as_cache;
+
+
+
+//
+acados_size_t dense_qp_as_cache_calculate_size(dense_qp_dims *dims, int size);
+//
+dense_qp_as_cache *dense_qp_as_cache_assign(dense_qp_dims *dims, int size, void *raw_memory);
+// tries the cached active sets, most recently used first; returns 1 and fills qp_out if one of them is optimal
+int dense_qp_as_cache_solve(dense_qp_in *qp_in, dense_qp_out *qp_out, dense_qp_as_cache *cache, double tol);
+// stores the active set of the solution in qp_out
+void dense_qp_as_cache_store(dense_qp_in *qp_in, dense_qp_out *qp_out, dense_qp_as_cache *cache, double tol);
+//
+void dense_qp_as_cache_get(dense_qp_as_cache *cache, const char *field, void *value);
+
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_DENSE_QP_DENSE_QP_AS_CACHE_H_
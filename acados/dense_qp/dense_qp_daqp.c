@@ -97,6 +97,8 @@ void dense_qp_daqp_opts_initialize_default(void *config_, dense_qp_dims *dims, v
     dense_qp_daqp_opts *opts = (dense_qp_daqp_opts *) opts_;
     daqp_default_settings(opts->daqp_opts);
     opts->warm_start=1;
+    opts->as_cache_size = 0;
+    opts->skip_unchanged = 0;
     return;
 }
 
@@ -141,6 +143,18 @@ void dense_qp_daqp_opts_set(void *config_, void *opts_, const char *field, void
         int *warm_start = value;
         opts->warm_start = *warm_start;
     }
+    else if (!strcmp(field, "as_cache_size"))
+    {
+        // NOTE: has to be set before the memory is created
+        int *as_cache_size = value;
+        opts->as_cache_size = *as_cache_size;
+    }
+    else if (!strcmp(field, "skip_unchanged"))
+    {
+        // NOTE: has to be set before the memory is created
+        int *skip_unchanged = value;
+        opts->skip_unchanged = *skip_unchanged;
+    }
     else
     {
         printf("\nerror: dense_qp_daqp_opts_set: wrong field: %s\n", field);
@@ -203,6 +217,8 @@ static acados_size_t daqp_workspace_calculate_size(int n, int m, int ms, int ns)
 
 acados_size_t dense_qp_daqp_memory_calculate_size(void *config_, dense_qp_dims *dims, void *opts_)
 {
+    dense_qp_daqp_opts *opts = opts_;
+
     int n = dims->nv;
     int m = dims->nv + dims->ng + dims->ne;
     int ms = dims->nv;
@@ -224,6 +240,12 @@ acados_size_t dense_qp_daqp_memory_calculate_size(void *config_, dense_qp_dims *
     size += ns * 6 * sizeof(c_float); // Zl,Zu,zl,zu,d_ls,d_us
     make_int_multiple_of(8, &size);
 
+    if (opts->skip_unchanged)
+        size += (n * n + n * (m-ms)) * sizeof(c_float); // H_prev, A_prev
+
+    if (opts->as_cache_size > 0)
+        size += dense_qp_as_cache_calculate_size(dims, opts->as_cache_size);
+
     return size;
 }
 
@@ -351,6 +373,7 @@ static void *daqp_workspace_assign(int n, int m, int ms, int ns, void *raw_memor
 void *dense_qp_daqp_memory_assign(void *config_, dense_qp_dims *dims, void *opts_,
                                      void *raw_memory)
 {
+    dense_qp_daqp_opts *opts = opts_;
     dense_qp_daqp_memory *mem;
 
     int n = dims->nv;
@@ -414,6 +437,27 @@ void *dense_qp_daqp_memory_assign(void *config_, dense_qp_dims *dims, void *opts
     mem->d_us = (c_float *) c_ptr;
     c_ptr += ns * 1 * sizeof(c_float);
 
+    align_char_to(8, &c_ptr);
+
+    mem->skip_unchanged = opts->skip_unchanged;
+    mem->first_run = 1;
+    mem->matrices_changed = 1;
+    if (mem->skip_unchanged)
+    {
+        mem->H_prev = (c_float *) c_ptr;
+        c_ptr += n * n * sizeof(c_float);
+
+        mem->A_prev = (c_float *) c_ptr;
+        c_ptr += n * (m-ms) * sizeof(c_float);
+    }
+
+    mem->as_cache = NULL;
+    if (opts->as_cache_size > 0)
+    {
+        mem->as_cache = dense_qp_as_cache_assign(dims, opts->as_cache_size, c_ptr);
+        c_ptr += dense_qp_as_cache_calculate_size(dims, opts->as_cache_size);
+    }
+
     assert((char *) raw_memory + dense_qp_daqp_memory_calculate_size(config_, dims, opts_) >=
            c_ptr);
 
@@ -437,6 +481,20 @@ void dense_qp_daqp_memory_get(void *config_, void *mem_, const char *field, void
         int *tmp_ptr = value;
         *tmp_ptr = mem->iter;
     }
+    else if (!strcmp(field, "as_cache_hit") || !strcmp(field, "as_cache_num_hits"))
+    {
+        if (mem->as_cache == NULL)
+        {
+            printf("\nerror: dense_qp_daqp_memory_get: field %s requires as_cache_size > 0\n", field);
+            exit(1);
+        }
+        dense_qp_as_cache_get(mem->as_cache, field+strlen("as_cache_"), value);
+    }
+    else if (!strcmp(field, "matrices_changed"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->matrices_changed;
+    }
     else
     {
         printf("\nerror: dense_qp_daqp_memory_get: field %s not available\n", field);
@@ -604,6 +662,30 @@ static void dense_qp_daqp_update_memory(dense_qp_in *qp_in, const dense_qp_daqp_
 
 
 
+// LDP update: Rinv (and M) are only recomputed if H (or A) changed since the last setup
+static int dense_qp_daqp_update_mask(dense_qp_daqp_memory *mem)
+{
+    DAQPWorkspace *work = mem->daqp_work;
+    int n = work->n;
+    int nA = n * (work->m - work->ms);
+
+    int H_changed = track_changes(n * n, work->qp->H, mem->H_prev);
+    int A_changed = track_changes(nA, work->qp->A, mem->A_prev);
+    H_changed = H_changed || mem->first_run;
+    mem->first_run = 0;
+
+    mem->matrices_changed = H_changed || A_changed;
+
+    if (H_changed)
+        return UPDATE_Rinv+UPDATE_M+UPDATE_v+UPDATE_d;
+    else if (A_changed)
+        return UPDATE_M+UPDATE_v+UPDATE_d;
+    else
+        return UPDATE_v+UPDATE_d;
+}
+
+
+
 static void dense_qp_daqp_fill_output(dense_qp_daqp_memory *mem, const dense_qp_out *qp_out, const dense_qp_in *qp_in)
 {
     int *idxv_to_idxb = mem->idxv_to_idxb;
@@ -730,6 +812,20 @@ int dense_qp_daqp(void* config_, dense_qp_in *qp_in, dense_qp_out *qp_out, void
     dense_qp_daqp_opts *opts = (dense_qp_daqp_opts *) opts_;
     dense_qp_daqp_memory *memory = (dense_qp_daqp_memory *) memory_;
 
+    // try the cached active sets, no DAQP iterations on a hit
+    if (memory->as_cache != NULL &&
+        dense_qp_as_cache_solve(qp_in, qp_out, memory->as_cache, opts->daqp_opts->primal_tol))
+    {
+        info->t_computed = 1;
+        info->interface_time = 0;
+        info->solve_QP_time = acados_toc(&interface_timer);
+        info->total_time = acados_toc(&tot_timer);
+        info->num_iter = 0;
+        memory->time_qp_solver_call = info->solve_QP_time;
+        memory->iter = 0;
+        return ACADOS_SUCCESS;
+    }
+
     // Move data into daqp workspace
     dense_qp_daqp_update_memory(qp_in,opts,memory);
     info->interface_time = acados_toc(&interface_timer);
@@ -743,8 +839,12 @@ int dense_qp_daqp(void* config_, dense_qp_in *qp_in, dense_qp_out *qp_out, void
     if (opts->warm_start==0) deactivate_constraints(work);
     // setup LDP
     int update_mask,daqp_status;
-    update_mask= (opts->warm_start==2) ?
-        UPDATE_v+UPDATE_d: UPDATE_Rinv+UPDATE_M+UPDATE_v+UPDATE_d;
+    if (opts->warm_start==2)
+        update_mask = UPDATE_v+UPDATE_d;
+    else if (memory->skip_unchanged)
+        update_mask = dense_qp_daqp_update_mask(memory);
+    else
+        update_mask = UPDATE_Rinv+UPDATE_M+UPDATE_v+UPDATE_d;
     daqp_status = update_ldp(update_mask,work);
     // if setup failed, abort
     if(daqp_status < 0)
@@ -781,6 +881,9 @@ int dense_qp_daqp(void* config_, dense_qp_in *qp_in, dense_qp_out *qp_out, void
         acados_status = ACADOS_SUCCESS;
     else if (daqp_status == EXIT_ITERLIMIT)
         acados_status = ACADOS_MAXITER;
+
+    if (memory->as_cache != NULL && acados_status == ACADOS_SUCCESS)
+        dense_qp_as_cache_store(qp_in, qp_out, memory->as_cache, opts->daqp_opts->primal_tol);
     // NOTE: There are also:
     // EXIT_INFEASIBLE, EXIT_CYCLE, EXIT_UNBOUNDED, EXIT_NONCONVEX, EXIT_OVERDETERMINED_INITIAL
 
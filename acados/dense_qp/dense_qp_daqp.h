@@ -43,6 +43,7 @@ extern "C" {
 #include "daqp/include/types.h"
 
 // acados
+#include "acados/dense_qp/dense_qp_as_cache.h"
 #include "acados/dense_qp/dense_qp_common.h"
 #include "acados/utils/types.h"
 
@@ -51,6 +52,8 @@ typedef struct dense_qp_daqp_opts_
 {
     DAQPSettings* daqp_opts;
     int warm_start;
+    int as_cache_size;  // number of cached active sets, 0: no active-set cache
+    int skip_unchanged;  // no factorization of H (and update of M) if H and A did not change
 } dense_qp_daqp_opts;
 
 
@@ -71,9 +74,17 @@ typedef struct dense_qp_daqp_memory_
     double* d_ls;
     double* d_us;
 
+    // change tracking: H and A passed to DAQP in the last setup
+    int skip_unchanged;
+    int first_run;
+    int matrices_changed;
+    double* H_prev;
+    double* A_prev;
+
     double time_qp_solver_call;
     int iter;
     DAQPWorkspace * daqp_work;
+    dense_qp_as_cache *as_cache;  // NULL if as_cache_size is 0
 
 } dense_qp_daqp_memory;
 
@@ -121,6 +121,8 @@ void dense_qp_qpoases_opts_initialize_default(void *config_, dense_qp_dims *dims
     opts->set_acado_opts = 1;
     opts->compute_t = 1;
     opts->tolerance = 1e-4;
+    opts->as_cache_size = 0;
+    opts->as_cache_tol = 1e-8;
 
     return;
 }
@@ -189,6 +191,17 @@ void dense_qp_qpoases_opts_set(void *config_, void *opts_, const char *field, vo
         int *max_iter = value;
         opts->max_nwsr = *max_iter;
     }
+    else if (!strcmp(field, "as_cache_size"))
+    {
+        // NOTE: has to be set before the memory is created
+        int *as_cache_size = value;
+        opts->as_cache_size = *as_cache_size;
+    }
+    else if (!strcmp(field, "as_cache_tol"))
+    {
+        double *as_cache_tol = value;
+        opts->as_cache_tol = *as_cache_tol;
+    }
     else
     {
         printf("\nerror: dense_qp_qpoases_opts_set: wrong field: %s\n", field);
@@ -213,6 +226,7 @@ void dense_qp_qpoases_opts_get(void *config_, void *opts_, const char *field, vo
 
 acados_size_t dense_qp_qpoases_memory_calculate_size(void *config_, dense_qp_dims *dims, void *opts_)
 {
+    dense_qp_qpoases_opts *opts = opts_;
     dense_qp_dims dims_stacked;
 
     int nv = dims->nv;
@@ -270,6 +284,9 @@ acados_size_t dense_qp_qpoases_memory_calculate_size(void *config_, dense_qp_dim
 
     make_int_multiple_of(8, &size);
 
+    if (opts->as_cache_size > 0)
+        size += dense_qp_as_cache_calculate_size(dims, opts->as_cache_size);
+
     return size;
 }
 
@@ -278,6 +295,7 @@ acados_size_t dense_qp_qpoases_memory_calculate_size(void *config_, dense_qp_dim
 void *dense_qp_qpoases_memory_assign(void *config_, dense_qp_dims *dims, void *opts_,
                                      void *raw_memory)
 {
+    dense_qp_qpoases_opts *opts = opts_;
     dense_qp_qpoases_memory *mem;
     dense_qp_dims dims_stacked;
 
@@ -361,6 +379,15 @@ void *dense_qp_qpoases_memory_assign(void *config_, dense_qp_dims *dims, void *o
     assign_and_advance_int(ns, &mem->idxs, &c_ptr);
     assign_and_advance_int(nb+ng, &mem->idxs_rev, &c_ptr);
 
+    align_char_to(8, &c_ptr);
+
+    mem->as_cache = NULL;
+    if (opts->as_cache_size > 0)
+    {
+        mem->as_cache = dense_qp_as_cache_assign(dims, opts->as_cache_size, c_ptr);
+        c_ptr += dense_qp_as_cache_calculate_size(dims, opts->as_cache_size);
+    }
+
     assert((char *) raw_memory + dense_qp_qpoases_memory_calculate_size(config_, dims, opts_) >=
            c_ptr);
 
@@ -387,6 +414,15 @@ void dense_qp_qpoases_memory_get(void *config_, void *mem_, const char *field, v
         int *tmp_ptr = value;
         *tmp_ptr = mem->iter;
     }
+    else if (!strcmp(field, "as_cache_hit") || !strcmp(field, "as_cache_num_hits"))
+    {
+        if (mem->as_cache == NULL)
+        {
+            printf("\nerror: dense_qp_qpoases_memory_get: field %s requires as_cache_size > 0\n", field);
+            exit(1);
+        }
+        dense_qp_as_cache_get(mem->as_cache, field+strlen("as_cache_"), value);
+    }
     else
     {
         printf("\nerror: dense_qp_qpoases_memory_get: field %s not available\n", field);
@@ -428,6 +464,20 @@ int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, vo
     dense_qp_qpoases_opts *opts = (dense_qp_qpoases_opts *) opts_;
     dense_qp_qpoases_memory *memory = (dense_qp_qpoases_memory *) memory_;
 
+    // try the cached active sets, no working set recalculations on a hit
+    if (memory->as_cache != NULL &&
+        dense_qp_as_cache_solve(qp_in, qp_out, memory->as_cache, opts->as_cache_tol))
+    {
+        info->t_computed = 1;
+        info->interface_time = 0;
+        info->solve_QP_time = acados_toc(&interface_timer);
+        info->total_time = acados_toc(&tot_timer);
+        info->num_iter = 0;
+        memory->time_qp_solver_call = info->solve_QP_time;
+        memory->iter = 0;
+        return ACADOS_SUCCESS;
+    }
+
     // extract qpoases data
     double *H = memory->H;
     double *HH = memory->HH;
@@ -784,6 +834,10 @@ int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, vo
     int acados_status = qpoases_status;
     if (qpoases_status == SUCCESSFUL_RETURN) acados_status = ACADOS_SUCCESS;
     if (qpoases_status == RET_MAX_NWSR_REACHED) acados_status = ACADOS_MAXITER;
+
+    if (memory->as_cache != NULL && acados_status == ACADOS_SUCCESS)
+        dense_qp_as_cache_store(qp_in, qp_out, memory->as_cache, opts->as_cache_tol);
+
     return acados_status;
 }
 
@@ -40,6 +40,7 @@ extern "C" {
 #include "blasfeo_common.h"
 
 // acados
+#include "acados/dense_qp/dense_qp_as_cache.h"
 #include "acados/dense_qp/dense_qp_common.h"
 #include "acados/utils/types.h"
 
@@ -54,6 +55,8 @@ typedef struct dense_qp_qpoases_opts_
     int set_acado_opts;  // use same options as in acado code generation
     int compute_t;       // compute t in qp_out (to have correct residuals in NLP)
     double tolerance;  // terminationTolerance
+    int as_cache_size;  // number of cached active sets, 0: no active-set cache
+    double as_cache_tol;  // feasibility tolerance of the solution from a cached active set
 } dense_qp_qpoases_opts;
 
 typedef struct dense_qp_qpoases_memory_
@@ -93,6 +96,7 @@ typedef struct dense_qp_qpoases_memory_
     int nwsr;        // performed number of working set recalculations
     int first_it;    // to be used with hotstart
     dense_qp_in *qp_stacked;
+    dense_qp_as_cache *as_cache;  // NULL if as_cache_size is 0
     double time_qp_solver_call; // equal to cputime
     int iter;
 
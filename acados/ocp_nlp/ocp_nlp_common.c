@@ -979,6 +979,38 @@ acados_size_t ocp_nlp_out_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *d
 
 
 
+static void ocp_nlp_out_assign_vec_mem(ocp_nlp_dims *dims, ocp_nlp_out *out, char **c_ptr)
+{
+    int N = dims->N;
+    int *nv = dims->nv;
+    int *nx = dims->nx;
+    int *ni = dims->ni;
+    int *nz = dims->nz;
+
+    // ux
+    for (int i = 0; i <= N; ++i)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nv[i], out->ux + i, c_ptr);
+    }
+    // z
+    for (int i = 0; i <= N; ++i)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nz[i], out->z + i, c_ptr);
+    }
+    // pi
+    for (int i = 0; i < N; ++i)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nx[i + 1], out->pi + i, c_ptr);
+    }
+    // lam
+    for (int i = 0; i <= N; ++i)
+    {
+        assign_and_advance_blasfeo_dvec_mem(2 * ni[i], out->lam + i, c_ptr);
+    }
+}
+
+
+
 ocp_nlp_out *ocp_nlp_out_assign(ocp_nlp_config *config, ocp_nlp_dims *dims, void *raw_memory)
 {
     // extract sizes
@@ -1014,26 +1046,8 @@ ocp_nlp_out *ocp_nlp_out_assign(ocp_nlp_config *config, ocp_nlp_dims *dims, void
     align_char_to(64, &c_ptr);
 
     // blasfeo_dvec
-    // ux
-    for (int i = 0; i <= N; ++i)
-    {
-        assign_and_advance_blasfeo_dvec_mem(nv[i], out->ux + i, &c_ptr);
-    }
-    // z
-    for (int i = 0; i <= N; ++i)
-    {
-        assign_and_advance_blasfeo_dvec_mem(nz[i], out->z + i, &c_ptr);
-    }
-    // pi
-    for (int i = 0; i < N; ++i)
-    {
-        assign_and_advance_blasfeo_dvec_mem(nx[i + 1], out->pi + i, &c_ptr);
-    }
-    // lam
-    for (int i = 0; i <= N; ++i)
-    {
-        assign_and_advance_blasfeo_dvec_mem(2 * ni[i], out->lam + i, &c_ptr);
-    }
+    out->vec_memory = c_ptr;
+    ocp_nlp_out_assign_vec_mem(dims, out, &c_ptr);
 
     // zero solution
     for(int i=0; i<N; i++)
@@ -1054,6 +1068,127 @@ ocp_nlp_out *ocp_nlp_out_assign(ocp_nlp_config *config, ocp_nlp_dims *dims, void
 
 
 
+int ocp_nlp_out_packed_size(ocp_nlp_dims *dims)
+{
+    int N = dims->N;
+    int size = 0;
+
+    for (int i = 0; i <= N; i++)
+    {
+        size += dims->nv[i] + dims->nz[i] + 2 * dims->ni[i];
+    }
+    for (int i = 0; i < N; i++)
+    {
+        size += dims->nx[i + 1];
+    }
+
+    return size;
+}
+
+
+
+void ocp_nlp_out_alias_memory(ocp_nlp_dims *dims, ocp_nlp_out *out, double *buffer)
+{
+    int N = dims->N;
+    int *nv = dims->nv;
+    int *nx = dims->nx;
+    int *ni = dims->ni;
+    int *nz = dims->nz;
+
+    if (buffer == NULL)
+    {
+        char *c_ptr = out->vec_memory;
+        ocp_nlp_out_assign_vec_mem(dims, out, &c_ptr);
+        return;
+    }
+
+    // the vectors are packed back to back, so only the alignment of double is required
+    if ((size_t) buffer % sizeof(double) != 0)
+    {
+        printf("\nerror: ocp_nlp_out_alias_memory: buffer has to be aligned to %d bytes.\n",
+               (int) sizeof(double));
+        exit(1);
+    }
+
+    // packed, i.e. without the padding of the blasfeo memory
+    double *d_ptr = buffer;
+    for (int i = 0; i <= N; i++)
+    {
+        blasfeo_create_dvec(nv[i], out->ux + i, d_ptr);
+        d_ptr += nv[i];
+    }
+    for (int i = 0; i <= N; i++)
+    {
+        blasfeo_create_dvec(nz[i], out->z + i, d_ptr);
+        d_ptr += nz[i];
+    }
+    for (int i = 0; i < N; i++)
+    {
+        blasfeo_create_dvec(nx[i + 1], out->pi + i, d_ptr);
+        d_ptr += nx[i + 1];
+    }
+    for (int i = 0; i <= N; i++)
+    {
+        blasfeo_create_dvec(2 * ni[i], out->lam + i, d_ptr);
+        d_ptr += 2 * ni[i];
+    }
+
+    return;
+}
+
+
+
+void ocp_nlp_out_shift(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_memory *mem,
+                       ocp_nlp_out *out, ocp_shift_tail_policy tail_policy)
+{
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *ns = dims->ns;
+    int *ni = dims->ni;
+    int *nz = dims->nz;
+
+    // NOTE: the vectors are copied instead of swapping the structs,
+    // such that out keeps its layout if it is aliased to a packed buffer
+    for (int i = 0; i < N; i++)
+    {
+        if (nu[i] == nu[i+1])
+            blasfeo_dveccp(nu[i], out->ux+i+1, 0, out->ux+i, 0);
+        if (nx[i] == nx[i+1])
+            blasfeo_dveccp(nx[i], out->ux+i+1, nu[i+1], out->ux+i, nu[i]);
+        if (ns[i] == ns[i+1])
+            blasfeo_dveccp(2*ns[i], out->ux+i+1, nu[i+1]+nx[i+1], out->ux+i, nu[i]+nx[i]);
+        if (nz[i] == nz[i+1])
+            blasfeo_dveccp(nz[i], out->z+i+1, 0, out->z+i, 0);
+        // lam only if the constraints match, including the number of nonlinear ones (nh or nphi)
+        int ni_nl, ni_nl_next;
+        config->constraints[i]->dims_get(config->constraints[i], dims->constraints[i], "ni_nl", &ni_nl);
+        config->constraints[i+1]->dims_get(config->constraints[i+1], dims->constraints[i+1], "ni_nl", &ni_nl_next);
+        if (ni_nl == ni_nl_next && ocp_qp_in_constraints_match_next_stage(mem->qp_in, i))
+            blasfeo_dveccp(2*ni[i], out->lam+i+1, 0, out->lam+i, 0);
+        else if (tail_policy == SHIFT_TAIL_ZERO)
+            blasfeo_dvecse(2*ni[i], 0.0, out->lam+i, 0);
+        if (i < N-1 && nx[i+1] == nx[i+2])
+            blasfeo_dveccp(nx[i+1], out->pi+i+1, 0, out->pi+i, 0);
+    }
+
+    if (tail_policy == SHIFT_TAIL_ZERO)
+    {
+        if (N > 0)
+        {
+            blasfeo_dvecse(nu[N-1], 0.0, out->ux+N-1, 0);
+            blasfeo_dvecse(nx[N], 0.0, out->pi+N-1, 0);
+        }
+        blasfeo_dvecse(nu[N]+nx[N]+2*ns[N], 0.0, out->ux+N, 0);
+        blasfeo_dvecse(nz[N], 0.0, out->z+N, 0);
+        blasfeo_dvecse(2*ni[N], 0.0, out->lam+N, 0);
+    }
+
+    return;
+}
+
+
+
 /************************************************
  * options
  ************************************************/
@@ -1193,6 +1328,9 @@ void ocp_nlp_opts_initialize_default(void *config_, void *dims_, void *opts_)
     int N = dims->N;
 
     opts->reuse_workspace = 1;
+    opts->with_stage_load_balancing = false;
+    opts->with_batched_dynamics = false;
+    opts->line_search_num_candidates = 1;
 #if defined(ACADOS_WITH_OPENMP)
     #if defined(ACADOS_NUM_THREADS)
     opts->num_threads = ACADOS_NUM_THREADS;
@@ -1372,8 +1510,33 @@ void ocp_nlp_opts_set(void *config_, void *opts_, const char *field, void* value
         else if (!strcmp(field, "num_threads"))
         {
             int* num_threads = (int *) value;
+            if (*num_threads < 1)
+            {
+                printf("\nerror: ocp_nlp_opts_set: invalid value for num_threads field, need int >= 1, got %d.\n", *num_threads);
+                exit(1);
+            }
             opts->num_threads = *num_threads;
         }
+        else if (!strcmp(field, "with_stage_load_balancing"))
+        {
+            bool* with_stage_load_balancing = (bool *) value;
+            opts->with_stage_load_balancing = *with_stage_load_balancing;
+        }
+        else if (!strcmp(field, "with_batched_dynamics"))
+        {
+            bool* with_batched_dynamics = (bool *) value;
+            opts->with_batched_dynamics = *with_batched_dynamics;
+        }
+        else if (!strcmp(field, "line_search_num_candidates"))
+        {
+            int* line_search_num_candidates = (int *) value;
+            if (*line_search_num_candidates < 1)
+            {
+                printf("\nerror: ocp_nlp_opts_set: invalid value for line_search_num_candidates field, need int >= 1, got %d.\n", *line_search_num_candidates);
+                exit(1);
+            }
+            opts->line_search_num_candidates = *line_search_num_candidates;
+        }
         else if (!strcmp(field, "ext_qp_res"))
         {
             int* ext_qp_res = (int *) value;
@@ -1698,6 +1861,124 @@ void ocp_nlp_opts_set_at_stage(void *config_, void *opts_, int stage, const char
  * memory
  ************************************************/
 
+/* A line search candidate replica holds its own stage module memories and workspaces, such that
+ * several trial points can be evaluated at the same time. The replica workspaces are live together
+ * with the nominal ones, thus they are kept with the replica instead of the planned workspace. */
+static acados_size_t ocp_nlp_candidate_replica_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_opts *opts)
+{
+    ocp_nlp_dynamics_config **dynamics = config->dynamics;
+    ocp_nlp_cost_config **cost = config->cost;
+    ocp_nlp_constraints_config **constraints = config->constraints;
+
+    int N = dims->N;
+
+    acados_size_t size = 0;
+
+    // pointers to module memory and workspace
+    size += 2 * N * sizeof(void *);        // dynamics
+    size += 4 * (N + 1) * sizeof(void *);  // cost constraints
+
+    // set_sim_guess
+    size += (N + 1) * sizeof(bool);
+
+    // trial iterate
+    size += ocp_nlp_out_calculate_size(config, dims);
+
+    for (int i = 0; i < N; i++)
+    {
+        size += dynamics[i]->memory_calculate_size(dynamics[i], dims->dynamics[i], opts->dynamics[i]);
+        size += dynamics[i]->workspace_calculate_size(dynamics[i], dims->dynamics[i], opts->dynamics[i]);
+    }
+    for (int i = 0; i <= N; i++)
+    {
+        size += cost[i]->memory_calculate_size(cost[i], dims->cost[i], opts->cost[i]);
+        size += cost[i]->workspace_calculate_size(cost[i], dims->cost[i], opts->cost[i]);
+    }
+    for (int i = 0; i <= N; i++)
+    {
+        size += constraints[i]->memory_calculate_size(constraints[i], dims->constraints[i], opts->constraints[i]);
+        size += constraints[i]->workspace_calculate_size(constraints[i], dims->constraints[i], opts->constraints[i]);
+    }
+
+    size += 8;  // align
+
+    return size;
+}
+
+
+
+static void ocp_nlp_candidate_replica_assign(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_opts *opts, ocp_nlp_candidate *cand, char **c_ptr_)
+{
+    ocp_nlp_dynamics_config **dynamics = config->dynamics;
+    ocp_nlp_cost_config **cost = config->cost;
+    ocp_nlp_constraints_config **constraints = config->constraints;
+
+    int N = dims->N;
+
+    char *c_ptr = *c_ptr_;
+
+    // pointers to module memory and workspace
+    cand->dynamics = (void **) c_ptr;
+    c_ptr += N*sizeof(void *);
+    cand->dynamics_work = (void **) c_ptr;
+    c_ptr += N*sizeof(void *);
+    cand->cost = (void **) c_ptr;
+    c_ptr += (N+1)*sizeof(void *);
+    cand->cost_work = (void **) c_ptr;
+    c_ptr += (N+1)*sizeof(void *);
+    cand->constraints = (void **) c_ptr;
+    c_ptr += (N+1)*sizeof(void *);
+    cand->constraints_work = (void **) c_ptr;
+    c_ptr += (N+1)*sizeof(void *);
+
+    // set_sim_guess
+    assign_and_advance_bool(N+1, &cand->set_sim_guess, &c_ptr);
+    for (int i = 0; i <= N; i++)
+    {
+        cand->set_sim_guess[i] = false;
+    }
+
+    align_char_to(8, &c_ptr);
+
+    // trial iterate
+    cand->nlp_out = ocp_nlp_out_assign(config, dims, c_ptr);
+    c_ptr += ocp_nlp_out_calculate_size(config, dims);
+
+    // dynamics
+    for (int i = 0; i < N; i++)
+    {
+        cand->dynamics[i] = dynamics[i]->memory_assign(dynamics[i], dims->dynamics[i], opts->dynamics[i], c_ptr);
+        c_ptr += dynamics[i]->memory_calculate_size(dynamics[i], dims->dynamics[i], opts->dynamics[i]);
+        cand->dynamics_work[i] = c_ptr;
+        c_ptr += dynamics[i]->workspace_calculate_size(dynamics[i], dims->dynamics[i], opts->dynamics[i]);
+    }
+
+    // cost
+    for (int i = 0; i <= N; i++)
+    {
+        cand->cost[i] = cost[i]->memory_assign(cost[i], dims->cost[i], opts->cost[i], c_ptr);
+        c_ptr += cost[i]->memory_calculate_size(cost[i], dims->cost[i], opts->cost[i]);
+        cand->cost_work[i] = c_ptr;
+        c_ptr += cost[i]->workspace_calculate_size(cost[i], dims->cost[i], opts->cost[i]);
+    }
+
+    // constraints
+    for (int i = 0; i <= N; i++)
+    {
+        cand->constraints[i] = constraints[i]->memory_assign(constraints[i], dims->constraints[i],
+                                                             opts->constraints[i], c_ptr);
+        c_ptr += constraints[i]->memory_calculate_size(constraints[i], dims->constraints[i], opts->constraints[i]);
+        cand->constraints_work[i] = c_ptr;
+        c_ptr += constraints[i]->workspace_calculate_size(constraints[i], dims->constraints[i], opts->constraints[i]);
+    }
+
+    *c_ptr_ = c_ptr;
+}
+
+
+
 acados_size_t ocp_nlp_memory_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_opts *opts, ocp_nlp_in *nlp_in)
 {
     ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
@@ -1807,6 +2088,9 @@ acados_size_t ocp_nlp_memory_calculate_size(ocp_nlp_config *config, ocp_nlp_dims
     {
         size += opts->max_iter*sizeof(double);
     }
+    // stage load balancing
+    size += (N+1)*sizeof(double); // stage_lin_time
+    size += (N+2)*sizeof(int); // stage_partition
 
     size += (N+1)*sizeof(struct blasfeo_dmat); // dzduxt
     size += 6*(N+1)*sizeof(struct blasfeo_dvec);  // cost_grad ineq_fun ineq_adj dyn_adj sim_guess z_alg
@@ -1830,8 +2114,17 @@ acados_size_t ocp_nlp_memory_calculate_size(ocp_nlp_config *config, ocp_nlp_dims
     size += 1*blasfeo_memsize_dvec(nx[N] + nz[N]);  // sim_guess
     size += 1 * blasfeo_memsize_dvec(np_global); //  out_np_global;
 
+    // line search candidates
+    size += opts->line_search_num_candidates * sizeof(ocp_nlp_candidate);
+    size += 3 * opts->line_search_num_candidates * (N+1) * sizeof(double); // merit_cost merit_dyn merit_constr
+    for (int k = 1; k < opts->line_search_num_candidates; k++)
+    {
+        size += ocp_nlp_candidate_replica_calculate_size(config, dims, opts);
+    }
+
     size += 8;   // initial align
     size += 8;   // middle align
+    size += 8;   // candidates align
     size += 8;   // blasfeo_struct align
     size += 64;  // blasfeo_mem align
 
@@ -2018,6 +2311,16 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
         c_ptr += opts->max_iter*sizeof(double);
     }
 
+    // stage load balancing
+    assign_and_advance_double(N+1, &mem->stage_lin_time, &c_ptr);
+    for (i = 0; i <= N; ++i)
+    {
+        mem->stage_lin_time[i] = 0.0;
+    }
+    assign_and_advance_int(N+2, &mem->stage_partition, &c_ptr);
+
+    mem->dynamics_batched = 0;
+
     // set_sim_guess
     assign_and_advance_bool(N+1, &mem->set_sim_guess, &c_ptr);
     for (i = 0; i <= N; ++i)
@@ -2025,6 +2328,26 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
         mem->set_sim_guess[i] = false;
     }
 
+    // line search candidates
+    align_char_to(8, &c_ptr);
+    mem->candidates = (ocp_nlp_candidate *) c_ptr;
+    c_ptr += opts->line_search_num_candidates * sizeof(ocp_nlp_candidate);
+    for (i = 0; i < opts->line_search_num_candidates; i++)
+    {
+        assign_and_advance_double(N+1, &mem->candidates[i].merit_cost, &c_ptr);
+        assign_and_advance_double(N+1, &mem->candidates[i].merit_dyn, &c_ptr);
+        assign_and_advance_double(N+1, &mem->candidates[i].merit_constr, &c_ptr);
+    }
+    // nominal candidate, nlp_out and workspace are set in ocp_nlp_workspace_assign
+    mem->candidates[0].dynamics = mem->dynamics;
+    mem->candidates[0].cost = mem->cost;
+    mem->candidates[0].constraints = mem->constraints;
+    mem->candidates[0].set_sim_guess = mem->set_sim_guess;
+    for (i = 1; i < opts->line_search_num_candidates; i++)
+    {
+        ocp_nlp_candidate_replica_assign(config, dims, opts, mem->candidates+i, &c_ptr);
+    }
+
     // blasfeo_mem align
     align_char_to(64, &c_ptr);
 
@@ -2098,7 +2421,15 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
  * workspace
  ************************************************/
 
-acados_size_t ocp_nlp_workspace_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_opts *opts, ocp_nlp_in *in)
+/* Module workspaces are planned according to the phases in which they are live:
+ * the qp solver workspace is only used while solving the QP (and evaluating its
+ * sensitivities), the stage module and external function workspaces only
+ * during linearization and globalization. With reuse_workspace, the two phases
+ * share the same buffer; stage workspaces are only overlapped among each other
+ * if the stages are evaluated sequentially. */
+static void ocp_nlp_workspace_modules_get_sizes(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_opts *opts, ocp_nlp_in *in, int reuse, acados_size_t *qp_size,
+        acados_size_t *stage_size, acados_size_t *ext_fun_size)
 {
     ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
     ocp_nlp_dynamics_config **dynamics = config->dynamics;
@@ -2106,6 +2437,187 @@ acados_size_t ocp_nlp_workspace_calculate_size(ocp_nlp_config *config, ocp_nlp_d
     ocp_nlp_constraints_config **constraints = config->constraints;
 
     int N = dims->N;
+
+#if defined(ACADOS_WITH_OPENMP)
+    // stages are evaluated in parallel, their workspaces are live at the same time
+    int overlap_stages = 0;
+#else
+    int overlap_stages = reuse;
+#endif
+
+    acados_size_t tmp;
+
+    *qp_size = qp_solver->workspace_calculate_size(qp_solver, dims->qp_solver, opts->qp_solver_opts);
+    *stage_size = 0;
+    *ext_fun_size = 0;
+
+    // dynamics
+    for (int i = 0; i < N; i++)
+    {
+        tmp = dynamics[i]->workspace_calculate_size(dynamics[i], dims->dynamics[i], opts->dynamics[i]);
+        *stage_size = overlap_stages ? (tmp > *stage_size ? tmp : *stage_size) : *stage_size + tmp;
+        tmp = dynamics[i]->get_external_fun_workspace_requirement(dynamics[i], dims->dynamics[i], opts->dynamics[i], in->dynamics[i]);
+        *ext_fun_size = overlap_stages ? (tmp > *ext_fun_size ? tmp : *ext_fun_size) : *ext_fun_size + tmp;
+    }
+
+    // cost
+    for (int i = 0; i <= N; i++)
+    {
+        tmp = cost[i]->workspace_calculate_size(cost[i], dims->cost[i], opts->cost[i]);
+        *stage_size = overlap_stages ? (tmp > *stage_size ? tmp : *stage_size) : *stage_size + tmp;
+        tmp = cost[i]->get_external_fun_workspace_requirement(cost[i], dims->cost[i], opts->cost[i], in->cost[i]);
+        *ext_fun_size = overlap_stages ? (tmp > *ext_fun_size ? tmp : *ext_fun_size) : *ext_fun_size + tmp;
+    }
+
+    // constraints
+    for (int i = 0; i <= N; i++)
+    {
+        tmp = constraints[i]->workspace_calculate_size(constraints[i], dims->constraints[i], opts->constraints[i]);
+        *stage_size = overlap_stages ? (tmp > *stage_size ? tmp : *stage_size) : *stage_size + tmp;
+        tmp = constraints[i]->get_external_fun_workspace_requirement(constraints[i], dims->constraints[i], opts->constraints[i], in->constraints[i]);
+        *ext_fun_size = overlap_stages ? (tmp > *ext_fun_size ? tmp : *ext_fun_size) : *ext_fun_size + tmp;
+    }
+
+    return;
+}
+
+
+
+static acados_size_t ocp_nlp_workspace_modules_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_opts *opts, ocp_nlp_in *in, int reuse)
+{
+    acados_size_t qp_size, stage_size, ext_fun_size;
+    ocp_nlp_workspace_modules_get_sizes(config, dims, opts, in, reuse, &qp_size, &stage_size, &ext_fun_size);
+
+    // linearization phase: stage module workspaces, aligned external function workspaces
+    acados_size_t lin_size = stage_size + 64 + ext_fun_size;
+
+    if (reuse)
+        return qp_size > lin_size ? qp_size : lin_size;
+    else
+        return qp_size + lin_size;
+}
+
+
+
+static void ocp_nlp_workspace_modules_assign(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_opts *opts, ocp_nlp_in *nlp_in, ocp_nlp_workspace *work, int reuse, char **c_ptr_)
+{
+    ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
+    ocp_nlp_dynamics_config **dynamics = config->dynamics;
+    ocp_nlp_cost_config **cost = config->cost;
+    ocp_nlp_constraints_config **constraints = config->constraints;
+
+    int N = dims->N;
+
+#if defined(ACADOS_WITH_OPENMP)
+    int overlap_stages = 0;
+#else
+    int overlap_stages = reuse;
+#endif
+
+    char *c_ptr = *c_ptr_;
+    char *c_ptr_start = c_ptr;
+    acados_size_t size, size_max;
+
+    // qp solver
+    acados_size_t qp_size = qp_solver->workspace_calculate_size(qp_solver, dims->qp_solver, opts->qp_solver_opts);
+    work->qp_work = (void *) c_ptr;
+    if (!reuse)
+        c_ptr += qp_size;
+
+    // stage modules
+    size_max = 0;
+    for (int i = 0; i < N; i++)
+    {
+        work->dynamics[i] = c_ptr;
+        size = dynamics[i]->workspace_calculate_size(dynamics[i], dims->dynamics[i], opts->dynamics[i]);
+        if (overlap_stages)
+            size_max = size > size_max ? size : size_max;
+        else
+            c_ptr += size;
+    }
+    for (int i = 0; i <= N; i++)
+    {
+        work->cost[i] = c_ptr;
+        size = cost[i]->workspace_calculate_size(cost[i], dims->cost[i], opts->cost[i]);
+        if (overlap_stages)
+            size_max = size > size_max ? size : size_max;
+        else
+            c_ptr += size;
+    }
+    for (int i = 0; i <= N; i++)
+    {
+        work->constraints[i] = c_ptr;
+        size = constraints[i]->workspace_calculate_size(constraints[i], dims->constraints[i], opts->constraints[i]);
+        if (overlap_stages)
+            size_max = size > size_max ? size : size_max;
+        else
+            c_ptr += size;
+    }
+    c_ptr += size_max;
+
+    // align for external_function workspace
+    align_char_to(64, &c_ptr);
+
+    // external functions
+    size_max = 0;
+    for (int i = 0; i <= N; i++)
+    {
+        constraints[i]->set_external_fun_workspaces(constraints[i], dims->constraints[i], opts->constraints[i], nlp_in->constraints[i], c_ptr);
+        size = constraints[i]->get_external_fun_workspace_requirement(constraints[i], dims->constraints[i], opts->constraints[i], nlp_in->constraints[i]);
+        if (overlap_stages)
+            size_max = size > size_max ? size : size_max;
+        else
+            c_ptr += size;
+    }
+    for (int i = 0; i <= N; i++)
+    {
+        cost[i]->set_external_fun_workspaces(cost[i], dims->cost[i], opts->cost[i], nlp_in->cost[i], c_ptr);
+        size = cost[i]->get_external_fun_workspace_requirement(cost[i], dims->cost[i], opts->cost[i], nlp_in->cost[i]);
+        if (overlap_stages)
+            size_max = size > size_max ? size : size_max;
+        else
+            c_ptr += size;
+    }
+    for (int i = 0; i < N; i++)
+    {
+        dynamics[i]->set_external_fun_workspaces(dynamics[i], dims->dynamics[i], opts->dynamics[i], nlp_in->dynamics[i], c_ptr);
+        size = dynamics[i]->get_external_fun_workspace_requirement(dynamics[i], dims->dynamics[i], opts->dynamics[i], nlp_in->dynamics[i]);
+        if (overlap_stages)
+            size_max = size > size_max ? size : size_max;
+        else
+            c_ptr += size;
+    }
+    c_ptr += size_max;
+
+    // qp phase overlaps with linearization phase
+    if (reuse && c_ptr < c_ptr_start + qp_size)
+        c_ptr = c_ptr_start + qp_size;
+
+    *c_ptr_ = c_ptr;
+}
+
+
+
+static acados_size_t ocp_nlp_dynamics_batch_workspace_calculate_size(ocp_nlp_config *config,
+        ocp_nlp_dims *dims, ocp_nlp_opts *opts)
+{
+    int N = dims->N;
+
+    if (!opts->with_batched_dynamics || N < 1 || config->dynamics[0]->batch_workspace_calculate_size == NULL)
+        return 0;
+
+    return config->dynamics[0]->batch_workspace_calculate_size((void **) config->dynamics,
+                dims->dynamics, opts->dynamics, N);
+}
+
+
+
+static acados_size_t ocp_nlp_workspace_calculate_size_with_reuse(ocp_nlp_config *config,
+        ocp_nlp_dims *dims, ocp_nlp_opts *opts, ocp_nlp_in *in, int reuse)
+{
+    int N = dims->N;
     int np_global = dims->np_global;
 
     int *nx = dims->nx;
@@ -2172,156 +2684,31 @@ acados_size_t ocp_nlp_workspace_calculate_size(ocp_nlp_config *config, ocp_nlp_d
     // doubles
     size += nv_max * sizeof(double); // tmp_nv_double
 
-    // module workspace
-    if (opts->reuse_workspace)
-    {
-#if defined(ACADOS_WITH_OPENMP)
-        // qp solver
-        size += qp_solver->workspace_calculate_size(qp_solver, dims->qp_solver,
-            opts->qp_solver_opts);
-
-        // dynamics
-        for (int i = 0; i < N; i++)
-        {
-            size += dynamics[i]->workspace_calculate_size(dynamics[i], dims->dynamics[i], opts->dynamics[i]);
-        }
-
-        // cost
-        for (int i = 0; i <= N; i++)
-        {
-            size += cost[i]->workspace_calculate_size(cost[i], dims->cost[i], opts->cost[i]);
-        }
+    // module workspace (qp solver, stage modules, external functions)
+    size += ocp_nlp_workspace_modules_calculate_size(config, dims, opts, in, reuse);
 
-        // constraints
-        for (int i = 0; i <= N; i++)
-        {
-            size += constraints[i]->workspace_calculate_size(constraints[i], dims->constraints[i], opts->constraints[i]);
-        }
+    size += (ni_max + ns_max) * sizeof(int);
 
-#else
-        acados_size_t size_tmp = 0;
-        int tmp;
+    // batched dynamics, not overlapped with the stage modules
+    size += ocp_nlp_dynamics_batch_workspace_calculate_size(config, dims, opts);
 
-        // qp solver
-        tmp = qp_solver->workspace_calculate_size(qp_solver, dims->qp_solver, opts->qp_solver_opts);
-        size_tmp = tmp > size_tmp ? tmp : size_tmp;
+    size += 8; // struct align
+    size += 64; // blasfeo align
+    return size;
+}
 
-        // dynamics
-        for (int i = 0; i < N; i++)
-        {
-            tmp = dynamics[i]->workspace_calculate_size(dynamics[i], dims->dynamics[i], opts->dynamics[i]);
-            size_tmp = tmp > size_tmp ? tmp : size_tmp;
-        }
 
-        // cost
-        for (int i = 0; i <= N; i++)
-        {
-            tmp = cost[i]->workspace_calculate_size(cost[i], dims->cost[i], opts->cost[i]);
-            size_tmp = tmp > size_tmp ? tmp : size_tmp;
-        }
 
-        // constraints
-        for (int i = 0; i <= N; i++)
-        {
-            tmp = constraints[i]->workspace_calculate_size(constraints[i], dims->constraints[i], opts->constraints[i]);
-            size_tmp = tmp > size_tmp ? tmp : size_tmp;
-        }
+acados_size_t ocp_nlp_workspace_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_opts *opts, ocp_nlp_in *in)
+{
+    return ocp_nlp_workspace_calculate_size_with_reuse(config, dims, opts, in, opts->reuse_workspace);
+}
 
-        size += size_tmp;
-#endif
-    }
-    else
-    {
-        // qp solver
-        size += qp_solver->workspace_calculate_size(qp_solver, dims->qp_solver,
-            opts->qp_solver_opts);
 
-        // dynamics
-        for (int i = 0; i < N; i++)
-        {
-            size += dynamics[i]->workspace_calculate_size(dynamics[i], dims->dynamics[i], opts->dynamics[i]);
-        }
 
-        // cost
-        for (int i = 0; i <= N; i++)
-        {
-            size += cost[i]->workspace_calculate_size(cost[i], dims->cost[i], opts->cost[i]);
-        }
-
-        // constraints
-        for (int i = 0; i <= N; i++)
-        {
-            size += constraints[i]->workspace_calculate_size(constraints[i], dims->constraints[i], opts->constraints[i]);
-        }
-    }
-
-    size += (ni_max + ns_max) * sizeof(int);
-    size_t ext_fun_workspace_size = 0;
-    if (opts->reuse_workspace)
-    {
-#if defined(ACADOS_WITH_OPENMP)
-        // constraints
-        for (int i = 0; i <= N; i++)
-        {
-            ext_fun_workspace_size += constraints[i]->get_external_fun_workspace_requirement(constraints[i], dims->constraints[i], opts->constraints[i], in->constraints[i]);
-        }
-        // cost
-        for (int i = 0; i <= N; i++)
-        {
-            ext_fun_workspace_size += cost[i]->get_external_fun_workspace_requirement(cost[i], dims->cost[i], opts->cost[i], in->cost[i]);
-        }
-        // dynamics
-        for (int i = 0; i < N; i++)
-        {
-            ext_fun_workspace_size += dynamics[i]->get_external_fun_workspace_requirement(dynamics[i], dims->dynamics[i], opts->dynamics[i], in->dynamics[i]);
-        }
-#else
-        size_t tmp_size;
-        // constraints
-        for (int i = 0; i <= N; i++)
-        {
-            tmp_size = constraints[i]->get_external_fun_workspace_requirement(constraints[i], dims->constraints[i], opts->constraints[i], in->constraints[i]);
-            ext_fun_workspace_size = tmp_size > ext_fun_workspace_size ? tmp_size : ext_fun_workspace_size;
-        }
-        // cost
-        for (int i = 0; i <= N; i++)
-        {
-            tmp_size = cost[i]->get_external_fun_workspace_requirement(cost[i], dims->cost[i], opts->cost[i], in->cost[i]);
-            ext_fun_workspace_size = tmp_size > ext_fun_workspace_size ? tmp_size : ext_fun_workspace_size;
-        }
-        // dynamics
-        for (int i = 0; i < N; i++)
-        {
-            tmp_size = dynamics[i]->get_external_fun_workspace_requirement(dynamics[i], dims->dynamics[i], opts->dynamics[i], in->dynamics[i]);
-            ext_fun_workspace_size = tmp_size > ext_fun_workspace_size ? tmp_size : ext_fun_workspace_size;
-        }
-#endif
-    }
-    else
-    {
-        // constraints
-        for (int i = 0; i <= N; i++)
-        {
-            ext_fun_workspace_size += constraints[i]->get_external_fun_workspace_requirement(constraints[i], dims->constraints[i], opts->constraints[i], in->constraints[i]);
-        }
-        // cost
-        for (int i = 0; i <= N; i++)
-        {
-            ext_fun_workspace_size += cost[i]->get_external_fun_workspace_requirement(cost[i], dims->cost[i], opts->cost[i], in->cost[i]);
-        }
-        // dynamics
-        for (int i = 0; i < N; i++)
-        {
-            ext_fun_workspace_size += dynamics[i]->get_external_fun_workspace_requirement(dynamics[i], dims->dynamics[i], opts->dynamics[i], in->dynamics[i]);
-        }
-    }
-
-    size += 64; // ext_fun_workspace_size align
-    size += ext_fun_workspace_size;
-
-    size += 8; // struct align
-    size += 64; // blasfeo align
-    return size;
+acados_size_t ocp_nlp_workspace_calculate_summed_size(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_opts *opts, ocp_nlp_in *in)
+{
+    return ocp_nlp_workspace_calculate_size_with_reuse(config, dims, opts, in, 0);
 }
 
 
@@ -2329,11 +2716,6 @@ acados_size_t ocp_nlp_workspace_calculate_size(ocp_nlp_config *config, ocp_nlp_d
 ocp_nlp_workspace *ocp_nlp_workspace_assign(ocp_nlp_config *config, ocp_nlp_dims *dims,
                              ocp_nlp_opts *opts, ocp_nlp_in *nlp_in, ocp_nlp_memory *mem, void *raw_memory)
 {
-    ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
-    ocp_nlp_dynamics_config **dynamics = config->dynamics;
-    ocp_nlp_cost_config **cost = config->cost;
-    ocp_nlp_constraints_config **constraints = config->constraints;
-
     int N = dims->N;
     int np_global = dims->np_global;
     int *nx = dims->nx;
@@ -2383,191 +2765,56 @@ ocp_nlp_workspace *ocp_nlp_workspace_assign(ocp_nlp_config *config, ocp_nlp_dims
     work->tmp_qp_out = ocp_qp_out_assign(dims->qp_solver->orig_dims, c_ptr);
     c_ptr += ocp_qp_out_calculate_size(dims->qp_solver->orig_dims);
 
-    // weight_merit_fun
-    work->weight_merit_fun = ocp_nlp_out_assign(config, dims, c_ptr);
-    c_ptr += ocp_nlp_out_calculate_size(config, dims);
-
-    // qp seed
-    work->qp_seed = ocp_qp_seed_assign(dims->qp_solver->orig_dims, c_ptr);
-    c_ptr += ocp_qp_seed_calculate_size(dims->qp_solver->orig_dims);
-
-    if (opts->ext_qp_res)
-    {
-        // qp res
-        work->qp_res = ocp_qp_res_assign(dims->qp_solver->orig_dims, c_ptr);
-        c_ptr += ocp_qp_res_calculate_size(dims->qp_solver->orig_dims);
-        // qp res ws
-        work->qp_res_ws = ocp_qp_res_workspace_assign(dims->qp_solver->orig_dims, c_ptr);
-        c_ptr += ocp_qp_res_workspace_calculate_size(dims->qp_solver->orig_dims);
-    }
-
-    assign_and_advance_double(nv_max, &work->tmp_nv_double, &c_ptr);
-
-    assign_and_advance_int(ni_max+ns_max, &work->tmp_nins, &c_ptr);
-    // align for blasfeo mem
-    align_char_to(64, &c_ptr);
-
-    // blasfeo_dvec
-    assign_and_advance_blasfeo_dvec_mem(nv_max, &work->tmp_nv, &c_ptr);
-    assign_and_advance_blasfeo_dvec_mem(2*ni_max, &work->tmp_2ni, &c_ptr);
-    assign_and_advance_blasfeo_dvec_mem(nx_max, &work->dxnext_dy, &c_ptr);
-    assign_and_advance_blasfeo_dvec_mem(np_global, &work->tmp_np_global, &c_ptr);
-
-    if (opts->reuse_workspace)
-    {
-#if defined(ACADOS_WITH_OPENMP)
-        // qp solver
-        work->qp_work = (void *) c_ptr;
-        c_ptr += qp_solver->workspace_calculate_size(qp_solver, dims->qp_solver, opts->qp_solver_opts);
-
-        // dynamics
-        for (int i = 0; i < N; i++)
-        {
-            work->dynamics[i] = c_ptr;
-            c_ptr += dynamics[i]->workspace_calculate_size(dynamics[i], dims->dynamics[i], opts->dynamics[i]);
-        }
-
-        // cost
-        for (int i = 0; i <= N; i++)
-        {
-            work->cost[i] = c_ptr;
-            c_ptr += cost[i]->workspace_calculate_size(cost[i], dims->cost[i], opts->cost[i]);
-        }
-
-        // constraints
-        for (int i = 0; i <= N; i++)
-        {
-            work->constraints[i] = c_ptr;
-            c_ptr += constraints[i]->workspace_calculate_size(constraints[i], dims->constraints[i], opts->constraints[i]);
-        }
-#else
-        acados_size_t size_tmp = 0;
-        int tmp;
-
-        // qp solver
-        work->qp_work = (void *) c_ptr;
-        tmp = qp_solver->workspace_calculate_size(qp_solver, dims->qp_solver, opts->qp_solver_opts);
-        size_tmp = tmp > size_tmp ? tmp : size_tmp;
-
-        // dynamics
-        for (int i = 0; i < N; i++)
-        {
-            work->dynamics[i] = c_ptr;
-            tmp = dynamics[i]->workspace_calculate_size(dynamics[i], dims->dynamics[i], opts->dynamics[i]);
-            size_tmp = tmp > size_tmp ? tmp : size_tmp;
-        }
-
-        // cost
-        for (int i = 0; i <= N; i++)
-        {
-            work->cost[i] = c_ptr;
-            tmp = cost[i]->workspace_calculate_size(cost[i], dims->cost[i], opts->cost[i]);
-            size_tmp = tmp > size_tmp ? tmp : size_tmp;
-        }
-
-        // constraints
-        for (int i = 0; i <= N; i++)
-        {
-            work->constraints[i] = c_ptr;
-            tmp = constraints[i]->workspace_calculate_size(constraints[i], dims->constraints[i], opts->constraints[i]);
-            size_tmp = tmp > size_tmp ? tmp : size_tmp;
-        }
-        c_ptr += size_tmp;
-#endif
-    }
-    else
-    {
-        // qp solver
-        work->qp_work = (void *) c_ptr;
-        c_ptr += qp_solver->workspace_calculate_size(qp_solver, dims->qp_solver, opts->qp_solver_opts);
-
-        // dynamics
-        for (int i = 0; i < N; i++)
-        {
-            work->dynamics[i] = c_ptr;
-            c_ptr += dynamics[i]->workspace_calculate_size(dynamics[i], dims->dynamics[i], opts->dynamics[i]);
-        }
-
-        // cost
-        for (int i = 0; i <= N; i++)
-        {
-            work->cost[i] = c_ptr;
-            c_ptr += cost[i]->workspace_calculate_size(cost[i], dims->cost[i], opts->cost[i]);
-        }
+    // weight_merit_fun
+    work->weight_merit_fun = ocp_nlp_out_assign(config, dims, c_ptr);
+    c_ptr += ocp_nlp_out_calculate_size(config, dims);
 
-        // constraints
-        for (int i = 0; i <= N; i++)
-        {
-            work->constraints[i] = c_ptr;
-            c_ptr += constraints[i]->workspace_calculate_size(constraints[i], dims->constraints[i], opts->constraints[i]);
-        }
+    // qp seed
+    work->qp_seed = ocp_qp_seed_assign(dims->qp_solver->orig_dims, c_ptr);
+    c_ptr += ocp_qp_seed_calculate_size(dims->qp_solver->orig_dims);
+
+    if (opts->ext_qp_res)
+    {
+        // qp res
+        work->qp_res = ocp_qp_res_assign(dims->qp_solver->orig_dims, c_ptr);
+        c_ptr += ocp_qp_res_calculate_size(dims->qp_solver->orig_dims);
+        // qp res ws
+        work->qp_res_ws = ocp_qp_res_workspace_assign(dims->qp_solver->orig_dims, c_ptr);
+        c_ptr += ocp_qp_res_workspace_calculate_size(dims->qp_solver->orig_dims);
     }
 
-    // align for external_function workspace
+    assign_and_advance_double(nv_max, &work->tmp_nv_double, &c_ptr);
+
+    assign_and_advance_int(ni_max+ns_max, &work->tmp_nins, &c_ptr);
+    // align for blasfeo mem
     align_char_to(64, &c_ptr);
 
-    if (opts->reuse_workspace)
+    // blasfeo_dvec
+    assign_and_advance_blasfeo_dvec_mem(nv_max, &work->tmp_nv, &c_ptr);
+    assign_and_advance_blasfeo_dvec_mem(2*ni_max, &work->tmp_2ni, &c_ptr);
+    assign_and_advance_blasfeo_dvec_mem(nx_max, &work->dxnext_dy, &c_ptr);
+    assign_and_advance_blasfeo_dvec_mem(np_global, &work->tmp_np_global, &c_ptr);
+
+    // module workspace (qp solver, stage modules, external functions)
+    ocp_nlp_workspace_modules_assign(config, dims, opts, nlp_in, work, opts->reuse_workspace, &c_ptr);
+
+    // nominal line search candidate
+    mem->candidates[0].nlp_out = work->tmp_nlp_out;
+    mem->candidates[0].dynamics_work = work->dynamics;
+    mem->candidates[0].cost_work = work->cost;
+    mem->candidates[0].constraints_work = work->constraints;
+
+    // batched dynamics
+    acados_size_t batch_size = ocp_nlp_dynamics_batch_workspace_calculate_size(config, dims, opts);
+    if (batch_size > 0)
     {
-#if defined(ACADOS_WITH_OPENMP)
-        /* dont reuse workspace */
-        // constraints
-        for (int i = 0; i <= N; i++)
-        {
-            constraints[i]->set_external_fun_workspaces(constraints[i], dims->constraints[i], opts->constraints[i], nlp_in->constraints[i], c_ptr);
-            c_ptr += constraints[i]->get_external_fun_workspace_requirement(constraints[i], dims->constraints[i], opts->constraints[i], nlp_in->constraints[i]);
-        }
-        // cost
-        for (int i = 0; i <= N; i++)
-        {
-            cost[i]->set_external_fun_workspaces(cost[i], dims->cost[i], opts->cost[i], nlp_in->cost[i], c_ptr);
-            c_ptr += cost[i]->get_external_fun_workspace_requirement(cost[i], dims->cost[i], opts->cost[i], nlp_in->cost[i]);
-        }
-        // dynamics
-        for (int i = 0; i < N; i++)
-        {
-            dynamics[i]->set_external_fun_workspaces(dynamics[i], dims->dynamics[i], opts->dynamics[i], nlp_in->dynamics[i], c_ptr);
-            c_ptr += dynamics[i]->get_external_fun_workspace_requirement(dynamics[i], dims->dynamics[i], opts->dynamics[i], nlp_in->dynamics[i]);
-        }
-#else
-        /* Reuse workspace */
-        // constraints
-        for (int i = 0; i <= N; i++)
-        {
-            constraints[i]->set_external_fun_workspaces(constraints[i], dims->constraints[i], opts->constraints[i], nlp_in->constraints[i], c_ptr);
-        }
-        // cost
-        for (int i = 0; i <= N; i++)
-        {
-            cost[i]->set_external_fun_workspaces(cost[i], dims->cost[i], opts->cost[i], nlp_in->cost[i], c_ptr);
-        }
-        // dynamics
-        for (int i = 0; i < N; i++)
-        {
-            dynamics[i]->set_external_fun_workspaces(dynamics[i], dims->dynamics[i], opts->dynamics[i], nlp_in->dynamics[i], c_ptr);
-        }
-#endif
+        align_char_to(8, &c_ptr);
+        work->dynamics_batch = c_ptr;
+        c_ptr += batch_size;
     }
     else
     {
-        /* dont reuse workspace */
-        // constraints
-        for (int i = 0; i <= N; i++)
-        {
-            constraints[i]->set_external_fun_workspaces(constraints[i], dims->constraints[i], opts->constraints[i], nlp_in->constraints[i], c_ptr);
-            c_ptr += constraints[i]->get_external_fun_workspace_requirement(constraints[i], dims->constraints[i], opts->constraints[i], nlp_in->constraints[i]);
-        }
-        // cost
-        for (int i = 0; i <= N; i++)
-        {
-            cost[i]->set_external_fun_workspaces(cost[i], dims->cost[i], opts->cost[i], nlp_in->cost[i], c_ptr);
-            c_ptr += cost[i]->get_external_fun_workspace_requirement(cost[i], dims->cost[i], opts->cost[i], nlp_in->cost[i]);
-        }
-        // dynamics
-        for (int i = 0; i < N; i++)
-        {
-            dynamics[i]->set_external_fun_workspaces(dynamics[i], dims->dynamics[i], opts->dynamics[i], nlp_in->dynamics[i], c_ptr);
-            c_ptr += dynamics[i]->get_external_fun_workspace_requirement(dynamics[i], dims->dynamics[i], opts->dynamics[i], nlp_in->dynamics[i]);
-        }
+        work->dynamics_batch = NULL;
     }
 
     assert((char *) work + mem->workspace_size >= c_ptr);
@@ -2742,21 +2989,12 @@ static void ocp_nlp_regularize_set_qp_out_ptrs(ocp_nlp_reg_config *reg_config, o
 }
 
 
-void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
-         ocp_nlp_out *nlp_out, ocp_nlp_opts *opts, ocp_nlp_memory *nlp_mem, ocp_nlp_workspace *nlp_work)
+// sets the pointers of the stage module memories, the loops are shared with an enclosing parallel region
+static void ocp_nlp_alias_stage_memory(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
+         ocp_nlp_out *nlp_out, ocp_nlp_opts *opts, ocp_nlp_memory *nlp_mem, void **dynamics_mem,
+         void **cost_mem, void **constraints_mem, bool *set_sim_guess)
 {
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel
-    { // beginning of parallel region
-#endif
-
     int N = dims->N;
-    // TODO: For z, why dont we use nlp_out->z+i instead of nlp_mem->z_alg+i? as is done for ux.
-    //  - z_alg contains values from integrator, used in cost and constraint linearization.
-    //  - nlp_out->z is updated as nlp_out->z = mem->z_alg + alpha * dzdux * qp_out->ux
-    // Probably, this can also be achieved without mem->z_alg.
-    // Would it work to initialize integrator always with z_out? Probably no, e.g. for lifted IRK.
-
 
     // alias to dynamics_memory
 #if defined(ACADOS_WITH_OPENMP)
@@ -2764,20 +3002,20 @@ void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *di
 #endif
     for (int i = 0; i < N; i++)
     {
-        config->dynamics[i]->memory_set_ux_ptr(nlp_out->ux+i, nlp_mem->dynamics[i]);
-        config->dynamics[i]->memory_set_ux1_ptr(nlp_out->ux+i+1, nlp_mem->dynamics[i]);
-        config->dynamics[i]->memory_set_pi_ptr(nlp_out->pi+i, nlp_mem->dynamics[i]);
-        config->dynamics[i]->memory_set_BAbt_ptr(nlp_mem->qp_in->BAbt+i, nlp_mem->dynamics[i]);
-        config->dynamics[i]->memory_set_RSQrq_ptr(nlp_mem->qp_in->RSQrq+i, nlp_mem->dynamics[i]);
-        config->dynamics[i]->memory_set_dzduxt_ptr(nlp_mem->dzduxt+i, nlp_mem->dynamics[i]);
-        config->dynamics[i]->memory_set_sim_guess_ptr(nlp_mem->sim_guess+i, nlp_mem->set_sim_guess+i, nlp_mem->dynamics[i]);
+        config->dynamics[i]->memory_set_ux_ptr(nlp_out->ux+i, dynamics_mem[i]);
+        config->dynamics[i]->memory_set_ux1_ptr(nlp_out->ux+i+1, dynamics_mem[i]);
+        config->dynamics[i]->memory_set_pi_ptr(nlp_out->pi+i, dynamics_mem[i]);
+        config->dynamics[i]->memory_set_BAbt_ptr(nlp_mem->qp_in->BAbt+i, dynamics_mem[i]);
+        config->dynamics[i]->memory_set_RSQrq_ptr(nlp_mem->qp_in->RSQrq+i, dynamics_mem[i]);
+        config->dynamics[i]->memory_set_dzduxt_ptr(nlp_mem->dzduxt+i, dynamics_mem[i]);
+        config->dynamics[i]->memory_set_sim_guess_ptr(nlp_mem->sim_guess+i, set_sim_guess+i, dynamics_mem[i]);
         // NOTE: no z at terminal stage, since dynamics modules dont compute it.
-        config->dynamics[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, nlp_mem->dynamics[i]);
+        config->dynamics[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, dynamics_mem[i]);
 
         if (opts->with_solution_sens_wrt_params)
         {
-            config->dynamics[i]->memory_set_dyn_jac_p_global_ptr(nlp_mem->jac_dyn_p_global+i, nlp_mem->dynamics[i]);
-            config->dynamics[i]->memory_set_jac_lag_stat_p_global_ptr(nlp_mem->jac_lag_stat_p_global+i, nlp_mem->dynamics[i]);
+            config->dynamics[i]->memory_set_dyn_jac_p_global_ptr(nlp_mem->jac_dyn_p_global+i, dynamics_mem[i]);
+            config->dynamics[i]->memory_set_jac_lag_stat_p_global_ptr(nlp_mem->jac_lag_stat_p_global+i, dynamics_mem[i]);
         }
 
         int cost_integration;
@@ -2786,23 +3024,23 @@ void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *di
         if (cost_integration)
         {
             // set pointers to cost function & gradient in integrator
-            double *cost_fun = config->cost[i]->memory_get_fun_ptr(nlp_mem->cost[i]);
-            struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(nlp_mem->cost[i]);
+            double *cost_fun = config->cost[i]->memory_get_fun_ptr(cost_mem[i]);
+            struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(cost_mem[i]);
             struct blasfeo_dvec *y_ref = config->cost[i]->model_get_y_ref_ptr(nlp_in->cost[i]);
-            struct blasfeo_dmat *W_chol = config->cost[i]->memory_get_W_chol_ptr(nlp_mem->cost[i]);
-            struct blasfeo_dvec *W_chol_diag = config->cost[i]->memory_get_W_chol_diag_ptr(nlp_mem->cost[i]);
-            double *outer_hess_is_diag = config->cost[i]->get_outer_hess_is_diag_ptr(nlp_mem->cost[i], nlp_in->cost[i]);
+            struct blasfeo_dmat *W_chol = config->cost[i]->memory_get_W_chol_ptr(cost_mem[i]);
+            struct blasfeo_dvec *W_chol_diag = config->cost[i]->memory_get_W_chol_diag_ptr(cost_mem[i]);
+            double *outer_hess_is_diag = config->cost[i]->get_outer_hess_is_diag_ptr(cost_mem[i], nlp_in->cost[i]);
             double *cost_scaling = config->cost[i]->model_get_scaling_ptr(nlp_in->cost[i]);
             int *add_cost_hess_contribution = config->cost[i]->opts_get_add_hess_contribution_ptr(config->cost[i], opts->cost[i]);
 
-            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "cost_grad", cost_grad);
-            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "cost_fun", cost_fun);
-            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "y_ref", y_ref);
-            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "W_chol", W_chol);
-            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "W_chol_diag", W_chol_diag);
-            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "outer_hess_is_diag", outer_hess_is_diag);
-            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "cost_scaling_ptr", cost_scaling);
-            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], nlp_mem->dynamics[i], "add_cost_hess_contribution_ptr", add_cost_hess_contribution);
+            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], dynamics_mem[i], "cost_grad", cost_grad);
+            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], dynamics_mem[i], "cost_fun", cost_fun);
+            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], dynamics_mem[i], "y_ref", y_ref);
+            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], dynamics_mem[i], "W_chol", W_chol);
+            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], dynamics_mem[i], "W_chol_diag", W_chol_diag);
+            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], dynamics_mem[i], "outer_hess_is_diag", outer_hess_is_diag);
+            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], dynamics_mem[i], "cost_scaling_ptr", cost_scaling);
+            config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], dynamics_mem[i], "add_cost_hess_contribution_ptr", add_cost_hess_contribution);
         }
     }
 
@@ -2814,13 +3052,13 @@ void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *di
     {
         if (opts->with_solution_sens_wrt_params)
         {
-            config->cost[i]->memory_set_jac_lag_stat_p_global_ptr(nlp_mem->jac_lag_stat_p_global+i, nlp_mem->cost[i]);
+            config->cost[i]->memory_set_jac_lag_stat_p_global_ptr(nlp_mem->jac_lag_stat_p_global+i, cost_mem[i]);
         }
-        config->cost[i]->memory_set_ux_ptr(nlp_out->ux+i, nlp_mem->cost[i]);
-        config->cost[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, nlp_mem->cost[i]);
-        config->cost[i]->memory_set_dzdux_tran_ptr(nlp_mem->dzduxt+i, nlp_mem->cost[i]);
-        config->cost[i]->memory_set_RSQrq_ptr(nlp_mem->qp_in->RSQrq+i, nlp_mem->cost[i]);
-        config->cost[i]->memory_set_Z_ptr(nlp_mem->qp_in->Z+i, nlp_mem->cost[i]);
+        config->cost[i]->memory_set_ux_ptr(nlp_out->ux+i, cost_mem[i]);
+        config->cost[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, cost_mem[i]);
+        config->cost[i]->memory_set_dzdux_tran_ptr(nlp_mem->dzduxt+i, cost_mem[i]);
+        config->cost[i]->memory_set_RSQrq_ptr(nlp_mem->qp_in->RSQrq+i, cost_mem[i]);
+        config->cost[i]->memory_set_Z_ptr(nlp_mem->qp_in->Z+i, cost_mem[i]);
     }
 
     // alias to constraints_memory
@@ -2829,21 +3067,41 @@ void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *di
 #endif
     for (int i = 0; i <= N; i++)
     {
-        config->constraints[i]->memory_set_ux_ptr(nlp_out->ux+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_lam_ptr(nlp_out->lam+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_dzdux_tran_ptr(nlp_mem->dzduxt+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_DCt_ptr(nlp_mem->qp_in->DCt+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_RSQrq_ptr(nlp_mem->qp_in->RSQrq+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_idxb_ptr(nlp_mem->qp_in->idxb[i], nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_idxs_rev_ptr(nlp_mem->qp_in->idxs_rev[i], nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_idxe_ptr(nlp_mem->qp_in->idxe[i], nlp_mem->constraints[i]);
+        config->constraints[i]->memory_set_ux_ptr(nlp_out->ux+i, constraints_mem[i]);
+        config->constraints[i]->memory_set_lam_ptr(nlp_out->lam+i, constraints_mem[i]);
+        config->constraints[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, constraints_mem[i]);
+        config->constraints[i]->memory_set_dzdux_tran_ptr(nlp_mem->dzduxt+i, constraints_mem[i]);
+        config->constraints[i]->memory_set_DCt_ptr(nlp_mem->qp_in->DCt+i, constraints_mem[i]);
+        config->constraints[i]->memory_set_RSQrq_ptr(nlp_mem->qp_in->RSQrq+i, constraints_mem[i]);
+        config->constraints[i]->memory_set_idxb_ptr(nlp_mem->qp_in->idxb[i], constraints_mem[i]);
+        config->constraints[i]->memory_set_idxs_rev_ptr(nlp_mem->qp_in->idxs_rev[i], constraints_mem[i]);
+        config->constraints[i]->memory_set_idxe_ptr(nlp_mem->qp_in->idxe[i], constraints_mem[i]);
         if (opts->with_solution_sens_wrt_params)
         {
-            config->constraints[i]->memory_set_jac_lag_stat_p_global_ptr(nlp_mem->jac_lag_stat_p_global+i, nlp_mem->constraints[i]);
-            config->constraints[i]->memory_set_jac_ineq_p_global_ptr(nlp_mem->jac_ineq_p_global+i, nlp_mem->constraints[i]);
+            config->constraints[i]->memory_set_jac_lag_stat_p_global_ptr(nlp_mem->jac_lag_stat_p_global+i, constraints_mem[i]);
+            config->constraints[i]->memory_set_jac_ineq_p_global_ptr(nlp_mem->jac_ineq_p_global+i, constraints_mem[i]);
         }
     }
+}
+
+
+void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
+         ocp_nlp_out *nlp_out, ocp_nlp_opts *opts, ocp_nlp_memory *nlp_mem, ocp_nlp_workspace *nlp_work)
+{
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel num_threads(opts->num_threads)
+    { // beginning of parallel region
+#endif
+
+    int N = dims->N;
+    // TODO: For z, why dont we use nlp_out->z+i instead of nlp_mem->z_alg+i? as is done for ux.
+    //  - z_alg contains values from integrator, used in cost and constraint linearization.
+    //  - nlp_out->z is updated as nlp_out->z = mem->z_alg + alpha * dzdux * qp_out->ux
+    // Probably, this can also be achieved without mem->z_alg.
+    // Would it work to initialize integrator always with z_out? Probably no, e.g. for lifted IRK.
+
+    ocp_nlp_alias_stage_memory(config, dims, nlp_in, nlp_out, opts, nlp_mem, nlp_mem->dynamics,
+                               nlp_mem->cost, nlp_mem->constraints, nlp_mem->set_sim_guess);
 
     // set pointer to dmask in qp_in to dmask in nlp_in
     nlp_mem->qp_in->d_mask = nlp_in->dmask;
@@ -2879,7 +3137,7 @@ void ocp_nlp_initialize_submodules(ocp_nlp_config *config, ocp_nlp_dims *dims, o
     // IN CONTRAST: precompute is only called once after solver creation
     //  -> computes things that are not expected to change between subsequent solver calls
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(opts->num_threads)
 #endif
     for (int i = 0; i <= N; i++)
     {
@@ -2895,6 +3153,25 @@ void ocp_nlp_initialize_submodules(ocp_nlp_config *config, ocp_nlp_dims *dims, o
                 in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
     }
 
+    // line search candidates
+    for (int k = 1; k < opts->line_search_num_candidates; k++)
+    {
+        ocp_nlp_candidate *cand = mem->candidates + k;
+#if defined(ACADOS_WITH_OPENMP)
+        #pragma omp parallel for num_threads(opts->num_threads)
+#endif
+        for (int i = 0; i <= N; i++)
+        {
+            config->cost[i]->initialize(config->cost[i], dims->cost[i], in->cost[i],
+                    opts->cost[i], cand->cost[i], cand->cost_work[i]);
+            if (i < N)
+                config->dynamics[i]->initialize(config->dynamics[i], dims->dynamics[i],
+                        in->dynamics[i], opts->dynamics[i], cand->dynamics[i], cand->dynamics_work[i]);
+            config->constraints[i]->initialize(config->constraints[i], dims->constraints[i],
+                    in->constraints[i], opts->constraints[i], cand->constraints[i], cand->constraints_work[i]);
+        }
+    }
+
     return;
 }
 
@@ -2968,6 +3245,92 @@ static void collect_integrator_timings(ocp_nlp_config *config, ocp_nlp_dims *dim
     }
 }
 
+
+
+// Splits stages 0, ..., n_stages-1 into n_part contiguous blocks of approximately equal cost,
+// where each stage is assigned to the block containing the midpoint of its cost interval.
+// Block k contains the stages partition[k], ..., partition[k+1]-1 and might be empty.
+// Without cost information, the stages are split uniformly.
+// Returns the number of blocks.
+static int ocp_nlp_compute_stage_partition(int n_stages, int n_part, double *stage_cost, int *partition)
+{
+    if (n_part > n_stages)
+        n_part = n_stages;
+    if (n_part < 1)
+        n_part = 1;
+
+    double total_cost = 0.0;
+    for (int i = 0; i < n_stages; i++)
+    {
+        total_cost += stage_cost[i];
+    }
+
+    partition[0] = 0;
+    if (total_cost <= 0.0)
+    {
+        for (int k = 1; k <= n_part; k++)
+        {
+            partition[k] = (k * n_stages) / n_part;
+        }
+        return n_part;
+    }
+
+    int k = 0;
+    int block;
+    double acc_cost = 0.0;
+    for (int i = 0; i < n_stages; i++)
+    {
+        block = (int) ((acc_cost + 0.5 * stage_cost[i]) / total_cost * n_part);
+        block = block < n_part ? block : n_part - 1;
+        while (k < block)
+        {
+            k++;
+            partition[k] = i;
+        }
+        acc_cost += stage_cost[i];
+    }
+    while (k < n_part)
+    {
+        k++;
+        partition[k] = n_stages;
+    }
+
+    return n_part;
+}
+
+
+
+static void ocp_nlp_approximate_qp_matrices_stage(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_in *in, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work, int i,
+    bool with_dynamics)
+{
+    int N = dims->N;
+
+    // // init Hessian to 0
+    // if (mem->compute_hess)
+    // {
+    //     blasfeo_dgese(nu[i] + nx[i], nu[i] + nx[i], 0.0, mem->qp_in->RSQrq+i, 0, 0);
+    // }
+    // NOTE: removed init and directly write cost contribution into Hessian
+
+    // dynamics: NOTE: has to be first, as it computes z, which is used in cost and constraints.
+    if (i < N && with_dynamics)
+    {
+        config->dynamics[i]->update_qp_matrices(config->dynamics[i], dims->dynamics[i],
+            in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+    }
+
+    // cost
+    config->cost[i]->update_qp_matrices(config->cost[i], dims->cost[i], in->cost[i],
+                opts->cost[i], mem->cost[i], work->cost[i]);
+
+    // constraints
+    config->constraints[i]->update_qp_matrices(config->constraints[i], dims->constraints[i],
+            in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+}
+
+
+
 void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
     ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
     ocp_nlp_workspace *work)
@@ -2977,38 +3340,65 @@ void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
     int *nx = dims->nx;
     int *nu = dims->nu;
 
-    /* stage-wise multiple shooting lagrangian evaluation */
+    // stage load balancing: assign contiguous blocks of stages to threads based on the timings of the previous call
+    int num_blocks = 1;
+    if (opts->with_stage_load_balancing)
+    {
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+        num_blocks = opts->num_threads;
 #endif
-    for (int i = 0; i <= N; i++)
+        num_blocks = ocp_nlp_compute_stage_partition(N+1, num_blocks, mem->stage_lin_time, mem->stage_partition);
+    }
+
+    // batched dynamics: all shooting intervals are integrated in lock-step before the stage loop,
+    // falls back to the stage-wise evaluation if the current options are not supported
+    bool dynamics_batched = false;
+    if (work->dynamics_batch != NULL)
     {
-        // // init Hessian to 0
-        // if (mem->compute_hess)
-        // {
-        //     blasfeo_dgese(nu[i] + nx[i], nu[i] + nx[i], 0.0, mem->qp_in->RSQrq+i, 0, 0);
-        // }
-        // NOTE: removed init and directly write cost contribution into Hessian
+        dynamics_batched = !config->dynamics[0]->batch_update_qp_matrices((void **) config->dynamics,
+                dims->dynamics, in->dynamics, opts->dynamics, mem->dynamics, work->dynamics_batch,
+                in->parameter_values, dims->np, N);
+    }
+    mem->dynamics_batched = dynamics_batched;
 
-        // dynamics: NOTE: has to be first, as it computes z, which is used in cost and constraints.
-        if (i < N)
+    // NOTE: all stage loops share a single parallel region to pay the fork/join only once;
+    // the implicit barrier after the first loop is needed, as stage i collects dyn_adj of stage i-1.
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel num_threads(opts->num_threads)
+    { // beginning of parallel region
+#endif
+
+    /* stage-wise multiple shooting lagrangian evaluation */
+    if (opts->with_stage_load_balancing)
+    {
+#if defined(ACADOS_WITH_OPENMP)
+        #pragma omp for schedule(static, 1)
+#endif
+        for (int k = 0; k < num_blocks; k++)
         {
-            config->dynamics[i]->update_qp_matrices(config->dynamics[i], dims->dynamics[i],
-                in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+            acados_timer timer;
+            for (int i = mem->stage_partition[k]; i < mem->stage_partition[k+1]; i++)
+            {
+                acados_tic(&timer);
+                ocp_nlp_approximate_qp_matrices_stage(config, dims, in, opts, mem, work, i, !dynamics_batched);
+                mem->stage_lin_time[i] = acados_toc(&timer);
+            }
+        }
+    }
+    else
+    {
+#if defined(ACADOS_WITH_OPENMP)
+        #pragma omp for
+#endif
+        for (int i = 0; i <= N; i++)
+        {
+            ocp_nlp_approximate_qp_matrices_stage(config, dims, in, opts, mem, work, i, !dynamics_batched);
         }
-
-        // cost
-        config->cost[i]->update_qp_matrices(config->cost[i], dims->cost[i], in->cost[i],
-                    opts->cost[i], mem->cost[i], work->cost[i]);
-
-        // constraints
-        config->constraints[i]->update_qp_matrices(config->constraints[i], dims->constraints[i],
-                in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
     }
 
     /* collect stage-wise evaluations */
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp for nowait
 #endif
     for (int i=0; i <= N; i++)
     {
@@ -3050,6 +3440,10 @@ void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
         blasfeo_dveccp(nv[i], ineq_adj, 0, mem->ineq_adj + i, 0);
     }
 
+#if defined(ACADOS_WITH_OPENMP)
+    } // end of parallel region
+#endif
+
     collect_integrator_timings(config, dims, mem);
 }
 
@@ -3069,7 +3463,7 @@ void ocp_nlp_approximate_qp_vectors_sqp(ocp_nlp_config *config,
     int *ni = dims->ni;
 
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(opts->num_threads)
 #endif
     for (int i = 0; i <= N; i++)
     {
@@ -3104,8 +3498,14 @@ void ocp_nlp_zero_order_qp_update(ocp_nlp_config *config,
     int *nu = dims->nu;
     int *ni = dims->ni;
 
+    // NOTE: the stage loops below write disjoint parts of qp_in and mem -> no barriers needed
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel num_threads(opts->num_threads)
+    { // beginning of parallel region
+#endif
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp for nowait
 #endif
     for (int i = 0; i <= N; i++)
     {
@@ -3120,7 +3520,7 @@ void ocp_nlp_zero_order_qp_update(ocp_nlp_config *config,
     }
 
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp for nowait
 #endif
     for (int i=0; i<N; i++)
     {
@@ -3135,6 +3535,9 @@ void ocp_nlp_zero_order_qp_update(ocp_nlp_config *config,
 
     // add gradient correction
     // rqz += Hess * last_step = RQ * qp_out
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp for nowait
+#endif
     for (int i = 0; i <= N; i++)
     {
         // NOTE: only lower triagonal of RSQ is stored
@@ -3142,6 +3545,10 @@ void ocp_nlp_zero_order_qp_update(ocp_nlp_config *config,
                         mem->qp_out->ux+i, 0, 1.0, mem->qp_in->rqz+i, 0, mem->qp_in->rqz+i, 0);
         // TODO: fix for ns > 0.
     }
+
+#if defined(ACADOS_WITH_OPENMP)
+    } // end of parallel region
+#endif
 }
 
 
@@ -3156,8 +3563,14 @@ void ocp_nlp_level_c_update(ocp_nlp_config *config,
     int *nu = dims->nu;
     int *ni = dims->ni;
 
+    // NOTE: the dynamics loop adds to the gradient written in the cost loop -> barrier in between
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel num_threads(opts->num_threads)
+    { // beginning of parallel region
+#endif
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp for nowait
 #endif
     for (int i = 0; i <= N; i++)
     {
@@ -3172,7 +3585,7 @@ void ocp_nlp_level_c_update(ocp_nlp_config *config,
     }
 
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp for
 #endif
     for (int i=0; i<=N; i++)
     {
@@ -3185,7 +3598,7 @@ void ocp_nlp_level_c_update(ocp_nlp_config *config,
 
 
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp for nowait
 #endif
     for (int i=0; i<N; i++)
     {
@@ -3215,6 +3628,10 @@ void ocp_nlp_level_c_update(ocp_nlp_config *config,
         // blasfeo_print_exp_tran_dvec(nu[i] + nx[i], &work->tmp_nv, 0);
     }
 
+#if defined(ACADOS_WITH_OPENMP)
+    } // end of parallel region
+#endif
+
     // TODO:
     // - adjoint call for inequalities as for dynamics
 }
@@ -3254,6 +3671,7 @@ void ocp_nlp_update_variables_sqp(void *config_, void *dims_,
     ocp_nlp_out *out_start = out_;
     ocp_nlp_memory *mem = mem_;
     ocp_nlp_out *out_destination = out_destination_;
+    ocp_nlp_opts *opts = opts_;
     // solver_mem is not used in this function, but needed for DDP
     // the function is used in the config->globalization->step_update
     int N = dims->N;
@@ -3263,9 +3681,9 @@ void ocp_nlp_update_variables_sqp(void *config_, void *dims_,
     int *ni = dims->ni;
     int *nz = dims->nz;
 
-    #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-    #endif
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(opts->num_threads)
+#endif
     for (int i = 0; i <= N; i++)
     {
         // step in primal variables
@@ -3299,7 +3717,6 @@ void ocp_nlp_update_variables_sqp(void *config_, void *dims_,
             }
         }
 #if defined(ACADOS_DEVELOPER_DEBUG_CHECKS)
-    ocp_nlp_opts *opts = opts_;
     sanity_check_nlp_slack_nonnegativity(dims, opts, out_destination);
 #endif
 
@@ -3370,7 +3787,7 @@ void ocp_nlp_update_variables_sqp_delta_primal_dual(ocp_nlp_config *config, ocp_
     int *nz = dims->nz;
 
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(opts->num_threads)
 #endif
     for (int i = 0; i <= N; i++)
     {
@@ -3403,6 +3820,8 @@ int ocp_nlp_precompute_common(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nl
     int status = ACADOS_SUCCESS;
     int ii, tmp;
 
+    mem->workspace_size_summed = ocp_nlp_workspace_calculate_summed_size(config, dims, opts, in);
+
     for (ii = 0; ii <= N; ii++)
     {
         int module_val;
@@ -3499,6 +3918,30 @@ int ocp_nlp_precompute_common(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nl
     }
 
     ocp_nlp_alias_memory_to_submodules(config, dims, in, out, opts, mem, work);
+
+    // line search candidates, replicas of the stage modules
+    for (int k = 1; k < opts->line_search_num_candidates; k++)
+    {
+        ocp_nlp_candidate *cand = mem->candidates + k;
+        for (ii = 0; ii < N; ii++)
+        {
+            status = config->dynamics[ii]->precompute(config->dynamics[ii], dims->dynamics[ii],
+                                                    in->dynamics[ii], opts->dynamics[ii],
+                                                    cand->dynamics[ii], cand->dynamics_work[ii]);
+            if (status != ACADOS_SUCCESS)
+                return status;
+        }
+        for (ii = 0; ii <= N; ii++)
+        {
+            config->cost[ii]->precompute(config->cost[ii], dims->cost[ii], in->cost[ii],
+                                         opts->cost[ii], cand->cost[ii], cand->cost_work[ii]);
+            config->constraints[ii]->precompute(config->constraints[ii], dims->constraints[ii], in->constraints[ii],
+                                         opts->constraints[ii], cand->constraints[ii], cand->constraints_work[ii]);
+        }
+        ocp_nlp_alias_stage_memory(config, dims, in, cand->nlp_out, opts, mem, cand->dynamics,
+                                   cand->cost, cand->constraints, cand->set_sim_guess);
+    }
+
     if (opts->fixed_hess)
     {
         mem->compute_hess = 1;
@@ -3959,7 +4402,7 @@ void ocp_nlp_params_jac_compute(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_
     // struct blasfeo_dmat *jac_dyn_p_global = mem->jac_dyn_p_global;
 
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(opts->num_threads)
 #endif
     for (i = 0; i <= N; i++)
     {
@@ -4677,6 +5120,16 @@ void ocp_nlp_memory_get(ocp_nlp_config *config, ocp_nlp_memory *nlp_mem, const c
         int *value = return_value_;
         *value = nlp_mem->status;
     }
+    else if (!strcmp("workspace_size", field))
+    {
+        acados_size_t *value = return_value_;
+        *value = nlp_mem->workspace_size;
+    }
+    else if (!strcmp("workspace_size_summed", field))
+    {
+        acados_size_t *value = return_value_;
+        *value = nlp_mem->workspace_size_summed;
+    }
     else if (!strcmp("nlp_mem", field))
     {
         void **value = return_value_;
@@ -4726,6 +5179,11 @@ void ocp_nlp_memory_get(ocp_nlp_config *config, ocp_nlp_memory *nlp_mem, const c
     {
         ocp_nlp_qpscaling_memory_get(NULL, nlp_mem->qpscaling, "status", 0, return_value_);
     }
+    else if (!strcmp("dynamics_batched", field))
+    {
+        int *value = return_value_;
+        *value = nlp_mem->dynamics_batched;
+    }
     else if (!strcmp("res_stat", field))
     {
         double *value = return_value_;
@@ -4814,6 +5272,11 @@ void ocp_nlp_memory_get_at_stage(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp
         double *value = return_value_;
         blasfeo_unpack_dvec(nx[stage+1], nlp_mem->nlp_res->res_eq + stage, 0, value, 1);
     }
+    else if (!strcmp("time_lin_stage", field))
+    {
+        double *value = return_value_;
+        *value = nlp_mem->stage_lin_time[stage];
+    }
     else
     {
         printf("\nerror: field %s not available in ocp_nlp_memory_get_at_stage\n", field);
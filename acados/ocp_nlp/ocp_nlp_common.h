@@ -287,6 +287,7 @@ typedef struct ocp_nlp_out
     // [ lbu lbx lg lh lphi ubu ubx ug uh uphi; lsbu lsbx lsg lsh lsphi usbu usbx usg ush usphi]
     double inf_norm_res;
 
+    void *vec_memory; // internal memory of the vectors, used when not aliased to a user buffer
     void *raw_memory; // Pointer to allocated memory, to be used for freeing
 
 } ocp_nlp_out;
@@ -296,6 +297,11 @@ acados_size_t ocp_nlp_out_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *d
 //
 ocp_nlp_out *ocp_nlp_out_assign(ocp_nlp_config *config, ocp_nlp_dims *dims,
                                 void *raw_memory);
+// number of doubles of a packed buffer [ux_0 ... ux_N, z_0 ... z_N, pi_0 ... pi_{N-1}, lam_0 ... lam_N]
+int ocp_nlp_out_packed_size(ocp_nlp_dims *dims);
+// let the vectors of out point into a packed buffer, NULL restores the internal memory; values are not copied;
+// the buffer has to be aligned to sizeof(double)
+void ocp_nlp_out_alias_memory(ocp_nlp_dims *dims, ocp_nlp_out *out, double *buffer);
 
 
 
@@ -314,6 +320,9 @@ typedef struct ocp_nlp_opts
     double levenberg_marquardt;  // LM factor to be added to the hessian before regularization
     int reuse_workspace;
     int num_threads;
+    bool with_stage_load_balancing; // distribute stages over threads in linearization based on measured cost
+    bool with_batched_dynamics; // integrate all shooting intervals in lock-step in linearization, if supported
+    int line_search_num_candidates; // number of line search trial points evaluated concurrently
     int print_level;
     int fixed_hess;
     int log_primal_step_norm; // compute and log the max norm of the primal steps
@@ -429,6 +438,32 @@ void ocp_nlp_timings_get(ocp_nlp_config *config, ocp_nlp_timings *timings, const
 void ocp_nlp_timings_reset(ocp_nlp_timings *timings);
 
 
+/************************************************
+ * line search candidates
+ ************************************************/
+
+// stage modules evaluating the merit function at one line search trial point;
+// candidate 0 uses the nominal memory and workspace, the others own a replica of them
+typedef struct
+{
+    ocp_nlp_out *nlp_out;     // trial iterate
+    void **dynamics;          // dynamics memory
+    void **cost;              // cost memory
+    void **constraints;       // constraints memory
+    void **dynamics_work;     // dynamics workspace
+    void **cost_work;         // cost workspace
+    void **constraints_work;  // constraints workspace
+    bool *set_sim_guess;      // only the nominal memory consumes the integrator guess
+    double *merit_cost;       // (N+1) merit function contributions per stage
+    double *merit_dyn;        // (N+1)
+    double *merit_constr;     // (N+1)
+    double merit_fun;
+    double violation;         // constraint violation inf norm
+    double alpha;             // step size of the trial iterate
+} ocp_nlp_candidate;
+
+
+
 /************************************************
  * memory
  ************************************************/
@@ -498,8 +533,19 @@ typedef struct ocp_nlp_memory
     double *primal_step_norm;
     double *dual_step_norm;
 
+    // stage load balancing
+    double *stage_lin_time; // last measured linearization time per stage
+    int *stage_partition; // stage partition boundaries, block k contains stages [stage_partition[k], stage_partition[k+1])
+
+    int dynamics_batched; // 1 if the last linearization evaluated the dynamics of all stages batched
+
     struct blasfeo_dvec *sim_guess;
-    acados_size_t workspace_size;
+
+    // line search candidates (line_search_num_candidates)
+    ocp_nlp_candidate *candidates;
+
+    acados_size_t workspace_size; // peak workspace size, module workspaces overlapped according to liveness
+    acados_size_t workspace_size_summed; // workspace size without any overlap
 
 } ocp_nlp_memory;
 
@@ -512,6 +558,10 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
 void ocp_nlp_memory_get(ocp_nlp_config *config, ocp_nlp_memory *nlp_mem, const char *field, void *return_value_);
 //
 void ocp_nlp_memory_get_at_stage(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_memory *nlp_mem, int stage, const char *field, void *return_value_);
+// shifts all stages of out by one towards stage 0, blocks with different dimensions in consecutive stages are kept,
+// lam only if the constraints match (idxb from the qp_in in mem), otherwise the tail policy is applied to it
+void ocp_nlp_out_shift(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_memory *mem,
+                       ocp_nlp_out *out, ocp_shift_tail_policy tail_policy);
 
 /************************************************
  * workspace
@@ -549,10 +599,15 @@ typedef struct ocp_nlp_workspace
 
     int *tmp_nins;
 
+    // batched evaluation of the dynamics, NULL if not used
+    void *dynamics_batch;
+
 } ocp_nlp_workspace;
 
 //
 acados_size_t ocp_nlp_workspace_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_opts *opts, ocp_nlp_in *nlp_in);
+// workspace size without overlapping module workspaces, i.e. with reuse_workspace = 0
+acados_size_t ocp_nlp_workspace_calculate_summed_size(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_opts *opts, ocp_nlp_in *nlp_in);
 //
 ocp_nlp_workspace *ocp_nlp_workspace_assign(ocp_nlp_config *config, ocp_nlp_dims *dims,
                                 ocp_nlp_opts *opts, ocp_nlp_in *nlp_in, ocp_nlp_memory *mem, void *raw_memory);
@@ -409,6 +409,184 @@ void ocp_nlp_constraints_bgh_update_mask_upper(ocp_nlp_constraints_bgh_model *mo
 }
 
 
+int ocp_nlp_constraints_bgh_model_field_id(void *config_, void *dims_, const char *field)
+{
+    if (!strcmp(field, "lbx"))
+        return BGH_FIELD_LBX;
+    else if (!strcmp(field, "ubx"))
+        return BGH_FIELD_UBX;
+    else if (!strcmp(field, "lbu"))
+        return BGH_FIELD_LBU;
+    else if (!strcmp(field, "ubu"))
+        return BGH_FIELD_UBU;
+    else if (!strcmp(field, "C"))
+        return BGH_FIELD_C;
+    else if (!strcmp(field, "D"))
+        return BGH_FIELD_D;
+    else if (!strcmp(field, "lg"))
+        return BGH_FIELD_LG;
+    else if (!strcmp(field, "ug"))
+        return BGH_FIELD_UG;
+    else if (!strcmp(field, "lh"))
+        return BGH_FIELD_LH;
+    else if (!strcmp(field, "uh"))
+        return BGH_FIELD_UH;
+    else if (!strcmp(field, "ls"))
+        return BGH_FIELD_LS;
+    else if (!strcmp(field, "us"))
+        return BGH_FIELD_US;
+    else if (!strcmp(field, "lsbu"))
+        return BGH_FIELD_LSBU;
+    else if (!strcmp(field, "usbu"))
+        return BGH_FIELD_USBU;
+    else if (!strcmp(field, "lsbx"))
+        return BGH_FIELD_LSBX;
+    else if (!strcmp(field, "usbx"))
+        return BGH_FIELD_USBX;
+    else if (!strcmp(field, "lsg"))
+        return BGH_FIELD_LSG;
+    else if (!strcmp(field, "usg"))
+        return BGH_FIELD_USG;
+    else if (!strcmp(field, "lsh"))
+        return BGH_FIELD_LSH;
+    else if (!strcmp(field, "ush"))
+        return BGH_FIELD_USH;
+    else
+        return -1;
+}
+
+
+
+int ocp_nlp_constraints_bgh_model_set_by_id(void *config_, void *dims_,
+                         void *model_, int field_id, void *value)
+{
+    ocp_nlp_constraints_bgh_dims *dims = (ocp_nlp_constraints_bgh_dims *) dims_;
+    ocp_nlp_constraints_bgh_model *model = (ocp_nlp_constraints_bgh_model *) model_;
+
+    int offset;
+
+    int nu = dims->nu;
+    int nx = dims->nx;
+    int nb = dims->nb;
+    int ng = dims->ng;
+    int nh = dims->nh;
+    int ns = dims->ns;
+    int nsbu = dims->nsbu;
+    int nsbx = dims->nsbx;
+    int nsg = dims->nsg;
+    int nsh = dims->nsh;
+    int nbx = dims->nbx;
+    int nbu = dims->nbu;
+
+    // If model->d is updated, we always also update dmask. 0 means unconstrained.
+    switch (field_id)
+    {
+        case BGH_FIELD_LBX:
+            offset = nbu;
+            blasfeo_pack_dvec(nbx, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_lower(model, nbx, offset);
+            break;
+        case BGH_FIELD_UBX:
+            offset = nb + ng + nh + nbu;
+            blasfeo_pack_dvec(nbx, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_upper(model, nbx, offset);
+            break;
+        case BGH_FIELD_LBU:
+            offset = 0;
+            blasfeo_pack_dvec(nbu, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_lower(model, nbu, offset);
+            break;
+        case BGH_FIELD_UBU:
+            offset = nb + ng + nh;
+            blasfeo_pack_dvec(nbu, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_upper(model, nbu, offset);
+            break;
+        case BGH_FIELD_C:
+            blasfeo_pack_tran_dmat(ng, nx, value, ng, &model->DCt, nu, 0);
+            break;
+        case BGH_FIELD_D:
+            blasfeo_pack_tran_dmat(ng, nu, value, ng, &model->DCt, 0, 0);
+            break;
+        case BGH_FIELD_LG:
+            offset = nb;
+            blasfeo_pack_dvec(ng, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_lower(model, ng, offset);
+            break;
+        case BGH_FIELD_UG:
+            offset = 2*nb+ng+nh;
+            blasfeo_pack_dvec(ng, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_upper(model, ng, offset);
+            break;
+        case BGH_FIELD_LH:
+            offset = nb+ng;
+            blasfeo_pack_dvec(nh, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_lower(model, nh, offset);
+            break;
+        case BGH_FIELD_UH:
+            offset = 2*nb+2*ng+nh;
+            blasfeo_pack_dvec(nh, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_upper(model, nh, offset);
+            break;
+        case BGH_FIELD_LS:
+            offset = 2*nb+2*ng+2*nh;
+            blasfeo_pack_dvec(ns, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_lower(model, ns, offset);
+            break;
+        case BGH_FIELD_US:
+            offset = 2*nb+2*ng+2*nh+ns;
+            blasfeo_pack_dvec(ns, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_lower(model, ns, offset);
+            break;
+        case BGH_FIELD_LSBU:
+            offset = 2*nb+2*ng+2*nh;
+            blasfeo_pack_dvec(nsbu, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_lower(model, nsbu, offset);
+            break;
+        case BGH_FIELD_USBU:
+            offset = 2*nb+2*ng+2*nh+ns;
+            blasfeo_pack_dvec(nsbu, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_lower(model, nsbu, offset);
+            break;
+        case BGH_FIELD_LSBX:
+            offset = 2*nb+2*ng+2*nh+nsbu;
+            blasfeo_pack_dvec(nsbx, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_lower(model, nsbx, offset);
+            break;
+        case BGH_FIELD_USBX:
+            offset = 2*nb+2*ng+2*nh+ns+nsbu;
+            blasfeo_pack_dvec(nsbx, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_lower(model, nsbx, offset);
+            break;
+        case BGH_FIELD_LSG:
+            offset = 2*nb+2*ng+2*nh+nsbu+nsbx;
+            blasfeo_pack_dvec(nsg, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_lower(model, nsg, offset);
+            break;
+        case BGH_FIELD_USG:
+            offset = 2*nb+2*ng+2*nh+ns+nsbu+nsbx;
+            blasfeo_pack_dvec(nsg, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_lower(model, nsg, offset);
+            break;
+        case BGH_FIELD_LSH:
+            offset = 2*nb+2*ng+2*nh+nsbu+nsbx+nsg;
+            blasfeo_pack_dvec(nsh, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_lower(model, nsh, offset);
+            break;
+        case BGH_FIELD_USH:
+            offset = 2*nb+2*ng+2*nh+ns+nsbu+nsbx+nsg;
+            blasfeo_pack_dvec(nsh, value, 1, &model->d, offset);
+            ocp_nlp_constraints_bgh_update_mask_lower(model, nsh, offset);
+            break;
+        default:
+            printf("\nerror: invalid field id %d in module ocp_nlp_constraints_bgh\n", field_id);
+            exit(1);
+    }
+
+    return ACADOS_SUCCESS;
+}
+
+
+
 int ocp_nlp_constraints_bgh_model_set(void *config_, void *dims_,
                          void *model_, const char *field, void *value)
 {
@@ -417,7 +595,6 @@ int ocp_nlp_constraints_bgh_model_set(void *config_, void *dims_,
 
     int ii;
     int *ptr_i;
-    int offset;
 
     if (!dims || !model || !field || !value)
     {
@@ -426,11 +603,9 @@ int ocp_nlp_constraints_bgh_model_set(void *config_, void *dims_,
     }
 
     int nu = dims->nu;
-    int nx = dims->nx;
     int nb = dims->nb;
     int ng = dims->ng;
     int nh = dims->nh;
-    int ns = dims->ns;
     int nsbu = dims->nsbu;
     int nsbx = dims->nsbx;
     int nsg = dims->nsg;
@@ -442,63 +617,20 @@ int ocp_nlp_constraints_bgh_model_set(void *config_, void *dims_,
     int nge = dims->nge;
     int nhe = dims->nhe;
 
-    // If model->d is updated, we always also update dmask. 0 means unconstrained.
+    int field_id;
+
     if (!strcmp(field, "idxbx"))
     {
         ptr_i = (int *) value;
         for (ii=0; ii < nbx; ii++)
             model->idxb[nbu+ii] = nu+ptr_i[ii];
     }
-    else if (!strcmp(field, "lbx"))
-    {
-        offset = nbu;
-        blasfeo_pack_dvec(nbx, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_lower(model, nbx, offset);
-    }
-    else if (!strcmp(field, "ubx"))
-    {
-        offset = nb + ng + nh + nbu;
-        blasfeo_pack_dvec(nbx, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_upper(model, nbx, offset);
-    }
     else if (!strcmp(field, "idxbu"))
     {
         ptr_i = (int *) value;
         for (ii=0; ii < nbu; ii++)
             model->idxb[ii] = ptr_i[ii];
     }
-    else if (!strcmp(field, "lbu"))
-    {
-        offset = 0;
-        blasfeo_pack_dvec(nbu, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_lower(model, nbu, offset);
-    }
-    else if (!strcmp(field, "ubu"))
-    {
-        offset = nb + ng + nh;
-        blasfeo_pack_dvec(nbu, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_upper(model, nbu, offset);
-    }
-    else if (!strcmp(field, "C"))
-    {
-        blasfeo_pack_tran_dmat(ng, nx, value, ng, &model->DCt, nu, 0);
-    }
-    else if (!strcmp(field, "D"))
-    {
-        blasfeo_pack_tran_dmat(ng, nu, value, ng, &model->DCt, 0, 0);
-    }
-    else if (!strcmp(field, "lg"))
-    {
-        offset = nb;
-        blasfeo_pack_dvec(ng, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_lower(model, ng, offset);
-    }
-    else if (!strcmp(field, "ug"))
-    {
-        offset = 2*nb+ng+nh;
-        blasfeo_pack_dvec(ng, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_upper(model, ng, offset);
-    }
     else if (!strcmp(field, "nl_constr_h_fun"))
     {
         model->nl_constr_h_fun = value;
@@ -519,18 +651,6 @@ int ocp_nlp_constraints_bgh_model_set(void *config_, void *dims_,
     {
         model->nl_constr_h_adj_p = value;
     }
-    else if (!strcmp(field, "lh"))
-    {
-        offset = nb+ng;
-        blasfeo_pack_dvec(nh, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_lower(model, nh, offset);
-    }
-    else if (!strcmp(field, "uh"))
-    {
-        offset = 2*nb+2*ng+nh;
-        blasfeo_pack_dvec(nh, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_upper(model, nh, offset);
-    }
     // idxs_rev formulation
     else if (!strcmp(field, "idxs_rev"))
     {
@@ -539,18 +659,6 @@ int ocp_nlp_constraints_bgh_model_set(void *config_, void *dims_,
             model->idxs_rev[ii] = ptr_i[ii];
         model->use_idxs_rev = 1;
     }
-    else if (!strcmp(field, "ls"))
-    {
-        offset = 2*nb+2*ng+2*nh;
-        blasfeo_pack_dvec(ns, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_lower(model, ns, offset);
-    }
-    else if (!strcmp(field, "us"))
-    {
-        offset = 2*nb+2*ng+2*nh+ns;
-        blasfeo_pack_dvec(ns, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_lower(model, ns, offset);
-    }
     // idxs_* formulation
     else if (!strcmp(field, "idxsbu"))
     {
@@ -558,73 +666,24 @@ int ocp_nlp_constraints_bgh_model_set(void *config_, void *dims_,
         for (ii=0; ii < nsbu; ii++)
             model->idxs[ii] = ptr_i[ii];
     }
-    else if (!strcmp(field, "lsbu"))
-    {
-        offset = 2*nb+2*ng+2*nh;
-        blasfeo_pack_dvec(nsbu, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_lower(model, nsbu, offset);
-    }
-    else if (!strcmp(field, "usbu"))
-    {
-        offset = 2*nb+2*ng+2*nh+ns;
-        blasfeo_pack_dvec(nsbu, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_lower(model, nsbu, offset);
-    }
     else if (!strcmp(field, "idxsbx"))
     {
         ptr_i = (int *) value;
         for (ii=0; ii < nsbx; ii++)
             model->idxs[nsbu+ii] = nbu+ptr_i[ii];
     }
-    else if (!strcmp(field, "lsbx"))
-    {
-        offset = 2*nb+2*ng+2*nh+nsbu;
-        blasfeo_pack_dvec(nsbx, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_lower(model, nsbx, offset);
-    }
-    else if (!strcmp(field, "usbx"))
-    {
-        offset = 2*nb+2*ng+2*nh+ns+nsbu;
-        blasfeo_pack_dvec(nsbx, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_lower(model, nsbx, offset);
-    }
     else if (!strcmp(field, "idxsg"))
     {
         ptr_i = (int *) value;
         for (ii=0; ii < nsg; ii++)
             model->idxs[nsbu+nsbx+ii] = nbu+nbx+ptr_i[ii];
     }
-    else if (!strcmp(field, "lsg"))
-    {
-        offset = 2*nb+2*ng+2*nh+nsbu+nsbx;
-        blasfeo_pack_dvec(nsg, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_lower(model, nsg, offset);
-    }
-    else if (!strcmp(field, "usg"))
-    {
-        offset = 2*nb+2*ng+2*nh+ns+nsbu+nsbx;
-        blasfeo_pack_dvec(nsg, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_lower(model, nsg, offset);
-    }
     else if (!strcmp(field, "idxsh"))
     {
         ptr_i = (int *) value;
         for (ii=0; ii < nsh; ii++)
             model->idxs[nsbu+nsbx+nsg+ii] = nbu+nbx+ng+ptr_i[ii];
     }
-    else if (!strcmp(field, "lsh"))
-    {
-        offset = 2*nb+2*ng+2*nh+nsbu+nsbx+nsg;
-        blasfeo_pack_dvec(nsh, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_lower(model, nsh, offset);
-
-    }
-    else if (!strcmp(field, "ush"))
-    {
-        offset = 2*nb+2*ng+2*nh+ns+nsbu+nsbx+nsg;
-        blasfeo_pack_dvec(nsh, value, 1, &model->d, offset);
-        ocp_nlp_constraints_bgh_update_mask_lower(model, nsh, offset);
-    }
     // equalities
     else if (!strcmp(field, "idxbue"))
     {
@@ -650,6 +709,11 @@ int ocp_nlp_constraints_bgh_model_set(void *config_, void *dims_,
         for (ii=0; ii < nhe; ii++)
             model->idxe[nbue+nbxe+nge+ii] = nbu+nbx+ng+ptr_i[ii];
     }
+    // bounds, slack bounds, C and D: same code path as the field handles
+    else if ((field_id = ocp_nlp_constraints_bgh_model_field_id(config_, dims_, field)) >= 0)
+    {
+        return ocp_nlp_constraints_bgh_model_set_by_id(config_, dims_, model_, field_id, value);
+    }
     else
     {
         printf("\nerror: model field not available in module ocp_nlp_constraints_bgh: %s\n", field);
@@ -1849,6 +1913,8 @@ void ocp_nlp_constraints_bgh_config_initialize_default(void *config_, int stage)
     config->model_calculate_size = &ocp_nlp_constraints_bgh_model_calculate_size;
     config->model_assign = &ocp_nlp_constraints_bgh_model_assign;
     config->model_set = &ocp_nlp_constraints_bgh_model_set;
+    config->model_field_id = &ocp_nlp_constraints_bgh_model_field_id;
+    config->model_set_by_id = &ocp_nlp_constraints_bgh_model_set_by_id;
     config->model_get = &ocp_nlp_constraints_bgh_model_get;
     config->model_set_dmask_ptr = &ocp_nlp_constraints_bgh_model_set_dmask_ptr;
     config->opts_calculate_size = &ocp_nlp_constraints_bgh_opts_calculate_size;
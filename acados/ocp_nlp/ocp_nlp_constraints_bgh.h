@@ -110,6 +110,31 @@ typedef struct
     external_function_generic *nl_constr_h_adj_p;
 } ocp_nlp_constraints_bgh_model;
 
+// ids of the model fields that can be set through ocp_nlp_constraints_bgh_model_set_by_id
+typedef enum
+{
+    BGH_FIELD_LBX,
+    BGH_FIELD_UBX,
+    BGH_FIELD_LBU,
+    BGH_FIELD_UBU,
+    BGH_FIELD_C,
+    BGH_FIELD_D,
+    BGH_FIELD_LG,
+    BGH_FIELD_UG,
+    BGH_FIELD_LH,
+    BGH_FIELD_UH,
+    BGH_FIELD_LS,
+    BGH_FIELD_US,
+    BGH_FIELD_LSBU,
+    BGH_FIELD_USBU,
+    BGH_FIELD_LSBX,
+    BGH_FIELD_USBX,
+    BGH_FIELD_LSG,
+    BGH_FIELD_USG,
+    BGH_FIELD_LSH,
+    BGH_FIELD_USH,
+} ocp_nlp_constraints_bgh_field_t;
+
 //
 acados_size_t ocp_nlp_constraints_bgh_model_calculate_size(void *config, void *dims);
 //
@@ -117,6 +142,11 @@ void *ocp_nlp_constraints_bgh_model_assign(void *config, void *dims, void *raw_m
 //
 int ocp_nlp_constraints_bgh_model_set(void *config_, void *dims_,
                          void *model_, const char *field, void *value);
+// returns the ocp_nlp_constraints_bgh_field_t of field, -1 if it has none
+int ocp_nlp_constraints_bgh_model_field_id(void *config_, void *dims_, const char *field);
+//
+int ocp_nlp_constraints_bgh_model_set_by_id(void *config_, void *dims_,
+                         void *model_, int field_id, void *value);
 
 //
 void ocp_nlp_constraints_bgh_model_get(void *config_, void *dims_,
@@ -60,6 +60,9 @@ typedef struct
     acados_size_t (*model_calculate_size)(void *config, void *dims);
     void *(*model_assign)(void *config, void *dims, void *raw_memory);
     int (*model_set)(void *config_, void *dims_, void *model_, const char *field, void *value);
+    // optional: resolve a field name once (-1 if not available) and set by id without string compares
+    int (*model_field_id)(void *config_, void *dims_, const char *field);
+    int (*model_set_by_id)(void *config_, void *dims_, void *model_, int field_id, void *value);
     void (*model_get)(void *config_, void *dims_, void *model_, const char *field, void *value);
     void (*model_set_dmask_ptr)(struct blasfeo_dvec *dmask, void *model_);
     acados_size_t (*opts_calculate_size)(void *config, void *dims);
@@ -240,17 +240,44 @@ void *ocp_nlp_cost_ls_model_assign(void *config_, void *dims_, void *raw_memory)
 
 
 
-int ocp_nlp_cost_ls_model_set(void *config_, void *dims_, void *model_,
-                                 const char *field, void *value_)
+int ocp_nlp_cost_ls_model_field_id(void *config_, void *dims_, const char *field)
 {
-    int status = ACADOS_SUCCESS;
+    if (!strcmp(field, "W"))
+        return LS_COST_FIELD_W;
+    else if (!strcmp(field, "Cyt"))
+        return LS_COST_FIELD_CYT;
+    else if (!strcmp(field, "Vx"))
+        return LS_COST_FIELD_VX;
+    else if (!strcmp(field, "Vu"))
+        return LS_COST_FIELD_VU;
+    else if (!strcmp(field, "Vz"))
+        return LS_COST_FIELD_VZ;
+    else if (!strcmp(field, "y_ref") || !strcmp(field, "yref"))
+        return LS_COST_FIELD_Y_REF;
+    else if (!strcmp(field, "Z"))
+        return LS_COST_FIELD_HESS_Z;
+    else if (!strcmp(field, "Zl"))
+        return LS_COST_FIELD_HESS_ZL;
+    else if (!strcmp(field, "Zu"))
+        return LS_COST_FIELD_HESS_ZU;
+    else if (!strcmp(field, "z"))
+        return LS_COST_FIELD_GRAD_Z;
+    else if (!strcmp(field, "zl"))
+        return LS_COST_FIELD_GRAD_ZL;
+    else if (!strcmp(field, "zu"))
+        return LS_COST_FIELD_GRAD_ZU;
+    else if (!strcmp(field, "scaling"))
+        return LS_COST_FIELD_SCALING;
+    else
+        return -1;
+}
 
-    if ( !config_ || !dims_ || !model_ || !value_ )
-    {
-        printf("ocp_nlp_cost_ls_model_set: got NULL pointer, setting field %s\n", field);
-        printf("config %p, dims %p model %p, value %p \n", config_, dims_, model_, value_);
-        exit(1);
-    }
+
+
+int ocp_nlp_cost_ls_model_set_by_id(void *config_, void *dims_, void *model_,
+                                 int field_id, void *value_)
+{
+    int status = ACADOS_SUCCESS;
 
     ocp_nlp_cost_ls_dims *dims = dims_;
     ocp_nlp_cost_ls_model *model = model_;
@@ -261,111 +288,146 @@ int ocp_nlp_cost_ls_model_set(void *config_, void *dims_, void *model_,
     int ns = dims->ns;
     int nz = dims->nz;
 
-    if (!strcmp(field, "W"))
+    switch (field_id)
     {
-        double *W_col_maj = (double *) value_;
-        blasfeo_pack_dmat(ny, ny, W_col_maj, ny, &model->W, 0, 0);
-        model->W_changed = 1;
-        if (ny > 4)
+        case LS_COST_FIELD_W:
         {
-            // detect if outer hess is diag
-            model->outer_hess_is_diag = 1.0;
-            double tmp;
-            for (int i = 0; i < ny; i++)
+            double *W_col_maj = (double *) value_;
+            blasfeo_pack_dmat(ny, ny, W_col_maj, ny, &model->W, 0, 0);
+            model->W_changed = 1;
+            if (ny > 4)
             {
-                for (int j = 0; j < ny; j++)
+                // detect if outer hess is diag
+                model->outer_hess_is_diag = 1.0;
+                double tmp;
+                for (int i = 0; i < ny; i++)
                 {
-                    if (j!=i)
+                    for (int j = 0; j < ny; j++)
                     {
-                        tmp = BLASFEO_DMATEL(&model->W, i, j);
-                        if (tmp != 0.0)
+                        if (j!=i)
                         {
-                            model->outer_hess_is_diag = 0.0;
+                            tmp = BLASFEO_DMATEL(&model->W, i, j);
+                            if (tmp != 0.0)
+                            {
+                                model->outer_hess_is_diag = 0.0;
+                            }
                         }
                     }
                 }
             }
+            else
+            {
+                // use BLASFEO matrices for small ny.
+                model->outer_hess_is_diag = 0.0;
+            }
+            break;
         }
-        else
+        case LS_COST_FIELD_CYT:
         {
-            // use BLASFEO matrices for small ny.
-            model->outer_hess_is_diag = 0.0;
+            double *Cyt_col_maj = (double *) value_;
+            blasfeo_pack_dmat(nx + nu, dims->ny, Cyt_col_maj, nx + nu,
+                &model->Cyt, 0, 0);
+            model->Cyt_or_scaling_changed = 1;
+            break;
         }
+        case LS_COST_FIELD_VX:
+        {
+            double *Vx_col_maj = (double *) value_;
+            blasfeo_pack_tran_dmat(ny, nx, Vx_col_maj, ny, &model->Cyt, nu, 0);
+            model->Cyt_or_scaling_changed = 1;
+            break;
+        }
+        case LS_COST_FIELD_VU:
+        {
+            double *Vu_col_maj = (double *) value_;
+            blasfeo_pack_tran_dmat(ny, nu, Vu_col_maj, ny, &model->Cyt, 0, 0);
+            model->Cyt_or_scaling_changed = 1;
+            break;
+        }
+        // TODO(andrea): inconsistent order x, u, z. Make x, z, u later!
+        case LS_COST_FIELD_VZ:
+        {
+            double *Vz_col_maj = (double *) value_;
+            blasfeo_pack_dmat(ny, nz, Vz_col_maj, ny, &model->Vz, 0, 0);
+            break;
+        }
+        case LS_COST_FIELD_Y_REF:
+        {
+            double *y_ref = (double *) value_;
+            blasfeo_pack_dvec(ny, y_ref, 1, &model->y_ref, 0);
+            break;
+        }
+        case LS_COST_FIELD_HESS_Z:
+        {
+            double *Z = (double *) value_;
+            blasfeo_pack_dvec(ns, Z, 1, &model->Z, 0);
+            blasfeo_pack_dvec(ns, Z, 1, &model->Z, ns);
+            break;
+        }
+        case LS_COST_FIELD_HESS_ZL:
+        {
+            double *Zl = (double *) value_;
+            blasfeo_pack_dvec(ns, Zl, 1, &model->Z, 0);
+            break;
+        }
+        case LS_COST_FIELD_HESS_ZU:
+        {
+            double *Zu = (double *) value_;
+            blasfeo_pack_dvec(ns, Zu, 1, &model->Z, ns);
+            break;
+        }
+        case LS_COST_FIELD_GRAD_Z:
+        {
+            double *z = (double *) value_;
+            blasfeo_pack_dvec(ns, z, 1, &model->z, 0);
+            blasfeo_pack_dvec(ns, z, 1, &model->z, ns);
+            break;
+        }
+        case LS_COST_FIELD_GRAD_ZL:
+        {
+            double *zl = (double *) value_;
+            blasfeo_pack_dvec(ns, zl, 1, &model->z, 0);
+            break;
+        }
+        case LS_COST_FIELD_GRAD_ZU:
+        {
+            double *zu = (double *) value_;
+            blasfeo_pack_dvec(ns, zu, 1, &model->z, ns);
+            break;
+        }
+        case LS_COST_FIELD_SCALING:
+        {
+            double *scaling_ptr = (double *) value_;
+            model->scaling = *scaling_ptr;
+            model->Cyt_or_scaling_changed = 1;
+            break;
+        }
+        default:
+            printf("\nerror: invalid field id %d in ocp_nlp_cost_ls_model_set_by_id\n", field_id);
+            exit(1);
     }
-    else if (!strcmp(field, "Cyt"))
-    {
-        double *Cyt_col_maj = (double *) value_;
-        blasfeo_pack_dmat(nx + nu, dims->ny, Cyt_col_maj, nx + nu,
-            &model->Cyt, 0, 0);
-        model->Cyt_or_scaling_changed = 1;
-    }
-    else if (!strcmp(field, "Vx"))
-    {
-        double *Vx_col_maj = (double *) value_;
-        blasfeo_pack_tran_dmat(ny, nx, Vx_col_maj, ny, &model->Cyt, nu, 0);
-        model->Cyt_or_scaling_changed = 1;
-    }
-    else if (!strcmp(field, "Vu"))
-    {
-        double *Vu_col_maj = (double *) value_;
-        blasfeo_pack_tran_dmat(ny, nu, Vu_col_maj, ny, &model->Cyt, 0, 0);
-        model->Cyt_or_scaling_changed = 1;
-    }
-    // TODO(andrea): inconsistent order x, u, z. Make x, z, u later!
-    else if (!strcmp(field, "Vz"))
-    {
-        double *Vz_col_maj = (double *) value_;
-        blasfeo_pack_dmat(ny, nz, Vz_col_maj, ny, &model->Vz, 0, 0);
-    }
-    else if (!strcmp(field, "y_ref") || !strcmp(field, "yref"))
-    {
-        double *y_ref = (double *) value_;
-        blasfeo_pack_dvec(ny, y_ref, 1, &model->y_ref, 0);
-    }
-    else if (!strcmp(field, "Z"))
-    {
-        double *Z = (double *) value_;
-        blasfeo_pack_dvec(ns, Z, 1, &model->Z, 0);
-        blasfeo_pack_dvec(ns, Z, 1, &model->Z, ns);
-    }
-    else if (!strcmp(field, "Zl"))
-    {
-        double *Zl = (double *) value_;
-        blasfeo_pack_dvec(ns, Zl, 1, &model->Z, 0);
-    }
-    else if (!strcmp(field, "Zu"))
-    {
-        double *Zu = (double *) value_;
-        blasfeo_pack_dvec(ns, Zu, 1, &model->Z, ns);
-    }
-    else if (!strcmp(field, "z"))
-    {
-        double *z = (double *) value_;
-        blasfeo_pack_dvec(ns, z, 1, &model->z, 0);
-        blasfeo_pack_dvec(ns, z, 1, &model->z, ns);
-    }
-    else if (!strcmp(field, "zl"))
-    {
-        double *zl = (double *) value_;
-        blasfeo_pack_dvec(ns, zl, 1, &model->z, 0);
-    }
-    else if (!strcmp(field, "zu"))
-    {
-        double *zu = (double *) value_;
-        blasfeo_pack_dvec(ns, zu, 1, &model->z, ns);
-    }
-    else if (!strcmp(field, "scaling"))
+    return status;
+}
+
+
+
+int ocp_nlp_cost_ls_model_set(void *config_, void *dims_, void *model_,
+                                 const char *field, void *value_)
+{
+    if ( !config_ || !dims_ || !model_ || !value_ )
     {
-        double *scaling_ptr = (double *) value_;
-        model->scaling = *scaling_ptr;
-        model->Cyt_or_scaling_changed = 1;
+        printf("ocp_nlp_cost_ls_model_set: got NULL pointer, setting field %s\n", field);
+        printf("config %p, dims %p model %p, value %p \n", config_, dims_, model_, value_);
+        exit(1);
     }
-    else
+
+    int field_id = ocp_nlp_cost_ls_model_field_id(config_, dims_, field);
+    if (field_id < 0)
     {
         printf("\nerror: field %s not available in ocp_nlp_cost_ls_model_set\n", field);
         exit(1);
     }
-    return status;
+    return ocp_nlp_cost_ls_model_set_by_id(config_, dims_, model_, field_id, value_);
 }
 
 
@@ -1140,6 +1202,8 @@ void ocp_nlp_cost_ls_config_initialize_default(void *config_, int stage)
     config->model_calculate_size = &ocp_nlp_cost_ls_model_calculate_size;
     config->model_assign = &ocp_nlp_cost_ls_model_assign;
     config->model_set = &ocp_nlp_cost_ls_model_set;
+    config->model_field_id = &ocp_nlp_cost_ls_model_field_id;
+    config->model_set_by_id = &ocp_nlp_cost_ls_model_set_by_id;
     config->model_get = &ocp_nlp_cost_ls_model_get;
     config->model_get_scaling_ptr = &ocp_nlp_cost_ls_model_get_scaling_ptr;
     config->opts_calculate_size = &ocp_nlp_cost_ls_opts_calculate_size;
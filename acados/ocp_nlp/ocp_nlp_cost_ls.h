@@ -117,6 +117,24 @@ typedef struct
     int Cyt_or_scaling_changed;         ///< flag indicating whether Cyt or scaling has changed and Hessian needs to be recomputed
 } ocp_nlp_cost_ls_model;
 
+/// Ids of the model fields, see ocp_nlp_cost_ls_model_set_by_id.
+typedef enum
+{
+    LS_COST_FIELD_W,
+    LS_COST_FIELD_CYT,
+    LS_COST_FIELD_VX,
+    LS_COST_FIELD_VU,
+    LS_COST_FIELD_VZ,
+    LS_COST_FIELD_Y_REF,
+    LS_COST_FIELD_HESS_Z,
+    LS_COST_FIELD_HESS_ZL,
+    LS_COST_FIELD_HESS_ZU,
+    LS_COST_FIELD_GRAD_Z,
+    LS_COST_FIELD_GRAD_ZL,
+    LS_COST_FIELD_GRAD_ZU,
+    LS_COST_FIELD_SCALING,
+} ocp_nlp_cost_ls_field_t;
+
 //
 acados_size_t ocp_nlp_cost_ls_model_calculate_size(void *config, void *dims);
 //
@@ -124,6 +142,11 @@ void *ocp_nlp_cost_ls_model_assign(void *config, void *dims, void *raw_memory);
 //
 int ocp_nlp_cost_ls_model_set(void *config_, void *dims_, void *model_,
                               const char *field, void *value_);
+// returns the ocp_nlp_cost_ls_field_t of field, -1 if it has none
+int ocp_nlp_cost_ls_model_field_id(void *config_, void *dims_, const char *field);
+//
+int ocp_nlp_cost_ls_model_set_by_id(void *config_, void *dims_, void *model_,
+                              int field_id, void *value_);
 //
 int ocp_nlp_cost_ls_model_get(void *config_, void *dims_, void *model_,
                               const char *field, void *value_);
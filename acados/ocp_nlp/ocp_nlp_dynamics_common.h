@@ -109,6 +109,13 @@ typedef struct
     void (*compute_adj_p)(void *config, void *dims, void *model, void *opts, void *memory, struct blasfeo_dvec *out);
     void (*compute_fun_and_adj)(void *config_, void *dims, void *model_, void *opts_, void *mem_, void *work_);
     int (*precompute)(void *config_, void *dims, void *model_, void *opts_, void *mem_, void *work_);
+    /* batched evaluation of all N stages, NULL if not supported by the module */
+    // returns 0 if the stages can not be batched
+    acados_size_t (*batch_workspace_calculate_size)(void **config, void **dims, void **opts, int N);
+    // returns 0 if update_qp_matrices was done for all stages, otherwise nothing was evaluated;
+    // p[i] holds the np[i] parameters of stage i
+    int (*batch_update_qp_matrices)(void **config, void **dims, void **model, void **opts, void **mem,
+                                    void *work, double **p, int *np, int N);
     int stage;
 } ocp_nlp_dynamics_config;
 
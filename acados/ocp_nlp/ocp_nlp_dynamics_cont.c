@@ -40,6 +40,7 @@
 #include "blasfeo_d_aux.h"
 #include "blasfeo_d_blas.h"
 // acados
+#include "acados/sim/sim_erk_integrator.h"
 #include "acados/utils/mem.h"
 
 
@@ -573,7 +574,10 @@ void ocp_nlp_dynamics_cont_memory_get(void *config_, void *dims_, void *mem_, co
 
     sim_config *sim = config->sim_solver;
 
-    if (!strcmp(field, "time_sim") || !strcmp(field, "time_sim_ad") || !strcmp(field, "time_sim_la"))
+    if (!strcmp(field, "time_sim") || !strcmp(field, "time_sim_ad") || !strcmp(field, "time_sim_la") ||
+        !strcmp(field, "steps_accepted") || !strcmp(field, "steps_rejected") ||
+        !strcmp(field, "step_cap_reached") || !strcmp(field, "jac_factorizations") ||
+        !strcmp(field, "jac_factorizations_skipped"))
     {
         sim->memory_get(sim, dims->sim, mem->sim_solver, field, value);
     }
@@ -939,27 +943,18 @@ void ocp_nlp_dynamics_cont_compute_fun(void *config_, void *dims_, void *model_,
         mem->set_sim_guess[0] = false;
     }
 
-    // backup sens options
-    bool sens_forw_bkp, sens_adj_bkp, sens_hess_bkp;
-    config->sim_solver->opts_get(config->sim_solver, opts->sim_solver, "sens_forw", &sens_forw_bkp);
-    config->sim_solver->opts_get(config->sim_solver, opts->sim_solver, "sens_adj", &sens_adj_bkp);
-    config->sim_solver->opts_get(config->sim_solver, opts->sim_solver, "sens_hess", &sens_hess_bkp);
-
-    // set all sens to false
+    // integrate without sensitivities, on a copy of the sim options: the shared options are not
+    // modified, such that several memories of this stage can be evaluated at the same time
+    sim_opts sim_opts_fun = *((sim_opts *) opts->sim_solver);
     bool sens_all = false;
-    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_forw", &sens_all);
-    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_adj", &sens_all);
-    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_hess", &sens_all);
+    config->sim_solver->opts_set(config->sim_solver, &sim_opts_fun, "sens_forw", &sens_all);
+    config->sim_solver->opts_set(config->sim_solver, &sim_opts_fun, "sens_adj", &sens_all);
+    config->sim_solver->opts_set(config->sim_solver, &sim_opts_fun, "sens_hess", &sens_all);
 
     // call integrator
-    config->sim_solver->evaluate(config->sim_solver, work->sim_in, work->sim_out, opts->sim_solver,
+    config->sim_solver->evaluate(config->sim_solver, work->sim_in, work->sim_out, &sim_opts_fun,
             mem->sim_solver, work->sim_solver);
 
-    // restore sens options
-    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_forw", &sens_forw_bkp);
-    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_adj", &sens_adj_bkp);
-    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_hess", &sens_hess_bkp);
-
     // fun = integrator(x, u) - x[next_stage]
     blasfeo_pack_dvec(nx1, work->sim_out->xn, 1, &mem->fun, 0);
     blasfeo_daxpy(nx1, -1.0, ux1, nu1, &mem->fun, 0, &mem->fun, 0);
@@ -1094,6 +1089,216 @@ void ocp_nlp_dynamics_cont_compute_adj_p(void* config_, void *dims_, void *model
 }
 
 
+/************************************************
+ * batched evaluation
+ ************************************************/
+
+// stages have to be continuous with ERK integrators of identical dims
+static bool ocp_nlp_dynamics_cont_batch_compatible(void **config_, void **dims_, void **opts_, int N)
+{
+    if (N < 1)
+        return false;
+
+    ocp_nlp_dynamics_cont_dims *dims0 = dims_[0];
+    sim_opts *sim_opts0 = ((ocp_nlp_dynamics_cont_opts *) opts_[0])->sim_solver;
+
+    for (int i = 0; i < N; i++)
+    {
+        ocp_nlp_dynamics_config *config = config_[i];
+        ocp_nlp_dynamics_cont_dims *dims = dims_[i];
+        sim_opts *sim_opts = ((ocp_nlp_dynamics_cont_opts *) opts_[i])->sim_solver;
+
+        if (config->update_qp_matrices != &ocp_nlp_dynamics_cont_update_qp_matrices ||
+            config->sim_solver->evaluate != &sim_erk)
+            return false;
+        if (dims->nx != dims0->nx || dims->nu != dims0->nu || dims->nx1 != dims0->nx || dims->nz != 0)
+            return false;
+        if (sim_opts->ns != sim_opts0->ns)
+            return false;
+    }
+
+    return true;
+}
+
+
+
+acados_size_t ocp_nlp_dynamics_cont_batch_workspace_calculate_size(void **config_, void **dims_, void **opts_, int N)
+{
+    if (!ocp_nlp_dynamics_cont_batch_compatible(config_, dims_, opts_, N))
+        return 0;
+
+    ocp_nlp_dynamics_config *config = config_[0];
+    ocp_nlp_dynamics_cont_dims *dims = dims_[0];
+    ocp_nlp_dynamics_cont_opts *opts = opts_[0];
+
+    int nx = dims->nx;
+    int nu = dims->nu;
+    int nB = nx * (1 + nx + nu) + nu;
+
+    acados_size_t size = 0;
+
+    size += sizeof(ocp_nlp_dynamics_cont_batch_workspace);
+
+    size += N * sizeof(void *);  // sim_models
+    size += N * sizeof(double);  // T
+    size += N * nB * sizeof(double);  // forw
+
+    size += sim_erk_batch_workspace_calculate_size(config->sim_solver, dims->sim, opts->sim_solver, N);
+
+    size += 2 * 8;  // align
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+static ocp_nlp_dynamics_cont_batch_workspace *ocp_nlp_dynamics_cont_batch_cast_workspace(
+        void **config_, void **dims_, void **opts_, int N, void *raw_memory)
+{
+    ocp_nlp_dynamics_cont_dims *dims = dims_[0];
+
+    int nx = dims->nx;
+    int nu = dims->nu;
+    int nB = nx * (1 + nx + nu) + nu;
+
+    char *c_ptr = (char *) raw_memory;
+
+    ocp_nlp_dynamics_cont_batch_workspace *work = (ocp_nlp_dynamics_cont_batch_workspace *) c_ptr;
+    c_ptr += sizeof(ocp_nlp_dynamics_cont_batch_workspace);
+
+    align_char_to(8, &c_ptr);
+
+    work->sim_models = (void **) c_ptr;
+    c_ptr += N * sizeof(void *);
+
+    assign_and_advance_double(N, &work->T, &c_ptr);
+    assign_and_advance_double(N * nB, &work->forw, &c_ptr);
+
+    align_char_to(8, &c_ptr);
+    work->sim_solver = c_ptr;
+
+    return work;
+}
+
+
+
+int ocp_nlp_dynamics_cont_batch_update_qp_matrices(void **config_, void **dims_, void **model_, void **opts_,
+                                                   void **mem_, void *work_, double **p, int *np, int N)
+{
+    ocp_nlp_dynamics_cont_dims *dims0 = dims_[0];
+    sim_opts *sim_opts0 = ((ocp_nlp_dynamics_cont_opts *) opts_[0])->sim_solver;
+
+    int nx = dims0->nx;
+    int nu = dims0->nu;
+    int nX = nx * (1 + nx + nu);
+    int nB = nX + nu;
+    int ns = sim_opts0->ns;
+
+    int i, jj;
+
+    // features that need the stage-wise evaluation
+    for (i = 0; i < N; i++)
+    {
+        ocp_nlp_dynamics_cont_opts *opts = opts_[i];
+        sim_opts *sim_opts = opts->sim_solver;
+
+        if (opts->compute_hess || sim_opts->sens_hess || sim_opts->cost_computation ||
+            sim_opts->adaptive_step || !sim_opts->sens_forw || sim_opts->num_forw_sens != nx + nu)
+            return 1;
+        if (sim_opts->ns != ns || sim_opts->num_steps != sim_opts0->num_steps)
+            return 1;
+        for (jj = 0; jj < ns * ns; jj++)
+        {
+            if (sim_opts->A_mat[jj] != sim_opts0->A_mat[jj])
+                return 1;
+        }
+        for (jj = 0; jj < ns; jj++)
+        {
+            if (sim_opts->b_vec[jj] != sim_opts0->b_vec[jj])
+                return 1;
+        }
+    }
+
+    // the batched vde takes the parameters of each stage as input
+    external_function_casadi_batch *fun_batch =
+        ((erk_model *) ((ocp_nlp_dynamics_cont_model *) model_[0])->sim_model)->expl_vde_for_batch;
+    if (fun_batch != NULL)
+    {
+        int np_batch;
+        fun_batch->get_nparam(fun_batch, &np_batch);
+        for (i = 0; i < N; i++)
+        {
+            if (np[i] != np_batch)
+                return 1;
+        }
+    }
+
+    ocp_nlp_dynamics_cont_batch_workspace *work =
+        ocp_nlp_dynamics_cont_batch_cast_workspace(config_, dims_, opts_, N, work_);
+
+    // pass state and control of all stages to the integrator
+    for (i = 0; i < N; i++)
+    {
+        ocp_nlp_dynamics_cont_memory *mem = mem_[i];
+        ocp_nlp_dynamics_cont_model *model = model_[i];
+
+        work->sim_models[i] = model->sim_model;
+        work->T[i] = model->T;
+        blasfeo_unpack_dvec(nx, mem->ux, nu, work->forw + i * nB, 1);
+        blasfeo_unpack_dvec(nu, mem->ux, 0, work->forw + i * nB + nX, 1);
+
+        // ERK does not use an initial guess
+        if (mem->set_sim_guess != NULL)
+            mem->set_sim_guess[0] = false;
+    }
+
+    acados_timer timer;
+    acados_tic(&timer);
+
+    ocp_nlp_dynamics_config *config0 = config_[0];
+    sim_erk_batch(config0->sim_solver, dims0->sim, sim_opts0, (erk_model **) work->sim_models,
+                  work->T, work->forw, p, N, work->sim_solver);
+
+    // integration time is attributed evenly to the stages
+    double time_sim = acados_toc(&timer) / N;
+
+    for (i = 0; i < N; i++)
+    {
+        ocp_nlp_dynamics_cont_dims *dims = dims_[i];
+        ocp_nlp_dynamics_cont_opts *opts = opts_[i];
+        ocp_nlp_dynamics_cont_memory *mem = mem_[i];
+        sim_erk_memory *sim_mem = mem->sim_solver;
+
+        sim_mem->time_sim = time_sim;
+        sim_mem->time_ad = 0.0;
+        sim_mem->time_la = 0.0;
+
+        double *xn = work->forw + i * nB;
+        double *S_forw = xn + nx;
+
+        // B
+        blasfeo_pack_tran_dmat(nx, nu, S_forw + nx * nx, nx, mem->BAbt, 0, 0);
+        // A
+        blasfeo_pack_tran_dmat(nx, nx, S_forw + 0, nx, mem->BAbt, nu, 0);
+
+        // function
+        blasfeo_pack_dvec(nx, xn, 1, &mem->fun, 0);
+        blasfeo_daxpy(nx, -1.0, mem->ux1, dims->nu1, &mem->fun, 0, &mem->fun, 0);
+
+        // adjoint, computed as forward * adj_seed, which is exact for ERK
+        if (opts->compute_adj)
+        {
+            blasfeo_dgemv_n(nu+nx, nx, -1.0, mem->BAbt, 0, 0, mem->pi, 0, 0.0, &mem->adj, 0, &mem->adj, 0);
+            blasfeo_dveccp(nx, mem->pi, 0, &mem->adj, nu+nx);
+        }
+    }
+
+    return 0;
+}
+
+
+
 size_t ocp_nlp_dynamics_cont_get_external_fun_workspace_requirement(void *config_, void *dims_, void *opts_, void *model_)
 {
     ocp_nlp_dynamics_cont_model *model = model_;
@@ -1158,6 +1363,8 @@ void ocp_nlp_dynamics_cont_config_initialize_default(void *config_, int stage)
     config->compute_fun_and_adj = &ocp_nlp_dynamics_cont_compute_fun_and_adj;
     config->compute_adj_p = &ocp_nlp_dynamics_cont_compute_adj_p;
     config->precompute = &ocp_nlp_dynamics_cont_precompute;
+    config->batch_workspace_calculate_size = &ocp_nlp_dynamics_cont_batch_workspace_calculate_size;
+    config->batch_update_qp_matrices = &ocp_nlp_dynamics_cont_batch_update_qp_matrices;
     config->config_initialize_default = &ocp_nlp_dynamics_cont_config_initialize_default;
     config->compute_jac_hess_p = &ocp_nlp_dynamics_cont_compute_jac_hess_p;
     config->stage = stage;
@@ -162,6 +162,20 @@ acados_size_t ocp_nlp_dynamics_cont_workspace_calculate_size(void *config, void
 
 
 
+// workspace of the batched evaluation of all stages
+typedef struct
+{
+    void **sim_models;  // (N) integrator models
+    double *T;          // (N) simulation times
+    double *forw;       // (N * nB) [x, Sx, Su, u] per stage
+    void *sim_solver;   // batched integrator workspace
+} ocp_nlp_dynamics_cont_batch_workspace;
+
+// returns 0 if the stages can not be integrated in lock-step
+acados_size_t ocp_nlp_dynamics_cont_batch_workspace_calculate_size(void **config, void **dims, void **opts, int N);
+
+
+
 /************************************************
  * model
  ************************************************/
@@ -202,6 +216,9 @@ int ocp_nlp_dynamics_cont_precompute(void *config_, void *dims, void *model_, vo
 void ocp_nlp_dynamics_cont_compute_jac_hess_p(void *config_, void *dims, void *model_, void *opts, void *mem, void *work_);
 //
 void ocp_nlp_dynamics_cont_compute_adj_p(void* config_, void *dims_, void *model_, void *opts_, void *mem_, struct blasfeo_dvec *out);
+//
+int ocp_nlp_dynamics_cont_batch_update_qp_matrices(void **config, void **dims, void **model, void **opts,
+                                                   void **mem, void *work, double **p, int *np, int N);
 
 #ifdef __cplusplus
 } /* extern "C" */
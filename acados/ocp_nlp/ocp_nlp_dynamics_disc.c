@@ -1020,6 +1020,8 @@ void ocp_nlp_dynamics_disc_config_initialize_default(void *config_, int stage)
     config->compute_fun_and_adj = &ocp_nlp_dynamics_disc_compute_fun_and_adj;
     config->compute_adj_p = &ocp_nlp_dynamics_disc_compute_adj_p;
     config->precompute = &ocp_nlp_dynamics_disc_precompute;
+    config->batch_workspace_calculate_size = NULL;
+    config->batch_update_qp_matrices = NULL;
     config->config_initialize_default = &ocp_nlp_dynamics_disc_config_initialize_default;
     config->stage = stage;
 
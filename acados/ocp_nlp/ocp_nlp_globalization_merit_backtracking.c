@@ -144,6 +144,191 @@ void *ocp_nlp_globalization_merit_backtracking_memory_assign(void *config_, void
  * functions
  ************************************************/
 
+static double ocp_nlp_get_violation_inf_norm(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                  ocp_nlp_candidate *cand)
+{
+    // computes constraint violation infinity norm
+    // assumes constraint functions are evaluated before in the memory of the candidate
+    int i, j;
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *ni = dims->ni;
+    struct blasfeo_dvec *tmp_fun_vec;
+    double violation = 0.0;
+    double tmp;
+    for (i=0; i<N; i++)
+    {
+        tmp_fun_vec = config->dynamics[i]->memory_get_fun_ptr(cand->dynamics[i]);
+        for (j=0; j<nx[i+1]; j++)
+        {
+            tmp = fabs(BLASFEO_DVECEL(tmp_fun_vec, j));
+            violation = tmp > violation ? tmp : violation;
+        }
+    }
+
+    for (i=0; i<=N; i++)
+    {
+        tmp_fun_vec = config->constraints[i]->memory_get_fun_ptr(cand->constraints[i]);
+        for (j=0; j<2*ni[i]; j++)
+        {
+            // Note constraint violation corresponds to > 0
+            tmp = BLASFEO_DVECEL(tmp_fun_vec, j);
+            violation = tmp > violation ? tmp : violation;
+        }
+    }
+
+    return violation;
+}
+
+static void ocp_nlp_evaluate_merit_fun_stage(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                  ocp_nlp_in *in, ocp_nlp_opts *opts, ocp_nlp_workspace *work,
+                                  ocp_nlp_candidate *cand, int i)
+{
+    /* evaluates the modules of stage i in the memory of the candidate and stores the weighted
+       merit function contributions of the stage */
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *ni = dims->ni;
+
+    double tmp;
+    struct blasfeo_dvec *tmp_fun_vec;
+
+    if (i < N)
+    {
+        // dynamics: Note has to be first, because cost_integration might be used.
+        config->dynamics[i]->compute_fun(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
+                                         opts->dynamics[i], cand->dynamics[i], cand->dynamics_work[i]);
+    }
+    // cost
+    config->cost[i]->compute_fun(config->cost[i], dims->cost[i], in->cost[i], opts->cost[i],
+                                cand->cost[i], cand->cost_work[i]);
+    // constr
+    config->constraints[i]->compute_fun(config->constraints[i], dims->constraints[i],
+                                        in->constraints[i], opts->constraints[i],
+                                        cand->constraints[i], cand->constraints_work[i]);
+
+    cand->merit_cost[i] = *config->cost[i]->memory_get_fun_ptr(cand->cost[i]);
+
+    cand->merit_dyn[i] = 0.0;
+    if (i < N)
+    {
+        tmp_fun_vec = config->dynamics[i]->memory_get_fun_ptr(cand->dynamics[i]);
+        for (int j=0; j<nx[i+1]; j++)
+        {
+            cand->merit_dyn[i] += fabs(BLASFEO_DVECEL(work->weight_merit_fun->pi+i, j)) * fabs(BLASFEO_DVECEL(tmp_fun_vec, j));
+        }
+    }
+
+    cand->merit_constr[i] = 0.0;
+    tmp_fun_vec = config->constraints[i]->memory_get_fun_ptr(cand->constraints[i]);
+    for (int j=0; j<2*ni[i]; j++)
+    {
+        tmp = BLASFEO_DVECEL(tmp_fun_vec, j);
+        if (tmp > 0.0)
+        {
+            // tmp = constraint violation
+            cand->merit_constr[i] += fabs(BLASFEO_DVECEL(work->weight_merit_fun->lam+i, j)) * tmp;
+        }
+    }
+}
+
+
+
+static void ocp_nlp_sum_merit_fun(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_candidate *cand)
+{
+    // add up the stage contributions in stage order, independent of the number of threads
+    int N = dims->N;
+
+    double cost_fun = 0.0;
+    double dyn_fun = 0.0;
+    double constr_fun = 0.0;
+
+    for (int i=0; i<=N; i++)
+    {
+        cost_fun += cand->merit_cost[i];
+        dyn_fun += cand->merit_dyn[i];
+        constr_fun += cand->merit_constr[i];
+    }
+
+    cand->merit_fun = cost_fun + dyn_fun + constr_fun;
+    cand->violation = ocp_nlp_get_violation_inf_norm(config, dims, cand);
+
+    // printf("Merit fun: %e cost: %e dyn: %e constr: %e\n", cand->merit_fun, cost_fun, dyn_fun, constr_fun);
+}
+
+
+
+static void ocp_nlp_evaluate_merit_fun_candidates(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                  ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
+                                  ocp_nlp_memory *mem, ocp_nlp_workspace *work, int num_candidates)
+{
+    /* computes merit function values at the trial iterates of the first num_candidates candidates,
+       with weights: work->weight_merit_fun */
+    int N = dims->N;
+    ocp_nlp_candidate *candidates = mem->candidates;
+
+    // set evaluation point of the nominal memory to its trial iterate (tmp_nlp_out)
+    ocp_nlp_set_primal_variable_pointers_in_submodules(config, dims, in, candidates[0].nlp_out, mem);
+
+    if (num_candidates == 1)
+    {
+        // stage i only depends on the modules of stage i
+#if defined(ACADOS_WITH_OPENMP)
+        #pragma omp parallel for num_threads(opts->num_threads)
+#endif
+        for (int i=0; i<=N; i++)
+        {
+            ocp_nlp_evaluate_merit_fun_stage(config, dims, in, opts, work, candidates, i);
+        }
+    }
+    else
+    {
+        // The stages are split into num_candidates blocks, in round r candidate k evaluates block
+        // (k + r) % num_candidates. No stage is evaluated by two candidates at the same time,
+        // since the external functions of a stage and their workspace are shared by all candidates.
+#if defined(ACADOS_WITH_OPENMP)
+        #pragma omp parallel num_threads(opts->num_threads)
+#endif
+        for (int r = 0; r < num_candidates; r++)
+        {
+#if defined(ACADOS_WITH_OPENMP)
+            #pragma omp for
+#endif
+            for (int k = 0; k < num_candidates; k++)
+            {
+                int block = (k + r) % num_candidates;
+                int i_start = block * (N+1) / num_candidates;
+                int i_end = (block+1) * (N+1) / num_candidates;
+                for (int i = i_start; i < i_end; i++)
+                {
+                    ocp_nlp_evaluate_merit_fun_stage(config, dims, in, opts, work, candidates+k, i);
+                }
+            }
+        }
+    }
+
+    // reset evaluation point to SQP iterate
+    ocp_nlp_set_primal_variable_pointers_in_submodules(config, dims, in, out, mem);
+
+    for (int k = 0; k < num_candidates; k++)
+    {
+        ocp_nlp_sum_merit_fun(config, dims, candidates+k);
+    }
+}
+
+
+
+double ocp_nlp_evaluate_merit_fun(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                  ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
+                                  ocp_nlp_memory *mem, ocp_nlp_workspace *work)
+{
+    /* computes merit function value at iterate: tmp_nlp_out, with weights: work->weight_merit_fun */
+    ocp_nlp_evaluate_merit_fun_candidates(config, dims, in, out, opts, mem, work, 1);
+
+    return mem->candidates[0].merit_fun;
+}
+
+
 static double ocp_nlp_compute_merit_gradient(ocp_nlp_config *config, ocp_nlp_dims *dims,
                                   ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
                                   ocp_nlp_memory *mem, ocp_nlp_workspace *work)
@@ -292,21 +477,20 @@ static int ocp_nlp_line_search(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_n
 {
     ocp_nlp_globalization_merit_backtracking_opts *merit_opts = opts->globalization;
     ocp_nlp_globalization_opts *globalization_opts = merit_opts->globalization_opts;
-    int i, j;
+    int i, j, k;
 
     int N = dims->N;
     int *nv = dims->nv;
 
     double merit_fun1 = 0;
     ocp_qp_out *qp_out = mem->qp_out;
+    ocp_nlp_candidate *candidates = mem->candidates;
+    int num_candidates;
 
     /* MERIT_BACKTRACKING line search */
     // Following Leineweber1999, Section "3.5.1 Line Search Globalization"
     // TODO: check out more advanced step search Leineweber1995
 
-    // copy out (current iterate) to work->tmp_nlp_out
-    for (i = 0; i <= N; i++)
-        blasfeo_dveccp(nv[i], out->ux+i, 0, work->tmp_nlp_out->ux+i, 0);
     // NOTE: copying duals not needed, as they dont enter the merit function
 
     // TODO: think about z here!
@@ -328,18 +512,39 @@ static int ocp_nlp_line_search(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_n
 
     // TODO: why does Leineweber do full step in first SQP iter?
 
-    double merit_fun0 = ocp_nlp_evaluate_merit_fun(config, dims, in, out, opts, mem, work);
-
     double reduction_factor = globalization_opts->alpha_reduction;
-    double max_next_merit_fun_val = merit_fun0;
+    double max_next_merit_fun_val;
     double eps_sufficient_descent = globalization_opts->eps_sufficient_descent;
     double dmerit_dy = 0.0;
     double alpha = 1.0;
 
+    // The trial step sizes are evaluated in batches of line_search_num_candidates, the first one
+    // also contains the current iterate, which is evaluated in the nominal memory (candidate 0).
+    // Within a batch, the first step size passing the descent condition is accepted.
+    // copy out (current iterate) to tmp_nlp_out
+    candidates[0].alpha = 0.0;
+    for (i = 0; i <= N; i++)
+        blasfeo_dveccp(nv[i], out->ux+i, 0, candidates[0].nlp_out->ux+i, 0);
+    num_candidates = 1;
+
+    for (k = 1; k < opts->line_search_num_candidates && alpha*reduction_factor > globalization_opts->alpha_min; k++)
+    {
+        // trial iterate = out + alpha * qp_out
+        candidates[k].alpha = alpha;
+        for (i = 0; i <= N; i++)
+            blasfeo_daxpy(nv[i], alpha, qp_out->ux+i, 0, out->ux+i, 0, candidates[k].nlp_out->ux+i, 0);
+        alpha *= reduction_factor;
+        num_candidates++;
+    }
+
+    ocp_nlp_evaluate_merit_fun_candidates(config, dims, in, out, opts, mem, work, num_candidates);
+    double merit_fun0 = candidates[0].merit_fun;
+
     /* actual Line Search*/
     if (globalization_opts->line_search_use_sufficient_descent)
     {
         // check Armijo-type sufficient descent condition Leinweber1999 (2.35);
+        // NOTE: uses the function values of the current iterate in the nominal memory
         dmerit_dy = ocp_nlp_compute_merit_gradient(config, dims, in, out, opts, mem, work);
         if (dmerit_dy > 0.0)
         {
@@ -366,33 +571,44 @@ static int ocp_nlp_line_search(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_n
     //     break;
     // }
 
-    for (j=0; alpha*reduction_factor > globalization_opts->alpha_min; j++)
+    j = 0;
+    k = 1;
+    while (true)
     {
-        // tmp_nlp_out = out + alpha * qp_out
-        for (i = 0; i <= N; i++)
-            blasfeo_daxpy(nv[i], alpha, qp_out->ux+i, 0, out->ux+i, 0, work->tmp_nlp_out->ux+i, 0);
-
-        merit_fun1 = ocp_nlp_evaluate_merit_fun(config, dims, in, out, opts, mem, work);
-        if (opts->print_level > 1)
+        for (; k < num_candidates; k++, j++)
         {
-            printf("backtracking %d alpha = %f, merit_fun1 = %e, merit_fun0 %e\n", j, alpha, merit_fun1, merit_fun0);
-        }
+            merit_fun1 = candidates[k].merit_fun;
+            if (opts->print_level > 1)
+            {
+                printf("backtracking %d alpha = %f, merit_fun1 = %e, merit_fun0 %e\n", j, candidates[k].alpha, merit_fun1, merit_fun0);
+            }
 
-        // if (merit_fun1 < merit_fun0 && merit_fun1 > max_next_merit_fun_val)
-        // {
-        //     printf("\nalpha %f would be accepted without sufficient descent condition", alpha);
-        // }
+            // if (merit_fun1 < merit_fun0 && merit_fun1 > max_next_merit_fun_val)
+            // {
+            //     printf("\nalpha %f would be accepted without sufficient descent condition", alpha);
+            // }
 
-        max_next_merit_fun_val = merit_fun0 + eps_sufficient_descent * dmerit_dy * alpha;
-        if ((merit_fun1 < max_next_merit_fun_val) && !isnan(merit_fun1) && !isinf(merit_fun1))
-        {
-            *alpha_reference = alpha;
-            return ACADOS_SUCCESS;
+            max_next_merit_fun_val = merit_fun0 + eps_sufficient_descent * dmerit_dy * candidates[k].alpha;
+            if ((merit_fun1 < max_next_merit_fun_val) && !isnan(merit_fun1) && !isinf(merit_fun1))
+            {
+                *alpha_reference = candidates[k].alpha;
+                return ACADOS_SUCCESS;
+            }
         }
-        else
+
+        // next batch of trial step sizes
+        for (k = 0; k < opts->line_search_num_candidates && alpha*reduction_factor > globalization_opts->alpha_min; k++)
         {
+            candidates[k].alpha = alpha;
+            for (i = 0; i <= N; i++)
+                blasfeo_daxpy(nv[i], alpha, qp_out->ux+i, 0, out->ux+i, 0, candidates[k].nlp_out->ux+i, 0);
             alpha *= reduction_factor;
         }
+        num_candidates = k;
+        if (num_candidates == 0)
+            break;
+        ocp_nlp_evaluate_merit_fun_candidates(config, dims, in, out, opts, mem, work, num_candidates);
+        k = 0;
     }
 
     *alpha_reference = alpha;
@@ -420,43 +636,6 @@ void ocp_nlp_globalization_merit_backtracking_print_iteration(double objective_v
     printf("%8.2e   ", mem->alpha);
 }
 
-static double ocp_nlp_get_violation_inf_norm(ocp_nlp_config *config, ocp_nlp_dims *dims,
-                                  ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
-                                  ocp_nlp_memory *mem, ocp_nlp_workspace *work)
-{
-    // computes constraint violation infinity norm
-    // assumes constraint functions are evaluated before, e.g. done in ocp_nlp_evaluate_merit_fun
-    int i, j;
-    int N = dims->N;
-    int *nx = dims->nx;
-    int *ni = dims->ni;
-    struct blasfeo_dvec *tmp_fun_vec;
-    double violation = 0.0;
-    double tmp;
-    for (i=0; i<N; i++)
-    {
-        tmp_fun_vec = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
-        for (j=0; j<nx[i+1]; j++)
-        {
-            tmp = fabs(BLASFEO_DVECEL(tmp_fun_vec, j));
-            violation = tmp > violation ? tmp : violation;
-        }
-    }
-
-    for (i=0; i<=N; i++)
-    {
-        tmp_fun_vec = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
-        for (j=0; j<2*ni[i]; j++)
-        {
-            // Note constraint violation corresponds to > 0
-            tmp = BLASFEO_DVECEL(tmp_fun_vec, j);
-            violation = tmp > violation ? tmp : violation;
-        }
-    }
-
-    return violation;
-}
-
 static void copy_multipliers_nlp_to_qp(ocp_nlp_dims *dims, ocp_nlp_out *from, ocp_qp_out *to)
 {
     int N = dims->N;
@@ -496,12 +675,19 @@ static int ocp_nlp_line_search_merit_check_full_step(ocp_nlp_config *config, ocp
     int *nv = dims->nv;
 
     ocp_qp_out *qp_out = mem->qp_out;
+    ocp_nlp_candidate *candidates = mem->candidates;
+
+    double merit_fun0, merit_fun1;
+    double violation_current, violation_step;
 
-    double merit_fun1;
+    // The full step is evaluated in the nominal memory, the second order correction uses its
+    // function values. With a second candidate, the current iterate is evaluated at the same time.
+    int num_candidates = opts->line_search_num_candidates > 1 ? 2 : 1;
+    ocp_nlp_candidate *current = candidates + num_candidates - 1;
 
-    // copy out (current iterate) to work->tmp_nlp_out
+    // copy out (current iterate) to the trial iterate of the candidate
     for (int i = 0; i <= N; i++)
-        blasfeo_dveccp(nv[i], out->ux+i, 0, work->tmp_nlp_out->ux+i, 0);
+        blasfeo_dveccp(nv[i], out->ux+i, 0, current->nlp_out->ux+i, 0);
     // NOTE: copying duals not needed, as they dont enter the merit function, see ocp_nlp_line_search
 
     /* modify/initialize merit function weights (Leineweber1999 M5.1, p.89) */
@@ -517,18 +703,29 @@ static int ocp_nlp_line_search_merit_check_full_step(ocp_nlp_config *config, ocp
         merit_backtracking_update_weights(dims, work->weight_merit_fun, qp_out);
     }
 
-    double merit_fun0 = ocp_nlp_evaluate_merit_fun(config, dims, in, out, opts, mem, work);
-    double alpha = 1.0;
-
     // TODO(oj): should the merit weight update be undone in case of early termination?
-    double violation_current = ocp_nlp_get_violation_inf_norm(config, dims, in, out, opts, mem, work);
+    if (num_candidates == 1)
+    {
+        ocp_nlp_evaluate_merit_fun_candidates(config, dims, in, out, opts, mem, work, 1);
+        merit_fun0 = current->merit_fun;
+        violation_current = current->violation;
+    }
+
+    double alpha = 1.0;
 
     // tmp_nlp_out = out + alpha * qp_out
     for (int i = 0; i <= N; i++)
-        blasfeo_daxpy(nv[i], alpha, qp_out->ux+i, 0, out->ux+i, 0, work->tmp_nlp_out->ux+i, 0);
-    merit_fun1 = ocp_nlp_evaluate_merit_fun(config, dims, in, out, opts, mem, work);
+        blasfeo_daxpy(nv[i], alpha, qp_out->ux+i, 0, out->ux+i, 0, candidates[0].nlp_out->ux+i, 0);
+    ocp_nlp_evaluate_merit_fun_candidates(config, dims, in, out, opts, mem, work, num_candidates);
+
+    if (num_candidates > 1)
+    {
+        merit_fun0 = current->merit_fun;
+        violation_current = current->violation;
+    }
+    merit_fun1 = candidates[0].merit_fun;
+    violation_step = candidates[0].violation;
 
-    double violation_step = ocp_nlp_get_violation_inf_norm(config, dims, in, out, opts, mem, work);
     if (opts->print_level > 0)
     {
         printf("\npreliminary line_search: merit0 %e, merit1 %e; viol_current %e, viol_step %e\n", merit_fun0, merit_fun1, violation_current, violation_step);
@@ -602,105 +799,6 @@ static bool ocp_nlp_soc_line_search(ocp_nlp_config *config, ocp_nlp_dims *dims,
 
 
 
-double ocp_nlp_evaluate_merit_fun(ocp_nlp_config *config, ocp_nlp_dims *dims,
-                                  ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
-                                  ocp_nlp_memory *mem, ocp_nlp_workspace *work)
-{
-    /* computes merit function value at iterate: tmp_nlp_out, with weights: work->weight_merit_fun */
-    //int j;
-
-    int N = dims->N;
-    int *nx = dims->nx;
-    int *ni = dims->ni;
-
-    double merit_fun = 0.0;
-
-    // set evaluation point to tmp_nlp_out
-    ocp_nlp_set_primal_variable_pointers_in_submodules(config, dims, in, work->tmp_nlp_out, mem);
-    // compute fun value
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i=0; i<N; i++)
-    {
-        // dynamics: Note has to be first, because cost_integration might be used.
-        config->dynamics[i]->compute_fun(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
-                                         opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
-    }
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i=0; i<=N; i++)
-    {
-        // cost
-        config->cost[i]->compute_fun(config->cost[i], dims->cost[i], in->cost[i], opts->cost[i],
-                                    mem->cost[i], work->cost[i]);
-    }
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i=0; i<=N; i++)
-    {
-        // constr
-        config->constraints[i]->compute_fun(config->constraints[i], dims->constraints[i],
-                                            in->constraints[i], opts->constraints[i],
-                                            mem->constraints[i], work->constraints[i]);
-    }
-    // reset evaluation point to SQP iterate
-    ocp_nlp_set_primal_variable_pointers_in_submodules(config, dims, in, out, mem);
-
-    double *tmp_fun;
-    double tmp;
-    struct blasfeo_dvec *tmp_fun_vec;
-
-    double cost_fun = 0.0;
-    for(int i=0; i<=N; i++)
-    {
-        tmp_fun = config->cost[i]->memory_get_fun_ptr(mem->cost[i]);
-        cost_fun += *tmp_fun;
-    }
-
-    double dyn_fun = 0.0;
-    for(int i=0; i<N; i++)
-    {
-        tmp_fun_vec = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
-        // printf("\nMerit: dyn will multiply tmp_fun, weights %d\n", i);
-        // blasfeo_print_exp_tran_dvec(nx[i+1], tmp_fun_vec, 0);
-        // blasfeo_print_exp_tran_dvec(nx[i+1], work->weight_merit_fun->pi+i, 0);
-        for(int j=0; j<nx[i+1]; j++)
-        {
-//            printf("\n%e %e\n", fabs(BLASFEO_DVECEL(work->weight_merit_fun->pi+i, j)), fabs(BLASFEO_DVECEL(tmp_fun_vec, j)));
-            dyn_fun += fabs(BLASFEO_DVECEL(work->weight_merit_fun->pi+i, j)) * fabs(BLASFEO_DVECEL(tmp_fun_vec, j));
-        }
-    }
-
-    double constr_fun = 0.0;
-    for(int i=0; i<=N; i++)
-    {
-//        printf("\ni %d\n", i);
-        tmp_fun_vec = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
-//        blasfeo_print_exp_tran_dvec(2*ni[i], tmp_fun_vec, 0);
-//        blasfeo_print_exp_tran_dvec(2*ni[i], work->weight_merit_fun->lam+i, 0);
-        for (int j=0; j<2*ni[i]; j++)
-        {
-            tmp = BLASFEO_DVECEL(tmp_fun_vec, j);
-            if (tmp > 0.0)
-            {
-                // tmp = constraint violation
-                // printf("IN merit fun: ineq i %d, j %d tmp_fun %e, multiplier %e\n", i, j, tmp, BLASFEO_DVECEL(work->weight_merit_fun->lam+i, j));
-                constr_fun += fabs(BLASFEO_DVECEL(work->weight_merit_fun->lam+i, j)) * tmp;
-            }
-        }
-    }
-
-    merit_fun = cost_fun + dyn_fun + constr_fun;
-
-    // printf("Merit fun: %e cost: %e dyn: %e constr: %e\n", merit_fun, cost_fun, dyn_fun, constr_fun);
-
-    return merit_fun;
-}
-
-
 void merit_backtracking_initialize_weights(ocp_nlp_dims *dims, ocp_nlp_out *weight_merit_fun, ocp_qp_out *qp_out)
 {
     int N = dims->N;
@@ -336,6 +336,107 @@ void ocp_qp_out_copy(ocp_qp_out* from, ocp_qp_out* to)
 }
 
 
+int ocp_qp_in_constraints_match_next_stage(ocp_qp_in *qp_in, int stage)
+{
+    ocp_qp_dims *dims = qp_in->dim;
+    int i = stage;
+
+    if (dims->nu[i] != dims->nu[i+1] || dims->nx[i] != dims->nx[i+1] || dims->nb[i] != dims->nb[i+1] ||
+        dims->ng[i] != dims->ng[i+1] || dims->ns[i] != dims->ns[i+1])
+        return 0;
+
+    for (int j = 0; j < dims->nb[i]; j++)
+    {
+        if (qp_in->idxb[i][j] != qp_in->idxb[i+1][j])
+            return 0;
+    }
+
+    return 1;
+}
+
+
+
+// shifts the vectors of qp_out, except for those which are aliased to the ones of qp_out_skip
+static void ocp_qp_out_shift_except(ocp_qp_in *qp_in, ocp_qp_out *qp_out, ocp_qp_out *qp_out_skip,
+                                    ocp_shift_tail_policy tail_policy)
+{
+    ocp_qp_dims *dims = qp_out->dim;
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *ns = dims->ns;
+
+    bool shift_ux = qp_out_skip == NULL || qp_out->ux != qp_out_skip->ux;
+    bool shift_pi = qp_out_skip == NULL || qp_out->pi != qp_out_skip->pi;
+    bool shift_lam = qp_out_skip == NULL || qp_out->lam != qp_out_skip->lam;
+    bool shift_t = qp_out_skip == NULL || qp_out->t != qp_out_skip->t;
+
+    // NOTE: stage N-1 copies from stage N before the latter is modified, so no OpenMP here
+    for (int i = 0; i < N; i++)
+    {
+        if (shift_ux)
+        {
+            if (nu[i] == nu[i+1])
+                blasfeo_dveccp(nu[i], qp_out->ux+i+1, 0, qp_out->ux+i, 0);
+            if (nx[i] == nx[i+1])
+                blasfeo_dveccp(nx[i], qp_out->ux+i+1, nu[i+1], qp_out->ux+i, nu[i]);
+            if (ns[i] == ns[i+1])
+                blasfeo_dveccp(2*ns[i], qp_out->ux+i+1, nu[i+1]+nx[i+1], qp_out->ux+i, nu[i]+nx[i]);
+        }
+        // lam and t of different constraints are not shifted, the stage is treated as the tail
+        if (ocp_qp_in_constraints_match_next_stage(qp_in, i))
+        {
+            if (shift_lam)
+                blasfeo_dveccp(2*ocp_qp_dims_get_ni(dims, i), qp_out->lam+i+1, 0, qp_out->lam+i, 0);
+            if (shift_t)
+                blasfeo_dveccp(2*ocp_qp_dims_get_ni(dims, i), qp_out->t+i+1, 0, qp_out->t+i, 0);
+        }
+        else if (tail_policy == SHIFT_TAIL_ZERO)
+        {
+            if (shift_lam)
+                blasfeo_dvecse(2*ocp_qp_dims_get_ni(dims, i), 0.0, qp_out->lam+i, 0);
+            if (shift_t)
+                blasfeo_dvecse(2*ocp_qp_dims_get_ni(dims, i), 0.0, qp_out->t+i, 0);
+        }
+        if (shift_pi && i < N-1 && nx[i+1] == nx[i+2])
+            blasfeo_dveccp(nx[i+1], qp_out->pi+i+1, 0, qp_out->pi+i, 0);
+    }
+
+    if (tail_policy == SHIFT_TAIL_ZERO)
+    {
+        if (N > 0)
+        {
+            if (shift_ux)
+                blasfeo_dvecse(nu[N-1], 0.0, qp_out->ux+N-1, 0);
+            if (shift_pi)
+                blasfeo_dvecse(nx[N], 0.0, qp_out->pi+N-1, 0);
+        }
+        if (shift_ux)
+            blasfeo_dvecse(nu[N]+nx[N]+2*ns[N], 0.0, qp_out->ux+N, 0);
+        if (shift_lam)
+            blasfeo_dvecse(2*ocp_qp_dims_get_ni(dims, N), 0.0, qp_out->lam+N, 0);
+        if (shift_t)
+            blasfeo_dvecse(2*ocp_qp_dims_get_ni(dims, N), 0.0, qp_out->t+N, 0);
+    }
+}
+
+
+
+void ocp_qp_out_shift(ocp_qp_in *qp_in, ocp_qp_out *qp_out, ocp_shift_tail_policy tail_policy)
+{
+    ocp_qp_out_shift_except(qp_in, qp_out, NULL, tail_policy);
+}
+
+
+
+void ocp_qp_out_shift_unaliased(ocp_qp_in *qp_in, ocp_qp_out *qp_out, ocp_qp_out *qp_out_shifted,
+                                ocp_shift_tail_policy tail_policy)
+{
+    ocp_qp_out_shift_except(qp_in, qp_out, qp_out_shifted, tail_policy);
+}
+
+
+
 void ocp_qp_out_axpy(double alpha, ocp_qp_out* x, ocp_qp_out* y, ocp_qp_out* z)
 {
     ocp_qp_dims *dims = x->dim;
@@ -171,6 +171,15 @@ void ocp_qp_out_set_to_zero(ocp_qp_out* qp_out);
 void ocp_qp_out_add(double alpha, ocp_qp_out* x, ocp_qp_out* y);
 void ocp_qp_out_sc(double alpha, ocp_qp_out* x);
 double ocp_qp_out_ddot(ocp_qp_out *x, ocp_qp_out *y, struct blasfeo_dvec *work_tmp_2ni);
+// 1 if stage stage+1 has the same dimensions, bound indices idxb and number of general constraints
+int ocp_qp_in_constraints_match_next_stage(ocp_qp_in *qp_in, int stage);
+// shifts all stages by one towards stage 0, blocks with different dimensions in consecutive stages are kept,
+// lam and t only if the constraints match, otherwise the tail policy is applied to them
+void ocp_qp_out_shift(ocp_qp_in *qp_in, ocp_qp_out *qp_out, ocp_shift_tail_policy tail_policy);
+// as ocp_qp_out_shift, but vectors which qp_out shares with the already shifted qp_out_shifted are left as they are,
+// e.g. for a scaled qp_out which aliases some vectors of the unscaled one
+void ocp_qp_out_shift_unaliased(ocp_qp_in *qp_in, ocp_qp_out *qp_out, ocp_qp_out *qp_out_shifted,
+                                ocp_shift_tail_policy tail_policy);
 
 
 /* res */
@@ -45,6 +45,7 @@
 #include "acados/dense_qp/dense_qp_common.h"
 #include "acados/ocp_qp/ocp_qp_common.h"
 #include "acados/ocp_qp/ocp_qp_full_condensing.h"
+#include "acados/utils/math.h"
 #include "acados/utils/mem.h"
 #include "acados/utils/types.h"
 #include "acados/utils/timing.h"
@@ -240,6 +241,8 @@ void ocp_qp_full_condensing_opts_initialize_default(void *dims_, void *opts_)
 
     opts->mem_qp_in = 1;
 
+    opts->skip_unchanged = 0;
+
     return;
 }
 
@@ -279,6 +282,12 @@ void ocp_qp_full_condensing_opts_set(void *opts_, const char *field, void* value
         d_ocp_qp_reduce_eq_dof_arg_set_comp_dual_sol_eq(tmp_ptr, opts->hpipm_red_opts);
         d_ocp_qp_reduce_eq_dof_arg_set_comp_dual_sol_ineq(tmp_ptr, opts->hpipm_red_opts);
     }
+    else if(!strcmp(field, "skip_unchanged"))
+    {
+        // NOTE: has to be set before the memory is created
+        int *tmp_ptr = value;
+        opts->skip_unchanged = *tmp_ptr;
+    }
     else
     {
         printf("\nerror: field %s not available in ocp_qp_full_condensing_opts_set\n", field);
@@ -295,6 +304,92 @@ void ocp_qp_full_condensing_opts_set(void *opts_, const char *field, void* value
  * memory
  ************************************************/
 
+// number of doubles and ints of the lhs of qp_in: BAt, RSQ, DCt, Z and idxb, idxs_rev
+static void lhs_size(ocp_qp_dims *dims, int *num_double, int *num_int)
+{
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *nb = dims->nb;
+    int *ng = dims->ng;
+    int *ns = dims->ns;
+
+    *num_double = 0;
+    *num_int = 0;
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nv = nu[ii] + nx[ii];
+        if (ii < N)
+            *num_double += nv * nx[ii + 1];
+        *num_double += nv * nv + nv * ng[ii] + 2 * ns[ii];
+        *num_int += nb[ii];
+        if (ns[ii] > 0)
+            *num_int += nb[ii] + ng[ii];
+    }
+}
+
+
+
+// stores the lhs of qp_in, returns 1 if any of it changed since the last call
+static int track_lhs_changes(ocp_qp_in *qp_in, double *lhs_prev, int *idx_prev)
+{
+    ocp_qp_dims *dims = qp_in->dim;
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *nb = dims->nb;
+    int *ng = dims->ng;
+    int *ns = dims->ns;
+
+    int changed = 0;
+    int nd = 0;
+    int ni = 0;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nv = nu[ii] + nx[ii];
+
+        if (ii < N)
+        {
+            for (int jj = 0; jj < nx[ii + 1]; jj++)
+                for (int kk = 0; kk < nv; kk++)
+                    changed |= track_change(BLASFEO_DMATEL(qp_in->BAbt + ii, kk, jj), lhs_prev + nd++);
+        }
+        for (int jj = 0; jj < nv; jj++)
+            for (int kk = 0; kk < nv; kk++)
+                changed |= track_change(BLASFEO_DMATEL(qp_in->RSQrq + ii, kk, jj), lhs_prev + nd++);
+        for (int jj = 0; jj < ng[ii]; jj++)
+            for (int kk = 0; kk < nv; kk++)
+                changed |= track_change(BLASFEO_DMATEL(qp_in->DCt + ii, kk, jj), lhs_prev + nd++);
+        for (int jj = 0; jj < 2 * ns[ii]; jj++)
+            changed |= track_change(BLASFEO_DVECEL(qp_in->Z + ii, jj), lhs_prev + nd++);
+
+        for (int jj = 0; jj < nb[ii]; jj++, ni++)
+        {
+            if (qp_in->idxb[ii][jj] != idx_prev[ni])
+            {
+                idx_prev[ni] = qp_in->idxb[ii][jj];
+                changed = 1;
+            }
+        }
+        if (ns[ii] > 0)
+        {
+            for (int jj = 0; jj < nb[ii] + ng[ii]; jj++, ni++)
+            {
+                if (qp_in->idxs_rev[ii][jj] != idx_prev[ni])
+                {
+                    idx_prev[ni] = qp_in->idxs_rev[ii][jj];
+                    changed = 1;
+                }
+            }
+        }
+    }
+
+    return changed;
+}
+
+
+
 acados_size_t ocp_qp_full_condensing_memory_calculate_size(void *dims_, void *opts_)
 {
     ocp_qp_full_condensing_dims *dims = dims_;
@@ -323,6 +418,15 @@ acados_size_t ocp_qp_full_condensing_memory_calculate_size(void *dims_, void *op
     size += sizeof(struct d_ocp_qp_reduce_eq_dof_ws);
     size += d_ocp_qp_reduce_eq_dof_ws_memsize(dims->orig_dims);
 
+    if (opts->skip_unchanged)
+    {
+        int num_double, num_int;
+        lhs_size(dims->orig_dims, &num_double, &num_int);
+        size += num_double * sizeof(double);  // lhs_prev
+        size += num_int * sizeof(int);        // idx_prev
+        size += 8;
+    }
+
     size += 2*8;
 
     return size;
@@ -382,6 +486,23 @@ void *ocp_qp_full_condensing_memory_assign(void *dims_, void *opts_, void *raw_m
 
     mem->qp_out_info = (qp_info *) mem->fcond_qp_out->misc;
 
+    mem->skip_unchanged = opts->skip_unchanged;
+    mem->lhs_changed = 1;
+    mem->first_run = 1;
+    if (mem->skip_unchanged)
+    {
+        int num_double, num_int;
+        lhs_size(dims->orig_dims, &num_double, &num_int);
+
+        align_char_to(8, &c_ptr);
+
+        mem->lhs_prev = (double *) c_ptr;
+        c_ptr += num_double * sizeof(double);
+
+        mem->idx_prev = (int *) c_ptr;
+        c_ptr += num_int * sizeof(int);
+    }
+
     assert((char *) raw_memory + ocp_qp_full_condensing_memory_calculate_size(dims, opts) >= c_ptr);
 
     return mem;
@@ -418,6 +539,11 @@ void ocp_qp_full_condensing_memory_get(void *config_, void *mem_, const char *fi
         double *ptr = value;
         *ptr = mem->time_qp_xcond;
     }
+    else if (!strcmp(field, "lhs_changed"))
+    {
+        int *ptr = value;
+        *ptr = mem->lhs_changed;
+    }
     else
     {
         printf("\nerror: ocp_qp_full_condensing_memory_get: field %s not available\n", field);
@@ -447,6 +573,25 @@ acados_size_t ocp_qp_full_condensing_workspace_calculate_size(void *dims_, void
  * functions
  ************************************************/
 
+// checks if the lhs of qp_in has to be condensed
+static int update_lhs_changed(ocp_qp_in *qp_in, ocp_qp_full_condensing_memory *mem)
+{
+    if (mem->skip_unchanged)
+    {
+        int changed = track_lhs_changes(qp_in, mem->lhs_prev, mem->idx_prev);
+        mem->lhs_changed = mem->first_run || changed;
+        mem->first_run = 0;
+    }
+    else
+    {
+        mem->lhs_changed = 1;
+    }
+
+    return mem->lhs_changed;
+}
+
+
+
 int ocp_qp_full_condensing(void *qp_in_, void *fcond_qp_in_, void *opts_, void *mem_, void *work_)
 {
     ocp_qp_in *qp_in = qp_in_;
@@ -462,6 +607,17 @@ int ocp_qp_full_condensing(void *qp_in_, void *fcond_qp_in_, void *opts_, void *
     // start timer
     acados_tic(&timer);
 
+    if (opts->cond_hess != 0 && !update_lhs_changed(qp_in, mem))
+    {
+        // same matrices as in the last call: the condensed Hessian and constraint matrix are still
+        // in fcond_qp_in, reduce and condense gradient and bounds only
+        d_ocp_qp_reduce_eq_dof_rhs(qp_in, mem->red_qp, opts->hpipm_red_opts, mem->hpipm_red_work);
+        d_cond_qp_cond_rhs(mem->red_qp, fcond_qp_in, opts->hpipm_cond_opts, mem->hpipm_cond_work);
+
+        mem->time_qp_xcond = acados_toc(&timer);
+        return ACADOS_SUCCESS;
+    }
+
 //d_ocp_qp_dim_print(qp_in->dim);
 //d_ocp_qp_dim_print(mem->red_qp->dim);
     // reduce eq constr DOF
@@ -520,6 +676,13 @@ int ocp_qp_full_condensing_condense_lhs(void *qp_in_, void *fcond_qp_in_, void *
     // start timer
     acados_tic(&timer);
 
+    // the condensed Hessian and constraint matrix of the last call are still valid
+    if (opts->cond_hess != 0 && !update_lhs_changed(qp_in, mem))
+    {
+        mem->time_qp_xcond = acados_toc(&timer);
+        return ACADOS_SUCCESS;
+    }
+
     // reduce eq constr DOF
     d_ocp_qp_reduce_eq_dof_lhs(qp_in, mem->red_qp, opts->hpipm_red_opts, mem->hpipm_red_work);
 
@@ -63,6 +63,7 @@ typedef struct ocp_qp_full_condensing_opts_
     int expand_dual_sol; // 0 primal sol only, 1 primal + dual sol
     int ric_alg;
     int mem_qp_in; // allocate qp_in in memory
+    int skip_unchanged; // no lhs condensing if the matrices of qp_in did not change, default 0
 } ocp_qp_full_condensing_opts;
 
 
@@ -83,6 +84,12 @@ typedef struct ocp_qp_full_condensing_memory_
     ocp_qp_seed *ptr_qp_seed;
     qp_info *qp_out_info; // info in fcond_qp_in
     double time_qp_xcond;
+    // change tracking: matrices of qp_in at the last lhs condensing
+    int skip_unchanged;
+    int lhs_changed;
+    int first_run;
+    double *lhs_prev;
+    int *idx_prev;
 } ocp_qp_full_condensing_memory;
 
 
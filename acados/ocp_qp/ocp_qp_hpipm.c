@@ -37,6 +37,11 @@
 #include "hpipm/include/hpipm_d_ocp_qp.h"
 #include "hpipm/include/hpipm_d_ocp_qp_ipm.h"
 #include "hpipm/include/hpipm_d_ocp_qp_sol.h"
+#include "hpipm/include/hpipm_s_ocp_qp.h"
+#include "hpipm/include/hpipm_s_ocp_qp_dim.h"
+#include "hpipm/include/hpipm_s_ocp_qp_ipm.h"
+#include "hpipm/include/hpipm_s_ocp_qp_seed.h"
+#include "hpipm/include/hpipm_s_ocp_qp_sol.h"
 
 // uncomment to codegen QP
 // #include "hpipm/include/hpipm_d_ocp_qp_utils.h"
@@ -55,14 +60,41 @@
  * opts
  ************************************************/
 
+// single precision dims sharing the dimension arrays of dims, only valid for the hpipm memsize routines
+static void ocp_qp_hpipm_sp_dim_alias(ocp_qp_dims *dims, struct s_ocp_qp_dim *sp_dim)
+{
+    sp_dim->nx = dims->nx;
+    sp_dim->nu = dims->nu;
+    sp_dim->nb = dims->nb;
+    sp_dim->nbx = dims->nbx;
+    sp_dim->nbu = dims->nbu;
+    sp_dim->ng = dims->ng;
+    sp_dim->ns = dims->ns;
+    sp_dim->nsbx = dims->nsbx;
+    sp_dim->nsbu = dims->nsbu;
+    sp_dim->nsg = dims->nsg;
+    sp_dim->nbxe = dims->nbxe;
+    sp_dim->nbue = dims->nbue;
+    sp_dim->nge = dims->nge;
+    sp_dim->N = dims->N;
+    sp_dim->memsize = 0;
+}
+
+
+
 acados_size_t ocp_qp_hpipm_opts_calculate_size(void *config_, void *dims_)
 {
     ocp_qp_dims *dims = dims_;
 
+    struct s_ocp_qp_dim sp_dim;
+    ocp_qp_hpipm_sp_dim_alias(dims, &sp_dim);
+
     acados_size_t size = 0;
     size += sizeof(ocp_qp_hpipm_opts);
     size += sizeof(struct d_ocp_qp_ipm_arg);
     size += d_ocp_qp_ipm_arg_memsize(dims);
+    size += sizeof(struct s_ocp_qp_ipm_arg);
+    size += s_ocp_qp_ipm_arg_memsize(&sp_dim);
 
     size += 1 * 8;
     make_int_multiple_of(8, &size);
@@ -85,12 +117,20 @@ void *ocp_qp_hpipm_opts_assign(void *config_, void *dims_, void *raw_memory)
     opts->hpipm_opts = (struct d_ocp_qp_ipm_arg *) c_ptr;
     c_ptr += sizeof(struct d_ocp_qp_ipm_arg);
 
+    opts->sp_arg = (struct s_ocp_qp_ipm_arg *) c_ptr;
+    c_ptr += sizeof(struct s_ocp_qp_ipm_arg);
+
     align_char_to(8, &c_ptr);
     assert((size_t) c_ptr % 8 == 0 && "memory not 8-byte aligned!");
 
     d_ocp_qp_ipm_arg_create(dims, opts->hpipm_opts, c_ptr);
     c_ptr += d_ocp_qp_ipm_arg_memsize(dims);
 
+    struct s_ocp_qp_dim sp_dim;
+    ocp_qp_hpipm_sp_dim_alias(dims, &sp_dim);
+    s_ocp_qp_ipm_arg_create(&sp_dim, opts->sp_arg, c_ptr);
+    c_ptr += opts->sp_arg->memsize;
+
     assert((char *) raw_memory + ocp_qp_hpipm_opts_calculate_size(config_, dims) >= c_ptr);
 
     return (void *) opts;
@@ -122,6 +162,9 @@ void ocp_qp_hpipm_opts_initialize_default(void *config_, void *dims_, void *opts
 
     ocp_qp_hpipm_opts_overwrite_mode_opts(opts);
     opts->print_level = 0;
+    opts->mixed_precision = 0;
+    opts->refine_iter_max = 5;
+    s_ocp_qp_ipm_arg_set_default(SPEED, opts->sp_arg);
 
     return;
 }
@@ -162,6 +205,16 @@ void ocp_qp_hpipm_opts_set(void *config_, void *opts_, const char *field, void *
         int* print_level = (int *) value;
         opts->print_level = *print_level;
     }
+    else if (!strcmp(field, "mixed_precision"))
+    {
+        int* mixed_precision = (int *) value;
+        opts->mixed_precision = *mixed_precision;
+    }
+    else if (!strcmp(field, "refine_iter_max"))
+    {
+        int* refine_iter_max = (int *) value;
+        opts->refine_iter_max = *refine_iter_max;
+    }
     else
     {
         d_ocp_qp_ipm_arg_set((char *) field, value, opts->hpipm_opts);
@@ -175,7 +228,278 @@ void ocp_qp_hpipm_opts_get(void *config_, void *opts_, const char *field, void *
 {
     ocp_qp_hpipm_opts *opts = opts_;
 
-    d_ocp_qp_ipm_arg_get((char *) field, opts->hpipm_opts, value);
+    if (!strcmp(field, "mixed_precision"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = opts->mixed_precision;
+    }
+    else if (!strcmp(field, "refine_iter_max"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = opts->refine_iter_max;
+    }
+    else
+    {
+        d_ocp_qp_ipm_arg_get((char *) field, opts->hpipm_opts, value);
+    }
+
+    return;
+}
+
+
+
+/************************************************
+ * mixed precision helpers
+ ************************************************/
+
+static void ocp_qp_hpipm_sp_dim_convert(ocp_qp_dims *dims, struct s_ocp_qp_dim *sp_dim)
+{
+    for (int ii = 0; ii <= dims->N; ii++)
+    {
+        s_ocp_qp_dim_set("nx", ii, dims->nx[ii], sp_dim);
+        s_ocp_qp_dim_set("nu", ii, dims->nu[ii], sp_dim);
+        s_ocp_qp_dim_set("nbx", ii, dims->nbx[ii], sp_dim);
+        s_ocp_qp_dim_set("nbu", ii, dims->nbu[ii], sp_dim);
+        s_ocp_qp_dim_set("ng", ii, dims->ng[ii], sp_dim);
+        s_ocp_qp_dim_set("nsbx", ii, dims->nsbx[ii], sp_dim);
+        s_ocp_qp_dim_set("nsbu", ii, dims->nsbu[ii], sp_dim);
+        s_ocp_qp_dim_set("nsg", ii, dims->nsg[ii], sp_dim);
+        s_ocp_qp_dim_set("nbxe", ii, dims->nbxe[ii], sp_dim);
+        s_ocp_qp_dim_set("nbue", ii, dims->nbue[ii], sp_dim);
+        s_ocp_qp_dim_set("nge", ii, dims->nge[ii], sp_dim);
+    }
+}
+
+
+
+static void ocp_qp_hpipm_sp_arg_update(ocp_qp_hpipm_opts *opts, struct s_ocp_qp_ipm_arg *sp_arg)
+{
+    // the single precision IPM only has to get close enough for the refinement to converge
+    float tol_stat = 1e-4;
+    float tol_eq = 1e-4;
+    float tol_ineq = 1e-4;
+    float tol_comp = 1e-4;
+    float mu0 = (float) opts->hpipm_opts->mu0;
+    int iter_max = opts->hpipm_opts->iter_max;
+    int warm_start = 0;
+
+    s_ocp_qp_ipm_arg_set_tol_stat(&tol_stat, sp_arg);
+    s_ocp_qp_ipm_arg_set_tol_eq(&tol_eq, sp_arg);
+    s_ocp_qp_ipm_arg_set_tol_ineq(&tol_ineq, sp_arg);
+    s_ocp_qp_ipm_arg_set_tol_comp(&tol_comp, sp_arg);
+    s_ocp_qp_ipm_arg_set_mu0(&mu0, sp_arg);
+    s_ocp_qp_ipm_arg_set_iter_max(&iter_max, sp_arg);
+    s_ocp_qp_ipm_arg_set_warm_start(&warm_start, sp_arg);
+}
+
+
+
+static acados_size_t ocp_qp_hpipm_sp_memory_calculate_size(ocp_qp_dims *dims, ocp_qp_hpipm_opts *opts)
+{
+    int N = dims->N;
+
+    struct s_ocp_qp_dim sp_dim;
+    ocp_qp_hpipm_sp_dim_alias(dims, &sp_dim);
+
+    acados_size_t size = 0;
+
+    size += sizeof(struct s_ocp_qp_dim) + s_ocp_qp_dim_memsize(N);
+    size += sizeof(struct s_ocp_qp) + s_ocp_qp_memsize(&sp_dim);
+    size += 2 * (sizeof(struct s_ocp_qp_sol) + s_ocp_qp_sol_memsize(&sp_dim));
+    size += sizeof(struct s_ocp_qp_seed) + s_ocp_qp_seed_memsize(&sp_dim);
+    size += sizeof(struct s_ocp_qp_ipm_ws) + s_ocp_qp_ipm_ws_memsize(&sp_dim, opts->sp_arg);
+    size += ocp_qp_res_calculate_size(dims);
+    size += ocp_qp_res_workspace_calculate_size(dims);
+
+    size += 8 * 8;
+
+    return size;
+}
+
+
+
+static void ocp_qp_hpipm_dmat_to_smat(int m, int n, struct blasfeo_dmat *sA, struct blasfeo_smat *sB)
+{
+    for (int jj = 0; jj < n; jj++)
+        for (int ii = 0; ii < m; ii++)
+            BLASFEO_SMATEL(sB, ii, jj) = (float) BLASFEO_DMATEL(sA, ii, jj);
+}
+
+
+
+static void ocp_qp_hpipm_dvec_to_svec(int m, struct blasfeo_dvec *sx, struct blasfeo_svec *sy)
+{
+    for (int ii = 0; ii < m; ii++)
+        BLASFEO_SVECEL(sy, ii) = (float) BLASFEO_DVECEL(sx, ii);
+}
+
+
+
+// y += x
+static void ocp_qp_hpipm_svec_add_to_dvec(int m, struct blasfeo_svec *sx, struct blasfeo_dvec *sy)
+{
+    for (int ii = 0; ii < m; ii++)
+        BLASFEO_DVECEL(sy, ii) += (double) BLASFEO_SVECEL(sx, ii);
+}
+
+
+
+static void ocp_qp_hpipm_sp_qp_convert(ocp_qp_in *qp_in, struct s_ocp_qp *sp_qp)
+{
+    ocp_qp_dims *dims = qp_in->dim;
+    int N = dims->N;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nx = dims->nx[ii];
+        int nu = dims->nu[ii];
+        int nb = dims->nb[ii];
+        int ng = dims->ng[ii];
+        int ns = dims->ns[ii];
+
+        if (ii < N)
+        {
+            ocp_qp_hpipm_dmat_to_smat(nu+nx+1, dims->nx[ii+1], qp_in->BAbt+ii, sp_qp->BAbt+ii);
+            ocp_qp_hpipm_dvec_to_svec(dims->nx[ii+1], qp_in->b+ii, sp_qp->b+ii);
+        }
+        ocp_qp_hpipm_dmat_to_smat(nu+nx+1, nu+nx, qp_in->RSQrq+ii, sp_qp->RSQrq+ii);
+        ocp_qp_hpipm_dvec_to_svec(nu+nx+2*ns, qp_in->rqz+ii, sp_qp->rqz+ii);
+        ocp_qp_hpipm_dmat_to_smat(nu+nx, ng, qp_in->DCt+ii, sp_qp->DCt+ii);
+        ocp_qp_hpipm_dvec_to_svec(2*nb+2*ng+2*ns, qp_in->d+ii, sp_qp->d+ii);
+        ocp_qp_hpipm_dvec_to_svec(2*nb+2*ng+2*ns, qp_in->d_mask+ii, sp_qp->d_mask+ii);
+        ocp_qp_hpipm_dvec_to_svec(2*nb+2*ng+2*ns, qp_in->m+ii, sp_qp->m+ii);
+        ocp_qp_hpipm_dvec_to_svec(2*ns, qp_in->Z+ii, sp_qp->Z+ii);
+
+        for (int jj = 0; jj < nb; jj++)
+            sp_qp->idxb[ii][jj] = qp_in->idxb[ii][jj];
+        for (int jj = 0; jj < nb+ng; jj++)
+            sp_qp->idxs_rev[ii][jj] = qp_in->idxs_rev[ii][jj];
+        for (int jj = 0; jj < dims->nbxe[ii]+dims->nbue[ii]+dims->nge[ii]; jj++)
+            sp_qp->idxe[ii][jj] = qp_in->idxe[ii][jj];
+        sp_qp->diag_H_flag[ii] = qp_in->diag_H_flag[ii];
+    }
+}
+
+
+
+// single precision IPM followed by iterative refinement on the double precision residual,
+// the Newton corrections reuse the last single precision KKT factorization
+static void ocp_qp_hpipm_mixed_precision(ocp_qp_in *qp_in, ocp_qp_out *qp_out,
+                                         ocp_qp_hpipm_opts *opts, ocp_qp_hpipm_memory *mem)
+{
+    ocp_qp_dims *dims = qp_in->dim;
+    qp_info *info = qp_out->misc;
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *nb = dims->nb;
+    int *ng = dims->ng;
+    int *ns = dims->ns;
+
+    int ii, jj;
+    double res_nrm[4], res_nrm_prev;
+    double tol[4] = {opts->hpipm_opts->res_g_max, opts->hpipm_opts->res_b_max,
+                     opts->hpipm_opts->res_d_max, opts->hpipm_opts->res_m_max};
+
+    // single precision solve
+    ocp_qp_hpipm_sp_qp_convert(qp_in, mem->sp_qp);
+    ocp_qp_hpipm_sp_arg_update(opts, opts->sp_arg);
+
+    s_ocp_qp_ipm_solve(mem->sp_qp, mem->sp_sol, opts->sp_arg, mem->sp_workspace);
+    s_ocp_qp_ipm_get_status(mem->sp_workspace, &mem->status);
+    mem->iter = mem->sp_workspace->iter;
+
+    for (ii = 0; ii <= N; ii++)
+    {
+        blasfeo_dvecse(nu[ii]+nx[ii]+2*ns[ii], 0.0, qp_out->ux+ii, 0);
+        blasfeo_dvecse(2*nb[ii]+2*ng[ii]+2*ns[ii], 0.0, qp_out->lam+ii, 0);
+        blasfeo_dvecse(2*nb[ii]+2*ng[ii]+2*ns[ii], 0.0, qp_out->t+ii, 0);
+        ocp_qp_hpipm_svec_add_to_dvec(nu[ii]+nx[ii]+2*ns[ii], mem->sp_sol->ux+ii, qp_out->ux+ii);
+        ocp_qp_hpipm_svec_add_to_dvec(2*nb[ii]+2*ng[ii]+2*ns[ii], mem->sp_sol->lam+ii, qp_out->lam+ii);
+        ocp_qp_hpipm_svec_add_to_dvec(2*nb[ii]+2*ng[ii]+2*ns[ii], mem->sp_sol->t+ii, qp_out->t+ii);
+        if (ii < N)
+        {
+            blasfeo_dvecse(nx[ii+1], 0.0, qp_out->pi+ii, 0);
+            ocp_qp_hpipm_svec_add_to_dvec(nx[ii+1], mem->sp_sol->pi+ii, qp_out->pi+ii);
+        }
+    }
+    info->t_computed = 1;
+
+    // iterative refinement
+    int converged = 0;
+    res_nrm_prev = 0.0;
+    for (mem->refine_iter = 0; ; mem->refine_iter++)
+    {
+        ocp_qp_res_compute(qp_in, qp_out, mem->res, mem->res_ws);
+        ocp_qp_res_compute_nrm_inf(mem->res, res_nrm);
+
+        converged = res_nrm[0] <= tol[0] && res_nrm[1] <= tol[1] &&
+                    res_nrm[2] <= tol[2] && res_nrm[3] <= tol[3];
+
+        double res_nrm_max = 0.0;
+        for (jj = 0; jj < 4; jj++)
+            res_nrm_max = res_nrm[jj] > res_nrm_max ? res_nrm[jj] : res_nrm_max;
+
+        // stop if converged, out of iterations or if the single precision factorization
+        // is not accurate enough for the refinement to contract
+        if (converged || mem->refine_iter >= opts->refine_iter_max ||
+            (mem->refine_iter > 0 && res_nrm_max >= res_nrm_prev))
+            break;
+        res_nrm_prev = res_nrm_max;
+
+        for (ii = 0; ii <= N; ii++)
+        {
+            ocp_qp_hpipm_dvec_to_svec(nu[ii]+nx[ii]+2*ns[ii], mem->res->res_g+ii, mem->sp_seed->seed_g+ii);
+            ocp_qp_hpipm_dvec_to_svec(2*nb[ii]+2*ng[ii]+2*ns[ii], mem->res->res_d+ii, mem->sp_seed->seed_d+ii);
+            ocp_qp_hpipm_dvec_to_svec(2*nb[ii]+2*ng[ii]+2*ns[ii], mem->res->res_m+ii, mem->sp_seed->seed_m+ii);
+            if (ii < N)
+                ocp_qp_hpipm_dvec_to_svec(nx[ii+1], mem->res->res_b+ii, mem->sp_seed->seed_b+ii);
+        }
+
+        s_ocp_qp_ipm_sens_frw(mem->sp_qp, mem->sp_seed, mem->sp_step, opts->sp_arg, mem->sp_workspace);
+
+        for (ii = 0; ii <= N; ii++)
+        {
+            ocp_qp_hpipm_svec_add_to_dvec(nu[ii]+nx[ii]+2*ns[ii], mem->sp_step->ux+ii, qp_out->ux+ii);
+            ocp_qp_hpipm_svec_add_to_dvec(2*nb[ii]+2*ng[ii]+2*ns[ii], mem->sp_step->lam+ii, qp_out->lam+ii);
+            ocp_qp_hpipm_svec_add_to_dvec(2*nb[ii]+2*ng[ii]+2*ns[ii], mem->sp_step->t+ii, qp_out->t+ii);
+            if (ii < N)
+                ocp_qp_hpipm_svec_add_to_dvec(nx[ii+1], mem->sp_step->pi+ii, qp_out->pi+ii);
+        }
+    }
+
+    // the Newton corrections do not keep the iterate interior
+    for (ii = 0; ii <= N && converged; ii++)
+    {
+        for (jj = 0; jj < 2*nb[ii]+2*ng[ii]+2*ns[ii]; jj++)
+        {
+            if (BLASFEO_DVECEL(qp_out->lam+ii, jj) < 0.0 || BLASFEO_DVECEL(qp_out->t+ii, jj) < 0.0)
+            {
+                converged = 0;
+                break;
+            }
+        }
+    }
+
+    // fall back to the double precision IPM, warm started from the refined solution
+    mem->refine_fallback = 0;
+    if (!converged)
+    {
+        int warm_start = opts->hpipm_opts->warm_start;
+        int warm_start_primal_dual = 2;
+        d_ocp_qp_ipm_arg_set_warm_start(&warm_start_primal_dual, opts->hpipm_opts);
+        d_ocp_qp_ipm_solve(qp_in, qp_out, opts->hpipm_opts, mem->hpipm_workspace);
+        d_ocp_qp_ipm_arg_set_warm_start(&warm_start, opts->hpipm_opts);
+
+        d_ocp_qp_ipm_get_status(mem->hpipm_workspace, &mem->status);
+        mem->iter += mem->hpipm_workspace->iter;
+        mem->refine_fallback = 1;
+    }
+    else
+    {
+        mem->status = 0;
+    }
+    mem->iter += mem->refine_iter;
 
     return;
 }
@@ -198,6 +522,9 @@ acados_size_t ocp_qp_hpipm_memory_calculate_size(void *config_, void *dims_, voi
 
     size += d_ocp_qp_ipm_ws_memsize(dims, opts->hpipm_opts);
 
+    if (opts->mixed_precision)
+        size += ocp_qp_hpipm_sp_memory_calculate_size(dims, opts);
+
     size += 1 * 8;
     make_int_multiple_of(8, &size);
 
@@ -230,6 +557,65 @@ void *ocp_qp_hpipm_memory_assign(void *config_, void *dims_, void *opts_, void *
     d_ocp_qp_ipm_ws_create(dims, opts->hpipm_opts, ipm_workspace, c_ptr);
     c_ptr += ipm_workspace->memsize;
 
+    mem->sp_dim = NULL;
+    mem->sp_qp = NULL;
+    mem->sp_sol = NULL;
+    mem->sp_step = NULL;
+    mem->sp_seed = NULL;
+    mem->sp_workspace = NULL;
+    mem->res = NULL;
+    mem->res_ws = NULL;
+    mem->refine_iter = 0;
+    mem->refine_fallback = 0;
+
+    if (opts->mixed_precision)
+    {
+        int N = dims->N;
+
+        align_char_to(8, &c_ptr);
+
+        // structures
+        mem->sp_dim = (struct s_ocp_qp_dim *) c_ptr;
+        c_ptr += sizeof(struct s_ocp_qp_dim);
+        mem->sp_qp = (struct s_ocp_qp *) c_ptr;
+        c_ptr += sizeof(struct s_ocp_qp);
+        mem->sp_sol = (struct s_ocp_qp_sol *) c_ptr;
+        c_ptr += sizeof(struct s_ocp_qp_sol);
+        mem->sp_step = (struct s_ocp_qp_sol *) c_ptr;
+        c_ptr += sizeof(struct s_ocp_qp_sol);
+        mem->sp_seed = (struct s_ocp_qp_seed *) c_ptr;
+        c_ptr += sizeof(struct s_ocp_qp_seed);
+        mem->sp_workspace = (struct s_ocp_qp_ipm_ws *) c_ptr;
+        c_ptr += sizeof(struct s_ocp_qp_ipm_ws);
+
+        align_char_to(8, &c_ptr);
+
+        mem->res = ocp_qp_res_assign(dims, c_ptr);
+        c_ptr += ocp_qp_res_calculate_size(dims);
+        mem->res_ws = ocp_qp_res_workspace_assign(dims, c_ptr);
+        c_ptr += ocp_qp_res_workspace_calculate_size(dims);
+
+        align_char_to(8, &c_ptr);
+
+        // hpipm single precision structures
+        s_ocp_qp_dim_create(N, mem->sp_dim, c_ptr);
+        c_ptr += mem->sp_dim->memsize;
+        ocp_qp_hpipm_sp_dim_convert(dims, mem->sp_dim);
+
+        s_ocp_qp_create(mem->sp_dim, mem->sp_qp, c_ptr);
+        c_ptr += mem->sp_qp->memsize;
+        s_ocp_qp_sol_create(mem->sp_dim, mem->sp_sol, c_ptr);
+        c_ptr += mem->sp_sol->memsize;
+        s_ocp_qp_sol_create(mem->sp_dim, mem->sp_step, c_ptr);
+        c_ptr += mem->sp_step->memsize;
+        s_ocp_qp_seed_create(mem->sp_dim, mem->sp_seed, c_ptr);
+        c_ptr += mem->sp_seed->memsize;
+
+        ocp_qp_hpipm_sp_arg_update(opts, opts->sp_arg);
+        s_ocp_qp_ipm_ws_create(mem->sp_dim, opts->sp_arg, mem->sp_workspace, c_ptr);
+        c_ptr += mem->sp_workspace->memsize;
+    }
+
     assert((char *) raw_memory + ocp_qp_hpipm_memory_calculate_size(config_, dims, opts_) >= c_ptr);
 
     return mem;
@@ -262,6 +648,16 @@ void ocp_qp_hpipm_memory_get(void *config_, void *mem_, const char *field, void*
         double *tmp_ptr = value;
         d_ocp_qp_ipm_get_tau_iter(mem->hpipm_workspace, tmp_ptr);
     }
+    else if (!strcmp(field, "refine_iter"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->refine_iter;
+    }
+    else if (!strcmp(field, "refine_fallback"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->refine_fallback;
+    }
     else
     {
         printf("\nerror: ocp_qp_hpipm_memory_get: field %s not available\n", field);
@@ -314,6 +710,33 @@ int ocp_qp_hpipm(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *
         blasfeo_dvecse(nu[ii]+nx[ii]+2*ns[ii], 0.0, qp_out->ux+ii, 0);
     }
 
+    if (opts->mixed_precision)
+    {
+        if (mem->sp_workspace == NULL)
+        {
+            printf("\nerror: ocp_qp_hpipm: mixed_precision has to be set before the memory is created\n");
+            exit(1);
+        }
+
+        acados_tic(&qp_timer);
+        ocp_qp_hpipm_mixed_precision(qp_in, qp_out, opts, mem);
+
+        info->solve_QP_time = acados_toc(&qp_timer);
+        info->interface_time = 0;
+        info->total_time = acados_toc(&tot_timer);
+        info->num_iter = mem->iter;
+        info->t_computed = 1;
+
+        mem->time_qp_solver_call = info->solve_QP_time;
+
+        int acados_status = mem->status;
+        if (mem->status == 0) acados_status = ACADOS_SUCCESS;
+        if (mem->status == 1) acados_status = ACADOS_MAXITER;
+        if (mem->status == 2) acados_status = ACADOS_MINSTEP;
+
+        return acados_status;
+    }
+
     // solve ipm
     acados_tic(&qp_timer);
     // print_ocp_qp_in(qp_in);
@@ -397,6 +820,12 @@ void ocp_qp_hpipm_solver_get(void *config_, void *qp_in_, void *qp_out_, void *o
     int nx = qp_in->dim->nx[stage];
     int nu = qp_in->dim->nu[stage];
 
+    if (opts->mixed_precision)
+    {
+        printf("\nocp_qp_hpipm_solver_get: Riccati factorization not available with mixed_precision\n");
+        return;
+    }
+
     if (!strcmp(field, "P"))
     {
         if ((size1 != nx) || (size2 != nx))
@@ -458,6 +887,12 @@ void ocp_qp_hpipm_eval_forw_sens(void *config_, void *param_qp_in_, void *seed,
     ocp_qp_hpipm_opts *opts = opts_;
     ocp_qp_hpipm_memory *mem = mem_;
 
+    if (opts->mixed_precision)
+    {
+        printf("\nerror: ocp_qp_hpipm_eval_forw_sens: not supported with mixed_precision\n");
+        exit(1);
+    }
+
     d_ocp_qp_ipm_sens_frw(param_qp_in, seed, sens_qp_out, opts->hpipm_opts, mem->hpipm_workspace);
 
     return;
@@ -472,6 +907,12 @@ void ocp_qp_hpipm_eval_adj_sens(void *config_, void *param_qp_in_, void *seed, v
     ocp_qp_hpipm_opts *opts = opts_;
     ocp_qp_hpipm_memory *mem = mem_;
 
+    if (opts->mixed_precision)
+    {
+        printf("\nerror: ocp_qp_hpipm_eval_adj_sens: not supported with mixed_precision\n");
+        exit(1);
+    }
+
     d_ocp_qp_ipm_sens_adj(param_qp_in, seed, sens_qp_out, opts->hpipm_opts, mem->hpipm_workspace);
 
     return;
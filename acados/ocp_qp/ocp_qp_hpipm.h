@@ -38,6 +38,11 @@ extern "C" {
 
 // hpipm
 #include "hpipm/include/hpipm_d_ocp_qp_ipm.h"
+#include "hpipm/include/hpipm_s_ocp_qp.h"
+#include "hpipm/include/hpipm_s_ocp_qp_dim.h"
+#include "hpipm/include/hpipm_s_ocp_qp_ipm.h"
+#include "hpipm/include/hpipm_s_ocp_qp_seed.h"
+#include "hpipm/include/hpipm_s_ocp_qp_sol.h"
 // acados
 #include "acados/ocp_qp/ocp_qp_common.h"
 #include "acados/utils/types.h"
@@ -49,6 +54,11 @@ typedef struct ocp_qp_hpipm_opts_
 {
     struct d_ocp_qp_ipm_arg *hpipm_opts;
     int print_level;
+    // solve in single precision and refine the solution on the double precision residual;
+    // NOTE: has to be set before the memory is created
+    int mixed_precision;
+    int refine_iter_max;  // max number of iterative refinement steps in mixed precision mode
+    struct s_ocp_qp_ipm_arg *sp_arg;  // arguments of the single precision IPM
 } ocp_qp_hpipm_opts;
 
 
@@ -61,6 +71,18 @@ typedef struct ocp_qp_hpipm_memory_
     int iter;
     int status;
 
+    // mixed precision
+    struct s_ocp_qp_dim *sp_dim;
+    struct s_ocp_qp *sp_qp;
+    struct s_ocp_qp_sol *sp_sol;
+    struct s_ocp_qp_sol *sp_step;
+    struct s_ocp_qp_seed *sp_seed;
+    struct s_ocp_qp_ipm_ws *sp_workspace;
+    ocp_qp_res *res;
+    ocp_qp_res_ws *res_ws;
+    int refine_iter;
+    int refine_fallback;  // 1 if the refined solution was polished by the double precision IPM
+
 } ocp_qp_hpipm_memory;
 
 
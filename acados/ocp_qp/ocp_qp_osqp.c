@@ -851,6 +851,88 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
 
 
 
+// sparsity pattern of a CSC matrix with dense blocks: keeps the entries that are nonzero now,
+// the diagonal (if keep_diag) and all entries kept before, i.e. the pattern only grows
+static c_int update_csc_sparsity(c_int n, const c_float *x, const c_int *i, const c_int *p, int keep_diag,
+                                 char *keep, c_int *map, c_int *i_sp, c_int *p_sp)
+{
+    c_int nn = 0;
+    for (c_int col = 0; col < n; col++)
+    {
+        p_sp[col] = nn;
+        for (c_int kk = p[col]; kk < p[col + 1]; kk++)
+        {
+            if (x[kk] != 0.0 || (keep_diag && i[kk] == col))
+                keep[kk] = 1;
+
+            if (keep[kk])
+            {
+                map[nn] = kk;
+                i_sp[nn] = i[kk];
+                nn++;
+            }
+        }
+    }
+    p_sp[n] = nn;
+
+    return nn;
+}
+
+
+
+// gathers the entries in the sparsity pattern, returns 1 if an entry outside of it is nonzero
+static int gather_csc_data(c_int nnz_dense, const c_float *x, const char *keep,
+                           c_int nnz, const c_int *map, c_float *x_sp)
+{
+    for (c_int kk = 0; kk < nnz; kk++)
+        x_sp[kk] = x[map[kk]];
+
+    for (c_int kk = 0; kk < nnz_dense; kk++)
+    {
+        if (!keep[kk] && x[kk] != 0.0)
+            return 1;
+    }
+
+    return 0;
+}
+
+
+
+static void update_sparsity(ocp_qp_osqp_memory *mem)
+{
+    c_int n = mem->osqp_data->n;
+
+    mem->P_nnz = update_csc_sparsity(n, mem->P_x, mem->P_i, mem->P_p, 1, mem->P_keep,
+                                     mem->P_map, mem->P_sp_i, mem->P_sp_p);
+    mem->A_nnz = update_csc_sparsity(n, mem->A_x, mem->A_i, mem->A_p, 0, mem->A_keep,
+                                     mem->A_map, mem->A_sp_i, mem->A_sp_p);
+
+    mem->osqp_data->P->nzmax = mem->P_nnz;
+    mem->osqp_data->A->nzmax = mem->A_nnz;
+}
+
+
+
+static void update_sparse_data(ocp_qp_osqp_memory *mem)
+{
+    c_int n = mem->osqp_data->n;
+
+    int changed = gather_csc_data(mem->P_p[n], mem->P_x, mem->P_keep, mem->P_nnz, mem->P_map, mem->P_sp_x);
+    changed |= gather_csc_data(mem->A_p[n], mem->A_x, mem->A_keep, mem->A_nnz, mem->A_map, mem->A_sp_x);
+
+    if (changed)
+    {
+        // extend the pattern, OSQP is set up again with the new structure
+        update_sparsity(mem);
+        gather_csc_data(mem->P_p[n], mem->P_x, mem->P_keep, mem->P_nnz, mem->P_map, mem->P_sp_x);
+        gather_csc_data(mem->A_p[n], mem->A_x, mem->A_keep, mem->A_nnz, mem->A_map, mem->A_sp_x);
+        if (!mem->first_run)
+            mem->structure_changed = 1;
+    }
+}
+
+
+
 static void update_bounds(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
 {
     ocp_qp_dims *dims = in->dim;
@@ -944,6 +1026,25 @@ static void ocp_qp_osqp_update_memory(const ocp_qp_in *in, const ocp_qp_osqp_opt
     update_hessian_data(in, mem);
     update_constraints_matrix_data(in, mem);
 
+    if (mem->skip_unchanged)
+    {
+        c_int n = mem->osqp_data->n;
+        int P_changed = track_changes(mem->P_p[n], mem->P_x, mem->P_x_prev);
+        int A_changed = track_changes(mem->A_p[n], mem->A_x, mem->A_x_prev);
+        mem->matrices_changed = mem->first_run || P_changed || A_changed;
+    }
+    else
+    {
+        mem->matrices_changed = 1;
+    }
+
+    if (mem->sparsity_detection && mem->matrices_changed)
+    {
+        if (mem->first_run)
+            update_sparsity(mem);
+        update_sparse_data(mem);
+    }
+
     //printf("\nP\n");
     //print_csc_as_dns(mem->osqp_data->P);
     //printf("\nA\n");
@@ -996,6 +1097,9 @@ void ocp_qp_osqp_opts_initialize_default(void *config_, void *dims_, void *opts_
     opts->osqp_opts->check_termination = 5;
     opts->osqp_opts->warm_start = 1;
 
+    opts->sparsity_detection = 0;
+    opts->skip_unchanged = 0;
+
     return;
 }
 
@@ -1060,6 +1164,18 @@ void ocp_qp_osqp_opts_set(void *config_, void *opts_, const char *field, void *v
         opts->osqp_opts->warm_start = *tmp_ptr;
         // printf("\nwarm start %d\n", opts->osqp_opts->warm_start);
     }
+    else if (!strcmp(field, "sparsity_detection"))
+    {
+        // NOTE: has to be set before the memory is created
+        int *tmp_ptr = value;
+        opts->sparsity_detection = *tmp_ptr;
+    }
+    else if (!strcmp(field, "skip_unchanged"))
+    {
+        // NOTE: has to be set before the memory is created
+        int *tmp_ptr = value;
+        opts->skip_unchanged = *tmp_ptr;
+    }
     else
     {
         printf("\nerror: ocp_qp_osqp_opts_set: wrong field: %s\n", field);
@@ -1159,6 +1275,7 @@ static acados_size_t osqp_workspace_calculate_size(int n, int m, int P_nnzmax, i
 acados_size_t ocp_qp_osqp_memory_calculate_size(void *config_, void *dims_, void *opts_)
 {
     ocp_qp_dims *dims = dims_;
+    ocp_qp_osqp_opts *opts = opts_;
 
     size_t n = acados_osqp_num_vars(dims);
     size_t m = acados_osqp_num_constr(dims);
@@ -1180,6 +1297,21 @@ acados_size_t ocp_qp_osqp_memory_calculate_size(void *config_, void *dims_, void
     size += A_nnzmax * sizeof(c_int);    // A_i
     size += (n + 1) * sizeof(c_int);     // A_p
 
+    if (opts->sparsity_detection)
+    {
+        size += (P_nnzmax + A_nnzmax) * sizeof(c_float);     // P_sp_x, A_sp_x
+        size += 2 * (P_nnzmax + A_nnzmax) * sizeof(c_int);   // P_map, P_sp_i, A_map, A_sp_i
+        size += 2 * (n + 1) * sizeof(c_int);                 // P_sp_p, A_sp_p
+        size += (P_nnzmax + A_nnzmax) * sizeof(char);        // P_keep, A_keep
+        size += 2 * 8;                                       // align doubles, align after chars
+    }
+
+    if (opts->skip_unchanged)
+    {
+        size += (P_nnzmax + A_nnzmax) * sizeof(c_float);     // P_x_prev, A_x_prev
+        size += 8;
+    }
+
     size += sizeof(OSQPData);
     size += 2 * sizeof(csc);  // matrices P and A
     size += osqp_workspace_calculate_size(n, m, P_nnzmax, A_nnzmax);
@@ -1476,9 +1608,8 @@ static int osqp_init_data(OSQPData *data, OSQPSettings *settings, OSQPWorkspace
 
 void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *raw_memory)
 {
-    UNUSED(opts_);
-
     ocp_qp_dims *dims = dims_;
+    ocp_qp_osqp_opts *opts = opts_;
     ocp_qp_osqp_memory *mem;
 
     int n = acados_osqp_num_vars(dims);
@@ -1527,6 +1658,68 @@ void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
     mem->A_p = (c_int *) c_ptr;
     c_ptr += (n + 1) * sizeof(c_int);
 
+    mem->skip_unchanged = opts->skip_unchanged;
+    mem->matrices_changed = 1;
+    if (mem->skip_unchanged)
+    {
+        align_char_to(8, &c_ptr);
+
+        mem->P_x_prev = (c_float *) c_ptr;
+        c_ptr += P_nnzmax * sizeof(c_float);
+
+        mem->A_x_prev = (c_float *) c_ptr;
+        c_ptr += A_nnzmax * sizeof(c_float);
+    }
+
+    mem->sparsity_detection = opts->sparsity_detection;
+    mem->structure_changed = 0;
+    mem->P_nnz = 0;
+    mem->A_nnz = 0;
+    if (mem->sparsity_detection)
+    {
+        align_char_to(8, &c_ptr);
+
+        // doubles
+        mem->P_sp_x = (c_float *) c_ptr;
+        c_ptr += P_nnzmax * sizeof(c_float);
+
+        mem->A_sp_x = (c_float *) c_ptr;
+        c_ptr += A_nnzmax * sizeof(c_float);
+
+        // ints
+        mem->P_map = (c_int *) c_ptr;
+        c_ptr += P_nnzmax * sizeof(c_int);
+
+        mem->P_sp_i = (c_int *) c_ptr;
+        c_ptr += P_nnzmax * sizeof(c_int);
+
+        mem->P_sp_p = (c_int *) c_ptr;
+        c_ptr += (n + 1) * sizeof(c_int);
+
+        mem->A_map = (c_int *) c_ptr;
+        c_ptr += A_nnzmax * sizeof(c_int);
+
+        mem->A_sp_i = (c_int *) c_ptr;
+        c_ptr += A_nnzmax * sizeof(c_int);
+
+        mem->A_sp_p = (c_int *) c_ptr;
+        c_ptr += (n + 1) * sizeof(c_int);
+
+        // chars
+        mem->P_keep = c_ptr;
+        c_ptr += P_nnzmax * sizeof(char);
+
+        mem->A_keep = c_ptr;
+        c_ptr += A_nnzmax * sizeof(char);
+
+        for (int ii = 0; ii < P_nnzmax; ii++)
+            mem->P_keep[ii] = 0;
+        for (int ii = 0; ii < A_nnzmax; ii++)
+            mem->A_keep[ii] = 0;
+
+        align_char_to(8, &c_ptr);
+    }
+
     mem->osqp_data = (OSQPData *) c_ptr;
     c_ptr += sizeof(OSQPData);
 
@@ -1550,8 +1743,17 @@ void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
     data->l = mem->l;
     data->u = mem->u;
 
-    init_csc_matrix(n, n, P_nnzmax, mem->P_x, mem->P_i, mem->P_p, data->P);
-    init_csc_matrix(m, n, A_nnzmax, mem->A_x, mem->A_i, mem->A_p, data->A);
+    if (mem->sparsity_detection)
+    {
+        // nzmax is set once the pattern is detected
+        init_csc_matrix(n, n, 0, mem->P_sp_x, mem->P_sp_i, mem->P_sp_p, data->P);
+        init_csc_matrix(m, n, 0, mem->A_sp_x, mem->A_sp_i, mem->A_sp_p, data->A);
+    }
+    else
+    {
+        init_csc_matrix(n, n, P_nnzmax, mem->P_x, mem->P_i, mem->P_p, data->P);
+        init_csc_matrix(m, n, A_nnzmax, mem->A_x, mem->A_i, mem->A_p, data->A);
+    }
 
     assert((char *) raw_memory + ocp_qp_osqp_memory_calculate_size(config_, dims, opts_) >= c_ptr);
 
@@ -1580,6 +1782,21 @@ void ocp_qp_osqp_memory_get(void *config_, void *mem_, const char *field, void*
         int *tmp_ptr = value;
         *tmp_ptr = mem->status;
     }
+    else if (!strcmp(field, "matrices_changed"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->matrices_changed;
+    }
+    else if (!strcmp(field, "P_nnz"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->sparsity_detection ? mem->P_nnz : mem->osqp_data->P->p[mem->osqp_data->n];
+    }
+    else if (!strcmp(field, "A_nnz"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->sparsity_detection ? mem->A_nnz : mem->osqp_data->A->p[mem->osqp_data->n];
+    }
     else
     {
         printf("\nerror: ocp_qp_osqp_memory_get: field %s not available\n", field);
@@ -1731,16 +1948,24 @@ int ocp_qp_osqp(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *m
     acados_tic(&qp_timer);
 
     // update osqp workspace with new data
-    if (!mem->first_run)
+    if (!mem->first_run && !mem->structure_changed)
     {
+        csc *P = mem->osqp_data->P;
+        csc *A = mem->osqp_data->A;
         osqp_update_lin_cost(mem->osqp_work, mem->q);
-        osqp_update_P_A(mem->osqp_work, mem->P_x, NULL, mem->P_nnzmax, mem->A_x, NULL,
-                        mem->A_nnzmax);
+        if (mem->matrices_changed)
+            osqp_update_P_A(mem->osqp_work, P->x, NULL, P->nzmax, A->x, NULL, A->nzmax);
         osqp_update_bounds(mem->osqp_work, mem->l, mem->u);
         cpy_osqp_settings(opts->osqp_opts, mem->osqp_work->settings);
     }
     else
     {
+        if (mem->structure_changed)
+        {
+            // sparsity pattern was extended, the KKT structure changes
+            mem->osqp_work->linsys_solver->free(mem->osqp_work->linsys_solver);
+            mem->structure_changed = 0;
+        }
         // mem->osqp_work = osqp_setup(mem->osqp_data, opts->osqp_opts);
         osqp_init_data(mem->osqp_data, opts->osqp_opts, mem->osqp_work);
         mem->first_run = 0;
@@ -46,6 +46,8 @@ extern "C" {
 typedef struct ocp_qp_osqp_opts_
 {
     OSQPSettings *osqp_opts;
+    int sparsity_detection;  // pass only the nonzeros of P and A to OSQP
+    int skip_unchanged;      // no update (and refactorization) of P and A if they did not change
 } ocp_qp_osqp_opts;
 
 
@@ -67,6 +69,28 @@ typedef struct ocp_qp_osqp_memory_
     c_int *A_p;
     c_float *A_x;
 
+    // sparsity detection: P_*, A_* above hold the dense blocks, OSQP gets the compact matrices
+    int sparsity_detection;
+    int structure_changed;  // a structural zero became nonzero, OSQP has to be set up again
+    c_int P_nnz;
+    char *P_keep;       // entry of the dense P is in the sparsity pattern
+    c_int *P_map;       // position in the dense P of the compact entries
+    c_int *P_sp_i;
+    c_int *P_sp_p;
+    c_float *P_sp_x;
+    c_int A_nnz;
+    char *A_keep;
+    c_int *A_map;
+    c_int *A_sp_i;
+    c_int *A_sp_p;
+    c_float *A_sp_x;
+
+    // change tracking: values of P and A passed to OSQP in the last solve
+    int skip_unchanged;
+    int matrices_changed;
+    c_float *P_x_prev;
+    c_float *A_x_prev;
+
     OSQPData *osqp_data;
     OSQPWorkspace *osqp_work;
 
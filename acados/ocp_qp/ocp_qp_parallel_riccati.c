@@ -0,0 +1,1428 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+// external
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+// blasfeo
+#include "blasfeo_d_aux.h"
+#include "blasfeo_d_blas.h"
+// acados
+#include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/ocp_qp/ocp_qp_parallel_riccati.h"
+#include "acados/utils/math.h"
+#include "acados/utils/mem.h"
+#include "acados/utils/timing.h"
+#include "acados/utils/types.h"
+
+
+
+static int max_nx(ocp_qp_dims *dims)
+{
+    int nxM = 0;
+    for (int ii = 0; ii <= dims->N; ii++)
+        nxM = MAX(nxM, dims->nx[ii]);
+    return nxM;
+}
+
+
+
+/************************************************
+ * opts
+ ************************************************/
+
+acados_size_t ocp_qp_parallel_riccati_opts_calculate_size(void *config_, void *dims_)
+{
+    acados_size_t size = 0;
+    size += sizeof(ocp_qp_parallel_riccati_opts);
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+void *ocp_qp_parallel_riccati_opts_assign(void *config_, void *dims_, void *raw_memory)
+{
+    char *c_ptr = (char *) raw_memory;
+
+    ocp_qp_parallel_riccati_opts *opts = (ocp_qp_parallel_riccati_opts *) c_ptr;
+    c_ptr += sizeof(ocp_qp_parallel_riccati_opts);
+
+    assert((char *) raw_memory + ocp_qp_parallel_riccati_opts_calculate_size(config_, dims_) >= c_ptr);
+
+    return (void *) opts;
+}
+
+
+
+void ocp_qp_parallel_riccati_opts_initialize_default(void *config_, void *dims_, void *opts_)
+{
+    ocp_qp_parallel_riccati_opts *opts = opts_;
+
+    opts->tol_stat = 1e-8;
+    opts->tol_eq = 1e-8;
+    opts->tol_ineq = 1e-8;
+    opts->tol_comp = 1e-8;
+    opts->mu0 = 1e1;
+    opts->reg_prim = 1e-12;
+    opts->iter_max = 100;
+    opts->num_segments = 1;
+    opts->warm_start = 0;
+    opts->print_level = 0;
+
+    return;
+}
+
+
+
+void ocp_qp_parallel_riccati_opts_update(void *config_, void *dims_, void *opts_)
+{
+    return;
+}
+
+
+
+void ocp_qp_parallel_riccati_opts_set(void *config_, void *opts_, const char *field, void *value)
+{
+    ocp_qp_parallel_riccati_opts *opts = opts_;
+
+    if (!strcmp(field, "iter_max"))
+    {
+        int *tmp_ptr = value;
+        opts->iter_max = *tmp_ptr;
+    }
+    else if (!strcmp(field, "tol_stat"))
+    {
+        double *tmp_ptr = value;
+        opts->tol_stat = *tmp_ptr;
+    }
+    else if (!strcmp(field, "tol_eq"))
+    {
+        double *tmp_ptr = value;
+        opts->tol_eq = *tmp_ptr;
+    }
+    else if (!strcmp(field, "tol_ineq"))
+    {
+        double *tmp_ptr = value;
+        opts->tol_ineq = *tmp_ptr;
+    }
+    else if (!strcmp(field, "tol_comp"))
+    {
+        double *tmp_ptr = value;
+        opts->tol_comp = *tmp_ptr;
+    }
+    else if (!strcmp(field, "mu0"))
+    {
+        double *tmp_ptr = value;
+        opts->mu0 = *tmp_ptr;
+    }
+    else if (!strcmp(field, "reg_prim"))
+    {
+        double *tmp_ptr = value;
+        opts->reg_prim = *tmp_ptr;
+    }
+    else if (!strcmp(field, "num_segments"))
+    {
+        int *tmp_ptr = value;
+        if (*tmp_ptr < 1)
+        {
+            printf("\nerror: ocp_qp_parallel_riccati_opts_set: num_segments must be >= 1, got %d\n", *tmp_ptr);
+            exit(1);
+        }
+        opts->num_segments = *tmp_ptr;
+    }
+    else if (!strcmp(field, "warm_start"))
+    {
+        int *tmp_ptr = value;
+        opts->warm_start = *tmp_ptr;
+    }
+    else if (!strcmp(field, "print_level"))
+    {
+        int *tmp_ptr = value;
+        opts->print_level = *tmp_ptr;
+    }
+    else
+    {
+        printf("\nerror: ocp_qp_parallel_riccati_opts_set: wrong field: %s\n", field);
+        exit(1);
+    }
+
+    return;
+}
+
+
+
+void ocp_qp_parallel_riccati_opts_get(void *config_, void *opts_, const char *field, void *value)
+{
+    ocp_qp_parallel_riccati_opts *opts = opts_;
+
+    if (!strcmp(field, "iter_max"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = opts->iter_max;
+    }
+    else if (!strcmp(field, "num_segments"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = opts->num_segments;
+    }
+    else if (!strcmp(field, "warm_start"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = opts->warm_start;
+    }
+    else
+    {
+        printf("\nerror: ocp_qp_parallel_riccati_opts_get: not implemented for field %s\n", field);
+        exit(1);
+    }
+
+    return;
+}
+
+
+
+/************************************************
+ * memory
+ ************************************************/
+
+acados_size_t ocp_qp_parallel_riccati_memory_calculate_size(void *config_, void *dims_, void *opts_)
+{
+    acados_size_t size = 0;
+    size += sizeof(ocp_qp_parallel_riccati_memory);
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+void *ocp_qp_parallel_riccati_memory_assign(void *config_, void *dims_, void *opts_, void *raw_memory)
+{
+    char *c_ptr = (char *) raw_memory;
+
+    ocp_qp_parallel_riccati_memory *mem = (ocp_qp_parallel_riccati_memory *) c_ptr;
+    c_ptr += sizeof(ocp_qp_parallel_riccati_memory);
+
+    mem->time_qp_solver_call = 0.0;
+    for (int ii = 0; ii < 4; ii++)
+        mem->res[ii] = 0.0;
+    mem->num_segments = 0;
+    mem->iter = 0;
+    mem->status = ACADOS_READY;
+
+    assert((char *) raw_memory + ocp_qp_parallel_riccati_memory_calculate_size(config_, dims_, opts_) >= c_ptr);
+
+    return mem;
+}
+
+
+
+void ocp_qp_parallel_riccati_memory_get(void *config_, void *mem_, const char *field, void* value)
+{
+    ocp_qp_parallel_riccati_memory *mem = mem_;
+
+    if (!strcmp(field, "time_qp_solver_call"))
+    {
+        double *tmp_ptr = value;
+        *tmp_ptr = mem->time_qp_solver_call;
+    }
+    else if (!strcmp(field, "iter"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->iter;
+    }
+    else if (!strcmp(field, "status"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->status;
+    }
+    else if (!strcmp(field, "num_segments"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->num_segments;
+    }
+    else if (!strcmp(field, "qp_res"))
+    {
+        double *tmp_ptr = value;
+        for (int ii = 0; ii < 4; ii++)
+            tmp_ptr[ii] = mem->res[ii];
+    }
+    else
+    {
+        printf("\nerror: ocp_qp_parallel_riccati_memory_get: field %s not available\n", field);
+        exit(1);
+    }
+
+    return;
+}
+
+
+
+/************************************************
+ * workspace
+ ************************************************/
+
+acados_size_t ocp_qp_parallel_riccati_workspace_calculate_size(void *config_, void *dims_, void *opts_)
+{
+    ocp_qp_dims *dims = dims_;
+
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *nb = dims->nb;
+    int *ng = dims->ng;
+
+    int nxM = max_nx(dims);
+    int num_seg = N > 0 ? N : 1;  // max number of segments
+
+    acados_size_t size = 0;
+    size += sizeof(ocp_qp_parallel_riccati_workspace);
+
+    size += 15 * (N + 1) * sizeof(struct blasfeo_dvec);  // ux lam t dux dlam dt res_g res_d res_m gamma w tmp_nc l lin yu
+    size += 4 * N * sizeof(struct blasfeo_dvec);          // pi dpi res_b tmp_nx
+    size += 3 * (N + 1) * sizeof(struct blasfeo_dmat);    // L VP tmp_nv_ng
+    size += 1 * N * sizeof(struct blasfeo_dmat);          // tmp_nv_nx
+    size += 4 * num_seg * sizeof(struct blasfeo_dmat);    // VPe Pbar T Y
+    size += 5 * num_seg * sizeof(struct blasfeo_dvec);    // le qbar v lam_seg tmp_seg
+    size += num_seg * sizeof(int *);                      // ipiv
+
+    size += ocp_qp_res_calculate_size(dims);
+    size += ocp_qp_res_workspace_calculate_size(dims);
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nv = nu[ii] + nx[ii];
+        int nc = nb[ii] + ng[ii];
+        size += 4 * blasfeo_memsize_dvec(nv);          // ux dux res_g gamma
+        size += 7 * blasfeo_memsize_dvec(2 * nc);      // lam t dlam dt res_d res_m w
+        size += 1 * blasfeo_memsize_dvec(2 * nc);      // tmp_nc
+        size += 1 * blasfeo_memsize_dvec(nx[ii] + nxM);  // l
+        size += 1 * blasfeo_memsize_dvec(nv + nxM);    // lin
+        size += 1 * blasfeo_memsize_dvec(nu[ii]);      // yu
+        size += blasfeo_memsize_dmat(nv + nxM, nv + nxM);          // L
+        size += blasfeo_memsize_dmat(nx[ii] + nxM, nx[ii] + nxM);  // VP
+        size += blasfeo_memsize_dmat(nv, ng[ii]);                  // tmp_nv_ng
+    }
+    for (int ii = 0; ii < N; ii++)
+    {
+        size += 4 * blasfeo_memsize_dvec(nx[ii + 1]);  // pi dpi res_b tmp_nx
+        size += blasfeo_memsize_dmat(nu[ii] + nx[ii], nx[ii + 1]);  // tmp_nv_nx
+    }
+    size += num_seg * blasfeo_memsize_dmat(2 * nxM, 2 * nxM);  // VPe
+    size += 3 * num_seg * blasfeo_memsize_dmat(nxM, nxM);      // Pbar T Y
+    size += 2 * blasfeo_memsize_dmat(nxM, nxM);                // Lbar tmp_mat
+    size += num_seg * blasfeo_memsize_dvec(2 * nxM);           // le
+    size += 4 * num_seg * blasfeo_memsize_dvec(nxM);           // qbar v lam_seg tmp_seg
+
+    size += num_seg * nxM * sizeof(int);  // ipiv
+    size += (num_seg + 1) * sizeof(int);  // seg_start
+
+    size += 2 * 8;   // struct align
+    size += 1 * 64;  // blasfeo_mem align
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+static ocp_qp_parallel_riccati_workspace *ocp_qp_parallel_riccati_cast_workspace(ocp_qp_dims *dims, void *raw_memory)
+{
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *nb = dims->nb;
+    int *ng = dims->ng;
+
+    int nxM = max_nx(dims);
+    int num_seg = N > 0 ? N : 1;
+
+    char *c_ptr = (char *) raw_memory;
+
+    ocp_qp_parallel_riccati_workspace *work = (ocp_qp_parallel_riccati_workspace *) c_ptr;
+    c_ptr += sizeof(ocp_qp_parallel_riccati_workspace);
+
+    align_char_to(8, &c_ptr);
+
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->ux, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N, &work->pi, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->lam, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->t, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->dux, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N, &work->dpi, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->dlam, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->dt, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->res_g, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N, &work->res_b, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->res_d, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->res_m, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->gamma, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->w, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->tmp_nc, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(N + 1, &work->L, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(N + 1, &work->VP, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->l, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->lin, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->yu, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(N, &work->tmp_nv_nx, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(N + 1, &work->tmp_nv_ng, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N, &work->tmp_nx, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(num_seg, &work->VPe, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(num_seg, &work->le, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(num_seg, &work->Pbar, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(num_seg, &work->T, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(num_seg, &work->Y, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(num_seg, &work->qbar, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(num_seg, &work->v, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(num_seg, &work->lam_seg, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(num_seg, &work->tmp_seg, &c_ptr);
+    assign_and_advance_int_ptrs(num_seg, &work->ipiv, &c_ptr);
+
+    align_char_to(8, &c_ptr);
+
+    work->qp_res = ocp_qp_res_assign(dims, c_ptr);
+    c_ptr += ocp_qp_res_calculate_size(dims);
+
+    work->qp_res_ws = ocp_qp_res_workspace_assign(dims, c_ptr);
+    c_ptr += ocp_qp_res_workspace_calculate_size(dims);
+
+    // blasfeo_mem align
+    align_char_to(64, &c_ptr);
+
+    // matrices
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nv = nu[ii] + nx[ii];
+        assign_and_advance_blasfeo_dmat_mem(nv + nxM, nv + nxM, work->L + ii, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nx[ii] + nxM, nx[ii] + nxM, work->VP + ii, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nv, ng[ii], work->tmp_nv_ng + ii, &c_ptr);
+    }
+    for (int ii = 0; ii < N; ii++)
+    {
+        assign_and_advance_blasfeo_dmat_mem(nu[ii] + nx[ii], nx[ii + 1], work->tmp_nv_nx + ii, &c_ptr);
+    }
+    for (int ss = 0; ss < num_seg; ss++)
+    {
+        assign_and_advance_blasfeo_dmat_mem(2 * nxM, 2 * nxM, work->VPe + ss, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nxM, nxM, work->Pbar + ss, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nxM, nxM, work->T + ss, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nxM, nxM, work->Y + ss, &c_ptr);
+    }
+    assign_and_advance_blasfeo_dmat_mem(nxM, nxM, &work->Lbar, &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(nxM, nxM, &work->tmp_mat, &c_ptr);
+
+    // vectors
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nv = nu[ii] + nx[ii];
+        int nc = nb[ii] + ng[ii];
+        assign_and_advance_blasfeo_dvec_mem(nv, work->ux + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nv, work->dux + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nv, work->res_g + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nv, work->gamma + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(2 * nc, work->lam + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(2 * nc, work->t + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(2 * nc, work->dlam + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(2 * nc, work->dt + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(2 * nc, work->res_d + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(2 * nc, work->res_m + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(2 * nc, work->w + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(2 * nc, work->tmp_nc + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nx[ii] + nxM, work->l + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nv + nxM, work->lin + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nu[ii], work->yu + ii, &c_ptr);
+    }
+    for (int ii = 0; ii < N; ii++)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nx[ii + 1], work->pi + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nx[ii + 1], work->dpi + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nx[ii + 1], work->res_b + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nx[ii + 1], work->tmp_nx + ii, &c_ptr);
+    }
+    for (int ss = 0; ss < num_seg; ss++)
+    {
+        assign_and_advance_blasfeo_dvec_mem(2 * nxM, work->le + ss, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nxM, work->qbar + ss, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nxM, work->v + ss, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nxM, work->lam_seg + ss, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nxM, work->tmp_seg + ss, &c_ptr);
+    }
+
+    // integers
+    align_char_to(8, &c_ptr);
+    for (int ss = 0; ss < num_seg; ss++)
+        assign_and_advance_int(nxM, work->ipiv + ss, &c_ptr);
+    assign_and_advance_int(num_seg + 1, &work->seg_start, &c_ptr);
+
+    assert((char *) raw_memory + ocp_qp_parallel_riccati_workspace_calculate_size(NULL, dims, NULL) >= c_ptr);
+
+    return work;
+}
+
+
+
+/************************************************
+ * interior point residuals and Newton system
+ ************************************************/
+
+// res_g = RSQ ux + rq + BAbt pi_k - pi_{k-1} + C' (lam_u - lam_l)
+// res_b = BAt' ux + b - x_{k+1}
+// res_d = [C ux - d_l; - C ux - d_u] - t, zero for the constraints not in d_mask
+static void stage_residuals(const ocp_qp_in *qp_in, ocp_qp_parallel_riccati_workspace *work, int ii)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    int nv = nu[ii] + nx[ii];
+    int nc = nb[ii] + ng[ii];
+
+    struct blasfeo_dvec *ux = work->ux + ii;
+    struct blasfeo_dvec *lam = work->lam + ii;
+    struct blasfeo_dvec *res_g = work->res_g + ii;
+    struct blasfeo_dvec *res_d = work->res_d + ii;
+    struct blasfeo_dvec *tmp_nc = work->tmp_nc + ii;
+
+    blasfeo_dsymv_l(nv, 1.0, qp_in->RSQrq + ii, 0, 0, ux, 0, 1.0, qp_in->rqz + ii, 0, res_g, 0);
+    if (ii < N)
+        blasfeo_dgemv_n(nv, nx[ii + 1], 1.0, qp_in->BAbt + ii, 0, 0, work->pi + ii, 0,
+                        1.0, res_g, 0, res_g, 0);
+    if (ii > 0)
+        blasfeo_daxpy(nx[ii], -1.0, work->pi + ii - 1, 0, res_g, nu[ii], res_g, nu[ii]);
+
+    if (nc > 0)
+    {
+        // tmp_nc = lam_u - lam_l
+        blasfeo_daxpy(nc, -1.0, lam, 0, lam, nc, tmp_nc, 0);
+        blasfeo_dvecad_sp(nb[ii], 1.0, tmp_nc, 0, qp_in->idxb[ii], res_g, 0);
+        blasfeo_dgemv_n(nv, ng[ii], 1.0, qp_in->DCt + ii, 0, 0, tmp_nc, nb[ii], 1.0, res_g, 0, res_g, 0);
+
+        // tmp_nc = C ux
+        blasfeo_dvecex_sp(nb[ii], 1.0, qp_in->idxb[ii], ux, 0, tmp_nc, 0);
+        blasfeo_dgemv_t(nv, ng[ii], 1.0, qp_in->DCt + ii, 0, 0, ux, 0, 0.0, tmp_nc, nb[ii], tmp_nc, nb[ii]);
+
+        blasfeo_daxpy(nc, -1.0, qp_in->d + ii, 0, tmp_nc, 0, res_d, 0);
+        blasfeo_daxpby(nc, -1.0, tmp_nc, 0, -1.0, qp_in->d + ii, nc, res_d, nc);
+        blasfeo_daxpy(2 * nc, -1.0, work->t + ii, 0, res_d, 0, res_d, 0);
+        blasfeo_dvecmul(2 * nc, qp_in->d_mask + ii, 0, res_d, 0, res_d, 0);
+    }
+
+    if (ii < N)
+    {
+        blasfeo_dgemv_t(nv, nx[ii + 1], 1.0, qp_in->BAbt + ii, 0, 0, ux, 0, 1.0, qp_in->b + ii, 0,
+                        work->res_b + ii, 0);
+        blasfeo_daxpy(nx[ii + 1], -1.0, work->ux + ii + 1, nu[ii + 1], work->res_b + ii, 0,
+                      work->res_b + ii, 0);
+    }
+}
+
+
+
+// computes the residuals and returns the duality measure mu
+static double compute_residuals(const ocp_qp_in *qp_in, ocp_qp_parallel_riccati_workspace *work,
+                                int num_active, int num_seg, double res[4])
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(num_seg)
+#endif
+    for (int ii = 0; ii <= N; ii++)
+        stage_residuals(qp_in, work, ii);
+
+    double tmp, sum_comp = 0.0;
+    for (int jj = 0; jj < 4; jj++)
+        res[jj] = 0.0;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nc = nb[ii] + ng[ii];
+
+        blasfeo_dvecnrm_inf(nu[ii] + nx[ii], work->res_g + ii, 0, &tmp);
+        res[0] = MAX(res[0], tmp);
+        if (ii < N)
+        {
+            blasfeo_dvecnrm_inf(nx[ii + 1], work->res_b + ii, 0, &tmp);
+            res[1] = MAX(res[1], tmp);
+        }
+        if (nc > 0)
+        {
+            blasfeo_dvecnrm_inf(2 * nc, work->res_d + ii, 0, &tmp);
+            res[2] = MAX(res[2], tmp);
+        }
+        // lam is zero for the constraints not in d_mask
+        for (int jj = 0; jj < 2 * nc; jj++)
+        {
+            tmp = BLASFEO_DVECEL(work->lam + ii, jj) * BLASFEO_DVECEL(work->t + ii, jj);
+            res[3] = MAX(res[3], tmp);
+            sum_comp += tmp;
+        }
+    }
+
+    return num_active > 0 ? sum_comp / num_active : 0.0;
+}
+
+
+
+// res_m = lam t + dlam dt - sigma_mu on the constraints in d_mask, with the step dlam, dt
+// (Mehrotra correction) only if use_step
+static void compute_res_m(const ocp_qp_in *qp_in, ocp_qp_parallel_riccati_workspace *work,
+                          double sigma_mu, int use_step)
+{
+    int N = qp_in->dim->N;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nc = nb[ii] + ng[ii];
+        for (int jj = 0; jj < 2 * nc; jj++)
+        {
+            double tmp = BLASFEO_DVECEL(work->lam + ii, jj) * BLASFEO_DVECEL(work->t + ii, jj);
+            if (use_step)
+                tmp += BLASFEO_DVECEL(work->dlam + ii, jj) * BLASFEO_DVECEL(work->dt + ii, jj);
+            BLASFEO_DVECEL(work->res_m + ii, jj) =
+                BLASFEO_DVECEL(qp_in->d_mask + ii, jj) * (tmp - sigma_mu);
+        }
+    }
+}
+
+
+
+// gradient of the Newton system after eliminating lam and t:
+// gamma = res_g + C' (v_l - v_u), with v = (res_m + lam res_d) / t
+static void stage_newton_gradient(const ocp_qp_in *qp_in, ocp_qp_parallel_riccati_workspace *work, int ii)
+{
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    int nv = nu[ii] + nx[ii];
+    int nc = nb[ii] + ng[ii];
+
+    struct blasfeo_dvec *tmp_nc = work->tmp_nc + ii;
+
+    blasfeo_dveccp(nv, work->res_g + ii, 0, work->gamma + ii, 0);
+
+    if (nc > 0)
+    {
+        for (int jj = 0; jj < 2 * nc; jj++)
+        {
+            BLASFEO_DVECEL(tmp_nc, jj) = (BLASFEO_DVECEL(work->res_m + ii, jj)
+                    + BLASFEO_DVECEL(work->lam + ii, jj) * BLASFEO_DVECEL(work->res_d + ii, jj))
+                    / BLASFEO_DVECEL(work->t + ii, jj);
+        }
+        blasfeo_daxpy(nc, -1.0, tmp_nc, nc, tmp_nc, 0, tmp_nc, 0);
+        blasfeo_dvecad_sp(nb[ii], 1.0, tmp_nc, 0, qp_in->idxb[ii], work->gamma + ii, 0);
+        blasfeo_dgemv_n(nv, ng[ii], 1.0, qp_in->DCt + ii, 0, 0, tmp_nc, nb[ii], 1.0,
+                        work->gamma + ii, 0, work->gamma + ii, 0);
+    }
+}
+
+
+
+// step of slacks and multipliers from the primal step:
+// dt = [C dux; -C dux] + res_d, dlam = -(res_m + lam dt) / t
+static void stage_expand_ineq(const ocp_qp_in *qp_in, ocp_qp_parallel_riccati_workspace *work, int ii)
+{
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    int nv = nu[ii] + nx[ii];
+    int nc = nb[ii] + ng[ii];
+
+    struct blasfeo_dvec *dt = work->dt + ii;
+
+    if (nc == 0)
+        return;
+
+    blasfeo_dvecex_sp(nb[ii], 1.0, qp_in->idxb[ii], work->dux + ii, 0, dt, 0);
+    blasfeo_dgemv_t(nv, ng[ii], 1.0, qp_in->DCt + ii, 0, 0, work->dux + ii, 0, 0.0, dt, nb[ii], dt, nb[ii]);
+    blasfeo_dveccpsc(nc, -1.0, dt, 0, dt, nc);
+    blasfeo_daxpy(2 * nc, 1.0, work->res_d + ii, 0, dt, 0, dt, 0);
+    blasfeo_dvecmul(2 * nc, qp_in->d_mask + ii, 0, dt, 0, dt, 0);
+
+    for (int jj = 0; jj < 2 * nc; jj++)
+    {
+        BLASFEO_DVECEL(work->dlam + ii, jj) = - (BLASFEO_DVECEL(work->res_m + ii, jj)
+                + BLASFEO_DVECEL(work->lam + ii, jj) * BLASFEO_DVECEL(dt, jj))
+                / BLASFEO_DVECEL(work->t + ii, jj);
+    }
+}
+
+
+
+/************************************************
+ * stage-wise Riccati recursion
+ ************************************************/
+
+// The cost-to-go of stage ii is kept as a quadratic function of [x; lam_seg], where lam_seg is the
+// multiplier of the coupling between the end of the segment and the initial state of the next one:
+//   VP = [P, *; Gamma', Omega], l = [p; omega].
+// At the end of a segment it is lam_seg' x, i.e. P = 0, Gamma = I, Omega = 0, l = 0.
+
+// factorization of stage ii, given the cost-to-go VPn of stage ii+1
+static void factorize_stage(const ocp_qp_in *qp_in, const ocp_qp_parallel_riccati_opts *opts,
+                            ocp_qp_parallel_riccati_workspace *work, int ii, int nl,
+                            struct blasfeo_dmat *VPn)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    int nv = nu[ii] + nx[ii];
+    int nc = nb[ii] + ng[ii];
+
+    struct blasfeo_dmat *L = work->L + ii;
+    struct blasfeo_dvec *w = work->w + ii;
+
+    // Hessian of the stage, with barrier terms C' diag(w_l + w_u) C
+    blasfeo_dgecp(nv, nv, qp_in->RSQrq + ii, 0, 0, L, 0, 0);
+    blasfeo_ddiare(nv, opts->reg_prim, L, 0, 0);
+    for (int jj = 0; jj < nb[ii]; jj++)
+    {
+        int idx = qp_in->idxb[ii][jj];
+        BLASFEO_DMATEL(L, idx, idx) += BLASFEO_DVECEL(w, jj) + BLASFEO_DVECEL(w, nc + jj);
+    }
+    if (ng[ii] > 0)
+    {
+        blasfeo_daxpy(ng[ii], 1.0, w, nb[ii], w, nc + nb[ii], work->tmp_nc + ii, 0);
+        blasfeo_dgemm_nd(nv, ng[ii], 1.0, qp_in->DCt + ii, 0, 0, work->tmp_nc + ii, 0, 0.0,
+                         work->tmp_nv_ng + ii, 0, 0, work->tmp_nv_ng + ii, 0, 0);
+        blasfeo_dsyrk_ln(nv, ng[ii], 1.0, work->tmp_nv_ng + ii, 0, 0, qp_in->DCt + ii, 0, 0, 1.0,
+                         L, 0, 0, L, 0, 0);
+    }
+
+    if (ii < N)
+    {
+        int nx1 = nx[ii + 1];
+
+        // [u; x] block: BAt P BAt'
+        blasfeo_dgemm_nn(nv, nx1, nx1, 1.0, qp_in->BAbt + ii, 0, 0, VPn, 0, 0, 0.0,
+                         work->tmp_nv_nx + ii, 0, 0, work->tmp_nv_nx + ii, 0, 0);
+        blasfeo_dsyrk_ln(nv, nx1, 1.0, work->tmp_nv_nx + ii, 0, 0, qp_in->BAbt + ii, 0, 0, 1.0,
+                         L, 0, 0, L, 0, 0);
+
+        // lam_seg block: Gamma' BAt' and Omega
+        if (nl > 0)
+        {
+            blasfeo_dgemm_nt(nl, nv, nx1, 1.0, VPn, nx1, 0, qp_in->BAbt + ii, 0, 0, 0.0,
+                             L, nv, 0, L, nv, 0);
+            blasfeo_dgecp(nl, nl, VPn, nx1, nx1, L, nv, nv);
+        }
+    }
+
+    // eliminate u, the Schur complement is the cost-to-go of stage ii
+    blasfeo_dpotrf_l_mn(nv + nl, nu[ii], L, 0, 0, L, 0, 0);
+    blasfeo_dsyrk_ln(nx[ii] + nl, nu[ii], -1.0, L, nu[ii], 0, L, nu[ii], 0, 1.0, L, nu[ii], nu[ii],
+                     work->VP + ii, 0, 0);
+    blasfeo_dtrtr_l(nx[ii] + nl, work->VP + ii, 0, 0, work->VP + ii, 0, 0);
+}
+
+
+
+// linear term of the cost-to-go of stage ii, given the cost-to-go VPn, ln of stage ii+1
+static void backward_stage(const ocp_qp_in *qp_in, ocp_qp_parallel_riccati_workspace *work, int ii,
+                           int nl, struct blasfeo_dmat *VPn, struct blasfeo_dvec *ln)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+
+    int nv = nu[ii] + nx[ii];
+
+    struct blasfeo_dmat *L = work->L + ii;
+    struct blasfeo_dvec *lin = work->lin + ii;
+
+    stage_newton_gradient(qp_in, work, ii);
+    blasfeo_dveccp(nv, work->gamma + ii, 0, lin, 0);
+
+    if (ii < N)
+    {
+        int nx1 = nx[ii + 1];
+
+        // [u; x] part: gamma + BAt (P b + p)
+        blasfeo_dsymv_l(nx1, 1.0, VPn, 0, 0, work->res_b + ii, 0, 1.0, ln, 0, work->tmp_nx + ii, 0);
+        blasfeo_dgemv_n(nv, nx1, 1.0, qp_in->BAbt + ii, 0, 0, work->tmp_nx + ii, 0, 1.0, lin, 0, lin, 0);
+
+        // lam_seg part: omega + Gamma' b
+        if (nl > 0)
+            blasfeo_dgemv_n(nl, nx1, 1.0, VPn, nx1, 0, work->res_b + ii, 0, 1.0, ln, nx1, lin, nv);
+    }
+
+    blasfeo_dtrsv_lnn(nu[ii], L, 0, 0, lin, 0, work->yu + ii, 0);
+    blasfeo_dgemv_n(nx[ii] + nl, nu[ii], -1.0, L, nu[ii], 0, work->yu + ii, 0, 1.0, lin, nu[ii],
+                    work->l + ii, 0);
+}
+
+
+
+// step in u_k, x_{k+1} and pi_k, given x_k and lam_seg
+static void forward_stage(const ocp_qp_in *qp_in, ocp_qp_parallel_riccati_workspace *work, int ii,
+                          int nl, struct blasfeo_dvec *lam_seg, int segment_end)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+
+    int nv = nu[ii] + nx[ii];
+
+    struct blasfeo_dmat *L = work->L + ii;
+    struct blasfeo_dvec *yu = work->yu + ii;
+    struct blasfeo_dvec *dux = work->dux + ii;
+
+    // du = - L_uu^-T (yu + L_xu' dx + L_lu' lam_seg)
+    blasfeo_dgemv_t(nx[ii], nu[ii], 1.0, L, nu[ii], 0, dux, nu[ii], 1.0, yu, 0, yu, 0);
+    if (nl > 0)
+        blasfeo_dgemv_t(nl, nu[ii], 1.0, L, nv, 0, lam_seg, 0, 1.0, yu, 0, yu, 0);
+    blasfeo_dtrsv_ltn(nu[ii], L, 0, 0, yu, 0, yu, 0);
+    blasfeo_dveccpsc(nu[ii], -1.0, yu, 0, dux, 0);
+
+    if (ii < N)
+    {
+        int nx1 = nx[ii + 1];
+
+        if (segment_end)
+        {
+            // the next state is the initial state of the next segment, from the reduced system
+            blasfeo_dveccp(nx1, lam_seg, 0, work->dpi + ii, 0);
+        }
+        else
+        {
+            blasfeo_dgemv_t(nv, nx1, 1.0, qp_in->BAbt + ii, 0, 0, dux, 0, 1.0, work->res_b + ii, 0,
+                            work->dux + ii + 1, nu[ii + 1]);
+            // dpi = P dx + p + Gamma lam_seg
+            blasfeo_dsymv_l(nx1, 1.0, work->VP + ii + 1, 0, 0, work->dux + ii + 1, nu[ii + 1], 1.0,
+                            work->l + ii + 1, 0, work->dpi + ii, 0);
+            if (nl > 0)
+                blasfeo_dgemv_t(nl, nx1, 1.0, work->VP + ii + 1, nx1, 0, lam_seg, 0, 1.0,
+                                work->dpi + ii, 0, work->dpi + ii, 0);
+        }
+    }
+}
+
+
+
+/************************************************
+ * segment-wise recursion and reduced system
+ ************************************************/
+
+static void factorize_segment(const ocp_qp_in *qp_in, const ocp_qp_parallel_riccati_opts *opts,
+                              ocp_qp_parallel_riccati_workspace *work, int ss, int num_seg)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+
+    int k0 = work->seg_start[ss];
+    int k1 = work->seg_start[ss + 1];
+    int nl, k_last;
+    struct blasfeo_dmat *VPn;
+
+    if (ss == num_seg - 1)
+    {
+        nl = 0;
+        factorize_stage(qp_in, opts, work, N, 0, NULL);
+        VPn = work->VP + N;
+        k_last = N - 1;
+    }
+    else
+    {
+        nl = nx[k1];
+        blasfeo_dgese(2 * nl, 2 * nl, 0.0, work->VPe + ss, 0, 0);
+        blasfeo_ddiare(nl, 1.0, work->VPe + ss, nl, 0);
+        VPn = work->VPe + ss;
+        k_last = k1 - 1;
+    }
+
+    for (int ii = k_last; ii >= k0; ii--)
+    {
+        factorize_stage(qp_in, opts, work, ii, nl, VPn);
+        VPn = work->VP + ii;
+    }
+}
+
+
+
+static void backward_segment(const ocp_qp_in *qp_in, ocp_qp_parallel_riccati_workspace *work,
+                             int ss, int num_seg)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+
+    int k0 = work->seg_start[ss];
+    int k1 = work->seg_start[ss + 1];
+    int nl, k_last;
+    struct blasfeo_dmat *VPn;
+    struct blasfeo_dvec *ln;
+
+    if (ss == num_seg - 1)
+    {
+        nl = 0;
+        backward_stage(qp_in, work, N, 0, NULL, NULL);
+        VPn = work->VP + N;
+        ln = work->l + N;
+        k_last = N - 1;
+    }
+    else
+    {
+        nl = nx[k1];
+        blasfeo_dvecse(2 * nl, 0.0, work->le + ss, 0);
+        VPn = work->VPe + ss;
+        ln = work->le + ss;
+        k_last = k1 - 1;
+    }
+
+    for (int ii = k_last; ii >= k0; ii--)
+    {
+        backward_stage(qp_in, work, ii, nl, VPn, ln);
+        VPn = work->VP + ii;
+        ln = work->l + ii;
+    }
+}
+
+
+
+static void forward_segment(const ocp_qp_in *qp_in, ocp_qp_parallel_riccati_workspace *work,
+                            int ss, int num_seg)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+
+    int k0 = work->seg_start[ss];
+    int k1 = work->seg_start[ss + 1];
+    int last = ss == num_seg - 1;
+    int nl = last ? 0 : nx[k1];
+    int k_last = last ? N : k1 - 1;
+
+    for (int ii = k0; ii <= k_last; ii++)
+    {
+        forward_stage(qp_in, work, ii, nl, work->lam_seg + ss, !last && ii == k1 - 1);
+        stage_expand_ineq(qp_in, work, ii);
+    }
+}
+
+
+
+// The cost-to-go of segment ss as function of its initial state x and of lam_seg is
+//   0.5 x' P x + x' (pbar + Gamma lam_seg) + 0.5 lam_seg' Omega lam_seg + omega' lam_seg,
+// its final state is Gamma' x + Omega lam_seg + omega, which has to match the initial state of the
+// next segment. Going backwards over the segments, the cost-to-go of the following segments
+//   0.5 x' Pbar x + qbar' x
+// is propagated with T = I - Omega Pbar_{ss+1}:
+//   Pbar_ss = P + Gamma Pbar_{ss+1} T^-1 Gamma'.
+static void factorize_reduced(const ocp_qp_in *qp_in, ocp_qp_parallel_riccati_workspace *work, int num_seg)
+{
+    int *nx = qp_in->dim->nx;
+    int *seg_start = work->seg_start;
+
+    int n = nx[seg_start[num_seg - 1]];
+    blasfeo_dgecp(n, n, work->VP + seg_start[num_seg - 1], 0, 0, work->Pbar + num_seg - 1, 0, 0);
+
+    for (int ss = num_seg - 2; ss >= 0; ss--)
+    {
+        struct blasfeo_dmat *VPs = work->VP + seg_start[ss];
+        struct blasfeo_dmat *T = work->T + ss;
+        struct blasfeo_dmat *Y = work->Y + ss;
+        n = nx[seg_start[ss]];
+        int m = nx[seg_start[ss + 1]];
+
+        blasfeo_dgemm_nn(m, m, m, -1.0, VPs, n, n, work->Pbar + ss + 1, 0, 0, 0.0, T, 0, 0, T, 0, 0);
+        blasfeo_ddiare(m, 1.0, T, 0, 0);
+        blasfeo_dgetrf_rp(m, m, T, 0, 0, T, 0, 0, work->ipiv[ss]);
+
+        // Y = T^-1 Gamma'
+        blasfeo_dgecp(m, n, VPs, n, 0, Y, 0, 0);
+        blasfeo_drowpe(m, work->ipiv[ss], Y);
+        blasfeo_dtrsm_llnu(m, n, 1.0, T, 0, 0, Y, 0, 0, Y, 0, 0);
+        blasfeo_dtrsm_lunn(m, n, 1.0, T, 0, 0, Y, 0, 0, Y, 0, 0);
+
+        blasfeo_dgemm_nn(m, n, m, 1.0, work->Pbar + ss + 1, 0, 0, Y, 0, 0, 0.0,
+                         &work->tmp_mat, 0, 0, &work->tmp_mat, 0, 0);
+        blasfeo_dgemm_tn(n, n, m, 1.0, VPs, n, 0, &work->tmp_mat, 0, 0, 1.0, VPs, 0, 0,
+                         work->Pbar + ss, 0, 0);
+        blasfeo_dtrtr_l(n, work->Pbar + ss, 0, 0, work->Pbar + ss, 0, 0);
+    }
+
+    blasfeo_dpotrf_l(nx[0], work->Pbar, 0, 0, &work->Lbar, 0, 0);
+}
+
+
+
+// solves the reduced system for the initial states of the segments and the coupling multipliers
+static void solve_reduced(const ocp_qp_in *qp_in, ocp_qp_parallel_riccati_workspace *work, int num_seg)
+{
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *seg_start = work->seg_start;
+
+    int n = nx[seg_start[num_seg - 1]];
+    blasfeo_dveccp(n, work->l + seg_start[num_seg - 1], 0, work->qbar + num_seg - 1, 0);
+
+    for (int ss = num_seg - 2; ss >= 0; ss--)
+    {
+        struct blasfeo_dmat *VPs = work->VP + seg_start[ss];
+        struct blasfeo_dvec *ls = work->l + seg_start[ss];
+        struct blasfeo_dvec *tmp = work->tmp_seg + ss;
+        n = nx[seg_start[ss]];
+        int m = nx[seg_start[ss + 1]];
+
+        // v = omega + Omega qbar_{ss+1}
+        blasfeo_dsymv_l(m, 1.0, VPs, n, n, work->qbar + ss + 1, 0, 1.0, ls, n, work->v + ss, 0);
+
+        // qbar_ss = pbar + Gamma (Pbar_{ss+1} T^-1 v + qbar_{ss+1})
+        blasfeo_dveccp(m, work->v + ss, 0, tmp, 0);
+        blasfeo_dvecpe(m, work->ipiv[ss], tmp, 0);
+        blasfeo_dtrsv_lnu(m, work->T + ss, 0, 0, tmp, 0, tmp, 0);
+        blasfeo_dtrsv_unn(m, work->T + ss, 0, 0, tmp, 0, tmp, 0);
+        blasfeo_dsymv_l(m, 1.0, work->Pbar + ss + 1, 0, 0, tmp, 0, 1.0, work->qbar + ss + 1, 0,
+                        work->lam_seg + ss, 0);
+        blasfeo_dgemv_t(m, n, 1.0, VPs, n, 0, work->lam_seg + ss, 0, 1.0, ls, 0, work->qbar + ss, 0);
+    }
+
+    // initial state: Pbar_0 x_0 + qbar_0 = 0
+    blasfeo_dtrsv_lnn(nx[0], &work->Lbar, 0, 0, work->qbar, 0, work->tmp_seg, 0);
+    blasfeo_dtrsv_ltn(nx[0], &work->Lbar, 0, 0, work->tmp_seg, 0, work->tmp_seg, 0);
+    blasfeo_dveccpsc(nx[0], -1.0, work->tmp_seg, 0, work->dux, nu[0]);
+
+    // initial state of the next segment x = T^-1 (Gamma' x_ss + v), lam_seg = Pbar x + qbar
+    for (int ss = 0; ss < num_seg - 1; ss++)
+    {
+        int k0 = seg_start[ss];
+        int k1 = seg_start[ss + 1];
+        struct blasfeo_dvec *tmp = work->tmp_seg + ss;
+        n = nx[k0];
+        int m = nx[k1];
+
+        blasfeo_dgemv_n(m, n, 1.0, work->VP + k0, n, 0, work->dux + k0, nu[k0], 1.0, work->v + ss, 0,
+                        tmp, 0);
+        blasfeo_dvecpe(m, work->ipiv[ss], tmp, 0);
+        blasfeo_dtrsv_lnu(m, work->T + ss, 0, 0, tmp, 0, tmp, 0);
+        blasfeo_dtrsv_unn(m, work->T + ss, 0, 0, tmp, 0, work->dux + k1, nu[k1]);
+        blasfeo_dsymv_l(m, 1.0, work->Pbar + ss + 1, 0, 0, work->dux + k1, nu[k1], 1.0,
+                        work->qbar + ss + 1, 0, work->lam_seg + ss, 0);
+    }
+}
+
+
+
+static void newton_factorize(const ocp_qp_in *qp_in, const ocp_qp_parallel_riccati_opts *opts,
+                             ocp_qp_parallel_riccati_workspace *work, int num_seg)
+{
+    int N = qp_in->dim->N;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    // barrier Hessian, zero for the constraints not in d_mask as lam is zero there
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nc = nb[ii] + ng[ii];
+        for (int jj = 0; jj < 2 * nc; jj++)
+            BLASFEO_DVECEL(work->w + ii, jj) =
+                BLASFEO_DVECEL(work->lam + ii, jj) / BLASFEO_DVECEL(work->t + ii, jj);
+    }
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(num_seg)
+#endif
+    for (int ss = 0; ss < num_seg; ss++)
+        factorize_segment(qp_in, opts, work, ss, num_seg);
+
+    factorize_reduced(qp_in, work, num_seg);
+}
+
+
+
+// Newton step for the current res_m, using the factorization from newton_factorize
+static void newton_solve(const ocp_qp_in *qp_in, ocp_qp_parallel_riccati_workspace *work, int num_seg)
+{
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(num_seg)
+#endif
+    for (int ss = 0; ss < num_seg; ss++)
+        backward_segment(qp_in, work, ss, num_seg);
+
+    solve_reduced(qp_in, work, num_seg);
+
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for num_threads(num_seg)
+#endif
+    for (int ss = 0; ss < num_seg; ss++)
+        forward_segment(qp_in, work, ss, num_seg);
+}
+
+
+
+// largest step in (0, 1] keeping lam and t nonnegative
+static double max_step_length(const ocp_qp_in *qp_in, ocp_qp_parallel_riccati_workspace *work)
+{
+    int N = qp_in->dim->N;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    double alpha = 1.0;
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nc = nb[ii] + ng[ii];
+        for (int jj = 0; jj < 2 * nc; jj++)
+        {
+            double dlam = BLASFEO_DVECEL(work->dlam + ii, jj);
+            double dt = BLASFEO_DVECEL(work->dt + ii, jj);
+            if (dlam < 0.0)
+                alpha = MIN(alpha, - BLASFEO_DVECEL(work->lam + ii, jj) / dlam);
+            if (dt < 0.0)
+                alpha = MIN(alpha, - BLASFEO_DVECEL(work->t + ii, jj) / dt);
+        }
+    }
+    return alpha;
+}
+
+
+
+// duality measure after a step of length alpha
+static double step_duality_measure(const ocp_qp_in *qp_in, ocp_qp_parallel_riccati_workspace *work,
+                                   double alpha, int num_active)
+{
+    int N = qp_in->dim->N;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    double sum_comp = 0.0;
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nc = nb[ii] + ng[ii];
+        for (int jj = 0; jj < 2 * nc; jj++)
+        {
+            sum_comp += (BLASFEO_DVECEL(work->lam + ii, jj) + alpha * BLASFEO_DVECEL(work->dlam + ii, jj))
+                        * (BLASFEO_DVECEL(work->t + ii, jj) + alpha * BLASFEO_DVECEL(work->dt + ii, jj));
+        }
+    }
+    return sum_comp / num_active;
+}
+
+
+
+static void update_iterates(const ocp_qp_in *qp_in, ocp_qp_parallel_riccati_workspace *work, double alpha)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nc = nb[ii] + ng[ii];
+        blasfeo_daxpy(nu[ii] + nx[ii], alpha, work->dux + ii, 0, work->ux + ii, 0, work->ux + ii, 0);
+        blasfeo_daxpy(2 * nc, alpha, work->dlam + ii, 0, work->lam + ii, 0, work->lam + ii, 0);
+        blasfeo_daxpy(2 * nc, alpha, work->dt + ii, 0, work->t + ii, 0, work->t + ii, 0);
+        if (ii < N)
+            blasfeo_daxpy(nx[ii + 1], alpha, work->dpi + ii, 0, work->pi + ii, 0, work->pi + ii, 0);
+    }
+}
+
+
+
+// returns the number of constraints in d_mask
+static int initialize_iterates(const ocp_qp_in *qp_in, ocp_qp_out *qp_out,
+                               const ocp_qp_parallel_riccati_opts *opts,
+                               ocp_qp_parallel_riccati_workspace *work)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    // minimum initial slack
+    double thr0 = 1.0;
+    int num_active = 0;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nv = nu[ii] + nx[ii];
+        int nc = nb[ii] + ng[ii];
+
+        if (opts->warm_start > 0)
+            blasfeo_dveccp(nv, qp_out->ux + ii, 0, work->ux + ii, 0);
+        else
+            blasfeo_dvecse(nv, 0.0, work->ux + ii, 0);
+
+        if (ii < N)
+            blasfeo_dvecse(nx[ii + 1], 0.0, work->pi + ii, 0);
+
+        if (nc == 0)
+            continue;
+
+        // slacks from the constraint values, multipliers on the central path
+        struct blasfeo_dvec *tmp_nc = work->tmp_nc + ii;
+        blasfeo_dvecex_sp(nb[ii], 1.0, qp_in->idxb[ii], work->ux + ii, 0, tmp_nc, 0);
+        blasfeo_dgemv_t(nv, ng[ii], 1.0, qp_in->DCt + ii, 0, 0, work->ux + ii, 0, 0.0, tmp_nc, nb[ii],
+                        tmp_nc, nb[ii]);
+        for (int jj = 0; jj < nc; jj++)
+        {
+            double c = BLASFEO_DVECEL(tmp_nc, jj);
+            BLASFEO_DVECEL(work->t + ii, jj) = c - BLASFEO_DVECEL(qp_in->d + ii, jj);
+            BLASFEO_DVECEL(work->t + ii, nc + jj) = - c - BLASFEO_DVECEL(qp_in->d + ii, nc + jj);
+        }
+        for (int jj = 0; jj < 2 * nc; jj++)
+        {
+            if (BLASFEO_DVECEL(qp_in->d_mask + ii, jj) != 0.0)
+            {
+                BLASFEO_DVECEL(work->t + ii, jj) = MAX(thr0, BLASFEO_DVECEL(work->t + ii, jj));
+                BLASFEO_DVECEL(work->lam + ii, jj) = opts->mu0 / BLASFEO_DVECEL(work->t + ii, jj);
+                num_active++;
+            }
+            else
+            {
+                BLASFEO_DVECEL(work->t + ii, jj) = 1.0;
+                BLASFEO_DVECEL(work->lam + ii, jj) = 0.0;
+            }
+        }
+    }
+
+    return num_active;
+}
+
+
+
+static void fill_in_qp_out(const ocp_qp_in *qp_in, ocp_qp_out *qp_out, ocp_qp_parallel_riccati_workspace *work)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nc = nb[ii] + ng[ii];
+        blasfeo_dveccp(nu[ii] + nx[ii], work->ux + ii, 0, qp_out->ux + ii, 0);
+        blasfeo_dveccp(2 * nc, work->lam + ii, 0, qp_out->lam + ii, 0);
+        blasfeo_dveccp(2 * nc, work->t + ii, 0, qp_out->t + ii, 0);
+        if (ii < N)
+            blasfeo_dveccp(nx[ii + 1], work->pi + ii, 0, qp_out->pi + ii, 0);
+    }
+}
+
+
+
+/************************************************
+ * functions
+ ************************************************/
+
+int ocp_qp_parallel_riccati(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, void *work_)
+{
+    ocp_qp_in *qp_in = qp_in_;
+    ocp_qp_out *qp_out = qp_out_;
+    ocp_qp_parallel_riccati_opts *opts = opts_;
+    ocp_qp_parallel_riccati_memory *mem = mem_;
+
+    qp_info *info = qp_out->misc;
+    acados_timer tot_timer, qp_timer;
+    acados_tic(&tot_timer);
+
+    int N = qp_in->dim->N;
+    int *ns = qp_in->dim->ns;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        if (ns[ii] > 0)
+        {
+            printf("\nparallel Riccati solver can not handle ns>0 yet: what about implementing it? :)\n");
+            exit(1);
+        }
+    }
+
+    ocp_qp_parallel_riccati_workspace *work = ocp_qp_parallel_riccati_cast_workspace(qp_in->dim, work_);
+
+    acados_tic(&qp_timer);
+
+    // split the horizon into segments
+    int num_seg = MIN(opts->num_segments, N > 0 ? N : 1);
+    for (int ss = 0; ss < num_seg; ss++)
+        work->seg_start[ss] = (ss * N) / num_seg;
+    work->seg_start[num_seg] = N;
+
+    int num_active = initialize_iterates(qp_in, qp_out, opts, work);
+
+    int status = ACADOS_MAXITER;
+    double res[4];
+    double mu, alpha;
+    int iter;
+
+    for (iter = 0; iter <= opts->iter_max; iter++)
+    {
+        mu = compute_residuals(qp_in, work, num_active, num_seg, res);
+
+        if (opts->print_level > 0)
+            printf("parallel riccati: iter %d\tres_stat %e\tres_eq %e\tres_ineq %e\tres_comp %e\n",
+                   iter, res[0], res[1], res[2], res[3]);
+
+        if (isnan(res[0]) || isnan(res[1]) || isnan(res[2]) || isnan(res[3]))
+        {
+            status = ACADOS_NAN_DETECTED;
+            break;
+        }
+        if (res[0] <= opts->tol_stat && res[1] <= opts->tol_eq &&
+            res[2] <= opts->tol_ineq && res[3] <= opts->tol_comp)
+        {
+            status = ACADOS_SUCCESS;
+            break;
+        }
+        if (iter == opts->iter_max)
+            break;
+
+        newton_factorize(qp_in, opts, work, num_seg);
+
+        // predictor (affine scaling) step
+        compute_res_m(qp_in, work, 0.0, 0);
+        newton_solve(qp_in, work, num_seg);
+
+        if (num_active > 0)
+        {
+            // corrector step, centering parameter from the predictor (Mehrotra)
+            alpha = max_step_length(qp_in, work);
+            double sigma = step_duality_measure(qp_in, work, alpha, num_active) / mu;
+            sigma = MIN(1.0, sigma * sigma * sigma);
+
+            compute_res_m(qp_in, work, sigma * mu, 1);
+            newton_solve(qp_in, work, num_seg);
+        }
+
+        alpha = MIN(1.0, 0.995 * max_step_length(qp_in, work));
+        update_iterates(qp_in, work, alpha);
+    }
+
+    fill_in_qp_out(qp_in, qp_out, work);
+
+    mem->time_qp_solver_call = acados_toc(&qp_timer);
+
+    // KKT residual of the solution
+    ocp_qp_res_compute(qp_in, qp_out, work->qp_res, work->qp_res_ws);
+    ocp_qp_res_compute_nrm_inf(work->qp_res, mem->res);
+
+    mem->num_segments = num_seg;
+    mem->iter = iter;
+    mem->status = status;
+
+    info->solve_QP_time = mem->time_qp_solver_call;
+    info->interface_time = 0;  // the solver works on ocp_qp_in directly
+    info->total_time = acados_toc(&tot_timer);
+    info->num_iter = iter;
+    info->t_computed = 1;
+
+    return status;
+}
+
+
+
+void ocp_qp_parallel_riccati_memory_reset(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, void *work_)
+{
+    // no internal state besides statistics
+    ocp_qp_in *qp_in = qp_in_;
+    ocp_qp_parallel_riccati_memory_assign(config_, qp_in->dim, opts_, mem_);
+}
+
+
+
+void ocp_qp_parallel_riccati_solver_get(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, const char *field, int stage, void* value, int size1, int size2)
+{
+    printf("\nerror: ocp_qp_parallel_riccati_solver_get: not implemented yet\n");
+    exit(1);
+}
+
+
+
+void ocp_qp_parallel_riccati_eval_forw_sens(void *config_, void *qp_in, void *seed, void *qp_out, void *opts_, void *mem_, void *work_)
+{
+    printf("\nerror: ocp_qp_parallel_riccati_eval_forw_sens: not implemented yet\n");
+    exit(1);
+}
+
+
+
+void ocp_qp_parallel_riccati_eval_adj_sens(void *config_, void *qp_in, void *seed, void *qp_out, void *opts_, void *mem_, void *work_)
+{
+    printf("\nerror: ocp_qp_parallel_riccati_eval_adj_sens: not implemented yet\n");
+    exit(1);
+}
+
+
+
+void ocp_qp_parallel_riccati_terminate(void *config_, void *mem_, void *work_)
+{
+    return;
+}
+
+
+
+void ocp_qp_parallel_riccati_config_initialize_default(void *config_)
+{
+    qp_solver_config *config = config_;
+
+    config->dims_set = &ocp_qp_dims_set;
+    config->opts_calculate_size = &ocp_qp_parallel_riccati_opts_calculate_size;
+    config->opts_assign = &ocp_qp_parallel_riccati_opts_assign;
+    config->opts_initialize_default = &ocp_qp_parallel_riccati_opts_initialize_default;
+    config->opts_update = &ocp_qp_parallel_riccati_opts_update;
+    config->opts_set = &ocp_qp_parallel_riccati_opts_set;
+    config->opts_get = &ocp_qp_parallel_riccati_opts_get;
+    config->memory_calculate_size = &ocp_qp_parallel_riccati_memory_calculate_size;
+    config->memory_assign = &ocp_qp_parallel_riccati_memory_assign;
+    config->memory_get = &ocp_qp_parallel_riccati_memory_get;
+    config->workspace_calculate_size = &ocp_qp_parallel_riccati_workspace_calculate_size;
+    config->evaluate = &ocp_qp_parallel_riccati;
+    config->solver_get = &ocp_qp_parallel_riccati_solver_get;
+    config->memory_reset = &ocp_qp_parallel_riccati_memory_reset;
+    config->eval_forw_sens = &ocp_qp_parallel_riccati_eval_forw_sens;
+    config->eval_adj_sens = &ocp_qp_parallel_riccati_eval_adj_sens;
+    config->terminate = &ocp_qp_parallel_riccati_terminate;
+
+    return;
+}
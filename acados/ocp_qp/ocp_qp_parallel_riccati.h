@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#ifndef ACADOS_OCP_QP_OCP_QP_PARALLEL_RICCATI_H_
+#define ACADOS_OCP_QP_OCP_QP_PARALLEL_RICCATI_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// blasfeo
+#include "blasfeo_common.h"
+// acados
+#include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/utils/types.h"
+
+
+
+// Primal-dual interior point method, in which the Newton system is solved by a Riccati recursion
+// that is parallel in time.
+// The horizon is split into segments. Within each segment, a Riccati recursion parametrized by the
+// initial state of the segment and by the multiplier of the coupling to the next segment is
+// computed independently. The segments are then coupled through a reduced system in the initial
+// states of the segments (a Riccati-like recursion with one step per segment), and the solution is
+// recovered independently in each segment.
+// With ACADOS_WITH_OPENMP the segments are processed in parallel, with one thread per segment.
+// The default is a single segment, i.e. a sequential Riccati recursion; set num_segments to the
+// number of threads to use.
+
+// struct of arguments to the solver
+typedef struct ocp_qp_parallel_riccati_opts_
+{
+    double tol_stat;     // exit tolerance on stationarity
+    double tol_eq;       // exit tolerance on the dynamics residual
+    double tol_ineq;     // exit tolerance on the inequality residual
+    double tol_comp;     // exit tolerance on complementarity
+    double mu0;          // initial barrier parameter
+    double reg_prim;     // regularization of the Hessian
+    int iter_max;
+    int num_segments;    // number of segments of the horizon (at most N), one thread each; default 1
+    int warm_start;      // 0: cold start, 1: primal from qp_out
+    int print_level;
+} ocp_qp_parallel_riccati_opts;
+
+
+
+// struct of the solver memory
+typedef struct ocp_qp_parallel_riccati_memory_
+{
+    double time_qp_solver_call;
+    double res[4];       // KKT residual of the solution, from ocp_qp_res_compute
+    int num_segments;    // number of segments used in the last call
+    int iter;
+    int status;
+} ocp_qp_parallel_riccati_memory;
+
+
+
+typedef struct ocp_qp_parallel_riccati_workspace_
+{
+    // iterates and steps
+    struct blasfeo_dvec *ux;
+    struct blasfeo_dvec *pi;
+    struct blasfeo_dvec *lam;
+    struct blasfeo_dvec *t;
+    struct blasfeo_dvec *dux;
+    struct blasfeo_dvec *dpi;
+    struct blasfeo_dvec *dlam;
+    struct blasfeo_dvec *dt;
+    // residuals
+    struct blasfeo_dvec *res_g;
+    struct blasfeo_dvec *res_b;
+    struct blasfeo_dvec *res_d;
+    struct blasfeo_dvec *res_m;
+    // Newton system
+    struct blasfeo_dvec *gamma;    // gradient of the condensed Newton system
+    struct blasfeo_dvec *w;        // barrier Hessian lam / t
+    struct blasfeo_dvec *tmp_nc;   // constraint evaluation
+    // stage-wise recursion
+    struct blasfeo_dmat *L;        // factorization of [u; x; lam_seg] (only u is eliminated)
+    struct blasfeo_dmat *VP;       // cost-to-go as function of [x; lam_seg]
+    struct blasfeo_dvec *l;        // linear term of the cost-to-go
+    struct blasfeo_dvec *lin;
+    struct blasfeo_dvec *yu;
+    struct blasfeo_dmat *tmp_nv_nx;
+    struct blasfeo_dmat *tmp_nv_ng;
+    struct blasfeo_dvec *tmp_nx;
+    // segment-wise reduced system
+    struct blasfeo_dmat *VPe;      // cost-to-go at the end of a segment
+    struct blasfeo_dvec *le;
+    struct blasfeo_dmat *Pbar;     // cost-to-go as function of the initial state of a segment
+    struct blasfeo_dmat *T;        // LU factorization of the coupling between segments
+    struct blasfeo_dmat *Y;
+    struct blasfeo_dvec *qbar;
+    struct blasfeo_dvec *v;
+    struct blasfeo_dvec *lam_seg;  // multiplier of the coupling to the next segment
+    struct blasfeo_dvec *tmp_seg;
+    struct blasfeo_dmat Lbar;
+    struct blasfeo_dmat tmp_mat;
+    int **ipiv;
+    int *seg_start;
+    // residual of the solution
+    ocp_qp_res *qp_res;
+    ocp_qp_res_ws *qp_res_ws;
+} ocp_qp_parallel_riccati_workspace;
+
+
+
+//
+acados_size_t ocp_qp_parallel_riccati_opts_calculate_size(void *config, void *dims);
+//
+void *ocp_qp_parallel_riccati_opts_assign(void *config, void *dims, void *raw_memory);
+//
+void ocp_qp_parallel_riccati_opts_initialize_default(void *config, void *dims, void *opts_);
+//
+void ocp_qp_parallel_riccati_opts_update(void *config, void *dims, void *opts_);
+//
+void ocp_qp_parallel_riccati_opts_set(void *config_, void *opts_, const char *field, void *value);
+//
+void ocp_qp_parallel_riccati_opts_get(void *config_, void *opts_, const char *field, void *value);
+//
+acados_size_t ocp_qp_parallel_riccati_memory_calculate_size(void *config, void *dims, void *opts_);
+//
+void *ocp_qp_parallel_riccati_memory_assign(void *config, void *dims, void *opts_, void *raw_memory);
+//
+void ocp_qp_parallel_riccati_memory_get(void *config_, void *mem_, const char *field, void* value);
+//
+acados_size_t ocp_qp_parallel_riccati_workspace_calculate_size(void *config, void *dims, void *opts_);
+//
+int ocp_qp_parallel_riccati(void *config, void *qp_in, void *qp_out, void *opts_, void *mem_, void *work_);
+//
+void ocp_qp_parallel_riccati_memory_reset(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, void *work_);
+//
+void ocp_qp_parallel_riccati_solver_get(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, const char *field, int stage, void* value, int size1, int size2);
+//
+void ocp_qp_parallel_riccati_eval_forw_sens(void *config_, void *qp_in, void *seed, void *qp_out, void *opts_, void *mem_, void *work_);
+//
+void ocp_qp_parallel_riccati_eval_adj_sens(void *config_, void *qp_in, void *seed, void *qp_out, void *opts_, void *mem_, void *work_);
+//
+void ocp_qp_parallel_riccati_terminate(void *config, void *mem_, void *work_);
+//
+void ocp_qp_parallel_riccati_config_initialize_default(void *config);
+
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_OCP_QP_OCP_QP_PARALLEL_RICCATI_H_
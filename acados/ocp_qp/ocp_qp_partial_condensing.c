@@ -261,6 +261,8 @@ void ocp_qp_partial_condensing_opts_initialize_default(void *dims_, void *opts_)
 
     opts->mem_qp_in = 1;
 
+    opts->num_threads = 1;
+
     return;
 }
 
@@ -311,6 +313,16 @@ void ocp_qp_partial_condensing_opts_set(void *opts_, const char *field, void* va
         }
         opts->block_size_was_set = true;
     }
+    else if(!strcmp(field, "num_threads"))
+    {
+        int *tmp_ptr = value;
+        if (*tmp_ptr < 1)
+        {
+            printf("\nerror: ocp_qp_partial_condensing_opts_set: invalid value for num_threads field, need int >= 1, got %d.\n", *tmp_ptr);
+            exit(1);
+        }
+        opts->num_threads = *tmp_ptr;
+    }
     // TODO dual_sol ???
     else
     {
@@ -396,6 +408,9 @@ acados_size_t ocp_qp_partial_condensing_memory_calculate_size(void *dims_, void
     size += sizeof(struct d_ocp_qp_reduce_eq_dof_ws);
     size += d_ocp_qp_reduce_eq_dof_ws_memsize(dims->orig_dims);
 
+    // block_offset
+    size += (opts->N2 + 1) * sizeof(int);
+
     size += 2*8;
     make_int_multiple_of(8, &size);
 
@@ -455,6 +470,12 @@ void *ocp_qp_partial_condensing_memory_assign(void *dims_, void *opts_, void *ra
 
     mem->qp_out_info = (qp_info *) mem->pcond_qp_out->misc;
 
+    // first stage of each block in the reduced qp
+    assign_and_advance_int(opts->N2 + 1, &mem->block_offset, &c_ptr);
+    mem->block_offset[0] = 0;
+    for (int ii = 0; ii < opts->N2; ii++)
+        mem->block_offset[ii+1] = mem->block_offset[ii] + dims->block_size[ii];
+
     mem->dims = dims;
 
     assert((char *) raw_memory + ocp_qp_partial_condensing_memory_calculate_size(dims, opts) >= c_ptr);
@@ -516,6 +537,163 @@ acados_size_t ocp_qp_partial_condensing_workspace_calculate_size(void *dims_, vo
 
 
 
+/************************************************
+ * block-parallel condensing
+ ************************************************/
+
+#if defined(ACADOS_WITH_OPENMP)
+
+// The blocks of stages are condensed independently of each other, each one with its own hpipm
+// cond arg and workspace (stored in the part_cond arg and workspace).
+// Here the loop over blocks, otherwise running inside d_part_cond_qp_*, is executed in parallel.
+// The first stage of each block in the reduced qp is stored in mem->block_offset.
+
+// alias stages N_tmp, ..., N_tmp+bs of qp as an ocp qp with horizon bs
+static void alias_block_qp(ocp_qp_in *qp, int N_tmp, int bs, ocp_qp_dims *block_dim, ocp_qp_in *block_qp)
+{
+    ocp_qp_dims *dim = qp->dim;
+
+    *block_dim = *dim;
+    block_dim->N = bs;
+    block_dim->nx = dim->nx + N_tmp;
+    block_dim->nu = dim->nu + N_tmp;
+    block_dim->nb = dim->nb + N_tmp;
+    block_dim->nbx = dim->nbx + N_tmp;
+    block_dim->nbu = dim->nbu + N_tmp;
+    block_dim->ng = dim->ng + N_tmp;
+    block_dim->ns = dim->ns + N_tmp;
+    block_dim->nsbx = dim->nsbx + N_tmp;
+    block_dim->nsbu = dim->nsbu + N_tmp;
+    block_dim->nsg = dim->nsg + N_tmp;
+    block_dim->nbxe = dim->nbxe + N_tmp;
+    block_dim->nbue = dim->nbue + N_tmp;
+    block_dim->nge = dim->nge + N_tmp;
+
+    *block_qp = *qp;
+    block_qp->dim = block_dim;
+    block_qp->BAbt = qp->BAbt + N_tmp;
+    block_qp->b = qp->b + N_tmp;
+    block_qp->RSQrq = qp->RSQrq + N_tmp;
+    block_qp->rqz = qp->rqz + N_tmp;
+    block_qp->DCt = qp->DCt + N_tmp;
+    block_qp->d = qp->d + N_tmp;
+    block_qp->d_mask = qp->d_mask + N_tmp;
+    block_qp->m = qp->m + N_tmp;
+    block_qp->Z = qp->Z + N_tmp;
+    block_qp->idxb = qp->idxb + N_tmp;
+    block_qp->idxs_rev = qp->idxs_rev + N_tmp;
+    block_qp->idxe = qp->idxe + N_tmp;
+    block_qp->diag_H_flag = qp->diag_H_flag + N_tmp;
+}
+
+
+
+static void alias_block_sol(ocp_qp_out *sol, int N_tmp, ocp_qp_dims *block_dim, ocp_qp_out *block_sol)
+{
+    *block_sol = *sol;
+    block_sol->dim = block_dim;
+    block_sol->ux = sol->ux + N_tmp;
+    block_sol->pi = sol->pi + N_tmp;
+    block_sol->lam = sol->lam + N_tmp;
+    block_sol->t = sol->t + N_tmp;
+}
+
+
+
+// condense lhs and/or rhs of all blocks of red_qp into the stages of pcond_qp
+static void partial_condensing_blocks(ocp_qp_in *red_qp, ocp_qp_in *pcond_qp, int *block_size,
+                    ocp_qp_partial_condensing_opts *opts, ocp_qp_partial_condensing_memory *mem,
+                    int lhs, int rhs)
+{
+    struct d_cond_qp_arg *cond_arg = opts->hpipm_pcond_opts->cond_arg;
+    struct d_cond_qp_ws *cond_ws = mem->hpipm_pcond_work->cond_workspace;
+
+    int *block_offset = mem->block_offset;
+
+    int N2 = pcond_qp->dim->N;
+
+    #pragma omp parallel for num_threads(opts->num_threads)
+    for (int ii = 0; ii <= N2; ii++)
+    {
+        ocp_qp_dims block_dim;
+        ocp_qp_in block_qp;
+        alias_block_qp(red_qp, block_offset[ii], block_size[ii], &block_dim, &block_qp);
+
+        if (lhs && rhs)
+        {
+            if (ii < N2)
+                d_cond_BAbt(&block_qp, pcond_qp->BAbt+ii, pcond_qp->b+ii, cond_arg+ii, cond_ws+ii);
+            d_cond_RSQrq(&block_qp, pcond_qp->RSQrq+ii, pcond_qp->rqz+ii, cond_arg+ii, cond_ws+ii);
+            d_cond_DCtd(&block_qp, pcond_qp->idxb[ii], pcond_qp->DCt+ii, pcond_qp->d+ii,
+                        pcond_qp->d_mask+ii, pcond_qp->idxs_rev[ii], pcond_qp->Z+ii,
+                        pcond_qp->rqz+ii, cond_arg+ii, cond_ws+ii);
+        }
+        else if (lhs)
+        {
+            if (ii < N2)
+                d_cond_BAt(&block_qp, pcond_qp->BAbt+ii, cond_arg+ii, cond_ws+ii);
+            d_cond_RSQ(&block_qp, pcond_qp->RSQrq+ii, cond_arg+ii, cond_ws+ii);
+            d_cond_DCt(&block_qp, pcond_qp->idxb[ii], pcond_qp->DCt+ii, pcond_qp->idxs_rev[ii],
+                       pcond_qp->Z+ii, cond_arg+ii, cond_ws+ii);
+        }
+        else if (rhs)
+        {
+            if (ii < N2)
+                d_cond_b(&block_qp, pcond_qp->b+ii, cond_arg+ii, cond_ws+ii);
+            d_cond_rq(&block_qp, pcond_qp->rqz+ii, cond_arg+ii, cond_ws+ii);
+            d_cond_d(&block_qp, pcond_qp->d+ii, pcond_qp->d_mask+ii, pcond_qp->rqz+ii,
+                     cond_arg+ii, cond_ws+ii);
+        }
+    }
+}
+
+
+
+// expand the solution of each block of pcond_sol into the stages of red_sol
+static void partial_expansion_blocks(ocp_qp_in *red_qp, ocp_qp_out *pcond_sol, ocp_qp_out *red_sol,
+                    int *block_size, ocp_qp_partial_condensing_opts *opts,
+                    ocp_qp_partial_condensing_memory *mem)
+{
+    struct d_cond_qp_arg *cond_arg = opts->hpipm_pcond_opts->cond_arg;
+    struct d_cond_qp_ws *cond_ws = mem->hpipm_pcond_work->cond_workspace;
+
+    int *block_offset = mem->block_offset;
+
+    int N2 = pcond_sol->dim->N;
+
+    #pragma omp parallel for num_threads(opts->num_threads)
+    for (int ii = 0; ii <= N2; ii++)
+    {
+        int N_tmp = block_offset[ii];
+
+        ocp_qp_dims block_dim;
+        ocp_qp_in block_qp;
+        ocp_qp_out block_sol;
+        alias_block_qp(red_qp, N_tmp, block_size[ii], &block_dim, &block_qp);
+        alias_block_sol(red_sol, N_tmp, &block_dim, &block_sol);
+
+        // stage ii of the partially condensed solution seen as the solution of the condensed block
+        struct d_dense_qp_sol dense_sol = {0};
+        dense_sol.v = pcond_sol->ux+ii;
+        dense_sol.pi = pcond_sol->pi+ii;
+        dense_sol.lam = pcond_sol->lam+ii;
+        dense_sol.t = pcond_sol->t+ii;
+
+        d_expand_sol(&block_qp, &dense_sol, &block_sol, cond_arg+ii, cond_ws+ii);
+
+        // the block is not condensed up to its last stage, pi of that stage is the one of stage ii
+        if (ii < N2)
+        {
+            int bs = block_size[ii];
+            blasfeo_dveccp(red_qp->dim->nx[N_tmp+bs], pcond_sol->pi+ii, 0, red_sol->pi+N_tmp+bs-1, 0);
+        }
+    }
+}
+
+#endif  // ACADOS_WITH_OPENMP
+
+
+
 /************************************************
  * functions
  ************************************************/
@@ -547,7 +725,12 @@ int ocp_qp_partial_condensing(void *qp_in_, void *pcond_qp_in_, void *opts_, voi
     // d_ocp_qp_print(pcond_qp_in->dim, pcond_qp_in);
 
     // convert to partially condensed qp structure
-    d_part_cond_qp_cond(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+#if defined(ACADOS_WITH_OPENMP)
+    if (opts->num_threads > 1)
+        partial_condensing_blocks(mem->red_qp, pcond_qp_in, mem->dims->block_size, opts, mem, 1, 1);
+    else
+#endif
+        d_part_cond_qp_cond(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
 
     // stop timer
     mem->time_qp_xcond = acados_toc(&timer);
@@ -590,7 +773,12 @@ int ocp_qp_partial_condensing_condense_lhs(void *qp_in_, void *pcond_qp_in_, voi
     acados_tic(&timer);
 
     d_ocp_qp_reduce_eq_dof_lhs(qp_in, mem->red_qp, opts->hpipm_red_opts, mem->hpipm_red_work);
-    d_part_cond_qp_cond_lhs(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+#if defined(ACADOS_WITH_OPENMP)
+    if (opts->num_threads > 1)
+        partial_condensing_blocks(mem->red_qp, pcond_qp_in, mem->dims->block_size, opts, mem, 1, 0);
+    else
+#endif
+        d_part_cond_qp_cond_lhs(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
 
     mem->time_qp_xcond = acados_toc(&timer);
 
@@ -621,7 +809,12 @@ int ocp_qp_partial_condensing_condense_rhs(void *qp_in_, void *pcond_qp_in_, voi
     d_ocp_qp_reduce_eq_dof_rhs(qp_in, mem->red_qp, opts->hpipm_red_opts, mem->hpipm_red_work);
 
     // convert to partially condensed qp structure
-    d_part_cond_qp_cond_rhs(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+#if defined(ACADOS_WITH_OPENMP)
+    if (opts->num_threads > 1)
+        partial_condensing_blocks(mem->red_qp, pcond_qp_in, mem->dims->block_size, opts, mem, 0, 1);
+    else
+#endif
+        d_part_cond_qp_cond_rhs(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
 
     // stop timer
     mem->time_qp_xcond += acados_toc(&timer);
@@ -677,7 +870,12 @@ int ocp_qp_partial_expansion(void *pcond_qp_out_, void *qp_out_, void *opts_, vo
 
     // expand solution
     // TODO only if N2<N
-    d_part_cond_qp_expand_sol(mem->red_qp, pcond_qp_out, mem->red_sol, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+#if defined(ACADOS_WITH_OPENMP)
+    if (opts->num_threads > 1)
+        partial_expansion_blocks(mem->red_qp, pcond_qp_out, mem->red_sol, mem->dims->block_size, opts, mem);
+    else
+#endif
+        d_part_cond_qp_expand_sol(mem->red_qp, pcond_qp_out, mem->red_sol, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
 
     // restore solution
     d_ocp_qp_restore_eq_dof(mem->ptr_qp_in, mem->red_sol, qp_out, opts->hpipm_red_opts, mem->hpipm_red_work);
@@ -65,6 +65,7 @@ typedef struct ocp_qp_partial_condensing_opts_
     bool block_size_was_set;
     int ric_alg;
     int mem_qp_in; // allocate qp_in in memory
+    int num_threads; // blocks are condensed in parallel if > 1 (with openmp), default 1
 } ocp_qp_partial_condensing_opts;
 
 
@@ -86,6 +87,7 @@ typedef struct ocp_qp_partial_condensing_memory_
     ocp_qp_seed *ptr_qp_seed;
     qp_info *qp_out_info; // info in pcond_qp_in
     ocp_qp_partial_condensing_dims *dims;
+    int *block_offset; // first stage of each block in the reduced qp
     double time_qp_xcond;
 } ocp_qp_partial_condensing_memory;
 
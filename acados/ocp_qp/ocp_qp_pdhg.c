@@ -0,0 +1,928 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+// external
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+// blasfeo
+#include "blasfeo_d_blasfeo_api.h"
+// acados
+#include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/ocp_qp/ocp_qp_pdhg.h"
+#include "acados/utils/math.h"
+#include "acados/utils/mem.h"
+#include "acados/utils/timing.h"
+#include "acados/utils/types.h"
+
+
+
+/************************************************
+ * opts
+ ************************************************/
+
+acados_size_t ocp_qp_pdhg_opts_calculate_size(void *config_, void *dims_)
+{
+    acados_size_t size = 0;
+    size += sizeof(ocp_qp_pdhg_opts);
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+void *ocp_qp_pdhg_opts_assign(void *config_, void *dims_, void *raw_memory)
+{
+    char *c_ptr = (char *) raw_memory;
+
+    ocp_qp_pdhg_opts *opts = (ocp_qp_pdhg_opts *) c_ptr;
+    c_ptr += sizeof(ocp_qp_pdhg_opts);
+
+    assert((char *) raw_memory + ocp_qp_pdhg_opts_calculate_size(config_, dims_) >= c_ptr);
+
+    return (void *) opts;
+}
+
+
+
+void ocp_qp_pdhg_opts_initialize_default(void *config_, void *dims_, void *opts_)
+{
+    ocp_qp_pdhg_opts *opts = opts_;
+
+    opts->tol_stat = 1e-6;
+    opts->tol_eq = 1e-6;
+    opts->tol_ineq = 1e-6;
+    opts->tol_comp = 1e-6;
+    opts->rho = 1.0;
+    opts->iter_max = 10000;
+    opts->warm_start = 0;
+    opts->adaptive_rho = 1;
+    opts->check_every = 10;
+    opts->power_iter = 20;
+    opts->print_level = 0;
+
+    return;
+}
+
+
+
+void ocp_qp_pdhg_opts_update(void *config_, void *dims_, void *opts_)
+{
+    return;
+}
+
+
+
+void ocp_qp_pdhg_opts_set(void *config_, void *opts_, const char *field, void *value)
+{
+    ocp_qp_pdhg_opts *opts = opts_;
+
+    if (!strcmp(field, "iter_max"))
+    {
+        int *tmp_ptr = value;
+        opts->iter_max = *tmp_ptr;
+    }
+    else if (!strcmp(field, "tol_stat"))
+    {
+        double *tmp_ptr = value;
+        opts->tol_stat = *tmp_ptr;
+    }
+    else if (!strcmp(field, "tol_eq"))
+    {
+        double *tmp_ptr = value;
+        opts->tol_eq = *tmp_ptr;
+    }
+    else if (!strcmp(field, "tol_ineq"))
+    {
+        double *tmp_ptr = value;
+        opts->tol_ineq = *tmp_ptr;
+    }
+    else if (!strcmp(field, "tol_comp"))
+    {
+        double *tmp_ptr = value;
+        opts->tol_comp = *tmp_ptr;
+    }
+    else if (!strcmp(field, "warm_start"))
+    {
+        int *tmp_ptr = value;
+        opts->warm_start = *tmp_ptr;
+    }
+    else if (!strcmp(field, "rho"))
+    {
+        double *tmp_ptr = value;
+        opts->rho = *tmp_ptr;
+    }
+    else if (!strcmp(field, "adaptive_rho"))
+    {
+        int *tmp_ptr = value;
+        opts->adaptive_rho = *tmp_ptr;
+    }
+    else if (!strcmp(field, "check_every"))
+    {
+        int *tmp_ptr = value;
+        opts->check_every = *tmp_ptr > 0 ? *tmp_ptr : 1;
+    }
+    else if (!strcmp(field, "power_iter"))
+    {
+        int *tmp_ptr = value;
+        opts->power_iter = *tmp_ptr;
+    }
+    else if (!strcmp(field, "print_level"))
+    {
+        int *tmp_ptr = value;
+        opts->print_level = *tmp_ptr;
+    }
+    else
+    {
+        printf("\nerror: ocp_qp_pdhg_opts_set: wrong field: %s\n", field);
+        exit(1);
+    }
+
+    return;
+}
+
+
+
+void ocp_qp_pdhg_opts_get(void *config_, void *opts_, const char *field, void *value)
+{
+    ocp_qp_pdhg_opts *opts = opts_;
+
+    if (!strcmp(field, "iter_max"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = opts->iter_max;
+    }
+    else if (!strcmp(field, "warm_start"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = opts->warm_start;
+    }
+    else if (!strcmp(field, "rho"))
+    {
+        double *tmp_ptr = value;
+        *tmp_ptr = opts->rho;
+    }
+    else
+    {
+        printf("\nerror: ocp_qp_pdhg_opts_get: not implemented for field %s\n", field);
+        exit(1);
+    }
+
+    return;
+}
+
+
+
+/************************************************
+ * memory
+ ************************************************/
+
+acados_size_t ocp_qp_pdhg_memory_calculate_size(void *config_, void *dims_, void *opts_)
+{
+    acados_size_t size = 0;
+    size += sizeof(ocp_qp_pdhg_memory);
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+void *ocp_qp_pdhg_memory_assign(void *config_, void *dims_, void *opts_, void *raw_memory)
+{
+    char *c_ptr = (char *) raw_memory;
+
+    ocp_qp_pdhg_memory *mem = (ocp_qp_pdhg_memory *) c_ptr;
+    c_ptr += sizeof(ocp_qp_pdhg_memory);
+
+    mem->time_qp_solver_call = 0.0;
+    mem->rho = 0.0;
+    mem->res_stat = 0.0;
+    mem->res_eq = 0.0;
+    mem->res_ineq = 0.0;
+    mem->res_comp = 0.0;
+    mem->iter = 0;
+    mem->status = ACADOS_READY;
+
+    assert((char *) raw_memory + ocp_qp_pdhg_memory_calculate_size(config_, dims_, opts_) >= c_ptr);
+
+    return mem;
+}
+
+
+
+void ocp_qp_pdhg_memory_get(void *config_, void *mem_, const char *field, void* value)
+{
+    ocp_qp_pdhg_memory *mem = mem_;
+
+    if (!strcmp(field, "time_qp_solver_call"))
+    {
+        double *tmp_ptr = value;
+        *tmp_ptr = mem->time_qp_solver_call;
+    }
+    else if (!strcmp(field, "iter"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->iter;
+    }
+    else if (!strcmp(field, "status"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->status;
+    }
+    else if (!strcmp(field, "rho"))
+    {
+        double *tmp_ptr = value;
+        *tmp_ptr = mem->rho;
+    }
+    else if (!strcmp(field, "res_stat"))
+    {
+        double *tmp_ptr = value;
+        *tmp_ptr = mem->res_stat;
+    }
+    else if (!strcmp(field, "res_eq"))
+    {
+        double *tmp_ptr = value;
+        *tmp_ptr = mem->res_eq;
+    }
+    else if (!strcmp(field, "res_ineq"))
+    {
+        double *tmp_ptr = value;
+        *tmp_ptr = mem->res_ineq;
+    }
+    else if (!strcmp(field, "res_comp"))
+    {
+        double *tmp_ptr = value;
+        *tmp_ptr = mem->res_comp;
+    }
+    else
+    {
+        printf("\nerror: ocp_qp_pdhg_memory_get: field %s not available\n", field);
+        exit(1);
+    }
+
+    return;
+}
+
+
+
+/************************************************
+ * workspace
+ ************************************************/
+
+acados_size_t ocp_qp_pdhg_workspace_calculate_size(void *config_, void *dims_, void *opts_)
+{
+    ocp_qp_dims *dims = dims_;
+
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *ng = dims->ng;
+
+    acados_size_t size = 0;
+    size += sizeof(ocp_qp_pdhg_workspace);
+
+    size += 6 * (N + 1) * sizeof(struct blasfeo_dvec);  // ux ux_prev ux_bar grad lam_g tmp_ng
+    size += 2 * N * sizeof(struct blasfeo_dvec);        // pi tmp_nx
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        size += 4 * blasfeo_memsize_dvec(nu[ii] + nx[ii]);  // ux ux_prev ux_bar grad
+        size += 2 * blasfeo_memsize_dvec(ng[ii]);           // lam_g tmp_ng
+    }
+    for (int ii = 0; ii < N; ii++)
+    {
+        size += 2 * blasfeo_memsize_dvec(nx[ii + 1]);       // pi tmp_nx
+    }
+
+    size += 1 * 8;   // struct align
+    size += 1 * 64;  // blasfeo_mem align
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+static ocp_qp_pdhg_workspace *ocp_qp_pdhg_cast_workspace(ocp_qp_dims *dims, void *raw_memory)
+{
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *ng = dims->ng;
+
+    char *c_ptr = (char *) raw_memory;
+
+    ocp_qp_pdhg_workspace *work = (ocp_qp_pdhg_workspace *) c_ptr;
+    c_ptr += sizeof(ocp_qp_pdhg_workspace);
+
+    align_char_to(8, &c_ptr);
+
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->ux, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->ux_prev, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->ux_bar, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->grad, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->lam_g, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &work->tmp_ng, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N, &work->pi, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(N, &work->tmp_nx, &c_ptr);
+
+    // blasfeo_mem align
+    align_char_to(64, &c_ptr);
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nu[ii] + nx[ii], work->ux + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nu[ii] + nx[ii], work->ux_prev + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nu[ii] + nx[ii], work->ux_bar + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nu[ii] + nx[ii], work->grad + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(ng[ii], work->lam_g + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(ng[ii], work->tmp_ng + ii, &c_ptr);
+    }
+    for (int ii = 0; ii < N; ii++)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nx[ii + 1], work->pi + ii, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nx[ii + 1], work->tmp_nx + ii, &c_ptr);
+    }
+
+    assert((char *) raw_memory + ocp_qp_pdhg_workspace_calculate_size(NULL, dims, NULL) >= c_ptr);
+
+    return work;
+}
+
+
+
+/************************************************
+ * stage-wise operators
+ ************************************************/
+
+// clips val to the bounds at position idx_low, idx_upp of d, disregarded bounds are skipped
+static double clip_to_bounds(const ocp_qp_in *qp_in, int stage, int idx_low, int idx_upp, double val)
+{
+    struct blasfeo_dvec *d = qp_in->d + stage;
+    struct blasfeo_dvec *d_mask = qp_in->d_mask + stage;
+
+    if (BLASFEO_DVECEL(d_mask, idx_low) != 0.0)
+        val = MAX(val, BLASFEO_DVECEL(d, idx_low));
+    // upper bounds are stored with flipped sign
+    if (BLASFEO_DVECEL(d_mask, idx_upp) != 0.0)
+        val = MIN(val, -BLASFEO_DVECEL(d, idx_upp));
+
+    return val;
+}
+
+
+
+// projects the stage vector v on the box constraints
+static void project_bounds(const ocp_qp_in *qp_in, int stage, struct blasfeo_dvec *v)
+{
+    int nb = qp_in->dim->nb[stage];
+    int ng = qp_in->dim->ng[stage];
+    int *idxb = qp_in->idxb[stage];
+
+    for (int jj = 0; jj < nb; jj++)
+    {
+        BLASFEO_DVECEL(v, idxb[jj]) = clip_to_bounds(qp_in, stage, jj, nb + ng + jj,
+                                                      BLASFEO_DVECEL(v, idxb[jj]));
+    }
+}
+
+
+
+// r_k = x_{k+1} - B_k u_k - A_k x_k and g_k = D_k u_k + C_k x_k
+static void constraint_operator(const ocp_qp_in *qp_in, struct blasfeo_dvec *v,
+                                struct blasfeo_dvec *r, struct blasfeo_dvec *g)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *ng = qp_in->dim->ng;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        if (ii < N)
+            blasfeo_dgemv_t(nu[ii] + nx[ii], nx[ii + 1], -1.0, qp_in->BAbt + ii, 0, 0, v + ii, 0,
+                            1.0, v + ii + 1, nu[ii + 1], r + ii, 0);
+        if (ng[ii] > 0)
+            blasfeo_dgemv_t(nu[ii] + nx[ii], ng[ii], 1.0, qp_in->DCt + ii, 0, 0, v + ii, 0,
+                            0.0, g + ii, 0, g + ii, 0);
+    }
+}
+
+
+
+// out = K' [y_dyn; y_g] + beta * out
+static void constraint_operator_adjoint(const ocp_qp_in *qp_in, struct blasfeo_dvec *y_dyn,
+                                        struct blasfeo_dvec *y_g, double beta,
+                                        struct blasfeo_dvec *out)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *ng = qp_in->dim->ng;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        if (beta == 0.0)
+            blasfeo_dvecse(nu[ii] + nx[ii], 0.0, out + ii, 0);
+        else if (beta != 1.0)
+            blasfeo_dvecsc(nu[ii] + nx[ii], beta, out + ii, 0);
+
+        if (ii < N)
+            blasfeo_dgemv_n(nu[ii] + nx[ii], nx[ii + 1], -1.0, qp_in->BAbt + ii, 0, 0, y_dyn + ii, 0,
+                            1.0, out + ii, 0, out + ii, 0);
+        if (ii > 0)
+            blasfeo_daxpy(nx[ii], 1.0, y_dyn + ii - 1, 0, out + ii, nu[ii], out + ii, nu[ii]);
+        if (ng[ii] > 0)
+            blasfeo_dgemv_n(nu[ii] + nx[ii], ng[ii], 1.0, qp_in->DCt + ii, 0, 0, y_g + ii, 0,
+                            1.0, out + ii, 0, out + ii, 0);
+    }
+}
+
+
+
+// gradient of the Lagrangian: grad = H ux + g + K' [pi; lam_g]
+static void compute_gradient(const ocp_qp_in *qp_in, ocp_qp_pdhg_workspace *work)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        blasfeo_dsymv_l(nu[ii] + nx[ii], 1.0, qp_in->RSQrq + ii, 0, 0, work->ux + ii, 0,
+                        1.0, qp_in->rqz + ii, 0, work->grad + ii, 0);
+    }
+    constraint_operator_adjoint(qp_in, work->pi, work->lam_g, 1.0, work->grad);
+}
+
+
+
+static double stage_vectors_norm(const ocp_qp_in *qp_in, struct blasfeo_dvec *v)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+
+    double sum = 0.0;
+    for (int ii = 0; ii <= N; ii++)
+        sum += blasfeo_ddot(nu[ii] + nx[ii], v + ii, 0, v + ii, 0);
+
+    return sqrt(sum);
+}
+
+
+
+static void stage_vectors_scale(const ocp_qp_in *qp_in, double alpha, struct blasfeo_dvec *v)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+
+    for (int ii = 0; ii <= N; ii++)
+        blasfeo_dvecsc(nu[ii] + nx[ii], alpha, v + ii, 0);
+}
+
+
+
+// power iteration for the spectral norm of the Hessian (hessian != 0) or of K'K (hessian == 0)
+static double power_iteration(const ocp_qp_in *qp_in, ocp_qp_pdhg_workspace *work, int hessian,
+                              int num_iter)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+
+    struct blasfeo_dvec *v = work->ux_bar;
+    struct blasfeo_dvec *w = work->ux_prev;
+
+    for (int ii = 0; ii <= N; ii++)
+        blasfeo_dvecse(nu[ii] + nx[ii], 1.0, v + ii, 0);
+    stage_vectors_scale(qp_in, 1.0 / stage_vectors_norm(qp_in, v), v);
+
+    double norm = 0.0;
+    for (int kk = 0; kk < num_iter; kk++)
+    {
+        if (hessian)
+        {
+            for (int ii = 0; ii <= N; ii++)
+                blasfeo_dsymv_l(nu[ii] + nx[ii], 1.0, qp_in->RSQrq + ii, 0, 0, v + ii, 0,
+                                0.0, w + ii, 0, w + ii, 0);
+        }
+        else
+        {
+            constraint_operator(qp_in, v, work->tmp_nx, work->tmp_ng);
+            constraint_operator_adjoint(qp_in, work->tmp_nx, work->tmp_ng, 0.0, w);
+        }
+
+        norm = stage_vectors_norm(qp_in, w);
+        if (norm <= ACADOS_EPS)
+            return 0.0;
+
+        for (int ii = 0; ii <= N; ii++)
+            blasfeo_dveccpsc(nu[ii] + nx[ii], 1.0 / norm, w + ii, 0, v + ii, 0);
+    }
+
+    return norm;
+}
+
+
+
+// dual step on the extrapolated primal iterate ux_bar
+static void dual_step(const ocp_qp_in *qp_in, ocp_qp_pdhg_workspace *work, double sigma)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    constraint_operator(qp_in, work->ux_bar, work->tmp_nx, work->tmp_ng);
+
+    // dynamics: equality constraints, the projection is b
+    for (int ii = 0; ii < N; ii++)
+    {
+        blasfeo_daxpy(nx[ii + 1], -1.0, qp_in->b + ii, 0, work->tmp_nx + ii, 0, work->tmp_nx + ii, 0);
+        blasfeo_daxpy(nx[ii + 1], sigma, work->tmp_nx + ii, 0, work->pi + ii, 0, work->pi + ii, 0);
+    }
+
+    // general constraints: prox of the conjugate of the indicator of [lg, ug] (Moreau)
+    for (int ii = 0; ii <= N; ii++)
+    {
+        for (int jj = 0; jj < ng[ii]; jj++)
+        {
+            double w = BLASFEO_DVECEL(work->lam_g + ii, jj) + sigma * BLASFEO_DVECEL(work->tmp_ng + ii, jj);
+            BLASFEO_DVECEL(work->lam_g + ii, jj) =
+                w - sigma * clip_to_bounds(qp_in, ii, nb[ii] + jj, 2 * nb[ii] + ng[ii] + jj, w / sigma);
+        }
+    }
+}
+
+
+
+// residuals at the current iterate, grad has to be up to date
+static void compute_residuals(const ocp_qp_in *qp_in, ocp_qp_pdhg_workspace *work,
+                              double *res_stat, double *res_eq, double *res_ineq, double *res_comp)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    double tmp;
+    *res_stat = 0.0;
+    *res_eq = 0.0;
+    *res_ineq = 0.0;
+    *res_comp = 0.0;
+
+    // stationarity: length of a projected gradient step
+    for (int ii = 0; ii <= N; ii++)
+    {
+        blasfeo_daxpby(nu[ii] + nx[ii], 1.0, work->ux + ii, 0, -1.0, work->grad + ii, 0,
+                       work->ux_bar + ii, 0);
+        project_bounds(qp_in, ii, work->ux_bar + ii);
+        blasfeo_daxpy(nu[ii] + nx[ii], -1.0, work->ux + ii, 0, work->ux_bar + ii, 0,
+                      work->ux_bar + ii, 0);
+        blasfeo_dvecnrm_inf(nu[ii] + nx[ii], work->ux_bar + ii, 0, &tmp);
+        *res_stat = MAX(*res_stat, tmp);
+    }
+
+    constraint_operator(qp_in, work->ux, work->tmp_nx, work->tmp_ng);
+
+    for (int ii = 0; ii < N; ii++)
+    {
+        blasfeo_daxpy(nx[ii + 1], -1.0, qp_in->b + ii, 0, work->tmp_nx + ii, 0, work->tmp_nx + ii, 0);
+        blasfeo_dvecnrm_inf(nx[ii + 1], work->tmp_nx + ii, 0, &tmp);
+        *res_eq = MAX(*res_eq, tmp);
+    }
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        for (int jj = 0; jj < ng[ii]; jj++)
+        {
+            double val = BLASFEO_DVECEL(work->tmp_ng + ii, jj);
+            tmp = fabs(val - clip_to_bounds(qp_in, ii, nb[ii] + jj, 2 * nb[ii] + ng[ii] + jj, val));
+            *res_ineq = MAX(*res_ineq, tmp);
+
+            // complementarity, for the bounds it holds by construction of the projection
+            double lam = BLASFEO_DVECEL(work->lam_g + ii, jj);
+            if (lam > 0.0)
+                tmp = lam * fabs(-BLASFEO_DVECEL(qp_in->d + ii, 2 * nb[ii] + ng[ii] + jj) - val);
+            else if (lam < 0.0)
+                tmp = -lam * fabs(val - BLASFEO_DVECEL(qp_in->d + ii, nb[ii] + jj));
+            else
+                tmp = 0.0;
+            *res_comp = MAX(*res_comp, tmp);
+        }
+    }
+}
+
+
+
+static void initialize_iterates(const ocp_qp_in *qp_in, const ocp_qp_out *qp_out,
+                                const ocp_qp_pdhg_opts *opts, ocp_qp_pdhg_workspace *work)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        if (opts->warm_start > 0)
+            blasfeo_dveccp(nu[ii] + nx[ii], qp_out->ux + ii, 0, work->ux + ii, 0);
+        else
+            blasfeo_dvecse(nu[ii] + nx[ii], 0.0, work->ux + ii, 0);
+
+        // lam_g = lam_ug - lam_lg
+        if (opts->warm_start > 1)
+            blasfeo_daxpby(ng[ii], 1.0, qp_out->lam + ii, 2 * nb[ii] + ng[ii], -1.0, qp_out->lam + ii,
+                           nb[ii], work->lam_g + ii, 0);
+        else
+            blasfeo_dvecse(ng[ii], 0.0, work->lam_g + ii, 0);
+    }
+
+    for (int ii = 0; ii < N; ii++)
+    {
+        // the dual iterate multiplies x_{k+1} - B_k u_k - A_k x_k, pi has the opposite sign
+        if (opts->warm_start > 1)
+            blasfeo_dveccpsc(nx[ii + 1], -1.0, qp_out->pi + ii, 0, work->pi + ii, 0);
+        else
+            blasfeo_dvecse(nx[ii + 1], 0.0, work->pi + ii, 0);
+    }
+}
+
+
+
+static void fill_in_qp_out(const ocp_qp_in *qp_in, ocp_qp_out *qp_out, ocp_qp_pdhg_workspace *work)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        blasfeo_dveccp(nu[ii] + nx[ii], work->ux + ii, 0, qp_out->ux + ii, 0);
+
+        blasfeo_dvecse(2 * nb[ii] + 2 * ng[ii], 0.0, qp_out->lam + ii, 0);
+
+        // bounds: multipliers from the gradient of the Lagrangian, on the active bounds only
+        // (the projection puts the iterate exactly on the bound)
+        for (int jj = 0; jj < nb[ii]; jj++)
+        {
+            int idx = qp_in->idxb[ii][jj];
+            double val = BLASFEO_DVECEL(work->ux + ii, idx);
+            double grad = BLASFEO_DVECEL(work->grad + ii, idx);
+            if (grad > 0.0 && BLASFEO_DVECEL(qp_in->d_mask + ii, jj) != 0.0 &&
+                val <= BLASFEO_DVECEL(qp_in->d + ii, jj))
+                BLASFEO_DVECEL(qp_out->lam + ii, jj) = grad;
+            else if (grad < 0.0 && BLASFEO_DVECEL(qp_in->d_mask + ii, nb[ii] + ng[ii] + jj) != 0.0 &&
+                     val >= -BLASFEO_DVECEL(qp_in->d + ii, nb[ii] + ng[ii] + jj))
+                BLASFEO_DVECEL(qp_out->lam + ii, nb[ii] + ng[ii] + jj) = -grad;
+        }
+
+        // general constraints: split lam_g = lam_ug - lam_lg
+        for (int jj = 0; jj < ng[ii]; jj++)
+        {
+            double lam = BLASFEO_DVECEL(work->lam_g + ii, jj);
+            if (lam > 0.0)
+                BLASFEO_DVECEL(qp_out->lam + ii, 2 * nb[ii] + ng[ii] + jj) = lam;
+            else
+                BLASFEO_DVECEL(qp_out->lam + ii, nb[ii] + jj) = -lam;
+        }
+    }
+
+    for (int ii = 0; ii < N; ii++)
+        blasfeo_dveccpsc(nx[ii + 1], -1.0, work->pi + ii, 0, qp_out->pi + ii, 0);
+
+    ocp_qp_compute_t((ocp_qp_in *) qp_in, qp_out);
+}
+
+
+
+/************************************************
+ * functions
+ ************************************************/
+
+int ocp_qp_pdhg(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, void *work_)
+{
+    ocp_qp_in *qp_in = qp_in_;
+    ocp_qp_out *qp_out = qp_out_;
+    ocp_qp_pdhg_opts *opts = opts_;
+    ocp_qp_pdhg_memory *mem = mem_;
+
+    qp_info *info = qp_out->misc;
+    acados_timer tot_timer, qp_timer;
+    acados_tic(&tot_timer);
+
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *ns = qp_in->dim->ns;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        if (ns[ii] > 0)
+        {
+            printf("\nPDHG solver can not handle ns>0 yet: what about implementing it? :)\n");
+            exit(1);
+        }
+    }
+
+    ocp_qp_pdhg_workspace *work = ocp_qp_pdhg_cast_workspace(qp_in->dim, work_);
+
+    acados_tic(&qp_timer);
+
+    initialize_iterates(qp_in, qp_out, opts, work);
+
+    // step sizes: 1/tau - sigma ||K||^2 >= ||H|| / 2 (Condat-Vu),
+    // safety factor as the power iteration underestimates the norms
+    double norm_H = 1.1 * power_iteration(qp_in, work, 1, opts->power_iter);
+    double norm_K = sqrt(1.1 * power_iteration(qp_in, work, 0, opts->power_iter));
+    if (norm_K <= ACADOS_EPS)
+        norm_K = 1.0;  // nothing to dualize
+
+    double rho = opts->rho;
+    double sigma = rho / norm_K;
+    double tau = 0.99 / (0.5 * norm_H + sigma * norm_K * norm_K);
+
+    int status = ACADOS_MAXITER;
+    double res_stat = 0.0, res_eq = 0.0, res_ineq = 0.0, res_comp = 0.0;
+    int iter;
+
+    for (iter = 0; iter <= opts->iter_max; iter++)
+    {
+        compute_gradient(qp_in, work);
+
+        // termination
+        if (iter % opts->check_every == 0 || iter == opts->iter_max)
+        {
+            compute_residuals(qp_in, work, &res_stat, &res_eq, &res_ineq, &res_comp);
+
+            if (opts->print_level > 0)
+                printf("pdhg: iter %d\tres_stat %e\tres_eq %e\tres_ineq %e\tres_comp %e\trho %e\n",
+                       iter, res_stat, res_eq, res_ineq, res_comp, rho);
+
+            if (isnan(res_stat) || isnan(res_eq) || isnan(res_ineq) || isnan(res_comp))
+            {
+                status = ACADOS_NAN_DETECTED;
+                break;
+            }
+            if (res_stat <= opts->tol_stat && res_eq <= opts->tol_eq && res_ineq <= opts->tol_ineq &&
+                res_comp <= opts->tol_comp)
+            {
+                status = ACADOS_SUCCESS;
+                break;
+            }
+            if (iter == opts->iter_max)
+                break;
+
+            // balance primal and dual progress
+            if (opts->adaptive_rho && iter > 0 && iter % (5 * opts->check_every) == 0)
+            {
+                double res_prim = MAX(res_eq, res_ineq);
+                if (res_prim > 10.0 * res_stat)
+                    rho *= 2.0;
+                else if (res_stat > 10.0 * res_prim)
+                    rho *= 0.5;
+                sigma = rho / norm_K;
+                tau = 0.99 / (0.5 * norm_H + sigma * norm_K * norm_K);
+            }
+        }
+
+        // primal step and extrapolation
+        for (int ii = 0; ii <= N; ii++)
+        {
+            blasfeo_dveccp(nu[ii] + nx[ii], work->ux + ii, 0, work->ux_prev + ii, 0);
+            blasfeo_daxpy(nu[ii] + nx[ii], -tau, work->grad + ii, 0, work->ux + ii, 0, work->ux + ii, 0);
+            project_bounds(qp_in, ii, work->ux + ii);
+            blasfeo_daxpby(nu[ii] + nx[ii], 2.0, work->ux + ii, 0, -1.0, work->ux_prev + ii, 0,
+                           work->ux_bar + ii, 0);
+        }
+
+        // dual step
+        dual_step(qp_in, work, sigma);
+    }
+
+    fill_in_qp_out(qp_in, qp_out, work);
+
+    mem->time_qp_solver_call = acados_toc(&qp_timer);
+    mem->iter = iter;
+    mem->status = status;
+    mem->rho = rho;
+    mem->res_stat = res_stat;
+    mem->res_eq = res_eq;
+    mem->res_ineq = res_ineq;
+    mem->res_comp = res_comp;
+
+    info->solve_QP_time = mem->time_qp_solver_call;
+    info->interface_time = 0;  // the solver works on ocp_qp_in directly
+    info->total_time = acados_toc(&tot_timer);
+    info->num_iter = iter;
+    info->t_computed = 1;
+
+    return status;
+}
+
+
+
+void ocp_qp_pdhg_memory_reset(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, void *work_)
+{
+    // no internal state besides statistics
+    ocp_qp_in *qp_in = qp_in_;
+    ocp_qp_pdhg_memory_assign(config_, qp_in->dim, opts_, mem_);
+}
+
+
+
+void ocp_qp_pdhg_solver_get(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, const char *field, int stage, void* value, int size1, int size2)
+{
+    printf("\nerror: ocp_qp_pdhg_solver_get: not implemented yet\n");
+    exit(1);
+}
+
+
+
+void ocp_qp_pdhg_eval_forw_sens(void *config_, void *qp_in, void *seed, void *qp_out, void *opts_, void *mem_, void *work_)
+{
+    printf("\nerror: ocp_qp_pdhg_eval_forw_sens: not implemented yet\n");
+    exit(1);
+}
+
+
+
+void ocp_qp_pdhg_eval_adj_sens(void *config_, void *qp_in, void *seed, void *qp_out, void *opts_, void *mem_, void *work_)
+{
+    printf("\nerror: ocp_qp_pdhg_eval_adj_sens: not implemented yet\n");
+    exit(1);
+}
+
+
+
+void ocp_qp_pdhg_terminate(void *config_, void *mem_, void *work_)
+{
+    return;
+}
+
+
+
+void ocp_qp_pdhg_config_initialize_default(void *config_)
+{
+    qp_solver_config *config = config_;
+
+    config->dims_set = &ocp_qp_dims_set;
+    config->opts_calculate_size = &ocp_qp_pdhg_opts_calculate_size;
+    config->opts_assign = &ocp_qp_pdhg_opts_assign;
+    config->opts_initialize_default = &ocp_qp_pdhg_opts_initialize_default;
+    config->opts_update = &ocp_qp_pdhg_opts_update;
+    config->opts_set = &ocp_qp_pdhg_opts_set;
+    config->opts_get = &ocp_qp_pdhg_opts_get;
+    config->memory_calculate_size = &ocp_qp_pdhg_memory_calculate_size;
+    config->memory_assign = &ocp_qp_pdhg_memory_assign;
+    config->memory_get = &ocp_qp_pdhg_memory_get;
+    config->workspace_calculate_size = &ocp_qp_pdhg_workspace_calculate_size;
+    config->evaluate = &ocp_qp_pdhg;
+    config->solver_get = &ocp_qp_pdhg_solver_get;
+    config->memory_reset = &ocp_qp_pdhg_memory_reset;
+    config->eval_forw_sens = &ocp_qp_pdhg_eval_forw_sens;
+    config->eval_adj_sens = &ocp_qp_pdhg_eval_adj_sens;
+    config->terminate = &ocp_qp_pdhg_terminate;
+
+    return;
+}
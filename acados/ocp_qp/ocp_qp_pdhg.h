@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+#ifndef ACADOS_OCP_QP_OCP_QP_PDHG_H_
+#define ACADOS_OCP_QP_OCP_QP_PDHG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// blasfeo
+#include "blasfeo_common.h"
+// acados
+#include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/utils/types.h"
+
+
+
+// Primal-dual hybrid gradient (Condat-Vu) method on the stage structure of the OCP QP.
+// Cost and constraints are applied block-wise from RSQrq, BAbt and DCt, bounds are handled by
+// projection, the dynamics and general constraints are dualized.
+// No factorization and no global matrix are formed, one iteration costs a few matrix-vector
+// products per stage.
+
+// struct of arguments to the solver
+typedef struct ocp_qp_pdhg_opts_
+{
+    double tol_stat;   // exit tolerance on the projected gradient
+    double tol_eq;     // exit tolerance on the dynamics residual
+    double tol_ineq;   // exit tolerance on the violation of general constraints
+    double tol_comp;   // exit tolerance on the complementarity of general constraints
+    double rho;        // ratio of dual and primal step size (scaled by the norm of the constraints)
+    int iter_max;
+    int warm_start;    // 0: cold start, 1: primal from qp_out, 2: primal and dual from qp_out
+    int adaptive_rho;  // balance primal and dual residuals by adapting rho
+    int check_every;   // number of iterations between termination checks
+    int power_iter;    // number of power iterations to estimate the operator norms
+    int print_level;
+} ocp_qp_pdhg_opts;
+
+
+
+// struct of the solver memory
+typedef struct ocp_qp_pdhg_memory_
+{
+    double time_qp_solver_call;
+    double rho;        // rho at exit
+    double res_stat;
+    double res_eq;
+    double res_ineq;
+    double res_comp;
+    int iter;
+    int status;
+} ocp_qp_pdhg_memory;
+
+
+
+typedef struct ocp_qp_pdhg_workspace_
+{
+    struct blasfeo_dvec *ux;       // primal iterate
+    struct blasfeo_dvec *ux_prev;  // previous primal iterate
+    struct blasfeo_dvec *ux_bar;   // extrapolated primal iterate
+    struct blasfeo_dvec *grad;     // gradient of the Lagrangian
+    struct blasfeo_dvec *pi;       // multipliers of the dynamics
+    struct blasfeo_dvec *lam_g;    // multipliers of the general constraints (upper - lower)
+    struct blasfeo_dvec *tmp_nx;   // dynamics residual
+    struct blasfeo_dvec *tmp_ng;   // general constraints evaluation
+} ocp_qp_pdhg_workspace;
+
+
+
+//
+acados_size_t ocp_qp_pdhg_opts_calculate_size(void *config, void *dims);
+//
+void *ocp_qp_pdhg_opts_assign(void *config, void *dims, void *raw_memory);
+//
+void ocp_qp_pdhg_opts_initialize_default(void *config, void *dims, void *opts_);
+//
+void ocp_qp_pdhg_opts_update(void *config, void *dims, void *opts_);
+//
+void ocp_qp_pdhg_opts_set(void *config_, void *opts_, const char *field, void *value);
+//
+void ocp_qp_pdhg_opts_get(void *config_, void *opts_, const char *field, void *value);
+//
+acados_size_t ocp_qp_pdhg_memory_calculate_size(void *config, void *dims, void *opts_);
+//
+void *ocp_qp_pdhg_memory_assign(void *config, void *dims, void *opts_, void *raw_memory);
+//
+void ocp_qp_pdhg_memory_get(void *config_, void *mem_, const char *field, void* value);
+//
+acados_size_t ocp_qp_pdhg_workspace_calculate_size(void *config, void *dims, void *opts_);
+//
+int ocp_qp_pdhg(void *config, void *qp_in, void *qp_out, void *opts_, void *mem_, void *work_);
+//
+void ocp_qp_pdhg_memory_reset(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, void *work_);
+//
+void ocp_qp_pdhg_solver_get(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, const char *field, int stage, void* value, int size1, int size2);
+//
+void ocp_qp_pdhg_eval_forw_sens(void *config_, void *qp_in, void *seed, void *qp_out, void *opts_, void *mem_, void *work_);
+//
+void ocp_qp_pdhg_eval_adj_sens(void *config_, void *qp_in, void *seed, void *qp_out, void *opts_, void *mem_, void *work_);
+//
+void ocp_qp_pdhg_terminate(void *config, void *mem_, void *work_);
+//
+void ocp_qp_pdhg_config_initialize_default(void *config);
+
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_OCP_QP_OCP_QP_PDHG_H_
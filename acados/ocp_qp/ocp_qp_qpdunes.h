@@ -55,6 +55,8 @@ typedef struct ocp_qp_qpdunes_opts_
     qpOptions_t options;
     qpdunes_stage_qp_solver_t stageQpSolver;
     int warmstart;  // warmstart = 0: all multipliers set to zero, warmstart = 1: use previous mult.
+    // constant matrices: only the bounds of the first interval are updated after the first QP,
+    // this covers the unchanged matrix case, so there is no skip_unchanged as for OSQP and DAQP
     bool isLinearMPC;
 } ocp_qp_qpdunes_opts;
 
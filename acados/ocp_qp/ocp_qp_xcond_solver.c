@@ -307,7 +307,15 @@ void ocp_qp_xcond_solver_opts_get_(void *config_, void *opts_, const char *field
     qp_solver_config *qp_solver = config->qp_solver;
     // ocp_qp_xcond_config *xcond = config->xcond;
 
-    qp_solver->opts_get(qp_solver, opts->qp_solver_opts, field, value);
+    if (!strcmp(field, "initialize_next_xcond_qp_from_qp_out"))
+    {
+        bool *initialize_next_xcond_qp_from_qp_out = (bool *) value;
+        *initialize_next_xcond_qp_from_qp_out = opts->initialize_next_xcond_qp_from_qp_out;
+    }
+    else
+    {
+        qp_solver->opts_get(qp_solver, opts->qp_solver_opts, field, value);
+    }
 
     return;
 }
@@ -438,7 +446,31 @@ void ocp_qp_xcond_solver_memory_get(void *config_, void *mem_, const char *field
     {
         qp_solver->memory_get(qp_solver, mem->solver_memory, field, value);
     }
-    else if (!strcmp(field, "time_qp_xcond"))
+    else if (!strcmp(field, "as_cache_hit") || !strcmp(field, "as_cache_num_hits"))
+    {
+        qp_solver->memory_get(qp_solver, mem->solver_memory, field, value);
+    }
+    else if (!strcmp(field, "refine_iter") || !strcmp(field, "refine_fallback"))
+    {
+        qp_solver->memory_get(qp_solver, mem->solver_memory, field, value);
+    }
+    else if (!strcmp(field, "matrices_changed"))
+    {
+        qp_solver->memory_get(qp_solver, mem->solver_memory, field, value);
+    }
+    else if (!strcmp(field, "P_nnz") || !strcmp(field, "A_nnz"))
+    {
+        qp_solver->memory_get(qp_solver, mem->solver_memory, field, value);
+    }
+    else if (!strcmp(field, "num_segments"))
+    {
+        qp_solver->memory_get(qp_solver, mem->solver_memory, field, value);
+    }
+    else if (!strcmp(field, "res_comp"))
+    {
+        qp_solver->memory_get(qp_solver, mem->solver_memory, field, value);
+    }
+    else if (!strcmp(field, "time_qp_xcond") || !strcmp(field, "lhs_changed"))
     {
         xcond->memory_get(xcond, mem->xcond_memory, field, value);
     }
@@ -332,132 +332,276 @@ static void gauss_radau_iia_nodes(int ns, double *nodes, void *work)
     }
 }
 
-// acados_size_t gauss_simplified_work_calculate_size(int ns)
-// {
-//     acados_size_t size = 0;
-
-//     size += 1 * 2 * ns * sizeof(double);   // D
-//     size += 3 * ns * ns * sizeof(double);  // T, T_inv, lu_work
-
-//     size += 1 * ns * sizeof(int);  // perm
-
-//     return size;
-// }
-
-
-// // TODO(all): understand how this works and leave a comment!
-// void gauss_simplified(int ns, Newton_scheme *scheme, void *work)
-// {
-//     char *c_ptr = work;
-
-//     // D
-//     double *D = (double *) c_ptr;
-//     c_ptr += 2 * ns * sizeof(double);
-//     // T
-//     double *T = (double *) c_ptr;
-//     c_ptr += ns * ns * sizeof(double);
-//     // T_inv
-//     double *T_inv = (double *) c_ptr;
-//     c_ptr += ns * ns * sizeof(double);
-//     // lu_work
-//     double *lu_work = (double *) c_ptr;
-//     c_ptr += ns * ns * sizeof(double);
-//     // perm
-//     int *perm = (int *) c_ptr;
-//     c_ptr += ns * sizeof(int);
-
-//     assert((char *) work + gauss_simplified_work_calculate_size(ns) >= c_ptr);
-
-//     char simplified[MAX_STR_LEN];
-
-//     snprintf(simplified, sizeof(simplified), "simplified/GL%d_simpl_%s.txt", 2 * ns, "D");
-//     read_matrix(simplified, D, ns, 2);
-
-//     snprintf(simplified, sizeof(simplified), "simplified/GL%d_simpl_%s.txt", 2 * ns, "T");
-//     read_matrix(simplified, T, ns, ns);
-
-//     scheme->single = false;
-//     scheme->low_tria = 0;
-//     for (int i = 0; i < ns; i++)
-//     {
-//         scheme->eig[i] = D[i];
-//     }
-//     for (int i = 0; i < ns * ns; i++)
-//     {
-//         scheme->transf2[i] = T[i];
-//     }
-//     // transf1_T:
-//     for (int i = 0; i < ns; i++)
-//     {
-//         if ((i + 1) < ns)
-//         {  // complex conjugate pair of eigenvalues
-//             for (int i1 = i; i1 < i + 2; i1++)
-//             {
-//                 for (int i2 = 0; i2 < ns; i2++)
-//                 {
-//                     scheme->transf1_T[i2 * ns + i1] = 0.0;
-//                     for (int i3 = 0; i3 < 2; i3++)
-//                     {
-//                         scheme->transf1_T[i2 * ns + i1] +=
-//                             D[(i1 - i) * ns + (i + i3)] * T[(i + i3) * ns + i2];
-//                     }
-//                 }
-//             }
-//             i++;
-//         }
-//         else
-//         {  // real eigenvalue
-//             for (int i2 = 0; i2 < ns; i2++)
-//             {
-//                 scheme->transf1_T[i2 * ns + i] = D[i] * T[i * ns + i2];
-//             }
-//         }
-//     }
-
-//     for (int i = 0; i < ns; i++)
-//     {
-//         T_inv[i * (ns + 1)] = 1.0;
-//     }
-
-//     lu_system_solve(T, T_inv, perm, ns, ns, lu_work);
-
-//     // transf1:
-//     for (int i = 0; i < ns; i++)
-//     {
-//         if ((i + 1) < ns)
-//         {  // complex conjugate pair of eigenvalues
-//             for (int i1 = i; i1 < i + 2; i1++)
-//             {
-//                 for (int i2 = 0; i2 < ns; i2++)
-//                 {
-//                     scheme->transf1[i2 * ns + i1] = 0.0;
-//                     for (int i3 = 0; i3 < 2; i3++)
-//                     {
-//                         scheme->transf1[i2 * ns + i1] += D[i3 * ns + i1] * T_inv[i2 * ns + i + i3];
-//                     }
-//                 }
-//             }
-//             i++;
-//         }
-//         else
-//         {  // real eigenvalue
-//             for (int i2 = 0; i2 < ns; i2++)
-//             {
-//                 scheme->transf1[i2 * ns + i] = D[i] * T_inv[i2 * ns + i];
-//             }
-//         }
-//     }
-//     // transf2_T:
-//     for (int i = 0; i < ns; i++)
-//     {
-//         for (int i2 = 0; i2 < ns; i2++)
-//         {
-//             scheme->transf2_T[i2 * ns + i] = T_inv[i * ns + i2];
-//         }
-//     }
-
-//     return;
-// }
+/* real block diagonalization of the inverse Gauss-Legendre Butcher matrix for simplified Newton,
+ * generated from acados/sim/simplified/GL<2*ns>_simpl_{D,T}.txt;
+ * T^{-1} A^{-1} T = blkdiag(D) for the (decreasing) node order of gauss_legendre_nodes,
+ * D holds [alpha, beta; -beta, alpha] for a complex pair and [gamma, 0] for a real eigenvalue */
+
+static const double GL4_simpl_D[] = {
+    2.9999999999999996e+00, 1.7320508075688772e+00,
+    -1.7320508075688772e+00, 2.9999999999999996e+00,
+};
+static const double GL4_simpl_T[] = {
+    9.6592582628906842e-01, 0.0000000000000000e+00,
+    -6.6359915501009627e-17, -2.5881904510252079e-01,
+};
+
+static const double GL6_simpl_D[] = {
+    3.6778146453739247e+00, 3.5087619195674487e+00,
+    -3.5087619195674487e+00, 3.6778146453739247e+00,
+    4.6443707092521676e+00, 0.0000000000000000e+00,
+};
+static const double GL6_simpl_T[] = {
+    -9.4780144954483625e-01, 0.0000000000000000e+00, 9.9047432157564597e-01,
+    -5.0295169925554134e-02, 2.9969960581658434e-01, 1.1770061780985283e-01,
+    7.7948357550038094e-02, -5.6982523211086947e-02, 7.1464556714800287e-02,
+};
+
+static const double GL8_simpl_D[] = {
+    4.2075787943592218e+00, 5.3148360837135682e+00,
+    -5.3148360837135682e+00, 4.2075787943592218e+00,
+    5.7924212056407534e+00, 1.7344682578688573e+00,
+    -1.7344682578688573e+00, 5.7924212056407534e+00,
+};
+static const double GL8_simpl_T[] = {
+    9.2755121578442024e-01, 0.0000000000000000e+00, 9.7688646208845364e-01, 0.0000000000000000e+00,
+    8.9973980766129363e-02, -3.3944980848817574e-01, 1.7926761499828683e-01, -1.0940228267310095e-01,
+    -1.1347923253170784e-01, 3.6496686603583427e-02, 2.7865866968752602e-02, -1.1762625061477404e-02,
+    4.5676938944744824e-02, 5.5969008293203868e-03, -1.2056498009687994e-02, -2.2953821305620972e-02,
+};
+
+static const double GL10_simpl_D[] = {
+    4.6493486063632918e+00, 7.1420458406761096e+00,
+    -7.1420458406761096e+00, 4.6493486063632918e+00,
+    6.7039127983069431e+00, 3.4853228323661725e+00,
+    -3.4853228323661725e+00, 6.7039127983069431e+00,
+    7.2934771906594484e+00, 0.0000000000000000e+00,
+};
+static const double GL10_simpl_T[] = {
+    9.0411743519846155e-01, 0.0000000000000000e+00, 9.5735008970684399e-01, 0.0000000000000000e+00,
+    9.6857461611736728e-01,
+    1.3001130604337371e-01, -3.7516554615897674e-01, 2.2355134850458269e-01, -1.7841467946953624e-01,
+    2.4484872919812409e-01,
+    -1.4426917672856002e-01, 1.1719339710664150e-02, -7.6582332554709395e-04, -3.5728186480685452e-02,
+    4.2697767969383175e-02,
+    4.9645019802481961e-02, 2.9204111659184805e-02, -5.7681622599773828e-03, -1.5214920129763956e-02,
+    -2.7678875562257808e-03,
+    -1.7761143010428849e-02, -1.8320263073173172e-02, -4.6086692807295335e-03, 1.0521756143668244e-02,
+    9.0306274459175748e-03,
+};
+
+static const double GL12_simpl_D[] = {
+    5.0318644956231697e+00, 8.9853459073092949e+00,
+    -8.9853459073092949e+00, 5.0318644956231697e+00,
+    7.4714167126486739e+00, 5.2525446228892765e+00,
+    -5.2525446228892765e+00, 7.4714167126486739e+00,
+    8.4967187917271758e+00, 1.7350193464772943e+00,
+    -1.7350193464772943e+00, 8.4967187917271758e+00,
+};
+static const double GL12_simpl_T[] = {
+    8.7808321708605108e-01, 0.0000000000000000e+00, 9.3555909275336069e-01, 0.0000000000000000e+00,
+    -9.5290824432258980e-01, 0.0000000000000000e+00,
+    1.7174076768258004e-01, -4.0377104892106513e-01, 2.6160744979570577e-01, -2.2709825698006320e-01,
+    -2.8978071413392414e-01, 7.3038588927541351e-02,
+    -1.7285671470878081e-01, -1.9069352853084826e-02, -2.1776505510137125e-02, -6.3546793662303272e-02,
+    -4.3552536808886155e-02, 2.5902104391501039e-02,
+    4.5557282850813216e-02, 5.3353030317658423e-02, -7.6298439875653557e-03, -5.5741760896124990e-03,
+    -8.8079797671061257e-04, 8.0762161273007990e-03,
+    -9.6857867134837114e-03, -3.0662337246238010e-02, -6.0493347690819075e-03, 6.6963839946151136e-03,
+    -2.8029695104241927e-03, -1.6020585539541729e-03,
+    1.9576377675118153e-03, 1.5523884904491846e-02, 5.4656523812362558e-03, -2.0251798596873515e-03,
+    2.2458329838366277e-03, 3.0281353437578078e-03,
+};
+
+static const double GL14_simpl_D[] = {
+    5.3713537578876096e+00, 1.0841388261432224e+01,
+    -1.0841388261432224e+01, 5.3713537578876096e+00,
+    8.1402783272844630e+00, 7.0343480954312403e+00,
+    -7.0343480954312403e+00, 8.1402783272844630e+00,
+    9.5165810562800210e+00, 3.4785721222551111e+00,
+    -3.4785721222551111e+00, 9.5165810562800210e+00,
+    9.9435737170944289e+00, 0.0000000000000000e+00,
+};
+static const double GL14_simpl_T[] = {
+    -8.5035232043588049e-01, 0.0000000000000000e+00, 9.1265021040563343e-01, 0.0000000000000000e+00,
+    9.3458122311122016e-01, 0.0000000000000000e+00, 9.4055978178044097e-01,
+    -2.1450814053661496e-01, 4.2359825665884765e-01, 2.9646814693794837e-01, -2.6195033155582120e-01,
+    3.2554787900384219e-01, -1.2513074581231315e-01, 3.3334883004868687e-01,
+    1.9735124680638266e-01, 5.6667545179045979e-02, -3.7257049634525086e-02, -9.4173302982180893e-02,
+    4.1269009800451721e-02, -5.5313477792228664e-02, 6.4554598012522474e-02,
+    -3.4525786839946324e-02, -7.8082400186207129e-02, -1.4836403119515500e-02, 3.0532524084083915e-03,
+    -9.5750612141811580e-04, -1.2080269976410070e-02, 6.8848385937857201e-03,
+    -3.7480270774970146e-03, 3.8607888395597902e-02, -4.0010474121755834e-03, 4.2899287529169485e-03,
+    -9.4442722610532355e-04, 9.1133366716706233e-04, 2.6598298604616926e-03,
+    7.2456359325201647e-03, -1.8461670570721598e-02, 5.1932873031154004e-03, 3.5806307043106028e-04,
+    -2.6136489066373248e-04, -2.0653078214020217e-03, -1.3756710316336618e-03,
+    -4.9583105855061016e-03, 9.0307885858180396e-03, -3.0042076223673322e-03, -1.2568098411682735e-03,
+    -3.7222800640570127e-04, 1.7480751994739369e-03, 1.4799018907661063e-03,
+};
+
+static const double GL16_simpl_D[] = {
+    5.6779678978367674e+00, 1.2707822597247784e+01,
+    -1.2707822597247784e+01, 5.6779678978367674e+00,
+    8.7365784339057306e+00, 8.8288850008925976e+00,
+    -8.8288850008925976e+00, 8.7365784339057306e+00,
+    1.0409681582375107e+01, 5.2323503048572375e+00,
+    -5.2323503048572375e+00, 1.0409681582375107e+01,
+    1.1175772085918894e+01, 1.7352288916565461e+00,
+    -1.7352288916565461e+00, 1.1175772085918894e+01,
+};
+static const double GL16_simpl_T[] = {
+    8.2193585582411233e-01, 0.0000000000000000e+00, -8.8931582451607150e-01, 0.0000000000000000e+00,
+    -9.1512355767925158e-01, 0.0000000000000000e+00, 9.2522599677736594e-01, 0.0000000000000000e+00,
+    2.5695191289628649e-01, -4.3397322144122358e-01, -3.2882588278748548e-01, 2.8603256021290585e-01,
+    -3.5608185529462405e-01, 1.6304756704893719e-01, 3.6647984402997824e-01, -5.3056290502956398e-02,
+    -2.1531057258483430e-01, -1.0045115052637008e-01, 4.7412923022494252e-02, 1.2685013315140561e-01,
+    -3.9264932617492761e-02, 8.5681802522811726e-02, 7.6251584480502163e-02, -2.9542231221371132e-02,
+    1.5720097174868292e-02, 1.0192116246093680e-01, 2.6310018504678262e-02, -9.8324966248575178e-03,
+    6.4813850227712173e-03, 1.5247456534805637e-02, 8.8743434172925319e-03, -8.0170353162528803e-03,
+    2.0911795842842178e-02, -4.1952919437378396e-02, 5.2667515379907872e-04, -4.3205079373658485e-03,
+    3.0337745103532049e-03, -5.4819094479204033e-04, 1.3922869826198865e-03, -7.9721274818788843e-04,
+    -1.7389482320966636e-02, 1.6030277877054053e-02, -3.7687869141313324e-03, -1.2389189547245235e-03,
+    -4.4445395875414512e-04, 6.2355066960449333e-04, -4.8940907885001062e-04, -7.4326683631171760e-04,
+    1.1236032025475818e-02, -6.7973400339616007e-03, 2.0093487142945608e-03, 2.4296418392114397e-03,
+    8.3666729513345644e-04, -9.0665413105449160e-04, 5.3987606222104245e-04, 4.9296710287674225e-04,
+    -6.4405756745805273e-03, 3.1044321477736946e-03, -8.5879141228368974e-04, -1.7549768582465566e-03,
+    -7.8577242811880854e-04, 4.9775715568057925e-04, -4.2882093245944554e-04, -5.0010930894975661e-04,
+};
+
+static const double GL18_simpl_D[] = {
+    5.9585215966711083e+00, 1.4582927377244966e+01,
+    -1.4582927377244966e+01, 5.9585215966711083e+00,
+    9.2768797702648644e+00, 1.0634543347748068e+01,
+    -1.0634543347748068e+01, 9.2768797702648644e+00,
+    1.1208843659694733e+01, 6.9963138450570330e+00,
+    -6.9963138450570330e+00, 1.1208843659694733e+01,
+    1.2258735757003109e+01, 3.4756967561812870e+00,
+    -3.4756967561812870e+00, 1.2258735757003109e+01,
+    1.2594038432460025e+01, 0.0000000000000000e+00,
+};
+static const double GL18_simpl_T[] = {
+    -7.9384250663601219e-01, 0.0000000000000000e+00, 8.6610261525994126e-01, 0.0000000000000000e+00,
+    -8.9529062622024524e-01, 0.0000000000000000e+00, 9.0860718434217347e-01, 0.0000000000000000e+00,
+    -9.1255025964651593e-01,
+    -2.9742497850721861e-01, 4.3510819292042968e-01, 3.5859837446935416e-01, -3.0131979735734976e-01,
+    -3.8289128779215392e-01, 1.9047468187400898e-01, 3.9362136386700247e-01, -9.2459474364991828e-02,
+    -3.9673481968343782e-01,
+    2.2460684386815194e-01, 1.4868443687827645e-01, -5.2066663574374783e-02, -1.6058246472476828e-01,
+    -3.9057525194806250e-02, 1.1595785351155380e-01, 8.4251374326292219e-02, -5.9356852445781871e-02,
+    -9.8017218221753841e-02,
+    1.1161682429223682e-02, -1.2247643742023198e-01, -4.1340124048056759e-02, 1.3932057977604734e-02,
+    1.4616104678174636e-02, 1.8965580260949778e-02, 7.6262373680541376e-03, -1.6180507738921521e-02,
+    -1.5496079709197074e-02,
+    -4.0671877871012348e-02, 3.9401916831758248e-02, 3.2916099269817609e-03, 6.9646400088144919e-03,
+    4.5033935639012309e-03, -1.1115224521292206e-03, -2.2933663796857292e-04, -1.9991220241953409e-03,
+    -2.3810107162980602e-03,
+    2.6737473182080997e-02, -8.9676937550279452e-03, 2.5812306611151890e-03, 7.2151287212455779e-04,
+    -5.7484040554017866e-04, -4.7966889823557293e-04, -2.4370348999050843e-04, -6.5613727299974520e-04,
+    6.7074588841508433e-05,
+    -1.5477002921820037e-02, 8.7349562388396105e-04, -8.5151233234706189e-04, -2.5088178386964534e-03,
+    6.2584520647701819e-04, -1.8716206869855815e-04, -2.7042771856001551e-05, 3.8701551541923013e-04,
+    -3.8420526509612695e-04,
+    9.1220807918937514e-03, 8.6322018398742994e-04, -1.3357708895478496e-04, 1.9943371519718844e-03,
+    -7.3523837601871501e-04, 4.9557988506226792e-06, -1.3614229048934513e-05, -4.0045363899854532e-04,
+    3.2460930147416666e-04,
+    -5.0931271451387797e-03, -8.5880328675818902e-04, 2.9911796416404499e-04, -1.2015346514997927e-03,
+    5.0968043309344120e-04, 1.0216917939076941e-04, -3.4452339279522420e-05, 3.2014804927610758e-04,
+    -2.7607902116190430e-04,
+};
+
+acados_size_t gauss_simplified_work_calculate_size(int ns)
+{
+    acados_size_t size = 0;
+
+    size += 3 * ns * ns * sizeof(double);  // V, V_inv, lu_work
+    size += 1 * ns * sizeof(int);  // perm
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+void gauss_simplified(int ns, double *eig, double *transf1, double *transf2, void *work)
+{
+    int i, j, k;
+
+    char *c_ptr = work;
+
+    // V
+    double *V = (double *) c_ptr;
+    c_ptr += ns * ns * sizeof(double);
+    // V_inv
+    double *V_inv = (double *) c_ptr;
+    c_ptr += ns * ns * sizeof(double);
+    // lu_work
+    double *lu_work = (double *) c_ptr;
+    c_ptr += ns * ns * sizeof(double);
+    // perm
+    int *perm = (int *) c_ptr;
+    c_ptr += ns * sizeof(int);
+
+    assert((char *) work + gauss_simplified_work_calculate_size(ns) >= c_ptr);
+
+    const double *D;
+    const double *T;
+
+    switch (ns)
+    {
+        case 1:
+            // A = 1/2
+            eig[0] = 2.0;
+            eig[1] = 0.0;
+            transf1[0] = 2.0;
+            transf2[0] = 1.0;
+            return;
+        case 2: D = GL4_simpl_D; T = GL4_simpl_T; break;
+        case 3: D = GL6_simpl_D; T = GL6_simpl_T; break;
+        case 4: D = GL8_simpl_D; T = GL8_simpl_T; break;
+        case 5: D = GL10_simpl_D; T = GL10_simpl_T; break;
+        case 6: D = GL12_simpl_D; T = GL12_simpl_T; break;
+        case 7: D = GL14_simpl_D; T = GL14_simpl_T; break;
+        case 8: D = GL16_simpl_D; T = GL16_simpl_T; break;
+        case 9: D = GL18_simpl_D; T = GL18_simpl_T; break;
+        default:
+            printf("\nerror: gauss_simplified: ns = %d not supported, ns <= %d required\n",
+                   ns, GAUSS_SIMPLIFIED_NS_MAX);
+            exit(1);
+    }
+
+    for (i = 0; i < 2 * ns; i++)
+        eig[i] = D[i];
+
+    // A^{-1} = V blkdiag(D) V^{-1}, V = T stored column-major
+    for (j = 0; j < ns; j++)
+    {
+        for (i = 0; i < ns; i++)
+        {
+            V[i + ns * j] = T[i * ns + j];
+            transf2[i + ns * j] = V[i + ns * j];
+            V_inv[i + ns * j] = i == j ? 1.0 : 0.0;
+        }
+    }
+
+    lu_system_solve(V, V_inv, perm, ns, ns, lu_work);
+
+    // transf1 = blkdiag(D) V^{-1}
+    for (i = 0; i < ns; i++)
+    {
+        // first row of the diagonal block containing row i
+        int i0 = (i % 2 == 0) ? i : i - 1;
+        int nb = (i0 + 1 < ns) ? 2 : 1;
+        for (j = 0; j < ns; j++)
+        {
+            transf1[i + ns * j] = 0.0;
+            for (k = 0; k < nb; k++)
+                transf1[i + ns * j] += D[2 * i + k] * V_inv[i0 + k + ns * j];
+        }
+    }
+
+    return;
+}
 
 
 
@@ -469,8 +613,10 @@ acados_size_t butcher_tableau_work_calculate_size(int ns)
     size += 1 * ns * sizeof(int);  // perm
 
     acados_size_t size_legendre = gauss_legendre_nodes_work_calculate_size(ns);
+    acados_size_t size_simplified = gauss_simplified_work_calculate_size(ns);
 
     size = size > size_legendre ? size : size_legendre;
+    size = size > size_simplified ? size : size_simplified;
     make_int_multiple_of(8, &size);
 
     return size;
@@ -646,3 +792,69 @@ void get_explicit_butcher_tableau(int ns, double *A, double *b, double *c)
         }
     }
 }
+
+
+
+void get_dormand_prince_tableau(double *A, double *b, double *c, double *e)
+{
+    const int ns = 7;
+
+    for (int ii = 0; ii < ns*ns; ii++)
+        A[ii] = 0.0;
+
+    // A
+    A[1 + ns * 0] = 1.0 / 5.0;
+
+    A[2 + ns * 0] = 3.0 / 40.0;
+    A[2 + ns * 1] = 9.0 / 40.0;
+
+    A[3 + ns * 0] = 44.0 / 45.0;
+    A[3 + ns * 1] = -56.0 / 15.0;
+    A[3 + ns * 2] = 32.0 / 9.0;
+
+    A[4 + ns * 0] = 19372.0 / 6561.0;
+    A[4 + ns * 1] = -25360.0 / 2187.0;
+    A[4 + ns * 2] = 64448.0 / 6561.0;
+    A[4 + ns * 3] = -212.0 / 729.0;
+
+    A[5 + ns * 0] = 9017.0 / 3168.0;
+    A[5 + ns * 1] = -355.0 / 33.0;
+    A[5 + ns * 2] = 46732.0 / 5247.0;
+    A[5 + ns * 3] = 49.0 / 176.0;
+    A[5 + ns * 4] = -5103.0 / 18656.0;
+
+    // last stage evaluates the solution (FSAL)
+    A[6 + ns * 0] = 35.0 / 384.0;
+    A[6 + ns * 1] = 0.0;
+    A[6 + ns * 2] = 500.0 / 1113.0;
+    A[6 + ns * 3] = 125.0 / 192.0;
+    A[6 + ns * 4] = -2187.0 / 6784.0;
+    A[6 + ns * 5] = 11.0 / 84.0;
+
+    // b, 5th order
+    b[0] = 35.0 / 384.0;
+    b[1] = 0.0;
+    b[2] = 500.0 / 1113.0;
+    b[3] = 125.0 / 192.0;
+    b[4] = -2187.0 / 6784.0;
+    b[5] = 11.0 / 84.0;
+    b[6] = 0.0;
+
+    // c
+    c[0] = 0.0;
+    c[1] = 1.0 / 5.0;
+    c[2] = 3.0 / 10.0;
+    c[3] = 4.0 / 5.0;
+    c[4] = 8.0 / 9.0;
+    c[5] = 1.0;
+    c[6] = 1.0;
+
+    // e = b - b_hat, with b_hat the embedded 4th order weights
+    e[0] = 71.0 / 57600.0;
+    e[1] = 0.0;
+    e[2] = -71.0 / 16695.0;
+    e[3] = 71.0 / 1920.0;
+    e[4] = -17253.0 / 339200.0;
+    e[5] = 22.0 / 525.0;
+    e[6] = -1.0 / 40.0;
+}
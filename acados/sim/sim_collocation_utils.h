@@ -65,6 +65,10 @@ extern "C" {
 // } Newton_scheme;
 
 
+// maximum number of stages for which the simplified Newton transformation is available
+#define GAUSS_SIMPLIFIED_NS_MAX 9
+
+
 typedef enum
 {
     GAUSS_LEGENDRE,
@@ -78,9 +82,11 @@ typedef enum
 //
 // void gauss_legendre_nodes(int ns, double *nodes, void *raw_memory);
 //
-// acados_size_t gauss_simplified_work_calculate_size(int ns);
-// //
-// void gauss_simplified(int ns, Newton_scheme *scheme, void *work);
+acados_size_t gauss_simplified_work_calculate_size(int ns);
+// real block diagonalization A^{-1} = transf2 * blkdiag(eig) * transf2^{-1} of the Gauss-Legendre
+// Butcher matrix, transf1 = blkdiag(eig) * transf2^{-1}; eig is (ns x 2) row-major, holding
+// [alpha, beta; -beta, alpha] for a complex pair and [gamma, 0] for a real eigenvalue
+void gauss_simplified(int ns, double *eig, double *transf1, double *transf2, void *work);
 //
 acados_size_t butcher_tableau_work_calculate_size(int ns);
 //
@@ -91,6 +97,8 @@ void calculate_butcher_tableau(int ns, sim_collocation_type collocation_type, do
 
 //
 void get_explicit_butcher_tableau(int ns, double *A, double *b, double *c);
+// Dormand-Prince 5(4) tableau with 7 stages, e = b - b_hat holds the embedded error weights
+void get_dormand_prince_tableau(double *A, double *b, double *c, double *e);
 
 
 
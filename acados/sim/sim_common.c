@@ -31,6 +31,7 @@
 
 // standard
 #include <assert.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -478,6 +479,11 @@ void sim_opts_set_(sim_opts *opts, const char *field, void *value)
         bool *jac_reuse = (bool *) value;
         opts->jac_reuse = *jac_reuse;
     }
+    else if (!strcmp(field, "simplified_newton"))
+    {
+        bool *simplified_newton = (bool *) value;
+        opts->simplified_newton = *simplified_newton;
+    }
     else if (!strcmp(field, "cost_computation"))
     {
         bool *cost_computation = (bool *) value;
@@ -528,6 +534,46 @@ void sim_opts_set_(sim_opts *opts, const char *field, void *value)
         double *newton_tol = value;
         opts->newton_tol = *newton_tol;
     }
+    else if (!strcmp(field, "jac_reuse_across_calls"))
+    {
+        bool *jac_reuse_across_calls = (bool *) value;
+        opts->jac_reuse_across_calls = *jac_reuse_across_calls;
+    }
+    else if (!strcmp(field, "sens_jac_reuse"))
+    {
+        bool *sens_jac_reuse = (bool *) value;
+        opts->sens_jac_reuse = *sens_jac_reuse;
+    }
+    else if (!strcmp(field, "jac_reuse_contraction_max"))
+    {
+        double *jac_reuse_contraction_max = value;
+        opts->jac_reuse_contraction_max = *jac_reuse_contraction_max;
+    }
+    else if (!strcmp(field, "jac_reuse_step_rtol"))
+    {
+        double *jac_reuse_step_rtol = value;
+        opts->jac_reuse_step_rtol = *jac_reuse_step_rtol;
+    }
+    else if (!strcmp(field, "adaptive_step"))
+    {
+        bool *adaptive_step = (bool *) value;
+        opts->adaptive_step = *adaptive_step;
+    }
+    else if (!strcmp(field, "num_steps_max"))
+    {
+        int *num_steps_max = (int *) value;
+        if (*num_steps_max < 1)
+        {
+            printf("\nerror: sim_opts_set_: num_steps_max has to be positive, got %d\n", *num_steps_max);
+            exit(1);
+        }
+        opts->num_steps_max = *num_steps_max;
+    }
+    else if (!strcmp(field, "step_tol"))
+    {
+        double *step_tol = value;
+        opts->step_tol = *step_tol;
+    }
     else
     {
         printf("\nerror: field %s not available in sim_opts_set_\n", field);
@@ -569,3 +615,126 @@ void sim_opts_get_(sim_config *config, sim_opts *opts, const char *field, void *
 
     return;
 }
+
+
+
+int sim_opts_steps_max(sim_opts *opts)
+{
+    if (opts->adaptive_step)
+        return opts->num_steps_max > opts->num_steps ? opts->num_steps_max : opts->num_steps;
+    return opts->num_steps;
+}
+
+
+
+double sim_step_error_norm(int n, const double *err, const double *x0, const double *x1, double tol)
+{
+    double sum = 0.0;
+    for (int ii = 0; ii < n; ii++)
+    {
+        double x_abs = fabs(x0[ii]) > fabs(x1[ii]) ? fabs(x0[ii]) : fabs(x1[ii]);
+        double tmp = err[ii] / (tol * (1.0 + x_abs));
+        sum += tmp * tmp;
+    }
+    if (n == 0)
+        return 0.0;
+    return sqrt(sum / n);
+}
+
+
+
+static double sim_step_size_factor(double err, int q)
+{
+    const double safety = 0.9;
+    const double fac_min = 0.2;
+    const double fac_max = 5.0;
+
+    if (err <= 0.0)
+        return fac_max;
+    double fac = safety * pow(err, -1.0 / (q + 1));
+    if (fac < fac_min)
+        fac = fac_min;
+    if (fac > fac_max)
+        fac = fac_max;
+    return fac;
+}
+
+
+
+void sim_step_control_init(sim_step_control *ctrl, double T, double step_init, int num_steps_max)
+{
+    ctrl->t_rem = T;
+    ctrl->step_prop = step_init < T ? step_init : T;
+    ctrl->num_steps_max = num_steps_max;
+    ctrl->num_attempts = 0;
+    ctrl->num_rejected = 0;
+    ctrl->last_step = false;
+    ctrl->last_rejected = false;
+    ctrl->force_accept = false;
+    ctrl->cap_reached = false;
+}
+
+
+
+double sim_step_control_next(sim_step_control *ctrl)
+{
+    int attempts_left = ctrl->num_steps_max - ctrl->num_attempts;
+    // the last quarter of the attempts is kept as reserve to reach the end of the interval
+    int attempts_reserve = (ctrl->num_steps_max + 3) / 4;
+    double step = ctrl->step_prop;
+
+    if (ctrl->force_accept ||
+        (attempts_left <= attempts_reserve && step * attempts_left < ctrl->t_rem * (1.0 - 1e-8)))
+    {
+        // the remaining attempts do not reach the end of the interval with the proposed
+        // step size: distribute the remainder uniformly and accept all steps
+        ctrl->force_accept = true;
+        ctrl->cap_reached = true;
+        step = ctrl->t_rem / attempts_left;
+    }
+    else if (step >= ctrl->t_rem * (1.0 - 1e-8))
+    {
+        step = ctrl->t_rem;
+    }
+
+    // the last attempt is always accepted
+    if (attempts_left == 1)
+        ctrl->force_accept = true;
+
+    ctrl->num_attempts++;
+    ctrl->last_step = step == ctrl->t_rem;
+
+    return step;
+}
+
+
+
+bool sim_step_control_update(sim_step_control *ctrl, double step, double err, int q, double fac_hold)
+{
+    double fac = sim_step_size_factor(err, q);
+
+    if (err > 1.0 && !ctrl->force_accept)
+    {
+        ctrl->num_rejected++;
+        ctrl->last_rejected = true;
+        ctrl->step_prop = fac * step;
+        return false;
+    }
+    if (err > 1.0)
+        ctrl->cap_reached = true;
+
+    // no increase directly after a rejection
+    if (ctrl->last_rejected && fac > 1.0)
+        fac = 1.0;
+    ctrl->last_rejected = false;
+    if (fac >= 1.0 && fac <= fac_hold)
+        fac = 1.0;
+
+    // keep the proposal if the last step was only shortened to hit the end of the interval
+    if (!ctrl->last_step || fac * step > ctrl->step_prop)
+        ctrl->step_prop = fac * step;
+
+    ctrl->t_rem = ctrl->last_step ? 0.0 : ctrl->t_rem - step;
+
+    return true;
+}
@@ -149,8 +149,31 @@ typedef struct
     bool jac_reuse;
     // Newton_scheme *scheme;
 
+    // IRK: simplified Newton with the stage system decoupled by the real block
+    // diagonalization of A^{-1}, only GAUSS_LEGENDRE with ns <= GAUSS_SIMPLIFIED_NS_MAX
+    bool simplified_newton;
+    double *simpl_eig;      // blkdiag(eig), ns x 2, see gauss_simplified
+    double *simpl_transf1;  // blkdiag(eig) * V^{-1}, ns x ns
+    double *simpl_transf2;  // V, ns x ns
+
     double newton_tol; // optinally used in implicit integrators
 
+    // IRK, GNSF: keep the factorized Newton matrix in memory across calls, e.g. SQP
+    // iterations; it is refactorized when the step size changes by more than
+    // jac_reuse_step_rtol or the observed Newton contraction exceeds
+    // jac_reuse_contraction_max, requires jac_reuse
+    bool jac_reuse_across_calls;
+    bool sens_jac_reuse;  // inexact forward sensitivities with the reused factorization
+    double jac_reuse_contraction_max;
+    double jac_reuse_step_rtol;
+
+    // adaptive step size control (ERK, IRK): steps are accepted based on an embedded error
+    // estimate, num_steps only gives the size of the very first step
+    bool adaptive_step;
+    int num_steps_max;  // max number of step attempts per call, sizes the trajectory storage
+    double step_tol;    // tolerance on the local error, scaled with (1 + |x|)
+    double *e_vec;      // ERK: embedded error weights, err = step * sum_i e_vec[i] * k_i
+
     // workspace
     void *work;
 
@@ -225,5 +248,32 @@ int sim_out_get_(void *config, void *dims, sim_out *out, const char *field, void
 void sim_opts_set_(sim_opts *opts, const char *field, void *value);
 //
 void sim_opts_get_(sim_config *config, sim_opts *opts, const char *field, void *value);
+// max number of steps in one call, i.e. size of the trajectory storage
+int sim_opts_steps_max(sim_opts *opts);
+
+/* adaptive step size control */
+
+typedef struct
+{
+    double t_rem;        // remaining integration time
+    double step_prop;    // proposed size of the next step
+    int num_steps_max;   // max number of step attempts
+    int num_attempts;
+    int num_rejected;
+    bool last_step;      // current attempt reaches the end of the interval
+    bool last_rejected;
+    bool force_accept;   // remaining steps are distributed uniformly and accepted
+    bool cap_reached;
+} sim_step_control;
+
+//
+void sim_step_control_init(sim_step_control *ctrl, double T, double step_init, int num_steps_max);
+// size of the next step attempt
+double sim_step_control_next(sim_step_control *ctrl);
+// accepts or rejects the current attempt based on the scaled error norm err of an error estimate
+// of order q and updates the proposal; factors in [1, fac_hold] keep the step size unchanged
+bool sim_step_control_update(sim_step_control *ctrl, double step, double err, int q, double fac_hold);
+// scaled root mean square norm of the local error estimate err of the step x0 -> x1
+double sim_step_error_norm(int n, const double *err, const double *x0, const double *x1, double tol);
 
 #endif  // ACADOS_SIM_SIM_COMMON_H_
@@ -160,6 +160,7 @@ void *sim_erk_model_assign(void *config, void *dims, void *raw_memory)
     model->expl_vde_for = NULL;
     model->expl_vde_adj = NULL;
     model->expl_ode_hes = NULL;
+    model->expl_vde_for_batch = NULL;
 
     return model;
 }
@@ -186,6 +187,10 @@ int sim_erk_model_set(void *model_, const char *field, void *value)
     {
         model->expl_ode_hes = value;
     }
+    else if (!strcmp(field, "expl_vde_for_batch"))
+    {
+        model->expl_vde_for_batch = value;
+    }
     else
     {
         printf("\nerror: sim_erk_model_set: wrong field: %s\n", field);
@@ -210,6 +215,7 @@ acados_size_t sim_erk_opts_calculate_size(void *config_, void *dims)
     size += ns_max * ns_max * sizeof(double);  // A_mat
     size += ns_max * sizeof(double);           // b_vec
     size += ns_max * sizeof(double);           // c_vec
+    size += ns_max * sizeof(double);           // e_vec
 
     make_int_multiple_of(8, &size);
     size += 1 * 8;
@@ -233,12 +239,16 @@ void *sim_erk_opts_assign(void *config_, void *dims, void *raw_memory)
     assign_and_advance_double(ns_max * ns_max, &opts->A_mat, &c_ptr);
     assign_and_advance_double(ns_max, &opts->b_vec, &c_ptr);
     assign_and_advance_double(ns_max, &opts->c_vec, &c_ptr);
+    assign_and_advance_double(ns_max, &opts->e_vec, &c_ptr);
 
     assert((char *) raw_memory + sim_erk_opts_calculate_size(config_, dims) >= c_ptr);
 
     opts->newton_iter = 0;
     // opts->scheme = NULL;
     opts->jac_reuse = false;
+    opts->simplified_newton = false;
+    opts->jac_reuse_across_calls = false;
+    opts->sens_jac_reuse = false;
 
     return (void *) opts;
 }
@@ -288,6 +298,10 @@ void sim_erk_opts_initialize_default(void *config_, void *dims_, void *opts_)
 
     opts->output_z = false;
     opts->sens_algebraic = false;
+
+    opts->adaptive_step = false;
+    opts->num_steps_max = 20;
+    opts->step_tol = 1e-6;
 }
 
 
@@ -296,6 +310,15 @@ void sim_erk_opts_update(void *config_, void *dims, void *opts_)
 {
     sim_opts *opts = opts_;
 
+    if (opts->adaptive_step)
+    {
+        // adaptive mode always uses the embedded Dormand-Prince 5(4) pair
+        opts->ns = 7;
+        opts->tableau_size = opts->ns;
+        get_dormand_prince_tableau(opts->A_mat, opts->b_vec, opts->c_vec, opts->e_vec);
+        return;
+    }
+
     int ns = opts->ns;
 
     opts->tableau_size = opts->ns;
@@ -338,6 +361,11 @@ void *sim_erk_memory_assign(void *config, void *dims, void *opts_, void *raw_mem
     sim_erk_memory *mem = (sim_erk_memory *) c_ptr;
     c_ptr += sizeof(sim_erk_memory);
 
+    mem->step_size = 0.0;
+    mem->steps_accepted = 0;
+    mem->steps_rejected = 0;
+    mem->step_cap_reached = 0;
+
     return mem;
 }
 
@@ -389,6 +417,26 @@ void sim_erk_memory_get(void *config_, void *dims_, void *mem_, const char *fiel
         double *ptr = value;
         *ptr = mem->time_la;
     }
+    else if (!strcmp(field, "steps_accepted"))
+    {
+        int *ptr = value;
+        *ptr = mem->steps_accepted;
+    }
+    else if (!strcmp(field, "steps_rejected"))
+    {
+        int *ptr = value;
+        *ptr = mem->steps_rejected;
+    }
+    else if (!strcmp(field, "step_cap_reached"))
+    {
+        int *ptr = value;
+        *ptr = mem->step_cap_reached;
+    }
+    else if (!strcmp(field, "step_size"))
+    {
+        double *ptr = value;
+        *ptr = mem->step_size;
+    }
     else
     {
         printf("sim_erk_memory_get field %s is not supported! \n", field);
@@ -415,7 +463,7 @@ acados_size_t sim_erk_workspace_calculate_size(void *config_, void *dims_, void
 
     int nX = nx * (1 + nf);  // (nx) for ODE and (nf*nx) for VDE
     int nhess = (nf + 1) * nf / 2;
-    int num_steps = opts->num_steps;  // number of steps
+    int num_steps = sim_opts_steps_max(opts);  // max number of steps
 
     acados_size_t size = sizeof(sim_erk_workspace);
 
@@ -445,6 +493,13 @@ acados_size_t sim_erk_workspace_calculate_size(void *config_, void *dims_, void
         size += ns * (nx + nu) * sizeof(double);  // adj_traj
     }
 
+    if (opts->adaptive_step)
+    {
+        if (opts->sens_adj | opts->sens_hess)
+            size += num_steps * sizeof(double);  // step_traj
+        size += nx * sizeof(double);             // err
+    }
+
     make_int_multiple_of(8, &size);
     size += 1 * 8;
 
@@ -463,7 +518,7 @@ static void *sim_erk_cast_workspace(void *config_, sim_erk_dims *dims, sim_opts
 
     int nX = nx * (1 + nf);  // (nx) for ODE and (nf*nx) for VDE
     int nhess = (nf + 1) * nf / 2;
-    int num_steps = opts->num_steps;  // number of steps
+    int num_steps = sim_opts_steps_max(opts);  // max number of steps
 
     char *c_ptr = (char *) raw_memory;
 
@@ -524,6 +579,17 @@ static void *sim_erk_cast_workspace(void *config_, sim_erk_dims *dims, sim_opts
         d_ptr += ns*(nu+nx);
     }
 
+    if (opts->adaptive_step)
+    {
+        if (opts->sens_adj | opts->sens_hess)
+        {
+            work->step_traj = d_ptr;
+            d_ptr += num_steps;
+        }
+        work->err = d_ptr;
+        d_ptr += nx;
+    }
+
     // update c_ptr
     c_ptr = (char *) d_ptr;
 
@@ -550,6 +616,11 @@ size_t sim_erk_get_external_fun_workspace_requirement(void *config_, void *dims_
     size = size > tmp_size ? size : tmp_size;
     tmp_size = external_function_get_workspace_requirement_if_defined(model->expl_ode_hes);
     size = size > tmp_size ? size : tmp_size;
+    if (model->expl_vde_for_batch != NULL)
+    {
+        tmp_size = model->expl_vde_for_batch->get_external_workspace_requirement(model->expl_vde_for_batch);
+        size = size > tmp_size ? size : tmp_size;
+    }
 
     return size;
 }
@@ -563,6 +634,8 @@ void sim_erk_set_external_fun_workspaces(void *config_, void *dims_, void *opts_
     external_function_set_fun_workspace_if_defined(model->expl_vde_for, workspace_);
     external_function_set_fun_workspace_if_defined(model->expl_vde_adj, workspace_);
     external_function_set_fun_workspace_if_defined(model->expl_ode_hes, workspace_);
+    if (model->expl_vde_for_batch != NULL)
+        model->expl_vde_for_batch->set_external_workspace(model->expl_vde_for_batch, workspace_);
 }
 
 
@@ -597,6 +670,11 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
         exit(1);
     }
     int ns = opts->ns;
+    if (opts->adaptive_step && ns != 7)
+    {
+        printf("\nerror: sim_erk: adaptive_step requires the Dormand-Prince tableau, call opts_update\n");
+        exit(1);
+    }
 
     void *dims_ = in->dims;
     sim_erk_dims *dims = (sim_erk_dims *) dims_;
@@ -711,8 +789,20 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     }
     for (i = 0; i < nu; i++) rhs_forw_in[nX + i] = u[i];  // controls
 
-    for (istep = 0; istep < num_steps; istep++)
+    // adaptive step size control
+    bool adaptive = opts->adaptive_step;
+    double *e_vec = opts->e_vec;
+    sim_step_control step_ctrl;
+    sim_step_control_init(&step_ctrl, in->T, mem->step_size > 0.0 ? mem->step_size : step,
+                          sim_opts_steps_max(opts));
+    bool first_stage_valid = false;  // FSAL: first stage already evaluated
+
+    istep = 0;
+    while (adaptive ? step_ctrl.t_rem > 0.0 : istep < num_steps)
     {
+        if (adaptive)
+            step = sim_step_control_next(&step_ctrl);
+
         if (opts->sens_adj | opts->sens_hess)
         {
             K_traj = work->K_traj + istep * ns * nX;
@@ -721,7 +811,7 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 forw_traj[i] = forw_traj[i - nX];
         }
 
-        for (s = 0; s < ns; s++)
+        for (s = first_stage_valid ? 1 : 0; s < ns; s++)
         {
             for (i = 0; i < nX; i++)
                 rhs_forw_in[i] = forw_traj[i];
@@ -759,11 +849,63 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             }
             timing_ad += acados_toc(&timer_ad);
         }
+
+        if (adaptive)
+        {
+            // embedded error estimate on the states only, the sensitivities follow the
+            // accepted steps (internal numerical differentiation);
+            // the last stage is evaluated at the new state, which is still in rhs_forw_in
+            for (i = 0; i < nx; i++)
+                work->err[i] = 0.0;
+            for (s = 0; s < ns; s++)
+            {
+                b = step * e_vec[s];
+                if (b != 0)
+                {
+                    for (i = 0; i < nx; i++)
+                        work->err[i] += b * K_traj[s * nX + i];
+                }
+            }
+            double err = sim_step_error_norm(nx, work->err, forw_traj, rhs_forw_in, opts->step_tol);
+
+            if (!sim_step_control_update(&step_ctrl, step, err, 4, 1.0))
+            {
+                // rejected, the first stage stays valid
+                first_stage_valid = true;
+                continue;
+            }
+
+            if (opts->sens_adj | opts->sens_hess)
+                work->step_traj[istep] = step;
+        }
+
         for (s = 0; s < ns; s++)
         {
             b = step * b_vec[s];
             for (i = 0; i < nX; i++) forw_traj[i] += b * K_traj[s * nX + i];  // ERK step
         }
+
+        istep++;
+
+        if (adaptive && !step_ctrl.last_step)
+        {
+            // FSAL: the last stage is the first stage of the next step
+            double *K_next = K_traj;
+            if (opts->sens_adj | opts->sens_hess)
+                K_next = work->K_traj + istep * ns * nX;
+            for (i = 0; i < nX; i++)
+                K_next[i] = K_traj[(ns - 1) * nX + i];
+            first_stage_valid = true;
+        }
+    }
+    num_steps = istep;
+
+    if (adaptive)
+    {
+        mem->step_size = step_ctrl.step_prop;
+        mem->steps_accepted = num_steps;
+        mem->steps_rejected = step_ctrl.num_rejected;
+        mem->step_cap_reached = step_ctrl.cap_reached;
     }
 
     // store trajectory
@@ -804,6 +946,8 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
 
             K_traj = work->K_traj + istep * ns * nX;
             forw_traj = work->out_forw_traj + istep*nX;
+            if (adaptive)
+                step = work->step_traj[istep];
 
             for (s = ns - 1; s >= 0; s--)
             {
@@ -928,6 +1072,215 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
 }
 
 
+/************************************************
+ * batched integration
+ ************************************************/
+
+acados_size_t sim_erk_batch_workspace_calculate_size(void *config_, void *dims_, void *opts_, int n_batch)
+{
+    sim_erk_dims *dims = dims_;
+    sim_opts *opts = opts_;
+
+    int nx = dims->nx;
+    int nu = dims->nu;
+    int ns = opts->ns;
+
+    int nB = nx * (1 + nx + nu) + nu;
+
+    acados_size_t size = sizeof(sim_erk_batch_workspace);
+
+    size += ns * n_batch * nB * sizeof(double);  // K
+    size += n_batch * nB * sizeof(double);  // rhs
+    size += n_batch * sizeof(double);  // step
+
+    size += 8 * n_batch * sizeof(void *);  // fun_in, fun_out
+    size += 2 * n_batch * sizeof(void **);  // fun_in_inst, fun_out_inst
+
+    make_int_multiple_of(8, &size);
+    size += 1 * 8;
+
+    return size;
+}
+
+
+
+static sim_erk_batch_workspace *sim_erk_batch_cast_workspace(sim_erk_dims *dims, sim_opts *opts,
+                                                             int n_batch, void *raw_memory)
+{
+    int nx = dims->nx;
+    int nu = dims->nu;
+    int ns = opts->ns;
+
+    int nB = nx * (1 + nx + nu) + nu;
+
+    char *c_ptr = (char *) raw_memory;
+
+    sim_erk_batch_workspace *work = (sim_erk_batch_workspace *) c_ptr;
+    c_ptr += sizeof(sim_erk_batch_workspace);
+
+    align_char_to(8, &c_ptr);
+
+    work->fun_in = (void **) c_ptr;
+    c_ptr += 5 * n_batch * sizeof(void *);
+    work->fun_out = (void **) c_ptr;
+    c_ptr += 3 * n_batch * sizeof(void *);
+    work->fun_in_inst = (void ***) c_ptr;
+    c_ptr += n_batch * sizeof(void **);
+    work->fun_out_inst = (void ***) c_ptr;
+    c_ptr += n_batch * sizeof(void **);
+
+    assign_and_advance_double(ns * n_batch * nB, &work->K, &c_ptr);
+    assign_and_advance_double(n_batch * nB, &work->rhs, &c_ptr);
+    assign_and_advance_double(n_batch, &work->step, &c_ptr);
+
+    assert((char *) raw_memory + sim_erk_batch_workspace_calculate_size(NULL, dims, opts, n_batch) >= c_ptr);
+
+    return work;
+}
+
+
+
+int sim_erk_batch(void *config_, void *dims_, void *opts_, erk_model **models, double *T, double *forw,
+                  double **p, int n_batch, void *work_)
+{
+    sim_erk_dims *dims = dims_;
+    sim_opts *opts = opts_;
+
+    int nx = dims->nx;
+    int nu = dims->nu;
+    int ns = opts->ns;
+    int num_steps = opts->num_steps;
+
+    if (ns != opts->tableau_size)
+    {
+        printf("\nerror: sim_erk_batch: the Butcher tableau size does not match ns\n");
+        exit(1);
+    }
+    if (!opts->sens_forw || opts->num_forw_sens != nx + nu || opts->adaptive_step || dims->nz != 0)
+    {
+        printf("\nerror: sim_erk_batch: only fixed steps with forward sensitivities w.r.t. x and u supported\n");
+        exit(1);
+    }
+
+    external_function_casadi_batch *fun_batch = models[0]->expl_vde_for_batch;
+
+    if (fun_batch != NULL && fun_batch->np > 0 && p == NULL)
+    {
+        printf("\nerror: sim_erk_batch: the batched vde has %d parameters, but none were passed\n", fun_batch->np);
+        exit(1);
+    }
+
+    sim_erk_batch_workspace *work = sim_erk_batch_cast_workspace(dims, opts, n_batch, work_);
+
+    int i, j, k, s, istep;
+    double a, b;
+
+    int nX = nx * (1 + nx + nu);
+    int nB = nX + nu;
+    int n_tot = n_batch * nB;  // length of the lock-step sweeps
+
+    double *A_mat = opts->A_mat;
+    double *b_vec = opts->b_vec;
+
+    double *K = work->K;
+    double *rhs = work->rhs;
+
+    ext_fun_arg_t expl_vde_type_in[5] = {COLMAJ, COLMAJ, COLMAJ, COLMAJ, COLMAJ};
+    ext_fun_arg_t expl_vde_type_out[3] = {COLMAJ, COLMAJ, COLMAJ};
+    void *expl_vde_out[3];
+
+    for (k = 0; k < n_batch; k++)
+    {
+        double *forw_k = forw + k * nB;
+
+        // identity seed
+        for (i = 0; i < nx * (nx + nu); i++)
+            forw_k[nx + i] = 0.0;
+        for (i = 0; i < nx; i++)
+            forw_k[nx + i * (nx + 1)] = 1.0;
+
+        work->step[k] = T[k] / num_steps;
+
+        // arguments of instance k: x, Sx, Su, u, p; the stage-wise vde holds its own parameters
+        work->fun_in[5 * k + 0] = rhs + k * nB;
+        work->fun_in[5 * k + 1] = rhs + k * nB + nx;
+        work->fun_in[5 * k + 2] = rhs + k * nB + nx * (1 + nx);
+        work->fun_in[5 * k + 3] = rhs + k * nB + nX;
+        work->fun_in[5 * k + 4] = p != NULL ? p[k] : NULL;
+        work->fun_in_inst[k] = work->fun_in + 5 * k;
+        work->fun_out_inst[k] = work->fun_out + 3 * k;
+    }
+
+    // the control part of the stage derivatives stays zero, such that the sweeps below
+    // carry u along unchanged
+    for (i = 0; i < ns * n_tot; i++)
+        K[i] = 0.0;
+
+    for (istep = 0; istep < num_steps; istep++)
+    {
+        for (s = 0; s < ns; s++)
+        {
+            double *K_s = K + s * n_tot;
+
+            // stage evaluation points of all intervals
+            for (i = 0; i < n_tot; i++)
+                rhs[i] = forw[i];
+            for (j = 0; j < s; j++)
+            {
+                a = A_mat[j * ns + s];
+                if (a != 0)
+                {
+                    for (i = 0; i < n_tot; i++)
+                        rhs[i] += a * K[j * n_tot + i];
+                }
+            }
+
+            // forward VDE evaluation
+            if (fun_batch != NULL)
+            {
+                for (k = 0; k < n_batch; k++)
+                {
+                    work->fun_out[3 * k + 0] = K_s + k * nB;
+                    work->fun_out[3 * k + 1] = K_s + k * nB + nx;
+                    work->fun_out[3 * k + 2] = K_s + k * nB + nx * (1 + nx);
+                }
+                fun_batch->evaluate_batch(fun_batch, n_batch, expl_vde_type_in, work->fun_in_inst,
+                                          expl_vde_type_out, work->fun_out_inst);
+            }
+            else
+            {
+                for (k = 0; k < n_batch; k++)
+                {
+                    expl_vde_out[0] = K_s + k * nB;
+                    expl_vde_out[1] = K_s + k * nB + nx;
+                    expl_vde_out[2] = K_s + k * nB + nx * (1 + nx);
+                    models[k]->expl_vde_for->evaluate(models[k]->expl_vde_for, expl_vde_type_in,
+                                    work->fun_in_inst[k], expl_vde_type_out, expl_vde_out);
+                }
+            }
+
+            // scale with the step size of each interval
+            for (k = 0; k < n_batch; k++)
+            {
+                for (i = 0; i < nX; i++)
+                    K_s[k * nB + i] *= work->step[k];
+            }
+        }
+
+        // ERK step of all intervals
+        for (s = 0; s < ns; s++)
+        {
+            b = b_vec[s];
+            for (i = 0; i < n_tot; i++)
+                forw[i] += b * K[s * n_tot + i];
+        }
+    }
+
+    return ACADOS_SUCCESS;
+}
+
+
+
 void sim_erk_config_initialize_default(void *config_)
 {
     sim_config *config = config_;
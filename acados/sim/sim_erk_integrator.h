@@ -61,6 +61,8 @@ typedef struct
     external_function_generic *expl_vde_for;
     // adjoint explicit vde
     external_function_generic *expl_vde_adj;
+    // forward explicit vde mapped over shooting intervals, optional, used by sim_erk_batch
+    external_function_casadi_batch *expl_vde_for_batch;
 
 } erk_model;
 
@@ -73,6 +75,11 @@ typedef struct
     double time_ad;
     double time_la;
     acados_size_t workspace_size;
+    // adaptive step size control
+    double step_size;  // proposal for the first step of the next call, 0 if none
+    int steps_accepted;
+    int steps_rejected;
+    int step_cap_reached;  // 1 if num_steps_max forced the last step
 
 } sim_erk_memory;
 
@@ -90,10 +97,26 @@ typedef struct
     double *out_adj_tmp;
     double *adj_traj;
 
+    double *step_traj;  // (steps) accepted step sizes, adaptive mode with adj
+    double *err;        // (nx) local error estimate, adaptive mode
+
 } sim_erk_workspace;
 
 
 
+typedef struct
+{
+    double *K;        // (stages*n_batch*nB) stage derivatives, scaled with the step size
+    double *rhs;      // (n_batch*nB) stage evaluation points
+    double *step;     // (n_batch) step size per interval
+    void **fun_in;    // (5*n_batch) argument pointers for the mapped vde
+    void **fun_out;   // (3*n_batch)
+    void ***fun_in_inst;   // (n_batch) arguments of each instance
+    void ***fun_out_inst;  // (n_batch)
+} sim_erk_batch_workspace;
+
+
+
 // dims
 acados_size_t sim_erk_dims_calculate_size();
 void *sim_erk_dims_assign(void *config_, void *raw_memory);
@@ -136,6 +159,16 @@ int sim_erk(void *config, sim_in *in, sim_out *out, void *opts_, void *mem_, voi
 //
 void sim_erk_config_initialize_default(void *config);
 
+// batched integration: n_batch initial value problems with identical dims and opts are
+// integrated in lock-step, i.e. every RK stage is combined for all problems in one sweep;
+// forw holds n_batch blocks of size nB = nx*(1+nx+nu)+nu, each [x, Sx, Su, u];
+// on entry x and u are read, on exit the block holds [xn, Sx, Su, u] for the identity seed;
+// p[k] are the parameters of problem k passed to the batched vde, may be NULL if it has none
+acados_size_t sim_erk_batch_workspace_calculate_size(void *config, void *dims, void *opts_, int n_batch);
+//
+int sim_erk_batch(void *config, void *dims, void *opts_, erk_model **models, double *T, double *forw,
+                  double **p, int n_batch, void *work_);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -31,6 +31,7 @@
 
 // standard
 #include <assert.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -323,6 +324,14 @@ void sim_gnsf_opts_initialize_default(void *config_, void *dims_, void *opts_)
     opts->sens_adj = false;
     opts->sens_hess = false;
     opts->jac_reuse = true;
+    opts->simplified_newton = false;
+    opts->adaptive_step = false;  // not supported
+    opts->jac_reuse_across_calls = false;
+    opts->sens_jac_reuse = false;
+    opts->jac_reuse_contraction_max = 0.5;
+    opts->jac_reuse_step_rtol = 0.2;
+    opts->num_steps_max = 20;
+    opts->step_tol = 1e-6;
     opts->exact_z_output = false;
     opts->ns = 3;
     opts->collocation_type = GAUSS_LEGENDRE;
@@ -509,10 +518,18 @@ int sim_gnsf_model_set(void *model_, const char *field, void *value)
     {
         model->phi_jac_y_uhat = value;
     }
+    else if (!strcmp(field, "phi_hess") || !strcmp(field, "gnsf_phi_hess"))
+    {
+        model->phi_hess = value;
+    }
     else if (!strcmp(field, "f_lo_jac_x1_x1dot_u_z") || !strcmp(field, "gnsf_f_lo_fun_jac_x1k1uz"))
     {
         model->f_lo_fun_jac_x1_x1dot_u_z = value;
     }
+    else if (!strcmp(field, "f_lo_hess") || !strcmp(field, "gnsf_f_lo_hess"))
+    {
+        model->f_lo_hess = value;
+    }
     else if (!strcmp(field, "get_gnsf_matrices") || !strcmp(field, "gnsf_get_matrices_fun"))
     {
         model->get_gnsf_matrices = value;
@@ -1179,6 +1196,29 @@ int sim_gnsf_precompute(void *config_, sim_in *in, sim_out *out, void *opts_, vo
 
 
 
+/************************************************
+ * workspace cast
+ ************************************************/
+
+// size of the workspace struct and the blasfeo structs it points to
+static acados_size_t sim_gnsf_workspace_structs_calculate_size(sim_opts *opts)
+{
+    int num_steps = opts->num_steps;
+
+    acados_size_t size = sizeof(gnsf_workspace);
+    make_int_multiple_of(8, &size);
+    size += 1 * 8;
+
+    size += 2 * num_steps * sizeof(struct blasfeo_dvec);  // vv_traj, yy_traj
+    size += num_steps * sizeof(struct blasfeo_dmat);  // f_LO_jac_traj
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
 /************************************************
  * memory
  ************************************************/
@@ -1220,6 +1260,12 @@ acados_size_t sim_gnsf_memory_calculate_size(void *config, void *dims_, void *op
 
     size += nK2 * sizeof(int);      // ipivM2
 
+    if (opts->jac_reuse_across_calls)
+    {
+        size += nvv * sizeof(int);                // ipiv_vv
+        size += blasfeo_memsize_dmat(nvv, nvv);  // J_r_vv_LU
+    }
+
     if (opts->sens_algebraic)
     {
         size += nxz2 * sizeof(int); // ipiv_ELO
@@ -1279,6 +1325,8 @@ acados_size_t sim_gnsf_memory_calculate_size(void *config, void *dims_, void *op
     size += blasfeo_memsize_dvec(nK1);  // KK0
     size += blasfeo_memsize_dvec(nyy);  // YY0
 
+    size += sim_gnsf_workspace_structs_calculate_size(opts);  // work_cast_memory
+
     size += 1 * 64;  // corresponds to memory alignment
     size += 2 * 8;  // initial memory alignment, alignment for doubles
     make_int_multiple_of(64, &size);
@@ -1328,6 +1376,14 @@ void *sim_gnsf_memory_assign(void *config, void *dims_, void *opts_, void *raw_m
     //     assign_and_advance_int(nxz2, &mem->ipiv_ELO, &c_ptr);
     // }
     assign_and_advance_int(nK2, &mem->ipivM2, &c_ptr);
+    if (opts->jac_reuse_across_calls)
+    {
+        assign_and_advance_int(nvv, &mem->ipiv_vv, &c_ptr);
+    }
+    else
+    {
+        mem->ipiv_vv = NULL;
+    }
     align_char_to(8, &c_ptr);
 
     // assign doubles
@@ -1342,6 +1398,13 @@ void *sim_gnsf_memory_assign(void *config, void *dims_, void *opts_, void *raw_m
         mem->phi_guess[ii] = 0.0;
     }
 
+    // cached workspace cast
+    mem->work_cast_size = sim_gnsf_workspace_structs_calculate_size(opts);
+    mem->work_cast_memory = c_ptr;
+    c_ptr += mem->work_cast_size;
+    mem->work_cast = NULL;
+    mem->work_cast_raw = NULL;
+
     // blasfeo_dmat structs
     // if (opts->sens_algebraic){
 
@@ -1392,6 +1455,11 @@ void *sim_gnsf_memory_assign(void *config, void *dims_, void *opts_, void *raw_m
     assign_and_advance_blasfeo_dmat_mem(nx, nx + nu, &mem->S_forw, &c_ptr);
     assign_and_advance_blasfeo_dmat_mem(nz, nx + nu, &mem->S_algebraic, &c_ptr);
 
+    if (opts->jac_reuse_across_calls)
+    {
+        assign_and_advance_blasfeo_dmat_mem(nvv, nvv, &mem->J_r_vv_LU, &c_ptr);
+    }
+
     // if (opts->sens_algebraic){
     //     // for algebraic sensitivity propagation
     //     assign_and_advance_blasfeo_dmat_mem(ny, nx1, mem->Lx, &c_ptr);
@@ -1418,6 +1486,10 @@ void *sim_gnsf_memory_assign(void *config, void *dims_, void *opts_, void *raw_m
     assign_and_advance_blasfeo_dvec_mem(nyy, &mem->YY0, &c_ptr);  // YY0
     assign_and_advance_blasfeo_dvec_mem(nK1, &mem->KK0, &c_ptr);  // KK0
 
+    mem->jac_dt = 0.0;
+    mem->jac_valid = false;
+    mem->jac_factorizations = 0;
+    mem->jac_factorizations_skipped = 0;
 
     assert((char *) raw_memory + sim_gnsf_memory_calculate_size(config, dims_, opts_) >= c_ptr);
     return mem;
@@ -1465,6 +1537,11 @@ int sim_gnsf_memory_set_to_zero(void *config_, void * dims_, void *opts_, void *
         for (int ii=0; ii < dims->n_out; ii++)
             mem->phi_guess[ii] = 0.0;
     }
+    else if (!strcmp(field, "jac_factorization"))
+    {
+        // invalidates the factorization kept across calls
+        mem->jac_valid = false;
+    }
     else
     {
         printf("sim_gnsf_memory_set_to_zero field %s is not supported! \n", field);
@@ -1495,6 +1572,16 @@ void sim_gnsf_memory_get(void *config_, void *dims_, void *mem_, const char *fie
         double *ptr = value;
         *ptr = mem->time_la;
     }
+    else if (!strcmp(field, "jac_factorizations"))
+    {
+        int *ptr = value;
+        *ptr = mem->jac_factorizations;
+    }
+    else if (!strcmp(field, "jac_factorizations_skipped"))
+    {
+        int *ptr = value;
+        *ptr = mem->jac_factorizations_skipped;
+    }
     else
     {
         printf("sim_gnsf_memory_get field %s is not supported! \n", field);
@@ -1626,6 +1713,9 @@ acados_size_t sim_gnsf_workspace_calculate_size(void *config, void *dims_, void
     size += blasfeo_memsize_dvec(nuhat);  // uhat
     size += blasfeo_memsize_dvec(nz);  // z0;
 
+    if (opts->sens_hess)
+        size += blasfeo_memsize_dvec(nK2);  // lambda_K2
+
     // if (opts->sens_algebraic){
     //     size += blasfeo_memsize_dvec(nx1);  // x0dot_1;
     //     size += blasfeo_memsize_dvec(ny);  // y_one_stage
@@ -1666,6 +1756,20 @@ acados_size_t sim_gnsf_workspace_calculate_size(void *config, void *dims_, void
     size += blasfeo_memsize_dmat(nvv, ny + nuhat);  // dPHI_dyuhat
     size += blasfeo_memsize_dmat(nz, nx + nu);  // S_algebraic_aux
 
+    if (opts->sens_hess)
+    {
+        int nw = nx + nu;
+        int nh = ny + nuhat > 2 * nx1 + nu + nz1 ? ny + nuhat : 2 * nx1 + nu + nz1;
+        size += blasfeo_memsize_dmat(num_steps * nx, nw);  // S_forw_traj
+        size += blasfeo_memsize_dmat(nw, nw);   // dw_dw0
+        size += blasfeo_memsize_dmat(nvv, nw);  // dvv_dw
+        size += blasfeo_memsize_dmat(nK1, nw);  // dK1_dw
+        size += blasfeo_memsize_dmat(nZ1, nw);  // dZ1_dw
+        size += 3 * blasfeo_memsize_dmat(nh, nw);  // hess_dir, hess_dir_w0, hess_tmp
+        size += blasfeo_memsize_dmat(nh, nh);   // hess_fun
+        size += blasfeo_memsize_dmat(nw, nw);   // S_hess
+    }
+
     make_int_multiple_of(8, &size);
     size += 1 * 8;
 
@@ -1677,7 +1781,10 @@ acados_size_t sim_gnsf_workspace_calculate_size(void *config, void *dims_, void
 
 
 
-static void *sim_gnsf_cast_workspace(void *config, void *dims_, void *opts_, void *raw_memory)
+/* The workspace struct and the blasfeo structs are assigned in structs_memory,
+ * everything else in raw_memory, at the same offset as for structs_memory == raw_memory. */
+static void *sim_gnsf_cast_workspace(void *config, void *dims_, void *opts_, void *structs_memory,
+                                     void *raw_memory)
 {
     // typecast
     sim_gnsf_dims *dims = (sim_gnsf_dims *) dims_;
@@ -1705,22 +1812,25 @@ static void *sim_gnsf_cast_workspace(void *config, void *dims_, void *opts_, voi
     int nZ1 = num_stages * nz1;
     int nxz2 = nx2 + nz2;
 
-    char *c_ptr = (char *) raw_memory;
+    char *c_ptr = (char *) structs_memory;
     gnsf_workspace *workspace = (gnsf_workspace *) c_ptr;
     c_ptr += sizeof(gnsf_workspace);
     align_char_to(8, &c_ptr);
 
+    assign_and_advance_blasfeo_dmat_structs(num_steps, &workspace->f_LO_jac_traj, &c_ptr);
+
+    assign_and_advance_blasfeo_dvec_structs(num_steps, &workspace->vv_traj, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(num_steps, &workspace->yy_traj, &c_ptr);
+
+    // continue in raw_memory
+    c_ptr = (char *) raw_memory + (c_ptr - (char *) structs_memory);
+
     assign_and_advance_double(num_stages, &workspace->Z_work, &c_ptr);
 
     assign_and_advance_int(nvv, &workspace->ipiv, &c_ptr);
 
     align_char_to(8, &c_ptr);
 
-    assign_and_advance_blasfeo_dmat_structs(num_steps, &workspace->f_LO_jac_traj, &c_ptr);
-
-    assign_and_advance_blasfeo_dvec_structs(num_steps, &workspace->vv_traj, &c_ptr);
-    assign_and_advance_blasfeo_dvec_structs(num_steps, &workspace->yy_traj, &c_ptr);
-
     for (int ii = 0; ii < num_steps; ii++)
     {
         assign_and_advance_blasfeo_dvec_mem(nvv, workspace->vv_traj + ii, &c_ptr);    // vv_traj
@@ -1749,6 +1859,9 @@ static void *sim_gnsf_cast_workspace(void *config, void *dims_, void *opts_, voi
     assign_and_advance_blasfeo_dvec_mem(nuhat, &workspace->uhat, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nz, &workspace->z0, &c_ptr);
 
+    if (opts->sens_hess)
+        assign_and_advance_blasfeo_dvec_mem(nK2, &workspace->lambda_K2, &c_ptr);
+
     // if (opts->sens_algebraic){
         // assign_and_advance_blasfeo_dvec_mem(ny, &workspace->y_one_stage, &c_ptr);
     //     assign_and_advance_blasfeo_dvec_mem(nx1, &workspace->x0dot_1, &c_ptr);
@@ -1785,7 +1898,6 @@ static void *sim_gnsf_cast_workspace(void *config, void *dims_, void *opts_, voi
     assign_and_advance_blasfeo_dmat_mem(nvv, ny + nuhat, &workspace->dPHI_dyuhat, &c_ptr);
 
     assign_and_advance_blasfeo_dmat_mem(nK2, nx1, &workspace->dK2_dx1, &c_ptr);
-    blasfeo_dgese(nK2, nx1, 0.0, &workspace->dK2_dx1, 0, 0);
 
     assign_and_advance_blasfeo_dmat_mem(nK2, nvv, &workspace->dK2_dvv, &c_ptr);
     assign_and_advance_blasfeo_dmat_mem(nx, nx + nu, &workspace->dxf_dwn, &c_ptr);
@@ -1796,6 +1908,22 @@ static void *sim_gnsf_cast_workspace(void *config, void *dims_, void *opts_, voi
     assign_and_advance_blasfeo_dmat_mem(nx, nu, &workspace->dPsi_du, &c_ptr);
     assign_and_advance_blasfeo_dmat_mem(nz, nx + nu, &workspace->S_algebraic_aux, &c_ptr);
 
+    if (opts->sens_hess)
+    {
+        int nw = nx + nu;
+        int nh = ny + nuhat > 2 * nx1 + nu + nz1 ? ny + nuhat : 2 * nx1 + nu + nz1;
+        assign_and_advance_blasfeo_dmat_mem(num_steps * nx, nw, &workspace->S_forw_traj, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nw, nw, &workspace->dw_dw0, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nvv, nw, &workspace->dvv_dw, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nK1, nw, &workspace->dK1_dw, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nZ1, nw, &workspace->dZ1_dw, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nh, nw, &workspace->hess_dir, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nh, nw, &workspace->hess_dir_w0, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nh, nw, &workspace->hess_tmp, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nh, nh, &workspace->hess_fun, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nw, nw, &workspace->S_hess, &c_ptr);
+    }
+
     assert((char *) raw_memory + sim_gnsf_workspace_calculate_size(config, dims_, opts) >= c_ptr);
 
     return (void *) workspace;
@@ -2148,6 +2276,10 @@ size_t sim_gnsf_get_external_fun_workspace_requirement(void *config_, void *dims
     size = size > tmp_size ? size : tmp_size;
     tmp_size = external_function_get_workspace_requirement_if_defined(model->phi_jac_y_uhat);
     size = size > tmp_size ? size : tmp_size;
+    tmp_size = external_function_get_workspace_requirement_if_defined(model->phi_hess);
+    size = size > tmp_size ? size : tmp_size;
+    tmp_size = external_function_get_workspace_requirement_if_defined(model->f_lo_hess);
+    size = size > tmp_size ? size : tmp_size;
 
     return size;
 }
@@ -2162,9 +2294,281 @@ void sim_gnsf_set_external_fun_workspaces(void *config_, void *dims_, void *opts
     external_function_set_fun_workspace_if_defined(model->phi_fun, workspace_);
     external_function_set_fun_workspace_if_defined(model->phi_fun_jac_y, workspace_);
     external_function_set_fun_workspace_if_defined(model->phi_jac_y_uhat, workspace_);
+    external_function_set_fun_workspace_if_defined(model->phi_hess, workspace_);
+    external_function_set_fun_workspace_if_defined(model->f_lo_hess, workspace_);
+}
+
+
+static gnsf_workspace *sim_gnsf_workspace_get(void *config, sim_gnsf_dims *dims, sim_opts *opts,
+                                              sim_gnsf_memory *mem, void *work_)
+{
+    gnsf_workspace *workspace;
+
+    if (mem->work_cast_raw == work_ && mem->work_cast_ns == opts->ns &&
+        mem->work_cast_num_steps == opts->num_steps && mem->work_cast_sens_hess == opts->sens_hess)
+    {
+        workspace = mem->work_cast;
+    }
+    else if (sim_gnsf_workspace_structs_calculate_size(opts) <= mem->work_cast_size)
+    {
+        workspace = sim_gnsf_cast_workspace(config, dims, opts, mem->work_cast_memory, work_);
+        mem->work_cast = workspace;
+        mem->work_cast_raw = work_;
+        mem->work_cast_ns = opts->ns;
+        mem->work_cast_num_steps = opts->num_steps;
+        mem->work_cast_sens_hess = opts->sens_hess;
+    }
+    else
+    {
+        // layout changed beyond the cached size, cast in place
+        mem->work_cast_raw = NULL;
+        workspace = sim_gnsf_cast_workspace(config, dims, opts, work_, work_);
+    }
+
+    // dK2_dx1 is assumed to be zero initialized
+    int nK2 = opts->ns * (dims->nx - dims->nx1 + dims->nz - dims->nz1);
+    blasfeo_dgese(nK2, dims->nx1, 0.0, &workspace->dK2_dx1, 0, 0);
+
+    return workspace;
+}
+
+
+// S_hess += (hess_dir * dw_dw0)^T * hess_fun * (hess_dir * dw_dw0), with n rows in hess_dir
+static void sim_gnsf_hess_add(int n, int nw, gnsf_workspace *workspace)
+{
+    blasfeo_dgemm_nn(n, nw, nw, 1.0, &workspace->hess_dir, 0, 0, &workspace->dw_dw0, 0, 0, 0.0,
+                     &workspace->hess_dir_w0, 0, 0, &workspace->hess_dir_w0, 0, 0);
+    blasfeo_dgemm_nn(n, nw, n, 1.0, &workspace->hess_fun, 0, 0, &workspace->hess_dir_w0, 0, 0, 0.0,
+                     &workspace->hess_tmp, 0, 0, &workspace->hess_tmp, 0, 0);
+    blasfeo_dgemm_tn(nw, nw, n, 1.0, &workspace->hess_dir_w0, 0, 0, &workspace->hess_tmp, 0, 0, 1.0,
+                     &workspace->S_hess, 0, 0, &workspace->S_hess, 0, 0);
+}
+
+
+
+/* Hessian contribution of integration step ss (forward-over-adjoint).
+ * Second order terms only enter through phi and f_LO, all other GNSF relations are linear, thus
+ * Hess += sum_i dyuhat_i^T * hess(lambda_vv_i^T phi) * dyuhat_i
+ *       + sum_i dx1k1uz1_i^T * hess(lambda_K2_i^T f_LO) * dx1k1uz1_i,
+ * with the directions taken w.r.t. the initial value via S_forw at the start of the step.
+ * Assumes the adjoint sweep state of step ss: lambda (adjoint of x at the end of the step),
+ * res_val (lambda_vv), J_r_vv factorized in ipiv and J_r_x1u not yet solved. */
+static void sim_gnsf_hessian_step(sim_gnsf_dims *dims, sim_opts *opts, sim_out *out,
+                                  sim_gnsf_memory *mem, gnsf_workspace *workspace,
+                                  gnsf_model *model, int ss)
+{
+    acados_timer casadi_timer, la_timer;
+
+    int nx      = dims->nx;
+    int nu      = dims->nu;
+    int nz      = dims->nz;
+    int nx1     = dims->nx1;
+    int nz1     = dims->nz1;
+    int n_out   = dims->n_out;
+    int ny      = dims->ny;
+    int nuhat   = dims->nuhat;
+    int nx2     = nx - nx1;
+    int nz2     = nz - nz1;
+
+    int num_stages = opts->ns;
+
+    int nvv = num_stages * n_out;
+    int nK1 = num_stages * nx1;
+    int nK2 = num_stages * (nx2 + nz2);
+    int nZ1 = num_stages * nz1;
+    int nxz2 = nx2 + nz2;
+    int nw = nx + nu;
+
+    double *A_dt = mem->A_dt;
+    double *b_dt = mem->b_dt;
+
+    struct blasfeo_dmat *dw_dw0 = &workspace->dw_dw0;
+    struct blasfeo_dmat *dvv_dw = &workspace->dvv_dw;
+    struct blasfeo_dmat *dK1_dw = &workspace->dK1_dw;
+    struct blasfeo_dmat *dZ1_dw = &workspace->dZ1_dw;
+    struct blasfeo_dmat *hess_dir = &workspace->hess_dir;
+    struct blasfeo_dmat *hess_fun = &workspace->hess_fun;
+    struct blasfeo_dmat *J_r_vv = &workspace->J_r_vv;
+    struct blasfeo_dmat *J_r_x1u = &workspace->J_r_x1u;
+    int *ipiv = workspace->ipiv;
+
+    struct blasfeo_dvec *K1_val = &workspace->K1_val;
+    struct blasfeo_dvec *Z1_val = &workspace->Z1_val;
+    struct blasfeo_dvec *x1_stage_val = &workspace->x1_stage_val;
+    struct blasfeo_dvec *x0_traj = &workspace->x0_traj;
+    struct blasfeo_dvec *lambda = &workspace->lambda;
+    struct blasfeo_dvec *lambda_K2 = &workspace->lambda_K2;
+
+    // dw_dw0 = [S_forw; 0 I] at the start of the step
+    blasfeo_dgecp(nx, nw, &workspace->S_forw_traj, ss * nx, 0, dw_dw0, 0, 0);
+    blasfeo_dgese(nu, nw, 0.0, dw_dw0, nx, 0);
+    blasfeo_ddiare(nu, 1.0, dw_dw0, nx, nx);
+
+    if (nx1 > 0 || nz1 > 0)
+    {
+        // dvv_dw = - J_r_vv \ [J_r_x1, 0, J_r_u]
+        acados_tic(&la_timer);
+        blasfeo_dgese(nvv, nw, 0.0, dvv_dw, 0, 0);
+        blasfeo_dgecpsc(nvv, nx1, -1.0, J_r_x1u, 0, 0, dvv_dw, 0, 0);
+        blasfeo_dgecpsc(nvv, nu, -1.0, J_r_x1u, 0, nx1, dvv_dw, 0, nx);
+        blasfeo_drowpe(nvv, ipiv, dvv_dw);
+        blasfeo_dtrsm_llnu(nvv, nw, 1.0, J_r_vv, 0, 0, dvv_dw, 0, 0, dvv_dw, 0, 0);
+        blasfeo_dtrsm_lunn(nvv, nw, 1.0, J_r_vv, 0, 0, dvv_dw, 0, 0, dvv_dw, 0, 0);
+
+        // dK1_dw = KKv * dvv_dw + [KKx, 0, KKu], dZ1_dw analogously
+        blasfeo_dgemm_nn(nK1, nw, nvv, 1.0, &mem->KKv, 0, 0, dvv_dw, 0, 0, 0.0, dK1_dw, 0, 0,
+                         dK1_dw, 0, 0);
+        blasfeo_dgead(nK1, nx1, 1.0, &mem->KKx, 0, 0, dK1_dw, 0, 0);
+        blasfeo_dgead(nK1, nu, 1.0, &mem->KKu, 0, 0, dK1_dw, 0, nx);
+        blasfeo_dgemm_nn(nZ1, nw, nvv, 1.0, &mem->ZZv, 0, 0, dvv_dw, 0, 0, 0.0, dZ1_dw, 0, 0,
+                         dZ1_dw, 0, 0);
+        blasfeo_dgead(nZ1, nx1, 1.0, &mem->ZZx, 0, 0, dZ1_dw, 0, 0);
+        blasfeo_dgead(nZ1, nu, 1.0, &mem->ZZu, 0, 0, dZ1_dw, 0, nx);
+        out->info->LAtime += acados_toc(&la_timer);
+
+        /* nonlinearity phi */
+        if (nvv > 0)
+        {
+            ext_fun_arg_t phi_hess_type_in[3];
+            void *phi_hess_in[3];
+            ext_fun_arg_t phi_hess_type_out[1];
+            void *phi_hess_out[1];
+
+            struct blasfeo_dvec_args y_in;
+            struct blasfeo_dvec_args lambda_vv_in;
+            y_in.x = &workspace->yy_traj[ss];
+            lambda_vv_in.x = &workspace->res_val;
+
+            phi_hess_type_in[0] = BLASFEO_DVEC_ARGS;
+            phi_hess_in[0] = &y_in;
+            phi_hess_type_in[1] = BLASFEO_DVEC;
+            phi_hess_in[1] = &workspace->uhat;
+            phi_hess_type_in[2] = BLASFEO_DVEC_ARGS;
+            phi_hess_in[2] = &lambda_vv_in;
+
+            phi_hess_type_out[0] = BLASFEO_DMAT;
+            phi_hess_out[0] = hess_fun;
+
+            for (int ii = 0; ii < num_stages; ii++)
+            {
+                y_in.xi = ii * ny;
+                lambda_vv_in.xi = ii * n_out;
+
+                acados_tic(&casadi_timer);
+                model->phi_hess->evaluate(model->phi_hess, phi_hess_type_in, phi_hess_in,
+                                          phi_hess_type_out, phi_hess_out);
+                out->info->ADtime += acados_toc(&casadi_timer);
+
+                acados_tic(&la_timer);
+                // d[y_i; uhat]/dw = [YYv_i * dvv_dw + [YYx_i, 0, YYu_i]; 0, 0, L_u]
+                blasfeo_dgemm_nn(ny, nw, nvv, 1.0, &mem->YYv, ii * ny, 0, dvv_dw, 0, 0, 0.0,
+                                 hess_dir, 0, 0, hess_dir, 0, 0);
+                blasfeo_dgead(ny, nx1, 1.0, &mem->YYx, ii * ny, 0, hess_dir, 0, 0);
+                blasfeo_dgead(ny, nu, 1.0, &mem->YYu, ii * ny, 0, hess_dir, 0, nx);
+                blasfeo_dgese(nuhat, nw, 0.0, hess_dir, ny, 0);
+                blasfeo_dgecp(nuhat, nu, &mem->Lu, 0, 0, hess_dir, ny, nx);
+
+                sim_gnsf_hess_add(ny + nuhat, nw, workspace);
+                out->info->LAtime += acados_toc(&la_timer);
+            }
+        }
+    }
+
+    /* linear output system, f_LO */
+    if (nxz2 > 0 && model->nontrivial_f_LO)
+    {
+        int nflo = 2 * nx1 + nu + nz1;
+
+        // recompute stage values of step ss
+        if (nx1 > 0 || nz1 > 0)
+        {
+            blasfeo_dgemv_n(nK1, nvv, 1.0, &mem->KKv, 0, 0, &workspace->vv_traj[ss], 0, 1.0,
+                            &workspace->K1u, 0, K1_val, 0);
+            blasfeo_dgemv_n(nK1, nx1, 1.0, &mem->KKx, 0, 0, x0_traj, ss * nx, 1.0, K1_val, 0,
+                            K1_val, 0);
+            blasfeo_dgemv_n(nZ1, nvv, 1.0, &mem->ZZv, 0, 0, &workspace->vv_traj[ss], 0, 1.0,
+                            &workspace->Zu, 0, Z1_val, 0);
+            blasfeo_dgemv_n(nZ1, nx1, 1.0, &mem->ZZx, 0, 0, x0_traj, ss * nx, 1.0, Z1_val, 0,
+                            Z1_val, 0);
+            for (int ii = 0; ii < num_stages; ii++)
+            {
+                blasfeo_dveccp(nx1, x0_traj, ss * nx, x1_stage_val, nx1 * ii);
+                for (int jj = 0; jj < num_stages; jj++)
+                    blasfeo_daxpy(nx1, A_dt[ii + num_stages * jj], K1_val, nx1 * jj, x1_stage_val,
+                                  nx1 * ii, x1_stage_val, nx1 * ii);
+            }
+        }
+
+        // lambda_K2 = M2^-T * [b_i * lambda_x2; 0]_i
+        acados_tic(&la_timer);
+        blasfeo_dvecse(nK2, 0.0, lambda_K2, 0);
+        for (int ii = 0; ii < num_stages; ii++)
+            blasfeo_daxpy(nx2, b_dt[ii], lambda, nx1, lambda_K2, ii * nxz2, lambda_K2, ii * nxz2);
+        blasfeo_dtrsv_utn(nK2, &mem->M2_LU, 0, 0, lambda_K2, 0, lambda_K2, 0);
+        blasfeo_dtrsv_ltu(nK2, &mem->M2_LU, 0, 0, lambda_K2, 0, lambda_K2, 0);
+        blasfeo_dvecpei(nK2, mem->ipivM2, lambda_K2, 0);
+        out->info->LAtime += acados_toc(&la_timer);
+
+        ext_fun_arg_t f_lo_hess_type_in[5];
+        void *f_lo_hess_in[5];
+        ext_fun_arg_t f_lo_hess_type_out[1];
+        void *f_lo_hess_out[1];
+
+        struct blasfeo_dvec_args f_lo_in_x1;
+        struct blasfeo_dvec_args f_lo_in_k1;
+        struct blasfeo_dvec_args f_lo_in_z1;
+        struct blasfeo_dvec_args f_lo_in_lambda;
+        f_lo_in_x1.x = x1_stage_val;
+        f_lo_in_k1.x = K1_val;
+        f_lo_in_z1.x = Z1_val;
+        f_lo_in_lambda.x = lambda_K2;
+
+        f_lo_hess_type_in[0] = BLASFEO_DVEC_ARGS;
+        f_lo_hess_in[0] = &f_lo_in_x1;
+        f_lo_hess_type_in[1] = BLASFEO_DVEC_ARGS;
+        f_lo_hess_in[1] = &f_lo_in_k1;
+        f_lo_hess_type_in[2] = BLASFEO_DVEC_ARGS;
+        f_lo_hess_in[2] = &f_lo_in_z1;
+        f_lo_hess_type_in[3] = BLASFEO_DVEC;
+        f_lo_hess_in[3] = &workspace->u0;
+        f_lo_hess_type_in[4] = BLASFEO_DVEC_ARGS;
+        f_lo_hess_in[4] = &f_lo_in_lambda;
+
+        f_lo_hess_type_out[0] = BLASFEO_DMAT;
+        f_lo_hess_out[0] = hess_fun;
+
+        for (int ii = 0; ii < num_stages; ii++)
+        {
+            f_lo_in_x1.xi = ii * nx1;
+            f_lo_in_k1.xi = ii * nx1;
+            f_lo_in_z1.xi = ii * nz1;
+            f_lo_in_lambda.xi = ii * nxz2;
+
+            acados_tic(&casadi_timer);
+            model->f_lo_hess->evaluate(model->f_lo_hess, f_lo_hess_type_in, f_lo_hess_in,
+                                       f_lo_hess_type_out, f_lo_hess_out);
+            out->info->ADtime += acados_toc(&casadi_timer);
+
+            acados_tic(&la_timer);
+            // d[x1_i; x1dot_i; u; z1_i]/dw, same ordering as the columns of the f_LO jacobian
+            blasfeo_dgese(nflo, nw, 0.0, hess_dir, 0, 0);
+            blasfeo_ddiare(nx1, 1.0, hess_dir, 0, 0);
+            for (int jj = 0; jj < num_stages; jj++)
+                blasfeo_dgead(nx1, nw, A_dt[ii + num_stages * jj], dK1_dw, jj * nx1, 0,
+                              hess_dir, 0, 0);
+            blasfeo_dgecp(nx1, nw, dK1_dw, ii * nx1, 0, hess_dir, nx1, 0);
+            blasfeo_ddiare(nu, 1.0, hess_dir, 2 * nx1, nx);
+            blasfeo_dgecp(nz1, nw, dZ1_dw, ii * nz1, 0, hess_dir, 2 * nx1 + nu, 0);
+
+            sim_gnsf_hess_add(nflo, nw, workspace);
+            out->info->LAtime += acados_toc(&la_timer);
+        }
+    }
 }
 
 
+
+
 int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, void *work_)
 {
     acados_timer tot_timer, casadi_timer, la_timer;
@@ -2175,8 +2579,7 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
     sim_opts *opts = (sim_opts *) args;
     sim_gnsf_dims *dims = (sim_gnsf_dims *) in->dims;
     gnsf_model *model = in->model;
-    gnsf_workspace *workspace =
-        (gnsf_workspace *) sim_gnsf_cast_workspace(config, dims, opts, work_);
+    gnsf_workspace *workspace = sim_gnsf_workspace_get(config, dims, opts, mem, work_);
 
     if ( opts->ns != opts->tableau_size )
     {
@@ -2219,6 +2622,19 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
         printf("ERROR sim_gnsf: mem->dt n!= in->T/opts->num_steps, check initialization\n");
         exit(1);
     }
+    if (opts->sens_hess)
+    {
+        if (n_out > 0 && (nx1 > 0 || nz1 > 0) && model->phi_hess == NULL)
+        {
+            printf("\nerror: sim_gnsf: sens_hess requires the model function phi_hess\n");
+            exit(1);
+        }
+        if (nxz2 > 0 && model->nontrivial_f_LO && model->f_lo_hess == NULL)
+        {
+            printf("\nerror: sim_gnsf: sens_hess requires the model function f_lo_hess\n");
+            exit(1);
+        }
+    }
 
     // assign variables from workspace
     struct blasfeo_dmat *J_r_vv =
@@ -2314,6 +2730,20 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
 
     double tmp_double;
 
+    // Jacobian reuse across calls
+    bool jac_across = opts->jac_reuse && opts->jac_reuse_across_calls;
+    if (opts->jac_reuse_across_calls && mem->ipiv_vv == NULL)
+    {
+        printf("\nerror: sim_gnsf: jac_reuse_across_calls was not set when the memory was created\n");
+        exit(1);
+    }
+    bool jac_valid = false;    // J_r_vv holds a factorization
+    bool jac_refresh = false;  // slow Newton contraction, refactorize at the next iteration
+    bool jac_fresh = false;    // factorization was computed in the current step
+    int jac_factorizations = 0;
+    int jac_skipped = 0;
+    double newton_step_prev = 0.0;
+
     // ONLY available for algebraic sensitivity propagation
     // struct blasfeo_dmat *Z0x = mem->Z0x;
     // struct blasfeo_dmat *Z0u = mem->Z0u;
@@ -2347,6 +2777,9 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
     blasfeo_dvecpe(nx, ipiv_x, lambda, 0);
     blasfeo_dvecpe(nx, ipiv_x, lambda_old, 0);
 
+    // second order terms vanish for fully linear models
+    if (opts->sens_hess)
+        blasfeo_dgese(nx + nu, nx + nu, 0.0, &workspace->S_hess, 0, 0);
 
     if (model->fully_linear && !mem->first_call)
     {
@@ -2514,9 +2947,24 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
          ************************************************/
         // printf("GNSF: nx %d, nz %d, nu %d, nx1 %d, nz1 %d\n", nx, nz, nu, nx1, nz1);
 
+        // start from the factorization of the previous call if the step size is close enough
+        if (jac_across && (nx1 > 0 || nz1 > 0) && mem->jac_valid &&
+            fabs(mem->dt - mem->jac_dt) <= opts->jac_reuse_step_rtol * mem->jac_dt)
+        {
+            blasfeo_dgecp(nvv, nvv, &mem->J_r_vv_LU, 0, 0, J_r_vv, 0, 0);
+            for (int ii = 0; ii < nvv; ii++)
+                ipiv[ii] = mem->ipiv_vv[ii];
+            jac_valid = true;
+            jac_skipped++;
+        }
+
         for (int ss = 0; ss < num_steps; ss++)
         {
             // STEP LOOP
+            jac_fresh = false;
+            // keep the forward sensitivities at the start of the step for the Hessian propagation
+            if (opts->sens_hess)
+                blasfeo_dgecp(nx, nx + nu, S_forw, 0, 0, &workspace->S_forw_traj, ss * nx, 0);
             // initialize lifted variables vv with solution of previous step
             if (ss > 0)
                 blasfeo_dveccp(nvv, &vv_traj[ss-1], 0, &vv_traj[ss], 0);
@@ -2529,13 +2977,17 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                 y_in.x = &yy_traj[ss];
                 for (int iter = 0; iter < newton_iter; iter++)
                 {  // NEWTON-ITERATION
+                    // with jac_reuse, J_r_vv is only factorized once, or refreshed if the
+                    // Newton contraction is too slow
+                    bool new_jac = !opts->jac_reuse || (iter == 0 && !jac_valid) || jac_refresh;
+
                     /* EVALUATE RESIDUAL FUNCTION & JACOBIAN */
 
                     blasfeo_dgemv_n(nyy, nvv, 1.0, YYv, 0, 0, &vv_traj[ss], 0, 1.0, yyss, nyy * ss,
                                     &yy_traj[ss], 0);
                     // printf("yy =  \n");
                     // blasfeo_print_exp_dvec(nyy, &yy_traj[ss], 0);
-                    if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+                    if (new_jac)
                     {
                         // set J_r_vv to unit matrix
                         blasfeo_dgese(nvv, nvv, 0.0, J_r_vv, 0, 0);
@@ -2550,7 +3002,7 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                         y_in.xi = ii * ny;
                         phi_fun_val_arg.xi = ii * n_out;
                         phi_jac_y_arg.ai = ii * n_out;
-                        if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+                        if (new_jac)
                         {
                             // evaluate
                             acados_tic(&casadi_timer);
@@ -2581,9 +3033,13 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                             // this is the actual value of the residual function!
                     acados_tic(&la_timer);
                     // factorize J_r_vv
-                    if ((opts->jac_reuse && (ss == 0) & (iter == 0)) || (!opts->jac_reuse))
+                    if (new_jac)
                     {
                         blasfeo_dgetrf_rp(nvv, nvv, J_r_vv, 0, 0, J_r_vv, 0, 0, ipiv);
+                        jac_factorizations++;
+                        jac_valid = true;
+                        jac_refresh = false;
+                        jac_fresh = true;
                     }
 
                     /* Solve linear system and update vv */
@@ -2594,10 +3050,24 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
 
                     blasfeo_daxpy(nvv, -1.0, res_val, 0, &vv_traj[ss], 0, &vv_traj[ss], 0);
 
+                    if (opts->newton_tol > 0 || jac_across)
+                        blasfeo_dvecnrm_inf(nvv, res_val, 0, &tmp_double);
+
+                    // monitor the contraction rate of the Newton steps, a factorization
+                    // that was not computed in this step is refreshed if it is too slow
+                    if (jac_across)
+                    {
+                        if (iter > 0 && !jac_fresh &&
+                            tmp_double > opts->jac_reuse_contraction_max * newton_step_prev)
+                        {
+                            jac_refresh = true;
+                        }
+                        newton_step_prev = tmp_double;
+                    }
+
                     // check early termination based on tolerance
                     if (opts->newton_tol > 0)
                     {
-                        blasfeo_dvecnrm_inf(nvv, res_val, 0, &tmp_double);
                         if (tmp_double < opts->newton_tol)
                         {
                             break;
@@ -2691,7 +3161,7 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
             }
 
             // Forward Sensitivities (via IND)
-            if (opts->sens_forw)
+            if (opts->sens_forw || opts->sens_hess)
             {
                 if (nx1 > 0 || nz1 > 0)
                 {
@@ -2699,11 +3169,19 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                     // update yy
                     blasfeo_dgemv_n(nyy, nvv, 1.0, YYv, 0, 0, &vv_traj[ss], 0, 1.0, yyss, nyy * ss,
                                     &yy_traj[ss], 0);
-                    // set J_r_vv to unit matrix
-                    blasfeo_dgese(nvv, nvv, 0.0, J_r_vv, 0, 0);
-                    for (int ii = 0; ii < nvv; ii++)
+
+                    // inexact sensitivities: keep the factorization used in the Newton iterations
+                    bool sens_jac_reuse = jac_across && opts->sens_jac_reuse && !opts->sens_hess &&
+                                          jac_valid && !jac_refresh;
+
+                    if (!sens_jac_reuse)
                     {
-                        blasfeo_dgein1(1.0, J_r_vv, ii, ii);
+                        // set J_r_vv to unit matrix
+                        blasfeo_dgese(nvv, nvv, 0.0, J_r_vv, 0, 0);
+                        for (int ii = 0; ii < nvv; ii++)
+                        {
+                            blasfeo_dgein1(1.0, J_r_vv, ii, ii);
+                        }
                     }
 
                     for (int ii = 0; ii < num_stages; ii++)
@@ -2718,8 +3196,9 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                         out->info->ADtime += acados_toc(&casadi_timer);
 
                         // build J_r_vv
-                        blasfeo_dgemm_nn(n_out, nvv, ny, -1.0, dPHI_dyuhat, ii * n_out, 0, YYv, ii * ny,
-                                        0, 1.0, J_r_vv, ii * n_out, 0, J_r_vv, ii * n_out, 0);
+                        if (!sens_jac_reuse)
+                            blasfeo_dgemm_nn(n_out, nvv, ny, -1.0, dPHI_dyuhat, ii * n_out, 0, YYv, ii * ny,
+                                            0, 1.0, J_r_vv, ii * n_out, 0, J_r_vv, ii * n_out, 0);
                         // build J_r_x1u
                         blasfeo_dgemm_nn(n_out, nx1, ny, -1.0, dPHI_dyuhat, ii * n_out, 0, YYx, ii * ny,
                                         0, 0.0, J_r_x1u, ii * n_out, 0, J_r_x1u, ii * n_out,
@@ -2732,8 +3211,18 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                                         nx1);  // + dPhi_duhat * L_u;
                     }
                     acados_tic(&la_timer);
-                    blasfeo_dgetrf_rp(nvv, nvv, J_r_vv, 0, 0, J_r_vv, 0, 0,
-                                            ipiv);        // factorize J_r_vv
+                    if (sens_jac_reuse)
+                    {
+                        jac_skipped++;
+                    }
+                    else
+                    {
+                        blasfeo_dgetrf_rp(nvv, nvv, J_r_vv, 0, 0, J_r_vv, 0, 0,
+                                                ipiv);        // factorize J_r_vv
+                        jac_factorizations++;
+                        jac_valid = true;
+                        jac_refresh = false;
+                    }
                     // printf("dPHI_dyuhat = (forward, ss = %d) \n", ss);
                     // blasfeo_print_exp_dmat(nvv, ny+nuhat, dPHI_dyuhat, 0, 0);
 
@@ -2862,13 +3351,25 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
             }
         }  // end step loop: ss
 
+        // keep the latest factorization for the next call, before the adjoint sweep overwrites it
+        if (jac_across && jac_valid && jac_factorizations > 0)
+        {
+            blasfeo_dgecp(nvv, nvv, J_r_vv, 0, 0, &mem->J_r_vv_LU, 0, 0);
+            for (int ii = 0; ii < nvv; ii++)
+                mem->ipiv_vv[ii] = ipiv[ii];
+            mem->jac_dt = mem->dt;
+            mem->jac_valid = true;
+        }
+        mem->jac_factorizations = jac_factorizations;
+        mem->jac_factorizations_skipped = jac_skipped;
+
 
 
     /************************************************
      * ADJOINT SENSITIVITY PROPAGATION
      ************************************************/
 
-        if (opts->sens_adj)
+        if (opts->sens_adj || opts->sens_hess)
         {
             for (int ss = num_steps - 1; ss >= 0; ss--)
             {
@@ -3000,6 +3501,9 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                     out->info->LAtime += acados_toc(&la_timer);
                 }
 
+                if (opts->sens_hess)
+                    sim_gnsf_hessian_step(dims, opts, out, mem, workspace, model, ss);
+
                 blasfeo_dveccp(nx + nu, lambda, 0, lambda_old, 0);
                 blasfeo_dgemv_t(nx, nu, 1.0, dPsi_du, 0, 0, lambda_old, 0, 1.0, lambda_old, nx,
                                 lambda, nx);  // update lambda_u
@@ -3027,11 +3531,17 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
         blasfeo_dcolpei(nx, ipiv_x, S_forw_new);
         blasfeo_unpack_dmat(nx, nx + nu, S_forw_new, 0, 0, out->S_forw, nx);
     }
-    if (opts->sens_adj)
+    if (opts->sens_adj || opts->sens_hess)
     {
         blasfeo_dvecpei(nx, ipiv_x, lambda, 0);
         blasfeo_unpack_dvec(nx + nu, lambda, 0, out->S_adj, 1);
     }
+    if (opts->sens_hess)
+    {
+        blasfeo_drowpei(nx, ipiv_x, &workspace->S_hess);
+        blasfeo_dcolpei(nx, ipiv_x, &workspace->S_hess);
+        blasfeo_unpack_dmat(nx + nu, nx + nu, &workspace->S_hess, 0, 0, out->S_hess, nx + nu);
+    }
     if (opts->sens_algebraic)
     {
         // permute rows and cols
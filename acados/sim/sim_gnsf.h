@@ -78,9 +78,15 @@ typedef struct
     external_function_generic *phi_fun;
     external_function_generic *phi_fun_jac_y;
     external_function_generic *phi_jac_y_uhat;
+    // hessian of lambda^T * phi w.r.t. [y; uhat], inputs: y, uhat, lambda (n_out);
+    // only needed for opts->sens_hess
+    external_function_generic *phi_hess;
 
     // f_lo: linear output function
     external_function_generic *f_lo_fun_jac_x1_x1dot_u_z;
+    // hessian of lambda^T * f_lo w.r.t. [x1; x1dot; u; z1], inputs: x1, x1dot, z1, u,
+    // lambda (nx2 + nz2); only needed for opts->sens_hess and nontrivial f_LO
+    external_function_generic *f_lo_hess;
 
     // to import model matrices
     external_function_generic *get_gnsf_matrices;
@@ -226,6 +232,19 @@ typedef struct
     struct blasfeo_dmat dPHI_dyuhat;
     struct blasfeo_dvec z0;
 
+    // memory only available if (opts->sens_hess), nh = max(ny + nuhat, 2 * nx1 + nu + nz1)
+    struct blasfeo_dmat S_forw_traj;   // (num_steps * nx) x (nx + nu), S_forw at the start of each step
+    struct blasfeo_dmat dw_dw0;        // (nx + nu) x (nx + nu), [S_forw; 0 I] of the current step
+    struct blasfeo_dmat dvv_dw;        // nvv x (nx + nu)
+    struct blasfeo_dmat dK1_dw;        // nK1 x (nx + nu)
+    struct blasfeo_dmat dZ1_dw;        // nZ1 x (nx + nu)
+    struct blasfeo_dmat hess_dir;      // nh x (nx + nu), directions of the function inputs
+    struct blasfeo_dmat hess_dir_w0;   // nh x (nx + nu), same w.r.t. initial value
+    struct blasfeo_dmat hess_fun;      // nh x nh, hessian of phi or f_lo
+    struct blasfeo_dmat hess_tmp;      // nh x (nx + nu)
+    struct blasfeo_dmat S_hess;        // (nx + nu) x (nx + nu)
+    struct blasfeo_dvec lambda_K2;     // nK2, adjoint of the linear output system
+
     // memory only available if (opts->sens_algebraic)
     // struct blasfeo_dvec y_one_stage;
     // struct blasfeo_dvec x0dot_1;
@@ -312,6 +331,24 @@ typedef struct
     double time_ad;
     double time_la;
 
+    // Newton matrix factorization kept across calls, only allocated if (opts->jac_reuse_across_calls)
+    struct blasfeo_dmat J_r_vv_LU;  // (nvv, nvv)
+    int *ipiv_vv;                   // nvv
+    double jac_dt;                  // step size J_r_vv_LU was factorized for
+    bool jac_valid;
+    int jac_factorizations;          // number of factorizations in the last call
+    int jac_factorizations_skipped;  // number of factorizations avoided by reuse in the last call
+
+    // cached workspace cast: pointer tables into the workspace, recast only if
+    // the workspace, ns or num_steps change
+    void *work_cast_memory;
+    acados_size_t work_cast_size;
+    void *work_cast;
+    void *work_cast_raw;
+    int work_cast_ns;
+    int work_cast_num_steps;
+    bool work_cast_sens_hess;
+
 } sim_gnsf_memory;
 
 
@@ -248,6 +248,8 @@ acados_size_t sim_irk_opts_calculate_size(void *config_, void *dims)
     size += ns_max * ns_max * sizeof(double);  // A_mat
     size += ns_max * sizeof(double);           // b_vec
     size += ns_max * sizeof(double);           // c_vec
+    size += 2 * ns_max * sizeof(double);       // simpl_eig
+    size += 2 * ns_max * ns_max * sizeof(double);  // simpl_transf1, simpl_transf2
 
     size += butcher_tableau_work_calculate_size(ns_max);
 
@@ -275,6 +277,9 @@ void *sim_irk_opts_assign(void *config_, void *dims, void *raw_memory)
     assign_and_advance_double(ns_max * ns_max, &opts->A_mat, &c_ptr);
     assign_and_advance_double(ns_max, &opts->b_vec, &c_ptr);
     assign_and_advance_double(ns_max, &opts->c_vec, &c_ptr);
+    assign_and_advance_double(2 * ns_max, &opts->simpl_eig, &c_ptr);
+    assign_and_advance_double(ns_max * ns_max, &opts->simpl_transf1, &c_ptr);
+    assign_and_advance_double(ns_max * ns_max, &opts->simpl_transf2, &c_ptr);
 
     assert((char *) raw_memory + sim_irk_opts_calculate_size(config_, dims) >= c_ptr);
 
@@ -283,6 +288,17 @@ void *sim_irk_opts_assign(void *config_, void *dims, void *raw_memory)
 
 
 
+static void sim_irk_opts_compute_tableau(sim_opts *opts)
+{
+    calculate_butcher_tableau(opts->ns, opts->collocation_type, opts->c_vec, opts->b_vec, opts->A_mat, opts->work);
+
+    // transformation for simplified Newton, cheap enough to always keep it consistent with the tableau
+    if (opts->collocation_type == GAUSS_LEGENDRE && opts->ns <= GAUSS_SIMPLIFIED_NS_MAX)
+        gauss_simplified(opts->ns, opts->simpl_eig, opts->simpl_transf1, opts->simpl_transf2, opts->work);
+}
+
+
+
 void sim_irk_opts_initialize_default(void *config_, void *dims_, void *opts_)
 {
     sim_irk_dims *dims = (sim_irk_dims *) dims_;
@@ -297,15 +313,23 @@ void sim_irk_opts_initialize_default(void *config_, void *dims_, void *opts_)
     opts->sens_adj = false;
     opts->sens_hess = false;
     opts->jac_reuse = true;
+    opts->simplified_newton = false;
     opts->exact_z_output = false;
     opts->ns = 3;
     opts->collocation_type = GAUSS_LEGENDRE;
     opts->newton_tol = 0.0;
+    opts->jac_reuse_across_calls = false;
+    opts->sens_jac_reuse = false;
+    opts->jac_reuse_contraction_max = 0.5;
+    opts->jac_reuse_step_rtol = 0.2;
+    opts->adaptive_step = false;
+    opts->num_steps_max = 20;
+    opts->step_tol = 1e-6;
 
     assert(opts->ns <= NS_MAX && "ns > NS_MAX!");
 
     // butcher tableau
-    calculate_butcher_tableau(opts->ns, opts->collocation_type, opts->c_vec, opts->b_vec, opts->A_mat, opts->work);
+    sim_irk_opts_compute_tableau(opts);
     // for consistency check
     opts->tableau_size = opts->ns;
     opts->cost_computation = false;
@@ -333,7 +357,7 @@ void sim_irk_opts_update(void *config_, void *dims, void *opts_)
 
     assert(opts->ns <= NS_MAX && "ns > NS_MAX!");
 
-    calculate_butcher_tableau(opts->ns, opts->collocation_type, opts->c_vec, opts->b_vec, opts->A_mat, opts->work);
+    sim_irk_opts_compute_tableau(opts);
 
     opts->tableau_size = opts->ns;
 
@@ -373,6 +397,91 @@ void sim_irk_opts_get(void *config_, void *opts_, const char *field, void *value
 
 
 
+/************************************************
+ * workspace cast
+ ************************************************/
+
+// size of the workspace struct and the blasfeo structs it points to
+static acados_size_t sim_irk_workspace_structs_calculate_size(sim_irk_dims *dims, sim_opts *opts)
+{
+    int steps = sim_opts_steps_max(opts);
+
+    acados_size_t size = sizeof(sim_irk_workspace);
+
+    if (opts->sens_adj || opts->sens_hess)
+    {
+        size += 2 * steps * sizeof(struct blasfeo_dvec);  // xn_traj, K_traj
+    }
+    size += 6 * sizeof(struct blasfeo_dvec);  // rG, K, lambda, lambdaK, xt, xn
+
+    if (opts->simplified_newton)
+    {
+        size += 1 * sizeof(struct blasfeo_dvec);  // rG_simpl
+        size += (opts->ns + 1) / 2 * sizeof(struct blasfeo_dmat);  // simpl_blk
+    }
+
+    if (!opts->sens_hess)
+    {
+        size += 4 * sizeof(struct blasfeo_dmat);  // dG_dxu, dG_dK, dK_dxu, S_forw
+    }
+    else
+    {
+        size += (4 * steps + 1) * sizeof(struct blasfeo_dmat);  // dG_dxu, dG_dK, dK_dxu, S_forw
+    }
+
+    if (opts->cost_computation)
+    {
+        size += 4 * sizeof(struct blasfeo_dmat);  // J_y_tilde, tmp_nux_ny, tmp_nux_ny2, S_forw_stage
+        size += 2 * sizeof(struct blasfeo_dvec);  // tmp_ny, nls_res
+        if (opts->cost_type == CONVEX_OVER_NONLINEAR)
+        {
+            size += 3 * sizeof(struct blasfeo_dmat);  // tmp_nv_ny, W, Jt_z
+        }
+    }
+
+    size += 8;  // initial alignment
+
+    return size;
+}
+
+
+
+// the sensitivity options are switched at runtime, e.g. by ocp_nlp_dynamics_cont,
+// thus the cached pointer tables are sized for the largest layout
+static acados_size_t sim_irk_workspace_cast_memory_calculate_size(sim_irk_dims *dims, sim_opts *opts)
+{
+    sim_opts opts_max = *opts;
+    opts_max.sens_adj = true;
+    opts_max.sens_hess = true;
+    opts_max.cost_type = CONVEX_OVER_NONLINEAR;
+    opts_max.simplified_newton = true;
+
+    acados_size_t size = sim_irk_workspace_structs_calculate_size(dims, &opts_max);
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+static bool sim_irk_workspace_cast_opts_equal(sim_opts *opts_a, sim_opts *opts_b)
+{
+    return opts_a->ns == opts_b->ns &&
+           opts_a->num_steps == opts_b->num_steps &&
+           opts_a->adaptive_step == opts_b->adaptive_step &&
+           opts_a->num_steps_max == opts_b->num_steps_max &&
+           opts_a->sens_adj == opts_b->sens_adj &&
+           opts_a->sens_hess == opts_b->sens_hess &&
+           opts_a->cost_computation == opts_b->cost_computation &&
+           opts_a->cost_type == opts_b->cost_type &&
+           opts_a->output_z == opts_b->output_z &&
+           opts_a->sens_algebraic == opts_b->sens_algebraic &&
+           opts_a->exact_z_output == opts_b->exact_z_output &&
+           opts_a->simplified_newton == opts_b->simplified_newton;
+}
+
+
+
 /************************************************
  * memory
  ************************************************/
@@ -400,6 +509,17 @@ acados_size_t sim_irk_memory_calculate_size(void *config, void *dims_, void *opt
         size += 1 * blasfeo_memsize_dmat(nx+nu, nx+nu);  // cost_hess
     }
 
+    if (opts->jac_reuse_across_calls)
+    {
+        int nK = (nx + nz) * opts->ns;
+        size += 1 * sizeof(struct blasfeo_dmat);  // jac_LU
+        size += 1 * blasfeo_memsize_dmat(nK, nK);  // jac_LU
+        size += (opts->ns + 1) * (nx + nz) * sizeof(int);  // jac_ipiv
+        size += 64;  // blasfeo_mem align
+    }
+
+    size += sim_irk_workspace_cast_memory_calculate_size(dims, opts);  // work_cast_memory
+
     make_int_multiple_of(8, &size);
 
     return size;
@@ -428,16 +548,46 @@ void *sim_irk_memory_assign(void *config, void *dims_, void *opts_, void *raw_me
     {
         assign_and_advance_blasfeo_dmat_structs(1, &mem->cost_hess, &c_ptr);
     }
+    if (opts->jac_reuse_across_calls)
+    {
+        assign_and_advance_blasfeo_dmat_structs(1, &mem->jac_LU, &c_ptr);
+    }
+    else
+    {
+        mem->jac_LU = NULL;
+    }
+
+    // cached workspace cast
+    mem->work_cast_size = sim_irk_workspace_cast_memory_calculate_size(dims, opts);
+    mem->work_cast_memory = c_ptr;
+    c_ptr += mem->work_cast_size;
+    mem->work_cast = NULL;
+    mem->work_cast_raw = NULL;
 
     // assign doubles
     assign_and_advance_double(nz, &mem->z, &c_ptr);
     assign_and_advance_double(nx, &mem->xdot, &c_ptr);
 
+    if (opts->jac_reuse_across_calls)
+    {
+        assign_and_advance_int((opts->ns + 1) * (nx + nz), &mem->jac_ipiv, &c_ptr);
+    }
+    else
+    {
+        mem->jac_ipiv = NULL;
+    }
+
     if (opts->cost_computation)
     {
         align_char_to(64, &c_ptr);
         assign_and_advance_blasfeo_dmat_mem(nx+nu, nx+nu, mem->cost_hess, &c_ptr);
     }
+    if (opts->jac_reuse_across_calls)
+    {
+        int nK = (nx + nz) * opts->ns;
+        align_char_to(64, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nK, nK, mem->jac_LU, &c_ptr);
+    }
 
     // initialization of xdot, z is 0 if not changed
     for (int ii = 0; ii < nx; ii++)
@@ -445,6 +595,16 @@ void *sim_irk_memory_assign(void *config, void *dims_, void *opts_, void *raw_me
     for (int ii = 0; ii < nz; ii++)
         mem->z[ii] = 0.0;
 
+    mem->step_size = 0.0;
+    mem->steps_accepted = 0;
+    mem->steps_rejected = 0;
+    mem->step_cap_reached = 0;
+
+    mem->jac_step = 0.0;
+    mem->jac_valid = false;
+    mem->jac_factorizations = 0;
+    mem->jac_factorizations_skipped = 0;
+
     return mem;
 }
 
@@ -539,6 +699,11 @@ int sim_irk_memory_set_to_zero(void *config_, void * dims_, void *opts_, void *m
         for (int ii=0; ii < nx; ii++)
             mem->xdot[ii] = 0.0;
     }
+    else if (!strcmp(field, "jac_factorization"))
+    {
+        // invalidates the factorization kept across calls
+        mem->jac_valid = false;
+    }
     else
     {
         printf("sim_irk_memory_set: field %s is not supported! \n", field);
@@ -574,6 +739,36 @@ void sim_irk_memory_get(void *config_, void *dims_, void *mem_, const char *fiel
         struct blasfeo_dmat **ptr = value;
         *ptr = mem->cost_hess;
     }
+    else if (!strcmp(field, "steps_accepted"))
+    {
+        int *ptr = value;
+        *ptr = mem->steps_accepted;
+    }
+    else if (!strcmp(field, "steps_rejected"))
+    {
+        int *ptr = value;
+        *ptr = mem->steps_rejected;
+    }
+    else if (!strcmp(field, "step_cap_reached"))
+    {
+        int *ptr = value;
+        *ptr = mem->step_cap_reached;
+    }
+    else if (!strcmp(field, "step_size"))
+    {
+        double *ptr = value;
+        *ptr = mem->step_size;
+    }
+    else if (!strcmp(field, "jac_factorizations"))
+    {
+        int *ptr = value;
+        *ptr = mem->jac_factorizations;
+    }
+    else if (!strcmp(field, "jac_factorizations_skipped"))
+    {
+        int *ptr = value;
+        *ptr = mem->jac_factorizations_skipped;
+    }
     else
     {
         printf("sim_irk_memory_get field %s is not supported! \n", field);
@@ -601,16 +796,23 @@ acados_size_t sim_irk_workspace_calculate_size(void *config_, void *dims_, void
 
     int nK = (nx + nz) * ns;
 
-    int steps = opts->num_steps;
+    int steps = sim_opts_steps_max(opts);
 
     acados_size_t size = sizeof(sim_irk_workspace);
 
-    if (opts->sens_algebraic || opts->output_z)
+    if (opts->sens_algebraic || opts->output_z || opts->adaptive_step)
     {
         size += (nx + nz) * sizeof(int);    // ipiv_one_stage
         size += ns * sizeof(double);        // Z_work
     }
 
+    if (opts->adaptive_step)
+    {
+        size += blasfeo_memsize_dvec(nx + nz);  // xdotz0
+        if (opts->sens_adj || opts->sens_hess)
+            size += 2 * steps * sizeof(double);  // step_traj, t_traj
+    }
+
     /* blasfeo structs */
     size += 4 * sizeof(struct blasfeo_dvec);          // rG, K, xt, xn
 
@@ -619,6 +821,16 @@ acados_size_t sim_irk_workspace_calculate_size(void *config_, void *dims_, void
     }
 
     size += 2 * sizeof(struct blasfeo_dvec);  // lambda, lambdaK
+
+    if (opts->simplified_newton)
+    {
+        size += 1 * sizeof(struct blasfeo_dvec);  // rG_simpl
+        size += (ns + 1) / 2 * sizeof(struct blasfeo_dmat);  // simpl_blk
+        size += blasfeo_memsize_dvec(nK);  // rG_simpl
+        size += (ns + 1) / 2 * blasfeo_memsize_dmat(2 * (nx + nz), 2 * (nx + nz));  // simpl_blk
+        size += (ns + 1) * (nx + nz) * sizeof(int);  // ipiv_simpl
+    }
+
     if (!opts->sens_hess)
     {
         size += 4 * sizeof(struct blasfeo_dmat);  // dG_dxu, dG_dK, dK_dxu, S_forw
@@ -688,9 +900,12 @@ acados_size_t sim_irk_workspace_calculate_size(void *config_, void *dims_, void
     size += blasfeo_memsize_dmat(nx + nz, nu);      // df_du
     size += blasfeo_memsize_dmat(nx + nz, nz);      // df_dz
 
-    if (opts->sens_algebraic && opts->exact_z_output)
+    if ((opts->sens_algebraic && opts->exact_z_output) || opts->adaptive_step)
     {
         size += blasfeo_memsize_dmat(nx + nz, nx + nz);  // df_dxdotz
+    }
+    if (opts->sens_algebraic && opts->exact_z_output)
+    {
         size += blasfeo_memsize_dmat(nx + nz, nx + nu);  // dk0_dxu
     }
 
@@ -701,7 +916,10 @@ acados_size_t sim_irk_workspace_calculate_size(void *config_, void *dims_, void
     return size;
 }
 
-static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, void *raw_memory)
+/* The workspace struct and the blasfeo structs are assigned in structs_memory,
+ * the blasfeo memory in raw_memory, at the same offset as for structs_memory == raw_memory. */
+static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, void *structs_memory,
+                                    void *raw_memory)
 {
     sim_opts *opts = opts_;
     sim_irk_dims *dims = (sim_irk_dims *) dims_;
@@ -714,9 +932,9 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
     int ny = dims->ny;
     int nK = (nx + nz) * ns;
 
-    int steps = opts->num_steps;
+    int steps = sim_opts_steps_max(opts);
 
-    char *c_ptr = (char *) raw_memory;
+    char *c_ptr = (char *) structs_memory;
 
     // initial align
     align_char_to(8, &c_ptr);
@@ -734,6 +952,12 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
     assign_and_advance_blasfeo_dvec_structs(1, &workspace->lambda, &c_ptr);
     assign_and_advance_blasfeo_dvec_structs(1, &workspace->lambdaK, &c_ptr);
 
+    if (opts->simplified_newton)
+    {
+        assign_and_advance_blasfeo_dvec_structs(1, &workspace->rG_simpl, &c_ptr);
+        assign_and_advance_blasfeo_dmat_structs((ns + 1) / 2, &workspace->simpl_blk, &c_ptr);
+    }
+
     // dG_dxu, dG_dK, dK_dxu, S_forw
     if (!opts->sens_hess){
         assign_and_advance_blasfeo_dmat_structs(1, &workspace->dG_dxu, &c_ptr);
@@ -765,6 +989,9 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
         assign_and_advance_blasfeo_dvec_structs(1, &workspace->nls_res, &c_ptr);
     }
 
+    // continue in raw_memory
+    c_ptr = (char *) raw_memory + (c_ptr - (char *) structs_memory);
+
     /* algin c_ptr to 64 blasfeo_dmat_mem has to be assigned directly after that  */
     align_char_to(64, &c_ptr);
 
@@ -809,9 +1036,18 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
     assign_and_advance_blasfeo_dmat_mem(nx + nz, nu, &workspace->df_du, &c_ptr);
     assign_and_advance_blasfeo_dmat_mem(nx + nz, nz, &workspace->df_dz, &c_ptr);
 
-    if (opts->sens_algebraic && opts->exact_z_output)
+    if (opts->simplified_newton)
+    {
+        for (int ii = 0; ii < (ns + 1) / 2; ii++)
+            assign_and_advance_blasfeo_dmat_mem(2 * (nx + nz), 2 * (nx + nz), &workspace->simpl_blk[ii], &c_ptr);
+    }
+
+    if ((opts->sens_algebraic && opts->exact_z_output) || opts->adaptive_step)
     {
         assign_and_advance_blasfeo_dmat_mem(nx + nz, nx + nz, &workspace->df_dxdotz, &c_ptr);
+    }
+    if (opts->sens_algebraic && opts->exact_z_output)
+    {
         assign_and_advance_blasfeo_dmat_mem(nx + nz, nx + nu, &workspace->dk0_dxu, &c_ptr);
     }
 
@@ -829,6 +1065,12 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
     assign_and_advance_blasfeo_dvec_mem(nx + nu, workspace->lambda, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nK, workspace->lambdaK, &c_ptr);
 
+    if (opts->simplified_newton)
+        assign_and_advance_blasfeo_dvec_mem(nK, workspace->rG_simpl, &c_ptr);
+
+    if (opts->adaptive_step)
+        assign_and_advance_blasfeo_dvec_mem(nx + nz, &workspace->xdotz0, &c_ptr);
+
 
     if ( opts->sens_adj || opts->sens_hess ){
         for (int i = 0; i < steps; i++)
@@ -838,11 +1080,20 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
         }
     }
 
-    if (opts->sens_algebraic || opts->output_z){
+    if (opts->adaptive_step && (opts->sens_adj || opts->sens_hess))
+    {
+        assign_and_advance_double(steps, &workspace->step_traj, &c_ptr);
+        assign_and_advance_double(steps, &workspace->t_traj, &c_ptr);
+    }
+
+    if (opts->sens_algebraic || opts->output_z || opts->adaptive_step){
         assign_and_advance_double(ns, &workspace->Z_work, &c_ptr);
         assign_and_advance_int((nx + nz), &workspace->ipiv_one_stage, &c_ptr);
     }
 
+    if (opts->simplified_newton)
+        assign_and_advance_int((ns + 1) * (nx + nz), &workspace->ipiv_simpl, &c_ptr);
+
     if (!opts->sens_hess){
         assign_and_advance_int(nK, &workspace->ipiv, &c_ptr);
     } else {
@@ -858,6 +1109,27 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
 }
 
 
+static sim_irk_workspace *sim_irk_workspace_get(void *config, sim_irk_dims *dims, sim_opts *opts,
+                                                sim_irk_memory *mem, void *work_)
+{
+    if (mem->work_cast_raw == work_ && sim_irk_workspace_cast_opts_equal(&mem->work_cast_opts, opts))
+        return mem->work_cast;
+
+    if (sim_irk_workspace_structs_calculate_size(dims, opts) <= mem->work_cast_size)
+    {
+        mem->work_cast = sim_irk_workspace_cast(config, dims, opts, mem->work_cast_memory, work_);
+        mem->work_cast_raw = work_;
+        mem->work_cast_opts = *opts;
+        return mem->work_cast;
+    }
+
+    // layout changed beyond the cached size, cast in place
+    mem->work_cast_raw = NULL;
+    return sim_irk_workspace_cast(config, dims, opts, work_, work_);
+}
+
+
+
 size_t sim_irk_get_external_fun_workspace_requirement(void *config_, void *dims_, void *opts_, void *model_)
 {
     irk_model *model = model_;
@@ -1112,6 +1384,241 @@ void sim_irk_compute_z_and_algebraic_sens(sim_irk_dims *dims, sim_opts *opts, si
  * integrator
  ************************************************/
 
+/* simplified Newton: with the Jacobians frozen at one point, the Newton matrix
+ * I (x) [df_dxdot, df_dz] + step * A (x) [df_dx, 0] is transformed with A^{-1} = V blkdiag(eig) V^{-1}
+ * into blocks eig (x) [df_dxdot, df_dz] + step * I (x) [df_dx, 0] of size (nx+nz) for real and
+ * 2*(nx+nz) for complex pair eigenvalues, which are factorized separately */
+static void sim_irk_simplified_newton_factorize(sim_irk_dims *dims, sim_opts *opts,
+                                                sim_irk_workspace *workspace, double step)
+{
+    int ns = opts->ns;
+    int nx = dims->nx;
+    int nz = dims->nz;
+    int n = nx + nz;
+
+    double *eig = opts->simpl_eig;
+
+    for (int i0 = 0; i0 < ns; i0 += 2)
+    {
+        int nb = (i0 + 1 < ns) ? 2 : 1;
+        struct blasfeo_dmat *blk = &workspace->simpl_blk[i0 / 2];
+
+        blasfeo_dgese(nb * n, nb * n, 0.0, blk, 0, 0);
+        for (int pp = 0; pp < nb; pp++)
+        {
+            for (int qq = 0; qq < nb; qq++)
+            {
+                double e = eig[2 * (i0 + pp) + qq];
+                blasfeo_dgead(n, nx, e, &workspace->df_dxdot, 0, 0, blk, pp * n, qq * n);
+                blasfeo_dgead(n, nz, e, &workspace->df_dz, 0, 0, blk, pp * n, qq * n + nx);
+            }
+            blasfeo_dgead(n, nx, step, &workspace->df_dx, 0, 0, blk, pp * n, pp * n);
+        }
+        blasfeo_dgetrf_rp(nb * n, nb * n, blk, 0, 0, blk, 0, 0, &workspace->ipiv_simpl[i0 * n]);
+    }
+}
+
+
+
+// overwrites the stage-wise residual rG with the Newton step in the ordering of K
+static void sim_irk_simplified_newton_solve(sim_irk_dims *dims, sim_opts *opts,
+                                            sim_irk_workspace *workspace)
+{
+    int ns = opts->ns;
+    int nx = dims->nx;
+    int nz = dims->nz;
+    int n = nx + nz;
+    int nK = n * ns;
+
+    double *transf1 = opts->simpl_transf1;
+    double *transf2 = opts->simpl_transf2;
+
+    struct blasfeo_dvec *rG = workspace->rG;
+    struct blasfeo_dvec *tmp = workspace->rG_simpl;
+
+    // tmp = (transf1 (x) I) rG
+    for (int pp = 0; pp < ns; pp++)
+    {
+        blasfeo_dvecse(n, 0.0, tmp, pp * n);
+        for (int qq = 0; qq < ns; qq++)
+            blasfeo_daxpy(n, transf1[pp + ns * qq], rG, qq * n, tmp, pp * n, tmp, pp * n);
+    }
+
+    // decoupled block solves
+    for (int i0 = 0; i0 < ns; i0 += 2)
+    {
+        int nb = (i0 + 1 < ns) ? 2 : 1;
+        struct blasfeo_dmat *blk = &workspace->simpl_blk[i0 / 2];
+
+        blasfeo_dvecpe(nb * n, &workspace->ipiv_simpl[i0 * n], tmp, i0 * n);
+        blasfeo_dtrsv_lnu(nb * n, blk, 0, 0, tmp, i0 * n, tmp, i0 * n);
+        blasfeo_dtrsv_unn(nb * n, blk, 0, 0, tmp, i0 * n, tmp, i0 * n);
+    }
+
+    // rG = (transf2 (x) I) tmp, ordered as K = (k_1,..., k_{ns},z_1,..., z_{ns})
+    blasfeo_dvecse(nK, 0.0, rG, 0);
+    for (int jj = 0; jj < ns; jj++)
+    {
+        for (int pp = 0; pp < ns; pp++)
+        {
+            double t = transf2[jj + ns * pp];
+            blasfeo_daxpy(nx, t, tmp, pp * n, rG, jj * nx, rG, jj * nx);
+            blasfeo_daxpy(nz, t, tmp, pp * n + nx, rG, ns * nx + jj * nz, rG, ns * nx + jj * nz);
+        }
+    }
+}
+
+
+
+/* local error estimate for adaptive step size control: the collocation polynomial is extrapolated
+ * to the start of the step and its residual r = f(xn, p'(0), z(0)) is filtered with the Jacobian
+ * as in Radau5, err = gamma * step * [df_dxdot + gamma * step * df_dx, df_dz]^{-1} * r, gamma = 1/ns;
+ * the estimate is of order ns+1, i.e. conservative for Gauss-Legendre and Radau IIA;
+ * returns the scaled error norm and leaves the new state in xt */
+static double sim_irk_local_error_norm(sim_irk_dims *dims, sim_opts *opts, sim_irk_workspace *workspace,
+                                       irk_model *model, double *u, double t_step, double step,
+                                       double *timing_ad, double *timing_la)
+{
+    int nx = dims->nx;
+    int nz = dims->nz;
+    int ns = opts->ns;
+    double gamma = 1.0 / ns;
+
+    acados_timer timer;
+
+    struct blasfeo_dvec *K = workspace->K;
+    struct blasfeo_dvec *xn = workspace->xn;
+    struct blasfeo_dvec *xt = workspace->xt;
+    struct blasfeo_dvec *rG = workspace->rG;
+    struct blasfeo_dvec *xdotz0 = &workspace->xdotz0;
+    struct blasfeo_dmat *df_dxdotz = &workspace->df_dxdotz;
+    double *Z_work = workspace->Z_work;
+    int *ipiv_one_stage = workspace->ipiv_one_stage;
+
+    // new state
+    blasfeo_dveccp(nx, xn, 0, xt, 0);
+    for (int ii = 0; ii < ns; ii++)
+        blasfeo_daxpy(nx, step * opts->b_vec[ii], K, ii * nx, xt, 0, xt, 0);
+
+    // xdot, z of the collocation polynomial at the start of the step
+    double value;
+    for (int ii = 0; ii < nx; ii++)
+    {
+        for (int jj = 0; jj < ns; jj++)
+            Z_work[jj] = blasfeo_dvecex1(K, nx * jj + ii);
+        neville_algorithm(0.0, ns - 1, opts->c_vec, Z_work, &value);
+        blasfeo_pack_dvec(1, &value, 1, xdotz0, ii);
+    }
+    for (int ii = 0; ii < nz; ii++)
+    {
+        for (int jj = 0; jj < ns; jj++)
+            Z_work[jj] = blasfeo_dvecex1(K, nx * ns + nz * jj + ii);
+        neville_algorithm(0.0, ns - 1, opts->c_vec, Z_work, &value);
+        blasfeo_pack_dvec(1, &value, 1, xdotz0, nx + ii);
+    }
+
+    // residual and Jacobians
+    ext_fun_arg_t impl_ode_type_in[5];
+    void *impl_ode_in[5];
+    struct blasfeo_dvec_args xdot_in;
+    struct blasfeo_dvec_args z_in;
+    xdot_in.x = xdotz0;
+    xdot_in.xi = 0;
+    z_in.x = xdotz0;
+    z_in.xi = nx;
+    impl_ode_type_in[0] = BLASFEO_DVEC;
+    impl_ode_in[0] = xn;
+    impl_ode_type_in[1] = BLASFEO_DVEC_ARGS;
+    impl_ode_in[1] = &xdot_in;
+    impl_ode_type_in[2] = COLMAJ;
+    impl_ode_in[2] = u;
+    impl_ode_type_in[3] = BLASFEO_DVEC_ARGS;
+    impl_ode_in[3] = &z_in;
+    impl_ode_type_in[4] = COLMAJ;
+    impl_ode_in[4] = &t_step;
+
+    ext_fun_arg_t impl_ode_type_out[4];
+    void *impl_ode_out[4];
+    struct blasfeo_dvec_args res_out;
+    res_out.x = rG;
+    res_out.xi = 0;
+    impl_ode_type_out[0] = BLASFEO_DVEC_ARGS;
+    impl_ode_out[0] = &res_out;
+    impl_ode_type_out[1] = BLASFEO_DMAT;
+    impl_ode_out[1] = &workspace->df_dx;
+    impl_ode_type_out[2] = BLASFEO_DMAT;
+    impl_ode_out[2] = &workspace->df_dxdot;
+    impl_ode_type_out[3] = BLASFEO_DMAT;
+    impl_ode_out[3] = &workspace->df_dz;
+
+    acados_tic(&timer);
+    model->impl_ode_fun_jac_x_xdot_z->evaluate(model->impl_ode_fun_jac_x_xdot_z,
+            impl_ode_type_in, impl_ode_in, impl_ode_type_out, impl_ode_out);
+    *timing_ad += acados_toc(&timer);
+
+    // filter the residual
+    acados_tic(&timer);
+    blasfeo_dgecp(nx + nz, nx, &workspace->df_dxdot, 0, 0, df_dxdotz, 0, 0);
+    blasfeo_dgead(nx + nz, nx, gamma * step, &workspace->df_dx, 0, 0, df_dxdotz, 0, 0);
+    blasfeo_dgecp(nx + nz, nz, &workspace->df_dz, 0, 0, df_dxdotz, 0, nx);
+    blasfeo_dgetrf_rp(nx + nz, nx + nz, df_dxdotz, 0, 0, df_dxdotz, 0, 0, ipiv_one_stage);
+    blasfeo_dvecsc(nx + nz, gamma * step, rG, 0);
+    blasfeo_dvecpe(nx + nz, ipiv_one_stage, rG, 0);
+    blasfeo_dtrsv_lnu(nx + nz, df_dxdotz, 0, 0, rG, 0, rG, 0);
+    blasfeo_dtrsv_unn(nx + nz, df_dxdotz, 0, 0, rG, 0, rG, 0);
+    *timing_la += acados_toc(&timer);
+
+    return sim_step_error_norm(nx, rG->pa, xn->pa, xt->pa, opts->step_tol);
+}
+
+
+
+// copies the Newton matrix factorization between the workspace and the memory kept
+// across calls; for simplified Newton the blocks sit on the diagonal of mem->jac_LU
+static void sim_irk_jac_copy(sim_irk_dims *dims, sim_opts *opts, sim_irk_workspace *workspace,
+                             struct blasfeo_dmat *dG_dK_ss, int *ipiv_ss, sim_irk_memory *mem,
+                             bool to_memory)
+{
+    int ns = opts->ns;
+    int n = dims->nx + dims->nz;
+    int nK = n * ns;
+
+    if (opts->simplified_newton)
+    {
+        for (int i0 = 0; i0 < ns; i0 += 2)
+        {
+            int nb = (i0 + 1 < ns) ? 2 : 1;
+            struct blasfeo_dmat *blk = &workspace->simpl_blk[i0 / 2];
+            if (to_memory)
+                blasfeo_dgecp(nb * n, nb * n, blk, 0, 0, mem->jac_LU, i0 * n, i0 * n);
+            else
+                blasfeo_dgecp(nb * n, nb * n, mem->jac_LU, i0 * n, i0 * n, blk, 0, 0);
+        }
+        for (int ii = 0; ii < (ns + 1) * n; ii++)
+        {
+            if (to_memory)
+                mem->jac_ipiv[ii] = workspace->ipiv_simpl[ii];
+            else
+                workspace->ipiv_simpl[ii] = mem->jac_ipiv[ii];
+        }
+    }
+    else
+    {
+        if (to_memory)
+            blasfeo_dgecp(nK, nK, dG_dK_ss, 0, 0, mem->jac_LU, 0, 0);
+        else
+            blasfeo_dgecp(nK, nK, mem->jac_LU, 0, 0, dG_dK_ss, 0, 0);
+        for (int ii = 0; ii < nK; ii++)
+        {
+            if (to_memory)
+                mem->jac_ipiv[ii] = ipiv_ss[ii];
+            else
+                ipiv_ss[ii] = mem->jac_ipiv[ii];
+        }
+    }
+}
+
+
 int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, void *work_)
 {
     acados_timer timer, timer_ad, timer_la;
@@ -1134,13 +1641,20 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     }
     int ns = opts->ns;
 
+    if (opts->simplified_newton &&
+        (opts->collocation_type != GAUSS_LEGENDRE || ns > GAUSS_SIMPLIFIED_NS_MAX))
+    {
+        printf("\nerror: sim_irk: simplified_newton requires GAUSS_LEGENDRE with ns <= %d\n",
+               GAUSS_SIMPLIFIED_NS_MAX);
+        exit(1);
+    }
+
     void *dims_ = in->dims;
     sim_irk_dims *dims = (sim_irk_dims *) dims_;
-    sim_irk_workspace *workspace =
-        (sim_irk_workspace *) sim_irk_workspace_cast(config, dims, opts, work_);
-
     sim_irk_memory *mem = (sim_irk_memory *) mem_;
 
+    sim_irk_workspace *workspace = sim_irk_workspace_get(config, dims, opts, mem, work_);
+
     irk_model *model = in->model;
 
     if (model->impl_ode_fun == 0)
@@ -1166,6 +1680,32 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     int num_steps = opts->num_steps;
     double step = in->T / num_steps;
 
+    // adaptive step size control
+    bool adaptive = opts->adaptive_step;
+    sim_step_control step_ctrl;
+    sim_step_control_init(&step_ctrl, in->T, mem->step_size > 0.0 ? mem->step_size : step,
+                          sim_opts_steps_max(opts));
+    double t_step = t0;  // start time of the current step
+    double step_jac = step;  // step size of the last Jacobian factorization
+
+    // Jacobian reuse across calls
+    bool jac_across = opts->jac_reuse && opts->jac_reuse_across_calls;
+    if (opts->jac_reuse_across_calls && mem->jac_LU == NULL)
+    {
+        printf("\nerror: sim_irk: jac_reuse_across_calls was not set when the memory was created\n");
+        exit(1);
+    }
+    bool jac_valid = false;    // the workspace holds a factorization for step_jac
+    bool jac_restored = false;
+    bool jac_refresh = false;  // slow Newton contraction, refactorize at the next iteration
+    bool jac_fresh = false;    // factorization was computed in the current step
+    int jac_factorizations = 0;
+    int jac_skipped = 0;
+    double newton_step_prev = 0.0;
+    double newton_step_nrm;
+    double steps_per_T = num_steps;  // for the cost weights
+    bool last_step = false;
+
     int *ipiv = workspace->ipiv;
 
     struct blasfeo_dmat *dG_dK = workspace->dG_dK;
@@ -1351,8 +1891,20 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     impl_ode_z_in.x = K;
 
     // start the loop
-    for (int ss = 0; ss < num_steps; ss++)
+    int ss = 0;
+    while (adaptive ? step_ctrl.t_rem > 0.0 : ss < num_steps)
     {
+        if (adaptive)
+        {
+            step = sim_step_control_next(&step_ctrl);
+            last_step = step_ctrl.last_step;
+            steps_per_T = in->T / step;
+        }
+        else
+        {
+            t_step = t0 + ss * step;
+            last_step = ss == num_steps - 1;
+        }
 
         // decide whether results from forward sensitivity propagation are stored,
         // or if memory has to be reused --> set pointers accordingly
@@ -1386,9 +1938,28 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
         if ( opts->sens_adj || opts->sens_hess )  // store current xn
             blasfeo_dveccp(nx, xn, 0, &xn_traj[ss], 0);
 
+        // start from the factorization of the previous call if the step size is close enough
+        if (jac_across && !jac_restored)
+        {
+            jac_restored = true;
+            if (mem->jac_valid && fabs(step - mem->jac_step) <= opts->jac_reuse_step_rtol * mem->jac_step)
+            {
+                sim_irk_jac_copy(dims, opts, workspace, dG_dK_ss, ipiv_ss, mem, false);
+                jac_valid = true;
+                step_jac = step;
+                jac_skipped++;
+            }
+        }
+        jac_fresh = false;
+
         for (int iter = 0; iter < newton_iter; iter++)
         {
-            if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+            // with jac_reuse, the Jacobian is only refactorized for a new step size,
+            // or if the Newton contraction is too slow
+            bool new_jac = !opts->jac_reuse || (iter == 0 && (!jac_valid || step != step_jac))
+                           || jac_refresh;
+
+            if (!opts->simplified_newton && new_jac)
             {
                 // if new jacobian gets computed, initialize dG_dK_ss with zeros
                 blasfeo_dgese(nK, nK, 0.0, dG_dK_ss, 0, 0);
@@ -1398,7 +1969,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             {  // ii-th row of tableau
                 // take x(n); copy a strvec into a strvec
                 blasfeo_dveccp(nx, xn, 0, xt, 0);
-                t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                t_current = t_step + opts->c_vec[ii] * step;
 
                 for (int jj = 0; jj < ns; jj++)
                 {  // jj-th col of tableau
@@ -1413,7 +1984,15 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 impl_ode_res_out.xi = ii * (nx + nz);  // store output in this position of rG
 
                 // compute the residual of implicit ode at time t_ii
-                if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+                if (opts->simplified_newton && ii == 0 && new_jac)
+                {   // simplified Newton: jacobians frozen at the first stage
+                    acados_tic(&timer_ad);
+                    model->impl_ode_fun_jac_x_xdot_z->evaluate(
+                        model->impl_ode_fun_jac_x_xdot_z, impl_ode_type_in, impl_ode_in,
+                        impl_ode_fun_jac_x_xdot_z_type_out, impl_ode_fun_jac_x_xdot_z_out);
+                    timing_ad += acados_toc(&timer_ad);
+                }
+                else if (!opts->simplified_newton && new_jac)
                 {   // evaluate the ode function & jacobian w.r.t. x, xdot;
                     // &  compute jacobian dG_dK_ss;
                     acados_tic(&timer_ad);
@@ -1448,43 +2027,95 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             }  // end ii
 
             acados_tic(&timer_la);
-            // DGETRF computes an LU factorization of a general M-by-N matrix A
-            // using partial pivoting with row interchanges.
-            // printf("dG_dK_ss = (IRK) \n");
-            // blasfeo_print_exp_dmat((nz+nx) *ns, (nz+nx) *ns, dG_dK_ss, 0, 0);
-            if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+            if (opts->simplified_newton)
             {
-                blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
+                if (new_jac)
+                {
+                    sim_irk_simplified_newton_factorize(dims, opts, workspace, step);
+                    step_jac = step;
+                    jac_factorizations++;
+                }
+                sim_irk_simplified_newton_solve(dims, opts, workspace);
             }
+            else
+            {
+                // DGETRF computes an LU factorization of a general M-by-N matrix A
+                // using partial pivoting with row interchanges.
+                // printf("dG_dK_ss = (IRK) \n");
+                // blasfeo_print_exp_dmat((nz+nx) *ns, (nz+nx) *ns, dG_dK_ss, 0, 0);
+                if (new_jac)
+                {
+                    blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
+                    step_jac = step;
+                    jac_factorizations++;
+                }
 
-            // permute also the r.h.s
-            blasfeo_dvecpe(nK, ipiv_ss, rG, 0);
-
-            // solve dG_dK_ss * y = rG, dG_dK_ss on the (l)eft, (l)ower-trian, (n)o-trans
-            // (u)nit trian
-            blasfeo_dtrsv_lnu(nK, dG_dK_ss, 0, 0, rG, 0, rG, 0);
+                // permute also the r.h.s
+                blasfeo_dvecpe(nK, ipiv_ss, rG, 0);
 
-            // solve dG_dK_ss * x = rG, dG_dK_ss on the (l)eft, (u)pper-trian, (n)o-trans
-            // (n)o unit trian , and store x in rG
-            blasfeo_dtrsv_unn(nK, dG_dK_ss, 0, 0, rG, 0, rG, 0);
+                // solve dG_dK_ss * y = rG, dG_dK_ss on the (l)eft, (l)ower-trian, (n)o-trans
+                // (u)nit trian
+                blasfeo_dtrsv_lnu(nK, dG_dK_ss, 0, 0, rG, 0, rG, 0);
 
+                // solve dG_dK_ss * x = rG, dG_dK_ss on the (l)eft, (u)pper-trian, (n)o-trans
+                // (n)o unit trian , and store x in rG
+                blasfeo_dtrsv_unn(nK, dG_dK_ss, 0, 0, rG, 0, rG, 0);
+            }
             timing_la += acados_toc(&timer_la);
+            if (new_jac)
+            {
+                jac_valid = true;
+                jac_refresh = false;
+                jac_fresh = true;
+            }
 
             // scale and add a generic strmat into a generic strmat // K = K - rG, where rG is
             // [DeltaK, DeltaZ]
             blasfeo_daxpy(nK, -1.0, rG, 0, K, 0, K, 0);
 
+            if (opts->newton_tol > 0 || jac_across)
+                blasfeo_dvecnrm_inf(nK, rG, 0, &newton_step_nrm);
+
+            // monitor the contraction rate of the Newton steps, a factorization
+            // that was not computed in this step is refreshed if it is too slow
+            if (jac_across)
+            {
+                if (iter > 0 && !jac_fresh &&
+                    newton_step_nrm > opts->jac_reuse_contraction_max * newton_step_prev)
+                {
+                    jac_refresh = true;
+                }
+                newton_step_prev = newton_step_nrm;
+            }
+
             // check early termination based on tolerance
             if (opts->newton_tol > 0)
             {
-                blasfeo_dvecnrm_inf(nK, rG, 0, &a);
-                if (a < opts->newton_tol)
+                if (newton_step_nrm < opts->newton_tol)
                 {
                     break;
                 }
             }
         } // end newton_iter
 
+        if (adaptive)
+        {
+            double err = sim_irk_local_error_norm(dims, opts, workspace, model, u, t_step, step,
+                                                  &timing_ad, &timing_la);
+            // with jac_reuse, small step size increases are skipped to avoid refactorizations
+            if (!sim_step_control_update(&step_ctrl, step, err, ns, opts->jac_reuse ? 1.2 : 1.0))
+            {
+                // rejected, K is kept as initial guess
+                continue;
+            }
+
+            if (opts->sens_adj || opts->sens_hess)
+            {
+                workspace->step_traj[ss] = step;
+                workspace->t_traj[ss] = t_step;
+            }
+        }
+
         if ( opts->sens_adj || opts->sens_hess )
         {
             blasfeo_dveccp(nK, K, 0, &K_traj[ss], 0);
@@ -1493,7 +2124,12 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
         // evaluate forward sensitivities
         if ( opts->sens_forw || opts->sens_hess )
         {
-            blasfeo_dgese(nK, nK, 0.0, dG_dK_ss, 0, 0);
+            // inexact sensitivities: keep the factorization used in the Newton iterations
+            bool sens_jac_reuse = jac_across && opts->sens_jac_reuse && !opts->simplified_newton &&
+                                  !opts->sens_hess && jac_valid && step == step_jac && !jac_refresh;
+
+            if (!sens_jac_reuse)
+                blasfeo_dgese(nK, nK, 0.0, dG_dK_ss, 0, 0);
             // initialize dG_dK_ss with zeros
             // evaluate dG_dK_ss(xn,Kn)
             for (int ii = 0; ii < ns; ii++)
@@ -1509,7 +2145,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     // xt = xt + T_int * a[i,j]*K_j
                     blasfeo_daxpy(nx, a, K, jj * nx, xt, 0, xt, 0);
                 }
-                t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                t_current = t_step + opts->c_vec[ii] * step;
 
                 acados_tic(&timer_ad);
                 model->impl_ode_jac_x_xdot_u_z->evaluate(
@@ -1520,6 +2156,9 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 blasfeo_dgecp(nx + nz, nx, df_dx, 0, 0, dG_dxu_ss, ii * (nx + nz), 0);
                 blasfeo_dgecp(nx + nz, nu, df_du, 0, 0, dG_dxu_ss, ii * (nx + nz), nx);
 
+                if (sens_jac_reuse)
+                    continue;
+
                 // compute the blocks of dG_dK_ss
                 for (int jj = 0; jj < ns; jj++)
                 {  // compute the block (ii,jj)th block of dG_dK_ss
@@ -1537,9 +2176,23 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             }  // end ii
 
             // factorize dG_dK_ss
-            acados_tic(&timer_la);
-            blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
-            timing_la += acados_toc(&timer_la);
+            if (sens_jac_reuse)
+            {
+                jac_skipped++;
+            }
+            else
+            {
+                acados_tic(&timer_la);
+                blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
+                timing_la += acados_toc(&timer_la);
+                jac_factorizations++;
+                if (!opts->simplified_newton)
+                {
+                    step_jac = step;
+                    jac_valid = true;
+                    jac_refresh = false;
+                }
+            }
 
             // obtain dK_dxu
             // set up right hand side
@@ -1596,7 +2249,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 {
                     impl_ode_z_in.xi = ns * nx + ii * nz;
 
-                    t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                    t_current = t_step + opts->c_vec[ii] * step;
                     // compute x at stage (xt) and sensitivity (S_forw_stage)
                     blasfeo_dveccp(nx, xn, 0, xt, 0);
                     blasfeo_dgecp(nx, nx+nu, S_forw_ss, 0, 0, S_forw_stage, 0, 0);
@@ -1651,17 +2304,17 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     }
 
                     // cost_grad += b * tmp_ny^T * tmp_ny_nux = b * tmp_ny_nux^T * tmp_ny
-                    blasfeo_dgemv_n(nx+nu, ny, cost_scaling * b_vec[ii]/num_steps, tmp_nux_ny2, 0, 0, tmp_ny, 0,
+                    blasfeo_dgemv_n(nx+nu, ny, cost_scaling * b_vec[ii]/steps_per_T, tmp_nux_ny2, 0, 0, tmp_ny, 0,
                                     1.0, cost_grad, 0, cost_grad, 0);
 
                     // cost_hess += b * tmp_nux_ny_2 * tmp_nux_ny_2^T
                     // TODO: use syrk (exploit symmetry)
-                    blasfeo_dgemm_nt(nx+nu, nx+nu, ny, b_vec[ii]/num_steps, tmp_nux_ny2, 0, 0, tmp_nux_ny2, 0, 0,
+                    blasfeo_dgemm_nt(nx+nu, nx+nu, ny, b_vec[ii]/steps_per_T, tmp_nux_ny2, 0, 0, tmp_nux_ny2, 0, 0,
                                     1.0, cost_hess, 0, 0, cost_hess, 0, 0);
 
                     // cost function value
                     // NOTE: slack contribution and scaling done in cost module
-                    mem->cost_fun[0] += 0.5 * b_vec[ii]/num_steps * blasfeo_ddot(ny, tmp_ny, 0, tmp_ny, 0);
+                    mem->cost_fun[0] += 0.5 * b_vec[ii]/steps_per_T * blasfeo_ddot(ny, tmp_ny, 0, tmp_ny, 0);
                 } // end ii
             } // end cost propagation NLS COST
             else if (opts->cost_computation && opts->cost_type == CONVEX_OVER_NONLINEAR)
@@ -1703,7 +2356,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 {
                     impl_ode_z_in.xi = ns * nx + ii * nz;
 
-                    t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                    t_current = t_step + opts->c_vec[ii] * step;
                     // compute x at stage (xt) and sensitivity (S_forw_stage)
                     blasfeo_dveccp(nx, xn, 0, xt, 0);
                     blasfeo_dgecp(nx, nx+nu, S_forw_ss, 0, 0, S_forw_stage, 0, 0);
@@ -1741,7 +2394,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                         //         &workspace->Jt_z, 0, 0, 1.0, &workspace->tmp_nux_ny, 0, 0, &Jt_ux_tilde, 0, 0);
 
                         // // cost_grad += b * Jt_ux_tilde * tmp_ny
-                        // blasfeo_dgemv_n(nu+nx, ny, cost_scaling * b_vec[ii]/num_steps, &Jt_ux_tilde, 0, 0, tmp_ny, 0,
+                        // blasfeo_dgemv_n(nu+nx, ny, cost_scaling * b_vec[ii]/steps_per_T, &Jt_ux_tilde, 0, 0, tmp_ny, 0,
                         //                 1.0, cost_grad, 0, cost_grad, 0);
 
                         // // tmp_nv_ny = Jt_ux_tilde * W_chol
@@ -1779,15 +2432,15 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                         }
 
                         // cost_grad += b * J_y_tilde^T * tmp_ny
-                        blasfeo_dgemv_t(ny, nx+nu, cost_scaling * b_vec[ii]/num_steps, J_y_tilde, 0, 0, tmp_ny, 0,
+                        blasfeo_dgemv_t(ny, nx+nu, cost_scaling * b_vec[ii]/steps_per_T, J_y_tilde, 0, 0, tmp_ny, 0,
                                         1.0, cost_grad, 0, cost_grad, 0);
                     }
                     // cost_hess += b * tmp_nux_ny2 * tmp_nux_ny2^T
-                    blasfeo_dsyrk_ln(nu+nx, ny, b_vec[ii]/num_steps, tmp_nux_ny2, 0, 0, tmp_nux_ny2, 0, 0,
+                    blasfeo_dsyrk_ln(nu+nx, ny, b_vec[ii]/steps_per_T, tmp_nux_ny2, 0, 0, tmp_nux_ny2, 0, 0,
                             1.0, cost_hess, 0, 0, cost_hess, 0, 0);
                     // cost function value
                     // NOTE: slack contribution and scaling done in cost module
-                    mem->cost_fun[0] += b_vec[ii]/num_steps * a;
+                    mem->cost_fun[0] += b_vec[ii]/steps_per_T * a;
                 }
             }
 
@@ -1822,7 +2475,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             {
                 impl_ode_z_in.xi = ns * nx + ii * nz;
 
-                t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                t_current = t_step + opts->c_vec[ii] * step;
                 // compute x at stage (xt)
                 blasfeo_dveccp(nx, xn, 0, xt, 0);
                 for (int jj = 0; jj < ns; jj++)
@@ -1850,7 +2503,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
 
                 // cost function value
                 // NOTE: slack contribution and scaling done in cost module
-                mem->cost_fun[0] += 0.5 * b_vec[ii]/num_steps * blasfeo_ddot(ny, tmp_ny, 0, tmp_ny, 0);
+                mem->cost_fun[0] += 0.5 * b_vec[ii]/steps_per_T * blasfeo_ddot(ny, tmp_ny, 0, tmp_ny, 0);
             }
         } // end NLS cost_computation without sens
         else if (opts->cost_computation && opts->cost_type == CONVEX_OVER_NONLINEAR)
@@ -1882,7 +2535,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             {
                 impl_ode_z_in.xi = ns * nx + ii * nz;
 
-                t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                t_current = t_step + opts->c_vec[ii] * step;
                 // compute x at stage (xt)
                 blasfeo_dveccp(nx, xn, 0, xt, 0);
                 for (int jj = 0; jj < ns; jj++)
@@ -1897,7 +2550,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
 
                 // cost function value
                 // NOTE: slack contribution and scaling done in cost module
-                mem->cost_fun[0] += b_vec[ii]/num_steps * a;
+                mem->cost_fun[0] += b_vec[ii]/steps_per_T * a;
             }
         } // end NLS cost_computation without sens
 
@@ -1914,13 +2567,36 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             sim_irk_compute_z_and_algebraic_sens(dims, opts, in, out, mem, workspace, model);
         }
 
-        if (ss == num_steps-1)
+        if (last_step)
         {
             // store last xdot, z values for next initialization
             blasfeo_unpack_dvec(nx, K, (ns-1) * nx, mem->xdot, 1);
             blasfeo_unpack_dvec(nz, K, (ns-1) * nz + ns*nx, mem->z, 1);
         }
+
+        ss++;
+        if (adaptive)
+            t_step += step;
     }  // end step loop (ss)
+    num_steps = ss;
+
+    if (adaptive)
+    {
+        mem->step_size = step_ctrl.step_prop;
+        mem->steps_accepted = num_steps;
+        mem->steps_rejected = step_ctrl.num_rejected;
+        mem->step_cap_reached = step_ctrl.cap_reached;
+    }
+
+    // keep the latest factorization for the next call
+    if (jac_across && jac_valid && jac_factorizations > 0)
+    {
+        sim_irk_jac_copy(dims, opts, workspace, dG_dK_ss, ipiv_ss, mem, true);
+        mem->jac_step = step_jac;
+        mem->jac_valid = true;
+    }
+    mem->jac_factorizations = jac_factorizations;
+    mem->jac_factorizations_skipped = jac_skipped;
 
     if (opts->cost_computation)
     {
@@ -1942,8 +2618,18 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
 *******************************************************************************/
     if ( opts->sens_adj  || opts->sens_hess )
     {
-        for (int ss = num_steps - 1; ss > -1; ss--)
+        for (ss = num_steps - 1; ss > -1; ss--)
         {
+            if (adaptive)
+            {
+                step = workspace->step_traj[ss];
+                t_step = workspace->t_traj[ss];
+            }
+            else
+            {
+                t_step = t0 + ss * step;
+            }
+
             if (opts->sens_hess){
                 dK_dxu_ss = &dK_dxu[ss];
                 dG_dK_ss = &dG_dK[ss];
@@ -1977,7 +2663,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     // use k_i of K = (k_1,..., k_{ns},z_1,..., z_{ns})
                     impl_ode_z_in.xi    = ns * nx + ii * nz;
                     // use z_i of K = (k_1,..., k_{ns},z_1,..., z_{ns})
-                    t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                    t_current = t_step + opts->c_vec[ii] * step;
 
                     // build stage value
                     blasfeo_dveccp(nx, &xn_traj[ss], 0, xt, 0);
@@ -2086,7 +2772,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     // use z_i of K = (k_1,..., k_{ns},z_1,..., z_{ns})
                     impl_ode_hess_lambda_in.xi = ii * (nx + nz);
 
-                    t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                    t_current = t_step + opts->c_vec[ii] * step;
 
                     // eval hessian function at stage ii
                     // printf("dxkzu_dw0 = (IRK, ss = %d) \n", ss);
@@ -94,15 +94,22 @@ typedef struct
 
     /* NOTE: the memory allocation corresponding to the following fields is CONDITIONAL */
 
-    // only allocated if (opts->sens_algebraic || opts->output_z)
+    // only allocated if (opts->sens_algebraic || opts->output_z || opts->adaptive_step)
     int *ipiv_one_stage;  // index of pivot vector (nx + nz)
     double *Z_work;  // used to perform computations to get out->zn (ns)
 
-    // df_dxdotz, dk0_dxu, only allocated if (opts->sens_algebraic && opts->exact_z_output)
+    // df_dxdotz only allocated if ((opts->sens_algebraic && opts->exact_z_output) || opts->adaptive_step)
+    // dk0_dxu, only allocated if (opts->sens_algebraic && opts->exact_z_output)
     //      used for algebraic sensitivity generation
     struct blasfeo_dmat df_dxdotz;  // temporary Jacobian of ode w.r.t. xdot,z (nx+nz, nx+nz);
     struct blasfeo_dmat dk0_dxu;    // intermediate result, (nx+nz, nx+nu)
 
+    // only allocated if (opts->adaptive_step)
+    struct blasfeo_dvec xdotz0;  // xdot, z at the start of the step, for the error estimate (nx+nz)
+    // only allocated if (opts->adaptive_step && (opts->sens_adj || opts->sens_hess))
+    double *step_traj;  // accepted step sizes
+    double *t_traj;     // start times of the accepted steps
+
     // dK_dxu: if (!opts->sens_hess) - single blasfeo_dmat that is reused
     //         if ( opts->sens_hess) - array of (num_steps) blasfeo_dmat
     //                                  to store intermediate results
@@ -127,7 +134,14 @@ typedef struct
     //              pivot vectors for dG_dxu
     int *ipiv;  // index of pivot vector
 
-    // xn_traj, K_traj only available if( opts->sens_adj || opts->sens_hess )
+    // only allocated if (opts->simplified_newton)
+    // Newton matrix blocks of size (nx+nz) for real and 2*(nx+nz) for complex pair eigenvalues
+    struct blasfeo_dmat *simpl_blk;  // ((ns+1)/2 blocks of (2*(nx+nz), 2*(nx+nz)))
+    struct blasfeo_dvec *rG_simpl;   // transformed residual ((nx+nz)*ns)
+    int *ipiv_simpl;                 // index of pivot vectors (ns+1)*(nx+nz)
+
+    // xn_traj, K_traj only available if( opts->sens_adj || opts->sens_hess ),
+    // of size num_steps, or num_steps_max in adaptive mode
     struct blasfeo_dvec *xn_traj;  // xn trajectory
     struct blasfeo_dvec *K_traj;   // K trajectory
 
@@ -164,6 +178,21 @@ typedef struct
     double time_ad;
     double time_la;
 
+    // adaptive step size control
+    double step_size;  // proposal for the first step of the next call, 0 if none
+    int steps_accepted;
+    int steps_rejected;
+    int step_cap_reached;  // 1 if num_steps_max forced the remaining steps
+
+    // Newton matrix factorization kept across calls, only allocated if (opts->jac_reuse_across_calls);
+    // simplified Newton stores its blocks on the diagonal of jac_LU
+    struct blasfeo_dmat *jac_LU;  // ((nx+nz)*ns, (nx+nz)*ns)
+    int *jac_ipiv;                // (ns+1)*(nx+nz)
+    double jac_step;              // step size jac_LU was factorized for
+    bool jac_valid;
+    int jac_factorizations;          // number of factorizations in the last call
+    int jac_factorizations_skipped;  // number of factorizations avoided by reuse in the last call
+
     double *cost_fun;
     double *outer_hess_is_diag;
     double *cost_scaling_ptr;
@@ -174,6 +203,14 @@ typedef struct
     struct blasfeo_dvec *cost_grad;
     struct blasfeo_dmat *cost_hess;
 
+    // cached workspace cast: pointer tables into the workspace, recast only if
+    // the workspace or the opts determining its layout change
+    void *work_cast_memory;
+    acados_size_t work_cast_size;
+    void *work_cast;
+    void *work_cast_raw;
+    sim_opts work_cast_opts;
+
 } sim_irk_memory;
 
 
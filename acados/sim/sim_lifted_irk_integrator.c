@@ -254,6 +254,12 @@ void sim_lifted_irk_opts_initialize_default(void *config_, void *dims_, void *op
     opts->sens_adj = false;
     opts->sens_hess = false;
     opts->jac_reuse = true;
+    opts->simplified_newton = false;
+    opts->jac_reuse_across_calls = false;  // not supported
+    opts->sens_jac_reuse = false;
+    opts->adaptive_step = false;  // not supported
+    opts->num_steps_max = 20;
+    opts->step_tol = 1e-6;
     opts->exact_z_output = false;
     opts->ns = 3;
     opts->collocation_type = GAUSS_LEGENDRE;
@@ -1270,6 +1270,334 @@ void external_function_param_casadi_set_external_workspace(void *self, void *wor
 
 
 
+/************************************************
+ * batched casadi external function
+ ************************************************/
+
+acados_size_t external_function_casadi_batch_struct_size()
+{
+    return sizeof(external_function_casadi_batch);
+}
+
+
+
+// number of ints of the sparsity of a single instance of a mapped casadi sparsity
+static int casadi_batch_sparsity_size(const int *sparsity, int batch_size)
+{
+    if (sparsity == NULL)
+        return 0;
+
+    int ncol = sparsity[1];
+    int dense = sparsity[2];
+    if (dense)
+        return 3;
+    else
+        return 2 + ncol / batch_size + 1 + casadi_nnz(sparsity) / batch_size;
+}
+
+
+
+// extract the sparsity of the first instance, the instances are concatenated horizontally
+static void casadi_batch_sparsity_extract(const int *sparsity, int batch_size, int *out)
+{
+    if (sparsity == NULL)
+        return;
+
+    int nrow = sparsity[0];
+    int ncol = sparsity[1];
+    int dense = sparsity[2];
+    int ncol_single = ncol / batch_size;
+
+    out[0] = nrow;
+    out[1] = ncol_single;
+    if (dense)
+    {
+        out[2] = 1;
+    }
+    else
+    {
+        const int *idxcol = sparsity + 2;
+        const int *row = sparsity + ncol + 3;
+        int nnz_single = casadi_nnz(sparsity) / batch_size;
+        for (int jj = 0; jj <= ncol_single; jj++)
+            out[2 + jj] = idxcol[jj];
+        for (int idx = 0; idx < nnz_single; idx++)
+            out[3 + ncol_single + idx] = row[idx];
+    }
+}
+
+
+
+static void casadi_batch_check_sparsity(const int *sparsity, int batch_size, const char *kind, int idx)
+{
+    if (sparsity == NULL)
+        return;
+
+    if (sparsity[1] % batch_size != 0 || casadi_nnz(sparsity) % batch_size != 0)
+    {
+        printf("\nexternal_function_casadi_batch: %s %d with %d columns is not a map over %d instances.\n",
+               kind, idx, sparsity[1], batch_size);
+        exit(1);
+    }
+}
+
+
+
+acados_size_t external_function_casadi_batch_calculate_size(external_function_casadi_batch *fun, int batch_size, int np, external_function_opts *opts_)
+{
+    fun->evaluate_batch = &external_function_casadi_batch_wrapper;
+    fun->get_external_workspace_requirement = external_function_casadi_batch_get_external_workspace_requirement;
+    fun->set_external_workspace = external_function_casadi_batch_set_external_workspace;
+    fun->get_nparam = &external_function_casadi_batch_get_nparam;
+
+    int ii;
+
+    if (batch_size < 1)
+    {
+        printf("\nexternal_function_casadi_batch: batch_size has to be positive, got %d.\n", batch_size);
+        exit(1);
+    }
+    fun->batch_size = batch_size;
+
+    fun->casadi_work(&fun->args_num, &fun->res_num, &fun->int_work_size, &fun->float_work_size);
+
+    fun->in_num = fun->casadi_n_in();
+    fun->out_num = fun->casadi_n_out();
+
+    // parameter is last input
+    fun->np = np;
+    fun->idx_in_p = np > 0 ? fun->in_num - 1 : -1;
+    if (np > 0 && casadi_nnz(fun->casadi_sparsity_in(fun->idx_in_p)) != batch_size * np)
+    {
+        printf("\nexternal_function_casadi_batch: last input does not match np = %d.\n", np);
+        exit(1);
+    }
+
+    // args
+    fun->args_size_tot = 0;
+    fun->args_sparsity_size_tot = 0;
+    for (ii = 0; ii < fun->args_num; ii++)
+    {
+        casadi_batch_check_sparsity(fun->casadi_sparsity_in(ii), batch_size, "input", ii);
+        fun->args_size_tot += casadi_nnz(fun->casadi_sparsity_in(ii));
+        fun->args_sparsity_size_tot += casadi_batch_sparsity_size(fun->casadi_sparsity_in(ii), batch_size);
+    }
+
+    // res
+    fun->res_size_tot = 0;
+    fun->res_sparsity_size_tot = 0;
+    for (ii = 0; ii < fun->res_num; ii++)
+    {
+        casadi_batch_check_sparsity(fun->casadi_sparsity_out(ii), batch_size, "output", ii);
+        fun->res_size_tot += casadi_nnz(fun->casadi_sparsity_out(ii));
+        fun->res_sparsity_size_tot += casadi_batch_sparsity_size(fun->casadi_sparsity_out(ii), batch_size);
+    }
+
+    // copy options
+    external_function_opts_copy(opts_, &fun->opts);
+
+    if (opts_->with_global_data)
+    {
+        printf("\nexternal_function_casadi_batch: option with_global_data not implemented!!!\n");
+        exit(1);
+    }
+
+    acados_size_t size = 0;
+
+    // double pointers
+    size += fun->args_num * sizeof(double *);  // args
+    size += fun->res_num * sizeof(double *);   // res
+
+    // int pointers
+    size += fun->args_num * sizeof(int *);  // args_sparsity
+    size += fun->res_num * sizeof(int *);   // res_sparsity
+
+    // ints
+    size += 2 * fun->args_num * sizeof(int);  // args_size, args_dense
+    size += 2 * fun->res_num * sizeof(int);   // res_size, res_dense
+    size += fun->args_sparsity_size_tot * sizeof(int);  // args_sparsity
+    size += fun->res_sparsity_size_tot * sizeof(int);   // res_sparsity
+    size += fun->int_work_size * sizeof(int);   // int_work
+
+    // doubles
+    size += fun->args_size_tot * sizeof(double);  // args
+    size += fun->res_size_tot * sizeof(double);   // res
+    // float_work
+    if (!fun->opts.external_workspace)
+    {
+        size += fun->float_work_size * sizeof(double);
+    }
+
+    size += 8;  // initial align
+    size += 8;  // align to double
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+void external_function_casadi_batch_assign(external_function_casadi_batch *fun, void *raw_memory)
+{
+    int ii;
+    int batch_size = fun->batch_size;
+
+    // save initial pointer to external memory
+    fun->ptr_ext_mem = raw_memory;
+
+    // char pointer for byte advances
+    char *c_ptr = raw_memory;
+
+    // initial align
+    align_char_to(8, &c_ptr);
+
+    // args
+    assign_and_advance_double_ptrs(fun->args_num, &fun->args, &c_ptr);
+    // res
+    assign_and_advance_double_ptrs(fun->res_num, &fun->res, &c_ptr);
+
+    // args_sparsity
+    assign_and_advance_int_ptrs(fun->args_num, &fun->args_sparsity, &c_ptr);
+    // res_sparsity
+    assign_and_advance_int_ptrs(fun->res_num, &fun->res_sparsity, &c_ptr);
+
+    // args_size, args_dense
+    assign_and_advance_int(fun->args_num, &fun->args_size, &c_ptr);
+    assign_and_advance_int(fun->args_num, &fun->args_dense, &c_ptr);
+    for (ii = 0; ii < fun->args_num; ii++)
+    {
+        const int *sparsity = fun->casadi_sparsity_in(ii);
+        fun->args_size[ii] = casadi_nnz(sparsity) / batch_size;
+        assign_and_advance_int(casadi_batch_sparsity_size(sparsity, batch_size), &fun->args_sparsity[ii], &c_ptr);
+        casadi_batch_sparsity_extract(sparsity, batch_size, fun->args_sparsity[ii]);
+        fun->args_dense[ii] = sparsity == NULL ? 1 : casadi_is_dense(fun->args_sparsity[ii]);
+    }
+    // res_size, res_dense
+    assign_and_advance_int(fun->res_num, &fun->res_size, &c_ptr);
+    assign_and_advance_int(fun->res_num, &fun->res_dense, &c_ptr);
+    for (ii = 0; ii < fun->res_num; ii++)
+    {
+        const int *sparsity = fun->casadi_sparsity_out(ii);
+        fun->res_size[ii] = casadi_nnz(sparsity) / batch_size;
+        assign_and_advance_int(casadi_batch_sparsity_size(sparsity, batch_size), &fun->res_sparsity[ii], &c_ptr);
+        casadi_batch_sparsity_extract(sparsity, batch_size, fun->res_sparsity[ii]);
+        fun->res_dense[ii] = sparsity == NULL ? 1 : casadi_is_dense(fun->res_sparsity[ii]);
+    }
+    // int_work
+    assign_and_advance_int(fun->int_work_size, &fun->int_work, &c_ptr);
+
+    // align to double
+    align_char_to(8, &c_ptr);
+
+    // args, all instances
+    for (ii = 0; ii < fun->args_num; ii++)
+        assign_and_advance_double(batch_size * fun->args_size[ii], &fun->args[ii], &c_ptr);
+    // res, all instances
+    for (ii = 0; ii < fun->res_num; ii++)
+        assign_and_advance_double(batch_size * fun->res_size[ii], &fun->res[ii], &c_ptr);
+    // float_work
+    if (!fun->opts.external_workspace)
+    {
+        assign_and_advance_double(fun->float_work_size, &fun->float_work, &c_ptr);
+    }
+
+    // instances not used by a partial chunk are evaluated at these values
+    for (ii = 0; ii < fun->args_num; ii++)
+        for (int jj = 0; jj < batch_size * fun->args_size[ii]; jj++)
+            fun->args[ii][jj] = 0.0;
+
+    assert((char *) raw_memory + external_function_casadi_batch_calculate_size(fun, fun->batch_size, fun->np, &fun->opts) >= c_ptr);
+
+    return;
+}
+
+
+
+void external_function_casadi_batch_wrapper(void *self, int n_inst, ext_fun_arg_t *type_in, void ***in,
+                                            ext_fun_arg_t *type_out, void ***out)
+{
+    // cast into batched external casadi function
+    external_function_casadi_batch *fun = self;
+
+    int ii, jj;
+    int status = 0;
+
+    // process the instances in chunks of batch_size
+    for (int j0 = 0; j0 < n_inst; j0 += fun->batch_size)
+    {
+        int n_chunk = n_inst - j0 < fun->batch_size ? n_inst - j0 : fun->batch_size;
+
+        // in as args, instance jj at offset jj * args_size[ii]
+        for (jj = 0; jj < n_chunk; jj++)
+        {
+            for (ii = 0; ii < fun->in_num; ii++)
+            {
+                status = d_cvt_ext_fun_arg_to_casadi(type_in[ii], in[j0+jj][ii],
+                            fun->args[ii] + jj * fun->args_size[ii], fun->args_sparsity[ii], fun->args_dense[ii]);
+                if (status)
+                {
+                    printf("\nexternal_function_casadi_batch_wrapper: Unknown external function argument type %d for input %d\n\n", type_in[ii], ii);
+                    exit(1);
+                }
+            }
+        }
+
+        // call casadi function, unused instances of a partial chunk are evaluated at stale data
+        fun->casadi_fun((const double **) fun->args, fun->res, fun->int_work, fun->float_work, NULL);
+
+        for (jj = 0; jj < n_chunk; jj++)
+        {
+            for (ii = 0; ii < fun->out_num; ii++)
+            {
+                status = d_cvt_casadi_to_ext_fun_arg(type_out[ii], fun->res[ii] + jj * fun->res_size[ii],
+                            fun->res_sparsity[ii], out[j0+jj][ii], fun->res_dense[ii]);
+                if (status)
+                {
+                    printf("\nexternal_function_casadi_batch_wrapper: Unknown external function argument type %d for output %d\n\n", type_out[ii], ii);
+                    exit(1);
+                }
+            }
+        }
+    }
+
+    return;
+}
+
+
+
+void external_function_casadi_batch_get_nparam(void *self, int *np)
+{
+    external_function_casadi_batch *fun = self;
+
+    *np = fun->np;
+
+    return;
+}
+
+
+
+size_t external_function_casadi_batch_get_external_workspace_requirement(void *self)
+{
+    external_function_casadi_batch *fun = self;
+    if (fun->opts.external_workspace)
+        return fun->float_work_size * sizeof(double);
+    else
+        return 0;
+}
+
+
+
+void external_function_casadi_batch_set_external_workspace(void *self, void *workspace)
+{
+    external_function_casadi_batch *fun = self;
+    if (fun->opts.external_workspace)
+        fun->float_work = workspace;
+}
+
+
+
+
 /************************************************
  * generic external parametric function
  ************************************************/
@@ -255,6 +255,74 @@ size_t external_function_param_casadi_get_external_workspace_requirement(void *s
 void external_function_param_casadi_set_external_workspace(void *self, void *workspace);
 
 
+/************************************************
+ * batched casadi external function
+ ************************************************/
+
+// Evaluates a casadi function generated with map(batch_size), i.e. all inputs and outputs are
+// horizontal concatenations of batch_size instances of the underlying function. One call
+// evaluates up to batch_size instances, which lets the generated code vectorize across them.
+// With np > 0 the last input is the parameter vector, which is passed per instance like the
+// other inputs, as the instances usually belong to different stages.
+typedef struct
+{
+    // public members
+    void (*evaluate_batch)(void *, int, ext_fun_arg_t *, void ***, ext_fun_arg_t *, void ***);
+    size_t (*get_external_workspace_requirement)(void *);
+    void (*set_external_workspace)(void *, void *);
+    void (*get_nparam)(void *, int *);
+    // private members
+    void *ptr_ext_mem;  // pointer to external memory
+    int (*casadi_fun)(const double **, double **, int *, double *, void *);
+    int (*casadi_work)(int *, int *, int *, int *);
+    const int *(*casadi_sparsity_in)(int);
+    const int *(*casadi_sparsity_out)(int);
+    int (*casadi_n_in)(void);
+    int (*casadi_n_out)(void);
+    double **args;
+    double **res;
+    double *float_work;
+    int *int_work;
+    int **args_sparsity; // sparsity of a single instance of args[i]
+    int **res_sparsity;  // sparsity of a single instance of res[i]
+    int *args_size;     // size of a single instance of args[i]
+    int *res_size;      // size of a single instance of res[i]
+    int *args_dense;    // indicates if args[i] is dense
+    int *res_dense;     // indicates if res[i] is dense
+    int args_num;       // number of args arrays
+    int args_size_tot;  // total size of args arrays
+    int args_sparsity_size_tot; // total size of single instance sparsity of args
+    int res_num;        // number of res arrays
+    int res_size_tot;   // total size of res arrays
+    int res_sparsity_size_tot;  // total size of single instance sparsity of res
+    int in_num;         // number of input arrays
+    int out_num;        // number of output arrays
+    int int_work_size;        // number of ints for worksapce
+    int float_work_size;         // number of doubles for workspace
+    int batch_size;     // number of instances evaluated in one call
+    int np;             // number of parameters
+    int idx_in_p;       // index of the parameter input, -1 if np == 0
+    external_function_opts opts;
+} external_function_casadi_batch;
+
+//
+acados_size_t external_function_casadi_batch_struct_size();
+//
+acados_size_t external_function_casadi_batch_calculate_size(external_function_casadi_batch *fun, int batch_size, int np, external_function_opts *opts_);
+//
+void external_function_casadi_batch_assign(external_function_casadi_batch *fun, void *mem);
+// in[j][ii] is input ii of instance j, out[j][ii] is output ii of instance j, j < n_inst;
+// for np > 0, in[j][idx_in_p] is the parameter vector of instance j
+void external_function_casadi_batch_wrapper(void *self, int n_inst, ext_fun_arg_t *type_in, void ***in,
+                                            ext_fun_arg_t *type_out, void ***out);
+//
+void external_function_casadi_batch_get_nparam(void *self, int *np);
+//
+size_t external_function_casadi_batch_get_external_workspace_requirement(void *self);
+//
+void external_function_casadi_batch_set_external_workspace(void *self, void *workspace);
+
+
 /************************************************
  * external_function_external_param_casadi
  ************************************************/
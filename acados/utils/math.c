@@ -1184,3 +1184,25 @@ void neville_algorithm(double xx, int n, double *x, double *Q, double *out)
     }
     out[0] = Q[0];
 }
+
+
+
+int track_change(double x, double *x_prev)
+{
+    if (x != *x_prev)
+    {
+        *x_prev = x;
+        return 1;
+    }
+    return 0;
+}
+
+
+
+int track_changes(int n, const double *x, double *x_prev)
+{
+    int changed = 0;
+    for (int ii = 0; ii < n; ii++)
+        changed |= track_change(x[ii], x_prev + ii);
+    return changed;
+}
@@ -105,6 +105,12 @@ void compute_gershgorin_max_abs_eig_estimate(int n, struct blasfeo_dmat *A, doub
 
 void compute_gershgorin_min_eig_estimate(int n, struct blasfeo_dmat *A, double *out);
 
+/* stores x in x_prev, returns 1 if it differs from the stored value */
+int track_change(double x, double *x_prev);
+
+/* stores x[0:n] in x_prev, returns 1 if any value differs from the stored one */
+int track_changes(int n, const double *x, double *x_prev);
+
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -33,6 +33,7 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 // blasfeo
 #include "blasfeo_d_aux.h"
@@ -252,3 +253,80 @@ void print_pointer_alignment(char **ptr)
         printf("Pointer is NOT aligned to 8 bytes\n");
     }
 }
+
+
+
+/************************************************
+ * arena
+ ************************************************/
+
+acados_size_t acados_arena_block_size(acados_size_t size)
+{
+    make_int_multiple_of(64, &size);
+    return size + 64;  // align
+}
+
+
+
+acados_arena *acados_arena_create(acados_size_t size)
+{
+    acados_size_t bytes = sizeof(acados_arena) + size;
+
+    void *ptr = acados_calloc(1, bytes);
+    if (ptr == NULL)
+        return NULL;
+
+    char *c_ptr = (char *) ptr;
+
+    acados_arena *arena = (acados_arena *) c_ptr;
+    c_ptr += sizeof(acados_arena);
+
+    arena->raw_memory = c_ptr;
+    arena->c_ptr = c_ptr;
+    arena->size = size;
+
+    return arena;
+}
+
+
+
+void *acados_arena_alloc(acados_arena *arena, acados_size_t size)
+{
+    char *c_ptr = arena->c_ptr;
+    align_char_to(64, &c_ptr);
+
+    make_int_multiple_of(64, &size);
+    if (c_ptr + size > arena->raw_memory + arena->size)
+    {
+        printf("\nerror: acados_arena_alloc: requested %zu bytes, but only %zu bytes left in arena.\n",
+               (size_t) size, (size_t) (arena->size - acados_arena_get_used_size(arena)));
+        return NULL;
+    }
+
+    arena->c_ptr = c_ptr + size;
+
+    return (void *) c_ptr;
+}
+
+
+
+acados_size_t acados_arena_get_used_size(acados_arena *arena)
+{
+    return (acados_size_t) (arena->c_ptr - arena->raw_memory);
+}
+
+
+
+void acados_arena_reset(acados_arena *arena)
+{
+    // zero used memory, as after acados_calloc
+    memset(arena->raw_memory, 0, acados_arena_get_used_size(arena));
+    arena->c_ptr = arena->raw_memory;
+}
+
+
+
+void acados_arena_destroy(acados_arena *arena)
+{
+    free(arena);
+}
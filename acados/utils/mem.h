@@ -94,6 +94,39 @@ void assign_and_advance_blasfeo_dmat_mem(int m, int n, struct blasfeo_dmat *sA,
 // print pointer alignment
 void print_pointer_alignment(char **ptr);
 
+
+
+/************************************************
+ * arena
+ ************************************************/
+
+// memory arena: one allocation, from which several objects (e.g. solvers sharing config, dims and opts)
+// get their memory consecutively; blocks are released all at once by reset or destroy
+typedef struct acados_arena_
+{
+    char *raw_memory;
+    char *c_ptr;  // first free byte
+    acados_size_t size;
+} acados_arena;
+
+// size to reserve in an arena for a block of given size, including alignment
+acados_size_t acados_arena_block_size(acados_size_t size);
+
+// allocate arena with capacity size, to be computed as a sum of acados_arena_block_size
+acados_arena *acados_arena_create(acados_size_t size);
+
+// get 64-byte aligned block of given size from arena, returns NULL if capacity is exceeded
+void *acados_arena_alloc(acados_arena *arena, acados_size_t size);
+
+// number of bytes of the arena in use
+acados_size_t acados_arena_get_used_size(acados_arena *arena);
+
+// release all blocks, the memory is kept for reuse
+void acados_arena_reset(acados_arena *arena);
+
+// free arena and all blocks
+void acados_arena_destroy(acados_arena *arena);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -138,6 +138,13 @@ typedef enum
     INF_NORM,
 } ocp_nlp_qpscaling_constraint_type;
 
+/// Values of the last stage after shifting the horizon by one stage
+typedef enum
+{
+    SHIFT_TAIL_KEEP,  // last stage keeps its values, i.e. is duplicated
+    SHIFT_TAIL_ZERO,  // last stage is set to zero
+} ocp_shift_tail_policy;
+
 
 
 #ifdef __cplusplus
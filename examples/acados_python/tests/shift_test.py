@@ -0,0 +1,159 @@
+#
+# Copyright (c) The acados authors.
+#
+# This file is part of acados.
+#
+# The 2-Clause BSD License
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.;
+#
+
+
+import sys
+sys.path.insert(0, '../pendulum_on_cart/common')
+
+from acados_template import AcadosOcp, AcadosOcpSolver
+from pendulum_model import export_pendulum_ode_model
+import numpy as np
+import scipy.linalg
+
+
+def create_solver(N=20, Tf=1.0):
+    ocp = AcadosOcp()
+
+    model = export_pendulum_ode_model()
+    ocp.model = model
+
+    nx = model.x.rows()
+    nu = model.u.rows()
+    ny = nx + nu
+
+    ocp.solver_options.N_horizon = N
+    ocp.solver_options.tf = Tf
+
+    # cost
+    Q = 2*np.diag([1e3, 1e3, 1e-2, 1e-2])
+    R = 2*np.diag([1e-2])
+
+    ocp.cost.cost_type = 'LINEAR_LS'
+    ocp.cost.cost_type_e = 'LINEAR_LS'
+    ocp.cost.W = scipy.linalg.block_diag(Q, R)
+    ocp.cost.W_e = Q
+    ocp.cost.Vx = np.zeros((ny, nx))
+    ocp.cost.Vx[:nx, :nx] = np.eye(nx)
+    ocp.cost.Vu = np.zeros((ny, nu))
+    ocp.cost.Vu[nx, 0] = 1.0
+    ocp.cost.Vx_e = np.eye(nx)
+    ocp.cost.yref = np.zeros((ny, ))
+    ocp.cost.yref_e = np.zeros((nx, ))
+
+    # constraints: stage 0 has the initial state bounds and no h,
+    # stages 1 to N-1 bound u and have a soft nonlinear constraint, stage N has no constraints,
+    # such that the constraints of stage 0 and N-1 differ from the ones of the next stage
+    Fmax = 80
+    ocp.constraints.x0 = np.array([0.0, np.pi, 0.0, 0.0])
+    ocp.constraints.lbu = np.array([-Fmax])
+    ocp.constraints.ubu = np.array([+Fmax])
+    ocp.constraints.idxbu = np.array([0])
+
+    ocp.model.con_h_expr = model.x[2]**2
+    ocp.constraints.lh = np.array([0.0])
+    ocp.constraints.uh = np.array([4.0])
+    ocp.constraints.idxsh = np.array([0])
+    ocp.cost.zl = 1e2 * np.ones((1,))
+    ocp.cost.zu = 1e2 * np.ones((1,))
+    ocp.cost.Zl = 1e0 * np.ones((1,))
+    ocp.cost.Zu = 1e0 * np.ones((1,))
+
+    ocp.solver_options.qp_solver = 'PARTIAL_CONDENSING_HPIPM'
+    ocp.solver_options.qp_solver_cond_N = 5
+    ocp.solver_options.hessian_approx = 'GAUSS_NEWTON'
+    ocp.solver_options.integrator_type = 'ERK'
+    ocp.solver_options.nlp_solver_type = 'SQP'
+
+    return AcadosOcpSolver(ocp, json_file='acados_ocp_shift.json')
+
+
+def get_iterate(ocp_solver, N):
+    iterate = {}
+    for field in ['x', 'lam']:
+        iterate[field] = [ocp_solver.get(i, field) for i in range(N+1)]
+    for field in ['u', 'pi']:
+        iterate[field] = [ocp_solver.get(i, field) for i in range(N)]
+    return iterate
+
+
+def main():
+    N = 20
+    ocp_solver = create_solver(N)
+
+    status = ocp_solver.solve()
+    if status != 0:
+        raise Exception(f'acados returned status {status}.')
+
+    # keep: every stage takes the values of the next one, if the constraints match
+    prev = get_iterate(ocp_solver, N)
+    ocp_solver.shift('keep')
+    shifted = get_iterate(ocp_solver, N)
+
+    for i in range(N):
+        assert np.array_equal(shifted['x'][i], prev['x'][i+1]), f'x not shifted at stage {i}'
+    assert np.array_equal(shifted['x'][N], prev['x'][N])
+    for i in range(N-1):
+        assert np.array_equal(shifted['u'][i], prev['u'][i+1]), f'u not shifted at stage {i}'
+        assert np.array_equal(shifted['pi'][i], prev['pi'][i+1]), f'pi not shifted at stage {i}'
+    assert np.array_equal(shifted['u'][N-1], prev['u'][N-1])
+    assert np.array_equal(shifted['pi'][N-1], prev['pi'][N-1])
+    for i in range(1, N-1):
+        assert np.array_equal(shifted['lam'][i], prev['lam'][i+1]), f'lam not shifted at stage {i}'
+    # multipliers of different constraints are not shifted across
+    for i in [0, N-1, N]:
+        assert np.array_equal(shifted['lam'][i], prev['lam'][i]), f'lam shifted across different constraints at stage {i}'
+
+    # zero: the tail and the multipliers of different constraints are set to zero
+    ocp_solver.shift('zero')
+    shifted = get_iterate(ocp_solver, N)
+
+    assert not np.any(shifted['x'][N])
+    assert not np.any(shifted['u'][N-1])
+    assert not np.any(shifted['pi'][N-1])
+    for i in [0, N-1, N]:
+        assert not np.any(shifted['lam'][i]), f'lam not set to zero at stage {i}'
+
+    try:
+        ocp_solver.shift('repeat')
+    except ValueError:
+        pass
+    else:
+        raise Exception('shift accepted an unknown tail_policy.')
+
+    # the shifted iterate is a valid initial guess, also for the condensed QP
+    status = ocp_solver.solve()
+    if status != 0:
+        raise Exception(f'acados returned status {status} after shifting.')
+
+    print('shift test passed.')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#include <assert.h>
+
+/*
+ * Hessian of the GNSF function f_lo of the crane DAE model, derived by hand
+ * (this model has no CasADi export for second order derivatives).
+ *
+ * Inputs:  x1[5], x1dot[5], z1[0], u[2], lambda[6]
+ * Output:  sum_i lambda_i * d^2 f_lo_i / d(x1, x1dot, u)^2, dense 12x12,
+ *          column-major; z1 is empty for this model.
+ *
+ * The casadi calling convention is kept so that the function can be wrapped in
+ * an external_function_casadi; all in- and outputs use the dense sparsity format.
+ */
+
+#include <math.h>
+
+#define NX1 5
+#define NU 2
+#define NLO 6
+#define NV (2 * NX1 + NU)
+
+static const int crane_dae_f_lo_hess_sparsity_x1[3] = {NX1, 1, 1};
+static const int crane_dae_f_lo_hess_sparsity_z1[3] = {0, 1, 1};
+static const int crane_dae_f_lo_hess_sparsity_u[3] = {NU, 1, 1};
+static const int crane_dae_f_lo_hess_sparsity_lambda[3] = {NLO, 1, 1};
+static const int crane_dae_f_lo_hess_sparsity_hess[3] = {NV, NV, 1};
+
+
+
+int crane_dae_f_lo_hess(const double **arg, double **res, int *iw, double *w, void *mem)
+{
+    const double *x1 = arg[0];
+    const double *x1dot = arg[1];
+    const double *u = arg[3];
+    const double *lambda = arg[4];
+    double *H = res[0];
+
+    if (H == 0)
+        return 0;
+
+    // variable ordering: x1 -> 0..4, x1dot -> 5..9, u -> 10..11
+    const int iu0 = 2 * NX1;
+    const int iu1 = 2 * NX1 + 1;
+
+    for (int ii = 0; ii < NV * NV; ii++)
+        H[ii] = 0.0;
+
+    // lower triangle
+    H[0 + NV * 0] = lambda[3] * (2.0 - cos(x1[0]));
+    H[1 + NV * 1] = -2.0 * lambda[5] * u[0] * u[0];
+    H[5 + NV * 1] = 2.0 * lambda[5] * u[0];
+    H[iu0 + NV * 1] = 2.0 * lambda[5] * (x1dot[0] - 2.0 * u[0] * x1[1]);
+    H[3 + NV * 3] = -0.25 * lambda[4];
+    H[4 + NV * 4] = lambda[5] * cos(x1[4] + 0.1);
+    H[5 + NV * 5] = -2.0 * lambda[5];
+    H[iu0 + NV * 5] = 2.0 * lambda[5] * x1[1];
+    H[iu0 + NV * iu0] = 2.0 * lambda[3] - 2.0 * lambda[5] * x1[1] * x1[1];
+    H[iu1 + NV * iu1] = lambda[4] * sin(u[1]);
+
+    // mirror into the upper triangle
+    for (int jj = 0; jj < NV; jj++)
+        for (int ii = jj + 1; ii < NV; ii++)
+            H[jj + NV * ii] = H[ii + NV * jj];
+
+    return 0;
+}
+
+
+
+int crane_dae_f_lo_hess_work(int *sz_arg, int *sz_res, int *sz_iw, int *sz_w)
+{
+    if (sz_arg) *sz_arg = 5;
+    if (sz_res) *sz_res = 1;
+    if (sz_iw) *sz_iw = 0;
+    if (sz_w) *sz_w = 0;
+    return 0;
+}
+
+
+
+const int *crane_dae_f_lo_hess_sparsity_in(int i)
+{
+    switch (i)
+    {
+        case 0: return crane_dae_f_lo_hess_sparsity_x1;
+        case 1: return crane_dae_f_lo_hess_sparsity_x1;
+        case 2: return crane_dae_f_lo_hess_sparsity_z1;
+        case 3: return crane_dae_f_lo_hess_sparsity_u;
+        case 4: return crane_dae_f_lo_hess_sparsity_lambda;
+        default: return 0;
+    }
+}
+
+
+
+const int *crane_dae_f_lo_hess_sparsity_out(int i)
+{
+    switch (i)
+    {
+        case 0: return crane_dae_f_lo_hess_sparsity_hess;
+        default: return 0;
+    }
+}
+
+
+
+int crane_dae_f_lo_hess_n_in(void) { return 5; }
+
+int crane_dae_f_lo_hess_n_out(void) { return 1; }
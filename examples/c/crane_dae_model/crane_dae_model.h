@@ -113,6 +113,22 @@ const int *crane_dae_f_lo_fun_jac_x1k1uz_sparsity_out(int);
 int        crane_dae_f_lo_fun_jac_x1k1uz_n_in();
 int        crane_dae_f_lo_fun_jac_x1k1uz_n_out();
 
+// phi_hess (hand-derived, dense output)
+int        crane_dae_phi_hess(const double** arg, double** res, int* iw, double* w, void *mem);
+int        crane_dae_phi_hess_work(int *, int *, int *, int *);
+const int *crane_dae_phi_hess_sparsity_in(int);
+const int *crane_dae_phi_hess_sparsity_out(int);
+int        crane_dae_phi_hess_n_in();
+int        crane_dae_phi_hess_n_out();
+
+// f_lo_hess (hand-derived, dense output)
+int        crane_dae_f_lo_hess(const double** arg, double** res, int* iw, double* w, void *mem);
+int        crane_dae_f_lo_hess_work(int *, int *, int *, int *);
+const int *crane_dae_f_lo_hess_sparsity_in(int);
+const int *crane_dae_f_lo_hess_sparsity_out(int);
+int        crane_dae_f_lo_hess_n_in();
+int        crane_dae_f_lo_hess_n_out();
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
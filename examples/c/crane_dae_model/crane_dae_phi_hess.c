@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#include <assert.h>
+
+/*
+ * Hessian of the GNSF nonlinearity phi of the crane DAE model, derived by hand
+ * (this model has no CasADi export for second order derivatives).
+ *
+ *   phi(y, uhat) = -(c * uhat * cos(y2) + g * sin(y2) + 2 * y1 * y3) / y0
+ *
+ * Inputs:  y[4], uhat[1], lambda[1]
+ * Output:  lambda * d^2 phi / d(y, uhat)^2, dense 5x5, column-major.
+ *
+ * The casadi calling convention is kept so that the function can be wrapped in
+ * an external_function_casadi; all in- and outputs use the dense sparsity format.
+ */
+
+#include <math.h>
+
+#define NY 4
+#define NV (NY + 1)
+
+static const int crane_dae_phi_hess_sparsity_y[3] = {NY, 1, 1};
+static const int crane_dae_phi_hess_sparsity_scalar[3] = {1, 1, 1};
+static const int crane_dae_phi_hess_sparsity_hess[3] = {NV, NV, 1};
+
+
+
+int crane_dae_phi_hess(const double **arg, double **res, int *iw, double *w, void *mem)
+{
+    const double c = 4.7418203070092001e-02;
+    const double g = 9.81;
+
+    const double *y = arg[0];
+    const double uhat = arg[1][0];
+    const double lambda = arg[2][0];
+    double *H = res[0];
+
+    if (H == 0)
+        return 0;
+
+    const double cy2 = cos(y[2]);
+    const double sy2 = sin(y[2]);
+    const double a = c * uhat * cy2 + g * sy2;
+    const double iy0 = 1.0 / y[0];
+    const double iy02 = iy0 * iy0;
+
+    for (int ii = 0; ii < NV * NV; ii++)
+        H[ii] = 0.0;
+
+    // lower triangle
+    H[0 + NV * 0] = -2.0 * lambda * (a + 2.0 * y[1] * y[3]) * iy02 * iy0;
+    H[1 + NV * 0] = 2.0 * lambda * y[3] * iy02;
+    H[2 + NV * 0] = lambda * (g * cy2 - c * uhat * sy2) * iy02;
+    H[3 + NV * 0] = 2.0 * lambda * y[1] * iy02;
+    H[4 + NV * 0] = lambda * c * cy2 * iy02;
+    H[3 + NV * 1] = -2.0 * lambda * iy0;
+    H[2 + NV * 2] = lambda * a * iy0;
+    H[4 + NV * 2] = lambda * c * sy2 * iy0;
+
+    // mirror into the upper triangle
+    for (int jj = 0; jj < NV; jj++)
+        for (int ii = jj + 1; ii < NV; ii++)
+            H[jj + NV * ii] = H[ii + NV * jj];
+
+    return 0;
+}
+
+
+
+int crane_dae_phi_hess_work(int *sz_arg, int *sz_res, int *sz_iw, int *sz_w)
+{
+    if (sz_arg) *sz_arg = 3;
+    if (sz_res) *sz_res = 1;
+    if (sz_iw) *sz_iw = 0;
+    if (sz_w) *sz_w = 0;
+    return 0;
+}
+
+
+
+const int *crane_dae_phi_hess_sparsity_in(int i)
+{
+    switch (i)
+    {
+        case 0: return crane_dae_phi_hess_sparsity_y;
+        case 1: return crane_dae_phi_hess_sparsity_scalar;
+        case 2: return crane_dae_phi_hess_sparsity_scalar;
+        default: return 0;
+    }
+}
+
+
+
+const int *crane_dae_phi_hess_sparsity_out(int i)
+{
+    switch (i)
+    {
+        case 0: return crane_dae_phi_hess_sparsity_hess;
+        default: return 0;
+    }
+}
+
+
+
+int crane_dae_phi_hess_n_in(void) { return 3; }
+
+int crane_dae_phi_hess_n_out(void) { return 1; }
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+
+
+// Benchmark of the per-call overhead of setting bounds and references of all stages,
+// by field name (string compare dispatch) and through precompiled field handles.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// acados
+#include "acados/utils/timing.h"
+
+#include "acados_c/ocp_nlp_interface.h"
+
+
+
+int main()
+{
+    int NREP = 10000;
+
+    const int N = 20;
+    const int NX = 4;
+    const int NU = 1;
+    const int NY = NX + NU;
+
+    int nx[N+1], nu[N+1], ny[N+1], nbx[N+1], nbu[N+1];
+    for (int i = 0; i <= N; i++)
+    {
+        nx[i] = NX;
+        nu[i] = i < N ? NU : 0;
+        ny[i] = nx[i] + nu[i];
+        nbx[i] = NX;
+        nbu[i] = nu[i];
+    }
+
+    ocp_nlp_plan_t *plan = ocp_nlp_plan_create(N);
+    plan->nlp_solver = SQP_RTI;
+    plan->ocp_qp_solver_plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+    for (int i = 0; i <= N; i++)
+    {
+        plan->nlp_cost[i] = LINEAR_LS;
+        plan->nlp_constraints[i] = BGH;
+    }
+    for (int i = 0; i < N; i++)
+        plan->nlp_dynamics[i] = DISCRETE_MODEL;
+
+    ocp_nlp_config *config = ocp_nlp_config_create(*plan);
+
+    ocp_nlp_dims *dims = ocp_nlp_dims_create(config);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nx", nx);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nu", nu);
+    for (int i = 0; i <= N; i++)
+    {
+        ocp_nlp_dims_set_cost(config, dims, i, "ny", &ny[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nbx", &nbx[i]);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nbu", &nbu[i]);
+    }
+
+    ocp_nlp_in *nlp_in = ocp_nlp_in_create(config, dims);
+    ocp_nlp_out *nlp_out = ocp_nlp_out_create(config, dims);
+
+    int idxbx[NX];
+    double lbx[NX], ubx[NX], yref[NY];
+    for (int ii = 0; ii < NX; ii++)
+    {
+        idxbx[ii] = ii;
+        lbx[ii] = -1.0;
+        ubx[ii] = 1.0;
+    }
+    for (int ii = 0; ii < NY; ii++)
+        yref[ii] = 0.0;
+
+    for (int i = 0; i <= N; i++)
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, i, "idxbx", idxbx);
+
+    // resolve handles once
+    ocp_nlp_field_handle h_lbx[N+1], h_ubx[N+1], h_yref[N+1];
+    for (int i = 0; i <= N; i++)
+    {
+        h_lbx[i] = ocp_nlp_constraints_field_lookup(config, dims, i, "lbx");
+        h_ubx[i] = ocp_nlp_constraints_field_lookup(config, dims, i, "ubx");
+        h_yref[i] = ocp_nlp_cost_field_lookup(config, dims, i, "yref");
+    }
+
+    acados_timer timer;
+    double time_string, time_handle;
+
+    // by field name
+    acados_tic(&timer);
+    for (int rep = 0; rep < NREP; rep++)
+    {
+        for (int i = 0; i <= N; i++)
+        {
+            ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, i, "lbx", lbx);
+            ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, i, "ubx", ubx);
+            ocp_nlp_cost_model_set(config, dims, nlp_in, i, "yref", yref);
+        }
+    }
+    time_string = acados_toc(&timer) / (NREP * 3 * (N+1));
+
+    // through handles
+    acados_tic(&timer);
+    for (int rep = 0; rep < NREP; rep++)
+    {
+        for (int i = 0; i <= N; i++)
+        {
+            ocp_nlp_field_handle_set(config, dims, nlp_in, nlp_out, h_lbx[i], lbx);
+            ocp_nlp_field_handle_set(config, dims, nlp_in, nlp_out, h_ubx[i], ubx);
+            ocp_nlp_field_handle_set(config, dims, nlp_in, nlp_out, h_yref[i], yref);
+        }
+    }
+    time_handle = acados_toc(&timer) / (NREP * 3 * (N+1));
+
+    printf("\nset lbx, ubx, yref on %d stages, nx = %d\n", N+1, NX);
+    printf("time per call, field name:  %8.4f [ns]\n", 1e9*time_string);
+    printf("time per call, handle:      %8.4f [ns]\n", 1e9*time_handle);
+
+    ocp_nlp_out_destroy(nlp_out);
+    ocp_nlp_in_destroy(nlp_in);
+    ocp_nlp_dims_destroy(dims);
+    ocp_nlp_config_destroy(config);
+    ocp_nlp_plan_destroy(plan);
+
+    return 0;
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// Benchmark of the simplified Newton scheme of the IRK integrator against full Newton
+// on the implicit chain model with 4 free masses (nx = 24): time per call and deviation
+// of the result for different numbers of stages.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// acados
+#include "acados/sim/sim_common.h"
+#include "acados/utils/external_function_generic.h"
+#include "acados/utils/timing.h"
+
+#include "acados_c/external_function_interface.h"
+#include "acados_c/sim_interface.h"
+
+// chain model
+#include "examples/c/implicit_chain_model/chain_model_impl.h"
+#include "examples/c/chain_model/x0_nm5.c"
+
+
+
+int main()
+{
+    int NREP = 500;
+
+    int nx = 24;
+    int nu = 3;
+
+    double T = 0.25;  // shooting interval of the chain OCP example
+    double u0[] = {0.1, -0.1, 0.05};
+
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+
+    external_function_casadi impl_ode_fun;
+    impl_ode_fun.casadi_fun = &casadi_impl_ode_fun_chain_nm5;
+    impl_ode_fun.casadi_work = &casadi_impl_ode_fun_chain_nm5_work;
+    impl_ode_fun.casadi_sparsity_in = &casadi_impl_ode_fun_chain_nm5_sparsity_in;
+    impl_ode_fun.casadi_sparsity_out = &casadi_impl_ode_fun_chain_nm5_sparsity_out;
+    impl_ode_fun.casadi_n_in = &casadi_impl_ode_fun_chain_nm5_n_in;
+    impl_ode_fun.casadi_n_out = &casadi_impl_ode_fun_chain_nm5_n_out;
+    external_function_casadi_create(&impl_ode_fun, &ext_fun_opts);
+
+    external_function_casadi impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_fun = &casadi_impl_ode_fun_jac_x_xdot_chain_nm5;
+    impl_ode_fun_jac_x_xdot.casadi_work = &casadi_impl_ode_fun_jac_x_xdot_chain_nm5_work;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_in = &casadi_impl_ode_fun_jac_x_xdot_chain_nm5_sparsity_in;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_out = &casadi_impl_ode_fun_jac_x_xdot_chain_nm5_sparsity_out;
+    impl_ode_fun_jac_x_xdot.casadi_n_in = &casadi_impl_ode_fun_jac_x_xdot_chain_nm5_n_in;
+    impl_ode_fun_jac_x_xdot.casadi_n_out = &casadi_impl_ode_fun_jac_x_xdot_chain_nm5_n_out;
+    external_function_casadi_create(&impl_ode_fun_jac_x_xdot, &ext_fun_opts);
+
+    external_function_casadi impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_fun = &casadi_impl_ode_jac_x_xdot_u_chain_nm5;
+    impl_ode_jac_x_xdot_u.casadi_work = &casadi_impl_ode_jac_x_xdot_u_chain_nm5_work;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_in = &casadi_impl_ode_jac_x_xdot_u_chain_nm5_sparsity_in;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_out = &casadi_impl_ode_jac_x_xdot_u_chain_nm5_sparsity_out;
+    impl_ode_jac_x_xdot_u.casadi_n_in = &casadi_impl_ode_jac_x_xdot_u_chain_nm5_n_in;
+    impl_ode_jac_x_xdot_u.casadi_n_out = &casadi_impl_ode_jac_x_xdot_u_chain_nm5_n_out;
+    external_function_casadi_create(&impl_ode_jac_x_xdot_u, &ext_fun_opts);
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = IRK;
+    sim_config *config = sim_config_create(plan);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+
+    double *xn = malloc(2 * nx * sizeof(double));
+    double *S_forw = malloc(2 * nx * (nx + nu) * sizeof(double));
+
+    printf("\nIRK on the chain model, nx = %d, nu = %d, T = %f\n", nx, nu, T);
+    printf("\n ns   full Newton [us]   simplified Newton [us]   speedup   max |xn diff|   max |S_forw diff|\n");
+
+    for (int ns = 2; ns <= 4; ns++)
+    {
+        double cpu_time[2];
+
+        for (int simplified = 0; simplified < 2; simplified++)
+        {
+            sim_opts *opts = sim_opts_create(config, dims);
+            int num_steps = 2;
+            int newton_iter = 3;
+            bool jac_reuse = true;
+            bool simplified_newton = simplified;
+            sim_opts_set(config, opts, "ns", &ns);
+            sim_opts_set(config, opts, "num_steps", &num_steps);
+            sim_opts_set(config, opts, "newton_iter", &newton_iter);
+            sim_opts_set(config, opts, "jac_reuse", &jac_reuse);
+            sim_opts_set(config, opts, "simplified_newton", &simplified_newton);
+
+            sim_in *in = sim_in_create(config, dims);
+            sim_in_set(config, dims, in, "T", &T);
+            sim_in_set(config, dims, in, "x", x0_nm5);
+            sim_in_set(config, dims, in, "u", u0);
+            sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+            sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot);
+            sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+
+            sim_out *out = sim_out_create(config, dims);
+
+            sim_solver *sim_solver = sim_solver_create(config, dims, opts, in);
+            sim_precompute(sim_solver, in, out);
+
+            // warm up
+            for (int ii = 0; ii < NREP/10; ii++)
+                sim_solve(sim_solver, in, out);
+
+            acados_timer timer;
+            acados_tic(&timer);
+            for (int ii = 0; ii < NREP; ii++)
+                sim_solve(sim_solver, in, out);
+            cpu_time[simplified] = acados_toc(&timer) / NREP;
+
+            sim_out_get(config, dims, out, "xn", xn + simplified * nx);
+            sim_out_get(config, dims, out, "S_forw", S_forw + simplified * nx * (nx + nu));
+
+            sim_solver_destroy(sim_solver);
+            sim_in_destroy(in);
+            sim_out_destroy(out);
+            sim_opts_destroy(opts);
+        }
+
+        double xn_diff = 0.0, S_forw_diff = 0.0;
+        for (int jj = 0; jj < nx; jj++)
+            xn_diff = fmax(xn_diff, fabs(xn[jj] - xn[nx + jj]));
+        for (int jj = 0; jj < nx * (nx + nu); jj++)
+            S_forw_diff = fmax(S_forw_diff, fabs(S_forw[jj] - S_forw[nx * (nx + nu) + jj]));
+
+        printf(" %2d   %16.2f   %22.2f   %7.2f   %13.2e   %17.2e\n", ns, 1e6*cpu_time[0], 1e6*cpu_time[1],
+               cpu_time[0] / cpu_time[1], xn_diff, S_forw_diff);
+    }
+
+    free(xn);
+    free(S_forw);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+
+    external_function_casadi_free(&impl_ode_fun);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&impl_ode_jac_x_xdot_u);
+
+    return 0;
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+
+// Benchmark of the cached workspace cast in the IRK integrator: the integrator is
+// called repeatedly with the same workspace (pointer tables cast once) and with
+// two alternating workspaces (pointer tables recast on every call).
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// acados
+#include "acados/sim/sim_common.h"
+#include "acados/utils/external_function_generic.h"
+#include "acados/utils/timing.h"
+
+#include "acados_c/external_function_interface.h"
+#include "acados_c/sim_interface.h"
+
+// crane model
+#include "examples/c/crane_model/crane_model.h"
+
+
+
+int main()
+{
+    int NREP = 10000;
+
+    int nx = 4;
+    int nu = 1;
+
+    double T = 0.01;
+
+    double x0[] = {0.0, 3.1415, 0.0, 0.0};
+    double u0[] = {1.0};
+
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+
+    external_function_casadi impl_ode_fun;
+    impl_ode_fun.casadi_fun = &casadi_impl_ode_fun;
+    impl_ode_fun.casadi_work = &casadi_impl_ode_fun_work;
+    impl_ode_fun.casadi_sparsity_in = &casadi_impl_ode_fun_sparsity_in;
+    impl_ode_fun.casadi_sparsity_out = &casadi_impl_ode_fun_sparsity_out;
+    impl_ode_fun.casadi_n_in = &casadi_impl_ode_fun_n_in;
+    impl_ode_fun.casadi_n_out = &casadi_impl_ode_fun_n_out;
+    external_function_casadi_create(&impl_ode_fun, &ext_fun_opts);
+
+    external_function_casadi impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_fun = &casadi_impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_work = &casadi_impl_ode_fun_jac_x_xdot_work;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_in = &casadi_impl_ode_fun_jac_x_xdot_sparsity_in;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_out = &casadi_impl_ode_fun_jac_x_xdot_sparsity_out;
+    impl_ode_fun_jac_x_xdot.casadi_n_in = &casadi_impl_ode_fun_jac_x_xdot_n_in;
+    impl_ode_fun_jac_x_xdot.casadi_n_out = &casadi_impl_ode_fun_jac_x_xdot_n_out;
+    external_function_casadi_create(&impl_ode_fun_jac_x_xdot, &ext_fun_opts);
+
+    external_function_casadi impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_fun = &casadi_impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_work = &casadi_impl_ode_jac_x_xdot_u_work;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_in = &casadi_impl_ode_jac_x_xdot_u_sparsity_in;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_out = &casadi_impl_ode_jac_x_xdot_u_sparsity_out;
+    impl_ode_jac_x_xdot_u.casadi_n_in = &casadi_impl_ode_jac_x_xdot_u_n_in;
+    impl_ode_jac_x_xdot_u.casadi_n_out = &casadi_impl_ode_jac_x_xdot_u_n_out;
+    external_function_casadi_create(&impl_ode_jac_x_xdot_u, &ext_fun_opts);
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = IRK;
+    sim_config *config = sim_config_create(plan);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+
+    // small integrator, typical for a single RTI step of a small model
+    sim_opts *opts = sim_opts_create(config, dims);
+    int ns = 2;
+    int num_steps = 1;
+    sim_opts_set(config, opts, "ns", &ns);
+    sim_opts_set(config, opts, "num_steps", &num_steps);
+
+    sim_in *in = sim_in_create(config, dims);
+    sim_in_set(config, dims, in, "T", &T);
+    sim_in_set(config, dims, in, "x", x0);
+    sim_in_set(config, dims, in, "u", u0);
+    sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+    sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot);
+    sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+
+    sim_out *out = sim_out_create(config, dims);
+
+    sim_solver *sim_solver = sim_solver_create(config, dims, opts, in);
+    sim_precompute(sim_solver, in, out);
+
+    // second workspace, alternating with the first one invalidates the cached cast
+    acados_size_t work_size = config->workspace_calculate_size(config, dims, opts);
+    void *work_other = calloc(1, work_size);
+    void *work = sim_solver->work;
+
+    acados_timer timer;
+    double time_cached, time_recast;
+
+    // warm up
+    for (int ii = 0; ii < NREP/10; ii++)
+        sim_solve(sim_solver, in, out);
+
+    // same workspace
+    acados_tic(&timer);
+    for (int ii = 0; ii < NREP; ii++)
+        sim_solve(sim_solver, in, out);
+    time_cached = acados_toc(&timer) / NREP;
+
+    // alternating workspaces
+    acados_tic(&timer);
+    for (int ii = 0; ii < NREP; ii++)
+    {
+        sim_solver->work = ii % 2 ? work : work_other;
+        sim_solve(sim_solver, in, out);
+    }
+    time_recast = acados_toc(&timer) / NREP;
+    sim_solver->work = work;
+
+    printf("\nIRK, nx = %d, ns = %d, num_steps = %d\n", nx, ns, num_steps);
+    printf("time per call, cached cast:  %8.4f [us]\n", 1e6*time_cached);
+    printf("time per call, recast:       %8.4f [us]\n", 1e6*time_recast);
+    printf("saved per call:              %8.4f [us]\n", 1e6*(time_recast - time_cached));
+
+    free(work_other);
+    sim_solver_destroy(sim_solver);
+    sim_in_destroy(in);
+    sim_out_destroy(out);
+    sim_opts_destroy(opts);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+
+    external_function_casadi_free(&impl_ode_fun);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&impl_ode_jac_x_xdot_u);
+
+    return 0;
+}
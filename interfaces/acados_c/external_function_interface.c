@@ -141,6 +141,32 @@ void external_function_casadi_free_array(int size, external_function_casadi *fun
 
 
 
+/************************************************
+ * batched casadi external function
+ ************************************************/
+
+void external_function_casadi_batch_create(external_function_casadi_batch *fun, int batch_size, int np,
+                                           external_function_opts *opts_)
+{
+    acados_size_t fun_size = external_function_casadi_batch_calculate_size(fun, batch_size, np, opts_);
+    void *fun_mem = acados_malloc(1, fun_size);
+    assert(fun_mem != 0);
+    external_function_casadi_batch_assign(fun, fun_mem);
+
+    return;
+}
+
+
+
+void external_function_casadi_batch_free(external_function_casadi_batch *fun)
+{
+    free(fun->ptr_ext_mem);
+
+    return;
+}
+
+
+
 /************************************************
  * casadi external parametric function
  ************************************************/
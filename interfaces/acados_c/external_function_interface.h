@@ -66,6 +66,19 @@ void external_function_casadi_free_array(int size, external_function_casadi *fun
 
 
 
+/************************************************
+ * batched casadi external function
+ ************************************************/
+
+// batch_size has to match the map size of the generated casadi function,
+// np > 0 if the last input of the underlying function is a parameter vector of size np
+void external_function_casadi_batch_create(external_function_casadi_batch *fun, int batch_size, int np,
+                                           external_function_opts *opts_);
+//
+void external_function_casadi_batch_free(external_function_casadi_batch *fun);
+
+
+
 /************************************************
  * casadi external parametric function
  ************************************************/
@@ -63,6 +63,7 @@
 #include "acados/ocp_nlp/ocp_nlp_ddp.h"
 #include "acados/utils/mem.h"
 #include "acados/utils/strsep.h"
+#include "acados/utils/timing.h"
 
 // blasfeo
 #include "blasfeo/include/blasfeo_d_blas.h"
@@ -432,6 +433,33 @@ void ocp_nlp_in_destroy(void *in_)
 
 
 
+acados_size_t ocp_nlp_in_arena_size(ocp_nlp_config *config, ocp_nlp_dims *dims)
+{
+    return acados_arena_block_size(ocp_nlp_in_calculate_size(config, dims));
+}
+
+
+
+ocp_nlp_in *ocp_nlp_in_create_in_arena(ocp_nlp_config *config, ocp_nlp_dims *dims, acados_arena *arena)
+{
+    acados_size_t bytes = ocp_nlp_in_calculate_size(config, dims);
+
+    void *ptr = acados_arena_alloc(arena, bytes);
+    if (ptr == NULL)
+    {
+        printf("\nerror: ocp_nlp_in_create_in_arena: arena capacity exceeded.\n");
+        return NULL;
+    }
+
+    ocp_nlp_in *nlp_in = ocp_nlp_in_assign(config, dims, ptr);
+    // memory is owned by the arena
+    nlp_in->raw_memory = NULL;
+
+    return nlp_in;
+}
+
+
+
 void ocp_nlp_in_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in, int stage,
         const char *field, void *value)
 {
@@ -542,6 +570,84 @@ int ocp_nlp_constraints_model_set(ocp_nlp_config *config, ocp_nlp_dims *dims,
 }
 
 
+ocp_nlp_field_handle ocp_nlp_constraints_field_lookup(ocp_nlp_config *config,
+        ocp_nlp_dims *dims, int stage, const char *field)
+{
+    ocp_nlp_constraints_config *constr_config = config->constraints[stage];
+    ocp_nlp_field_handle handle;
+
+    handle.module = OCP_NLP_CONSTRAINTS_FIELD;
+    handle.stage = stage;
+    handle.field_id = -1;
+    if (constr_config->model_field_id != NULL)
+    {
+        handle.field_id = constr_config->model_field_id(constr_config, dims->constraints[stage], field);
+    }
+
+    if (handle.field_id < 0)
+    {
+        printf("\nerror: ocp_nlp_constraints_field_lookup: no handle for field %s at stage %d,"
+               " use ocp_nlp_constraints_model_set.\n", field, stage);
+        exit(1);
+    }
+
+    return handle;
+}
+
+
+
+ocp_nlp_field_handle ocp_nlp_cost_field_lookup(ocp_nlp_config *config,
+        ocp_nlp_dims *dims, int stage, const char *field)
+{
+    ocp_nlp_cost_config *cost_config = config->cost[stage];
+    ocp_nlp_field_handle handle;
+
+    handle.module = OCP_NLP_COST_FIELD;
+    handle.stage = stage;
+    handle.field_id = -1;
+    if (cost_config->model_field_id != NULL)
+    {
+        handle.field_id = cost_config->model_field_id(cost_config, dims->cost[stage], field);
+    }
+
+    if (handle.field_id < 0)
+    {
+        printf("\nerror: ocp_nlp_cost_field_lookup: no handle for field %s at stage %d,"
+               " use ocp_nlp_cost_model_set.\n", field, stage);
+        exit(1);
+    }
+
+    return handle;
+}
+
+
+
+int ocp_nlp_field_handle_set(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_field_handle handle, void *value)
+{
+    int stage = handle.stage;
+    int status;
+
+    if (handle.module == OCP_NLP_CONSTRAINTS_FIELD)
+    {
+        ocp_nlp_constraints_config *constr_config = config->constraints[stage];
+        status = constr_config->model_set_by_id(constr_config, dims->constraints[stage],
+                in->constraints[stage], handle.field_id, value);
+        // multiply lam with new mask to ensure that multipliers associated with masked constraints are zero.
+        blasfeo_dvecmul(2*dims->ni[stage], &in->dmask[stage], 0, &out->lam[stage], 0, &out->lam[stage], 0);
+    }
+    else
+    {
+        ocp_nlp_cost_config *cost_config = config->cost[stage];
+        status = cost_config->model_set_by_id(cost_config, dims->cost[stage],
+                in->cost[stage], handle.field_id, value);
+    }
+
+    return status;
+}
+
+
+
 int ocp_nlp_dynamics_model_set_external_param_fun(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
         int stage, const char *field, void *ext_fun_)
 {
@@ -634,47 +740,204 @@ void ocp_nlp_out_destroy(void *out_)
 
 
 
-void ocp_nlp_out_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out, ocp_nlp_in *in,
-        int stage, const char *field, void *value)
+acados_size_t ocp_nlp_out_arena_size(ocp_nlp_config *config, ocp_nlp_dims *dims)
 {
-    double *double_values = value;
-    if (!strcmp(field, "x"))
+    return acados_arena_block_size(ocp_nlp_out_calculate_size(config, dims));
+}
+
+
+
+ocp_nlp_out *ocp_nlp_out_create_in_arena(ocp_nlp_config *config, ocp_nlp_dims *dims, acados_arena *arena)
+{
+    acados_size_t bytes = ocp_nlp_out_calculate_size(config, dims);
+
+    void *ptr = acados_arena_alloc(arena, bytes);
+    if (ptr == NULL)
     {
-        blasfeo_pack_dvec(dims->nx[stage], double_values, 1, &out->ux[stage], dims->nu[stage]);
+        printf("\nerror: ocp_nlp_out_create_in_arena: arena capacity exceeded.\n");
+        return NULL;
     }
+
+    ocp_nlp_out *nlp_out = ocp_nlp_out_assign(config, dims, ptr);
+    // memory is owned by the arena
+    nlp_out->raw_memory = NULL;
+
+    return nlp_out;
+}
+
+
+
+ocp_nlp_out_field_t ocp_nlp_out_field_from_name(const char *field)
+{
+    if (!strcmp(field, "x"))
+        return OCP_NLP_OUT_X;
     else if (!strcmp(field, "u"))
-    {
-        blasfeo_pack_dvec(dims->nu[stage], double_values, 1, &out->ux[stage], 0);
-    }
+        return OCP_NLP_OUT_U;
+    else if (!strcmp(field, "z"))
+        return OCP_NLP_OUT_Z;
     else if (!strcmp(field, "sl"))
-    {
-        blasfeo_pack_dvec(dims->ns[stage], double_values, 1, &out->ux[stage],
-                            dims->nu[stage] + dims->nx[stage]);
-    }
+        return OCP_NLP_OUT_SL;
     else if (!strcmp(field, "su"))
-    {
-        blasfeo_pack_dvec(dims->ns[stage], double_values, 1, &out->ux[stage],
-                            dims->nu[stage] + dims->nx[stage] + dims->ns[stage]);
-    }
+        return OCP_NLP_OUT_SU;
+    else if (!strcmp(field, "s"))
+        return OCP_NLP_OUT_S;
     else if (!strcmp(field, "pi"))
-    {
-        blasfeo_pack_dvec(dims->nx[stage+1], double_values, 1, &out->pi[stage], 0);
-    }
+        return OCP_NLP_OUT_PI;
     else if (!strcmp(field, "lam"))
+        return OCP_NLP_OUT_LAM;
+    else
+        return INVALID_OCP_NLP_OUT_FIELD;
+}
+
+
+
+// vector, offset and size of a field at one stage
+static struct blasfeo_dvec *ocp_nlp_out_field_vec(ocp_nlp_dims *dims, ocp_nlp_out *out, int stage,
+        ocp_nlp_out_field_t field, int *offset, int *size)
+{
+    switch (field)
+    {
+        case OCP_NLP_OUT_X:
+            *offset = dims->nu[stage];
+            *size = dims->nx[stage];
+            return out->ux + stage;
+        case OCP_NLP_OUT_U:
+            *offset = 0;
+            *size = dims->nu[stage];
+            return out->ux + stage;
+        case OCP_NLP_OUT_Z:
+            *offset = 0;
+            *size = dims->nz[stage];
+            return out->z + stage;
+        case OCP_NLP_OUT_SL:
+            *offset = dims->nu[stage] + dims->nx[stage];
+            *size = dims->ns[stage];
+            return out->ux + stage;
+        case OCP_NLP_OUT_SU:
+            *offset = dims->nu[stage] + dims->nx[stage] + dims->ns[stage];
+            *size = dims->ns[stage];
+            return out->ux + stage;
+        case OCP_NLP_OUT_S:
+            *offset = dims->nu[stage] + dims->nx[stage];
+            *size = 2*dims->ns[stage];
+            return out->ux + stage;
+        case OCP_NLP_OUT_PI:
+            *offset = 0;
+            *size = dims->nx[stage+1];
+            return out->pi + stage;
+        case OCP_NLP_OUT_LAM:
+            *offset = 0;
+            *size = 2*dims->ni[stage];
+            return out->lam + stage;
+        default:
+            printf("\nerror: ocp_nlp_out: invalid field id %d\n", field);
+            exit(1);
+    }
+}
+
+
+
+// number of stages a field is defined on in the bulk getters and setters
+static int ocp_nlp_out_field_num_stages(ocp_nlp_dims *dims, ocp_nlp_out_field_t field)
+{
+    if (field == OCP_NLP_OUT_U || field == OCP_NLP_OUT_Z || field == OCP_NLP_OUT_PI)
+        return dims->N;
+    else
+        return dims->N+1;
+}
+
+
+
+void ocp_nlp_out_set_by_id(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        ocp_nlp_in *in, int stage, ocp_nlp_out_field_t field, const double *value)
+{
+    int offset, size;
+    struct blasfeo_dvec *vec = ocp_nlp_out_field_vec(dims, out, stage, field, &offset, &size);
+
+    blasfeo_pack_dvec(size, (double *) value, 1, vec, offset);
+    if (field == OCP_NLP_OUT_LAM)
     {
-        blasfeo_pack_dvec(2*dims->ni[stage], double_values, 1, &out->lam[stage], 0);
         // multiply with mask to ensure that multiplier associated with masked constraints are zero
-        blasfeo_dvecmul(2*dims->ni[stage], &in->dmask[stage], 0, &out->lam[stage], 0, &out->lam[stage], 0);
+        blasfeo_dvecmul(size, &in->dmask[stage], 0, vec, 0, vec, 0);
     }
-    else if (!strcmp(field, "z"))
+}
+
+
+
+void ocp_nlp_out_get_by_id(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        int stage, ocp_nlp_out_field_t field, double *value)
+{
+    int offset, size;
+    struct blasfeo_dvec *vec = ocp_nlp_out_field_vec(dims, out, stage, field, &offset, &size);
+
+    blasfeo_unpack_dvec(size, vec, offset, value, 1);
+}
+
+
+
+void ocp_nlp_out_set_all_by_id(ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_out *out,
+        ocp_nlp_out_field_t field, const double *value)
+{
+    int offset, size;
+    int tmp_offset = 0;
+    int num_stages = ocp_nlp_out_field_num_stages(dims, field);
+
+    for (int stage = 0; stage < num_stages; stage++)
+    {
+        struct blasfeo_dvec *vec = ocp_nlp_out_field_vec(dims, out, stage, field, &offset, &size);
+        blasfeo_pack_dvec(size, (double *) value + tmp_offset, 1, vec, offset);
+        if (field == OCP_NLP_OUT_LAM)
+        {
+            // multiply with mask to ensure that multiplier associated with masked constraints are zero
+            blasfeo_dvecmul(size, &in->dmask[stage], 0, vec, 0, vec, 0);
+        }
+        tmp_offset += size;
+    }
+}
+
+
+
+void ocp_nlp_out_get_all_by_id(ocp_nlp_dims *dims, ocp_nlp_out *out,
+        ocp_nlp_out_field_t field, double *value)
+{
+    int offset, size;
+    int tmp_offset = 0;
+    int num_stages = ocp_nlp_out_field_num_stages(dims, field);
+
+    for (int stage = 0; stage < num_stages; stage++)
     {
-        blasfeo_pack_dvec(dims->nz[stage], double_values, 1, &out->z[stage], 0);
+        struct blasfeo_dvec *vec = ocp_nlp_out_field_vec(dims, out, stage, field, &offset, &size);
+        blasfeo_unpack_dvec(size, vec, offset, value + tmp_offset, 1);
+        tmp_offset += size;
     }
-    else
+}
+
+
+
+int ocp_nlp_out_alias_size(ocp_nlp_config *config, ocp_nlp_dims *dims)
+{
+    return ocp_nlp_out_packed_size(dims);
+}
+
+
+
+void ocp_nlp_out_alias(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out, double *buffer)
+{
+    ocp_nlp_out_alias_memory(dims, out, buffer);
+}
+
+
+
+void ocp_nlp_out_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out, ocp_nlp_in *in,
+        int stage, const char *field, void *value)
+{
+    ocp_nlp_out_field_t field_id = ocp_nlp_out_field_from_name(field);
+    if (field_id == INVALID_OCP_NLP_OUT_FIELD || field_id == OCP_NLP_OUT_S)
     {
         printf("\nerror: ocp_nlp_out_set: field %s not available\n", field);
         exit(1);
     }
+    ocp_nlp_out_set_by_id(config, dims, out, in, stage, field_id, value);
 }
 
 
@@ -694,42 +957,10 @@ void ocp_nlp_out_set_values_to_zero(ocp_nlp_config *config, ocp_nlp_dims *dims,
 void ocp_nlp_out_get(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
         int stage, const char *field, void *value)
 {
-    if (!strcmp(field, "x"))
+    ocp_nlp_out_field_t field_id = ocp_nlp_out_field_from_name(field);
+    if (field_id != INVALID_OCP_NLP_OUT_FIELD && field_id != OCP_NLP_OUT_S)
     {
-        double *double_values = value;
-        blasfeo_unpack_dvec(dims->nx[stage], &out->ux[stage], dims->nu[stage], double_values, 1);
-    }
-    else if (!strcmp(field, "u"))
-    {
-        double *double_values = value;
-        blasfeo_unpack_dvec(dims->nu[stage], &out->ux[stage], 0, double_values, 1);
-    }
-    else if (!strcmp(field, "sl"))
-    {
-        double *double_values = value;
-        blasfeo_unpack_dvec(dims->ns[stage], &out->ux[stage],
-             dims->nu[stage] + dims->nx[stage], double_values, 1);
-    }
-    else if (!strcmp(field, "su"))
-    {
-        double *double_values = value;
-        blasfeo_unpack_dvec(dims->ns[stage], &out->ux[stage],
-             dims->nu[stage] + dims->nx[stage] + dims->ns[stage], double_values, 1);
-    }
-    else if (!strcmp(field, "z"))
-    {
-        double *double_values = value;
-        blasfeo_unpack_dvec(dims->nz[stage], &out->z[stage], 0, double_values, 1);
-    }
-    else if (!strcmp(field, "pi"))
-    {
-        double *double_values = value;
-        blasfeo_unpack_dvec(dims->nx[stage+1], &out->pi[stage], 0, double_values, 1);
-    }
-    else if (!strcmp(field, "lam"))
-    {
-        double *double_values = value;
-        blasfeo_unpack_dvec(2*dims->ni[stage], &out->lam[stage], 0, double_values, 1);
+        ocp_nlp_out_get_by_id(config, dims, out, stage, field_id, value);
     }
     else if ((!strcmp(field, "kkt_norm_inf")) || (!strcmp(field, "kkt_norm")))
     {
@@ -1366,6 +1597,43 @@ void ocp_nlp_solver_destroy(ocp_nlp_solver *solver)
 }
 
 
+
+acados_size_t ocp_nlp_solver_arena_size(ocp_nlp_config *config, ocp_nlp_dims *dims, void *opts_, ocp_nlp_in *nlp_in)
+{
+    config->opts_update(config, dims, opts_);
+
+    return acados_arena_block_size(ocp_nlp_calculate_size(config, dims, opts_, nlp_in));
+}
+
+
+
+ocp_nlp_solver *ocp_nlp_solver_create_in_arena(ocp_nlp_config *config, ocp_nlp_dims *dims, void *opts_,
+                                               ocp_nlp_in *nlp_in, acados_arena *arena)
+{
+    config->opts_update(config, dims, opts_);
+
+    acados_size_t bytes = ocp_nlp_calculate_size(config, dims, opts_, nlp_in);
+
+    void *ptr = acados_arena_alloc(arena, bytes);
+    if (ptr == NULL)
+    {
+        printf("\nerror: ocp_nlp_solver_create_in_arena: arena capacity exceeded.\n");
+        return NULL;
+    }
+
+    ocp_nlp_solver *solver = ocp_nlp_assign(config, dims, opts_, nlp_in, ptr);
+
+    return solver;
+}
+
+
+
+void ocp_nlp_solver_terminate(ocp_nlp_solver *solver)
+{
+    solver->config->terminate(solver->config, solver->mem, solver->work);
+}
+
+
 void ocp_nlp_solver_reset_qp_memory(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out)
 {
     solver->config->memory_reset_qp_solver(solver->config, solver->dims, nlp_in, nlp_out,
@@ -1373,6 +1641,31 @@ void ocp_nlp_solver_reset_qp_memory(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in,
 }
 
 
+void ocp_nlp_shift(ocp_nlp_solver *solver, ocp_nlp_out *nlp_out, ocp_shift_tail_policy tail_policy)
+{
+    ocp_nlp_config *config = solver->config;
+    ocp_nlp_memory *nlp_mem;
+    ocp_nlp_opts *nlp_opts;
+
+    config->get(config, solver->dims, solver->mem, "nlp_mem", &nlp_mem);
+    config->opts_get(config, solver->dims, solver->opts, "nlp_opts", &nlp_opts);
+
+    ocp_nlp_out_shift(config, solver->dims, nlp_mem, nlp_out, tail_policy);
+
+    // QP solution used for warm starting the QP solver
+    ocp_qp_out_shift(nlp_mem->qp_in, nlp_mem->qp_out, tail_policy);
+    // the scaled QP solution shares some vectors with the unscaled one, which must not be shifted twice
+    if (nlp_mem->scaled_qp_out != nlp_mem->qp_out)
+        ocp_qp_out_shift_unaliased(nlp_mem->scaled_qp_in, nlp_mem->scaled_qp_out, nlp_mem->qp_out, tail_policy);
+
+    // the solution of the condensed QP can not be shifted stage-wise, it is condensed from the shifted one
+    bool tmp_bool = true;
+    config->qp_solver->opts_set(config->qp_solver, nlp_opts->qp_solver_opts,
+                                "initialize_next_xcond_qp_from_qp_out", &tmp_bool);
+}
+
+
+
 int ocp_nlp_solve(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out)
 {
     return solver->config->evaluate(solver->config, solver->dims, nlp_in, nlp_out,
@@ -1380,6 +1673,36 @@ int ocp_nlp_solve(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_o
 }
 
 
+void ocp_nlp_batch_solve(ocp_nlp_solver **solvers, ocp_nlp_in **nlp_in, ocp_nlp_out **nlp_out,
+                         int n_batch, int num_threads, int *status, double *time_tot)
+{
+    if (num_threads < 1)
+    {
+        printf("\nerror: ocp_nlp_batch_solve: num_threads has to be positive, got %d\n", num_threads);
+        exit(1);
+    }
+
+    // instances are handed out one at a time, such that threads which finish early
+    // take over the remaining instances instead of idling at the end of a static split
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+#endif
+    for (int i = 0; i < n_batch; i++)
+    {
+        acados_timer timer;
+        acados_tic(&timer);
+
+        int status_i = ocp_nlp_solve(solvers[i], nlp_in[i], nlp_out[i]);
+
+        if (status != NULL)
+            status[i] = status_i;
+        if (time_tot != NULL)
+            time_tot[i] = acados_toc(&timer);
+    }
+}
+
+
+
 int ocp_nlp_setup_qp_matrices_and_factorize(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out)
 {
     return solver->config->setup_qp_matrices_and_factorize(solver->config, solver->dims, nlp_in, nlp_out,
@@ -1639,7 +1962,8 @@ void ocp_nlp_get_at_stage(ocp_nlp_solver *solver, int stage, const char *field,
         }
         xcond_solver_config->solver_get(xcond_solver_config, nlp_mem->qp_in, nlp_mem->qp_out, nlp_opts->qp_solver_opts, nlp_mem->qp_solver_mem, field, stage, value, size1, size2);
     }
-    else if (!strcmp(field, "ineq_fun") || !strcmp(field, "res_stat") || !strcmp(field, "res_eq"))
+    else if (!strcmp(field, "ineq_fun") || !strcmp(field, "res_stat") || !strcmp(field, "res_eq") ||
+             !strcmp(field, "time_lin_stage"))
     {
         ocp_nlp_memory_get_at_stage(config, dims, nlp_mem, stage, field, value);
     }
@@ -1797,79 +2121,11 @@ void ocp_nlp_get_all(ocp_nlp_solver *solver, ocp_nlp_in *in, ocp_nlp_out *out, c
     int N = dims->N;
     int tmp_int, stage;
 
-    if (!strcmp(field, "x"))
-    {
-        for (stage = 0; stage < N+1; stage++)
-        {
-            tmp_int = dims->nx[stage];
-            blasfeo_unpack_dvec(tmp_int, &out->ux[stage], dims->nu[stage], (double_values + tmp_offset), 1);
-            tmp_offset += tmp_int;
-        }
-    }
-    else if (!strcmp(field, "u"))
-    {
-        for (stage = 0; stage < N; stage++)
-        {
-            tmp_int = dims->nu[stage];
-            blasfeo_unpack_dvec(tmp_int, &out->ux[stage], 0, (double_values + tmp_offset), 1);
-            tmp_offset += tmp_int;
-        }
-    }
-    else if (!strcmp(field, "sl"))
-    {
-        for (stage = 0; stage < N+1; stage++)
-        {
-            tmp_int = dims->ns[stage];
-            blasfeo_unpack_dvec(tmp_int, &out->ux[stage], dims->nu[stage] + dims->nx[stage], (double_values + tmp_offset), 1);
-            tmp_offset += tmp_int;
-        }
-    }
-    else if (!strcmp(field, "su"))
-    {
-        for (stage = 0; stage < N+1; stage++)
-        {
-            tmp_int = dims->ns[stage];
-            blasfeo_unpack_dvec(tmp_int, &out->ux[stage], dims->nu[stage] + dims->nx[stage] + dims->ns[stage],
-                                (double_values + tmp_offset), 1);
-            tmp_offset += tmp_int;
-        }
-    }
-    else if (!strcmp(field, "s"))
-    {
-        for (stage = 0; stage < N+1; stage++)
-        {
-            tmp_int = 2*dims->ns[stage];
-            blasfeo_unpack_dvec(tmp_int, &out->ux[stage], dims->nu[stage] + dims->nx[stage],
-                                (double_values + tmp_offset), 1);
-            tmp_offset += tmp_int;
-        }
-    }
-    else if (!strcmp(field, "z"))
-    {
-        for (stage = 0; stage < N; stage++)
-        {
-            tmp_int = dims->nz[stage];
-            blasfeo_unpack_dvec(tmp_int, &out->z[stage], 0, (double_values + tmp_offset), 1);
-            tmp_offset += tmp_int;
-        }
-    }
-    else if (!strcmp(field, "pi"))
-    {
-        for (stage = 0; stage < N; stage++)
-        {
-            tmp_int = dims->nx[stage+1];
-            blasfeo_unpack_dvec(tmp_int, &out->pi[stage], 0, (double_values + tmp_offset), 1);
-            tmp_offset += tmp_int;
-        }
-    }
-    else if (!strcmp(field, "lam"))
+    ocp_nlp_out_field_t field_id = ocp_nlp_out_field_from_name(field);
+
+    if (field_id != INVALID_OCP_NLP_OUT_FIELD)
     {
-        for (stage = 0; stage < N+1; stage++)
-        {
-            tmp_int = 2*dims->ni[stage];
-            blasfeo_unpack_dvec(tmp_int, &out->lam[stage], 0, (double_values + tmp_offset), 1);
-            tmp_offset += tmp_int;
-        }
+        ocp_nlp_out_get_all_by_id(dims, out, field_id, double_values);
     }
     else if (!strcmp(field, "p"))
     {
@@ -1901,79 +2157,11 @@ void ocp_nlp_set_all(ocp_nlp_solver *solver, ocp_nlp_in *in, ocp_nlp_out *out, c
     int N = dims->N;
     int tmp_int, stage;
 
-    if (!strcmp(field, "x"))
-    {
-        for (stage = 0; stage < N+1; stage++)
-        {
-            tmp_int = dims->nx[stage];
-            blasfeo_pack_dvec(tmp_int, double_values + tmp_offset, 1, &out->ux[stage], dims->nu[stage]);
-            tmp_offset += tmp_int;
-        }
-    }
-    else if (!strcmp(field, "u"))
-    {
-        for (stage = 0; stage < N; stage++)
-        {
-            tmp_int = dims->nu[stage];
-            blasfeo_pack_dvec(tmp_int, double_values + tmp_offset, 1, &out->ux[stage], 0);
-            tmp_offset += tmp_int;
-        }
-    }
-    else if (!strcmp(field, "sl"))
-    {
-        for (stage = 0; stage < N+1; stage++)
-        {
-            tmp_int = dims->ns[stage];
-            blasfeo_pack_dvec(tmp_int, double_values + tmp_offset, 1, &out->ux[stage], dims->nx[stage] + dims->nu[stage]);
-            tmp_offset += tmp_int;
-        }
-    }
-    else if (!strcmp(field, "su"))
-    {
-        for (stage = 0; stage < N+1; stage++)
-        {
-            tmp_int = dims->ns[stage];
-            blasfeo_pack_dvec(tmp_int, double_values + tmp_offset, 1, &out->ux[stage], dims->nx[stage] + dims->nu[stage] + dims->ns[stage]);
-            tmp_offset += tmp_int;
-        }
-    }
-    else if (!strcmp(field, "s"))
-    {
-        for (stage = 0; stage < N+1; stage++)
-        {
-            tmp_int = 2*dims->ns[stage];
-            blasfeo_pack_dvec(tmp_int, double_values + tmp_offset, 1, &out->ux[stage], dims->nx[stage] + dims->nu[stage]);
-            tmp_offset += tmp_int;
-        }
-    }
-    else if (!strcmp(field, "z"))
-    {
-        for (stage = 0; stage < N; stage++)
-        {
-            tmp_int = dims->nz[stage];
-            blasfeo_pack_dvec(tmp_int, double_values + tmp_offset, 1, &out->z[stage], 0);
-            tmp_offset += tmp_int;
-        }
-    }
-    else if (!strcmp(field, "pi"))
-    {
-        for (stage = 0; stage < N; stage++)
-        {
-            tmp_int = dims->nx[stage+1];
-            blasfeo_pack_dvec(tmp_int, double_values + tmp_offset, 1, &out->pi[stage], 0);
-            tmp_offset += tmp_int;
-        }
-    }
-    else if (!strcmp(field, "lam"))
+    ocp_nlp_out_field_t field_id = ocp_nlp_out_field_from_name(field);
+
+    if (field_id != INVALID_OCP_NLP_OUT_FIELD)
     {
-        for (stage = 0; stage < N+1; stage++)
-        {
-            tmp_int = 2*dims->ni[stage];
-            blasfeo_pack_dvec(tmp_int, double_values + tmp_offset, 1, &out->lam[stage], 0);
-            // multiply with mask to ensure that multiplier associated with masked constraints are zero
-            blasfeo_dvecmul(2*dims->ni[stage], &in->dmask[stage], 0, &out->lam[stage], 0, &out->lam[stage], 0);
-            tmp_offset += tmp_int;
-        }
+        ocp_nlp_out_set_all_by_id(dims, in, out, field_id, double_values);
     }
     else if (!strcmp(field, "p"))
     {
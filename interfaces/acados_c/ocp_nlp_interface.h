@@ -43,6 +43,7 @@ extern "C" {
 #include "acados/sim/sim_irk_integrator.h"
 #include "acados/sim/sim_lifted_irk_integrator.h"
 #include "acados/sim/sim_gnsf.h"
+#include "acados/utils/mem.h"
 #include "acados/utils/types.h"
 // acados_c
 #include "acados_c/ocp_qp_interface.h"
@@ -105,6 +106,40 @@ typedef enum
     FUNNEL_L1PEN_LINESEARCH
 } ocp_nlp_globalization_t;
 
+
+/// Fields of the output struct, to be resolved once with ocp_nlp_out_field_from_name
+/// and used with the *_by_id getters and setters.
+typedef enum
+{
+    OCP_NLP_OUT_X,
+    OCP_NLP_OUT_U,
+    OCP_NLP_OUT_Z,
+    OCP_NLP_OUT_SL,
+    OCP_NLP_OUT_SU,
+    OCP_NLP_OUT_S,
+    OCP_NLP_OUT_PI,
+    OCP_NLP_OUT_LAM,
+    INVALID_OCP_NLP_OUT_FIELD,
+} ocp_nlp_out_field_t;
+
+
+/// Module a field handle refers to.
+typedef enum
+{
+    OCP_NLP_CONSTRAINTS_FIELD,
+    OCP_NLP_COST_FIELD,
+} ocp_nlp_field_module_t;
+
+
+/// Handle to a model field of one stage, resolved once with ocp_nlp_constraints_field_lookup
+/// or ocp_nlp_cost_field_lookup and set with ocp_nlp_field_handle_set without string compares.
+typedef struct
+{
+    ocp_nlp_field_module_t module;
+    int stage;
+    int field_id;  // module specific id
+} ocp_nlp_field_handle;
+
 /// Structure to store the configuration of a non-linear program
 typedef struct ocp_nlp_plan_t
 {
@@ -197,6 +232,21 @@ ACADOS_SYMBOL_EXPORT ocp_nlp_in *ocp_nlp_in_create(ocp_nlp_config *config, ocp_n
 /// \param in The inputs struct.
 ACADOS_SYMBOL_EXPORT void ocp_nlp_in_destroy(void *in);
 
+/// Returns the arena capacity needed by ocp_nlp_in_create_in_arena.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+ACADOS_SYMBOL_EXPORT acados_size_t ocp_nlp_in_arena_size(ocp_nlp_config *config, ocp_nlp_dims *dims);
+
+/// Constructs an input struct in memory taken from an arena.
+/// The struct is released with the arena, ocp_nlp_in_destroy must not be called.
+/// Returns NULL if the arena has not enough capacity left.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param arena The arena.
+ACADOS_SYMBOL_EXPORT ocp_nlp_in *ocp_nlp_in_create_in_arena(ocp_nlp_config *config, ocp_nlp_dims *dims, acados_arena *arena);
+
 
 /// Sets the sampling times for the given stage.
 ///
@@ -268,6 +318,39 @@ ACADOS_SYMBOL_EXPORT int ocp_nlp_cost_model_get(ocp_nlp_config *config, ocp_nlp_
 ACADOS_SYMBOL_EXPORT int ocp_nlp_constraints_model_set(ocp_nlp_config *config, ocp_nlp_dims *dims,
         ocp_nlp_in *in, ocp_nlp_out *out, int stage, const char *field, void *value);
 
+/// Resolves a constraints model field of the given stage to a handle.
+/// Only available for modules with precompiled setters (BGH), and for their
+/// numeric fields, i.e. bounds and matrices; exits with an error otherwise.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param stage Stage number.
+/// \param field The name of the field, e.g. lbx, ubx, lg, ug, C, D.
+ACADOS_SYMBOL_EXPORT ocp_nlp_field_handle ocp_nlp_constraints_field_lookup(ocp_nlp_config *config,
+        ocp_nlp_dims *dims, int stage, const char *field);
+
+/// Resolves a cost model field of the given stage to a handle.
+/// Only available for modules with precompiled setters (LINEAR_LS); exits with an error otherwise.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param stage Stage number.
+/// \param field The name of the field, e.g. y_ref, W.
+ACADOS_SYMBOL_EXPORT ocp_nlp_field_handle ocp_nlp_cost_field_lookup(ocp_nlp_config *config,
+        ocp_nlp_dims *dims, int stage, const char *field);
+
+/// Sets a model field through a handle, equivalent to ocp_nlp_constraints_model_set or
+/// ocp_nlp_cost_model_set with the field name the handle was resolved from.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param in The inputs struct.
+/// \param out The output struct, multipliers of masked constraints are set to zero.
+/// \param handle The field handle.
+/// \param value Values of the field.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_field_handle_set(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_field_handle handle, void *value);
+
 ///
 ACADOS_SYMBOL_EXPORT void ocp_nlp_constraints_model_get(ocp_nlp_config *config, ocp_nlp_dims *dims,
         ocp_nlp_in *in, int stage, const char *field, void *value);
@@ -285,6 +368,21 @@ ACADOS_SYMBOL_EXPORT ocp_nlp_out *ocp_nlp_out_create(ocp_nlp_config *config, ocp
 /// \param out The output struct.
 ACADOS_SYMBOL_EXPORT void ocp_nlp_out_destroy(void *out);
 
+/// Returns the arena capacity needed by ocp_nlp_out_create_in_arena.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+ACADOS_SYMBOL_EXPORT acados_size_t ocp_nlp_out_arena_size(ocp_nlp_config *config, ocp_nlp_dims *dims);
+
+/// Constructs an output struct in memory taken from an arena.
+/// The struct is released with the arena, ocp_nlp_out_destroy must not be called.
+/// Returns NULL if the arena has not enough capacity left.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param arena The arena.
+ACADOS_SYMBOL_EXPORT ocp_nlp_out *ocp_nlp_out_create_in_arena(ocp_nlp_config *config, ocp_nlp_dims *dims, acados_arena *arena);
+
 
 /// Sets fields in the output struct of an nlp solver, used to initialize the solver.
 ///
@@ -324,6 +422,54 @@ ACADOS_SYMBOL_EXPORT void ocp_nlp_get_all(ocp_nlp_solver *solver, ocp_nlp_in *in
 ACADOS_SYMBOL_EXPORT void ocp_nlp_set_all(ocp_nlp_solver *solver, ocp_nlp_in *in, ocp_nlp_out *out, const char *field, void *value);
 
 
+/// Resolves the name of a field of the output struct, returns INVALID_OCP_NLP_OUT_FIELD if not available.
+///
+/// \param field The name of the field, either x, u, z, sl, su, s, pi, lam.
+ACADOS_SYMBOL_EXPORT ocp_nlp_out_field_t ocp_nlp_out_field_from_name(const char *field);
+
+/// Sets the values of a field of the output struct at one stage, without string comparison.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param out The output struct.
+/// \param in The inputs struct, used for the constraint mask of lam.
+/// \param stage Stage number.
+/// \param field Field id obtained from ocp_nlp_out_field_from_name.
+/// \param value Pointer to the values.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_out_set_by_id(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        ocp_nlp_in *in, int stage, ocp_nlp_out_field_t field, const double *value);
+
+/// Gets the values of a field of the output struct at one stage, without string comparison.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_out_get_by_id(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        int stage, ocp_nlp_out_field_t field, double *value);
+
+/// Sets a field over the whole horizon from a contiguous buffer, stages stored one after another
+/// as in ocp_nlp_set_all; the buffer size is given by ocp_nlp_dims_get_total_from_attr.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_out_set_all_by_id(ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_out *out,
+        ocp_nlp_out_field_t field, const double *value);
+
+/// Gets a field over the whole horizon into a contiguous buffer, stages stored one after another.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_out_get_all_by_id(ocp_nlp_dims *dims, ocp_nlp_out *out,
+        ocp_nlp_out_field_t field, double *value);
+
+/// Returns the number of doubles of a buffer the output struct can be aliased to, see ocp_nlp_out_alias.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_out_alias_size(ocp_nlp_config *config, ocp_nlp_dims *dims);
+
+/// Lets the output struct operate directly on a user buffer, such that the solution is read and
+/// warm started without copies. The layout is [ux_0 ... ux_N, z_0 ... z_N, pi_0 ... pi_{N-1}, lam_0 ... lam_N]
+/// with ux_i = [u_i; x_i; sl_i; su_i], without padding. The vectors are therefore not aligned like
+/// blasfeo memory, the buffer only has to be aligned to sizeof(double), which is checked; a 64-byte
+/// aligned buffer keeps ux_0 on a cache line boundary. The buffer has to stay valid while aliased and
+/// its current values are used as is. Passing NULL switches back to the internal memory of the output
+/// struct, which still holds the values from before the aliasing.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param out The output struct.
+/// \param buffer Buffer of ocp_nlp_out_alias_size doubles, or NULL.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_out_alias(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out, double *buffer);
+
+
 // TODO(andrea): remove this once/if the MATLAB interface uses the new setters below?
 ACADOS_SYMBOL_EXPORT int ocp_nlp_dims_get_from_attr(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
         int stage, const char *field);
@@ -382,6 +528,35 @@ ACADOS_SYMBOL_EXPORT ocp_nlp_solver *ocp_nlp_solver_create(ocp_nlp_config *confi
 /// \param solver The solver struct.
 ACADOS_SYMBOL_EXPORT void ocp_nlp_solver_destroy(ocp_nlp_solver *solver);
 
+/// Returns the arena capacity needed by ocp_nlp_solver_create_in_arena.
+/// Updates the options as ocp_nlp_solver_create.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param opts_ The options struct.
+/// \param nlp_in The inputs struct, with all model functions set.
+ACADOS_SYMBOL_EXPORT acados_size_t ocp_nlp_solver_arena_size(ocp_nlp_config *config, ocp_nlp_dims *dims, void *opts_, ocp_nlp_in *nlp_in);
+
+/// Creates an ocp solver in memory taken from an arena.
+/// Several solvers can share config, dims and opts, such that a batch of solvers is created with a single allocation.
+/// Nothing else is shared: each solver gets its own memory and workspace, including the per-stage parts.
+/// Returns NULL if the arena has not enough capacity left.
+/// Release the solver with ocp_nlp_solver_terminate before resetting or destroying the arena.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param opts_ The options struct.
+/// \param nlp_in The inputs struct.
+/// \param arena The arena.
+/// \return The solver, or NULL.
+ACADOS_SYMBOL_EXPORT ocp_nlp_solver *ocp_nlp_solver_create_in_arena(ocp_nlp_config *config, ocp_nlp_dims *dims, void *opts_,
+                                                                    ocp_nlp_in *nlp_in, acados_arena *arena);
+
+/// Releases resources held by the submodules of a solver created with ocp_nlp_solver_create_in_arena.
+///
+/// \param solver The solver struct.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_solver_terminate(ocp_nlp_solver *solver);
+
 /// Solves the optimal control problem. Call ocp_nlp_precompute before
 /// calling this function.
 ///
@@ -390,6 +565,25 @@ ACADOS_SYMBOL_EXPORT void ocp_nlp_solver_destroy(ocp_nlp_solver *solver);
 /// \param nlp_out The output struct.
 ACADOS_SYMBOL_EXPORT int ocp_nlp_solve(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out);
 
+/// Solves a batch of independent optimal control problems in parallel.
+/// Instances are distributed dynamically over the threads, such that solves with
+/// different iteration counts do not leave threads idle. Without OpenMP, the
+/// instances are solved sequentially.
+/// The parallel regions inside each solve (solver option num_threads) are nested in the
+/// batch loop. With the default OpenMP settings nested regions run on a single thread, i.e.
+/// each instance is solved by one thread; set num_threads of the solvers to 1 to not rely
+/// on this, the total number of threads is then bounded by num_threads of the batch.
+///
+/// \param solvers Array of n_batch solver structs, precomputed.
+/// \param nlp_in Array of n_batch inputs structs.
+/// \param nlp_out Array of n_batch output structs.
+/// \param n_batch Number of instances.
+/// \param num_threads Number of threads used for the batch.
+/// \param status Array of n_batch returned solver statuses, or NULL.
+/// \param time_tot Array of n_batch wall times in seconds per instance, or NULL.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_batch_solve(ocp_nlp_solver **solvers, ocp_nlp_in **nlp_in, ocp_nlp_out **nlp_out,
+                                              int n_batch, int num_threads, int *status, double *time_tot);
+
 //
 ACADOS_SYMBOL_EXPORT int ocp_nlp_setup_qp_matrices_and_factorize(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out);
 
@@ -403,6 +597,18 @@ ACADOS_SYMBOL_EXPORT int ocp_nlp_setup_qp_matrices_and_factorize(ocp_nlp_solver
 ACADOS_SYMBOL_EXPORT void ocp_nlp_solver_reset_qp_memory(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out);
 
 
+/// Shifts the iterate and the QP solver warm start by one stage, e.g. between two RTI calls.
+/// Stage i takes the states, controls, slacks and multipliers of stage i+1, where the dimensions agree.
+/// The multipliers of the inequalities are only taken if the bounds (including idxb) and constraints agree,
+/// otherwise the tail policy is applied to them.
+/// The condensed QP solution is initialized from the shifted QP solution in the next call.
+///
+/// \param solver The solver struct.
+/// \param nlp_out The output struct.
+/// \param tail_policy Values of the last stage, SHIFT_TAIL_KEEP or SHIFT_TAIL_ZERO.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_shift(ocp_nlp_solver *solver, ocp_nlp_out *nlp_out, ocp_shift_tail_policy tail_policy);
+
+
 /// Performs precomputations for the solver. Needs to be called before
 /// ocp_nlp_solve (TBC).
 ///
@@ -33,11 +33,14 @@
 
 // external
 #include <assert.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 // acados_c
 
+#include "acados/utils/math.h"
 #include "acados/utils/mem.h"
+#include "acados/utils/timing.h"
 
 #include "acados/dense_qp/dense_qp_hpipm.h"
 #include "acados/ocp_qp/ocp_qp_xcond_solver.h"
@@ -57,6 +60,8 @@
 #endif
 
 #include "acados/ocp_qp/ocp_qp_hpipm.h"
+#include "acados/ocp_qp/ocp_qp_parallel_riccati.h"
+#include "acados/ocp_qp/ocp_qp_pdhg.h"
 #ifdef ACADOS_WITH_HPMPC
 #include "acados/ocp_qp/ocp_qp_hpmpc.h"
 #endif
@@ -115,6 +120,16 @@ void ocp_qp_xcond_solver_config_initialize_from_plan(
             ocp_qp_partial_condensing_config_initialize_default(solver_config->xcond);
             break;
 #endif
+        case PARTIAL_CONDENSING_PDHG:
+            ocp_qp_xcond_solver_config_initialize_default(solver_config);
+            ocp_qp_pdhg_config_initialize_default(solver_config->qp_solver);
+            ocp_qp_partial_condensing_config_initialize_default(solver_config->xcond);
+            break;
+        case PARTIAL_CONDENSING_PARALLEL_RICCATI:
+            ocp_qp_xcond_solver_config_initialize_default(solver_config);
+            ocp_qp_parallel_riccati_config_initialize_default(solver_config->qp_solver);
+            ocp_qp_partial_condensing_config_initialize_default(solver_config->xcond);
+            break;
         case FULL_CONDENSING_HPIPM:
             ocp_qp_xcond_solver_config_initialize_default(solver_config);
             dense_qp_hpipm_config_initialize_default(solver_config->qp_solver);
@@ -425,6 +440,167 @@ void ocp_qp_solver_destroy(ocp_qp_solver *solver)
 }
 
 
+
+/* condensing horizon tuning */
+
+// signature of the stage dimensions, used as key in the cond_N cache file
+static unsigned int ocp_qp_dims_signature(ocp_qp_dims *dims)
+{
+    // FNV-1a
+    unsigned int hash = 2166136261u;
+    for (int ii = 0; ii <= dims->N; ii++)
+    {
+        int stage_dims[6] = {dims->nx[ii], dims->nu[ii], dims->nbx[ii], dims->nbu[ii], dims->ng[ii], dims->ns[ii]};
+        for (int jj = 0; jj < 6; jj++)
+        {
+            hash ^= (unsigned int) stage_dims[jj];
+            hash *= 16777619u;
+        }
+    }
+    return hash;
+}
+
+
+
+int ocp_qp_xcond_solver_load_cond_N(const char *cache_file, ocp_qp_dims *dims)
+{
+    FILE *file = fopen(cache_file, "r");
+    if (file == NULL)
+        return -1;
+
+    unsigned int signature = ocp_qp_dims_signature(dims);
+    unsigned int entry_signature;
+    int entry_N, entry_cond_N;
+    int cond_N = -1;
+
+    // the last matching entry wins
+    while (fscanf(file, "%d %u %d", &entry_N, &entry_signature, &entry_cond_N) == 3)
+    {
+        if (entry_N == dims->N && entry_signature == signature &&
+            entry_cond_N >= 1 && entry_cond_N <= dims->N)
+        {
+            cond_N = entry_cond_N;
+        }
+    }
+
+    fclose(file);
+
+    return cond_N;
+}
+
+
+
+void ocp_qp_xcond_solver_save_cond_N(const char *cache_file, ocp_qp_dims *dims, int cond_N)
+{
+    FILE *file = fopen(cache_file, "a");
+    if (file == NULL)
+    {
+        printf("\nwarning: ocp_qp_xcond_solver_save_cond_N: could not open %s\n", cache_file);
+        return;
+    }
+
+    fprintf(file, "%d %u %d\n", dims->N, ocp_qp_dims_signature(dims), cond_N);
+
+    fclose(file);
+}
+
+
+
+int ocp_qp_xcond_solver_tune_cond_N(ocp_qp_xcond_solver_config *config, ocp_qp_xcond_solver_dims *dims,
+                                    void *opts_, ocp_qp_in *qp_in, int num_candidates, int *candidates,
+                                    int num_solves, const char *cache_file)
+{
+    if (config->xcond->condensing != &ocp_qp_partial_condensing)
+    {
+        printf("\nerror: ocp_qp_xcond_solver_tune_cond_N: only available with partial condensing\n");
+        exit(1);
+    }
+
+    int N = dims->orig_dims->N;
+
+    if (cache_file != NULL)
+    {
+        int cond_N = ocp_qp_xcond_solver_load_cond_N(cache_file, dims->orig_dims);
+        if (cond_N > 0)
+        {
+            config->opts_set(config, opts_, "cond_N", &cond_N);
+            return cond_N;
+        }
+    }
+
+    // default candidates: N, N/2, N/4, ..., 1
+    int num_default = 0;
+    int default_candidates[32];
+    if (num_candidates <= 0 || candidates == NULL)
+    {
+        for (int cond_N = N; num_default < 32; cond_N /= 2)
+        {
+            default_candidates[num_default++] = cond_N > 0 ? cond_N : 1;
+            if (cond_N <= 1)
+                break;
+        }
+        num_candidates = num_default;
+        candidates = default_candidates;
+    }
+    if (num_solves < 1)
+        num_solves = 1;
+
+    ocp_qp_out *qp_out = ocp_qp_out_create(dims->orig_dims);
+    acados_timer timer;
+
+    int best_cond_N = -1;
+    double best_time = 0.0;
+
+    for (int ii = 0; ii < num_candidates; ii++)
+    {
+        int cond_N = candidates[ii];
+        if (cond_N < 1 || cond_N > N)
+        {
+            printf("\nwarning: ocp_qp_xcond_solver_tune_cond_N: skipping cond_N = %d, not in [1, %d]\n", cond_N, N);
+            continue;
+        }
+
+        config->opts_set(config, opts_, "cond_N", &cond_N);
+        ocp_qp_solver *solver = ocp_qp_create(config, dims, opts_);
+
+        // fastest of num_solves solves, candidates failing on qp_in are discarded
+        double time = 0.0;
+        int status = ACADOS_SUCCESS;
+        for (int jj = 0; jj < num_solves && status == ACADOS_SUCCESS; jj++)
+        {
+            acados_tic(&timer);
+            status = ocp_qp_solve(solver, qp_in, qp_out);
+            double time_solve = acados_toc(&timer);
+            time = jj == 0 ? time_solve : MIN(time, time_solve);
+        }
+
+        ocp_qp_solver_destroy(solver);
+
+        if (status == ACADOS_SUCCESS && (best_cond_N < 0 || time < best_time))
+        {
+            best_cond_N = cond_N;
+            best_time = time;
+        }
+    }
+
+    ocp_qp_out_free(qp_out);
+
+    if (best_cond_N < 0)
+    {
+        printf("\nwarning: ocp_qp_xcond_solver_tune_cond_N: no candidate solved the QP, using cond_N = %d\n", N);
+        best_cond_N = N;
+    }
+    else if (cache_file != NULL)
+    {
+        ocp_qp_xcond_solver_save_cond_N(cache_file, dims->orig_dims, best_cond_N);
+    }
+
+    config->opts_set(config, opts_, "cond_N", &best_cond_N);
+
+    return best_cond_N;
+}
+
+
 // qp residual
 static ocp_qp_res *ocp_qp_res_create(ocp_qp_dims *dims)
 {
@@ -52,10 +52,13 @@ extern "C" {
 ///   FULL_CONDENSING_QPOASES
 ///   FULL_CONDENSING_QORE
 ///   FULL_CONDENSING_OOQP
+///   PARTIAL_CONDENSING_PDHG
+///   PARTIAL_CONDENSING_PARALLEL_RICCATI
 ///   INVALID_QP_SOLVER
 ///
-/// Note: In this enumeration the partial condensing solvers have to be
-///       specified before the full condensing solvers.
+/// Note: In this enumeration the original partial condensing solvers are
+///       specified before the full condensing solvers. Solvers added later
+///       are appended at the end, such that the values of the existing ones do not change.
 typedef enum {
     PARTIAL_CONDENSING_HPIPM,
 #ifdef ACADOS_WITH_HPMPC
@@ -99,6 +102,8 @@ typedef enum {
 #else
     FULL_CONDENSING_OOQP_NOT_AVAILABLE,
 #endif
+    PARTIAL_CONDENSING_PDHG,
+    PARTIAL_CONDENSING_PARALLEL_RICCATI,
     INVALID_QP_SOLVER,
 } ocp_qp_solver_t;
 
@@ -247,6 +252,33 @@ void ocp_qp_x_cond_solver_free(ocp_qp_xcond_solver_config *config,
 int ocp_qp_solve(ocp_qp_solver *solver, ocp_qp_in *qp_in, ocp_qp_out *qp_out);
 
 
+/// Benchmarks partial condensing horizons on a QP and sets the fastest one as cond_N in the options.
+/// For each candidate a solver is created and qp_in is solved num_solves times; the fastest solve
+/// counts. Candidates which do not solve qp_in successfully are discarded.
+/// The blocks are of uniform size, as computed by the partial condensing module.
+///
+/// \param config The configuration struct, has to use partial condensing.
+/// \param dims The dimension struct.
+/// \param opts_ The options struct, cond_N is set to the chosen value.
+/// \param qp_in A representative QP, e.g. the first QP of a sequence or a recorded one.
+/// \param num_candidates The number of candidates, 0 for the default N, N/2, N/4, ..., 1.
+/// \param candidates The candidate values of cond_N.
+/// \param num_solves The number of solves per candidate.
+/// \param cache_file If not NULL, a cached choice for the dimensions of qp_in is used without
+///        benchmarking; otherwise the choice is appended to the file.
+/// \return The chosen cond_N.
+int ocp_qp_xcond_solver_tune_cond_N(ocp_qp_xcond_solver_config *config, ocp_qp_xcond_solver_dims *dims,
+                                    void *opts_, ocp_qp_in *qp_in, int num_candidates, int *candidates,
+                                    int num_solves, const char *cache_file);
+
+/// Loads the cond_N cached for the given dimensions from a file written by
+/// ocp_qp_xcond_solver_tune_cond_N, -1 if there is none.
+int ocp_qp_xcond_solver_load_cond_N(const char *cache_file, ocp_qp_dims *dims);
+
+/// Appends the choice of cond_N for the given dimensions to a cache file.
+void ocp_qp_xcond_solver_save_cond_N(const char *cache_file, ocp_qp_dims *dims, int cond_N);
+
+
 /// Calculates the infinity norm of the residuals.
 ///
 /// \param dims The dimension struct.
@@ -938,7 +938,7 @@ classdef AcadosOcp < handle
             end
 
             % sanity checks on options, which are done in setters in Python
-            qp_solvers = {'PARTIAL_CONDENSING_HPIPM', 'FULL_CONDENSING_QPOASES', 'FULL_CONDENSING_HPIPM', 'PARTIAL_CONDENSING_QPDUNES', 'PARTIAL_CONDENSING_OSQP', 'FULL_CONDENSING_DAQP'};
+            qp_solvers = {'PARTIAL_CONDENSING_HPIPM', 'FULL_CONDENSING_QPOASES', 'FULL_CONDENSING_HPIPM', 'PARTIAL_CONDENSING_QPDUNES', 'PARTIAL_CONDENSING_OSQP', 'FULL_CONDENSING_DAQP', 'PARTIAL_CONDENSING_PDHG', 'PARTIAL_CONDENSING_PARALLEL_RICCATI'};
             if ~ismember(opts.qp_solver, qp_solvers)
                 error(['Invalid qp_solver: ', opts.qp_solver, '. Available options are: ', strjoin(qp_solvers, ', ')]);
             end
@@ -1200,6 +1200,10 @@ classdef AcadosOcp < handle
                 error('qp_solver_t0_init must be one of [0, 1, 2].');
             end
 
+            if opts.with_batched_dynamics
+                error('with_batched_dynamics is only supported in the Python interface.');
+            end
+
             if opts.tau_min > 0 && isempty(strfind(opts.qp_solver, 'HPIPM'))
                 error('tau_min > 0 is only compatible with HPIPM.');
             end
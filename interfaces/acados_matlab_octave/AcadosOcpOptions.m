@@ -124,6 +124,7 @@ classdef AcadosOcpOptions < handle
         solution_sens_qp_t_lam_min
         as_rti_iter
         as_rti_level
+        with_batched_dynamics
         with_adaptive_levenberg_marquardt
         adaptive_levenberg_marquardt_lam
         adaptive_levenberg_marquardt_mu_min
@@ -251,6 +252,7 @@ classdef AcadosOcpOptions < handle
             obj.solution_sens_qp_t_lam_min = 1e-9;
             obj.as_rti_iter = 1;
             obj.as_rti_level = 4;
+            obj.with_batched_dynamics = 0;
             obj.with_adaptive_levenberg_marquardt = 0;
             obj.adaptive_levenberg_marquardt_lam = 5.0;
             obj.adaptive_levenberg_marquardt_mu_min = 1e-16;
@@ -1151,6 +1151,12 @@ class AcadosOcp:
                 if constraint is not None and any(ca.which_depends(constraint, model.p_global)):
                     raise NotImplementedError(f"with_value_sens_wrt_params is not supported for BGP constraints that depend on p_global. Got dependency on p_global for {horizon_type} constraint.")
 
+        if opts.with_batched_dynamics:
+            if opts.N_horizon == 0 or opts.integrator_type != 'ERK' or model.dyn_ext_fun_type != 'casadi':
+                raise ValueError('with_batched_dynamics is only supported for ERK integrators with CasADi functions.')
+            if dims.np_global > 0:
+                raise NotImplementedError('with_batched_dynamics is not supported with p_global.')
+
         if opts.tau_min > 0 and "HPIPM" not in opts.qp_solver:
             raise ValueError('tau_min > 0 is only compatible with HPIPM.')
 
@@ -1394,6 +1400,7 @@ class AcadosOcp:
                 with_solution_sens_wrt_params = self.solver_options.with_solution_sens_wrt_params,
                 with_value_sens_wrt_params = self.solver_options.with_value_sens_wrt_params,
                 generate_hess = self.solver_options.hessian_approx == 'EXACT',
+                expl_vde_forw_batch_size = self.solver_options.N_horizon if self.solver_options.with_batched_dynamics else 0,
             )
 
             context = GenerateContext(self.model.p_global, self.name, code_gen_opts)
@@ -160,12 +160,14 @@ class AcadosOcpOptions:
         self.__num_threads_in_batch_solve: int = 1
         self.__with_batch_functionality: bool = False
         self.__with_anderson_acceleration: bool = False
+        self.__with_batched_dynamics: bool = False
 
 
     @property
     def qp_solver(self):
         """QP solver to be used in the NLP solver.
-        String in ('PARTIAL_CONDENSING_HPIPM', 'FULL_CONDENSING_QPOASES', 'FULL_CONDENSING_HPIPM', 'PARTIAL_CONDENSING_QPDUNES', 'PARTIAL_CONDENSING_OSQP', 'FULL_CONDENSING_DAQP').
+        String in ('PARTIAL_CONDENSING_HPIPM', 'FULL_CONDENSING_QPOASES', 'FULL_CONDENSING_HPIPM', 'PARTIAL_CONDENSING_QPDUNES', 'PARTIAL_CONDENSING_OSQP', 'FULL_CONDENSING_DAQP', 'PARTIAL_CONDENSING_PDHG',
+        'PARTIAL_CONDENSING_PARALLEL_RICCATI').
         Default: 'PARTIAL_CONDENSING_HPIPM'.
         """
         return self.__qp_solver
@@ -750,6 +752,20 @@ class AcadosOcpOptions:
         """
         return self.__with_anderson_acceleration
 
+    @property
+    def with_batched_dynamics(self):
+        """
+        Determines if the shooting intervals are integrated in lock-step in one sim call.
+        The forward VDE is additionally generated as one CasADi map over the N_horizon intervals.
+        The solver falls back to the stage-wise integration for options the batched ERK does not support,
+        e.g. exact Hessians.
+        Only supported for integrator_type == 'ERK' without p_global.
+
+        Type: bool
+        Default: False
+        """
+        return self.__with_batched_dynamics
+
 
     @property
     def as_rti_level(self):
@@ -1420,7 +1436,8 @@ class AcadosOcpOptions:
         qp_solvers = ('PARTIAL_CONDENSING_HPIPM', \
                 'FULL_CONDENSING_QPOASES', 'FULL_CONDENSING_HPIPM', \
                 'PARTIAL_CONDENSING_QPDUNES', 'PARTIAL_CONDENSING_OSQP', \
-                'FULL_CONDENSING_DAQP')
+                'FULL_CONDENSING_DAQP', 'PARTIAL_CONDENSING_PDHG', \
+                'PARTIAL_CONDENSING_PARALLEL_RICCATI')
         if qp_solver in qp_solvers:
             self.__qp_solver = qp_solver
         else:
@@ -2010,6 +2027,12 @@ class AcadosOcpOptions:
             raise TypeError('Invalid with_anderson_acceleration value, must be bool.')
         self.__with_anderson_acceleration = with_anderson_acceleration
 
+    @with_batched_dynamics.setter
+    def with_batched_dynamics(self, with_batched_dynamics):
+        if not isinstance(with_batched_dynamics, bool):
+            raise TypeError('Invalid with_batched_dynamics value, must be bool.')
+        self.__with_batched_dynamics = with_batched_dynamics
+
     @as_rti_level.setter
     def as_rti_level(self, as_rti_level):
         if as_rti_level in [0, 1, 2, 3, 4]:
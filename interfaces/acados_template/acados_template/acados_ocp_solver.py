@@ -369,6 +369,9 @@ class AcadosOcpSolver:
 
         self.__acados_lib.ocp_nlp_out_set_values_to_zero.argtypes = [c_void_p, c_void_p, c_void_p]
 
+        self.__acados_lib.ocp_nlp_shift.argtypes = [c_void_p, c_void_p, c_int]
+        self.__acados_lib.ocp_nlp_shift.restype = None
+
         getattr(self.shared_lib, f"{self.name}_acados_solve").argtypes = [c_void_p]
         getattr(self.shared_lib, f"{self.name}_acados_solve").restype = c_int
 
@@ -526,6 +529,20 @@ class AcadosOcpSolver:
         getattr(self.shared_lib, f"{self.name}_acados_reset")(self.capsule, reset_qp_solver_mem)
 
 
+    def shift(self, tail_policy: str = 'keep'):
+        """
+        Shifts the current iterate and the QP solver warm start by one stage towards stage 0,
+        e.g. to warm start the next RTI call in closed loop.
+        Blocks whose dimensions differ between consecutive stages, e.g. the multipliers of an initial state constraint, are not shifted.
+
+        :param tail_policy: values of the last stage, either 'keep' (duplicate the last stage) or 'zero'
+        """
+        tail_policies = {'keep': 0, 'zero': 1}
+        if tail_policy not in tail_policies:
+            raise ValueError(f"shift: tail_policy must be one of {list(tail_policies.keys())}, got {tail_policy}.")
+        self.__acados_lib.ocp_nlp_shift(self.nlp_solver, self.nlp_out, tail_policies[tail_policy])
+
+
     def set_new_time_steps(self, new_time_steps):
         """
         Set new time steps.
@@ -583,6 +583,17 @@ void {{ model.name }}_acados_create_setup_functions({{ model.name }}_solver_caps
         for (int i = 0; i < N; i++) {
             MAP_CASADI_FNC(expl_vde_forw[i], {{ model.name }}_expl_vde_forw);
         }
+        {%- if solver_options.with_batched_dynamics %}
+
+        // forward VDE mapped over the shooting intervals, the parameters are passed per interval
+        capsule->expl_vde_forw_batch.casadi_fun = &{{ model.name }}_expl_vde_forw_batch;
+        capsule->expl_vde_forw_batch.casadi_work = &{{ model.name }}_expl_vde_forw_batch_work;
+        capsule->expl_vde_forw_batch.casadi_sparsity_in = &{{ model.name }}_expl_vde_forw_batch_sparsity_in;
+        capsule->expl_vde_forw_batch.casadi_sparsity_out = &{{ model.name }}_expl_vde_forw_batch_sparsity_out;
+        capsule->expl_vde_forw_batch.casadi_n_in = &{{ model.name }}_expl_vde_forw_batch_n_in;
+        capsule->expl_vde_forw_batch.casadi_n_out = &{{ model.name }}_expl_vde_forw_batch_n_out;
+        external_function_casadi_batch_create(&capsule->expl_vde_forw_batch, N, {{ dims.np }}, &ext_fun_opts);
+        {%- endif %}
 
         capsule->expl_ode_fun = (external_function_external_param_casadi *) malloc(sizeof(external_function_external_param_casadi)*N);
         for (int i = 0; i < N; i++) {
@@ -1026,6 +1037,10 @@ void {{ model.name }}_acados_setup_nlp_in({{ model.name }}_solver_capsule* capsu
         {%- if solver_options.hessian_approx == "EXACT" %}
         ocp_nlp_dynamics_model_set_external_param_fun(nlp_config, nlp_dims, nlp_in, i, "expl_ode_hess", &capsule->expl_ode_hess[i]);
         {%- endif %}
+        {%- if solver_options.with_batched_dynamics %}
+        if (i == 0)
+            ocp_nlp_dynamics_model_set(nlp_config, nlp_dims, nlp_in, i, "expl_vde_for_batch", &capsule->expl_vde_forw_batch);
+        {%- endif %}
     {%- elif solver_options.integrator_type == "IRK" %}
         ocp_nlp_dynamics_model_set_external_param_fun(nlp_config, nlp_dims, nlp_in, i, "impl_dae_fun", &capsule->impl_dae_fun[i]);
         ocp_nlp_dynamics_model_set_external_param_fun(nlp_config, nlp_dims, nlp_in, i,
@@ -2598,6 +2613,9 @@ static void {{ model.name }}_acados_create_set_opts({{ model.name }}_solver_caps
     int nlp_solver_max_iter = {{ solver_options.nlp_solver_max_iter }};
     ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "max_iter", &nlp_solver_max_iter);
 
+    bool with_batched_dynamics = {{ solver_options.with_batched_dynamics }};
+    ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "with_batched_dynamics", &with_batched_dynamics);
+
     // set options for adaptive Levenberg-Marquardt Update
     bool with_adaptive_levenberg_marquardt = {{ solver_options.with_adaptive_levenberg_marquardt }};
     ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "with_adaptive_levenberg_marquardt", &with_adaptive_levenberg_marquardt);
@@ -3214,6 +3232,9 @@ int {{ model.name }}_acados_free({{ model.name }}_solver_capsule* capsule)
     free(capsule->expl_vde_adj);
     free(capsule->expl_vde_forw);
     free(capsule->expl_ode_fun);
+    {%- if solver_options.with_batched_dynamics %}
+    external_function_casadi_batch_free(&capsule->expl_vde_forw_batch);
+    {%- endif %}
     {%- if solver_options.hessian_approx == "EXACT" %}
     free(capsule->expl_ode_hess);
     {%- endif %}
@@ -106,6 +106,9 @@ typedef struct {{ model.name }}_solver_capsule
     // dynamics
 {% if solver_options.integrator_type == "ERK" %}
     external_function_external_param_casadi *expl_vde_forw;
+{%- if solver_options.with_batched_dynamics %}
+    external_function_casadi_batch expl_vde_forw_batch;
+{%- endif %}
     external_function_external_param_casadi *expl_ode_fun;
     external_function_external_param_casadi *expl_vde_adj;
 {% if solver_options.hessian_approx == "EXACT" %}
@@ -156,6 +156,16 @@ const int *{{ model.name }}_expl_vde_forw_sparsity_in(int);
 const int *{{ model.name }}_expl_vde_forw_sparsity_out(int);
 int {{ model.name }}_expl_vde_forw_n_in(void);
 int {{ model.name }}_expl_vde_forw_n_out(void);
+{%- if solver_options.with_batched_dynamics is defined and solver_options.with_batched_dynamics %}
+
+// explicit forward VDE, mapped over the shooting intervals
+int {{ model.name }}_expl_vde_forw_batch(const real_t** arg, real_t** res, int* iw, real_t* w, void *mem);
+int {{ model.name }}_expl_vde_forw_batch_work(int *, int *, int *, int *);
+const int *{{ model.name }}_expl_vde_forw_batch_sparsity_in(int);
+const int *{{ model.name }}_expl_vde_forw_batch_sparsity_out(int);
+int {{ model.name }}_expl_vde_forw_batch_n_in(void);
+int {{ model.name }}_expl_vde_forw_batch_n_out(void);
+{%- endif %}
 
 // explicit adjoint VDE
 int {{ model.name }}_expl_vde_adj(const real_t** arg, real_t** res, int* iw, real_t* w, void *mem);
@@ -48,6 +48,7 @@ class AcadosCodegenOptions:
     with_solution_sens_wrt_params: bool = False
     with_value_sens_wrt_params: bool = False
     generate_hess: bool = True
+    expl_vde_forw_batch_size: int = 0
 
 class GenerateContext:
     def __init__(self, p_global: Optional[Union[ca.SX, ca.MX]], problem_name: str, opts: AcadosCodegenOptions):
@@ -72,6 +73,7 @@ class GenerateContext:
         self.generic_funname_dir_pairs = []  # list of (function_name, output_dir) of functions that are not generated by acados
         self.function_input_output_pairs: List[List[Union[ca.SX, ca.MX], Union[ca.SX, ca.MX]]] = []
         self.dyn_cost_constr_types = []
+        self.map_sizes = []  # generate the function mapped over this many instances, if > 0
 
         self.global_data_sym = None
         self.global_data_expr = None
@@ -88,10 +90,11 @@ class GenerateContext:
 
 
     def __generate_functions(self):
-        for (name, output_dir), (inputs, outputs), dyn_cost_constr_type in zip(self.list_funname_dir_pairs, self.function_input_output_pairs, self.dyn_cost_constr_types):
+        for (name, output_dir), (inputs, outputs), dyn_cost_constr_type, map_size in zip(self.list_funname_dir_pairs, self.function_input_output_pairs, self.dyn_cost_constr_types, self.map_sizes):
             # create function
             try:
-                fun = ca.Function(name, inputs, outputs, self.__casadi_fun_opts)
+                fun_name = name if map_size == 0 else name + '_instance'
+                fun = ca.Function(fun_name, inputs, outputs, self.__casadi_fun_opts)
                 # print(f"Generating function {name} with inputs {inputs}")
             except RuntimeError as e:
                 print(f"\nError while creating function {name} with inputs \n{inputs} \n and outputs \n {outputs}")
@@ -108,6 +111,10 @@ class GenerateContext:
                 except:
                     warnings.warn(f"Failed to expand CasADi function {name}.")
 
+            # all inputs and outputs are concatenated horizontally over the instances
+            if map_size > 0:
+                fun = fun.map(name, 'serial', map_size, [], [])
+
             # setup output directory
             if not os.path.exists(output_dir):
                 os.makedirs(output_dir)
@@ -132,10 +139,12 @@ class GenerateContext:
                                 inputs: List[Union[ca.MX, ca.SX]],
                                 outputs: List[Union[ca.MX, ca.SX]],
                                 output_dir: str,
-                                dyn_cost_constr_type: str):
+                                dyn_cost_constr_type: str,
+                                map_size: int = 0):
         self.list_funname_dir_pairs.append((name, output_dir))
         self.function_input_output_pairs.append([inputs, outputs])
         self.dyn_cost_constr_types.append(dyn_cost_constr_type)
+        self.map_sizes.append(map_size)
 
     def __setup_p_global_precompute_fun(self):
         precompute_pairs = []
@@ -313,6 +322,11 @@ def generate_c_code_explicit_ode(context: GenerateContext, model: AcadosModel, m
     fun_name = model_name + '_expl_vde_forw'
     context.add_function_definition(fun_name, [x, Sx, Sp, u, p], [f_expl, vdeX, vdeP], model_dir, 'dyn')
 
+    if context.opts.expl_vde_forw_batch_size > 0:
+        fun_name = model_name + '_expl_vde_forw_batch'
+        context.add_function_definition(fun_name, [x, Sx, Sp, u, p], [f_expl, vdeX, vdeP], model_dir, 'dyn',
+                                        map_size=context.opts.expl_vde_forw_batch_size)
+
     fun_name = model_name + '_expl_vde_adj'
     context.add_function_definition(fun_name, [x, lambdaX, u, p], [adj], model_dir, 'dyn')
 
@@ -33,7 +33,9 @@
 #include <string>
 #include <vector>
 #include <cstdlib>
+#include <cmath>
 
+#include "test/test_utils/casadi_map.h"
 #include "test/test_utils/eigen.h"
 #include "catch/include/catch.hpp"
 
@@ -133,7 +135,7 @@ ocp_nlp_dynamics_t nlp_dynamics_enum(std::string const& inString)
 
 sim_solver_t integrator_enum(std::string const& inString)
 {
-    if (inString == "ERK") return ERK;
+    if (inString == "ERK" || inString == "ERK_BATCHED") return ERK;
     if (inString == "IRK") return IRK;
     if (inString == "LIFTED_IRK") return LIFTED_IRK;
 
@@ -756,13 +758,239 @@ void read_final_state(const int nx, const int num_free_masses, double *xN)
 // BROKEN & removed since external function convention changed, input is x, u now.
 
 
+// solver options and memory layouts that have to reproduce the default solution
+typedef struct
+{
+    bool with_stage_load_balancing;
+    bool use_arena;  // additionally solve with in, out and solver created in one arena
+    int reuse_workspace;
+    bool check_out_access;  // compare the field id accessors, field handles and aliasing of nlp_out with the string based ones
+    int line_search_num_candidates;  // 0: full steps, else merit backtracking with this many concurrent trials
+    int use_SOC;  // second order correction in the merit backtracking
+    double init_pos_scale;  // scaling of the mass positions in the initial guess, < 1 contracts the chain
+    bool with_batch_vde;  // ERK_BATCHED: set the mapped vde, else the lock-step integration calls the stage-wise vde
+    int batch_size;  // > 0: additionally solve this many instances with different x0 with ocp_nlp_batch_solve
+} chain_nlp_variant;
+
+static chain_nlp_variant chain_nlp_variant_default()
+{
+    chain_nlp_variant variant;
+    variant.with_stage_load_balancing = false;
+    variant.use_arena = false;
+    variant.reuse_workspace = 1;
+    variant.check_out_access = false;
+    variant.line_search_num_candidates = 0;
+    variant.use_SOC = 0;
+    variant.init_pos_scale = 1.0;
+    variant.with_batch_vde = false;
+    variant.batch_size = 0;
+    return variant;
+}
+
+// compares the field id based accessors of ocp_nlp_out with the string based ones
+static void check_nlp_out_access_by_id(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
+                                       ocp_nlp_out *nlp_out)
+{
+    int N = dims->N;
+    std::vector<std::string> fields = {"x", "u", "z", "sl", "su", "pi", "lam"};
+
+    for (std::string const& field : fields)
+    {
+        ocp_nlp_out_field_t field_id = ocp_nlp_out_field_from_name(field.c_str());
+        REQUIRE(field_id != INVALID_OCP_NLP_OUT_FIELD);
+
+        // stages covered by the bulk accessors, as in ocp_nlp_get_all
+        int num_stages = (field == "u" || field == "z" || field == "pi") ? N : N+1;
+
+        std::vector<double> all_by_name, all_by_id;
+        for (int stage = 0; stage < num_stages; stage++)
+        {
+            int size = ocp_nlp_dims_get_from_attr(config, dims, nlp_out, stage, field.c_str());
+            std::vector<double> by_name(size), by_id(size), perturbed(size);
+
+            ocp_nlp_out_get(config, dims, nlp_out, stage, field.c_str(), by_name.data());
+            ocp_nlp_out_get_by_id(config, dims, nlp_out, stage, field_id, by_id.data());
+            for (int j = 0; j < size; j++)
+                REQUIRE(by_id[j] == by_name[j]);
+
+            // set by id, get by name and restore by name
+            for (int j = 0; j < size; j++)
+                perturbed[j] = by_name[j] + 1.0 + j;
+            ocp_nlp_out_set_by_id(config, dims, nlp_out, nlp_in, stage, field_id, perturbed.data());
+            ocp_nlp_out_get(config, dims, nlp_out, stage, field.c_str(), by_name.data());
+            for (int j = 0; j < size; j++)
+                REQUIRE(by_name[j] == perturbed[j]);
+            for (int j = 0; j < size; j++)
+                by_name[j] = by_id[j];
+            ocp_nlp_out_set(config, dims, nlp_out, nlp_in, stage, field.c_str(), by_name.data());
+
+            all_by_name.insert(all_by_name.end(), by_name.begin(), by_name.end());
+        }
+
+        // bulk accessors
+        all_by_id.resize(all_by_name.size());
+        ocp_nlp_out_get_all_by_id(dims, nlp_out, field_id, all_by_id.data());
+        for (size_t j = 0; j < all_by_name.size(); j++)
+            REQUIRE(all_by_id[j] == all_by_name[j]);
+
+        std::vector<double> perturbed(all_by_name.size());
+        for (size_t j = 0; j < all_by_name.size(); j++)
+            perturbed[j] = 2.0 * all_by_name[j] - 1.0;
+        ocp_nlp_out_set_all_by_id(dims, nlp_in, nlp_out, field_id, perturbed.data());
+        int offset = 0;
+        for (int stage = 0; stage < num_stages; stage++)
+        {
+            int size = ocp_nlp_dims_get_from_attr(config, dims, nlp_out, stage, field.c_str());
+            std::vector<double> by_name(size);
+            ocp_nlp_out_get(config, dims, nlp_out, stage, field.c_str(), by_name.data());
+            for (int j = 0; j < size; j++)
+                REQUIRE(by_name[j] == perturbed[offset+j]);
+            offset += size;
+        }
+        ocp_nlp_out_set_all_by_id(dims, nlp_in, nlp_out, field_id, all_by_name.data());
+    }
+}
+
+
+
+// sets constraints and cost fields through field handles and checks that the model, the constraint
+// mask and the multipliers end up as with the string based setters; restores the original values
+static void check_model_field_handles(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
+                                      ocp_nlp_out *nlp_out)
+{
+    int N = dims->N;
+
+    for (int stage = 0; stage <= N; stage++)
+    {
+        int ni = dims->ni[stage];
+        int nlam = ocp_nlp_dims_get_from_attr(config, dims, nlp_out, stage, "lam");
+        std::vector<double> lam_orig(nlam), lam_str(nlam), lam_handle(nlam);
+        std::vector<double> mask_str(2*ni), mask_handle(2*ni);
+        ocp_nlp_out_get(config, dims, nlp_out, stage, "lam", lam_orig.data());
+
+        for (std::string field : {"lbu", "ubu", "lbx", "ubx", "lg", "ug"})
+        {
+            int dims_out[2];
+            ocp_nlp_constraint_dims_get_from_attr(config, dims, nlp_out, stage, field.c_str(), dims_out);
+            int size = dims_out[0];
+            if (size == 0)
+                continue;
+
+            // every other bound is set to infinity, such that the mask changes
+            bool upper = field[0] == 'u';
+            std::vector<double> orig(size), value(size), by_str(size), by_handle(size);
+            ocp_nlp_constraints_model_get(config, dims, nlp_in, stage, field.c_str(), orig.data());
+            for (int j = 0; j < size; j++)
+            {
+                if (j % 2 == 0)
+                    value[j] = upper ? ACADOS_INFTY : -ACADOS_INFTY;
+                else
+                    value[j] = upper ? orig[j] + 0.5 + j : orig[j] - 0.5 - j;
+            }
+
+            ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, stage, field.c_str(), value.data());
+            ocp_nlp_constraints_model_get(config, dims, nlp_in, stage, field.c_str(), by_str.data());
+            blasfeo_unpack_dvec(2*ni, &nlp_in->dmask[stage], 0, mask_str.data(), 1);
+            ocp_nlp_out_get(config, dims, nlp_out, stage, "lam", lam_str.data());
+
+            ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, stage, field.c_str(), orig.data());
+            ocp_nlp_out_set(config, dims, nlp_out, nlp_in, stage, "lam", lam_orig.data());
+
+            ocp_nlp_field_handle handle = ocp_nlp_constraints_field_lookup(config, dims, stage, field.c_str());
+            REQUIRE(handle.stage == stage);
+            ocp_nlp_field_handle_set(config, dims, nlp_in, nlp_out, handle, value.data());
+            ocp_nlp_constraints_model_get(config, dims, nlp_in, stage, field.c_str(), by_handle.data());
+            blasfeo_unpack_dvec(2*ni, &nlp_in->dmask[stage], 0, mask_handle.data(), 1);
+            ocp_nlp_out_get(config, dims, nlp_out, stage, "lam", lam_handle.data());
+
+            for (int j = 0; j < size; j++)
+                REQUIRE(by_handle[j] == by_str[j]);
+            for (int j = 0; j < 2*ni; j++)
+                REQUIRE(mask_handle[j] == mask_str[j]);
+            for (int j = 0; j < nlam; j++)
+                REQUIRE(lam_handle[j] == lam_str[j]);
+
+            ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, stage, field.c_str(), orig.data());
+            ocp_nlp_out_set(config, dims, nlp_out, nlp_in, stage, "lam", lam_orig.data());
+        }
+
+        // cost modules without precompiled setters are only reachable by name
+        if (config->cost[stage]->model_field_id == NULL)
+            continue;
+
+        for (std::string field : {"y_ref", "W"})
+        {
+            int dims_out[2];
+            ocp_nlp_cost_dims_get_from_attr(config, dims, nlp_out, stage, field.c_str(), dims_out);
+            int size = dims_out[0] * (dims_out[1] > 0 ? dims_out[1] : 1);
+            std::vector<double> orig(size), value(size), by_str(size), by_handle(size);
+            ocp_nlp_cost_model_get(config, dims, nlp_in, stage, field.c_str(), orig.data());
+            for (int j = 0; j < size; j++)
+                value[j] = orig[j];
+            // keeps W symmetric
+            for (int j = 0; j < dims_out[0]; j++)
+                value[j*(dims_out[1] > 0 ? dims_out[0]+1 : 1)] += 1.0 + j;
+
+            ocp_nlp_cost_model_set(config, dims, nlp_in, stage, field.c_str(), value.data());
+            ocp_nlp_cost_model_get(config, dims, nlp_in, stage, field.c_str(), by_str.data());
+            ocp_nlp_cost_model_set(config, dims, nlp_in, stage, field.c_str(), orig.data());
+
+            ocp_nlp_field_handle handle = ocp_nlp_cost_field_lookup(config, dims, stage, field.c_str());
+            ocp_nlp_field_handle_set(config, dims, nlp_in, nlp_out, handle, value.data());
+            ocp_nlp_cost_model_get(config, dims, nlp_in, stage, field.c_str(), by_handle.data());
+            for (int j = 0; j < size; j++)
+                REQUIRE(by_handle[j] == by_str[j]);
+
+            ocp_nlp_cost_model_set(config, dims, nlp_in, stage, field.c_str(), orig.data());
+        }
+    }
+}
+
+
+
+// packs x and u of all stages into a buffer with the layout of ocp_nlp_out_alias
+static void pack_alias_buffer_ux(ocp_nlp_dims *dims, const double *x, const double *u, double *buffer)
+{
+    int N = dims->N;
+    int offset = 0;
+    for (int i = 0; i <= N; i++)
+    {
+        for (int j = 0; j < dims->nu[i]; j++)
+            buffer[offset+j] = u[j];
+        for (int j = 0; j < dims->nx[i]; j++)
+            buffer[offset+dims->nu[i]+j] = x[j];
+        offset += dims->nv[i];
+    }
+}
+
+
+
+// solution and solver statistics, to compare different variants
+typedef struct
+{
+    std::vector<double> x;
+    std::vector<double> u;
+    std::vector<double> time_lin_stage;
+    int sqp_iter;
+    acados_size_t workspace_size;
+    acados_size_t workspace_size_summed;
+    int dynamics_batched;
+    // last linearization: A, B and b of each shooting interval and the stationarity residual
+    std::vector<double> A, B, b, res_stat;
+    std::vector<double> alpha;  // accepted step sizes, with line search only
+} chain_nlp_result;
+
+
+
 void setup_and_solve_nlp(int NN,
     int NMF,
     std::string const& con_str,
     std::string const& cost_str,
     std::string const& qp_solver_str,
     std::string const& model_str,
-    std::string const& integrator_str
+    std::string const& integrator_str,
+    chain_nlp_variant const& variant = chain_nlp_variant_default(),
+    chain_nlp_result *result = NULL
     )
 {
     /************************************************
@@ -924,6 +1152,8 @@ void setup_and_solve_nlp(int NN,
 
     // TODO(dimitris): not necessarily GN, depends on cost module
     plan->nlp_solver = SQP;
+    if (variant.line_search_num_candidates > 0)
+        plan->globalization = MERIT_BACKTRACKING;
 
     ocp_nlp_cost_t cost_type = cost_enum(cost_str);
     switch (cost_type)
@@ -1105,6 +1335,22 @@ void setup_and_solve_nlp(int NN,
 
     // forw_vde
     external_function_casadi_create_array(NN, expl_vde_for, &ext_fun_opts);
+    // forw_vde mapped over all shooting intervals
+    typedef casadi_map<0> mapped_vde;
+    external_function_casadi_batch expl_vde_for_batch;
+    if (variant.with_batch_vde)
+    {
+        mapped_vde::init(expl_vde_for[0].casadi_fun, expl_vde_for[0].casadi_work,
+                         expl_vde_for[0].casadi_sparsity_in, expl_vde_for[0].casadi_sparsity_out,
+                         expl_vde_for[0].casadi_n_in, expl_vde_for[0].casadi_n_out, NN);
+        expl_vde_for_batch.casadi_fun = &mapped_vde::fun;
+        expl_vde_for_batch.casadi_work = &mapped_vde::work;
+        expl_vde_for_batch.casadi_sparsity_in = &mapped_vde::sparsity_in;
+        expl_vde_for_batch.casadi_sparsity_out = &mapped_vde::sparsity_out;
+        expl_vde_for_batch.casadi_n_in = &mapped_vde::get_n_in;
+        expl_vde_for_batch.casadi_n_out = &mapped_vde::get_n_out;
+        external_function_casadi_batch_create(&expl_vde_for_batch, NN, 0, &ext_fun_opts);
+    }
     // impl_ode
     external_function_casadi_create_array(NN, impl_ode_fun, &ext_fun_opts);
     //
@@ -1159,191 +1405,203 @@ void setup_and_solve_nlp(int NN,
     * nlp_in
     ************************************************/
 
-    ocp_nlp_in *nlp_in = ocp_nlp_in_create(config, dims);
-
-    // sampling times
-    for (int ii = 0; ii < NN; ii++)
-        nlp_in->Ts[ii] = TF/NN;
+    // sets the problem data, also used for the inputs created in an arena
+    auto set_nlp_in_data = [&](ocp_nlp_in *nlp_in)
+    {
+        // sampling times
+        for (int ii = 0; ii < NN; ii++)
+            nlp_in->Ts[ii] = TF/NN;
 
-    // output definition: y = [x; u]
-    /* cost */
-    ocp_nlp_cost_ls_model *stage_cost_ls;
-    ocp_nlp_cost_nls_model *stage_cost_nls;
-    ocp_nlp_cost_external_model *stage_cost_external;
+        // output definition: y = [x; u]
+        /* cost */
+        ocp_nlp_cost_ls_model *stage_cost_ls;
+        ocp_nlp_cost_nls_model *stage_cost_nls;
+        ocp_nlp_cost_external_model *stage_cost_external;
 
-    for (int i = 0; i < NN; i++)
-    {
-        switch (plan->nlp_cost[i])
+        for (int i = 0; i < NN; i++)
         {
-            case LINEAR_LS:
+            switch (plan->nlp_cost[i])
+            {
+                case LINEAR_LS:
 
-                stage_cost_ls = (ocp_nlp_cost_ls_model *) nlp_in->cost[i];
-
-                // Cyt
-                blasfeo_dgese(nu[i]+nx[i], ny[i], 0.0, &stage_cost_ls->Cyt, 0, 0);
-                for (int j = 0; j < nu[i]; j++)
-                    BLASFEO_DMATEL(&stage_cost_ls->Cyt, j, nx[i]+j) = 1.0;
-                for (int j = 0; j < nx[i]; j++)
-                    BLASFEO_DMATEL(&stage_cost_ls->Cyt, nu[i]+j, j) = 1.0;
-
-                // W
-                blasfeo_dgese(ny[i], ny[i], 0.0, &stage_cost_ls->W, 0, 0);
-                for (int j = 0; j < nx[i]; j++)
-                    BLASFEO_DMATEL(&stage_cost_ls->W, j, j) = diag_cost_x[j];
-                for (int j = 0; j < nu[i]; j++)
-                    BLASFEO_DMATEL(&stage_cost_ls->W, nx[i]+j, nx[i]+j) = diag_cost_u[j];
-
-                // y_ref
-                blasfeo_pack_dvec(nx[i], xref, 1, &stage_cost_ls->y_ref, 0);
-                blasfeo_pack_dvec(nu[i], uref, 1, &stage_cost_ls->y_ref, nx[i]);
-                break;
+                    stage_cost_ls = (ocp_nlp_cost_ls_model *) nlp_in->cost[i];
 
-            case NONLINEAR_LS:
+                    // Cyt
+                    blasfeo_dgese(nu[i]+nx[i], ny[i], 0.0, &stage_cost_ls->Cyt, 0, 0);
+                    for (int j = 0; j < nu[i]; j++)
+                        BLASFEO_DMATEL(&stage_cost_ls->Cyt, j, nx[i]+j) = 1.0;
+                    for (int j = 0; j < nx[i]; j++)
+                        BLASFEO_DMATEL(&stage_cost_ls->Cyt, nu[i]+j, j) = 1.0;
 
-                stage_cost_nls = (ocp_nlp_cost_nls_model *) nlp_in->cost[i];
+                    // W
+                    blasfeo_dgese(ny[i], ny[i], 0.0, &stage_cost_ls->W, 0, 0);
+                    for (int j = 0; j < nx[i]; j++)
+                        BLASFEO_DMATEL(&stage_cost_ls->W, j, j) = diag_cost_x[j];
+                    for (int j = 0; j < nu[i]; j++)
+                        BLASFEO_DMATEL(&stage_cost_ls->W, nx[i]+j, nx[i]+j) = diag_cost_u[j];
 
-                // nls_y_fun_jac
-                stage_cost_nls->nls_y_fun_jac = (external_function_generic *) &ls_cost_jac_casadi[i];
+                    // y_ref
+                    blasfeo_pack_dvec(nx[i], xref, 1, &stage_cost_ls->y_ref, 0);
+                    blasfeo_pack_dvec(nu[i], uref, 1, &stage_cost_ls->y_ref, nx[i]);
+                    break;
 
-                // W
-                blasfeo_dgese(ny[i], ny[i], 0.0, &stage_cost_nls->W, 0, 0);
-                for (int j = 0; j < nx[i]; j++)
-                    BLASFEO_DMATEL(&stage_cost_nls->W, j, j) = diag_cost_x[j];
-                for (int j = 0; j < nu[i]; j++)
-                    BLASFEO_DMATEL(&stage_cost_nls->W, nx[i]+j, nx[i]+j) = diag_cost_u[j];
+                case NONLINEAR_LS:
 
-                // y_ref
-                blasfeo_pack_dvec(nx[i], xref, 1, &stage_cost_nls->y_ref, 0);
-                blasfeo_pack_dvec(nu[i], uref, 1, &stage_cost_nls->y_ref, nx[i]);
-                break;
+                    stage_cost_nls = (ocp_nlp_cost_nls_model *) nlp_in->cost[i];
 
-            case EXTERNAL:
+                    // nls_y_fun_jac
+                    stage_cost_nls->nls_y_fun_jac = (external_function_generic *) &ls_cost_jac_casadi[i];
 
-                ocp_nlp_cost_model_set(config, dims, nlp_in, i, "ext_cost_fun_jac_hes", &external_cost[i]);
+                    // W
+                    blasfeo_dgese(ny[i], ny[i], 0.0, &stage_cost_nls->W, 0, 0);
+                    for (int j = 0; j < nx[i]; j++)
+                        BLASFEO_DMATEL(&stage_cost_nls->W, j, j) = diag_cost_x[j];
+                    for (int j = 0; j < nu[i]; j++)
+                        BLASFEO_DMATEL(&stage_cost_nls->W, nx[i]+j, nx[i]+j) = diag_cost_u[j];
 
-                assert(i < NN && "externally provided cost not implemented for last stage!");
-                break;
+                    // y_ref
+                    blasfeo_pack_dvec(nx[i], xref, 1, &stage_cost_nls->y_ref, 0);
+                    blasfeo_pack_dvec(nu[i], uref, 1, &stage_cost_nls->y_ref, nx[i]);
+                    break;
 
-            default:
-                printf("\ncost not correctly specified\n\n");
-                exit(1);
+                case EXTERNAL:
+
+                    ocp_nlp_cost_model_set(config, dims, nlp_in, i, "ext_cost_fun_jac_hes", &external_cost[i]);
+
+                    assert(i < NN && "externally provided cost not implemented for last stage!");
+                    break;
+
+                default:
+                    printf("\ncost not correctly specified\n\n");
+                    exit(1);
+            }
         }
-    }
 
 
 
-    /* dynamics */
-    int set_fun_status;
+        /* dynamics */
+        int set_fun_status;
 
-    // TODO(dimitris): remove after setting
-    // function via nlp interface
-    ocp_nlp_dynamics_disc_model *dynamics;
+        // TODO(dimitris): remove after setting
+        // function via nlp interface
+        ocp_nlp_dynamics_disc_model *dynamics;
 
-    for (int i = 0; i < NN; i++)
-    {
-        switch (plan->nlp_dynamics[i])
+        for (int i = 0; i < NN; i++)
         {
-            case CONTINUOUS_MODEL:
+            switch (plan->nlp_dynamics[i])
+            {
+                case CONTINUOUS_MODEL:
 
-                if (plan->sim_solver_plan[i].sim_solver == ERK)
-                {
-                    set_fun_status = ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
-                                                            "expl_vde_for", &expl_vde_for[i]);
-                    if (set_fun_status != 0) exit(1);
-                }
-                else if (plan->sim_solver_plan[i].sim_solver == IRK)
-                {
-                    set_fun_status = ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
-                                                            "impl_ode_fun", &impl_ode_fun[i]);
-                    if (set_fun_status != 0) exit(1);
-                    set_fun_status = ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
-                                            "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot[i]);
-                    if (set_fun_status != 0) exit(1);
-                    set_fun_status = ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
-                                                "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u[i]);
-                    if (set_fun_status != 0) exit(1);
-                }
-                else if (plan->sim_solver_plan[i].sim_solver == LIFTED_IRK)
-                {
-                    set_fun_status = ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
-                                                            "impl_ode_fun", &impl_ode_fun[i]);
-                    if (set_fun_status != 0) exit(1);
-                    set_fun_status = ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
-                                        "impl_ode_fun_jac_x_xdot_u", &impl_ode_fun_jac_x_xdot_u[i]);
-                    if (set_fun_status != 0) exit(1);
-                }
-                break;
-            case DISCRETE_MODEL:
-                // TODO(dimitris): do this
-                // through the interface and
-                // remove header
-                if (NMF < 4)
-                {
-                    dynamics = (ocp_nlp_dynamics_disc_model *)nlp_in->dynamics[i];
-                    dynamics->disc_dyn_fun_jac = (external_function_generic *) &erk4_casadi[i];
-                }
-                break;
+                    if (plan->sim_solver_plan[i].sim_solver == ERK)
+                    {
+                        set_fun_status = ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                                                "expl_vde_for", &expl_vde_for[i]);
+                        if (set_fun_status != 0) exit(1);
+                    }
+                    else if (plan->sim_solver_plan[i].sim_solver == IRK)
+                    {
+                        set_fun_status = ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                                                "impl_ode_fun", &impl_ode_fun[i]);
+                        if (set_fun_status != 0) exit(1);
+                        set_fun_status = ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                                "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot[i]);
+                        if (set_fun_status != 0) exit(1);
+                        set_fun_status = ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                                    "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u[i]);
+                        if (set_fun_status != 0) exit(1);
+                    }
+                    else if (plan->sim_solver_plan[i].sim_solver == LIFTED_IRK)
+                    {
+                        set_fun_status = ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                                                "impl_ode_fun", &impl_ode_fun[i]);
+                        if (set_fun_status != 0) exit(1);
+                        set_fun_status = ocp_nlp_dynamics_model_set(config, dims, nlp_in, i,
+                                            "impl_ode_fun_jac_x_xdot_u", &impl_ode_fun_jac_x_xdot_u[i]);
+                        if (set_fun_status != 0) exit(1);
+                    }
+                    break;
+                case DISCRETE_MODEL:
+                    // TODO(dimitris): do this
+                    // through the interface and
+                    // remove header
+                    if (NMF < 4)
+                    {
+                        dynamics = (ocp_nlp_dynamics_disc_model *)nlp_in->dynamics[i];
+                        dynamics->disc_dyn_fun_jac = (external_function_generic *) &erk4_casadi[i];
+                    }
+                    break;
 
-            default:
-                printf("\ndynamics not correctly specified\n\n");
-                exit(1);
+                default:
+                    printf("\ndynamics not correctly specified\n\n");
+                    exit(1);
+            }
         }
-    }
-
-    /* constraints */
-    ocp_nlp_constraints_bgh_model **constraints =
-        (ocp_nlp_constraints_bgh_model **) nlp_in->constraints;
 
-    // first stage
-    switch (con_type)
-    {
-        case BOX:
-            blasfeo_pack_dvec(nb[0], lb0, 1, &constraints[0]->d, 0);
-            blasfeo_pack_dvec(nb[0], ub0, 1, &constraints[0]->d, nb[0]+ng[0]);
-            constraints[0]->idxb = idxb0;
-            break;
-        case GENERAL:
-            double *Cu0; d_zeros(&Cu0, ng[0], nu[0]);
-            for (int ii = 0; ii < nu[0]; ii++)
-                Cu0[ii*(ng[0]+1)] = 1.0;
+        if (variant.with_batch_vde)
+        {
+            set_fun_status = ocp_nlp_dynamics_model_set(config, dims, nlp_in, 0,
+                                                        "expl_vde_for_batch", &expl_vde_for_batch);
+            if (set_fun_status != 0) exit(1);
+        }
 
-            double *Cx0; d_zeros(&Cx0, ng[0], nx[0]);
-            for (int ii = 0; ii < nx[0]; ii++)
-                Cx0[nu[0]+ii*(ng[0]+1)] = 1.0;
+        /* constraints */
+        ocp_nlp_constraints_bgh_model **constraints =
+            (ocp_nlp_constraints_bgh_model **) nlp_in->constraints;
 
-            blasfeo_pack_tran_dmat(ng[0], nu[0], Cu0, ng[0], &constraints[0]->DCt, 0, 0);
-            blasfeo_pack_tran_dmat(ng[0], nx[0], Cx0, ng[0], &constraints[0]->DCt, nu[0], 0);
-            blasfeo_pack_dvec(ng[0], lb0, 1, &constraints[0]->d, nb[0]);
-            blasfeo_pack_dvec(ng[0], ub0, 1, &constraints[0]->d, 2*nb[0]+ng[0]);
+        // first stage
+        switch (con_type)
+        {
+            case BOX:
+                blasfeo_pack_dvec(nb[0], lb0, 1, &constraints[0]->d, 0);
+                blasfeo_pack_dvec(nb[0], ub0, 1, &constraints[0]->d, nb[0]+ng[0]);
+                constraints[0]->idxb = idxb0;
+                break;
+            case GENERAL:
+                double *Cu0; d_zeros(&Cu0, ng[0], nu[0]);
+                for (int ii = 0; ii < nu[0]; ii++)
+                    Cu0[ii*(ng[0]+1)] = 1.0;
+
+                double *Cx0; d_zeros(&Cx0, ng[0], nx[0]);
+                for (int ii = 0; ii < nx[0]; ii++)
+                    Cx0[nu[0]+ii*(ng[0]+1)] = 1.0;
+
+                blasfeo_pack_tran_dmat(ng[0], nu[0], Cu0, ng[0], &constraints[0]->DCt, 0, 0);
+                blasfeo_pack_tran_dmat(ng[0], nx[0], Cx0, ng[0], &constraints[0]->DCt, nu[0], 0);
+                blasfeo_pack_dvec(ng[0], lb0, 1, &constraints[0]->d, nb[0]);
+                blasfeo_pack_dvec(ng[0], ub0, 1, &constraints[0]->d, 2*nb[0]+ng[0]);
+
+                d_free(Cu0);
+                d_free(Cx0);
+                break;
+            case GENERAL_NONLINEAR:
+            default:
+                blasfeo_dgese(nu[0]+nx[0], ng[0], 0.0, &constraints[0]->DCt, 0, 0);
+                for (int ii = 0; ii < ng[0]; ii++)
+                    BLASFEO_DMATEL(&constraints[0]->DCt, ii, ii) = 1.0;
 
-            d_free(Cu0);
-            d_free(Cx0);
-            break;
-        case GENERAL_NONLINEAR:
-        default:
-            blasfeo_dgese(nu[0]+nx[0], ng[0], 0.0, &constraints[0]->DCt, 0, 0);
-            for (int ii = 0; ii < ng[0]; ii++)
-                BLASFEO_DMATEL(&constraints[0]->DCt, ii, ii) = 1.0;
+                ocp_nlp_constraints_bgh_model **nl_constr = (ocp_nlp_constraints_bgh_model **)
+                                                        nlp_in->constraints;
+                nl_constr[0]->nl_constr_h_fun_jac = &nonlin_constr_generic;
 
-            ocp_nlp_constraints_bgh_model **nl_constr = (ocp_nlp_constraints_bgh_model **)
-                                                    nlp_in->constraints;
-            nl_constr[0]->nl_constr_h_fun_jac = &nonlin_constr_generic;
+                blasfeo_pack_dvec(ng[0]+nh[0], lb0, 1, &constraints[0]->d, nb[0]);
+                blasfeo_pack_dvec(ng[0]+nh[0], ub0, 1, &constraints[0]->d, 2*nb[0]+ng[0]+nh[0]);
+                break;
+        }
 
-            blasfeo_pack_dvec(ng[0]+nh[0], lb0, 1, &constraints[0]->d, nb[0]);
-            blasfeo_pack_dvec(ng[0]+nh[0], ub0, 1, &constraints[0]->d, 2*nb[0]+ng[0]+nh[0]);
-            break;
-    }
+        // other stages
+        for (int i = 1; i < NN; i++)
+        {
+            blasfeo_pack_dvec(nb[i], lb1, 1, &constraints[i]->d, 0);
+            blasfeo_pack_dvec(nb[i], ub1, 1, &constraints[i]->d, nb[i]+ng[i]);
+            constraints[i]->idxb = idxb1;
+        }
+        blasfeo_pack_dvec(nb[NN], lbN, 1, &constraints[NN]->d, 0);
+        blasfeo_pack_dvec(nb[NN], ubN, 1, &constraints[NN]->d, nb[NN]+ng[NN]);
+        constraints[NN]->idxb = idxbN;
+    };
 
-    // other stages
-    for (int i = 1; i < NN; i++)
-    {
-        blasfeo_pack_dvec(nb[i], lb1, 1, &constraints[i]->d, 0);
-        blasfeo_pack_dvec(nb[i], ub1, 1, &constraints[i]->d, nb[i]+ng[i]);
-        constraints[i]->idxb = idxb1;
-    }
-    blasfeo_pack_dvec(nb[NN], lbN, 1, &constraints[NN]->d, 0);
-    blasfeo_pack_dvec(nb[NN], ubN, 1, &constraints[NN]->d, nb[NN]+ng[NN]);
-    constraints[NN]->idxb = idxbN;
+    ocp_nlp_in *nlp_in = ocp_nlp_in_create(config, dims);
+    set_nlp_in_data(nlp_in);
 
     /************************************************
     * sqp opts
@@ -1383,6 +1641,24 @@ void setup_and_solve_nlp(int NN,
     ocp_nlp_solver_opts_set(config, nlp_opts, "tol_ineq", &tol_ineq);
     ocp_nlp_solver_opts_set(config, nlp_opts, "tol_comp", &tol_comp);
 
+    // lock-step integration of all shooting intervals
+    bool with_batched_dynamics = integrator_str == "ERK_BATCHED";
+    ocp_nlp_solver_opts_set(config, nlp_opts, "with_batched_dynamics", &with_batched_dynamics);
+
+    bool with_stage_load_balancing = variant.with_stage_load_balancing;
+    ocp_nlp_solver_opts_set(config, nlp_opts, "with_stage_load_balancing", &with_stage_load_balancing);
+
+    int reuse_workspace = variant.reuse_workspace;
+    ocp_nlp_solver_opts_set(config, nlp_opts, "reuse_workspace", &reuse_workspace);
+
+    if (variant.line_search_num_candidates > 0)
+    {
+        int line_search_num_candidates = variant.line_search_num_candidates;
+        ocp_nlp_solver_opts_set(config, nlp_opts, "line_search_num_candidates", &line_search_num_candidates);
+        int use_SOC = variant.use_SOC;
+        ocp_nlp_solver_opts_set(config, nlp_opts, "globalization_use_SOC", &use_SOC);
+    }
+
     /************************************************
     * ocp_nlp out
     ************************************************/
@@ -1401,11 +1677,15 @@ void setup_and_solve_nlp(int NN,
 
     // warm start output initial guess of
     // solution
+    double *xguess = (double *)malloc(NX*sizeof(double));
+    for (int j = 0; j < NX; j++)
+        xguess[j] = (j % 6 < 3) ? variant.init_pos_scale * xref[j] : xref[j];
     for (int i=0; i <= NN; i++)
     {
         blasfeo_pack_dvec(nu[i], uref, 1, nlp_out->ux+i, 0);
-        blasfeo_pack_dvec(nx[i], xref, 1, nlp_out->ux+i, nu[i]);
+        blasfeo_pack_dvec(nx[i], xguess, 1, nlp_out->ux+i, nu[i]);
     }
+    free(xguess);
 
     // call nlp solver
     status = ocp_nlp_solve(solver, nlp_in, nlp_out);
@@ -1427,6 +1707,286 @@ void setup_and_solve_nlp(int NN,
     REQUIRE(status == 0);
     REQUIRE(max_res <= TOL);
 
+    if (result != NULL)
+    {
+        result->x.resize((NN+1)*NX);
+        result->u.resize(NN*NU);
+        result->time_lin_stage.resize(NN+1);
+        for (int i = 0; i <= NN; i++)
+        {
+            ocp_nlp_out_get(config, dims, nlp_out, i, "x", &result->x[i*NX]);
+            if (i < NN)
+                ocp_nlp_out_get(config, dims, nlp_out, i, "u", &result->u[i*NU]);
+            ocp_nlp_get_at_stage(solver, i, "time_lin_stage", &result->time_lin_stage[i]);
+        }
+        ocp_nlp_get(solver, "sqp_iter", &result->sqp_iter);
+        ocp_nlp_get(solver, "workspace_size", &result->workspace_size);
+        ocp_nlp_get(solver, "workspace_size_summed", &result->workspace_size_summed);
+        ocp_nlp_get(solver, "dynamics_batched", &result->dynamics_batched);
+
+        result->alpha.clear();
+        if (variant.line_search_num_candidates > 0)
+        {
+            double *stat;
+            int stat_m, stat_n;
+            ocp_nlp_get(solver, "stat", &stat);
+            ocp_nlp_get(solver, "stat_m", &stat_m);
+            ocp_nlp_get(solver, "stat_n", &stat_n);
+            for (int ii = 1; ii <= result->sqp_iter && ii < stat_m; ii++)
+                result->alpha.push_back(stat[stat_n*ii+6]);
+        }
+
+        result->A.resize(NN*NX*NX);
+        result->B.resize(NN*NX*NU);
+        result->b.resize(NN*NX);
+        result->res_stat.clear();
+        for (int i = 0; i < NN; i++)
+        {
+            ocp_nlp_get_at_stage(solver, i, "A", &result->A[i*NX*NX]);
+            ocp_nlp_get_at_stage(solver, i, "B", &result->B[i*NX*NU]);
+            ocp_nlp_get_at_stage(solver, i, "b", &result->b[i*NX]);
+        }
+        for (int i = 0; i <= NN; i++)
+        {
+            std::vector<double> res_stat_i(dims->nv[i]);
+            ocp_nlp_get_at_stage(solver, i, "res_stat", res_stat_i.data());
+            result->res_stat.insert(result->res_stat.end(), res_stat_i.begin(), res_stat_i.end());
+        }
+    }
+
+    /************************************************
+    * solve in arena
+    ************************************************/
+
+    if (variant.use_arena)
+    {
+        int sqp_iter, arena_sqp_iter;
+        ocp_nlp_get(solver, "sqp_iter", &sqp_iter);
+
+        acados_size_t arena_size = ocp_nlp_in_arena_size(config, dims)
+                                 + ocp_nlp_out_arena_size(config, dims)
+                                 + ocp_nlp_solver_arena_size(config, dims, nlp_opts, nlp_in);
+        acados_arena *arena = acados_arena_create(arena_size);
+        REQUIRE(arena != NULL);
+
+        double *x_ref = (double *) malloc(NX*sizeof(double));
+        double *x_arena = (double *) malloc(NX*sizeof(double));
+
+        // the second pass creates everything again after resetting the arena
+        for (int pass = 0; pass < 2; pass++)
+        {
+            ocp_nlp_in *arena_in = ocp_nlp_in_create_in_arena(config, dims, arena);
+            set_nlp_in_data(arena_in);
+            ocp_nlp_out *arena_out = ocp_nlp_out_create_in_arena(config, dims, arena);
+            ocp_nlp_solver *arena_solver = ocp_nlp_solver_create_in_arena(config, dims, nlp_opts,
+                                                                          arena_in, arena);
+            REQUIRE(acados_arena_get_used_size(arena) <= arena_size);
+
+            status = ocp_nlp_precompute(arena_solver, arena_in, arena_out);
+            REQUIRE(status == 0);
+
+            for (int i=0; i <= NN; i++)
+            {
+                blasfeo_pack_dvec(nu[i], uref, 1, arena_out->ux+i, 0);
+                blasfeo_pack_dvec(nx[i], xref, 1, arena_out->ux+i, nu[i]);
+            }
+
+            status = ocp_nlp_solve(arena_solver, arena_in, arena_out);
+            REQUIRE(status == 0);
+
+            ocp_nlp_get(arena_solver, "sqp_iter", &arena_sqp_iter);
+            REQUIRE(arena_sqp_iter == sqp_iter);
+
+            double max_err = 0.0;
+            for (int i = 0; i <= NN; i++)
+            {
+                ocp_nlp_out_get(config, dims, nlp_out, i, "x", x_ref);
+                ocp_nlp_out_get(config, dims, arena_out, i, "x", x_arena);
+                for (int j = 0; j < NX; j++)
+                    max_err = fabs(x_arena[j] - x_ref[j]) > max_err ? fabs(x_arena[j] - x_ref[j]) : max_err;
+            }
+            std::cout << "arena pass " << pass << ", max deviation from calloc solution: " << max_err << std::endl;
+            REQUIRE(max_err <= 1e-10);
+
+            ocp_nlp_solver_terminate(arena_solver);
+            acados_arena_reset(arena);
+            REQUIRE(acados_arena_get_used_size(arena) == 0);
+        }
+
+        // an arena without room for the solver is reported, not overrun
+        acados_arena *small_arena = acados_arena_create(ocp_nlp_in_arena_size(config, dims)
+                                                        + ocp_nlp_out_arena_size(config, dims));
+        ocp_nlp_in *small_in = ocp_nlp_in_create_in_arena(config, dims, small_arena);
+        REQUIRE(small_in != NULL);
+        REQUIRE(ocp_nlp_out_create_in_arena(config, dims, small_arena) != NULL);
+        REQUIRE(ocp_nlp_solver_create_in_arena(config, dims, nlp_opts, small_in, small_arena) == NULL);
+        REQUIRE(ocp_nlp_out_create_in_arena(config, dims, small_arena) == NULL);
+        acados_arena_destroy(small_arena);
+
+        free(x_ref);
+        free(x_arena);
+        acados_arena_destroy(arena);
+    }
+
+    /************************************************
+    * batch solve
+    ************************************************/
+
+    if (variant.batch_size > 0)
+    {
+        int n_batch = variant.batch_size;
+        int num_threads = 2;
+
+        std::vector<ocp_nlp_in *> batch_in(n_batch);
+        std::vector<ocp_nlp_out *> batch_out(n_batch), seq_out(n_batch);
+        std::vector<ocp_nlp_solver *> batch_solver(n_batch), seq_solver(n_batch);
+        std::vector<int> batch_status(n_batch);
+        std::vector<double> batch_time(n_batch);
+
+        // the initial position of the first mass differs between the instances
+        double x0_0 = lb0[NU];
+        for (int k = 0; k < n_batch; k++)
+        {
+            lb0[NU] = x0_0 + 0.05 * k;
+            ub0[NU] = x0_0 + 0.05 * k;
+            batch_in[k] = ocp_nlp_in_create(config, dims);
+            set_nlp_in_data(batch_in[k]);
+
+            batch_out[k] = ocp_nlp_out_create(config, dims);
+            seq_out[k] = ocp_nlp_out_create(config, dims);
+            batch_solver[k] = ocp_nlp_solver_create(config, dims, nlp_opts, batch_in[k]);
+            seq_solver[k] = ocp_nlp_solver_create(config, dims, nlp_opts, batch_in[k]);
+            REQUIRE(ocp_nlp_precompute(batch_solver[k], batch_in[k], batch_out[k]) == 0);
+            REQUIRE(ocp_nlp_precompute(seq_solver[k], batch_in[k], seq_out[k]) == 0);
+
+            for (int i = 0; i <= NN; i++)
+            {
+                blasfeo_pack_dvec(nu[i], uref, 1, batch_out[k]->ux+i, 0);
+                blasfeo_pack_dvec(nx[i], xref, 1, batch_out[k]->ux+i, nu[i]);
+                blasfeo_pack_dvec(nu[i], uref, 1, seq_out[k]->ux+i, 0);
+                blasfeo_pack_dvec(nx[i], xref, 1, seq_out[k]->ux+i, nu[i]);
+            }
+        }
+        lb0[NU] = x0_0;
+        ub0[NU] = x0_0;
+
+        ocp_nlp_batch_solve(batch_solver.data(), batch_in.data(), batch_out.data(), n_batch, num_threads,
+                            batch_status.data(), batch_time.data());
+
+        std::vector<double> x_seq(NX), x_batch(NX), u_seq(NU), u_batch(NU), x0_prev(NX);
+        for (int k = 0; k < n_batch; k++)
+        {
+            int seq_status = ocp_nlp_solve(seq_solver[k], batch_in[k], seq_out[k]);
+            REQUIRE(batch_status[k] == seq_status);
+            REQUIRE(batch_time[k] > 0.0);
+
+            int seq_iter, batch_iter;
+            ocp_nlp_get(seq_solver[k], "sqp_iter", &seq_iter);
+            ocp_nlp_get(batch_solver[k], "sqp_iter", &batch_iter);
+            REQUIRE(batch_iter == seq_iter);
+
+            double max_err = 0.0;
+            for (int i = 0; i <= NN; i++)
+            {
+                ocp_nlp_out_get(config, dims, seq_out[k], i, "x", x_seq.data());
+                ocp_nlp_out_get(config, dims, batch_out[k], i, "x", x_batch.data());
+                for (int j = 0; j < NX; j++)
+                    max_err = fabs(x_batch[j] - x_seq[j]) > max_err ? fabs(x_batch[j] - x_seq[j]) : max_err;
+                if (i < NN)
+                {
+                    ocp_nlp_out_get(config, dims, seq_out[k], i, "u", u_seq.data());
+                    ocp_nlp_out_get(config, dims, batch_out[k], i, "u", u_batch.data());
+                    for (int j = 0; j < NU; j++)
+                        max_err = fabs(u_batch[j] - u_seq[j]) > max_err ? fabs(u_batch[j] - u_seq[j]) : max_err;
+                }
+            }
+            std::cout << "batch instance " << k << ", max deviation from sequential solve: " << max_err << std::endl;
+            REQUIRE(max_err <= 1e-10);
+
+            // the instances are not all solved with the same x0
+            ocp_nlp_out_get(config, dims, batch_out[k], 0, "x", x_batch.data());
+            REQUIRE(fabs(x_batch[0] - (x0_0 + 0.05 * k)) <= 1e-6);
+            if (k > 0)
+                REQUIRE(fabs(x_batch[0] - x0_prev[0]) > 1e-2);
+            x0_prev = x_batch;
+        }
+
+        for (int k = 0; k < n_batch; k++)
+        {
+            ocp_nlp_solver_destroy(batch_solver[k]);
+            ocp_nlp_solver_destroy(seq_solver[k]);
+            ocp_nlp_out_destroy(batch_out[k]);
+            ocp_nlp_out_destroy(seq_out[k]);
+            ocp_nlp_in_destroy(batch_in[k]);
+        }
+    }
+
+    /************************************************
+    * output access by field id and aliasing
+    ************************************************/
+
+    if (variant.check_out_access)
+    {
+        check_nlp_out_access_by_id(config, dims, nlp_in, nlp_out);
+        check_model_field_handles(config, dims, nlp_in, nlp_out);
+
+        int alias_size = ocp_nlp_out_alias_size(config, dims);
+        REQUIRE(alias_size == ocp_nlp_out_packed_size(dims));
+
+        // keep the solution of the internal memory
+        std::vector<double> x_sol((NN+1)*NX), x_tmp(NX);
+        for (int i = 0; i <= NN; i++)
+            ocp_nlp_out_get(config, dims, nlp_out, i, "x", &x_sol[i*NX]);
+
+        // the aliased buffer is read and written through the string based accessors
+        std::vector<double> buffer(alias_size);
+        for (int j = 0; j < alias_size; j++)
+            buffer[j] = 1e-3 * j;
+        ocp_nlp_out_alias(config, dims, nlp_out, buffer.data());
+
+        int offset = 0;
+        for (int i = 0; i <= NN; i++)
+        {
+            ocp_nlp_out_get(config, dims, nlp_out, i, "x", x_tmp.data());
+            for (int j = 0; j < NX; j++)
+                REQUIRE(x_tmp[j] == buffer[offset+nu[i]+j]);
+            offset += dims->nv[i];
+        }
+        check_nlp_out_access_by_id(config, dims, nlp_in, nlp_out);
+
+        // solve from the initial guess in the aliased buffer, the solution is written to the buffer
+        for (int j = 0; j < alias_size; j++)
+            buffer[j] = 0.0;
+        pack_alias_buffer_ux(dims, xref, uref, buffer.data());
+
+        status = ocp_nlp_solve(solver, nlp_in, nlp_out);
+        REQUIRE(status == 0);
+
+        double max_err = 0.0;
+        offset = 0;
+        for (int i = 0; i <= NN; i++)
+        {
+            for (int j = 0; j < NX; j++)
+            {
+                double err = fabs(buffer[offset+nu[i]+j] - x_sol[i*NX+j]);
+                max_err = err > max_err ? err : max_err;
+            }
+            offset += dims->nv[i];
+        }
+        // the solver memory is not reset, so only agreement up to the solver tolerance is expected
+        std::cout << "aliased nlp_out, max deviation from solution: " << max_err << std::endl;
+        REQUIRE(max_err <= 1e-5);
+
+        // back to the internal memory, which still holds the solution
+        ocp_nlp_out_alias(config, dims, nlp_out, NULL);
+        for (int i = 0; i <= NN; i++)
+        {
+            ocp_nlp_out_get(config, dims, nlp_out, i, "x", x_tmp.data());
+            for (int j = 0; j < NX; j++)
+                REQUIRE(x_tmp[j] == x_sol[i*NX+j]);
+        }
+    }
+
     /************************************************
     * free memory
     ************************************************/
@@ -1434,6 +1994,8 @@ void setup_and_solve_nlp(int NN,
     // TODO(dimitris): VALGRIND!
     external_function_casadi_free(expl_vde_for);
     free(expl_vde_for);
+    if (variant.with_batch_vde)
+        external_function_casadi_batch_free(&expl_vde_for_batch);
 
     external_function_casadi_free(impl_ode_fun);
     external_function_casadi_free(impl_ode_fun_jac_x_xdot);
@@ -1554,7 +2116,7 @@ TEST_CASE("chain example", "[NLP solver]")
         cons = {"BOX", "GENERAL"};
         // cons = {"NONLINEAR+GENERAL"};
         models = {"DISCRETE", "CONTINUOUS", "MIXED"};
-        integrators = {"MIXED"};
+        integrators = {"MIXED", "ERK_BATCHED"};
         costs = {"MIXED"};
     }
 
@@ -1610,3 +2172,253 @@ TEST_CASE("chain example", "[NLP solver]")
         }  // horizon lenght
     }
 }  // TEST_CASE
+
+
+
+static void compare_chain_results(chain_nlp_result const& ref, chain_nlp_result const& res, double tol)
+{
+    REQUIRE(res.sqp_iter == ref.sqp_iter);
+    REQUIRE(res.x.size() == ref.x.size());
+    REQUIRE(res.u.size() == ref.u.size());
+
+    double max_err = 0.0;
+    for (size_t i = 0; i < ref.x.size(); i++)
+        max_err = fabs(res.x[i] - ref.x[i]) > max_err ? fabs(res.x[i] - ref.x[i]) : max_err;
+    for (size_t i = 0; i < ref.u.size(); i++)
+        max_err = fabs(res.u[i] - ref.u[i]) > max_err ? fabs(res.u[i] - ref.u[i]) : max_err;
+
+    std::cout << "max deviation from default solution: " << max_err << std::endl;
+    REQUIRE(max_err <= tol);
+}
+
+
+
+/************************************************
+* TEST CASE: stage load balancing
+************************************************/
+
+TEST_CASE("chain example stage load balancing", "[NLP solver]")
+{
+    int NN = 20;
+    int NMF = 3;
+
+    for (std::string model_str : {"CONTINUOUS", "MIXED"})
+    {
+        SECTION("Type of model: " + model_str)
+        {
+            chain_nlp_result ref, res;
+
+            setup_and_solve_nlp(NN, NMF, "BOX", "MIXED", "SPARSE_HPIPM", model_str, "MIXED",
+                                chain_nlp_variant_default(), &ref);
+
+            chain_nlp_variant variant = chain_nlp_variant_default();
+            variant.with_stage_load_balancing = true;
+            setup_and_solve_nlp(NN, NMF, "BOX", "MIXED", "SPARSE_HPIPM", model_str, "MIXED",
+                                variant, &res);
+
+            // the stages are evaluated by the same code, only the assignment to threads changes
+            compare_chain_results(ref, res, 1e-10);
+
+            // timings are only recorded with load balancing
+            for (int i = 0; i <= NN; i++)
+            {
+                REQUIRE(ref.time_lin_stage[i] == 0.0);
+                REQUIRE(res.time_lin_stage[i] > 0.0);
+            }
+        }
+    }
+}  // TEST_CASE
+
+
+
+/************************************************
+* TEST CASE: arena allocation
+************************************************/
+
+TEST_CASE("chain example arena allocation", "[NLP solver]")
+{
+    chain_nlp_variant variant = chain_nlp_variant_default();
+    variant.use_arena = true;
+
+    for (std::string qp_solver_str : {"SPARSE_HPIPM", "DENSE_HPIPM"})
+    {
+        SECTION("QP solver: " + qp_solver_str)
+        {
+            setup_and_solve_nlp(20, 3, "BOX", "MIXED", qp_solver_str, "MIXED", "MIXED", variant);
+        }
+    }
+}  // TEST_CASE
+
+
+
+/************************************************
+* TEST CASE: shared module workspaces
+************************************************/
+
+TEST_CASE("chain example workspace reuse", "[NLP solver]")
+{
+    int NN = 20;
+    int NMF = 3;
+
+    for (std::string qp_solver_str : {"SPARSE_HPIPM", "DENSE_HPIPM"})
+    {
+        SECTION("QP solver: " + qp_solver_str)
+        {
+            chain_nlp_result ref, res;
+            chain_nlp_variant variant = chain_nlp_variant_default();
+
+            // separate workspaces for all modules
+            variant.reuse_workspace = 0;
+            setup_and_solve_nlp(NN, NMF, "BOX", "MIXED", qp_solver_str, "MIXED", "MIXED", variant, &ref);
+
+            // qp solver workspace overlapping the stage and external function workspaces
+            variant.reuse_workspace = 1;
+            setup_and_solve_nlp(NN, NMF, "BOX", "MIXED", qp_solver_str, "MIXED", "MIXED", variant, &res);
+
+            compare_chain_results(ref, res, 1e-10);
+
+            std::cout << "workspace size: " << res.workspace_size << ", without reuse: "
+                      << ref.workspace_size << std::endl;
+            REQUIRE(ref.workspace_size == ref.workspace_size_summed);
+            REQUIRE(res.workspace_size_summed == ref.workspace_size_summed);
+            REQUIRE(res.workspace_size < res.workspace_size_summed);
+        }
+    }
+}  // TEST_CASE
+
+
+
+/************************************************
+* TEST CASE: output access by field id
+************************************************/
+
+TEST_CASE("chain example output access by field id", "[NLP solver]")
+{
+    chain_nlp_variant variant = chain_nlp_variant_default();
+    variant.check_out_access = true;
+
+    for (std::string con_str : {"BOX", "GENERAL"})
+    {
+        SECTION("Type of constraints: " + con_str)
+        {
+            setup_and_solve_nlp(20, 3, con_str, "MIXED", "SPARSE_HPIPM", "MIXED", "MIXED", variant);
+        }
+    }
+}  // TEST_CASE
+
+
+
+/************************************************
+* TEST CASE: concurrent line search candidates
+************************************************/
+
+TEST_CASE("chain example concurrent line search", "[NLP solver]")
+{
+    int NN = 20;
+    int NMF = 3;
+
+    for (int use_SOC : {0, 1})
+    {
+        SECTION("use_SOC: " + std::to_string(use_SOC))
+        {
+            chain_nlp_result ref, res;
+            chain_nlp_variant variant = chain_nlp_variant_default();
+            variant.use_SOC = use_SOC;
+            // contracted chain as initial guess: the springs are far from their linearization,
+            // such that full steps are rejected
+            variant.init_pos_scale = 0.1;
+
+            // one trial point at a time in the nominal memory
+            variant.line_search_num_candidates = 1;
+            setup_and_solve_nlp(NN, NMF, "BOX", "MIXED", "SPARSE_HPIPM", "CONTINUOUS", "ERK", variant, &ref);
+
+            double alpha_min = 1.0;
+            for (double alpha : ref.alpha)
+                alpha_min = alpha < alpha_min ? alpha : alpha_min;
+            std::cout << "smallest accepted step size: " << alpha_min << std::endl;
+            REQUIRE(alpha_min < 1.0);
+
+            // three trial points at a time, two of them in replicas of the stage modules;
+            // ERK has no state across calls and the merit function is summed in stage order,
+            // thus the same step sizes are accepted
+            variant.line_search_num_candidates = 3;
+            setup_and_solve_nlp(NN, NMF, "BOX", "MIXED", "SPARSE_HPIPM", "CONTINUOUS", "ERK", variant, &res);
+
+            compare_chain_results(ref, res, 1e-10);
+            REQUIRE(res.alpha == ref.alpha);
+        }
+    }
+}  // TEST_CASE
+
+
+
+/************************************************
+* TEST CASE: batched dynamics
+************************************************/
+
+static double max_abs_diff(std::vector<double> const& a, std::vector<double> const& b)
+{
+    REQUIRE(a.size() == b.size());
+    double max_err = 0.0;
+    for (size_t i = 0; i < a.size(); i++)
+        max_err = fabs(a[i] - b[i]) > max_err ? fabs(a[i] - b[i]) : max_err;
+    return max_err;
+}
+
+TEST_CASE("chain example batched dynamics", "[NLP solver]")
+{
+    int NN = 20;
+
+    for (int NMF : {2, 3})
+    {
+        SECTION("Number of masses: " + std::to_string(NMF))
+        {
+            chain_nlp_result ref;
+            chain_nlp_variant variant = chain_nlp_variant_default();
+
+            // stage-wise ERK
+            setup_and_solve_nlp(NN, NMF, "BOX", "MIXED", "SPARSE_HPIPM", "CONTINUOUS", "ERK", variant, &ref);
+            REQUIRE(ref.dynamics_batched == 0);
+
+            for (bool with_batch_vde : {false, true})
+            {
+                SECTION("with_batch_vde: " + std::to_string(with_batch_vde))
+                {
+                    chain_nlp_result res;
+                    variant.with_batch_vde = with_batch_vde;
+                    setup_and_solve_nlp(NN, NMF, "BOX", "MIXED", "SPARSE_HPIPM", "CONTINUOUS", "ERK_BATCHED",
+                                        variant, &res);
+                    REQUIRE(res.dynamics_batched == 1);
+
+                    compare_chain_results(ref, res, 1e-10);
+
+                    // BAbt, fun and, through the stationarity residual, adj of the last linearization
+                    REQUIRE(max_abs_diff(ref.A, res.A) <= 1e-10);
+                    REQUIRE(max_abs_diff(ref.B, res.B) <= 1e-10);
+                    REQUIRE(max_abs_diff(ref.b, res.b) <= 1e-10);
+                    REQUIRE(max_abs_diff(ref.res_stat, res.res_stat) <= 1e-10);
+                }
+            }
+        }
+    }
+}  // TEST_CASE
+
+
+
+/************************************************
+* TEST CASE: batch solve
+************************************************/
+
+TEST_CASE("chain example batch solve", "[NLP solver]")
+{
+    chain_nlp_variant variant = chain_nlp_variant_default();
+    variant.batch_size = 5;
+
+    for (std::string model_str : {"CONTINUOUS", "MIXED"})
+    {
+        SECTION("Type of model: " + model_str)
+        {
+            setup_and_solve_nlp(20, 3, "BOX", "MIXED", "SPARSE_HPIPM", model_str, "MIXED", variant);
+        }
+    }
+}  // TEST_CASE
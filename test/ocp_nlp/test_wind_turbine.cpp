@@ -59,6 +59,8 @@
 #include "examples/c/wt_model_nx6/nx6p2/wt_model.h"
 #include "examples/c/wt_model_nx6/setup.c"
 
+#include "test/test_utils/casadi_map.h"
+
 #define NN 40
 
 #define MAX_SQP_ITERS 15
@@ -128,6 +130,147 @@ static void shift_controls(ocp_nlp_dims *dims, ocp_nlp_out *out, double *u_end)
 
 
 
+static void require_dvec_equal(int n, struct blasfeo_dvec *x, int xi, struct blasfeo_dvec *y, int yi)
+{
+    for (int j = 0; j < n; j++)
+        REQUIRE(BLASFEO_DVECEL(x, xi+j) == BLASFEO_DVECEL(y, yi+j));
+}
+
+
+
+static void require_dvec_zero(int n, struct blasfeo_dvec *x, int xi)
+{
+    for (int j = 0; j < n; j++)
+        REQUIRE(BLASFEO_DVECEL(x, xi+j) == 0.0);
+}
+
+
+
+// shifts with ocp_nlp_shift and checks nlp_out, the QP solution and the scaled QP solution;
+// the constraints of stage 0 (x0, no h) and N-1 (h, stage N has none) differ from the next stage,
+// so their multipliers are not shifted
+static void shift_and_check(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_solver *solver, void *nlp_opts,
+                            ocp_nlp_out *nlp_out, ocp_shift_tail_policy tail_policy)
+{
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *ni = dims->ni;
+    bool keep = tail_policy == SHIFT_TAIL_KEEP;
+
+    ocp_nlp_memory *nlp_mem;
+    config->get(config, dims, solver->mem, "nlp_mem", &nlp_mem);
+    ocp_qp_out *qp_out = nlp_mem->qp_out;
+    ocp_qp_out *scaled_qp_out = nlp_mem->scaled_qp_out;
+    ocp_qp_dims *qp_dims = qp_out->dim;
+    // objective scaling only, the scaled QP solution shares ux and t with the unscaled one
+    REQUIRE(scaled_qp_out != qp_out);
+    REQUIRE(scaled_qp_out->t == qp_out->t);
+
+    ocp_nlp_out *out_prev = ocp_nlp_out_create(config, dims);
+    copy_ocp_nlp_out(dims, nlp_out, out_prev);
+    ocp_qp_out *qp_out_prev = ocp_qp_out_create(qp_dims);
+    ocp_qp_out_copy(qp_out, qp_out_prev);
+    ocp_qp_out *scaled_qp_out_prev = ocp_qp_out_create(qp_dims);
+    ocp_qp_out_copy(scaled_qp_out, scaled_qp_out_prev);
+
+    ocp_nlp_shift(solver, nlp_out, tail_policy);
+
+    for (int i = 0; i < N; i++)
+    {
+        // states
+        require_dvec_equal(nx[i], nlp_out->ux+i, nu[i], out_prev->ux+i+1, nu[i+1]);
+        require_dvec_equal(nx[i], qp_out->ux+i, nu[i], qp_out_prev->ux+i+1, nu[i+1]);
+
+        // controls, stage N has none
+        if (i < N-1)
+        {
+            require_dvec_equal(nu[i], nlp_out->ux+i, 0, out_prev->ux+i+1, 0);
+            require_dvec_equal(nu[i], qp_out->ux+i, 0, qp_out_prev->ux+i+1, 0);
+        }
+        else if (keep)
+        {
+            require_dvec_equal(nu[i], nlp_out->ux+i, 0, out_prev->ux+i, 0);
+            require_dvec_equal(nu[i], qp_out->ux+i, 0, qp_out_prev->ux+i, 0);
+        }
+        else
+        {
+            require_dvec_zero(nu[i], nlp_out->ux+i, 0);
+            require_dvec_zero(nu[i], qp_out->ux+i, 0);
+        }
+
+        // multipliers and slacks t
+        int ni_qp = qp_dims->nb[i] + qp_dims->ng[i] + qp_dims->ns[i];
+        if (i > 0 && i < N-1)
+        {
+            require_dvec_equal(2*ni[i], nlp_out->lam+i, 0, out_prev->lam+i+1, 0);
+            require_dvec_equal(2*ni_qp, qp_out->lam+i, 0, qp_out_prev->lam+i+1, 0);
+            require_dvec_equal(2*ni_qp, qp_out->t+i, 0, qp_out_prev->t+i+1, 0);
+            require_dvec_equal(2*ni_qp, scaled_qp_out->lam+i, 0, scaled_qp_out_prev->lam+i+1, 0);
+        }
+        else if (keep)
+        {
+            require_dvec_equal(2*ni[i], nlp_out->lam+i, 0, out_prev->lam+i, 0);
+            require_dvec_equal(2*ni_qp, qp_out->lam+i, 0, qp_out_prev->lam+i, 0);
+            require_dvec_equal(2*ni_qp, qp_out->t+i, 0, qp_out_prev->t+i, 0);
+            require_dvec_equal(2*ni_qp, scaled_qp_out->lam+i, 0, scaled_qp_out_prev->lam+i, 0);
+        }
+        else
+        {
+            require_dvec_zero(2*ni[i], nlp_out->lam+i, 0);
+            require_dvec_zero(2*ni_qp, qp_out->lam+i, 0);
+            require_dvec_zero(2*ni_qp, qp_out->t+i, 0);
+            require_dvec_zero(2*ni_qp, scaled_qp_out->lam+i, 0);
+        }
+
+        // equality multipliers, pi_{N-1} is the tail
+        if (i < N-1)
+        {
+            require_dvec_equal(nx[i+1], nlp_out->pi+i, 0, out_prev->pi+i+1, 0);
+            require_dvec_equal(nx[i+1], qp_out->pi+i, 0, qp_out_prev->pi+i+1, 0);
+            require_dvec_equal(nx[i+1], scaled_qp_out->pi+i, 0, scaled_qp_out_prev->pi+i+1, 0);
+        }
+        else if (keep)
+        {
+            require_dvec_equal(nx[i+1], nlp_out->pi+i, 0, out_prev->pi+i, 0);
+            require_dvec_equal(nx[i+1], qp_out->pi+i, 0, qp_out_prev->pi+i, 0);
+            require_dvec_equal(nx[i+1], scaled_qp_out->pi+i, 0, scaled_qp_out_prev->pi+i, 0);
+        }
+        else
+        {
+            require_dvec_zero(nx[i+1], nlp_out->pi+i, 0);
+            require_dvec_zero(nx[i+1], qp_out->pi+i, 0);
+            require_dvec_zero(nx[i+1], scaled_qp_out->pi+i, 0);
+        }
+    }
+
+    // last stage
+    if (keep)
+    {
+        require_dvec_equal(nx[N], nlp_out->ux+N, nu[N], out_prev->ux+N, nu[N]);
+        require_dvec_equal(2*ni[N], nlp_out->lam+N, 0, out_prev->lam+N, 0);
+    }
+    else
+    {
+        require_dvec_zero(nx[N], nlp_out->ux+N, nu[N]);
+        require_dvec_zero(2*ni[N], nlp_out->lam+N, 0);
+    }
+
+    // the condensed QP is warm started from the shifted QP solution in the next solve
+    ocp_nlp_opts *opts;
+    config->opts_get(config, dims, nlp_opts, "nlp_opts", &opts);
+    bool initialize_next_xcond_qp_from_qp_out = false;
+    config->qp_solver->opts_get(config->qp_solver, opts->qp_solver_opts,
+                                "initialize_next_xcond_qp_from_qp_out", &initialize_next_xcond_qp_from_qp_out);
+    REQUIRE(initialize_next_xcond_qp_from_qp_out);
+
+    ocp_nlp_out_destroy(out_prev);
+    free(qp_out_prev);
+    free(scaled_qp_out_prev);
+}
+
+
+
 static void select_dynamics_wt_casadi(int N,
     external_function_param_casadi *expl_vde_for,
     external_function_param_casadi *impl_ode_fun,
@@ -261,7 +404,8 @@ void ext_fun_h1(void *fun, ext_fun_arg_t *type_in, void **in, ext_fun_arg_t *typ
 
 
 
-void setup_and_solve_nlp(std::string const& integrator_str, std::string const& qp_solver_str)
+void setup_and_solve_nlp(std::string const& integrator_str, std::string const& qp_solver_str,
+                         bool with_shift = false)
 {
     // _MM_SET_EXCEPTION_MASK(_MM_GET_EXCEPTION_MASK() & ~_MM_MASK_INVALID);
     int nx_ = 8;
@@ -988,6 +1132,13 @@ void setup_and_solve_nlp(std::string const& integrator_str, std::string const& q
         ocp_nlp_solver_opts_set(config, nlp_opts, "qp_cond_N", &cond_N);
     }
 
+    // the shift also has to handle the scaled QP solution
+    if (with_shift)
+    {
+        qpscaling_scale_objective_type scale_objective = OBJECTIVE_GERSHGORIN;
+        ocp_nlp_solver_opts_set(config, nlp_opts, "qpscaling_scale_objective", &scale_objective);
+    }
+
     config->opts_update(config, dims, nlp_opts);
 
     /************************************************
@@ -1109,11 +1260,20 @@ void setup_and_solve_nlp(std::string const& integrator_str, std::string const& q
         REQUIRE(max_res <= TOL);
 
         // shift trajectories
-        blasfeo_unpack_dvec(dims->nx[NN], &nlp_out->ux[NN-1], dims->nu[NN-1], x_end, 1);
-        blasfeo_unpack_dvec(dims->nu[NN-1], &nlp_out->ux[NN-2], dims->nu[NN-2], u_end, 1);
+        if (with_shift)
+        {
+            // the last shift zeros the tail, there is no solve after it
+            shift_and_check(config, dims, solver, nlp_opts, nlp_out,
+                            idx < nmpc_problems-1 ? SHIFT_TAIL_KEEP : SHIFT_TAIL_ZERO);
+        }
+        else
+        {
+            blasfeo_unpack_dvec(dims->nx[NN], &nlp_out->ux[NN-1], dims->nu[NN-1], x_end, 1);
+            blasfeo_unpack_dvec(dims->nu[NN-1], &nlp_out->ux[NN-2], dims->nu[NN-2], u_end, 1);
 
-        shift_states(dims, nlp_out, x_end);
-        shift_controls(dims, nlp_out, u_end);
+            shift_states(dims, nlp_out, x_end);
+            shift_controls(dims, nlp_out, u_end);
+        }
     }
 
     double time = acados_toc(&timer);
@@ -1246,3 +1406,136 @@ TEST_CASE("wind turbine nmpc", "[NLP solver]")
         }
     }
 }
+
+
+
+/************************************************
+* TEST CASE: wind turbine with ocp_nlp_shift
+************************************************/
+
+TEST_CASE("wind turbine nmpc shift", "[NLP solver]")
+{
+    // partial condensing to cond_N = 10 and full condensing, both warm start the condensed QP after the shift
+    std::vector<std::string> qp_solvers = {"SPARSE_HPIPM", "DENSE_HPIPM"};
+
+    for (std::string qp_solver_str : qp_solvers)
+    {
+        SECTION("QP solver: " + qp_solver_str)
+        {
+            setup_and_solve_nlp("IRK", qp_solver_str, true);
+        }
+    }
+}
+
+
+
+/************************************************
+* TEST CASE: batched casadi external function
+************************************************/
+
+TEST_CASE("batched casadi external function", "[external functions]")
+{
+    // parametric function with sparse outputs, (x, xdot, u, p) -> (f, df/dx, df/dxdot)
+    const int nx = 8, nu = 2, np = 1;
+    const int batch_size = 4;
+
+    typedef casadi_map<0> mapped;
+    mapped::init(&wt_nx6p2_impl_ode_fun_jac_x_xdot, &wt_nx6p2_impl_ode_fun_jac_x_xdot_work,
+                 &wt_nx6p2_impl_ode_fun_jac_x_xdot_sparsity_in, &wt_nx6p2_impl_ode_fun_jac_x_xdot_sparsity_out,
+                 &wt_nx6p2_impl_ode_fun_jac_x_xdot_n_in, &wt_nx6p2_impl_ode_fun_jac_x_xdot_n_out, batch_size);
+
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+
+    external_function_casadi_batch fun_batch;
+    fun_batch.casadi_fun = &mapped::fun;
+    fun_batch.casadi_work = &mapped::work;
+    fun_batch.casadi_sparsity_in = &mapped::sparsity_in;
+    fun_batch.casadi_sparsity_out = &mapped::sparsity_out;
+    fun_batch.casadi_n_in = &mapped::get_n_in;
+    fun_batch.casadi_n_out = &mapped::get_n_out;
+    external_function_casadi_batch_create(&fun_batch, batch_size, np, &ext_fun_opts);
+
+    int np_get;
+    fun_batch.get_nparam(&fun_batch, &np_get);
+    REQUIRE(np_get == np);
+
+    external_function_param_casadi fun;
+    fun.casadi_fun = &wt_nx6p2_impl_ode_fun_jac_x_xdot;
+    fun.casadi_work = &wt_nx6p2_impl_ode_fun_jac_x_xdot_work;
+    fun.casadi_sparsity_in = &wt_nx6p2_impl_ode_fun_jac_x_xdot_sparsity_in;
+    fun.casadi_sparsity_out = &wt_nx6p2_impl_ode_fun_jac_x_xdot_sparsity_out;
+    fun.casadi_n_in = &wt_nx6p2_impl_ode_fun_jac_x_xdot_n_in;
+    fun.casadi_n_out = &wt_nx6p2_impl_ode_fun_jac_x_xdot_n_out;
+    external_function_param_casadi_create(&fun, np, &ext_fun_opts);
+
+    ext_fun_arg_t type_in[4] = {COLMAJ, COLMAJ, COLMAJ, COLMAJ};
+    ext_fun_arg_t type_out[3] = {COLMAJ, COLMAJ, COLMAJ};
+
+    // the last chunk is partial
+    for (int n_inst : {batch_size, 2 * batch_size + 3})
+    {
+        SECTION("n_inst = " + std::to_string(n_inst))
+        {
+            std::vector<double> x(n_inst * nx), xdot(n_inst * nx), u(n_inst * nu), p(n_inst * np);
+            for (int jj = 0; jj < n_inst; jj++)
+            {
+                for (int ii = 0; ii < nx; ii++)
+                {
+                    x[jj * nx + ii] = 1.0 + 0.1 * ii + 0.01 * jj;
+                    xdot[jj * nx + ii] = 0.05 * ii - 0.02 * jj;
+                }
+                for (int ii = 0; ii < nu; ii++)
+                    u[jj * nu + ii] = 0.5 + 0.1 * ii * jj;
+                p[jj] = 10.0 + jj;
+            }
+
+            int nf = nx, nJ = nx * nx;
+            std::vector<double> out_batch(n_inst * (nf + 2 * nJ), -1.0);
+            std::vector<double> out_ref(n_inst * (nf + 2 * nJ), -2.0);
+
+            std::vector<void *> in_ptr(4 * n_inst), out_ptr(3 * n_inst);
+            std::vector<void **> in_inst(n_inst), out_inst(n_inst);
+            for (int jj = 0; jj < n_inst; jj++)
+            {
+                in_ptr[4 * jj + 0] = &x[jj * nx];
+                in_ptr[4 * jj + 1] = &xdot[jj * nx];
+                in_ptr[4 * jj + 2] = &u[jj * nu];
+                in_ptr[4 * jj + 3] = &p[jj * np];
+                in_inst[jj] = &in_ptr[4 * jj];
+
+                double *out_jj = &out_batch[jj * (nf + 2 * nJ)];
+                out_ptr[3 * jj + 0] = out_jj;
+                out_ptr[3 * jj + 1] = out_jj + nf;
+                out_ptr[3 * jj + 2] = out_jj + nf + nJ;
+                out_inst[jj] = &out_ptr[3 * jj];
+            }
+
+            fun_batch.evaluate_batch(&fun_batch, n_inst, type_in, in_inst.data(), type_out, out_inst.data());
+
+            // one instance at a time, with the parameter of that instance
+            for (int jj = 0; jj < n_inst; jj++)
+            {
+                double *out_jj = &out_ref[jj * (nf + 2 * nJ)];
+                void *out_single[3] = {out_jj, out_jj + nf, out_jj + nf + nJ};
+                fun.set_param(&fun, &p[jj * np]);
+                fun.evaluate(&fun, type_in, in_inst[jj], type_out, out_single);
+            }
+
+            double max_diff = 0.0;
+            for (size_t ii = 0; ii < out_ref.size(); ii++)
+                max_diff = fmax(max_diff, fabs(out_batch[ii] - out_ref[ii]));
+            std::cout << "batched casadi function, n_inst " << n_inst << ": max diff " << max_diff << std::endl;
+            REQUIRE(max_diff <= 1e-14);
+
+            // the structural zeros of the jacobians are written as well
+            int n_zero = 0;
+            for (int ii = 0; ii < nJ; ii++)
+                n_zero += out_batch[nf + ii] == 0.0;
+            REQUIRE(n_zero > 0);
+        }
+    }
+
+    external_function_casadi_batch_free(&fun_batch);
+    external_function_param_casadi_free(&fun);
+}  // END_TEST_CASE
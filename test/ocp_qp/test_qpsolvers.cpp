@@ -29,6 +29,7 @@
  */
 
 
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -37,6 +38,7 @@
 //#include "test/test_utils/eigen.h"
 
 #include "acados_c/ocp_qp_interface.h"
+#include "acados/utils/timing.h"
 
 extern "C" {
 ocp_qp_xcond_solver_dims *create_ocp_qp_dims_mass_spring(ocp_qp_xcond_solver_config *config, int N, int nx_, int nu_, int nb_, int ng_, int ngN);
@@ -51,6 +53,8 @@ ocp_qp_solver_t hashit(std::string const &inString)
 {
     if (inString == "SPARSE_HPIPM") return PARTIAL_CONDENSING_HPIPM;
     if (inString == "DENSE_HPIPM") return FULL_CONDENSING_HPIPM;
+    if (inString == "SPARSE_PDHG") return PARTIAL_CONDENSING_PDHG;
+    if (inString == "SPARSE_PARALLEL_RICCATI") return PARTIAL_CONDENSING_PARALLEL_RICCATI;
 #ifdef ACADOS_WITH_HPMPC
     if (inString == "SPARSE_HPMPC") return PARTIAL_CONDENSING_HPMPC;
 #endif
@@ -90,6 +94,8 @@ double solver_tolerance(std::string const &inString)
     if (inString == "SPARSE_OOQP") return 1e-5;
     if (inString == "DENSE_OOQP") return 1e-5;
     if (inString == "SPARSE_OSQP") return 1e-8;
+    if (inString == "SPARSE_PDHG") return 1e-5;
+    if (inString == "SPARSE_PARALLEL_RICCATI") return 1e-8;
 
     return -1;
 }
@@ -100,7 +106,7 @@ void set_N2(std::string const &inString, ocp_qp_xcond_solver_config *config, voi
 {
     bool option_found = false;
 
-    if ( inString=="SPARSE_HPIPM" | inString=="SPARSE_HPMPC" | inString == "SPARSE_OOQP" | inString == "SPARSE_OSQP" )
+    if ( inString=="SPARSE_HPIPM" | inString=="SPARSE_HPMPC" | inString == "SPARSE_OOQP" | inString == "SPARSE_OSQP" | inString == "SPARSE_PDHG" | inString == "SPARSE_PARALLEL_RICCATI" )
     {
 		config->opts_set(config, opts, "cond_N", &N2);
     }
@@ -117,7 +123,9 @@ void set_N2(std::string const &inString, ocp_qp_xcond_solver_config *config, voi
 TEST_CASE("mass spring example", "[QP solvers]")
 {
     vector<std::string> solvers = {"DENSE_HPIPM",
-                                   "SPARSE_HPIPM"
+                                   "SPARSE_HPIPM",
+                                   "SPARSE_PDHG",
+                                   "SPARSE_PARALLEL_RICCATI"
 #ifdef ACADOS_WITH_HPMPC
                                    ,
                                    "SPARSE_HPMPC"
@@ -266,3 +274,793 @@ TEST_CASE("mass spring example", "[QP solvers]")
     }  // END_FOR_SOLVERS
 
 }  // END_TEST_CASE
+
+
+
+TEST_CASE("cond_N tuning", "[QP solvers]")
+{
+    int N = 15;
+    int candidates[] = {15, 5, 3};
+    const char *cache_file = "test_cond_N_cache.txt";
+    remove(cache_file);
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, 8, 3, 11, 0, 0);
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+    ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+    void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+
+    REQUIRE(ocp_qp_xcond_solver_load_cond_N(cache_file, qp_dims->orig_dims) == -1);
+
+    int cond_N = ocp_qp_xcond_solver_tune_cond_N(config, qp_dims, opts, qp_in, 3, candidates, 3, cache_file);
+
+    REQUIRE((cond_N == 15 || cond_N == 5 || cond_N == 3));
+
+    // the choice is persisted and reused without benchmarking
+    REQUIRE(ocp_qp_xcond_solver_load_cond_N(cache_file, qp_dims->orig_dims) == cond_N);
+    REQUIRE(ocp_qp_xcond_solver_tune_cond_N(config, qp_dims, opts, qp_in, 0, NULL, 1, cache_file) == cond_N);
+
+    // the solver created afterwards uses the chosen cond_N
+    ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+    REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+
+    ocp_qp_dims *pcond_dims;
+    config->xcond->dims_get(config->xcond, qp_dims->xcond_dims, "xcond_dims", &pcond_dims);
+    REQUIRE(pcond_dims->N == cond_N);
+
+    // the controls of all stages are distributed over the condensed stages
+    int nu_pcond = 0;
+    for (int ii = 0; ii <= cond_N; ii++)
+    {
+        int nu_stage;
+        config->dims_get(config, qp_dims, ii, "pcond_nu", &nu_stage);
+        nu_pcond += nu_stage;
+    }
+    REQUIRE(nu_pcond == 3 * N);
+
+    int iter;
+    config->memory_get(config, qp_solver->mem, "iter", &iter);
+    REQUIRE(iter > 0);
+
+    // same solution as without partial condensing
+    int cond_N_ref = N;
+    void *opts_ref = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+    config->opts_set(config, opts_ref, "cond_N", &cond_N_ref);
+    ocp_qp_solver *qp_solver_ref = ocp_qp_create(config, qp_dims, opts_ref);
+    ocp_qp_out *qp_out_ref = ocp_qp_out_create(qp_dims->orig_dims);
+    REQUIRE(ocp_qp_solve(qp_solver_ref, qp_in, qp_out_ref) == 0);
+
+    double max_diff = 0.0;
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nux = qp_dims->orig_dims->nu[ii] + qp_dims->orig_dims->nx[ii];
+        for (int jj = 0; jj < nux; jj++)
+            max_diff = fmax(max_diff, fabs(BLASFEO_DVECEL(qp_out->ux+ii, jj) - BLASFEO_DVECEL(qp_out_ref->ux+ii, jj)));
+    }
+    REQUIRE(max_diff <= 1e-8);
+
+    remove(cache_file);
+
+    free(qp_solver_ref);
+    free(qp_out_ref);
+    free(opts_ref);
+    free(qp_solver);
+    free(opts);
+    free(qp_out);
+    free(qp_in);
+    free(qp_dims);
+    free(config);
+}
+
+
+
+TEST_CASE("full condensing with unchanged matrices", "[QP solvers]")
+{
+    int N = 15;
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = FULL_CONDENSING_HPIPM;
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, 8, 3, 11, 0, 0);
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+    ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+    void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+    int skip_unchanged = 1;
+    config->opts_set(config, opts, "cond_skip_unchanged", &skip_unchanged);
+    ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+
+    int lhs_changed;
+    double res[4];
+
+    REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+    config->memory_get(config, qp_solver->mem, "lhs_changed", &lhs_changed);
+    REQUIRE(lhs_changed == 1);
+
+    // only the initial state bounds change, the Hessian is not condensed again
+    double x0[8] = {1.0, 0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    ocp_qp_in_set(config, qp_in, 0, (char *) "lbx", x0);
+    ocp_qp_in_set(config, qp_in, 0, (char *) "ubx", x0);
+
+    REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+    config->memory_get(config, qp_solver->mem, "lhs_changed", &lhs_changed);
+    REQUIRE(lhs_changed == 0);
+
+    ocp_qp_inf_norm_residuals(qp_dims->orig_dims, qp_in, qp_out, res);
+    for (int ii = 0; ii < 4; ii++)
+        REQUIRE(res[ii] <= 1e-8);
+
+    free(qp_solver);
+    free(opts);
+    free(qp_out);
+    free(qp_in);
+    free(qp_dims);
+    free(config);
+}
+
+
+
+TEST_CASE("mixed precision hpipm", "[QP solvers]")
+{
+    int N = 15;
+    int nx = 8;
+    int nu = 3;
+    int n_rep = 100;
+
+    int N2_values[] = {15, 5};
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+
+    for (int N2 : N2_values)
+    {
+        SECTION("N2 = " + std::to_string(N2))
+        {
+            ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+            ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx, nu, 11, 0, 0);
+            ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+            ocp_qp_out *qp_out_ref = ocp_qp_out_create(qp_dims->orig_dims);
+            ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+
+            // double precision reference
+            void *opts_ref = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+            set_N2("SPARSE_HPIPM", config, opts_ref, N2, N);
+            ocp_qp_solver *solver_ref = ocp_qp_create(config, qp_dims, opts_ref);
+
+            // single precision factorization with double precision refinement
+            int mixed_precision = 1;
+            void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+            set_N2("SPARSE_HPIPM", config, opts, N2, N);
+            config->opts_set(config, opts, "mixed_precision", &mixed_precision);
+            ocp_qp_solver *solver = ocp_qp_create(config, qp_dims, opts);
+
+            acados_timer timer;
+            double time_ref = 0.0, time_mp = 0.0;
+            for (int rep = 0; rep < n_rep; rep++)
+            {
+                acados_tic(&timer);
+                REQUIRE(ocp_qp_solve(solver_ref, qp_in, qp_out_ref) == 0);
+                time_ref += acados_toc(&timer);
+
+                acados_tic(&timer);
+                REQUIRE(ocp_qp_solve(solver, qp_in, qp_out) == 0);
+                time_mp += acados_toc(&timer);
+            }
+
+            int refine_iter, refine_fallback;
+            config->memory_get(config, solver->mem, "refine_iter", &refine_iter);
+            config->memory_get(config, solver->mem, "refine_fallback", &refine_fallback);
+
+            double res[4];
+            ocp_qp_inf_norm_residuals(qp_dims->orig_dims, qp_in, qp_out, res);
+            printf("\nmixed precision (N2 = %d): inf norm res: %e, %e, %e, %e\n", N2, res[0], res[1], res[2], res[3]);
+            printf("refine_iter = %d, refine_fallback = %d\n", refine_iter, refine_fallback);
+            printf("time per solve: double %e s, mixed precision %e s\n", time_ref / n_rep, time_mp / n_rep);
+
+            for (int ii = 0; ii < 4; ii++)
+                REQUIRE(res[ii] <= 1e-6);
+
+            // the refinement converged without the double precision IPM
+            REQUIRE(refine_fallback == 0);
+
+            // same solution as the double precision solver
+            ocp_qp_dims *dims = qp_dims->orig_dims;
+            double err = 0.0;
+            for (int ii = 0; ii <= N; ii++)
+            {
+                for (int jj = 0; jj < dims->nu[ii]+dims->nx[ii]; jj++)
+                {
+                    double diff = fabs(BLASFEO_DVECEL(qp_out->ux+ii, jj) - BLASFEO_DVECEL(qp_out_ref->ux+ii, jj));
+                    err = diff > err ? diff : err;
+                }
+            }
+            printf("max primal difference to double precision solution: %e\n", err);
+            REQUIRE(err <= 1e-6);
+
+            free(solver);
+            free(opts);
+            free(solver_ref);
+            free(opts_ref);
+            free(qp_out);
+            free(qp_out_ref);
+            free(qp_in);
+            free(qp_dims);
+            free(config);
+        }
+    }
+}
+
+
+
+#if defined(ACADOS_WITH_QPOASES) || defined(ACADOS_WITH_DAQP)
+TEST_CASE("dense active-set cache", "[QP solvers]")
+{
+    vector<std::string> solvers = {
+#ifdef ACADOS_WITH_QPOASES
+                                   "DENSE_QPOASES",
+#endif
+#ifdef ACADOS_WITH_DAQP
+                                   "DENSE_DAQP",
+#endif
+                                   };
+
+    int N = 15;
+    int as_cache_size = 8;
+
+    for (std::string solver : solvers)
+    {
+        SECTION(solver)
+        {
+            ocp_qp_solver_plan_t plan;
+            plan.qp_solver = hashit(solver);
+
+            ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+            ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, 8, 3, 11, 0, 0);
+            ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+            ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+            void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+            config->opts_set(config, opts, "as_cache_size", &as_cache_size);
+            ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+
+            int hit, num_hits;
+            double res[4];
+            double x0[8] = {1.0, 0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+            double x0_k[8];
+
+            // a sequence of initial states, as in closed loop
+            for (int kk = 0; kk < 4; kk++)
+            {
+                for (int ii = 0; ii < 8; ii++)
+                    x0_k[ii] = (1.0 - 0.2 * kk) * x0[ii];
+                ocp_qp_in_set(config, qp_in, 0, (char *) "lbx", x0_k);
+                ocp_qp_in_set(config, qp_in, 0, (char *) "ubx", x0_k);
+
+                REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+                ocp_qp_inf_norm_residuals(qp_dims->orig_dims, qp_in, qp_out, res);
+                for (int ii = 0; ii < 4; ii++)
+                    REQUIRE(res[ii] <= 1e-8);
+            }
+
+            // the active set of the first initial state is still cached
+            ocp_qp_in_set(config, qp_in, 0, (char *) "lbx", x0);
+            ocp_qp_in_set(config, qp_in, 0, (char *) "ubx", x0);
+
+            REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+            config->memory_get(config, qp_solver->mem, "as_cache_hit", &hit);
+            config->memory_get(config, qp_solver->mem, "as_cache_num_hits", &num_hits);
+            REQUIRE(hit == 1);
+            REQUIRE(num_hits >= 1);
+
+            ocp_qp_inf_norm_residuals(qp_dims->orig_dims, qp_in, qp_out, res);
+            for (int ii = 0; ii < 4; ii++)
+                REQUIRE(res[ii] <= 1e-8);
+
+            free(qp_solver);
+            free(opts);
+            free(qp_out);
+            free(qp_in);
+            free(qp_dims);
+            free(config);
+        }  // END_SECTION
+    }  // END_FOR_SOLVERS
+}  // END_TEST_CASE
+#endif
+
+
+
+TEST_CASE("pdhg general constraints, warm start and maxiter", "[QP solvers]")
+{
+    int N = 15;
+    int nx = 8;
+    int nu = 3;
+    int ng = 1;
+
+    ocp_qp_solver_plan_t plan;
+
+    // reference solution
+    plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+    ocp_qp_xcond_solver_config *config_ref = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims_ref = create_ocp_qp_dims_mass_spring(config_ref, N, nx, nu, 11, ng, 0);
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims_ref->orig_dims);
+    // the general constraints are zero, make them u_0 + u_1 = 0, such that they are active everywhere
+    double D[3] = {1.0, 1.0, 0.0};
+    for (int ii = 0; ii < N; ii++)
+        ocp_qp_in_set(config_ref, qp_in, ii, (char *) "D", D);
+    ocp_qp_out *qp_out_ref = ocp_qp_out_create(qp_dims_ref->orig_dims);
+    void *opts_ref = ocp_qp_xcond_solver_opts_create(config_ref, qp_dims_ref);
+    ocp_qp_solver *qp_solver_ref = ocp_qp_create(config_ref, qp_dims_ref, opts_ref);
+    REQUIRE(ocp_qp_solve(qp_solver_ref, qp_in, qp_out_ref) == 0);
+
+    plan.qp_solver = PARTIAL_CONDENSING_PDHG;
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx, nu, 11, ng, 0);
+    ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+    void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+    double tol = 1e-7;
+    config->opts_set(config, opts, "tol_stat", &tol);
+    config->opts_set(config, opts, "tol_eq", &tol);
+    config->opts_set(config, opts, "tol_ineq", &tol);
+    config->opts_set(config, opts, "tol_comp", &tol);
+    ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+
+    int status, iter_cold, iter_warm;
+    double res[4], res_comp;
+
+    REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+    config->memory_get(config, qp_solver->mem, "iter", &iter_cold);
+    config->memory_get(config, qp_solver->mem, "res_comp", &res_comp);
+    REQUIRE(res_comp <= tol);
+
+    ocp_qp_inf_norm_residuals(qp_dims->orig_dims, qp_in, qp_out, res);
+    printf("\npdhg with general constraints: %d iterations, inf norm res: %e, %e, %e, %e\n",
+           iter_cold, res[0], res[1], res[2], res[3]);
+    for (int ii = 0; ii < 4; ii++)
+        REQUIRE(res[ii] <= 1e-5);
+
+    double max_diff = 0.0;
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nv = qp_dims->orig_dims->nu[ii] + qp_dims->orig_dims->nx[ii];
+        for (int jj = 0; jj < nv; jj++)
+            max_diff = fmax(max_diff, fabs(BLASFEO_DVECEL(qp_out->ux+ii, jj) - BLASFEO_DVECEL(qp_out_ref->ux+ii, jj)));
+    }
+    REQUIRE(max_diff <= 1e-5);
+    for (int ii = 0; ii < N; ii++)
+        REQUIRE(fabs(BLASFEO_DVECEL(qp_out->ux+ii, 0) + BLASFEO_DVECEL(qp_out->ux+ii, 1)) <= 1e-5);
+
+    // warm start from the primal and dual solution: converged at the first check
+    int warm_start = 2;
+    config->opts_set(config, opts, "warm_start", &warm_start);
+    REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+    config->memory_get(config, qp_solver->mem, "iter", &iter_warm);
+    REQUIRE(iter_warm < iter_cold);
+
+    // cold start with a too small iteration budget
+    warm_start = 0;
+    int iter_max = 5;
+    config->opts_set(config, opts, "warm_start", &warm_start);
+    config->opts_set(config, opts, "iter_max", &iter_max);
+    status = ocp_qp_solve(qp_solver, qp_in, qp_out);
+    REQUIRE(status == ACADOS_MAXITER);
+    config->memory_get(config, qp_solver->mem, "status", &status);
+    REQUIRE(status == ACADOS_MAXITER);
+    config->memory_get(config, qp_solver->mem, "iter", &iter_warm);
+    REQUIRE(iter_warm == iter_max);
+
+    free(qp_solver);
+    free(opts);
+    free(qp_out);
+    free(qp_dims);
+    free(config);
+    free(qp_solver_ref);
+    free(opts_ref);
+    free(qp_out_ref);
+    free(qp_in);
+    free(qp_dims_ref);
+    free(config_ref);
+}
+
+
+
+TEST_CASE("shift qp_out", "[QP solvers]")
+{
+    int N = 15;
+    int nx = 8;
+    int nu = 3;
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx, nu, 11, 0, 0);
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+    ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+    void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+    ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+
+    REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+
+    ocp_qp_out *qp_out_prev = ocp_qp_out_create(qp_dims->orig_dims);
+    ocp_qp_out_copy(qp_out, qp_out_prev);
+
+    ocp_qp_out_shift(qp_in, qp_out, SHIFT_TAIL_KEEP);
+
+    ocp_qp_dims *dims = qp_dims->orig_dims;
+    for (int i = 0; i < N; i++)
+    {
+        // multipliers, stage N has no bounds on u, so the ones of stage N-1 are kept
+        int ni = dims->nb[i] + dims->ng[i] + dims->ns[i];
+        for (int j = 0; j < 2*ni; j++)
+            REQUIRE(BLASFEO_DVECEL(qp_out->lam+i, j) == BLASFEO_DVECEL(qp_out_prev->lam+(i+1 < N ? i+1 : i), j));
+        // states
+        for (int j = 0; j < nx; j++)
+            REQUIRE(BLASFEO_DVECEL(qp_out->ux+i, nu+j) == BLASFEO_DVECEL(qp_out_prev->ux+i+1, (i+1 < N ? nu : 0)+j));
+        // controls, the last one has no successor
+        for (int j = 0; j < nu; j++)
+            REQUIRE(BLASFEO_DVECEL(qp_out->ux+i, j) == BLASFEO_DVECEL(qp_out_prev->ux+(i+1 < N ? i+1 : i), j));
+    }
+    for (int j = 0; j < nx; j++)
+        REQUIRE(BLASFEO_DVECEL(qp_out->ux+N, j) == BLASFEO_DVECEL(qp_out_prev->ux+N, j));
+    // equality multipliers, pi_{N-1} is the tail and kept
+    for (int i = 0; i < N; i++)
+    {
+        for (int j = 0; j < nx; j++)
+            REQUIRE(BLASFEO_DVECEL(qp_out->pi+i, j) == BLASFEO_DVECEL(qp_out_prev->pi+(i+1 < N ? i+1 : i), j));
+    }
+
+    ocp_qp_out_shift(qp_in, qp_out, SHIFT_TAIL_ZERO);
+
+    for (int j = 0; j < nx; j++)
+        REQUIRE(BLASFEO_DVECEL(qp_out->ux+N, j) == 0.0);
+    for (int j = 0; j < nu; j++)
+        REQUIRE(BLASFEO_DVECEL(qp_out->ux+N-1, j) == 0.0);
+    for (int j = 0; j < nx; j++)
+        REQUIRE(BLASFEO_DVECEL(qp_out->pi+N-1, j) == 0.0);
+    for (int j = 0; j < 2*(dims->nb[N-1]+dims->ng[N-1]+dims->ns[N-1]); j++)
+    {
+        REQUIRE(BLASFEO_DVECEL(qp_out->lam+N-1, j) == 0.0);
+        REQUIRE(BLASFEO_DVECEL(qp_out->t+N-1, j) == 0.0);
+    }
+
+    free(qp_out_prev);
+    free(qp_solver);
+    free(opts);
+    free(qp_out);
+    free(qp_in);
+    free(qp_dims);
+    free(config);
+}
+
+
+
+#ifdef ACADOS_WITH_OSQP
+static double max_diff_ux(int N, ocp_qp_out *out, ocp_qp_out *out_ref, int nux)
+{
+    double err = 0.0;
+    for (int ii = 0; ii <= N; ii++)
+    {
+        for (int jj = 0; jj < nux; jj++)
+        {
+            double diff = fabs(BLASFEO_DVECEL(out->ux+ii, jj) - BLASFEO_DVECEL(out_ref->ux+ii, jj));
+            err = diff > err ? diff : err;
+        }
+    }
+    return err;
+}
+
+
+
+TEST_CASE("osqp sparsity detection", "[QP solvers]")
+{
+    int N = 15;
+    int nx = 8;
+    int nu = 3;
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_OSQP;
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx, nu, 11, 0, 0);
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+    ocp_qp_out *qp_out_ref = ocp_qp_out_create(qp_dims->orig_dims);
+    ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+
+    // dense blocks passed to OSQP
+    void *opts_ref = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+    set_N2("SPARSE_OSQP", config, opts_ref, N, N);
+    ocp_qp_solver *solver_ref = ocp_qp_create(config, qp_dims, opts_ref);
+
+    // only the nonzeros passed to OSQP
+    int sparsity_detection = 1;
+    void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+    set_N2("SPARSE_OSQP", config, opts, N, N);
+    config->opts_set(config, opts, "sparsity_detection", &sparsity_detection);
+    ocp_qp_solver *solver = ocp_qp_create(config, qp_dims, opts);
+
+    int P_nnz_ref, P_nnz, P_nnz_first;
+    double res[4];
+
+    REQUIRE(ocp_qp_solve(solver_ref, qp_in, qp_out_ref) == 0);
+    REQUIRE(ocp_qp_solve(solver, qp_in, qp_out) == 0);
+
+    config->memory_get(config, solver_ref->mem, "P_nnz", &P_nnz_ref);
+    config->memory_get(config, solver->mem, "P_nnz", &P_nnz_first);
+    REQUIRE(P_nnz_first < P_nnz_ref);
+    REQUIRE(max_diff_ux(N, qp_out, qp_out_ref, nu+nx) <= 1e-6);
+
+    // couple two states in the cost of one stage, the pattern of P grows
+    double Q[8*8] = {0};
+    for (int ii = 0; ii < nx; ii++)
+        Q[ii * (nx + 1)] = 1.0;
+    Q[1] = 0.1;
+    Q[nx] = 0.1;
+    ocp_qp_in_set(config, qp_in, 5, (char *) "Q", Q);
+
+    REQUIRE(ocp_qp_solve(solver_ref, qp_in, qp_out_ref) == 0);
+    REQUIRE(ocp_qp_solve(solver, qp_in, qp_out) == 0);
+
+    config->memory_get(config, solver->mem, "P_nnz", &P_nnz);
+    REQUIRE(P_nnz > P_nnz_first);
+    REQUIRE(P_nnz < P_nnz_ref);
+
+    ocp_qp_inf_norm_residuals(qp_dims->orig_dims, qp_in, qp_out, res);
+    for (int ii = 0; ii < 4; ii++)
+        REQUIRE(res[ii] <= 1e-8);
+    REQUIRE(max_diff_ux(N, qp_out, qp_out_ref, nu+nx) <= 1e-6);
+
+    free(solver);
+    free(opts);
+    free(solver_ref);
+    free(opts_ref);
+    free(qp_out);
+    free(qp_out_ref);
+    free(qp_in);
+    free(qp_dims);
+    free(config);
+}
+#endif
+
+
+
+#if defined(ACADOS_WITH_OSQP) || defined(ACADOS_WITH_DAQP)
+TEST_CASE("skip unchanged matrices", "[QP solvers]")
+{
+    vector<std::string> solvers = {
+#ifdef ACADOS_WITH_OSQP
+                                   "SPARSE_OSQP",
+#endif
+#ifdef ACADOS_WITH_DAQP
+                                   "DENSE_DAQP",
+#endif
+                                   };
+
+    int N = 15;
+    int nx = 8;
+    int nu = 3;
+
+    for (std::string solver : solvers)
+    {
+        SECTION(solver)
+        {
+            ocp_qp_solver_plan_t plan;
+            plan.qp_solver = hashit(solver);
+
+            ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+            ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx, nu, 11, 0, 0);
+            ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+            ocp_qp_out *qp_out_ref = ocp_qp_out_create(qp_dims->orig_dims);
+            ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+
+            // matrices updated in every solve
+            void *opts_ref = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+            set_N2(solver, config, opts_ref, N, N);
+            ocp_qp_solver *solver_ref = ocp_qp_create(config, qp_dims, opts_ref);
+
+            int skip_unchanged = 1;
+            void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+            set_N2(solver, config, opts, N, N);
+            config->opts_set(config, opts, "skip_unchanged", &skip_unchanged);
+            ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+
+            int matrices_changed;
+            double res[4];
+
+            REQUIRE(ocp_qp_solve(solver_ref, qp_in, qp_out_ref) == 0);
+            REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+            config->memory_get(config, qp_solver->mem, "matrices_changed", &matrices_changed);
+            REQUIRE(matrices_changed == 1);
+
+            // only the initial state bounds change
+            double x0[8] = {1.0, 0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+            ocp_qp_in_set(config, qp_in, 0, (char *) "lbx", x0);
+            ocp_qp_in_set(config, qp_in, 0, (char *) "ubx", x0);
+
+            REQUIRE(ocp_qp_solve(solver_ref, qp_in, qp_out_ref) == 0);
+            REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+            config->memory_get(config, qp_solver->mem, "matrices_changed", &matrices_changed);
+            REQUIRE(matrices_changed == 0);
+
+            ocp_qp_inf_norm_residuals(qp_dims->orig_dims, qp_in, qp_out, res);
+            for (int ii = 0; ii < 4; ii++)
+                REQUIRE(res[ii] <= solver_tolerance(solver));
+
+            // same solution as with the matrix update
+            double err = 0.0;
+            for (int ii = 0; ii <= N; ii++)
+            {
+                for (int jj = 0; jj < nu+nx; jj++)
+                {
+                    double diff = fabs(BLASFEO_DVECEL(qp_out->ux+ii, jj) - BLASFEO_DVECEL(qp_out_ref->ux+ii, jj));
+                    err = diff > err ? diff : err;
+                }
+            }
+            REQUIRE(err <= 1e-10);
+
+            free(qp_solver);
+            free(opts);
+            free(solver_ref);
+            free(opts_ref);
+            free(qp_out);
+            free(qp_out_ref);
+            free(qp_in);
+            free(qp_dims);
+            free(config);
+        }  // END_SECTION
+    }  // END_FOR_SOLVERS
+}  // END_TEST_CASE
+#endif
+
+
+
+TEST_CASE("partial condensing of blocks in parallel", "[QP solvers]")
+{
+    int N = 15;
+    int nx = 8;
+    int nu = 3;
+
+    int N2_values[] = {5, 3};
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+
+    for (int N2 : N2_values)
+    {
+        SECTION("N2 = " + std::to_string(N2))
+        {
+            ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+            ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx, nu, 11, 0, 0);
+            ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+            ocp_qp_out *qp_out_ref = ocp_qp_out_create(qp_dims->orig_dims);
+            ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+
+            // serial condensing and expansion in hpipm
+            int num_threads_ref = 1;
+            void *opts_ref = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+            set_N2("SPARSE_HPIPM", config, opts_ref, N2, N);
+            config->opts_set(config, opts_ref, "cond_num_threads", &num_threads_ref);
+            ocp_qp_solver *solver_ref = ocp_qp_create(config, qp_dims, opts_ref);
+
+            // blocks condensed and expanded in parallel (if built with openmp)
+            int num_threads = 4;
+            void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+            set_N2("SPARSE_HPIPM", config, opts, N2, N);
+            config->opts_set(config, opts, "cond_num_threads", &num_threads);
+            ocp_qp_solver *solver = ocp_qp_create(config, qp_dims, opts);
+
+            REQUIRE(ocp_qp_solve(solver_ref, qp_in, qp_out_ref) == 0);
+            REQUIRE(ocp_qp_solve(solver, qp_in, qp_out) == 0);
+
+            // same primal and dual solution, including pi at the last stage of each block
+            ocp_qp_dims *dims = qp_dims->orig_dims;
+            double err_ux = 0.0, err_pi = 0.0, err_lam = 0.0;
+            for (int ii = 0; ii <= N; ii++)
+            {
+                for (int jj = 0; jj < dims->nu[ii]+dims->nx[ii]; jj++)
+                    err_ux = fmax(err_ux, fabs(BLASFEO_DVECEL(qp_out->ux+ii, jj) - BLASFEO_DVECEL(qp_out_ref->ux+ii, jj)));
+                for (int jj = 0; jj < 2*dims->nb[ii]+2*dims->ng[ii]; jj++)
+                    err_lam = fmax(err_lam, fabs(BLASFEO_DVECEL(qp_out->lam+ii, jj) - BLASFEO_DVECEL(qp_out_ref->lam+ii, jj)));
+            }
+            for (int ii = 0; ii < N; ii++)
+            {
+                for (int jj = 0; jj < dims->nx[ii+1]; jj++)
+                    err_pi = fmax(err_pi, fabs(BLASFEO_DVECEL(qp_out->pi+ii, jj) - BLASFEO_DVECEL(qp_out_ref->pi+ii, jj)));
+            }
+            printf("\nN2 = %d: difference to serial partial condensing: ux %e, pi %e, lam %e\n", N2, err_ux, err_pi, err_lam);
+            REQUIRE(err_ux <= 1e-10);
+            REQUIRE(err_pi <= 1e-10);
+            REQUIRE(err_lam <= 1e-10);
+
+            free(solver);
+            free(opts);
+            free(solver_ref);
+            free(opts_ref);
+            free(qp_out);
+            free(qp_out_ref);
+            free(qp_in);
+            free(qp_dims);
+            free(config);
+        }
+    }
+}
+
+
+
+TEST_CASE("parallel riccati segments", "[QP solvers]")
+{
+    int N = 15;
+    int nx = 8;
+    int nu = 3;
+
+    ocp_qp_solver_plan_t plan_ref;
+    plan_ref.qp_solver = PARTIAL_CONDENSING_HPIPM;
+    ocp_qp_xcond_solver_config *config_ref = ocp_qp_xcond_solver_config_create(plan_ref);
+    ocp_qp_xcond_solver_dims *qp_dims_ref = create_ocp_qp_dims_mass_spring(config_ref, N, nx, nu, 11, 0, 0);
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims_ref->orig_dims);
+    ocp_qp_out *qp_out_ref = ocp_qp_out_create(qp_dims_ref->orig_dims);
+
+    // hpipm on the uncondensed qp as reference
+    void *opts_ref = ocp_qp_xcond_solver_opts_create(config_ref, qp_dims_ref);
+    set_N2("SPARSE_HPIPM", config_ref, opts_ref, N, N);
+    ocp_qp_solver *solver_ref = ocp_qp_create(config_ref, qp_dims_ref, opts_ref);
+    REQUIRE(ocp_qp_solve(solver_ref, qp_in, qp_out_ref) == 0);
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_PARALLEL_RICCATI;
+
+    for (int num_segments : {2, 3, N})
+    {
+        SECTION("num_segments = " + std::to_string(num_segments))
+        {
+            ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+            ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx, nu, 11, 0, 0);
+            ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+
+            void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+            set_N2("SPARSE_PARALLEL_RICCATI", config, opts, N, N);
+            config->opts_set(config, opts, "num_segments", &num_segments);
+            ocp_qp_solver *solver = ocp_qp_create(config, qp_dims, opts);
+
+            REQUIRE(ocp_qp_solve(solver, qp_in, qp_out) == 0);
+
+            int num_segments_used;
+            config->memory_get(config, solver->mem, "num_segments", &num_segments_used);
+            REQUIRE(num_segments_used == num_segments);
+
+            // same primal and dual solution as hpipm
+            ocp_qp_dims *dims = qp_dims->orig_dims;
+            double err_ux = 0.0, err_pi = 0.0, err_lam = 0.0;
+            for (int ii = 0; ii <= N; ii++)
+            {
+                for (int jj = 0; jj < dims->nu[ii]+dims->nx[ii]; jj++)
+                    err_ux = fmax(err_ux, fabs(BLASFEO_DVECEL(qp_out->ux+ii, jj) - BLASFEO_DVECEL(qp_out_ref->ux+ii, jj)));
+                for (int jj = 0; jj < 2*dims->nb[ii]+2*dims->ng[ii]; jj++)
+                    err_lam = fmax(err_lam, fabs(BLASFEO_DVECEL(qp_out->lam+ii, jj) - BLASFEO_DVECEL(qp_out_ref->lam+ii, jj)));
+            }
+            for (int ii = 0; ii < N; ii++)
+            {
+                for (int jj = 0; jj < dims->nx[ii+1]; jj++)
+                    err_pi = fmax(err_pi, fabs(BLASFEO_DVECEL(qp_out->pi+ii, jj) - BLASFEO_DVECEL(qp_out_ref->pi+ii, jj)));
+            }
+            printf("\nnum_segments = %d: difference to hpipm: ux %e, pi %e, lam %e\n", num_segments, err_ux, err_pi, err_lam);
+            REQUIRE(err_ux <= 1e-6);
+            REQUIRE(err_pi <= 1e-6);
+            REQUIRE(err_lam <= 1e-6);
+
+            free(solver);
+            free(opts);
+            free(qp_out);
+            free(qp_dims);
+            free(config);
+        }
+    }
+
+    free(solver_ref);
+    free(opts_ref);
+    free(qp_out_ref);
+    free(qp_in);
+    free(qp_dims_ref);
+    free(config_ref);
+}  // END_TEST_CASE
@@ -709,3 +709,402 @@ TEST_CASE("crane_dae_example", "[integrators]")
     external_function_casadi_free(&get_matrices_fun);
 
 }  // END_TEST_CASE
+
+
+
+TEST_CASE("crane_dae_simplified_newton", "[integrators]")
+{
+    int nx = 9;
+    int nu = 2;
+    int nz = 2;
+    int NF = nx + nu;
+
+    double x0[nx];
+    for (int ii = 0; ii < nx; ii++)
+        x0[ii] = 0.0;
+    x0[0] = 0.8;
+
+    double u_sim[2] = {40.108149413030752, -50.446662212534974};
+    double T = 0.01;
+    int n_rep = 100;
+
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+
+    // impl_ode_fun
+    external_function_casadi impl_ode_fun;
+    impl_ode_fun.casadi_fun = &crane_dae_impl_ode_fun;
+    impl_ode_fun.casadi_work = &crane_dae_impl_ode_fun_work;
+    impl_ode_fun.casadi_sparsity_in = &crane_dae_impl_ode_fun_sparsity_in;
+    impl_ode_fun.casadi_sparsity_out = &crane_dae_impl_ode_fun_sparsity_out;
+    impl_ode_fun.casadi_n_in = &crane_dae_impl_ode_fun_n_in;
+    impl_ode_fun.casadi_n_out = &crane_dae_impl_ode_fun_n_out;
+    external_function_casadi_create(&impl_ode_fun, &ext_fun_opts);
+
+    // impl_ode_fun_jac_x_xdot
+    external_function_casadi impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_fun = &crane_dae_impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_work = &crane_dae_impl_ode_fun_jac_x_xdot_work;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_in = &crane_dae_impl_ode_fun_jac_x_xdot_sparsity_in;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_out = &crane_dae_impl_ode_fun_jac_x_xdot_sparsity_out;
+    impl_ode_fun_jac_x_xdot.casadi_n_in = &crane_dae_impl_ode_fun_jac_x_xdot_n_in;
+    impl_ode_fun_jac_x_xdot.casadi_n_out = &crane_dae_impl_ode_fun_jac_x_xdot_n_out;
+    external_function_casadi_create(&impl_ode_fun_jac_x_xdot, &ext_fun_opts);
+
+    // impl_ode_jac_x_xdot_u
+    external_function_casadi impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_fun = &crane_dae_impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_work = &crane_dae_impl_ode_jac_x_xdot_u_work;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_in = &crane_dae_impl_ode_jac_x_xdot_u_sparsity_in;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_out = &crane_dae_impl_ode_jac_x_xdot_u_sparsity_out;
+    impl_ode_jac_x_xdot_u.casadi_n_in = &crane_dae_impl_ode_jac_x_xdot_u_n_in;
+    impl_ode_jac_x_xdot_u.casadi_n_out = &crane_dae_impl_ode_jac_x_xdot_u_n_out;
+    external_function_casadi_create(&impl_ode_jac_x_xdot_u, &ext_fun_opts);
+
+    for (int num_stages = 2; num_stages < 5; num_stages++)
+    {
+    SECTION("num_stages = " + std::to_string(num_stages))
+    {
+        double xn[2][nx];
+        double S_forw[2][nx*NF];
+        double cpu_time[2];
+
+        // 0: full Newton, 1: simplified Newton
+        for (int simplified = 0; simplified < 2; simplified++)
+        {
+            sim_solver_plan_t plan;
+            plan.sim_solver = IRK;
+
+            sim_config *config = sim_config_create(plan);
+            void *dims = sim_dims_create(config);
+
+            sim_dims_set(config, dims, "nx", &nx);
+            sim_dims_set(config, dims, "nu", &nu);
+            sim_dims_set(config, dims, "nz", &nz);
+
+            void *opts_ = sim_opts_create(config, dims);
+            sim_opts *opts = (sim_opts *) opts_;
+            config->opts_initialize_default(config, dims, opts);
+
+            opts->ns = num_stages;
+            opts->num_steps = 3;
+            opts->newton_iter = 8;
+            opts->jac_reuse = true;
+            opts->sens_forw = true;
+            opts->sens_adj = false;
+            opts->output_z = false;
+            opts->sens_algebraic = false;
+            opts->sens_hess = false;
+
+            bool simplified_newton = (bool) simplified;
+            sim_opts_set(config, opts, "simplified_newton", &simplified_newton);
+
+            sim_in *in = sim_in_create(config, dims);
+            sim_out *out = sim_out_create(config, dims);
+
+            in->T = T;
+            sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+            sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot);
+            sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+
+            for (int ii = 0; ii < nx * NF; ii++)
+                in->S_forw[ii] = 0.0;
+            for (int ii = 0; ii < nx; ii++)
+                in->S_forw[ii * (nx + 1)] = 1.0;
+
+            for (int jj = 0; jj < nx; jj++)
+                in->x[jj] = x0[jj];
+            for (int jj = 0; jj < nu; jj++)
+                in->u[jj] = u_sim[jj];
+
+            sim_solver *sim_solver = sim_solver_create(config, dims, opts, in);
+            sim_precompute(sim_solver, in, out);
+
+            acados_timer timer;
+            acados_tic(&timer);
+            for (int rep = 0; rep < n_rep; rep++)
+            {
+                int acados_return = sim_solve(sim_solver, in, out);
+                REQUIRE(acados_return == 0);
+            }
+            cpu_time[simplified] = acados_toc(&timer) / n_rep;
+
+            for (int jj = 0; jj < nx; jj++)
+                xn[simplified][jj] = out->xn[jj];
+            for (int jj = 0; jj < nx*NF; jj++)
+                S_forw[simplified][jj] = out->S_forw[jj];
+
+            sim_config_destroy(config);
+            sim_dims_destroy(dims);
+            sim_opts_destroy(opts);
+            sim_in_destroy(in);
+            sim_out_destroy(out);
+            sim_solver_destroy(sim_solver);
+        }
+
+        double error[nx*NF];
+        for (int jj = 0; jj < nx; jj++)
+            error[jj] = fabs(xn[1][jj] - xn[0][jj]);
+        double rel_error_x = onenorm(nx, 1, error) / onenorm(nx, 1, xn[0]);
+
+        for (int jj = 0; jj < nx*NF; jj++)
+            error[jj] = fabs(S_forw[1][jj] - S_forw[0][jj]);
+        double rel_error_forw = onenorm(nx, NF, error) / onenorm(nx, NF, S_forw[0]);
+
+        std::cout << "\n---> crane_dae_simplified_newton num_stages = " << num_stages << "\n";
+        std::cout << "cpu time full Newton       = " << 1e6 * cpu_time[0] << " us\n";
+        std::cout << "cpu time simplified Newton = " << 1e6 * cpu_time[1] << " us\n";
+        std::cout << "rel_error_sim  = " << rel_error_x << "\n";
+        std::cout << "rel_error_forw = " << rel_error_forw << "\n";
+
+        REQUIRE(rel_error_x <= 1e-8);
+        REQUIRE(rel_error_forw <= 1e-8);
+    }  // end SECTION
+    }  // end for num_stages
+
+    external_function_casadi_free(&impl_ode_fun);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&impl_ode_jac_x_xdot_u);
+}  // END_TEST_CASE
+
+
+
+TEST_CASE("crane_dae_gnsf_hessian_finite_differences", "[integrators]")
+{
+    int nx = 9;
+    int nu = 2;
+    int nz = 2;
+    int nout = 1;
+    int ny = 4;
+    int nuhat = 1;
+    int nx1 = 5;
+    int nz1 = 0;
+    int NF = nx + nu;
+
+    double x0[nx];
+    for (int ii = 0; ii < nx; ii++)
+        x0[ii] = 0.0;
+    x0[0] = 0.8;
+
+    double u_sim[2] = {40.108149413030752, -50.446662212534974};
+    double T = 0.01;
+    double FD_EPS = 1e-6;
+
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+
+    // phi_fun
+    external_function_casadi phi_fun;
+    phi_fun.casadi_fun = &crane_dae_phi_fun;
+    phi_fun.casadi_work = &crane_dae_phi_fun_work;
+    phi_fun.casadi_sparsity_in = &crane_dae_phi_fun_sparsity_in;
+    phi_fun.casadi_sparsity_out = &crane_dae_phi_fun_sparsity_out;
+    phi_fun.casadi_n_in = &crane_dae_phi_fun_n_in;
+    phi_fun.casadi_n_out = &crane_dae_phi_fun_n_out;
+    external_function_casadi_create(&phi_fun, &ext_fun_opts);
+
+    // phi_fun_jac_y
+    external_function_casadi phi_fun_jac_y;
+    phi_fun_jac_y.casadi_fun = &crane_dae_phi_fun_jac_y;
+    phi_fun_jac_y.casadi_work = &crane_dae_phi_fun_jac_y_work;
+    phi_fun_jac_y.casadi_sparsity_in = &crane_dae_phi_fun_jac_y_sparsity_in;
+    phi_fun_jac_y.casadi_sparsity_out = &crane_dae_phi_fun_jac_y_sparsity_out;
+    phi_fun_jac_y.casadi_n_in = &crane_dae_phi_fun_jac_y_n_in;
+    phi_fun_jac_y.casadi_n_out = &crane_dae_phi_fun_jac_y_n_out;
+    external_function_casadi_create(&phi_fun_jac_y, &ext_fun_opts);
+
+    // phi_jac_y_uhat
+    external_function_casadi phi_jac_y_uhat;
+    phi_jac_y_uhat.casadi_fun = &crane_dae_phi_jac_y_uhat;
+    phi_jac_y_uhat.casadi_work = &crane_dae_phi_jac_y_uhat_work;
+    phi_jac_y_uhat.casadi_sparsity_in = &crane_dae_phi_jac_y_uhat_sparsity_in;
+    phi_jac_y_uhat.casadi_sparsity_out = &crane_dae_phi_jac_y_uhat_sparsity_out;
+    phi_jac_y_uhat.casadi_n_in = &crane_dae_phi_jac_y_uhat_n_in;
+    phi_jac_y_uhat.casadi_n_out = &crane_dae_phi_jac_y_uhat_n_out;
+    external_function_casadi_create(&phi_jac_y_uhat, &ext_fun_opts);
+
+    // f_lo_fun_jac_x1k1uz
+    external_function_casadi f_lo_fun_jac_x1k1uz;
+    f_lo_fun_jac_x1k1uz.casadi_fun = &crane_dae_f_lo_fun_jac_x1k1uz;
+    f_lo_fun_jac_x1k1uz.casadi_work = &crane_dae_f_lo_fun_jac_x1k1uz_work;
+    f_lo_fun_jac_x1k1uz.casadi_sparsity_in = &crane_dae_f_lo_fun_jac_x1k1uz_sparsity_in;
+    f_lo_fun_jac_x1k1uz.casadi_sparsity_out = &crane_dae_f_lo_fun_jac_x1k1uz_sparsity_out;
+    f_lo_fun_jac_x1k1uz.casadi_n_in = &crane_dae_f_lo_fun_jac_x1k1uz_n_in;
+    f_lo_fun_jac_x1k1uz.casadi_n_out = &crane_dae_f_lo_fun_jac_x1k1uz_n_out;
+    external_function_casadi_create(&f_lo_fun_jac_x1k1uz, &ext_fun_opts);
+
+    // get_matrices_fun
+    external_function_casadi get_matrices_fun;
+    get_matrices_fun.casadi_fun = &crane_dae_get_matrices_fun;
+    get_matrices_fun.casadi_work = &crane_dae_get_matrices_fun_work;
+    get_matrices_fun.casadi_sparsity_in = &crane_dae_get_matrices_fun_sparsity_in;
+    get_matrices_fun.casadi_sparsity_out = &crane_dae_get_matrices_fun_sparsity_out;
+    get_matrices_fun.casadi_n_in = &crane_dae_get_matrices_fun_n_in;
+    get_matrices_fun.casadi_n_out = &crane_dae_get_matrices_fun_n_out;
+    external_function_casadi_create(&get_matrices_fun, &ext_fun_opts);
+
+    // phi_hess
+    external_function_casadi phi_hess;
+    phi_hess.casadi_fun = &crane_dae_phi_hess;
+    phi_hess.casadi_work = &crane_dae_phi_hess_work;
+    phi_hess.casadi_sparsity_in = &crane_dae_phi_hess_sparsity_in;
+    phi_hess.casadi_sparsity_out = &crane_dae_phi_hess_sparsity_out;
+    phi_hess.casadi_n_in = &crane_dae_phi_hess_n_in;
+    phi_hess.casadi_n_out = &crane_dae_phi_hess_n_out;
+    external_function_casadi_create(&phi_hess, &ext_fun_opts);
+
+    // f_lo_hess
+    external_function_casadi f_lo_hess;
+    f_lo_hess.casadi_fun = &crane_dae_f_lo_hess;
+    f_lo_hess.casadi_work = &crane_dae_f_lo_hess_work;
+    f_lo_hess.casadi_sparsity_in = &crane_dae_f_lo_hess_sparsity_in;
+    f_lo_hess.casadi_sparsity_out = &crane_dae_f_lo_hess_sparsity_out;
+    f_lo_hess.casadi_n_in = &crane_dae_f_lo_hess_n_in;
+    f_lo_hess.casadi_n_out = &crane_dae_f_lo_hess_n_out;
+    external_function_casadi_create(&f_lo_hess, &ext_fun_opts);
+
+    for (int num_stages = 1; num_stages < 5; num_stages++)
+    {
+    SECTION("num_stages = " + std::to_string(num_stages))
+    {
+        for (int sens_forw = 0; sens_forw < 2; sens_forw++)
+        {
+        SECTION("sens_forw = " + std::to_string(sens_forw))
+        {
+            sim_solver_plan_t plan;
+            plan.sim_solver = GNSF;
+
+            sim_config *config = sim_config_create(plan);
+            void *dims = sim_dims_create(config);
+
+            sim_dims_set(config, dims, "nx", &nx);
+            sim_dims_set(config, dims, "nu", &nu);
+            sim_dims_set(config, dims, "nz", &nz);
+            sim_dims_set(config, dims, "nx1", &nx1);
+            sim_dims_set(config, dims, "nz1", &nz1);
+            sim_dims_set(config, dims, "nout", &nout);
+            sim_dims_set(config, dims, "ny", &ny);
+            sim_dims_set(config, dims, "nuhat", &nuhat);
+
+            void *opts_ = sim_opts_create(config, dims);
+            sim_opts *opts = (sim_opts *) opts_;
+            config->opts_initialize_default(config, dims, opts);
+
+            opts->ns = num_stages;
+            opts->num_steps = 3;
+            opts->newton_iter = 8;
+            opts->jac_reuse = false;
+            opts->sens_forw = (bool) sens_forw;
+            opts->sens_adj = true;
+            opts->sens_hess = true;
+            opts->output_z = false;
+            opts->sens_algebraic = false;
+
+            sim_in *in = sim_in_create(config, dims);
+            sim_out *out = sim_out_create(config, dims);
+
+            sim_in_set(config, dims, in, "T", &T);
+            sim_in_set(config, dims, in, "phi_fun", &phi_fun);
+            sim_in_set(config, dims, in, "phi_fun_jac_y", &phi_fun_jac_y);
+            sim_in_set(config, dims, in, "phi_jac_y_uhat", &phi_jac_y_uhat);
+            sim_in_set(config, dims, in, "f_lo_jac_x1_x1dot_u_z", &f_lo_fun_jac_x1k1uz);
+            sim_in_set(config, dims, in, "get_gnsf_matrices", &get_matrices_fun);
+            sim_in_set(config, dims, in, "phi_hess", &phi_hess);
+            sim_in_set(config, dims, in, "f_lo_hess", &f_lo_hess);
+
+            // seeds forw
+            for (int ii = 0; ii < nx * NF; ii++)
+                in->S_forw[ii] = 0.0;
+            for (int ii = 0; ii < nx; ii++)
+                in->S_forw[ii * (nx + 1)] = 1.0;
+            in->identity_seed = true;
+
+            // seeds adj
+            for (int ii = 0; ii < nx; ii++)
+                in->S_adj[ii] = 1.0 + 0.1 * ii;
+            for (int ii = nx; ii < nx + nu; ii++)
+                in->S_adj[ii] = 0.0;
+
+            sim_solver *sim_solver = sim_solver_create(config, dims, opts, in);
+            sim_precompute(sim_solver, in, out);
+
+            // nominal solve
+            for (int jj = 0; jj < nx; jj++)
+                in->x[jj] = x0[jj];
+            for (int jj = 0; jj < nu; jj++)
+                in->u[jj] = u_sim[jj];
+
+            int acados_return = sim_solve(sim_solver, in, out);
+            REQUIRE(acados_return == 0);
+
+            double S_hess[NF*NF];
+            for (int jj = 0; jj < NF*NF; jj++)
+            {
+                REQUIRE(std::isnan(out->S_hess[jj]) == 0);
+                S_hess[jj] = out->S_hess[jj];
+            }
+
+            // central finite differences of the adjoint sensitivities
+            double S_hess_fd[NF*NF];
+            double S_adj_plus[NF];
+            for (int kk = 0; kk < NF; kk++)
+            {
+                double *w = kk < nx ? &in->x[kk] : &in->u[kk - nx];
+                double w0 = *w;
+
+                *w = w0 + FD_EPS;
+                acados_return = sim_solve(sim_solver, in, out);
+                REQUIRE(acados_return == 0);
+                for (int jj = 0; jj < NF; jj++)
+                    S_adj_plus[jj] = out->S_adj[jj];
+
+                *w = w0 - FD_EPS;
+                acados_return = sim_solve(sim_solver, in, out);
+                REQUIRE(acados_return == 0);
+                for (int jj = 0; jj < NF; jj++)
+                    S_hess_fd[kk*NF + jj] = (S_adj_plus[jj] - out->S_adj[jj]) / (2 * FD_EPS);
+
+                *w = w0;
+            }
+
+            double error[NF*NF];
+            double error_sym[NF*NF];
+            for (int ii = 0; ii < NF; ii++)
+            {
+                for (int jj = 0; jj < NF; jj++)
+                {
+                    error[ii*NF + jj] = fabs(S_hess[ii*NF + jj] - S_hess_fd[ii*NF + jj]);
+                    error_sym[ii*NF + jj] = fabs(S_hess[ii*NF + jj] - S_hess[jj*NF + ii]);
+                }
+            }
+            double norm_S_hess = onenorm(NF, NF, S_hess);
+            double rel_error_hess = onenorm(NF, NF, error) / norm_S_hess;
+            double rel_error_sym = onenorm(NF, NF, error_sym) / norm_S_hess;
+
+            std::cout << "\n---> crane_dae_gnsf_hessian num_stages = " << num_stages
+                      << ", sens_forw = " << sens_forw << "\n";
+            std::cout << "rel_error_hess = " << rel_error_hess << "\n";
+            std::cout << "rel_error_sym  = " << rel_error_sym << "\n";
+
+            REQUIRE(rel_error_hess <= 1e-5);
+            REQUIRE(rel_error_sym <= 1e-12);
+
+            sim_config_destroy(config);
+            sim_dims_destroy(dims);
+            sim_opts_destroy(opts);
+            sim_in_destroy(in);
+            sim_out_destroy(out);
+            sim_solver_destroy(sim_solver);
+        }  // end SECTION
+        }  // end for sens_forw
+    }  // end SECTION
+    }  // end for num_stages
+
+    external_function_casadi_free(&phi_fun);
+    external_function_casadi_free(&phi_fun_jac_y);
+    external_function_casadi_free(&phi_jac_y_uhat);
+    external_function_casadi_free(&f_lo_fun_jac_x1k1uz);
+    external_function_casadi_free(&get_matrices_fun);
+    external_function_casadi_free(&phi_hess);
+    external_function_casadi_free(&f_lo_hess);
+}  // END_TEST_CASE
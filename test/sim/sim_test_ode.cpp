@@ -604,3 +604,873 @@ TEST_CASE("wt_nx3_example", "[integrators]")
     external_function_casadi_free(&get_matrices_fun);
 
 }  // END_TEST_CASE
+
+
+
+TEST_CASE("wt_nx3_adaptive_step", "[integrators]")
+{
+    vector<std::string> solvers = {"ERK", "IRK"};
+
+    int ii, jj;
+
+    const int nx = 3;
+    const int nu = 4;
+    int NF = nx + nu;  // columns of forward seed
+
+    double T = 0.05;  // simulation time
+
+    double x_ref_sol[nx];
+    double S_forw_ref_sol[nx*NF];
+    double S_adj_ref_sol[NF];
+
+    /************************************************
+    * external functions
+    ************************************************/
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+    ext_fun_opts.external_workspace = true;
+
+    // expl_ode_fun
+    external_function_casadi expl_ode_fun;
+    expl_ode_fun.casadi_fun = &casadi_expl_ode_fun;
+    expl_ode_fun.casadi_work = &casadi_expl_ode_fun_work;
+    expl_ode_fun.casadi_sparsity_in = &casadi_expl_ode_fun_sparsity_in;
+    expl_ode_fun.casadi_sparsity_out = &casadi_expl_ode_fun_sparsity_out;
+    expl_ode_fun.casadi_n_in = &casadi_expl_ode_fun_n_in;
+    expl_ode_fun.casadi_n_out = &casadi_expl_ode_fun_n_out;
+    external_function_casadi_create(&expl_ode_fun, &ext_fun_opts);
+
+    // expl_vde_for
+    external_function_casadi expl_vde_for;
+    expl_vde_for.casadi_fun = &casadi_expl_vde_for;
+    expl_vde_for.casadi_work = &casadi_expl_vde_for_work;
+    expl_vde_for.casadi_sparsity_in = &casadi_expl_vde_for_sparsity_in;
+    expl_vde_for.casadi_sparsity_out = &casadi_expl_vde_for_sparsity_out;
+    expl_vde_for.casadi_n_in = &casadi_expl_vde_for_n_in;
+    expl_vde_for.casadi_n_out = &casadi_expl_vde_for_n_out;
+    external_function_casadi_create(&expl_vde_for, &ext_fun_opts);
+
+    // expl_vde_adj
+    external_function_casadi expl_vde_adj;
+    expl_vde_adj.casadi_fun = &casadi_expl_vde_adj;
+    expl_vde_adj.casadi_work = &casadi_expl_vde_adj_work;
+    expl_vde_adj.casadi_sparsity_in = &casadi_expl_vde_adj_sparsity_in;
+    expl_vde_adj.casadi_sparsity_out = &casadi_expl_vde_adj_sparsity_out;
+    expl_vde_adj.casadi_n_in = &casadi_expl_vde_adj_n_in;
+    expl_vde_adj.casadi_n_out = &casadi_expl_vde_adj_n_out;
+    external_function_casadi_create(&expl_vde_adj, &ext_fun_opts);
+
+    // impl_ode_fun
+    external_function_casadi impl_ode_fun;
+    impl_ode_fun.casadi_fun = &casadi_impl_ode_fun;
+    impl_ode_fun.casadi_work = &casadi_impl_ode_fun_work;
+    impl_ode_fun.casadi_sparsity_in = &casadi_impl_ode_fun_sparsity_in;
+    impl_ode_fun.casadi_sparsity_out = &casadi_impl_ode_fun_sparsity_out;
+    impl_ode_fun.casadi_n_in = &casadi_impl_ode_fun_n_in;
+    impl_ode_fun.casadi_n_out = &casadi_impl_ode_fun_n_out;
+    external_function_casadi_create(&impl_ode_fun, &ext_fun_opts);
+
+    // impl_ode_fun_jac_x_xdot
+    external_function_casadi impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_fun = &casadi_impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_work = &casadi_impl_ode_fun_jac_x_xdot_work;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_in = &casadi_impl_ode_fun_jac_x_xdot_sparsity_in;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_out = &casadi_impl_ode_fun_jac_x_xdot_sparsity_out;
+    impl_ode_fun_jac_x_xdot.casadi_n_in = &casadi_impl_ode_fun_jac_x_xdot_n_in;
+    impl_ode_fun_jac_x_xdot.casadi_n_out = &casadi_impl_ode_fun_jac_x_xdot_n_out;
+    external_function_casadi_create(&impl_ode_fun_jac_x_xdot, &ext_fun_opts);
+
+    // impl_ode_jac_x_xdot_u
+    external_function_casadi impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_fun = &casadi_impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_work = &casadi_impl_ode_jac_x_xdot_u_work;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_in = &casadi_impl_ode_jac_x_xdot_u_sparsity_in;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_out = &casadi_impl_ode_jac_x_xdot_u_sparsity_out;
+    impl_ode_jac_x_xdot_u.casadi_n_in = &casadi_impl_ode_jac_x_xdot_u_n_in;
+    impl_ode_jac_x_xdot_u.casadi_n_out = &casadi_impl_ode_jac_x_xdot_u_n_out;
+    external_function_casadi_create(&impl_ode_jac_x_xdot_u, &ext_fun_opts);
+
+    /************************************************
+    * reference solution, fixed steps
+    ************************************************/
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = IRK;
+
+    sim_config *config = sim_config_create(plan);
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+
+    sim_opts *opts = (sim_opts *) sim_opts_create(config, dims);
+    opts->sens_forw = true;
+    opts->sens_adj = true;
+    opts->jac_reuse = false;
+    opts->newton_iter = 5;
+    opts->num_steps = 10;
+    opts->ns = 5;
+
+    sim_in *in = sim_in_create(config, dims);
+    sim_out *out = sim_out_create(config, dims);
+    in->T = T;
+
+    sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+    sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot);
+    sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+
+    for (ii = 0; ii < nx * NF; ii++)
+        in->S_forw[ii] = 0.0;
+    for (ii = 0; ii < nx; ii++)
+        in->S_forw[ii * (nx + 1)] = 1.0;
+    for (ii = 0; ii < nx; ii++)
+        in->S_adj[ii] = 1.0;
+    for (jj = 0; jj < nx; jj++)
+        in->x[jj] = x0[jj];
+    for (jj = 0; jj < nu; jj++)
+        in->u[jj] = u_sim[jj];
+
+    sim_solver *sim_solver = sim_solver_create(config, dims, opts, in);
+    REQUIRE(sim_solve(sim_solver, in, out) == 0);
+
+    for (jj = 0; jj < nx; jj++)
+        x_ref_sol[jj] = out->xn[jj];
+    for (jj = 0; jj < nx*NF; jj++)
+        S_forw_ref_sol[jj] = out->S_forw[jj];
+    for (jj = 0; jj < NF; jj++)
+        S_adj_ref_sol[jj] = out->S_adj[jj];
+
+    sim_config_destroy(config);
+    sim_dims_destroy(dims);
+    sim_opts_destroy(opts);
+    sim_in_destroy(in);
+    sim_out_destroy(out);
+    sim_solver_destroy(sim_solver);
+
+    /************************************************
+    * adaptive step size
+    ************************************************/
+
+    for (std::string solver : solvers)
+    {
+        SECTION(solver)
+        {
+            plan.sim_solver = hashitsim(solver);
+
+            sim_config *config = sim_config_create(plan);
+            void *dims = sim_dims_create(config);
+            sim_dims_set(config, dims, "nx", &nx);
+            sim_dims_set(config, dims, "nu", &nu);
+
+            sim_opts *opts = (sim_opts *) sim_opts_create(config, dims);
+            opts->sens_forw = true;
+            opts->sens_adj = true;
+            opts->num_steps = 1;  // initial step size T
+            opts->newton_iter = 5;
+            opts->ns = 2;
+
+            bool adaptive_step = true;
+            int num_steps_max = 50;
+            double step_tol = 1e-8;
+            sim_opts_set(config, opts, "adaptive_step", &adaptive_step);
+            sim_opts_set(config, opts, "num_steps_max", &num_steps_max);
+            sim_opts_set(config, opts, "step_tol", &step_tol);
+
+            sim_in *in = sim_in_create(config, dims);
+            sim_out *out = sim_out_create(config, dims);
+            in->T = T;
+
+            if (plan.sim_solver == ERK)
+            {
+                sim_in_set(config, dims, in, "expl_ode_fun", &expl_ode_fun);
+                sim_in_set(config, dims, in, "expl_vde_for", &expl_vde_for);
+                sim_in_set(config, dims, in, "expl_vde_adj", &expl_vde_adj);
+            }
+            else
+            {
+                sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+                sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot);
+                sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+            }
+
+            sim_solver = sim_solver_create(config, dims, opts, in);
+            sim_precompute(sim_solver, in, out);
+
+            // second call starts from the step size proposed by the first one
+            for (int kk = 0; kk < 2; kk++)
+            {
+                for (ii = 0; ii < nx * NF; ii++)
+                    in->S_forw[ii] = 0.0;
+                for (ii = 0; ii < nx; ii++)
+                    in->S_forw[ii * (nx + 1)] = 1.0;
+                for (ii = 0; ii < nx; ii++)
+                    in->S_adj[ii] = 1.0;
+                for (jj = 0; jj < nx; jj++)
+                    in->x[jj] = x0[jj];
+                for (jj = 0; jj < nu; jj++)
+                    in->u[jj] = u_sim[jj];
+
+                REQUIRE(sim_solve(sim_solver, in, out) == 0);
+
+                int steps_accepted, steps_rejected, step_cap_reached;
+                config->memory_get(config, dims, sim_solver->mem, "steps_accepted", &steps_accepted);
+                config->memory_get(config, dims, sim_solver->mem, "steps_rejected", &steps_rejected);
+                config->memory_get(config, dims, sim_solver->mem, "step_cap_reached", &step_cap_reached);
+
+                double max_error = 0.0, max_error_forw = 0.0, max_error_adj = 0.0;
+                for (jj = 0; jj < nx; jj++)
+                    max_error = fmax(max_error, fabs(out->xn[jj] - x_ref_sol[jj]));
+                for (jj = 0; jj < nx*NF; jj++)
+                    max_error_forw = fmax(max_error_forw, fabs(out->S_forw[jj] - S_forw_ref_sol[jj]));
+                for (jj = 0; jj < NF; jj++)
+                    max_error_adj = fmax(max_error_adj, fabs(out->S_adj[jj] - S_adj_ref_sol[jj]));
+
+                std::cout << "\n---> sim_test_ode adaptive: " << solver << " call " << kk
+                          << ": steps accepted " << steps_accepted << ", rejected " << steps_rejected
+                          << "\nerror_sim   = " << max_error
+                          << "\nerror_forw  = " << max_error_forw
+                          << "\nerror_adj   = " << max_error_adj << "\n";
+
+                REQUIRE(steps_accepted >= 1);
+                REQUIRE(steps_accepted + steps_rejected <= num_steps_max);
+                REQUIRE(step_cap_reached == 0);
+                REQUIRE(max_error <= 1e-6);
+                REQUIRE(max_error_forw <= 1e-5);
+                REQUIRE(max_error_adj <= 1e-5);
+            }
+
+            // a tight cap on the number of steps bounds the work and is reported
+            num_steps_max = 2;
+            step_tol = 1e-12;
+            sim_solver_destroy(sim_solver);
+            sim_opts_set(config, opts, "num_steps_max", &num_steps_max);
+            sim_opts_set(config, opts, "step_tol", &step_tol);
+            sim_solver = sim_solver_create(config, dims, opts, in);
+            sim_precompute(sim_solver, in, out);
+
+            for (jj = 0; jj < nx; jj++)
+                in->x[jj] = x0[jj];
+            REQUIRE(sim_solve(sim_solver, in, out) == 0);
+
+            int steps_accepted, step_cap_reached;
+            config->memory_get(config, dims, sim_solver->mem, "steps_accepted", &steps_accepted);
+            config->memory_get(config, dims, sim_solver->mem, "step_cap_reached", &step_cap_reached);
+            REQUIRE(steps_accepted <= num_steps_max);
+            REQUIRE(step_cap_reached == 1);
+            for (jj = 0; jj < nx; jj++)
+                REQUIRE(std::isnan(out->xn[jj]) == 0);
+
+            sim_config_destroy(config);
+            sim_dims_destroy(dims);
+            sim_opts_destroy(opts);
+            sim_in_destroy(in);
+            sim_out_destroy(out);
+            sim_solver_destroy(sim_solver);
+        }  // end section
+    }  // END FOR SOLVERS
+
+    external_function_casadi_free(&expl_ode_fun);
+    external_function_casadi_free(&expl_vde_for);
+    external_function_casadi_free(&expl_vde_adj);
+    external_function_casadi_free(&impl_ode_fun);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&impl_ode_jac_x_xdot_u);
+
+}  // END_TEST_CASE
+
+
+
+TEST_CASE("wt_nx3_jac_reuse_across_calls", "[integrators]")
+{
+    vector<std::string> sens_modes = {"exact_sens", "inexact_sens"};
+
+    int ii, jj;
+
+    const int nx = 3;
+    const int nu = 4;
+    int NF = nx + nu;  // columns of forward seed
+
+    double T = 0.05;  // simulation time
+    int num_calls = 4;
+
+    /************************************************
+    * external functions
+    ************************************************/
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+    ext_fun_opts.external_workspace = true;
+
+    // impl_ode_fun
+    external_function_casadi impl_ode_fun;
+    impl_ode_fun.casadi_fun = &casadi_impl_ode_fun;
+    impl_ode_fun.casadi_work = &casadi_impl_ode_fun_work;
+    impl_ode_fun.casadi_sparsity_in = &casadi_impl_ode_fun_sparsity_in;
+    impl_ode_fun.casadi_sparsity_out = &casadi_impl_ode_fun_sparsity_out;
+    impl_ode_fun.casadi_n_in = &casadi_impl_ode_fun_n_in;
+    impl_ode_fun.casadi_n_out = &casadi_impl_ode_fun_n_out;
+    external_function_casadi_create(&impl_ode_fun, &ext_fun_opts);
+
+    // impl_ode_fun_jac_x_xdot
+    external_function_casadi impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_fun = &casadi_impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_work = &casadi_impl_ode_fun_jac_x_xdot_work;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_in = &casadi_impl_ode_fun_jac_x_xdot_sparsity_in;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_out = &casadi_impl_ode_fun_jac_x_xdot_sparsity_out;
+    impl_ode_fun_jac_x_xdot.casadi_n_in = &casadi_impl_ode_fun_jac_x_xdot_n_in;
+    impl_ode_fun_jac_x_xdot.casadi_n_out = &casadi_impl_ode_fun_jac_x_xdot_n_out;
+    external_function_casadi_create(&impl_ode_fun_jac_x_xdot, &ext_fun_opts);
+
+    // impl_ode_jac_x_xdot_u
+    external_function_casadi impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_fun = &casadi_impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_work = &casadi_impl_ode_jac_x_xdot_u_work;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_in = &casadi_impl_ode_jac_x_xdot_u_sparsity_in;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_out = &casadi_impl_ode_jac_x_xdot_u_sparsity_out;
+    impl_ode_jac_x_xdot_u.casadi_n_in = &casadi_impl_ode_jac_x_xdot_u_n_in;
+    impl_ode_jac_x_xdot_u.casadi_n_out = &casadi_impl_ode_jac_x_xdot_u_n_out;
+    external_function_casadi_create(&impl_ode_jac_x_xdot_u, &ext_fun_opts);
+
+    for (std::string sens_mode : sens_modes)
+    {
+        SECTION(sens_mode)
+        {
+            bool sens_jac_reuse = sens_mode == "inexact_sens";
+
+            sim_solver_plan_t plan;
+            plan.sim_solver = IRK;
+
+            sim_config *config = sim_config_create(plan);
+            void *dims = sim_dims_create(config);
+            sim_dims_set(config, dims, "nx", &nx);
+            sim_dims_set(config, dims, "nu", &nu);
+
+            // reference: factorization within a call only
+            sim_opts *opts_ref = (sim_opts *) sim_opts_create(config, dims);
+            opts_ref->sens_forw = true;
+            opts_ref->newton_iter = 8;
+            opts_ref->num_steps = 3;
+            opts_ref->ns = 3;
+
+            // factorization kept across calls, e.g. SQP iterations
+            sim_opts *opts = (sim_opts *) sim_opts_create(config, dims);
+            opts->sens_forw = true;
+            opts->newton_iter = 8;
+            opts->num_steps = 3;
+            opts->ns = 3;
+            bool jac_reuse_across_calls = true;
+            sim_opts_set(config, opts, "jac_reuse_across_calls", &jac_reuse_across_calls);
+            sim_opts_set(config, opts, "sens_jac_reuse", &sens_jac_reuse);
+
+            sim_in *in = sim_in_create(config, dims);
+            sim_out *out_ref = sim_out_create(config, dims);
+            sim_out *out = sim_out_create(config, dims);
+            in->T = T;
+
+            sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+            sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot);
+            sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+
+            sim_solver *sim_solver_ref = sim_solver_create(config, dims, opts_ref, in);
+            sim_solver *sim_solver = sim_solver_create(config, dims, opts, in);
+
+            for (int kk = 0; kk < num_calls; kk++)
+            {
+                // small changes of the linearization point, as between SQP iterations
+                for (ii = 0; ii < nx * NF; ii++)
+                    in->S_forw[ii] = 0.0;
+                for (ii = 0; ii < nx; ii++)
+                    in->S_forw[ii * (nx + 1)] = 1.0;
+                for (jj = 0; jj < nx; jj++)
+                    in->x[jj] = x0[jj] * (1.0 + 0.01 * kk);
+                for (jj = 0; jj < nu; jj++)
+                    in->u[jj] = u_sim[jj];
+
+                REQUIRE(sim_solve(sim_solver_ref, in, out_ref) == 0);
+                REQUIRE(sim_solve(sim_solver, in, out) == 0);
+
+                int jac_factorizations, jac_factorizations_skipped;
+                config->memory_get(config, dims, sim_solver->mem, "jac_factorizations",
+                                   &jac_factorizations);
+                config->memory_get(config, dims, sim_solver->mem, "jac_factorizations_skipped",
+                                   &jac_factorizations_skipped);
+
+                double max_error = 0.0, max_error_forw = 0.0;
+                for (jj = 0; jj < nx; jj++)
+                    max_error = fmax(max_error, fabs(out->xn[jj] - out_ref->xn[jj]));
+                for (jj = 0; jj < nx*NF; jj++)
+                    max_error_forw = fmax(max_error_forw, fabs(out->S_forw[jj] - out_ref->S_forw[jj]));
+
+                std::cout << "\n---> sim_test_ode jac_reuse_across_calls: " << sens_mode << " call " << kk
+                          << ": factorizations " << jac_factorizations
+                          << ", skipped " << jac_factorizations_skipped
+                          << "\nerror_sim   = " << max_error
+                          << "\nerror_forw  = " << max_error_forw << "\n";
+
+                if (kk > 0)
+                    REQUIRE(jac_factorizations_skipped >= 1);
+                REQUIRE(max_error <= 1e-10);
+                if (sens_jac_reuse)
+                    REQUIRE(max_error_forw <= 1e-3);
+                else
+                    REQUIRE(max_error_forw <= 1e-10);
+            }
+
+            sim_config_destroy(config);
+            sim_dims_destroy(dims);
+            sim_opts_destroy(opts_ref);
+            sim_opts_destroy(opts);
+            sim_in_destroy(in);
+            sim_out_destroy(out_ref);
+            sim_out_destroy(out);
+            sim_solver_destroy(sim_solver_ref);
+            sim_solver_destroy(sim_solver);
+        }  // end section
+    }  // END FOR SENS MODES
+
+    external_function_casadi_free(&impl_ode_fun);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&impl_ode_jac_x_xdot_u);
+
+}  // END_TEST_CASE
+
+
+
+TEST_CASE("wt_nx3_gnsf_jac_reuse_across_calls", "[integrators]")
+{
+    vector<std::string> sens_modes = {"exact_sens", "inexact_sens"};
+
+    int ii, jj;
+
+    const int nx = 3;
+    const int nu = 4;
+    int NF = nx + nu;  // columns of forward seed
+
+    double T = 0.05;  // simulation time
+    int num_calls = 4;
+
+    // gnsf dimensions
+    int nx1 = nx;
+    int nz1 = 0;
+    int ny = nx;
+    int nuhat = nu;
+    int nout = 1;
+    int nz = 0;
+
+    /************************************************
+    * external functions (Generalized Nonlinear Static Feedback (GNSF) model)
+    ************************************************/
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+    ext_fun_opts.external_workspace = true;
+
+    // phi_fun
+    external_function_casadi phi_fun;
+    phi_fun.casadi_fun            = &casadi_phi_fun;
+    phi_fun.casadi_work           = &casadi_phi_fun_work;
+    phi_fun.casadi_sparsity_in    = &casadi_phi_fun_sparsity_in;
+    phi_fun.casadi_sparsity_out   = &casadi_phi_fun_sparsity_out;
+    phi_fun.casadi_n_in           = &casadi_phi_fun_n_in;
+    phi_fun.casadi_n_out          = &casadi_phi_fun_n_out;
+    external_function_casadi_create(&phi_fun, &ext_fun_opts);
+
+    // phi_fun_jac_y
+    external_function_casadi phi_fun_jac_y;
+    phi_fun_jac_y.casadi_fun            = &casadi_phi_fun_jac_y;
+    phi_fun_jac_y.casadi_work           = &casadi_phi_fun_jac_y_work;
+    phi_fun_jac_y.casadi_sparsity_in    = &casadi_phi_fun_jac_y_sparsity_in;
+    phi_fun_jac_y.casadi_sparsity_out   = &casadi_phi_fun_jac_y_sparsity_out;
+    phi_fun_jac_y.casadi_n_in           = &casadi_phi_fun_jac_y_n_in;
+    phi_fun_jac_y.casadi_n_out          = &casadi_phi_fun_jac_y_n_out;
+    external_function_casadi_create(&phi_fun_jac_y, &ext_fun_opts);
+
+    // phi_jac_y_uhat
+    external_function_casadi phi_jac_y_uhat;
+    phi_jac_y_uhat.casadi_fun                = &casadi_phi_jac_y_uhat;
+    phi_jac_y_uhat.casadi_work               = &casadi_phi_jac_y_uhat_work;
+    phi_jac_y_uhat.casadi_sparsity_in        = &casadi_phi_jac_y_uhat_sparsity_in;
+    phi_jac_y_uhat.casadi_sparsity_out       = &casadi_phi_jac_y_uhat_sparsity_out;
+    phi_jac_y_uhat.casadi_n_in               = &casadi_phi_jac_y_uhat_n_in;
+    phi_jac_y_uhat.casadi_n_out              = &casadi_phi_jac_y_uhat_n_out;
+    external_function_casadi_create(&phi_jac_y_uhat, &ext_fun_opts);
+
+    // f_lo_fun_jac_x1k1uz
+    external_function_casadi f_lo_fun_jac_x1k1uz;
+    f_lo_fun_jac_x1k1uz.casadi_fun            = &casadi_f_lo_fun_jac_x1k1uz;
+    f_lo_fun_jac_x1k1uz.casadi_work           = &casadi_f_lo_fun_jac_x1k1uz_work;
+    f_lo_fun_jac_x1k1uz.casadi_sparsity_in    = &casadi_f_lo_fun_jac_x1k1uz_sparsity_in;
+    f_lo_fun_jac_x1k1uz.casadi_sparsity_out   = &casadi_f_lo_fun_jac_x1k1uz_sparsity_out;
+    f_lo_fun_jac_x1k1uz.casadi_n_in           = &casadi_f_lo_fun_jac_x1k1uz_n_in;
+    f_lo_fun_jac_x1k1uz.casadi_n_out          = &casadi_f_lo_fun_jac_x1k1uz_n_out;
+    external_function_casadi_create(&f_lo_fun_jac_x1k1uz, &ext_fun_opts);
+
+    // get_matrices_fun
+    external_function_casadi get_matrices_fun;
+    get_matrices_fun.casadi_fun            = &casadi_get_matrices_fun;
+    get_matrices_fun.casadi_work           = &casadi_get_matrices_fun_work;
+    get_matrices_fun.casadi_sparsity_in    = &casadi_get_matrices_fun_sparsity_in;
+    get_matrices_fun.casadi_sparsity_out   = &casadi_get_matrices_fun_sparsity_out;
+    get_matrices_fun.casadi_n_in           = &casadi_get_matrices_fun_n_in;
+    get_matrices_fun.casadi_n_out          = &casadi_get_matrices_fun_n_out;
+    external_function_casadi_create(&get_matrices_fun, &ext_fun_opts);
+
+    for (std::string sens_mode : sens_modes)
+    {
+        SECTION(sens_mode)
+        {
+            bool sens_jac_reuse = sens_mode == "inexact_sens";
+
+            sim_solver_plan_t plan;
+            plan.sim_solver = GNSF;
+
+            sim_config *config = sim_config_create(plan);
+            void *dims = sim_dims_create(config);
+            sim_dims_set(config, dims, "nx", &nx);
+            sim_dims_set(config, dims, "nu", &nu);
+            sim_dims_set(config, dims, "nx1", &nx1);
+            sim_dims_set(config, dims, "nz", &nz);
+            sim_dims_set(config, dims, "nz1", &nz1);
+            sim_dims_set(config, dims, "nout", &nout);
+            sim_dims_set(config, dims, "ny", &ny);
+            sim_dims_set(config, dims, "nuhat", &nuhat);
+
+            // reference: exact Newton, factorization in every iteration
+            sim_opts *opts_ref = (sim_opts *) sim_opts_create(config, dims);
+            opts_ref->sens_forw = true;
+            opts_ref->jac_reuse = false;
+            opts_ref->newton_iter = 8;
+            opts_ref->num_steps = 3;
+            opts_ref->ns = 3;
+
+            // factorization kept across calls, e.g. SQP iterations
+            sim_opts *opts = (sim_opts *) sim_opts_create(config, dims);
+            opts->sens_forw = true;
+            opts->jac_reuse = true;
+            opts->newton_iter = 8;
+            opts->num_steps = 3;
+            opts->ns = 3;
+            bool jac_reuse_across_calls = true;
+            sim_opts_set(config, opts, "jac_reuse_across_calls", &jac_reuse_across_calls);
+            sim_opts_set(config, opts, "sens_jac_reuse", &sens_jac_reuse);
+
+            sim_in *in = sim_in_create(config, dims);
+            sim_out *out_ref = sim_out_create(config, dims);
+            sim_out *out = sim_out_create(config, dims);
+            in->T = T;
+
+            sim_in_set(config, dims, in, "phi_fun", &phi_fun);
+            sim_in_set(config, dims, in, "phi_fun_jac_y", &phi_fun_jac_y);
+            sim_in_set(config, dims, in, "phi_jac_y_uhat", &phi_jac_y_uhat);
+            sim_in_set(config, dims, in, "f_lo_jac_x1_x1dot_u_z", &f_lo_fun_jac_x1k1uz);
+            sim_in_set(config, dims, in, "get_gnsf_matrices", &get_matrices_fun);
+
+            sim_solver *sim_solver_ref = sim_solver_create(config, dims, opts_ref, in);
+            sim_solver *sim_solver = sim_solver_create(config, dims, opts, in);
+            sim_precompute(sim_solver_ref, in, out_ref);
+            sim_precompute(sim_solver, in, out);
+
+            for (int kk = 0; kk < num_calls; kk++)
+            {
+                // small changes of the linearization point, as between SQP iterations
+                for (ii = 0; ii < nx * NF; ii++)
+                    in->S_forw[ii] = 0.0;
+                for (ii = 0; ii < nx; ii++)
+                    in->S_forw[ii * (nx + 1)] = 1.0;
+                for (jj = 0; jj < nx; jj++)
+                    in->x[jj] = x0[jj] * (1.0 + 0.01 * kk);
+                for (jj = 0; jj < nu; jj++)
+                    in->u[jj] = u_sim[jj];
+
+                REQUIRE(sim_solve(sim_solver_ref, in, out_ref) == 0);
+                REQUIRE(sim_solve(sim_solver, in, out) == 0);
+
+                int jac_factorizations, jac_factorizations_skipped;
+                config->memory_get(config, dims, sim_solver->mem, "jac_factorizations",
+                                   &jac_factorizations);
+                config->memory_get(config, dims, sim_solver->mem, "jac_factorizations_skipped",
+                                   &jac_factorizations_skipped);
+
+                double max_error = 0.0, max_error_forw = 0.0;
+                for (jj = 0; jj < nx; jj++)
+                    max_error = fmax(max_error, fabs(out->xn[jj] - out_ref->xn[jj]));
+                for (jj = 0; jj < nx*NF; jj++)
+                    max_error_forw = fmax(max_error_forw, fabs(out->S_forw[jj] - out_ref->S_forw[jj]));
+
+                std::cout << "\n---> sim_test_ode gnsf jac_reuse_across_calls: " << sens_mode << " call " << kk
+                          << ": factorizations " << jac_factorizations
+                          << ", skipped " << jac_factorizations_skipped
+                          << "\nerror_sim   = " << max_error
+                          << "\nerror_forw  = " << max_error_forw << "\n";
+
+                // the reference refactorizes in every Newton iteration, so both only agree
+                // up to the convergence of the Newton iterations
+                if (kk > 0)
+                    REQUIRE(jac_factorizations_skipped >= 1);
+                REQUIRE(max_error <= 1e-8);
+                if (sens_jac_reuse)
+                    REQUIRE(max_error_forw <= 1e-3);
+                else
+                    REQUIRE(max_error_forw <= 1e-8);
+            }
+
+            sim_config_destroy(config);
+            sim_dims_destroy(dims);
+            sim_opts_destroy(opts_ref);
+            sim_opts_destroy(opts);
+            sim_in_destroy(in);
+            sim_out_destroy(out_ref);
+            sim_out_destroy(out);
+            sim_solver_destroy(sim_solver_ref);
+            sim_solver_destroy(sim_solver);
+        }  // end section
+    }  // END FOR SENS MODES
+
+    external_function_casadi_free(&phi_fun);
+    external_function_casadi_free(&phi_fun_jac_y);
+    external_function_casadi_free(&phi_jac_y_uhat);
+    external_function_casadi_free(&f_lo_fun_jac_x1k1uz);
+    external_function_casadi_free(&get_matrices_fun);
+
+}  // END_TEST_CASE
+
+
+
+TEST_CASE("wt_nx3_workspace_cast", "[integrators]")
+{
+    vector<std::string> solvers = {"IRK", "GNSF"};
+
+    int ii, jj;
+
+    const int nx = 3;
+    const int nu = 4;
+    int NF = nx + nu;  // columns of forward seed
+
+    double T = 0.05;  // simulation time
+    int num_calls = 6;
+
+    // gnsf dimensions
+    int nx1 = nx;
+    int nz1 = 0;
+    int ny = nx;
+    int nuhat = nu;
+    int nout = 1;
+    int nz = 0;
+
+    /************************************************
+    * external functions
+    ************************************************/
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+    ext_fun_opts.external_workspace = true;
+
+    // impl_ode_fun
+    external_function_casadi impl_ode_fun;
+    impl_ode_fun.casadi_fun = &casadi_impl_ode_fun;
+    impl_ode_fun.casadi_work = &casadi_impl_ode_fun_work;
+    impl_ode_fun.casadi_sparsity_in = &casadi_impl_ode_fun_sparsity_in;
+    impl_ode_fun.casadi_sparsity_out = &casadi_impl_ode_fun_sparsity_out;
+    impl_ode_fun.casadi_n_in = &casadi_impl_ode_fun_n_in;
+    impl_ode_fun.casadi_n_out = &casadi_impl_ode_fun_n_out;
+    external_function_casadi_create(&impl_ode_fun, &ext_fun_opts);
+
+    // impl_ode_fun_jac_x_xdot
+    external_function_casadi impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_fun = &casadi_impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_work = &casadi_impl_ode_fun_jac_x_xdot_work;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_in = &casadi_impl_ode_fun_jac_x_xdot_sparsity_in;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_out = &casadi_impl_ode_fun_jac_x_xdot_sparsity_out;
+    impl_ode_fun_jac_x_xdot.casadi_n_in = &casadi_impl_ode_fun_jac_x_xdot_n_in;
+    impl_ode_fun_jac_x_xdot.casadi_n_out = &casadi_impl_ode_fun_jac_x_xdot_n_out;
+    external_function_casadi_create(&impl_ode_fun_jac_x_xdot, &ext_fun_opts);
+
+    // impl_ode_jac_x_xdot_u
+    external_function_casadi impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_fun = &casadi_impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_work = &casadi_impl_ode_jac_x_xdot_u_work;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_in = &casadi_impl_ode_jac_x_xdot_u_sparsity_in;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_out = &casadi_impl_ode_jac_x_xdot_u_sparsity_out;
+    impl_ode_jac_x_xdot_u.casadi_n_in = &casadi_impl_ode_jac_x_xdot_u_n_in;
+    impl_ode_jac_x_xdot_u.casadi_n_out = &casadi_impl_ode_jac_x_xdot_u_n_out;
+    external_function_casadi_create(&impl_ode_jac_x_xdot_u, &ext_fun_opts);
+
+    // phi_fun
+    external_function_casadi phi_fun;
+    phi_fun.casadi_fun            = &casadi_phi_fun;
+    phi_fun.casadi_work           = &casadi_phi_fun_work;
+    phi_fun.casadi_sparsity_in    = &casadi_phi_fun_sparsity_in;
+    phi_fun.casadi_sparsity_out   = &casadi_phi_fun_sparsity_out;
+    phi_fun.casadi_n_in           = &casadi_phi_fun_n_in;
+    phi_fun.casadi_n_out          = &casadi_phi_fun_n_out;
+    external_function_casadi_create(&phi_fun, &ext_fun_opts);
+
+    // phi_fun_jac_y
+    external_function_casadi phi_fun_jac_y;
+    phi_fun_jac_y.casadi_fun            = &casadi_phi_fun_jac_y;
+    phi_fun_jac_y.casadi_work           = &casadi_phi_fun_jac_y_work;
+    phi_fun_jac_y.casadi_sparsity_in    = &casadi_phi_fun_jac_y_sparsity_in;
+    phi_fun_jac_y.casadi_sparsity_out   = &casadi_phi_fun_jac_y_sparsity_out;
+    phi_fun_jac_y.casadi_n_in           = &casadi_phi_fun_jac_y_n_in;
+    phi_fun_jac_y.casadi_n_out          = &casadi_phi_fun_jac_y_n_out;
+    external_function_casadi_create(&phi_fun_jac_y, &ext_fun_opts);
+
+    // phi_jac_y_uhat
+    external_function_casadi phi_jac_y_uhat;
+    phi_jac_y_uhat.casadi_fun                = &casadi_phi_jac_y_uhat;
+    phi_jac_y_uhat.casadi_work               = &casadi_phi_jac_y_uhat_work;
+    phi_jac_y_uhat.casadi_sparsity_in        = &casadi_phi_jac_y_uhat_sparsity_in;
+    phi_jac_y_uhat.casadi_sparsity_out       = &casadi_phi_jac_y_uhat_sparsity_out;
+    phi_jac_y_uhat.casadi_n_in               = &casadi_phi_jac_y_uhat_n_in;
+    phi_jac_y_uhat.casadi_n_out              = &casadi_phi_jac_y_uhat_n_out;
+    external_function_casadi_create(&phi_jac_y_uhat, &ext_fun_opts);
+
+    // f_lo_fun_jac_x1k1uz
+    external_function_casadi f_lo_fun_jac_x1k1uz;
+    f_lo_fun_jac_x1k1uz.casadi_fun            = &casadi_f_lo_fun_jac_x1k1uz;
+    f_lo_fun_jac_x1k1uz.casadi_work           = &casadi_f_lo_fun_jac_x1k1uz_work;
+    f_lo_fun_jac_x1k1uz.casadi_sparsity_in    = &casadi_f_lo_fun_jac_x1k1uz_sparsity_in;
+    f_lo_fun_jac_x1k1uz.casadi_sparsity_out   = &casadi_f_lo_fun_jac_x1k1uz_sparsity_out;
+    f_lo_fun_jac_x1k1uz.casadi_n_in           = &casadi_f_lo_fun_jac_x1k1uz_n_in;
+    f_lo_fun_jac_x1k1uz.casadi_n_out          = &casadi_f_lo_fun_jac_x1k1uz_n_out;
+    external_function_casadi_create(&f_lo_fun_jac_x1k1uz, &ext_fun_opts);
+
+    // get_matrices_fun
+    external_function_casadi get_matrices_fun;
+    get_matrices_fun.casadi_fun            = &casadi_get_matrices_fun;
+    get_matrices_fun.casadi_work           = &casadi_get_matrices_fun_work;
+    get_matrices_fun.casadi_sparsity_in    = &casadi_get_matrices_fun_sparsity_in;
+    get_matrices_fun.casadi_sparsity_out   = &casadi_get_matrices_fun_sparsity_out;
+    get_matrices_fun.casadi_n_in           = &casadi_get_matrices_fun_n_in;
+    get_matrices_fun.casadi_n_out          = &casadi_get_matrices_fun_n_out;
+    external_function_casadi_create(&get_matrices_fun, &ext_fun_opts);
+
+    for (std::string solver : solvers)
+    {
+        SECTION(solver)
+        {
+            sim_solver_plan_t plan;
+            plan.sim_solver = hashitsim(solver);
+
+            sim_config *config = sim_config_create(plan);
+            void *dims = sim_dims_create(config);
+            sim_dims_set(config, dims, "nx", &nx);
+            sim_dims_set(config, dims, "nu", &nu);
+            if (plan.sim_solver == GNSF)
+            {
+                sim_dims_set(config, dims, "nx1", &nx1);
+                sim_dims_set(config, dims, "nz", &nz);
+                sim_dims_set(config, dims, "nz1", &nz1);
+                sim_dims_set(config, dims, "nout", &nout);
+                sim_dims_set(config, dims, "ny", &ny);
+                sim_dims_set(config, dims, "nuhat", &nuhat);
+            }
+
+            // the workspaces are sized with adjoint sensitivities,
+            // which are switched off and on again between calls
+            sim_opts *opts = (sim_opts *) sim_opts_create(config, dims);
+            opts->sens_forw = true;
+            opts->sens_adj = true;
+            opts->newton_iter = 3;
+            opts->num_steps = 3;
+            opts->ns = 3;
+
+            sim_in *in = sim_in_create(config, dims);
+            sim_out *out_cached = sim_out_create(config, dims);
+            sim_out *out_recast = sim_out_create(config, dims);
+            in->T = T;
+
+            if (plan.sim_solver == GNSF)
+            {
+                sim_in_set(config, dims, in, "phi_fun", &phi_fun);
+                sim_in_set(config, dims, in, "phi_fun_jac_y", &phi_fun_jac_y);
+                sim_in_set(config, dims, in, "phi_jac_y_uhat", &phi_jac_y_uhat);
+                sim_in_set(config, dims, in, "f_lo_jac_x1_x1dot_u_z", &f_lo_fun_jac_x1k1uz);
+                sim_in_set(config, dims, in, "get_gnsf_matrices", &get_matrices_fun);
+            }
+            else
+            {
+                sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+                sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot);
+                sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+            }
+
+            // cached: always the same workspace, the cast is only redone if the options change
+            sim_solver *sim_solver_cached = sim_solver_create(config, dims, opts, in);
+            // recast: alternating workspaces invalidate the cached cast in every call
+            sim_solver *sim_solver_recast = sim_solver_create(config, dims, opts, in);
+            sim_precompute(sim_solver_cached, in, out_cached);
+            sim_precompute(sim_solver_recast, in, out_recast);
+
+            acados_size_t work_size = config->workspace_calculate_size(config, dims, opts);
+            void *work_other = calloc(1, work_size);
+            void *work = sim_solver_recast->work;
+
+            for (int kk = 0; kk < num_calls; kk++)
+            {
+                // switch off the adjoint sensitivities for two calls, this changes the layout
+                opts->sens_adj = kk < 2 || kk > 3;
+
+                // different inputs in every call
+                for (ii = 0; ii < nx * NF; ii++)
+                    in->S_forw[ii] = 0.0;
+                for (ii = 0; ii < nx; ii++)
+                    in->S_forw[ii * (nx + 1)] = 1.0;
+                for (jj = 0; jj < nx; jj++)
+                    in->x[jj] = x0[jj] * (1.0 + 0.05 * kk);
+                for (jj = 0; jj < nu; jj++)
+                    in->u[jj] = u_sim[jj] * (1.0 - 0.02 * kk);
+                for (jj = 0; jj < nx; jj++)
+                    in->S_adj[jj] = 1.0 + 0.1 * kk;
+                for (jj = nx; jj < nx + nu; jj++)
+                    in->S_adj[jj] = 0.0;
+
+                sim_solver_recast->work = kk % 2 ? work : work_other;
+
+                REQUIRE(sim_solve(sim_solver_cached, in, out_cached) == 0);
+                REQUIRE(sim_solve(sim_solver_recast, in, out_recast) == 0);
+
+                double max_error = 0.0, max_error_forw = 0.0, max_error_adj = 0.0;
+                for (jj = 0; jj < nx; jj++)
+                    max_error = fmax(max_error, fabs(out_cached->xn[jj] - out_recast->xn[jj]));
+                for (jj = 0; jj < nx*NF; jj++)
+                    max_error_forw = fmax(max_error_forw,
+                                          fabs(out_cached->S_forw[jj] - out_recast->S_forw[jj]));
+                if (opts->sens_adj)
+                {
+                    for (jj = 0; jj < nx + nu; jj++)
+                        max_error_adj = fmax(max_error_adj,
+                                             fabs(out_cached->S_adj[jj] - out_recast->S_adj[jj]));
+                }
+
+                std::cout << "\n---> sim_test_ode workspace_cast: " << solver << " call " << kk
+                          << "\nerror_sim   = " << max_error
+                          << "\nerror_forw  = " << max_error_forw
+                          << "\nerror_adj   = " << max_error_adj << "\n";
+
+                // same operations on the same data, the results have to be identical
+                REQUIRE(max_error == 0.0);
+                REQUIRE(max_error_forw == 0.0);
+                REQUIRE(max_error_adj == 0.0);
+            }
+
+            sim_solver_recast->work = work;
+            free(work_other);
+
+            sim_config_destroy(config);
+            sim_dims_destroy(dims);
+            sim_opts_destroy(opts);
+            sim_in_destroy(in);
+            sim_out_destroy(out_cached);
+            sim_out_destroy(out_recast);
+            sim_solver_destroy(sim_solver_cached);
+            sim_solver_destroy(sim_solver_recast);
+        }  // end section
+    }  // END FOR SOLVERS
+
+    external_function_casadi_free(&impl_ode_fun);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&impl_ode_jac_x_xdot_u);
+    external_function_casadi_free(&phi_fun);
+    external_function_casadi_free(&phi_fun_jac_y);
+    external_function_casadi_free(&phi_jac_y_uhat);
+    external_function_casadi_free(&f_lo_fun_jac_x1k1uz);
+    external_function_casadi_free(&get_matrices_fun);
+
+}  // END_TEST_CASE
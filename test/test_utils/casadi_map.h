@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#ifndef TEST_TEST_UTILS_CASADI_MAP_H_
+#define TEST_TEST_UTILS_CASADI_MAP_H_
+
+#include <vector>
+
+// Emulates the code generated by casadi for f.map(batch_size) with serial evaluation, such that
+// external_function_casadi_batch can be tested with the casadi functions shipped in examples/c:
+// all inputs and outputs are horizontal concatenations of batch_size instances of f.
+// ID distinguishes several mapped functions in one translation unit.
+namespace
+{
+
+template <int ID>
+struct casadi_map
+{
+    typedef int (*fun_t)(const double **, double **, int *, double *, void *);
+    typedef int (*work_t)(int *, int *, int *, int *);
+    typedef const int *(*sparsity_t)(int);
+    typedef int (*n_t)();
+
+    static fun_t f;
+    static work_t f_work;
+    static sparsity_t f_sparsity_in;
+    static sparsity_t f_sparsity_out;
+    static int n_in;
+    static int n_out;
+    static int batch_size;
+    static std::vector<std::vector<int>> sp_in;
+    static std::vector<std::vector<int>> sp_out;
+
+    static int nnz(const int *sp)
+    {
+        if (sp[2] == 1)  // dense format
+            return sp[0] * sp[1];
+        return sp[2 + sp[1]];
+    }
+
+    static std::vector<int> map_sparsity(const int *sp)
+    {
+        int nrow = sp[0];
+        int ncol = sp[1];
+        if (sp[2] == 1)
+            return {nrow, ncol * batch_size, 1};
+
+        int nz = nnz(sp);
+        std::vector<int> out = {nrow, ncol * batch_size};
+        for (int jj = 0; jj < batch_size; jj++)
+            for (int kk = (jj == 0 ? 0 : 1); kk <= ncol; kk++)
+                out.push_back(sp[2 + kk] + jj * nz);
+        for (int jj = 0; jj < batch_size; jj++)
+            for (int kk = 0; kk < nz; kk++)
+                out.push_back(sp[3 + ncol + kk]);
+        return out;
+    }
+
+    static void init(fun_t fun, work_t work, sparsity_t sparsity_in, sparsity_t sparsity_out,
+                     n_t fun_n_in, n_t fun_n_out, int size)
+    {
+        f = fun;
+        f_work = work;
+        f_sparsity_in = sparsity_in;
+        f_sparsity_out = sparsity_out;
+        n_in = fun_n_in();
+        n_out = fun_n_out();
+        batch_size = size;
+        sp_in.clear();
+        sp_out.clear();
+        for (int ii = 0; ii < n_in; ii++)
+            sp_in.push_back(map_sparsity(sparsity_in(ii)));
+        for (int ii = 0; ii < n_out; ii++)
+            sp_out.push_back(map_sparsity(sparsity_out(ii)));
+    }
+
+    static int fun(const double **arg, double **res, int *iw, double *w, void *mem)
+    {
+        int sz_arg, sz_res, sz_iw, sz_w;
+        f_work(&sz_arg, &sz_res, &sz_iw, &sz_w);
+        std::vector<const double *> arg_j(sz_arg, nullptr);
+        std::vector<double *> res_j(sz_res, nullptr);
+        for (int jj = 0; jj < batch_size; jj++)
+        {
+            for (int ii = 0; ii < n_in; ii++)
+                arg_j[ii] = arg[ii] ? arg[ii] + jj * nnz(f_sparsity_in(ii)) : nullptr;
+            for (int ii = 0; ii < n_out; ii++)
+                res_j[ii] = res[ii] ? res[ii] + jj * nnz(f_sparsity_out(ii)) : nullptr;
+            f(arg_j.data(), res_j.data(), iw, w, mem);
+        }
+        return 0;
+    }
+
+    static int work(int *sz_arg, int *sz_res, int *sz_iw, int *sz_w)
+    {
+        f_work(nullptr, nullptr, sz_iw, sz_w);
+        if (sz_arg) *sz_arg = n_in;
+        if (sz_res) *sz_res = n_out;
+        return 0;
+    }
+
+    static const int *sparsity_in(int ii) { return ii < n_in ? sp_in[ii].data() : nullptr; }
+    static const int *sparsity_out(int ii) { return ii < n_out ? sp_out[ii].data() : nullptr; }
+    static int get_n_in() { return n_in; }
+    static int get_n_out() { return n_out; }
+};
+
+template <int ID> typename casadi_map<ID>::fun_t casadi_map<ID>::f;
+template <int ID> typename casadi_map<ID>::work_t casadi_map<ID>::f_work;
+template <int ID> typename casadi_map<ID>::sparsity_t casadi_map<ID>::f_sparsity_in;
+template <int ID> typename casadi_map<ID>::sparsity_t casadi_map<ID>::f_sparsity_out;
+template <int ID> int casadi_map<ID>::n_in;
+template <int ID> int casadi_map<ID>::n_out;
+template <int ID> int casadi_map<ID>::batch_size;
+template <int ID> std::vector<std::vector<int>> casadi_map<ID>::sp_in;
+template <int ID> std::vector<std::vector<int>> casadi_map<ID>::sp_out;
+
+}  // namespace
+
+#endif  // TEST_TEST_UTILS_CASADI_MAP_H_